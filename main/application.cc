@@ -1,6 +1,7 @@
 #include "application.h"
 #include "board.h"
 #include "display.h"
+#include "emote_display.h"
 #include "system_info.h"
 #include "audio_codec.h"
 #include "mqtt_protocol.h"
@@ -9,8 +10,25 @@
 #include "mcp_server.h"
 #include "assets.h"
 #include "settings.h"
+#include "boot_profiler.h"
+#include "heap_telemetry.h"
+#include "memory_budget.h"
+#include "knob_registry.h"
+#include "dvfs_governor.h"
+#include "crash_reporter.h"
+#include "dns_prefetch.h"
+#include "tracepoint.h"
+#include "wake_word_metrics.h"
+#include "power_profiler.h"
+#include "latency_scoreboard.h"
+#include "flash_op_monitor.h"
+#include "json_arena.h"
+#include "wake_snapshot.h"
+#include "thermal_monitor.h"
 
 #include <cstring>
+#include <ctime>
+#include <sys/time.h>
 #include <esp_log.h>
 #include <cJSON.h>
 #include <driver/gpio.h>
@@ -59,6 +77,37 @@ Application::Application() {
         .skip_unhandled_events = true
     };
     esp_timer_create(&clock_timer_args, &clock_timer_handle_);
+
+    // LED 和屏幕的状态反馈走异步档：进入聆听态在唤醒词的关键路径上，
+    // 不需要等这些 UI 工作做完
+    DeviceStateEventManager::GetInstance().RegisterStateChangeCallback(
+        [](DeviceState previous_state, DeviceState current_state) {
+            auto& board = Board::GetInstance();
+            auto display = board.GetDisplay();
+            auto led = board.GetLed();
+            led->OnStateChanged();
+            switch (current_state) {
+                case kDeviceStateUnknown:
+                case kDeviceStateIdle:
+                    display->SetStatus(Lang::Strings::STANDBY);
+                    display->SetEmotion("neutral");
+                    break;
+                case kDeviceStateConnecting:
+                    display->SetStatus(Lang::Strings::CONNECTING);
+                    display->SetEmotion("neutral");
+                    display->SetChatMessage("system", "");
+                    break;
+                case kDeviceStateListening:
+                    display->SetStatus(Lang::Strings::LISTENING);
+                    display->SetEmotion("neutral");
+                    break;
+                case kDeviceStateSpeaking:
+                    display->SetStatus(Lang::Strings::SPEAKING);
+                    break;
+                default:
+                    break;
+            }
+        }, StateCallbackTier::kAsync);
 }
 
 Application::~Application() {
@@ -82,10 +131,20 @@ void Application::CheckAssetsVersion() {
     Settings settings("assets", true);
     // Check if there is a new assets need to be downloaded
     std::string download_url = settings.GetString("download_url");
+    if (download_url.empty()) {
+        // 上次没下完的后台下载，重启后从断点继续
+        download_url = settings.GetString("bg_url");
+    }
 
     if (!download_url.empty()) {
         settings.EraseKey("download_url");
 
+        // 双槽布局走后台涓流下载：不打断交互，完成后自动热应用；
+        // 单分区布局下载期间资源不可用，保留原来的前台升级流程
+        if (assets.StartBackgroundDownload(download_url)) {
+            return;
+        }
+
         char message[256];
         snprintf(message, sizeof(message), Lang::Strings::FOUND_NEW_ASSETS, download_url.c_str());
         Alert(Lang::Strings::LOADING_ASSETS, message, "cloud_arrow_down", Lang::Sounds::OGG_UPGRADE);
@@ -112,15 +171,45 @@ void Application::CheckAssetsVersion() {
             vTaskDelay(pdMS_TO_TICKS(2000));
             return;
         }
+
+        // 启动早期已经应用过资源，这里只在下载了新包之后重新应用。
+        // 主题、音效原地生效，唤醒词模型走热切换（SwapModelsList），
+        // 整个过程不需要重启
+        assets.Apply();
     }
 
-    // Apply assets
-    assets.Apply();
     display->SetChatMessage("system", "");
     display->SetEmotion("microchip_ai");
 }
 
 void Application::CheckNewVersion(Ota& ota) {
+#if CONFIG_OTA_CHECK_CACHE_TTL_SECONDS > 0
+    // 上次检查结果还新鲜且没有待办事项时直接就绪，在后台重新校验；
+    // 断电后 RTC 时钟丢失（time 无效）则退回阻塞检查
+    {
+        Settings settings("ota", false);
+        time_t now = time(NULL);
+        int32_t last_check = settings.GetInt("last_check", 0);
+        // 深睡快速唤醒时固件不可能在睡眠期间变过，即使缓存超过 TTL
+        // 也直接走缓存 + 后台复验
+        int32_t cache_ttl = KnobRegistry::GetInstance().GetInt(
+            "ota_cache_ttl_s", CONFIG_OTA_CHECK_CACHE_TTL_SECONDS);
+        bool cache_fresh = now > 1600000000 && last_check > 0 &&
+                           now - last_check < cache_ttl;
+        if (settings.GetBool("last_ok", false) && ota.LoadCachedConfig() &&
+            (cache_fresh || fast_wake_boot_)) {
+            ESP_LOGI(TAG, "Version check cache is fresh (checked %ld seconds ago), revalidating in background",
+                     (long)(now - last_check));
+            xEventGroupSetBits(event_group_, MAIN_EVENT_CHECK_NEW_VERSION_DONE);
+            xTaskCreate([](void* arg) {
+                ((Application*)arg)->RevalidateVersionInBackground();
+                vTaskDelete(NULL);
+            }, "ota_revalidate", 2048 * 4, this, 2, NULL);
+            return;
+        }
+    }
+#endif
+
     const int MAX_RETRY = 10;
     int retry_count = 0;
     int retry_delay = 10; // 初始重试延迟为10秒
@@ -159,10 +248,16 @@ void Application::CheckNewVersion(Ota& ota) {
         retry_delay = 10; // 重置重试延迟时间
 
         if (ota.HasNewVersion()) {
+#if CONFIG_OTA_DEFER_IDLE_SECONDS > 0
+            // 不立即打断启动流程升级，交给后台窗口调度器：等设备持续空闲
+            // 后限速预装，静默时段再重启激活。这里按无新版本继续往下走
+            StartDeferredUpgrade();
+#else
             if (UpgradeFirmware(ota)) {
                 return; // This line will never be reached after reboot
             }
             // If upgrade failed, continue to normal operation (don't break, just fall through)
+#endif
         }
 
         // No new version, mark the current version as valid
@@ -198,6 +293,104 @@ void Application::CheckNewVersion(Ota& ota) {
     }
 }
 
+void Application::RevalidateVersionInBackground() {
+    // 缓存命中后的后台校验：失败不打扰用户，留到缓存过期后的下次启动再阻塞检查
+    Ota ota;
+    esp_err_t err = ota.CheckVersion();
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Background version check failed: %d", err);
+        return;
+    }
+
+    if (ota.HasNewVersion()) {
+#if CONFIG_OTA_DEFER_IDLE_SECONDS > 0
+        StartDeferredUpgrade();
+#else
+        // 只有升级需要打断；等设备空闲再开始
+        while (device_state_ != kDeviceStateIdle) {
+            vTaskDelay(pdMS_TO_TICKS(1000));
+        }
+        UpgradeFirmware(ota);
+#endif
+        return;
+    }
+
+    ota.MarkCurrentVersionValid();
+    if (ota.HasActivationCode() || ota.HasActivationChallenge()) {
+        // 激活流程需要用户参与，不在后台打断，下次启动再走完整流程
+        ESP_LOGW(TAG, "Server requests activation, deferring to next boot");
+    }
+}
+
+void Application::StartDeferredUpgrade() {
+    bool expected = false;
+    if (!deferred_upgrade_active_.compare_exchange_strong(expected, true)) {
+        return;
+    }
+    ESP_LOGI(TAG, "New version available, deferring upgrade to next idle window");
+    xTaskCreate([](void* arg) {
+        ((Application*)arg)->DeferredUpgradeTask();
+        vTaskDelete(NULL);
+    }, "ota_window", 2048 * 4, this, 1, NULL);
+}
+
+void Application::DeferredUpgradeTask() {
+    // 第一步：等设备持续空闲满阈值。任何一次交互（状态离开 Idle、音频
+    // 通道打开、播放未结束）都把计时清零，避免下载跟会话抢带宽
+    int idle_seconds = 0;
+    while (idle_seconds < CONFIG_OTA_DEFER_IDLE_SECONDS) {
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        // 结温临界时后台下载同样让路，窗口推迟到芯片凉下来
+        bool can_stage = CanEnterSleepMode() &&
+                         !ThermalMonitor::GetInstance().ShouldDeferBackgroundWork();
+        idle_seconds = can_stage ? idle_seconds + 1 : 0;
+    }
+
+    // 下载地址可能带时效签名，等到窗口再重新检查一次拿新鲜 URL
+    Ota ota;
+    if (ota.CheckVersion() != ESP_OK || !ota.HasNewVersion()) {
+        ESP_LOGW(TAG, "Deferred upgrade: re-check found nothing to install");
+        deferred_upgrade_active_ = false;
+        return;
+    }
+
+    // 第二步：限速下载并预装到备用 OTA 分区。不切设备状态、不停音频
+    // 服务，下载期间设备照常可用；音频通道打开时限速钩子重度让速
+    ota.SetBackgroundPacing([]() {
+        return Application::GetInstance().IsAudioChannelOpened() ||
+               ThermalMonitor::GetInstance().ShouldDeferBackgroundWork();
+    });
+    ESP_LOGI(TAG, "Deferred upgrade: staging version %s in background", ota.GetFirmwareVersion().c_str());
+    if (!ota.StartUpgrade(nullptr)) {
+        ESP_LOGW(TAG, "Deferred upgrade: staging failed, will retry after next version check");
+        deferred_upgrade_active_ = false;
+        return;
+    }
+
+    // 第三步：镜像已就绪、启动分区已切换，只差一次重启。挪到静默时段
+    // 执行；时钟没同步（断电丢 RTC）时退化为只看空闲
+    ESP_LOGI(TAG, "Deferred upgrade: image staged, waiting for quiet hour to reboot");
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(30000));
+        if (!CanEnterSleepMode()) {
+            continue;
+        }
+#if CONFIG_OTA_QUIET_HOUR >= 0
+        time_t now = time(NULL);
+        if (now > 1600000000) {
+            struct tm tm_now;
+            localtime_r(&now, &tm_now);
+            if (tm_now.tm_hour != CONFIG_OTA_QUIET_HOUR) {
+                continue;
+            }
+        }
+#endif
+        break;
+    }
+    ESP_LOGI(TAG, "Deferred upgrade: rebooting into new firmware");
+    Reboot();
+}
+
 void Application::ShowActivationCode(const std::string& code, const std::string& message) {
     struct digit_sound {
         char digit;
@@ -271,7 +464,7 @@ void Application::ToggleChatState() {
         Schedule([this]() {
             if (!protocol_->IsAudioChannelOpened()) {
                 SetDeviceState(kDeviceStateConnecting);
-                if (!protocol_->OpenAudioChannel()) {
+                if (!OpenAudioChannelWithFallback()) {
                     return;
                 }
             }
@@ -308,7 +501,7 @@ void Application::StartListening() {
         Schedule([this]() {
             if (!protocol_->IsAudioChannelOpened()) {
                 SetDeviceState(kDeviceStateConnecting);
-                if (!protocol_->OpenAudioChannel()) {
+                if (!OpenAudioChannelWithFallback()) {
                     return;
                 }
             }
@@ -348,69 +541,16 @@ void Application::StopListening() {
     });
 }
 
-void Application::Start() {
+// 创建指定传输的协议实例并接好全部回调；传输回退时会再次调用，
+// 因此所有回调只捕获随协议实例一起重建无副作用的对象
+void Application::SetupProtocol(bool use_websocket) {
     auto& board = Board::GetInstance();
-    SetDeviceState(kDeviceStateStarting);
-
-    /* Setup the display */
     auto display = board.GetDisplay();
-
-    // Print board name/version info
-    display->SetChatMessage("system", SystemInfo::GetUserAgent().c_str());
-
-    /* Setup the audio service */
     auto codec = board.GetAudioCodec();
-    audio_service_.Initialize(codec);
-    audio_service_.Start();
-
-    AudioServiceCallbacks callbacks;
-    callbacks.on_send_queue_available = [this]() {
-        xEventGroupSetBits(event_group_, MAIN_EVENT_SEND_AUDIO);
-    };
-    callbacks.on_wake_word_detected = [this](const std::string& wake_word) {
-        xEventGroupSetBits(event_group_, MAIN_EVENT_WAKE_WORD_DETECTED);
-    };
-    callbacks.on_vad_change = [this](bool speaking) {
-        xEventGroupSetBits(event_group_, MAIN_EVENT_VAD_CHANGE);
-    };
-    audio_service_.SetCallbacks(callbacks);
-
-    // Start the main event loop task with priority 3
-    xTaskCreate([](void* arg) {
-        ((Application*)arg)->MainEventLoop();
-        vTaskDelete(NULL);
-    }, "main_event_loop", 2048 * 4, this, 3, &main_event_loop_task_handle_);
-
-    /* Start the clock timer to update the status bar */
-    esp_timer_start_periodic(clock_timer_handle_, 1000000);
-
-    /* Wait for the network to be ready */
-    board.StartNetwork();
-
-    // Update the status bar immediately to show the network state
-    display->UpdateStatusBar(true);
-
-    // Check for new assets version
-    CheckAssetsVersion();
-
-    // Check for new firmware version or get the MQTT broker address
-    Ota ota;
-    CheckNewVersion(ota);
-
-    // Initialize the protocol
-    display->SetStatus(Lang::Strings::LOADING_PROTOCOL);
-
-    // Add MCP common tools before initializing the protocol
-    auto& mcp_server = McpServer::GetInstance();
-    mcp_server.AddCommonTools();
-    mcp_server.AddUserOnlyTools();
-
-    if (ota.HasMqttConfig()) {
-        protocol_ = std::make_unique<MqttProtocol>();
-    } else if (ota.HasWebsocketConfig()) {
+    protocol_is_websocket_ = use_websocket;
+    if (use_websocket) {
         protocol_ = std::make_unique<WebsocketProtocol>();
     } else {
-        ESP_LOGW(TAG, "No protocol specified in the OTA config, using MQTT");
         protocol_ = std::make_unique<MqttProtocol>();
     }
 
@@ -422,13 +562,17 @@ void Application::Start() {
         last_error_message_ = message;
         xEventGroupSetBits(event_group_, MAIN_EVENT_ERROR);
     });
-    protocol_->OnIncomingAudio([this](std::unique_ptr<AudioStreamPacket> packet) {
-        if (device_state_ == kDeviceStateSpeaking) {
-            audio_service_.PushPacketToDecodeQueue(std::move(packet));
-        }
-    });
+    protocol_->OnIncomingAudio(Delegate<void(std::unique_ptr<AudioStreamPacket>)>::Bind(
+        this, [](Application* self, std::unique_ptr<AudioStreamPacket> packet) {
+            TRACE_EVENT(TracePoint::kProtoRecv, packet->payload.size());
+            LatencyScoreboard::GetInstance().Mark(LatencyScoreboard::kFirstDownlinkAudio);
+            if (self->device_state_ == kDeviceStateSpeaking) {
+                self->audio_service_.PushPacketToDecodeQueue(std::move(packet));
+            }
+        }));
     protocol_->OnAudioChannelOpened([this, codec, &board]() {
         board.SetPowerSaveMode(false);
+        PowerProfiler::GetInstance().SetFlag(PowerProfiler::kFlagNetworkSession, true);
         if (protocol_->server_sample_rate() != codec->output_sample_rate()) {
             ESP_LOGW(TAG, "Server sample rate %d does not match device output sample rate %d, resampling may cause distortion",
                 protocol_->server_sample_rate(), codec->output_sample_rate());
@@ -436,13 +580,61 @@ void Application::Start() {
     });
     protocol_->OnAudioChannelClosed([this, &board]() {
         board.SetPowerSaveMode(true);
+        PowerProfiler::GetInstance().SetFlag(PowerProfiler::kFlagNetworkSession, false);
         Schedule([this]() {
             auto display = Board::GetInstance().GetDisplay();
             display->SetChatMessage("system", "");
             SetDeviceState(kDeviceStateIdle);
         });
     });
+    /* Fast path for the high-frequency state messages; anything the
+     * protocol-side scanner cannot handle still arrives via OnIncomingJson */
+    protocol_->OnIncomingState([this, display](const StateMessage& msg) {
+        LatencyScoreboard::GetInstance().Mark(LatencyScoreboard::kFirstServerJson);
+        if (msg.type == "tts") {
+            if (msg.state == "start") {
+                Schedule([this]() {
+                    aborted_ = false;
+                    if (device_state_ == kDeviceStateIdle || device_state_ == kDeviceStateListening) {
+                        SetDeviceState(kDeviceStateSpeaking);
+                    }
+                });
+            } else if (msg.state == "stop") {
+                Schedule([this]() {
+                    if (device_state_ == kDeviceStateSpeaking) {
+                        if (listening_mode_ == kListeningModeManualStop) {
+                            SetDeviceState(kDeviceStateIdle);
+                        } else {
+                            SetDeviceState(kDeviceStateListening);
+                        }
+                    }
+                });
+            } else if (msg.state == "sentence_start") {
+                if (!msg.text.empty()) {
+                    ESP_LOGI(TAG, "<< %s", msg.text.c_str());
+                    Schedule([this, display, message = msg.text]() {
+                        display->SetChatMessage("assistant", message.c_str());
+                    });
+                }
+            }
+        } else if (msg.type == "stt") {
+            if (!msg.text.empty()) {
+                ESP_LOGI(TAG, ">> %s", msg.text.c_str());
+                Schedule([this, display, message = msg.text]() {
+                    display->SetChatMessage("user", message.c_str());
+                });
+            }
+        } else if (msg.type == "llm") {
+            if (!msg.emotion.empty()) {
+                Schedule([this, display, emotion_str = msg.emotion]() {
+                    display->SetEmotion(emotion_str.c_str());
+                });
+            }
+        }
+    });
+
     protocol_->OnIncomingJson([this, display](const cJSON* root) {
+        LatencyScoreboard::GetInstance().Mark(LatencyScoreboard::kFirstServerJson);
         // Parse JSON data
         auto type = cJSON_GetObjectItem(root, "type");
         if (strcmp(type->valuestring, "tts") == 0) {
@@ -476,8 +668,17 @@ void Application::Start() {
         } else if (strcmp(type->valuestring, "stt") == 0) {
             auto text = cJSON_GetObjectItem(root, "text");
             if (cJSON_IsString(text)) {
-                ESP_LOGI(TAG, ">> %s", text->valuestring);
-                Schedule([this, display, message = std::string(text->valuestring)]() {
+                // 带转义的增量消息会落到这条全量解析路径，重建仍要走
+                // 协议层的同一块缓冲，否则快慢两条路径会互相覆盖
+                std::string full = text->valuestring;
+                auto delta = cJSON_GetObjectItem(root, "delta");
+                if (cJSON_IsString(delta)) {
+                    auto keep = cJSON_GetObjectItem(root, "delta_keep");
+                    int keep_chars = cJSON_IsString(keep) ? atoi(keep->valuestring) : -1;
+                    full = protocol_->ApplySttDelta(delta->valuestring, keep_chars, full);
+                }
+                ESP_LOGI(TAG, ">> %s", full.c_str());
+                Schedule([this, display, message = std::move(full)]() {
                     display->SetChatMessage("user", message.c_str());
                 });
             }
@@ -490,7 +691,8 @@ void Application::Start() {
             }
         } else if (strcmp(type->valuestring, "mcp") == 0) {
             auto payload = cJSON_GetObjectItem(root, "payload");
-            if (cJSON_IsObject(payload)) {
+            // 数组是 JSON-RPC 批量请求（一组 tools/call 打包下发）
+            if (cJSON_IsObject(payload) || cJSON_IsArray(payload)) {
                 McpServer::GetInstance().ParseMessage(payload);
             }
         } else if (strcmp(type->valuestring, "system") == 0) {
@@ -506,6 +708,25 @@ void Application::Start() {
                     ESP_LOGW(TAG, "Unknown system command: %s", command->valuestring);
                 }
             }
+        } else if (strcmp(type->valuestring, "knobs") == 0) {
+            // 机群调参下推：payload 是 {参数名: 整数值} 对象，逐项校验
+            // 应用并持久化，未注册/越界的逐项打日志跳过
+            auto payload = cJSON_GetObjectItem(root, "payload");
+            if (cJSON_IsObject(payload)) {
+                cJSON* item = NULL;
+                cJSON_ArrayForEach(item, payload) {
+                    if (!cJSON_IsNumber(item)) {
+                        ESP_LOGW(TAG, "Knob '%s' value must be a number", item->string);
+                        continue;
+                    }
+                    std::string error;
+                    if (!KnobRegistry::GetInstance().Set(item->string, item->valueint, error)) {
+                        ESP_LOGW(TAG, "Knob push rejected: %s", error.c_str());
+                    }
+                }
+            } else {
+                ESP_LOGW(TAG, "Knobs message requires an object payload");
+            }
         } else if (strcmp(type->valuestring, "alert") == 0) {
             auto status = cJSON_GetObjectItem(root, "status");
             auto message = cJSON_GetObjectItem(root, "message");
@@ -531,11 +752,195 @@ void Application::Start() {
             ESP_LOGW(TAG, "Unknown message type: %s", type->valuestring);
         }
     });
-    bool protocol_started = protocol_->Start();
+}
+
+void Application::Start() {
+    auto& board = Board::GetInstance();
+    JsonArena::InstallHooks();
+    DvfsGovernor::GetInstance().Init();
+    PowerProfiler::GetInstance().Init();
+    ThermalMonitor::GetInstance().Init();
+
+    // 机群可调参数（MCP self.knobs.* / 服务器下推 type:"knobs"）。
+    // 音频类参数由 AudioService 自己注册；这里注册应用层的
+#if CONFIG_OTA_CHECK_CACHE_TTL_SECONDS > 0
+    KnobRegistry::GetInstance().RegisterInt("ota_cache_ttl_s", CONFIG_OTA_CHECK_CACHE_TTL_SECONDS,
+                                            60, 7 * 24 * 3600);
+#endif
+    debug_dump_period_s_.store(KnobRegistry::GetInstance().RegisterInt(
+        "dbg_dump_s", 10, 5, 3600,
+        [this](int value) { debug_dump_period_s_.store(value, std::memory_order_relaxed); }),
+        std::memory_order_relaxed);
+    SetDeviceState(kDeviceStateStarting);
+    BootProfiler::GetInstance().BeginSpan("boot_total");
+
+    // 深睡唤醒快照：命中时本次启动跳过可证明没变的发现类工作；
+    // 无论命中与否都重新挂上入睡前的保存回调
+    fast_wake_boot_ = WakeSnapshot::Restore();
+    WakeSnapshot::RegisterSaveHook();
+
+    /* Setup the display */
+    auto display = board.GetDisplay();
+
+    // Print board name/version info
+    display->SetChatMessage("system", SystemInfo::GetUserAgent().c_str());
+
+    /* Setup the audio service */
+    auto codec = board.GetAudioCodec();
+    {
+        BootSpan span("audio_service");
+        audio_service_.Initialize(codec);
+        audio_service_.Start();
+    }
+
+    // 提示音缓存是最大的一块可丢弃内存，注册成预算管理器的最低保护
+    // 等级：高等级分配（抓帧、解码）失败时先拿它开刀，碎片化告警也经
+    // 同一条聚合缓解链走到这里。缓存内部有锁，任意任务回收都安全
+    MemoryBudget::GetInstance().RegisterPool("sound_cache", MemoryBudget::kReclaimCaches,
+                                             [this](size_t wanted) {
+        return audio_service_.DropSoundCache();
+    });
+
+    // 接线固定不变，用 Delegate 绑定（无捕获 lambda，首参收 this）
+    AudioServiceCallbacks callbacks;
+    callbacks.on_send_queue_available = Delegate<void()>::Bind(this, [](Application* self) {
+        xEventGroupSetBits(self->event_group_, MAIN_EVENT_SEND_AUDIO);
+    });
+    callbacks.on_wake_word_detected =
+        Delegate<void(const std::string&)>::Bind(this, [](Application* self, const std::string& wake_word) {
+            xEventGroupSetBits(self->event_group_, MAIN_EVENT_WAKE_WORD_DETECTED);
+        });
+    callbacks.on_vad_change = Delegate<void(bool)>::Bind(this, [](Application* self, bool speaking) {
+        xEventGroupSetBits(self->event_group_, MAIN_EVENT_VAD_CHANGE);
+    });
+    // 表情盘的动画节奏跟随实际播放进度，其它显示类型不付这个回调的开销
+    if (auto emote_display = dynamic_cast<emote::EmoteDisplay*>(Board::GetInstance().GetDisplay())) {
+        callbacks.on_playback_position =
+            Delegate<void(uint32_t)>::Bind(emote_display, [](emote::EmoteDisplay* display, uint32_t position_ms) {
+                display->NotifyPlaybackPosition(position_ms);
+            });
+    }
+    audio_service_.SetCallbacks(callbacks);
+
+    // 分阶段初始化：先只加载唤醒词模型并打开检测，让设备尽早具备交互能力；
+    // 主题资源、分区校验和、OTA 检查都推迟到这之后
+    auto& assets = Assets::GetInstance();
+    if (assets.partition_valid()) {
+        BootSpan span("assets_models");
+        assets.ApplyModels();
+    }
+    {
+        BootSpan span("wake_word");
+        audio_service_.EnableWakeWordDetection(true);
+    }
+
+    // Start the main event loop task with priority 3
+    xTaskCreate([](void* arg) {
+        ((Application*)arg)->MainEventLoop();
+        vTaskDelete(NULL);
+    }, "main_event_loop", 2048 * 4, this, 3, &main_event_loop_task_handle_);
+
+    /* Arm the one-shot clock timer to update the status bar */
+    ScheduleClockTick();
+
+    // 主题资源（字体、表情、皮肤）在唤醒词可用之后再加载
+    if (assets.partition_valid()) {
+        BootSpan span("assets_theme");
+        assets.ApplyUi();
+    }
+
+    /* Wait for the network to be ready */
+    {
+        BootSpan span("network");
+        board.StartNetwork();
+    }
+
+    // Update the status bar immediately to show the network state
+    display->UpdateStatusBar(true);
+
+    // 网络一就绪就预热已知端点的 DNS 表项，OTA 检查和开通道时省掉
+    // 冷链路上几百毫秒的阻塞解析
+    {
+        auto& dns = DnsPrefetch::GetInstance();
+        Settings websocket_settings("websocket", false);
+        dns.AddUrl(websocket_settings.GetString("url"));
+        dns.AddUrl(Ota::GetCheckVersionUrl());
+        dns.Start();
+    }
+
+    // 上次崩溃留下的 core dump 交给后台任务限速上传
+    CrashReporter::GetInstance().CheckAndUpload();
+
+    // 补算启动时跳过的资源分区校验和；深睡期间 flash 不会变，快照里
+    // 记了入睡时已校验通过就不再重算
+    if (assets.partition_valid() && !(fast_wake_boot_ && WakeSnapshot::assets_verified())) {
+        BootSpan span("assets_checksum");
+        assets.VerifyChecksum();
+    }
+
+    // Check for new assets version
+    if (!fast_wake_boot_) {
+        BootSpan span("assets_update");
+        CheckAssetsVersion();
+    }
+
+    // 资源内容定稿后，后台预热打包器标出的热资源（表情、字体）的
+    // flash cache 页，并在主循环空闲时预解码告警提示音，首次交互不再
+    // 因 mmap 区缺页和 Opus 解码卡顿
+    if (assets.partition_valid()) {
+        xTaskCreate([](void*) {
+            Assets::GetInstance().PreloadHotAssets();
+            vTaskDelete(NULL);
+        }, "asset_warm", 3072, nullptr, 1, nullptr);
+    }
+    Schedule([this]() {
+        audio_service_.WarmSoundCache(Lang::Sounds::OGG_POPUP);
+        audio_service_.WarmSoundCache(Lang::Sounds::OGG_EXCLAMATION);
+    });
+
+    // Check for new firmware version or get the MQTT broker address
+    Ota ota;
+    {
+        BootSpan span("ota_check");
+        CheckNewVersion(ota);
+    }
+
+    // Initialize the protocol
+    display->SetStatus(Lang::Strings::LOADING_PROTOCOL);
+
+    // Add MCP common tools before initializing the protocol
+    auto& mcp_server = McpServer::GetInstance();
+    mcp_server.AddCommonTools();
+    mcp_server.AddUserOnlyTools();
+
+    // 两套配置都存在时按历史成功记录选首选传输；首选打不开时立即换
+    // 另一条重试并记住结果（见 OpenAudioChannelWithFallback）
+    bool has_mqtt_config = ota.HasMqttConfig();
+    bool has_websocket_config = ota.HasWebsocketConfig();
+    bool use_websocket = false;
+    if (has_mqtt_config && has_websocket_config) {
+        transport_fallback_available_ = true;
+        Settings settings("protocol", false);
+        use_websocket = settings.GetInt("prefer_ws", 0) != 0;
+    } else if (has_websocket_config) {
+        use_websocket = true;
+    } else if (!has_mqtt_config) {
+        ESP_LOGW(TAG, "No protocol specified in the OTA config, using MQTT");
+    }
+    SetupProtocol(use_websocket);
+
+    bool protocol_started = false;
+    {
+        BootSpan span("protocol");
+        protocol_started = protocol_->Start();
+    }
 
     SystemInfo::PrintHeapStats();
     SetDeviceState(kDeviceStateIdle);
 
+    BootProfiler::GetInstance().EndSpan("boot_total");
+    BootProfiler::GetInstance().LogSummary();
+
     has_server_time_ = ota.HasServerTime();
     if (protocol_started) {
         std::string message = std::string(Lang::Strings::VERSION) + ota.GetCurrentVersion();
@@ -547,17 +952,40 @@ void Application::Start() {
 }
 
 // Add a async task to MainLoop
-void Application::Schedule(std::function<void()> callback) {
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        main_tasks_.push_back(std::move(callback));
-    }
-    xEventGroupSetBits(event_group_, MAIN_EVENT_SCHEDULE);
-}
-
 // The Main Event Loop controls the chat state and websocket connection
 // If other tasks need to access the websocket or chat state,
 // they should use Schedule to call this function
+void Application::ScheduleClockTick() {
+    // Tickless 时钟：不再以 1Hz 周期唤醒主循环，而是取"下一个整分钟
+    // （状态栏时钟翻页）"和"下一个 10 秒检查点（状态栏增量刷新、调试
+    // 统计）"中较近的截止时间做单次定时。屏幕处于省电状态时跳过 10 秒
+    // 检查点，每分钟只醒一次
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    int64_t us_into_minute = (int64_t)(tv.tv_sec % 60) * 1000000 + tv.tv_usec;
+    int64_t delay_us = 60 * 1000000LL - us_into_minute;
+    auto display = Board::GetInstance().GetDisplay();
+    if (!display->power_save_mode()) {
+        const int64_t check_interval_us = 10 * 1000000LL;
+        int64_t to_check_us = check_interval_us - us_into_minute % check_interval_us;
+        if (to_check_us < delay_us) {
+            delay_us = to_check_us;
+        }
+    }
+    // 定时器提前少许到期时重算出的间隔可能极小，压到至少 100ms 防止空转
+    if (delay_us < 100000) {
+        delay_us = 100000;
+    }
+    esp_timer_stop(clock_timer_handle_);
+    esp_timer_start_once(clock_timer_handle_, delay_us);
+}
+
+void Application::RearmClockTick() {
+    if (event_group_ != nullptr) {
+        xEventGroupSetBits(event_group_, MAIN_EVENT_CLOCK_TICK);
+    }
+}
+
 void Application::MainEventLoop() {
     while (true) {
         auto bits = xEventGroupWaitBits(event_group_, MAIN_EVENT_SCHEDULE |
@@ -572,14 +1000,7 @@ void Application::MainEventLoop() {
             Alert(Lang::Strings::ERROR, last_error_message_.c_str(), "circle_xmark", Lang::Sounds::OGG_EXCLAMATION);
         }
 
-        if (bits & MAIN_EVENT_SEND_AUDIO) {
-            while (auto packet = audio_service_.PopPacketFromSendQueue()) {
-                if (protocol_ && !protocol_->SendAudio(std::move(packet))) {
-                    break;
-                }
-            }
-        }
-
+        // 交互相关的事件先于排队任务处理，避免 UI 任务积压拖慢唤醒响应
         if (bits & MAIN_EVENT_WAKE_WORD_DETECTED) {
             OnWakeWordDetected();
         }
@@ -589,28 +1010,150 @@ void Application::MainEventLoop() {
                 auto led = Board::GetInstance().GetLed();
                 led->OnStateChanged();
             }
+#if CONFIG_USE_VAD_BARGE_IN
+            // 插话快速通路：设备端 AEC 时 VAD 跑在回声消除之后，播放中
+            // VAD 亮起即用户在说话，直接中止服务端播报，不必等唤醒词。
+            // 实时模式下麦克风本就在持续采集编码，握手期间的语音帧会在
+            // 发送队列里排队送达，不会丢
+            else if (device_state_ == kDeviceStateSpeaking &&
+                     audio_service_.IsVoiceDetected() &&
+                     aec_mode_ == kAecOnDeviceSide &&
+                     listening_mode_ == kListeningModeRealtime) {
+                int64_t now_us = esp_timer_get_time();
+                // 限速：残余回声偶发误触 VAD 时不至于反复打断
+                if (now_us - last_barge_in_us_ > 2000 * 1000) {
+                    last_barge_in_us_ = now_us;
+                    ESP_LOGI(TAG, "VAD barge-in, abort speaking");
+                    AbortSpeaking(kAbortReasonNone);
+                }
+            }
+#endif
+        }
+
+        if (bits & MAIN_EVENT_SEND_AUDIO) {
+            while (auto packet = audio_service_.PopPacketFromSendQueue()) {
+                if (protocol_ && !protocol_->SendAudio(std::move(packet))) {
+                    break;
+                }
+                LatencyScoreboard::GetInstance().Mark(LatencyScoreboard::kFirstUplinkAudio);
+            }
         }
 
         if (bits & MAIN_EVENT_SCHEDULE) {
-            std::unique_lock<std::mutex> lock(mutex_);
-            auto tasks = std::move(main_tasks_);
-            lock.unlock();
-            for (auto& task : tasks) {
-                task();
+            // 低优先级任务按时间预算分批执行：预算用完或有高优先级事件
+            // 到达时让出去，剩余任务重新置位 MAIN_EVENT_SCHEDULE 留到
+            // 下一轮
+            const int64_t budget_us = 20 * 1000;
+            const EventBits_t urgent_bits = MAIN_EVENT_ERROR |
+                MAIN_EVENT_WAKE_WORD_DETECTED | MAIN_EVENT_VAD_CHANGE;
+            int64_t start_us = esp_timer_get_time();
+            bool yielded = false;
+            while (scheduled_tasks_.PopAndInvoke()) {
+                if (esp_timer_get_time() - start_us > budget_us ||
+                        (xEventGroupGetBits(event_group_) & urgent_bits) != 0) {
+                    yielded = true;
+                    break;
+                }
+            }
+            if (!yielded) {
+                // 溢出队列只在环满或回调过大时才会有内容
+                std::unique_lock<std::mutex> lock(mutex_);
+                auto tasks = std::move(main_tasks_);
+                lock.unlock();
+                while (!tasks.empty()) {
+                    auto task = std::move(tasks.front());
+                    tasks.pop_front();
+                    task();
+                    if (esp_timer_get_time() - start_us > budget_us ||
+                            (xEventGroupGetBits(event_group_) & urgent_bits) != 0) {
+                        yielded = true;
+                        break;
+                    }
+                }
+                if (!tasks.empty()) {
+                    // 没跑完的放回队列头部，保持原有顺序
+                    lock.lock();
+                    main_tasks_.insert(main_tasks_.begin(),
+                        std::make_move_iterator(tasks.begin()), std::make_move_iterator(tasks.end()));
+                    lock.unlock();
+                }
+            }
+            bool overflow_pending = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                overflow_pending = !main_tasks_.empty();
+            }
+            if (yielded || overflow_pending || !scheduled_tasks_.Empty()) {
+                xEventGroupSetBits(event_group_, MAIN_EVENT_SCHEDULE);
+                taskYIELD();
             }
         }
 
         if (bits & MAIN_EVENT_CLOCK_TICK) {
-            clock_ticks_++;
             auto display = Board::GetInstance().GetDisplay();
-            display->UpdateStatusBar();
-        
-            // Print the debug info every 10 seconds
-            if (clock_ticks_ % 10 == 0) {
+            // 息屏时不刷新状态栏，免得白白唤醒 LVGL 任务
+            if (!display->power_save_mode()) {
+                display->UpdateStatusBar();
+            }
+            // 1Hz 采样无线链路质量，劣化时提前收紧音频发送拥塞阈值
+            Board::GetInstance().SampleRadioQuality();
+
+            // Print the debug info every 10 seconds (once per minute while
+            // the display sleeps, since that is the only remaining wakeup)
+            int64_t now_us = esp_timer_get_time();
+            int64_t dump_period_us = debug_dump_period_s_.load(std::memory_order_relaxed) * 1000000LL;
+            if (now_us - last_debug_dump_us_ >= dump_period_us) {
+                last_debug_dump_us_ = now_us;
                 // SystemInfo::PrintTaskCpuUsage(pdMS_TO_TICKS(1000));
                 // SystemInfo::PrintTaskList();
-                SystemInfo::PrintHeapStats();
+                HeapTelemetry::GetInstance().LogCompact();
+                HeapTelemetry::GetInstance().CheckFragmentation();
+                MemoryBudget::GetInstance().Dump();
+                // 电量掉格检测 + 耗电画像（CONFIG_POWER_PROFILER 关闭时为空操作）
+                PowerProfiler::GetInstance().Sample();
+                SystemInfo::PrintPowerProfile();
+                ThermalMonitor::GetInstance().Dump();
+                LatencyScoreboard::GetInstance().DumpIfFresh();
+
+                // Transport health counters, useful to split "server slow"
+                // from "radio slow" in the field
+                audio_service_.DumpQueueStatistics();
+                FlashOpMonitor::GetInstance().Dump();
+                Settings::DumpHealth();
+                // 空闲态顺手做 NVS 维护（内部限频），页回收的停顿
+                // 不留给下一次交互中的提交
+                if (device_state_ == kDeviceStateIdle) {
+                    Settings::CompactIfDegraded();
+                }
+
+                if (protocol_ && protocol_->IsAudioChannelOpened()) {
+                    protocol_->DumpNetworkStatistics();
+
+                    // 唤醒词质量窗口到期才返回非空，顺带清零计数
+                    auto report = WakeWordMetrics::GetInstance().TakeReport();
+                    if (!report.empty()) {
+                        protocol_->SendTelemetry("wake_word", report);
+                    }
+
+                    // 音频队列动态同周期上报："卡了一下"的报障从此有数据可查
+                    if (now_us - last_queue_telemetry_us_ >= 1800 * 1000000LL) {
+                        last_queue_telemetry_us_ = now_us;
+                        protocol_->SendTelemetry("audio_queues",
+                                                 audio_service_.GetQueueStatisticsJson());
+                        // 链路质量同周期上报，和队列动态对得上号
+                        auto radio = Board::GetInstance().GetRadioTelemetryJson();
+                        if (!radio.empty()) {
+                            protocol_->SendTelemetry("radio", radio);
+                        }
+                        // NVS 磨损趋势：老化设备的提交时延悄悄变差，上报了才看得见
+                        auto nvs_health = Settings::GetHealthJson();
+                        if (!nvs_health.empty()) {
+                            protocol_->SendTelemetry("nvs", nvs_health);
+                        }
+                    }
+                }
             }
+            ScheduleClockTick();
         }
     }
 }
@@ -621,11 +1164,28 @@ void Application::OnWakeWordDetected() {
     }
 
     if (device_state_ == kDeviceStateIdle) {
+        LatencyScoreboard::GetInstance().BeginRound();
         audio_service_.EncodeWakeWord();
 
         if (!protocol_->IsAudioChannelOpened()) {
             SetDeviceState(kDeviceStateConnecting);
-            if (!protocol_->OpenAudioChannel()) {
+#if CONFIG_USE_PREDICTIVE_CAPTURE
+            // 预测性采集：不等握手，先把处理器和编码器跑起来，用户紧跟
+            // 唤醒词说的首音节进发送队列攒着（约 2.4 秒容量）。握手在本
+            // 任务上阻塞，MAIN_EVENT_SEND_AUDIO 要等本函数返回才会被处理，
+            // 所以攒下的包天然排在 start-listening 之后依序放出
+            predictive_capture_active_ = true;
+            audio_service_.EnableWakeWordDetection(false);
+            audio_service_.EnableVoiceProcessing(true);
+#endif
+            if (!OpenAudioChannelWithFallback()) {
+#if CONFIG_USE_PREDICTIVE_CAPTURE
+                // 开通道失败：停掉采集并丢弃攒下的包，免得下次会话把这次
+                // 的音节当开场白送出去
+                predictive_capture_active_ = false;
+                audio_service_.EnableVoiceProcessing(false);
+                while (audio_service_.PopPacketFromSendQueue()) {}
+#endif
                 audio_service_.EnableWakeWordDetection(true);
                 return;
             }
@@ -633,10 +1193,12 @@ void Application::OnWakeWordDetected() {
 
         auto wake_word = audio_service_.GetLastWakeWord();
         ESP_LOGI(TAG, "Wake word detected: %s", wake_word.c_str());
+        WakeWordMetrics::GetInstance().OnSessionStart();
 #if CONFIG_SEND_WAKE_WORD_DATA
         // Encode and send the wake word data to the server
         while (auto packet = audio_service_.PopWakeWordPacket()) {
             protocol_->SendAudio(std::move(packet));
+            LatencyScoreboard::GetInstance().Mark(LatencyScoreboard::kFirstUplinkAudio);
         }
         // Set the chat state to wake word detected
         protocol_->SendWakeWordDetected(wake_word);
@@ -656,6 +1218,8 @@ void Application::OnWakeWordDetected() {
 void Application::AbortSpeaking(AbortReason reason) {
     ESP_LOGI(TAG, "Abort speaking");
     aborted_ = true;
+    // 紧跟唤醒的中止在指标里按疑似误唤醒计（窗口判定在指标内部）
+    WakeWordMetrics::GetInstance().OnSessionAborted();
     if (protocol_) {
         protocol_->SendAbortSpeaking(reason);
     }
@@ -671,46 +1235,52 @@ void Application::SetDeviceState(DeviceState state) {
         return;
     }
     
-    clock_ticks_ = 0;
+    // 状态刚切换时推迟下一次调试统计，日志里先让出位置给状态相关输出
+    last_debug_dump_us_ = esp_timer_get_time();
     auto previous_state = device_state_;
     device_state_ = state;
     ESP_LOGI(TAG, "STATE: %s", STATE_STRINGS[device_state_]);
+    TRACE_EVENT(TracePoint::kStateChange, ((uint16_t)previous_state << 8) | (uint16_t)state);
 
-    // Send the state change event
+    // Send the state change event. Sync listeners run inline here; the
+    // LED/display feedback lives in the async tier (see the constructor)
+    // and is not waited for
     DeviceStateEventManager::GetInstance().PostStateChangeEvent(previous_state, state);
 
-    auto& board = Board::GetInstance();
-    auto display = board.GetDisplay();
-    auto led = board.GetLed();
-    led->OnStateChanged();
+#if CONFIG_USE_LP_WAKE_PRESCREEN
+    // 只有空闲态允许把常开监听降级到 LP VAD 预筛
+    audio_service_.EnableLpPrescreen(state == kDeviceStateIdle);
+#endif
+
     switch (state) {
         case kDeviceStateUnknown:
         case kDeviceStateIdle:
-            display->SetStatus(Lang::Strings::STANDBY);
-            display->SetEmotion("neutral");
+#if CONFIG_USE_PREDICTIVE_CAPTURE
+            predictive_capture_active_ = false;
+#endif
             audio_service_.EnableVoiceProcessing(false);
             audio_service_.EnableWakeWordDetection(true);
             break;
-        case kDeviceStateConnecting:
-            display->SetStatus(Lang::Strings::CONNECTING);
-            display->SetEmotion("neutral");
-            display->SetChatMessage("system", "");
-            break;
         case kDeviceStateListening:
-            display->SetStatus(Lang::Strings::LISTENING);
-            display->SetEmotion("neutral");
-
             // Make sure the audio processor is running
             if (!audio_service_.IsAudioProcessorRunning()) {
                 // Send the start listening command
                 protocol_->SendStartListening(listening_mode_);
+                LatencyScoreboard::GetInstance().Mark(LatencyScoreboard::kStartListening);
                 audio_service_.EnableVoiceProcessing(true);
                 audio_service_.EnableWakeWordDetection(false);
             }
+#if CONFIG_USE_PREDICTIVE_CAPTURE
+            else if (predictive_capture_active_) {
+                // 预测性采集期间处理器已经在跑了，只补上 start-listening。
+                // 返回主循环后 MAIN_EVENT_SEND_AUDIO 立刻放出攒下的包
+                predictive_capture_active_ = false;
+                protocol_->SendStartListening(listening_mode_);
+                LatencyScoreboard::GetInstance().Mark(LatencyScoreboard::kStartListening);
+            }
+#endif
             break;
         case kDeviceStateSpeaking:
-            display->SetStatus(Lang::Strings::SPEAKING);
-
             if (listening_mode_ != kListeningModeRealtime) {
                 audio_service_.EnableVoiceProcessing(false);
                 // Only AFE wake word can be detected in speaking mode
@@ -733,10 +1303,62 @@ void Application::Reboot() {
     protocol_.reset();
     audio_service_.Stop();
 
+    // 把写后缓存里还没落盘的设置同步写入 NVS
+    Settings::FlushAll();
+
     vTaskDelay(pdMS_TO_TICKS(1000));
     esp_restart();
 }
 
+bool Application::OpenAudioChannelWithFallback() {
+    if (protocol_->OpenAudioChannel()) {
+        return true;
+    }
+    if (!transport_fallback_available_) {
+        return false;
+    }
+    // 首选传输打不开就立刻换另一条传输重试，而不是把整个超时留给用户
+    // 下一次再试
+    bool use_websocket = !protocol_is_websocket_;
+    ESP_LOGW(TAG, "Preferred transport failed, falling back to %s", use_websocket ? "websocket" : "mqtt");
+    SetupProtocol(use_websocket);
+    protocol_->Start();
+    if (protocol_->OpenAudioChannel()) {
+        // 清掉首选传输失败挂起的错误提示，并记住这条成功的传输
+        xEventGroupClearBits(event_group_, MAIN_EVENT_ERROR);
+        Settings settings("protocol", true);
+        settings.SetInt("prefer_ws", use_websocket ? 1 : 0);
+        return true;
+    }
+    return false;
+}
+
+void Application::ReopenAudioChannel() {
+    if (!protocol_) {
+        return;
+    }
+    // 新链路的 DNS 表是冷的，先把重解析提前到现在
+    DnsPrefetch::GetInstance().RefreshNow();
+    bool resume = device_state_ == kDeviceStateListening ||
+                  device_state_ == kDeviceStateSpeaking ||
+                  device_state_ == kDeviceStateConnecting;
+    auto mode = listening_mode_;
+    if (protocol_->IsAudioChannelOpened()) {
+        protocol_->CloseAudioChannel();
+    }
+    if (!resume) {
+        return;
+    }
+    // 关闭回调会调度一次回到 idle 的状态切换，重建放到其后执行，
+    // 避免刚恢复的监听状态被覆盖
+    Schedule([this, mode]() {
+        SetDeviceState(kDeviceStateConnecting);
+        if (OpenAudioChannelWithFallback()) {
+            SetListeningMode(mode);
+        }
+    });
+}
+
 bool Application::UpgradeFirmware(Ota& ota, const std::string& url) {
     auto& board = Board::GetInstance();
     auto display = board.GetDisplay();
@@ -800,7 +1422,7 @@ void Application::WakeWordInvoke(const std::string& wake_word) {
 
         if (!protocol_->IsAudioChannelOpened()) {
             SetDeviceState(kDeviceStateConnecting);
-            if (!protocol_->OpenAudioChannel()) {
+            if (!OpenAudioChannelWithFallback()) {
                 audio_service_.EnableWakeWordDetection(true);
                 return;
             }
@@ -865,6 +1487,14 @@ void Application::SendMcpMessage(const std::string& payload) {
     }
 }
 
+uint32_t Application::SendMcpAttachment(const std::string& data) {
+    if (protocol_ == nullptr) {
+        return 0;
+    }
+    // Enqueues on the protocol's outbound lane, safe from any task
+    return protocol_->SendBinaryAttachment(data);
+}
+
 void Application::SetAecMode(AecMode mode) {
     aec_mode_ = mode;
     Schedule([this]() {
@@ -10,7 +10,9 @@
 #include <mutex>
 #include <deque>
 #include <memory>
+#include <atomic>
 
+#include "callable_ring.h"
 #include "protocol.h"
 #include "ota.h"
 #include "audio_service.h"
@@ -46,8 +48,22 @@ public:
     void MainEventLoop();
     DeviceState GetDeviceState() const { return device_state_; }
     bool IsVoiceDetected() const { return audio_service_.IsVoiceDetected(); }
-    void Schedule(std::function<void()> callback);
+    // 后台下载等低优先级工作据此让出带宽；协议未建立时视为未打开
+    bool IsAudioChannelOpened() const { return protocol_ != nullptr && protocol_->IsAudioChannelOpened(); }
+    // 音频/协议等高优先级任务把回调投递到主循环执行。捕获不超过 48 字节
+    // 的回调走无锁环形队列，不会分配堆内存也不会争抢锁；环满或回调过大
+    // 时才退回 mutex 保护的溢出队列
+    template <typename F>
+    void Schedule(F&& callback) {
+        if (!scheduled_tasks_.Push(std::forward<F>(callback))) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            main_tasks_.push_back(std::forward<F>(callback));
+        }
+        xEventGroupSetBits(event_group_, MAIN_EVENT_SCHEDULE);
+    }
     void SetDeviceState(DeviceState state);
+    // 息屏状态变化时由显示层调用，立即触发一次时钟节拍并重算下一个截止时间
+    void RearmClockTick();
     void Alert(const char* status, const char* message, const char* emotion = "", const std::string_view& sound = "");
     void DismissAlert();
     void AbortSpeaking(AbortReason reason);
@@ -55,10 +71,14 @@ public:
     void StartListening();
     void StopListening();
     void Reboot();
+    // 网络链路切换后在新链路上重建音频通道（见 DualNetworkBoard::SwitchToStandby）
+    void ReopenAudioChannel();
     void WakeWordInvoke(const std::string& wake_word);
     bool UpgradeFirmware(Ota& ota, const std::string& url = "");
     bool CanEnterSleepMode();
     void SendMcpMessage(const std::string& payload);
+    // Returns the attachment id, or 0 when the protocol has no binary channel
+    uint32_t SendMcpAttachment(const std::string& data);
     void SetAecMode(AecMode mode);
     AecMode GetAecMode() const { return aec_mode_; }
     void PlaySound(const std::string_view& sound);
@@ -69,7 +89,8 @@ private:
     ~Application();
 
     std::mutex mutex_;
-    std::deque<std::function<void()>> main_tasks_;
+    CallableRing<16, 48> scheduled_tasks_;
+    std::deque<std::function<void()>> main_tasks_;  // scheduled_tasks_ 的溢出队列
     std::unique_ptr<Protocol> protocol_;
     EventGroupHandle_t event_group_ = nullptr;
     esp_timer_handle_t clock_timer_handle_ = nullptr;
@@ -81,12 +102,35 @@ private:
 
     bool has_server_time_ = false;
     bool aborted_ = false;
-    int clock_ticks_ = 0;
+    // OTA 同时下发 MQTT 和 WebSocket 配置时才允许在两条传输之间回退
+    bool transport_fallback_available_ = false;
+    bool protocol_is_websocket_ = false;
+    int64_t last_debug_dump_us_ = 0;
+    // 调试统计节拍（秒），机群可调（"dbg_dump_s"）：注册表写、主循环读
+    std::atomic<int> debug_dump_period_s_{10};
+    int64_t last_barge_in_us_ = 0;
+    int64_t last_queue_telemetry_us_ = 0;
     TaskHandle_t check_new_version_task_handle_ = nullptr;
+    std::atomic<bool> deferred_upgrade_active_{false};
+    // 深睡快速唤醒：本次启动命中了有效的 RTC 快照（见 wake_snapshot.h）
+    bool fast_wake_boot_ = false;
+#if CONFIG_USE_PREDICTIVE_CAPTURE
+    // 唤醒后握手期间已提前开启采集编码，进入监听态时只需补发 start-listening
+    bool predictive_capture_active_ = false;
+#endif
     TaskHandle_t main_event_loop_task_handle_ = nullptr;
 
     void OnWakeWordDetected();
+    void ScheduleClockTick();
+    // 构造指定传输的协议实例并接好全部回调；回退换传输时会再次调用
+    void SetupProtocol(bool use_websocket);
+    // 首选传输打不开时立刻换另一条重试，成功后把偏好写进 Settings
+    bool OpenAudioChannelWithFallback();
     void CheckNewVersion(Ota& ota);
+    void RevalidateVersionInBackground();
+    // OTA 窗口调度器：等设备持续空闲后限速预装新固件，静默时段再重启激活
+    void StartDeferredUpgrade();
+    void DeferredUpgradeTask();
     void CheckAssetsVersion();
     void ShowActivationCode(const std::string& code, const std::string& message);
     void SetListeningMode(ListeningMode mode);
@@ -2,8 +2,11 @@
 #include "board.h"
 #include "display.h"
 #include "application.h"
+#include "settings.h"
 #include "lvgl_theme.h"
 #include "emote_display.h"
+#include "json_arena.h"
+#include "flash_op_monitor.h"
 #ifdef HAVE_LVGL
 #include "display/lcd_display.h"
 #endif
@@ -11,8 +14,14 @@
 #include <esp_log.h>
 #include <spi_flash_mmap.h>
 #include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <cbin_font.h>
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
 
 #define TAG "Assets"
 
@@ -26,8 +35,9 @@ struct mmap_assets_table {
 
 
 Assets::Assets() {
-    // Initialize the partition
-    InitializePartition();
+    // Initialize the partition. 启动时先不算整片分区的校验和，
+    // Application 在联网之后调用 VerifyChecksum() 补算
+    InitializePartition(false);
 }
 
 Assets::~Assets() {
@@ -44,15 +54,37 @@ uint32_t Assets::CalculateChecksum(const char* data, uint32_t length) {
     return checksum & 0xFFFF;
 }
 
-bool Assets::InitializePartition() {
+bool Assets::InitializePartition(bool verify_checksum) {
     partition_valid_ = false;
     checksum_valid_ = false;
-    assets_.clear();
+    checksum_pending_ = false;
+    asset_table_ = nullptr;
+    asset_count_ = 0;
+    asset_data_start_ = 0;
+    asset_table_sorted_ = false;
 
-    partition_ = esp_partition_find_first(ESP_PARTITION_TYPE_ANY, ESP_PARTITION_SUBTYPE_ANY, "assets");
     if (partition_ == nullptr) {
-        ESP_LOGI(TAG, "No assets partition found");
-        return false;
+        // 单分区布局用 "assets"；A/B 双槽布局用 "assets_A"/"assets_B"，
+        // 生效槽位记录在 NVS（assets/active_slot），下载永远写备槽。
+        // 只有 A 槽的旧布局按单分区处理
+        partition_ = esp_partition_find_first(ESP_PARTITION_TYPE_ANY, ESP_PARTITION_SUBTYPE_ANY, "assets");
+        if (partition_ == nullptr) {
+            auto slot_a = esp_partition_find_first(ESP_PARTITION_TYPE_ANY, ESP_PARTITION_SUBTYPE_ANY, "assets_A");
+            auto slot_b = esp_partition_find_first(ESP_PARTITION_TYPE_ANY, ESP_PARTITION_SUBTYPE_ANY, "assets_B");
+            if (slot_a != nullptr && slot_b != nullptr) {
+                Settings settings("assets", false);
+                bool use_b = settings.GetInt("active_slot") == 1;
+                partition_ = use_b ? slot_b : slot_a;
+                inactive_partition_ = use_b ? slot_a : slot_b;
+                ESP_LOGI(TAG, "Dual assets slots, active %s", partition_->label);
+            } else {
+                partition_ = slot_a;
+            }
+        }
+        if (partition_ == nullptr) {
+            ESP_LOGI(TAG, "No assets partition found");
+            return false;
+        }
     }
 
     int free_pages = spi_flash_mmap_get_free_pages(SPI_FLASH_MMAP_DATA);
@@ -80,64 +112,256 @@ bool Assets::InitializePartition() {
         ESP_LOGD(TAG, "The stored_len (0x%lx) is greater than the partition size (0x%lx) - 12", stored_len, partition_->size);
         return false;
     }
+    if (12 + sizeof(mmap_assets_table) * stored_files > 12 + stored_len) {
+        ESP_LOGE(TAG, "The file table does not fit the stored length");
+        return false;
+    }
+
+    stored_checksum_ = stored_chksum;
+    stored_length_ = stored_len;
+    checksum_pending_ = true;
+
+    // 文件表就留在 mmap 区域里按需查找，不再复制到堆上；打包脚本按文件名
+    // 排序生成文件表，这里只验证一次有序性，旧格式的资源包退回线性查找
+    asset_table_ = (const mmap_assets_table*)(mmap_root_ + 12);
+    asset_count_ = stored_files;
+    asset_data_start_ = 12 + sizeof(mmap_assets_table) * stored_files;
+    asset_table_sorted_ = true;
+    for (uint32_t i = 0; i + 1 < stored_files; i++) {
+        if (strncmp(asset_table_[i].asset_name, asset_table_[i + 1].asset_name, sizeof(asset_table_[i].asset_name)) >= 0) {
+            asset_table_sorted_ = false;
+            break;
+        }
+    }
+
+    if (verify_checksum) {
+        return VerifyChecksum();
+    }
+    return true;
+}
+
+bool Assets::VerifyChecksum() {
+    if (!checksum_pending_) {
+        return checksum_valid_;
+    }
+    checksum_pending_ = false;
 
     auto start_time = esp_timer_get_time();
-    uint32_t calculated_checksum = CalculateChecksum(mmap_root_ + 12, stored_len);
+    uint32_t calculated_checksum = CalculateChecksum(mmap_root_ + 12, stored_length_);
     auto end_time = esp_timer_get_time();
     ESP_LOGI(TAG, "The checksum calculation time is %d ms", int((end_time - start_time) / 1000));
 
-    if (calculated_checksum != stored_chksum) {
-        ESP_LOGE(TAG, "The calculated checksum (0x%lx) does not match the stored checksum (0x%lx)", calculated_checksum, stored_chksum);
+    if (calculated_checksum != stored_checksum_) {
+        ESP_LOGE(TAG, "The calculated checksum (0x%lx) does not match the stored checksum (0x%lx)", calculated_checksum, stored_checksum_);
+        // 分区内容不可信，使文件表失效，等待重新下载
+        asset_table_ = nullptr;
+        asset_count_ = 0;
         return false;
     }
 
     checksum_valid_ = true;
+    return true;
+}
+
+void Assets::PreloadHotAssets() {
+    if (asset_table_ == nullptr) {
+        return;
+    }
+    cJSON* root = ParseIndex();
+    if (root == nullptr) {
+        return;
+    }
+    cJSON* preload = cJSON_GetObjectItem(root, "preload");
+    if (!cJSON_IsArray(preload)) {
+        cJSON_Delete(root);
+        return;
+    }
 
-    for (uint32_t i = 0; i < stored_files; i++) {
-        auto item = (const mmap_assets_table*)(mmap_root_ + 12 + i * sizeof(mmap_assets_table));
-        auto asset = Asset{
-            .size = static_cast<size_t>(item->asset_size),
-            .offset = static_cast<size_t>(12 + sizeof(mmap_assets_table) * stored_files + item->asset_offset)
-        };
-        assets_[item->asset_name] = asset;
+    // 首次播放提示音、首次渲染表情的卡顿来自 mmap 区域的 flash cache
+    // 缺页，这里在后台把热资源的每个 cache 行都读一遍。校验和补算刚扫过
+    // 整个分区，热资源多半已被换出，所以这一趟必须排在它之后
+    auto start_time = esp_timer_get_time();
+    size_t warmed_bytes = 0;
+    int count = cJSON_GetArraySize(preload);
+    for (int i = count - 1; i >= 0; i--) {
+        cJSON* name = cJSON_GetArrayItem(preload, i);
+        if (!cJSON_IsString(name)) {
+            continue;
+        }
+        void* ptr = nullptr;
+        size_t size = 0;
+        if (!GetAssetData(name->valuestring, ptr, size)) {
+            ESP_LOGW(TAG, "Preload asset %s is not found", name->valuestring);
+            continue;
+        }
+        auto data = static_cast<const volatile char*>(ptr);
+        uint32_t sink = 0;
+        for (size_t offset = 0; offset < size; offset += 32) {
+            sink += data[offset];
+        }
+        (void)sink;
+        warmed_bytes += size;
+        // 低优先级任务上运行，让出 CPU 避免挤占启动尾声的其它工作
+        vTaskDelay(1);
     }
-    return checksum_valid_;
+    cJSON_Delete(root);
+    ESP_LOGI(TAG, "Warmed %u bytes of hot assets in %d ms", warmed_bytes,
+             int((esp_timer_get_time() - start_time) / 1000));
 }
 
-bool Assets::Apply() {
+// 预读粒度：一次触碰一页，与 mmap flash cache 的换页粒度对齐
+static constexpr size_t PREFETCH_PAGE_SIZE = 32 * 1024;
+
+struct PrefetchRequest {
+    const volatile char* ptr;
+    size_t length;
+};
+
+void Assets::Prefetch(const void* cursor, size_t remaining) {
+    if (mmap_root_ == nullptr || partition_ == nullptr || cursor == nullptr) {
+        return;
+    }
+    auto addr = reinterpret_cast<uintptr_t>(cursor);
+    auto base = reinterpret_cast<uintptr_t>(mmap_root_);
+    if (addr < base || addr >= base + partition_->size) {
+        // 堆上的数据（已拷贝出 mmap 区域的资源）没有缺页问题
+        return;
+    }
+    // 消费者当前页之后的下一页；已经越过流末尾或分区末尾就没什么可预读
+    uintptr_t page = (addr + PREFETCH_PAGE_SIZE) & ~(uintptr_t)(PREFETCH_PAGE_SIZE - 1);
+    if (page >= addr + remaining || page >= base + partition_->size) {
+        return;
+    }
+    if (prefetch_last_page_.exchange(page) == page) {
+        // 这一页已经入过队，渲染循环里每帧都会走到的快速路径
+        return;
+    }
+
+    if (prefetch_queue_ == nullptr) {
+        prefetch_queue_ = xQueueCreate(4, sizeof(PrefetchRequest));
+        if (prefetch_queue_ == nullptr) {
+            return;
+        }
+        // 优先级低于渲染任务：只有渲染在等下一帧时才真正去触碰 flash
+        xTaskCreate([](void* arg) {
+            static_cast<Assets*>(arg)->PrefetchTask();
+            vTaskDelete(NULL);
+        }, "asset_ra", 2048, this, 1, nullptr);
+    }
+
+    PrefetchRequest request;
+    request.ptr = reinterpret_cast<const volatile char*>(page);
+    request.length = std::min(PREFETCH_PAGE_SIZE, size_t(addr + remaining - page));
+    if (xQueueSend(prefetch_queue_, &request, 0) != pdTRUE) {
+        // 队列满就放弃这一页，预读只是优化；清掉水位让下次调用重试
+        prefetch_last_page_ = 0;
+    }
+}
+
+void Assets::PrefetchTask() {
+    PrefetchRequest request;
+    while (xQueueReceive(prefetch_queue_, &request, portMAX_DELAY) == pdTRUE) {
+        // 每个 cache 行读一个字节就足以触发整行装载
+        uint32_t sink = 0;
+        for (size_t offset = 0; offset < request.length; offset += 32) {
+            sink += request.ptr[offset];
+        }
+        (void)sink;
+    }
+}
+
+void Assets::SwitchToInactiveSlot() {
+    if (mmap_handle_ != 0) {
+        esp_partition_munmap(mmap_handle_);
+        mmap_handle_ = 0;
+        mmap_root_ = nullptr;
+    }
+    std::swap(partition_, inactive_partition_);
+    Settings settings("assets", true);
+    settings.SetInt("active_slot", strcmp(partition_->label, "assets_B") == 0 ? 1 : 0);
+    ESP_LOGI(TAG, "Switched active assets slot to %s", partition_->label);
+}
+
+const mmap_assets_table* Assets::FindAssetEntry(const char* name) const {
+    if (asset_table_ == nullptr) {
+        return nullptr;
+    }
+    if (asset_table_sorted_) {
+        uint32_t lo = 0, hi = asset_count_;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            int cmp = strncmp(name, asset_table_[mid].asset_name, sizeof(asset_table_[mid].asset_name));
+            if (cmp == 0) {
+                return &asset_table_[mid];
+            }
+            if (cmp < 0) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < asset_count_; i++) {
+        if (strncmp(name, asset_table_[i].asset_name, sizeof(asset_table_[i].asset_name)) == 0) {
+            return &asset_table_[i];
+        }
+    }
+    return nullptr;
+}
+
+cJSON* Assets::ParseIndex() {
     void* ptr = nullptr;
     size_t size = 0;
     if (!GetAssetData("index.json", ptr, size)) {
         ESP_LOGE(TAG, "The index.json file is not found");
-        return false;
+        return nullptr;
     }
 
     cJSON* root = cJSON_ParseWithLength(static_cast<char*>(ptr), size);
     if (root == nullptr) {
         ESP_LOGE(TAG, "The index.json file is not valid");
-        return false;
+        return nullptr;
     }
 
     cJSON* version = cJSON_GetObjectItem(root, "version");
     if (cJSON_IsNumber(version)) {
         if (version->valuedouble > 1) {
             ESP_LOGE(TAG, "The assets version %d is not supported, please upgrade the firmware", version->valueint);
-            return false;
+            cJSON_Delete(root);
+            return nullptr;
         }
     }
-    
+    return root;
+}
+
+bool Assets::Apply() {
+    return ApplyModels() && ApplyUi();
+}
+
+bool Assets::ApplyModels() {
+    cJSON* root = ParseIndex();
+    if (root == nullptr) {
+        return false;
+    }
+
+    void* ptr = nullptr;
+    size_t size = 0;
     cJSON* srmodels = cJSON_GetObjectItem(root, "srmodels");
     if (cJSON_IsString(srmodels)) {
         std::string srmodels_file = srmodels->valuestring;
         if (GetAssetData(srmodels_file, ptr, size)) {
-            if (models_list_ != nullptr) {
-                esp_srmodel_deinit(models_list_);
-                models_list_ = nullptr;
-            }
-            models_list_ = srmodel_load(static_cast<uint8_t*>(ptr));
-            if (models_list_ != nullptr) {
+            auto new_list = srmodel_load(static_cast<uint8_t*>(ptr));
+            if (new_list != nullptr) {
+                // 热切换：先退住检测引擎、换上新列表重建，再释放旧列表。
+                // 旧列表必须晚于旧引擎销毁释放，检测任务退出前还在用它
+                auto old_list = models_list_;
+                models_list_ = new_list;
                 auto& app = Application::GetInstance();
-                app.GetAudioService().SetModelsList(models_list_);
+                app.GetAudioService().SwapModelsList(models_list_);
+                if (old_list != nullptr) {
+                    esp_srmodel_deinit(old_list);
+                }
             } else {
                 ESP_LOGE(TAG, "Failed to load srmodels.bin");
             }
@@ -146,7 +370,19 @@ bool Assets::Apply() {
         }
     }
 
+    cJSON_Delete(root);
+    return true;
+}
+
+bool Assets::ApplyUi() {
+    cJSON* root = ParseIndex();
+    if (root == nullptr) {
+        return false;
+    }
+
 #ifdef HAVE_LVGL
+    void* ptr = nullptr;
+    size_t size = 0;
     auto& theme_manager = LvglThemeManager::GetInstance();
     auto light_theme = theme_manager.GetTheme("light");
     auto dark_theme = theme_manager.GetTheme("dark");
@@ -155,11 +391,8 @@ bool Assets::Apply() {
     if (cJSON_IsString(font)) {
         std::string fonts_text_file = font->valuestring;
         if (GetAssetData(fonts_text_file, ptr, size)) {
-            auto text_font = std::make_shared<LvglCBinFont>(ptr);
-            if (text_font->font() == nullptr) {
-                ESP_LOGE(TAG, "Failed to load fonts.bin");
-                return false;
-            }
+            // 字体对象在主题首次使用时才创建，见 LvglCBinFont::font()
+            auto text_font = std::make_shared<LvglCBinFont>(ptr, size);
             if (light_theme != nullptr) {
                 light_theme->set_text_font(text_font);
             }
@@ -198,6 +431,25 @@ bool Assets::Apply() {
         }
     }
 
+    // 预光栅化的表情图集，精灵直接从 mmap 的 flash blit，切换表情时不再解码 PNG。
+    // 若同时配置了 emoji_collection，图集优先。
+    cJSON* emoji_atlas = cJSON_GetObjectItem(root, "emoji_atlas");
+    if (cJSON_IsString(emoji_atlas)) {
+        if (GetAssetData(emoji_atlas->valuestring, ptr, size)) {
+            auto atlas_collection = std::make_shared<AtlasEmojiCollection>();
+            if (atlas_collection->Load(ptr, size)) {
+                if (light_theme != nullptr) {
+                    light_theme->set_emoji_collection(atlas_collection);
+                }
+                if (dark_theme != nullptr) {
+                    dark_theme->set_emoji_collection(atlas_collection);
+                }
+            }
+        } else {
+            ESP_LOGE(TAG, "The emoji atlas file %s is not found", emoji_atlas->valuestring);
+        }
+    }
+
     cJSON* skin = cJSON_GetObjectItem(root, "skin");
     if (cJSON_IsObject(skin)) {
         cJSON* light_skin = cJSON_GetObjectItem(skin, "light");
@@ -264,6 +516,8 @@ bool Assets::Apply() {
     }
 
 #elif defined(CONFIG_USE_EMOTE_MESSAGE_STYLE)
+    void* ptr = nullptr;
+    size_t size = 0;
     auto &board = Board::GetInstance();
     auto display = board.GetDisplay();
     auto emote_display = dynamic_cast<emote::EmoteDisplay*>(display);
@@ -272,7 +526,7 @@ bool Assets::Apply() {
     if (cJSON_IsString(font)) {
         std::string fonts_text_file = font->valuestring;
         if (GetAssetData(fonts_text_file, ptr, size)) {
-            auto text_font = std::make_shared<LvglCBinFont>(ptr);
+            auto text_font = std::make_shared<LvglCBinFont>(ptr, size);
             if (text_font->font() == nullptr) {
                 ESP_LOGE(TAG, "Failed to load fonts.bin");
                 return false;
@@ -382,22 +636,340 @@ bool Assets::Apply() {
     return true;
 }
 
+/*
+ * 按清单增量同步资源分区。清单由 scripts/make_assets_manifest.py 生成，和资源包
+ * 放在一起（url + ".manifest.json"），列出每个文件在新镜像中的偏移、大小和校验和。
+ * 与当前分区逐文件比对后，只下载有变化的字节区间（HTTP range 请求），未变化的
+ * 文件从旧分区原地复制；资源包版本间通常只有不到 5% 的内容变化，ML307 这类慢速
+ * 链路上同步时间从几分钟降到几秒。任何一步失败都回落到全量下载。
+ */
+bool Assets::TryIncrementalSync(const std::string& url, std::function<void(int progress, size_t speed)> progress_callback) {
+    std::string manifest_url = url + ".manifest.json";
+    auto http = Board::GetInstance().AcquireHttp("assets");
+    if (!http->Open("GET", manifest_url)) {
+        ESP_LOGW(TAG, "Failed to open manifest %s, falling back to full download", manifest_url.c_str());
+        return false;
+    }
+    if (http->GetStatusCode() != 200) {
+        ESP_LOGW(TAG, "No manifest for assets (status %d), falling back to full download", http->GetStatusCode());
+        http->Close();
+        Board::GetInstance().ReleaseHttp("assets", std::move(http));
+        return false;
+    }
+
+    std::string manifest_data;
+    char buffer[512];
+    while (true) {
+        int ret = http->Read(buffer, sizeof(buffer));
+        if (ret < 0) {
+            http->Close();
+            Board::GetInstance().ReleaseHttp("assets", std::move(http));
+            return false;
+        }
+        if (ret == 0) {
+            break;
+        }
+        manifest_data.append(buffer, ret);
+    }
+    http->Close();
+    Board::GetInstance().ReleaseHttp("assets", std::move(http));
+
+    // 清单树只在本作用域内读取（SyncSpan 不含指针），用 arena 整体分配/归还。
+    // index.json 的树经 ParseIndex 跨函数传递，不适用
+    JsonArena arena;
+    cJSON* root = cJSON_ParseWithLength(manifest_data.data(), manifest_data.size());
+    if (root == nullptr) {
+        ESP_LOGW(TAG, "The assets manifest is not valid JSON");
+        return false;
+    }
+
+    cJSON* version = cJSON_GetObjectItem(root, "version");
+    cJSON* size_item = cJSON_GetObjectItem(root, "size");
+    if (!cJSON_IsNumber(version) || version->valueint != 1 || !cJSON_IsNumber(size_item)) {
+        ESP_LOGW(TAG, "Unsupported assets manifest");
+        cJSON_Delete(root);
+        return false;
+    }
+    size_t total_size = static_cast<size_t>(size_item->valuedouble);
+    if (total_size == 0 || total_size > WritePartition()->size) {
+        ESP_LOGE(TAG, "Assets manifest size (%u) does not fit partition size (%lu)", total_size, WritePartition()->size);
+        cJSON_Delete(root);
+        return false;
+    }
+
+    std::vector<SyncSpan> plan;
+    bool plan_ok = BuildSyncPlan(cJSON_GetObjectItem(root, "files"), total_size, plan);
+    cJSON_Delete(root);
+    if (!plan_ok) {
+        return false;
+    }
+
+    size_t reused = 0;
+    for (const auto& span : plan) {
+        if (span.from_old) {
+            reused += span.length;
+        }
+    }
+    ESP_LOGI(TAG, "Incremental sync: reusing %u of %u bytes from the current partition", reused, total_size);
+
+    // 单分区布局原地重写，计划定了才取消映射，后面写分区时旧数据改用
+    // esp_partition_read 读取；双槽布局写备槽，生效槽保持映射继续服务
+    if (inactive_partition_ == nullptr) {
+        if (mmap_handle_ != 0) {
+            esp_partition_munmap(mmap_handle_);
+            mmap_handle_ = 0;
+            mmap_root_ = nullptr;
+        }
+        checksum_valid_ = false;
+        asset_table_ = nullptr;
+        asset_count_ = 0;
+    }
+
+    if (!SyncFromPlan(url, plan, total_size, progress_callback)) {
+        return false;
+    }
+
+    if (inactive_partition_ != nullptr) {
+        SwitchToInactiveSlot();
+    }
+
+    // 重新映射并校验整个分区的校验和
+    if (!InitializePartition()) {
+        ESP_LOGE(TAG, "Incremental sync result failed verification");
+        if (inactive_partition_ != nullptr) {
+            // 新槽不可用，切回旧槽保底，再由全量下载重试
+            SwitchToInactiveSlot();
+            InitializePartition();
+        }
+        return false;
+    }
+    return true;
+}
+
+bool Assets::BuildSyncPlan(cJSON* files, size_t total_size, std::vector<SyncSpan>& plan) {
+    if (!cJSON_IsArray(files)) {
+        return false;
+    }
+
+    std::vector<SyncSpan> copies;
+    int count = cJSON_GetArraySize(files);
+    for (int i = 0; i < count; i++) {
+        cJSON* file = cJSON_GetArrayItem(files, i);
+        cJSON* name = cJSON_GetObjectItem(file, "name");
+        cJSON* offset = cJSON_GetObjectItem(file, "offset");
+        cJSON* size = cJSON_GetObjectItem(file, "size");
+        cJSON* checksum = cJSON_GetObjectItem(file, "checksum");
+        if (!cJSON_IsString(name) || !cJSON_IsNumber(offset) || !cJSON_IsNumber(size) || !cJSON_IsNumber(checksum)) {
+            return false;
+        }
+        size_t new_offset = static_cast<size_t>(offset->valuedouble);
+        size_t payload = static_cast<size_t>(size->valuedouble);
+        if (new_offset + payload + 2 > total_size) {
+            return false;
+        }
+        auto entry = FindAssetEntry(name->valuestring);
+        if (entry == nullptr || entry->asset_size != payload) {
+            continue;
+        }
+        size_t old_offset = asset_data_start_ + entry->asset_offset;
+        // 单分区逐扇区前向重写时只有位于新位置之后的旧数据还没被覆盖，
+        // 能安全读取；双槽布局旧槽全程完好，不受此限制
+        if (inactive_partition_ == nullptr && old_offset < new_offset) {
+            continue;
+        }
+        if (CalculateChecksum(mmap_root_ + old_offset + 2, payload) != static_cast<uint32_t>(checksum->valuedouble)) {
+            continue;
+        }
+        // 区间包含 2 字节的资源魔数
+        copies.push_back(SyncSpan{new_offset, payload + 2, old_offset, true});
+    }
+
+    std::sort(copies.begin(), copies.end(), [](const SyncSpan& a, const SyncSpan& b) {
+        return a.offset < b.offset;
+    });
+
+    // 复制区间之间的空隙（头部、文件表、有变化的文件）都走下载
+    plan.clear();
+    size_t pos = 0;
+    for (const auto& copy : copies) {
+        if (copy.offset < pos) {
+            continue;
+        }
+        if (copy.offset > pos) {
+            plan.push_back(SyncSpan{pos, copy.offset - pos, 0, false});
+        }
+        plan.push_back(copy);
+        pos = copy.offset + copy.length;
+    }
+    if (pos < total_size) {
+        plan.push_back(SyncSpan{pos, total_size - pos, 0, false});
+    }
+    return true;
+}
+
+bool Assets::SyncFromPlan(const std::string& url, const std::vector<SyncSpan>& plan, size_t total_size,
+                          std::function<void(int progress, size_t speed)> progress_callback) {
+    const size_t SECTOR_SIZE = esp_partition_get_main_flash_sector_size();
+    std::vector<char> sector(SECTOR_SIZE);
+    auto& board = Board::GetInstance();
+    auto http = board.AcquireHttp("assets");
+    bool stream_open = false;
+    size_t stream_pos = 0;
+
+    auto read_exact = [&http](char* dest, size_t n) -> bool {
+        while (n > 0) {
+            int ret = http->Read(dest, n);
+            if (ret <= 0) {
+                return false;
+            }
+            dest += ret;
+            n -= ret;
+        }
+        return true;
+    };
+    // 为每段连续的下载区间开一个 range 请求，复用同一条热连接
+    auto ensure_stream = [&](size_t offset, size_t end) -> bool {
+        if (stream_open && stream_pos == offset) {
+            return true;
+        }
+        if (stream_open) {
+            http->Close();
+            stream_open = false;
+        }
+        char range[48];
+        snprintf(range, sizeof(range), "bytes=%u-%u", offset, end - 1);
+        http->SetHeader("Range", range);
+        if (!http->Open("GET", url)) {
+            ESP_LOGE(TAG, "Failed to open HTTP connection");
+            return false;
+        }
+        if (http->GetStatusCode() != 206) {
+            ESP_LOGE(TAG, "Server does not support range requests, status code: %d", http->GetStatusCode());
+            http->Close();
+            return false;
+        }
+        stream_open = true;
+        stream_pos = offset;
+        return true;
+    };
+
+    size_t processed = 0, recent_downloaded = 0, skipped_sectors = 0;
+    size_t span_idx = 0;
+    auto last_calc_time = esp_timer_get_time();
+    bool failed = false;
+
+    // 逐扇区前向重写：先在内存里拼好整个扇区（旧分区复制 + 下载），再擦再写
+    for (size_t sec_start = 0; sec_start < total_size && !failed; sec_start += SECTOR_SIZE) {
+        size_t sec_len = std::min(SECTOR_SIZE, total_size - sec_start);
+        size_t sec_end = sec_start + sec_len;
+        while (span_idx < plan.size() && plan[span_idx].offset + plan[span_idx].length <= sec_start) {
+            span_idx++;
+        }
+
+        // 本扇区内容与旧分区逐字节相同时直接跳过，不擦不写；
+        // 写备槽时目标内容是陈旧数据，必须整扇区重写
+        bool unchanged = inactive_partition_ == nullptr;
+        for (size_t j = span_idx; unchanged && j < plan.size() && plan[j].offset < sec_end; j++) {
+            if (!plan[j].from_old || plan[j].src_offset != plan[j].offset) {
+                unchanged = false;
+                break;
+            }
+        }
+        if (unchanged) {
+            skipped_sectors++;
+            processed += sec_len;
+            continue;
+        }
+
+        for (size_t j = span_idx; j < plan.size() && plan[j].offset < sec_end && !failed; j++) {
+            size_t a = std::max(plan[j].offset, sec_start);
+            size_t b = std::min(plan[j].offset + plan[j].length, sec_end);
+            char* dest = sector.data() + (a - sec_start);
+            if (plan[j].from_old) {
+                esp_err_t err = esp_partition_read(partition_, plan[j].src_offset + (a - plan[j].offset), dest, b - a);
+                if (err != ESP_OK) {
+                    ESP_LOGE(TAG, "Failed to read old asset data at %u: %s", plan[j].src_offset, esp_err_to_name(err));
+                    failed = true;
+                }
+            } else {
+                if (!ensure_stream(a, plan[j].offset + plan[j].length) || !read_exact(dest, b - a)) {
+                    ESP_LOGE(TAG, "Failed to download assets range %u-%u", a, b);
+                    failed = true;
+                } else {
+                    stream_pos = b;
+                    recent_downloaded += b - a;
+                }
+            }
+        }
+        if (failed) {
+            break;
+        }
+
+        esp_err_t err;
+        {
+            FlashOpScope scope(FlashOpMonitor::kPartitionErase);
+            err = esp_partition_erase_range(WritePartition(), sec_start, SECTOR_SIZE);
+        }
+        if (err == ESP_OK) {
+            FlashOpScope scope(FlashOpMonitor::kPartitionWrite);
+            err = esp_partition_write(WritePartition(), sec_start, sector.data(), sec_len);
+        }
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to rewrite sector at %u: %s", sec_start, esp_err_to_name(err));
+            failed = true;
+            break;
+        }
+
+        processed += sec_len;
+
+        // 计算进度和速度（速度只统计真正下载的字节）
+        if (esp_timer_get_time() - last_calc_time >= 1000000 || processed == total_size) {
+            size_t progress = processed * 100 / total_size;
+            ESP_LOGI(TAG, "Progress: %u%% (%u/%u), Speed: %u B/s", progress, processed, total_size, recent_downloaded);
+            if (progress_callback) {
+                progress_callback(progress, recent_downloaded);
+            }
+            last_calc_time = esp_timer_get_time();
+            recent_downloaded = 0;
+        }
+    }
+
+    if (stream_open) {
+        http->Close();
+    }
+    board.ReleaseHttp("assets", std::move(http));
+
+    if (failed) {
+        return false;
+    }
+    ESP_LOGI(TAG, "Incremental sync completed: %u bytes, %u sectors left untouched", total_size, skipped_sectors);
+    return true;
+}
+
 bool Assets::Download(std::string url, std::function<void(int progress, size_t speed)> progress_callback) {
     ESP_LOGI(TAG, "Downloading new version of assets from %s", url.c_str());
-    
-    // 取消当前资源分区的内存映射
-    if (mmap_handle_ != 0) {
-        esp_partition_munmap(mmap_handle_);
-        mmap_handle_ = 0;
-        mmap_root_ = nullptr;
+
+    // 旧分区内容完整时先尝试按清单增量同步，只传输有变化的文件
+    if (checksum_valid_ && TryIncrementalSync(url, progress_callback)) {
+        return true;
     }
-    checksum_valid_ = false;
-    assets_.clear();
 
-    // 下载新的资源文件
-    auto network = Board::GetInstance().GetNetwork();
-    auto http = network->CreateHttp(0);
-    
+    // 单分区布局原地重写，先取消当前资源分区的内存映射；
+    // 双槽布局写备槽，生效槽保持映射，下载期间资源照常可用
+    if (inactive_partition_ == nullptr) {
+        if (mmap_handle_ != 0) {
+            esp_partition_munmap(mmap_handle_);
+            mmap_handle_ = 0;
+            mmap_root_ = nullptr;
+        }
+        checksum_valid_ = false;
+        asset_table_ = nullptr;
+        asset_count_ = 0;
+    }
+
+    // 下载新的资源文件（复用连接池里的客户端，热连接可以跳过 TLS 握手）
+    auto http = Board::GetInstance().AcquireHttp("assets");
+
     if (!http->Open("GET", url)) {
         ESP_LOGE(TAG, "Failed to open HTTP connection");
         return false;
@@ -414,8 +986,8 @@ bool Assets::Download(std::string url, std::function<void(int progress, size_t s
         return false;
     }
 
-    if (content_length > partition_->size) {
-        ESP_LOGE(TAG, "Assets file size (%u) is larger than partition size (%lu)", content_length, partition_->size);
+    if (content_length > WritePartition()->size) {
+        ESP_LOGE(TAG, "Assets file size (%u) is larger than partition size (%lu)", content_length, WritePartition()->size);
         return false;
     }
 
@@ -435,7 +1007,12 @@ bool Assets::Download(std::string url, std::function<void(int progress, size_t s
     size_t recent_written = 0;
     size_t current_sector = 0;
     auto last_calc_time = esp_timer_get_time();
-    
+
+    // 边下载边累计校验和，最后一个字节写完校验即完成，不再整片回读
+    uint8_t stream_header[12];
+    uint32_t running_checksum = 0;
+    size_t verify_limit = 0;    // 头部解析出 stored_len 后为 12 + stored_len
+
     while (true) {
         int ret = http->Read(buffer, sizeof(buffer));
         if (ret < 0) {
@@ -457,13 +1034,14 @@ bool Assets::Download(std::string url, std::function<void(int progress, size_t s
             size_t sector_end = (current_sector + 1) * SECTOR_SIZE;
             
             // 确保擦除范围不超过分区大小
-            if (sector_end > partition_->size) {
-                ESP_LOGE(TAG, "Sector end (%u) exceeds partition size (%lu)", sector_end, partition_->size);
+            if (sector_end > WritePartition()->size) {
+                ESP_LOGE(TAG, "Sector end (%u) exceeds partition size (%lu)", sector_end, WritePartition()->size);
                 return false;
             }
-            
+
             ESP_LOGD(TAG, "Erasing sector %u (offset: %u, size: %u)", current_sector, sector_start, SECTOR_SIZE);
-            esp_err_t err = esp_partition_erase_range(partition_, sector_start, SECTOR_SIZE);
+            FlashOpScope scope(FlashOpMonitor::kPartitionErase);
+            esp_err_t err = esp_partition_erase_range(WritePartition(), sector_start, SECTOR_SIZE);
             if (err != ESP_OK) {
                 ESP_LOGE(TAG, "Failed to erase sector %u at offset %u: %s", current_sector, sector_start, esp_err_to_name(err));
                 return false;
@@ -473,12 +1051,35 @@ bool Assets::Download(std::string url, std::function<void(int progress, size_t s
         }
 
         // 写入数据到分区
-        esp_err_t err = esp_partition_write(partition_, total_written, buffer, ret);
+        esp_err_t err;
+        {
+            FlashOpScope scope(FlashOpMonitor::kPartitionWrite);
+            err = esp_partition_write(WritePartition(), total_written, buffer, ret);
+        }
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "Failed to write to assets partition at offset %u: %s", total_written, esp_err_to_name(err));
             return false;
         }
 
+        // 捕获 12 字节头部，之后对 [12, 12 + stored_len) 范围累计校验和
+        if (total_written < sizeof(stream_header)) {
+            size_t n = std::min(static_cast<size_t>(ret), sizeof(stream_header) - total_written);
+            memcpy(stream_header + total_written, buffer, n);
+            if (total_written + n == sizeof(stream_header)) {
+                uint32_t stored_len;
+                memcpy(&stored_len, stream_header + 8, sizeof(stored_len));
+                verify_limit = 12 + stored_len;
+            }
+        }
+        if (verify_limit > 0) {
+            size_t start = std::max(total_written, static_cast<size_t>(12));
+            size_t end = std::min(total_written + ret, verify_limit);
+            if (end > start) {
+                running_checksum += CalculateChecksum(buffer + (start - total_written), end - start);
+                running_checksum &= 0xFFFF;
+            }
+        }
+
         total_written += ret;
         recent_written += ret;
 
@@ -497,36 +1098,288 @@ bool Assets::Download(std::string url, std::function<void(int progress, size_t s
     }
     
     http->Close();
+    Board::GetInstance().ReleaseHttp("assets", std::move(http));
 
     if (total_written != content_length) {
         ESP_LOGE(TAG, "Downloaded size (%u) does not match expected size (%u)", total_written, content_length);
         return false;
     }
 
-    ESP_LOGI(TAG, "Assets download completed, total written: %u bytes, total sectors erased: %u", 
+    ESP_LOGI(TAG, "Assets download completed, total written: %u bytes, total sectors erased: %u",
              total_written, current_sector);
 
-    // 重新初始化资源分区
-    if (!InitializePartition()) {
+    // 用下载过程中累计的校验和验证，不再整片回读
+    if (verify_limit == 0 || verify_limit > content_length) {
+        ESP_LOGE(TAG, "The downloaded assets header is not valid");
+        return false;
+    }
+    uint32_t stored_chksum;
+    memcpy(&stored_chksum, stream_header + 4, sizeof(stored_chksum));
+    if (running_checksum != stored_chksum) {
+        ESP_LOGE(TAG, "The streamed checksum (0x%lx) does not match the stored checksum (0x%lx)", running_checksum, stored_chksum);
+        return false;
+    }
+
+    // 双槽布局：新包校验通过后原子切换生效槽
+    if (inactive_partition_ != nullptr) {
+        SwitchToInactiveSlot();
+    }
+
+    // 重新初始化资源分区；内容已经在下载时校验过，不需要再算一遍
+    if (!InitializePartition(false)) {
         ESP_LOGE(TAG, "Failed to re-initialize assets partition");
+        if (inactive_partition_ != nullptr) {
+            // 新槽映射失败，切回旧槽保底
+            SwitchToInactiveSlot();
+            InitializePartition();
+        }
+        return false;
+    }
+    checksum_pending_ = false;
+    checksum_valid_ = true;
+
+    return true;
+}
+
+// 后台下载的节奏：音频通道空闲时每块 4KB 间隔 20ms（约 200KB/s），
+// 通道打开时间隔拉长到 500ms（约 8KB/s），带宽让给语音
+static const int BG_IDLE_DELAY_MS = 20;
+static const int BG_BUSY_DELAY_MS = 500;
+static const int BG_MAX_RECONNECTS = 10;
+
+bool Assets::StartBackgroundDownload(const std::string& url) {
+    // 单分区布局必须取消映射原地重写，做不到边下载边服务，走前台路径
+    if (inactive_partition_ == nullptr) {
         return false;
     }
+    bool expected = false;
+    if (!background_download_active_.compare_exchange_strong(expected, true)) {
+        ESP_LOGW(TAG, "Background assets download already running");
+        return true;
+    }
 
+    auto url_copy = new std::string(url);
+    xTaskCreate([](void* arg) {
+        auto url = static_cast<std::string*>(arg);
+        Assets::GetInstance().BackgroundDownloadTask(*url);
+        delete url;
+        vTaskDelete(NULL);
+    }, "assets_bg", 4096, url_copy, 1, NULL);
     return true;
 }
 
+/*
+ * 后台涓流下载。生效槽保持映射照常服务，备槽按 range 请求续传写入；
+ * 断点（url/已写字节数/总长）持久化在 NVS，重启后从上次落盘的扇区边界
+ * 继续，不再从头传。续传后无法像前台路径那样边下边算校验和，写满后
+ * 回读备槽统一校验，通过了才在主循环上切槽热应用
+ */
+void Assets::BackgroundDownloadTask(const std::string& url) {
+    const size_t SECTOR_SIZE = esp_partition_get_main_flash_sector_size();
+    const size_t PERSIST_INTERVAL = 32 * SECTOR_SIZE;
+
+    size_t written = 0;
+    size_t total = 0;
+    {
+        Settings settings("assets", true);
+        if (settings.GetString("bg_url") == url) {
+            written = static_cast<size_t>(settings.GetInt("bg_offset"));
+            total = static_cast<size_t>(settings.GetInt("bg_total"));
+        } else {
+            settings.SetString("bg_url", url);
+            settings.SetInt("bg_offset", 0);
+            settings.SetInt("bg_total", 0);
+        }
+    }
+    written -= written % SECTOR_SIZE;
+    if (total > 0 && written > total) {
+        written = 0;
+    }
+    ESP_LOGI(TAG, "Background assets download from %s, resuming at %u/%u", url.c_str(), written, total);
+
+    auto& app = Application::GetInstance();
+    auto& board = Board::GetInstance();
+    auto http = board.AcquireHttp("assets");
+    std::vector<char> sector(SECTOR_SIZE);
+    size_t fill = 0;
+    size_t last_persist = written;
+    int reconnects = 0;
+    bool stream_open = false;
+    bool failed = false;
+
+    while (!failed && (total == 0 || written < total)) {
+        if (!stream_open) {
+            if (reconnects++ >= BG_MAX_RECONNECTS) {
+                ESP_LOGW(TAG, "Background download gave up after %d reconnects, will resume at %u next boot",
+                         BG_MAX_RECONNECTS, written);
+                failed = true;
+                break;
+            }
+            fill = 0;
+            if (written > 0) {
+                char range[32];
+                snprintf(range, sizeof(range), "bytes=%u-", written);
+                http->SetHeader("Range", range);
+            }
+            if (!http->Open("GET", url)) {
+                vTaskDelay(pdMS_TO_TICKS(10000));
+                continue;
+            }
+            int status = http->GetStatusCode();
+            if (written > 0 && status == 200) {
+                // 服务器不支持 range，给的是全量流，就用它从头写
+                ESP_LOGW(TAG, "Server ignored range request, restarting from 0");
+                written = 0;
+            }
+            int expected_status = written > 0 ? 206 : 200;
+            if (status != expected_status) {
+                ESP_LOGE(TAG, "Background download status code %d (expected %d)", status, expected_status);
+                http->Close();
+                failed = true;
+                break;
+            }
+            size_t body = http->GetBodyLength();
+            if (written == 0) {
+                if (body == 0 || body > WritePartition()->size) {
+                    ESP_LOGE(TAG, "Assets size (%u) does not fit partition (%lu)", body, WritePartition()->size);
+                    http->Close();
+                    failed = true;
+                    break;
+                }
+                total = body;
+                Settings settings("assets", true);
+                settings.SetInt("bg_total", static_cast<int32_t>(total));
+            } else if (body != total - written) {
+                // 服务器上的文件变了，断点作废从头再来
+                ESP_LOGW(TAG, "Remote assets changed (body %u != remaining %u), restarting", body, total - written);
+                http->Close();
+                written = 0;
+                total = 0;
+                continue;
+            }
+            stream_open = true;
+        }
+
+        size_t want = std::min(SECTOR_SIZE - fill, total - written - fill);
+        int ret = http->Read(sector.data() + fill, want);
+        if (ret <= 0) {
+            http->Close();
+            stream_open = false;
+            vTaskDelay(pdMS_TO_TICKS(10000));
+            continue;
+        }
+        fill += ret;
+
+        if (fill == SECTOR_SIZE || written + fill == total) {
+            esp_err_t err;
+            {
+                FlashOpScope scope(FlashOpMonitor::kPartitionErase);
+                err = esp_partition_erase_range(WritePartition(), written, SECTOR_SIZE);
+            }
+            if (err == ESP_OK) {
+                FlashOpScope scope(FlashOpMonitor::kPartitionWrite);
+                err = esp_partition_write(WritePartition(), written, sector.data(), fill);
+            }
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to write backup slot at %u: %s", written, esp_err_to_name(err));
+                failed = true;
+                break;
+            }
+            written += fill;
+            fill = 0;
+            // 断点只在字节真正落盘之后推进
+            if (written - last_persist >= PERSIST_INTERVAL || written == total) {
+                Settings settings("assets", true);
+                settings.SetInt("bg_offset", static_cast<int32_t>(written));
+                last_persist = written;
+                // 有实际进展就把重连预算还满，长时间涓流允许多次瞬断
+                reconnects = 0;
+                ESP_LOGI(TAG, "Background assets download: %u/%u (%u%%)", written, total, written * 100 / total);
+            }
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(app.IsAudioChannelOpened() ? BG_BUSY_DELAY_MS : BG_IDLE_DELAY_MS));
+    }
+
+    if (stream_open) {
+        http->Close();
+    }
+    board.ReleaseHttp("assets", std::move(http));
+
+    if (!failed && total > 0 && written == total) {
+        if (VerifyInactiveSlot()) {
+            Settings settings("assets", true);
+            settings.EraseKey("bg_url");
+            settings.EraseKey("bg_offset");
+            settings.EraseKey("bg_total");
+            // 切槽会取消当前映射，必须和资源消费方同任务执行
+            app.Schedule([]() {
+                auto& assets = Assets::GetInstance();
+                assets.SwitchToInactiveSlot();
+                if (assets.InitializePartition(false)) {
+                    assets.checksum_pending_ = false;
+                    assets.checksum_valid_ = true;
+                    assets.Apply();
+                    ESP_LOGI(TAG, "Background assets update applied");
+                } else {
+                    ESP_LOGE(TAG, "Failed to map new assets slot, rolling back");
+                    assets.SwitchToInactiveSlot();
+                    assets.InitializePartition();
+                }
+            });
+        } else {
+            ESP_LOGE(TAG, "Background download checksum mismatch, discarding");
+            Settings settings("assets", true);
+            settings.EraseKey("bg_url");
+            settings.EraseKey("bg_offset");
+            settings.EraseKey("bg_total");
+        }
+    }
+    background_download_active_.store(false);
+}
+
+bool Assets::VerifyInactiveSlot() {
+    auto part = inactive_partition_;
+    if (part == nullptr) {
+        return false;
+    }
+    uint8_t header[12];
+    if (esp_partition_read(part, 0, header, sizeof(header)) != ESP_OK) {
+        return false;
+    }
+    uint32_t stored_chksum, stored_len;
+    memcpy(&stored_chksum, header + 4, sizeof(stored_chksum));
+    memcpy(&stored_len, header + 8, sizeof(stored_len));
+    if (stored_len == 0 || stored_len > part->size - 12) {
+        return false;
+    }
+    std::vector<char> buffer(4096);
+    uint32_t sum = 0;
+    size_t pos = 12;
+    const size_t end = 12 + stored_len;
+    while (pos < end) {
+        size_t n = std::min(buffer.size(), end - pos);
+        if (esp_partition_read(part, pos, buffer.data(), n) != ESP_OK) {
+            return false;
+        }
+        sum = (sum + CalculateChecksum(buffer.data(), n)) & 0xFFFF;
+        pos += n;
+    }
+    return sum == stored_chksum;
+}
+
 bool Assets::GetAssetData(const std::string& name, void*& ptr, size_t& size) {
-    auto asset = assets_.find(name);
-    if (asset == assets_.end()) {
+    auto entry = FindAssetEntry(name.c_str());
+    if (entry == nullptr) {
         return false;
     }
-    auto data = (const char*)(mmap_root_ + asset->second.offset);
+    auto data = (const char*)(mmap_root_ + asset_data_start_ + entry->asset_offset);
     if (data[0] != 'Z' || data[1] != 'Z') {
         ESP_LOGE(TAG, "The asset %s is not valid with magic %02x%02x", name.c_str(), data[0], data[1]);
         return false;
     }
 
     ptr = static_cast<void*>(const_cast<char*>(data + 2));
-    size = asset->second.size;
+    size = entry->asset_size;
     return true;
 }
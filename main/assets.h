@@ -1,19 +1,18 @@
 #ifndef ASSETS_H
 #define ASSETS_H
 
-#include <map>
+#include <atomic>
 #include <string>
+#include <vector>
 #include <functional>
 
 #include <cJSON.h>
 #include <esp_partition.h>
 #include <model_path.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 
-
-struct Asset {
-    size_t size;
-    size_t offset;
-};
+struct mmap_assets_table;
 
 class Assets {
 public:
@@ -24,7 +23,23 @@ public:
     ~Assets();
 
     bool Download(std::string url, std::function<void(int progress, size_t speed)> progress_callback);
+    // 后台涓流下载（仅 A/B 双槽布局，单分区布局返回 false 由调用方走
+    // 前台路径）：range 请求断点续传，进度持久化在 NVS，音频通道打开时
+    // 重度限速让出带宽，完成校验后在主循环上切槽并热应用
+    bool StartBackgroundDownload(const std::string& url);
     bool Apply();
+    // 启动用的分阶段应用：先加载唤醒词模型让检测尽早可用，主题资源推后
+    bool ApplyModels();
+    bool ApplyUi();
+    // 补算启动时跳过的整片分区校验和，失败时使资源表失效
+    bool VerifyChecksum();
+    // 按 index.json 的 preload 列表（打包器按优先级排序）预热热资源的
+    // flash cache 页；倒序触碰，优先级最高的最后触碰、最不容易被换出
+    void PreloadHotAssets();
+    // 顺序流式消费（长 GIF、字体 bin）的预读：消费者每前进一步就带当前
+    // 游标和剩余长度调用，后台任务提前一页触碰 flash cache，把缺页从
+    // 渲染循环挪到帧间空闲。游标不在 mmap 区域内时是空操作
+    void Prefetch(const void* cursor, size_t remaining);
     bool GetAssetData(const std::string& name, void*& ptr, size_t& size);
 
     inline bool partition_valid() const { return partition_valid_; }
@@ -36,17 +51,57 @@ private:
     Assets(const Assets&) = delete;
     Assets& operator=(const Assets&) = delete;
 
-    bool InitializePartition();
+    // 增量同步计划中的一段字节区间，按新镜像中的偏移排序、完整覆盖整个镜像
+    struct SyncSpan {
+        size_t offset;      // 新镜像中的起始偏移
+        size_t length;
+        size_t src_offset;  // from_old 时旧分区中的来源偏移
+        bool from_old;      // true: 从旧分区复制；false: 从 HTTP 下载
+    };
+
+    bool InitializePartition(bool verify_checksum = true);
+    void SwitchToInactiveSlot();
+    // 下载/同步的写入目标：双槽布局写备槽，单分区布局原地重写
+    inline const esp_partition_t* WritePartition() const {
+        return inactive_partition_ != nullptr ? inactive_partition_ : partition_;
+    }
     uint32_t CalculateChecksum(const char* data, uint32_t length);
+    cJSON* ParseIndex();
+    const mmap_assets_table* FindAssetEntry(const char* name) const;
+    bool TryIncrementalSync(const std::string& url, std::function<void(int progress, size_t speed)> progress_callback);
+    void BackgroundDownloadTask(const std::string& url);
+    void PrefetchTask();
+    // 回读备槽内容按头部声明的长度补算校验和，后台下载续传后无法
+    // 边下边算，完成时统一校验
+    bool VerifyInactiveSlot();
+    bool BuildSyncPlan(cJSON* files, size_t total_size, std::vector<SyncSpan>& plan);
+    bool SyncFromPlan(const std::string& url, const std::vector<SyncSpan>& plan, size_t total_size,
+                      std::function<void(int progress, size_t speed)> progress_callback);
 
+    // 当前生效（已映射）的槽；A/B 双槽布局时 inactive_partition_ 指向备槽，
+    // 单分区布局为空
     const esp_partition_t* partition_ = nullptr;
+    const esp_partition_t* inactive_partition_ = nullptr;
     esp_partition_mmap_handle_t mmap_handle_ = 0;
     const char* mmap_root_ = nullptr;
     bool partition_valid_ = false;
     bool checksum_valid_ = false;
     std::string default_assets_url_;
     srmodel_list_t* models_list_ = nullptr;
-    std::map<std::string, Asset> assets_;
+    // 文件表直接在 mmap 区域内查找，启动时不再把文件名解析到堆上的 map 里
+    const mmap_assets_table* asset_table_ = nullptr;
+    uint32_t asset_count_ = 0;
+    size_t asset_data_start_ = 0;   // 文件数据区在分区内的起始偏移
+    bool asset_table_sorted_ = false;
+    // 启动时跳过整片分区的校验和计算（多兆字节的 SPI flash 读取），
+    // 由启动后的后台阶段调用 VerifyChecksum() 补算
+    bool checksum_pending_ = false;
+    uint32_t stored_checksum_ = 0;
+    uint32_t stored_length_ = 0;
+    std::atomic<bool> background_download_active_{false};
+    // 预读请求队列和去重水位（上一次入队的页地址），首次 Prefetch 时才创建
+    QueueHandle_t prefetch_queue_ = nullptr;
+    std::atomic<uintptr_t> prefetch_last_page_{0};
 };
 
 #endif
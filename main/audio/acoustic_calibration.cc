@@ -0,0 +1,106 @@
+#include "acoustic_calibration.h"
+#include "assets.h"
+
+#include <cJSON.h>
+#include <esp_log.h>
+
+#include <cmath>
+#include <string>
+
+#define TAG "AcousticCal"
+
+namespace {
+
+int32_t DbToQ15(double db) {
+    double linear = std::pow(10.0, db / 20.0);
+    int32_t q15 = (int32_t)std::lround(linear * 32768.0);
+    // 数字微调不做超过 +12dB 的放大，防止标定档案笔误直接削波
+    if (q15 > 32768 * 4) {
+        q15 = 32768 * 4;
+    }
+    if (q15 < 0) {
+        q15 = 0;
+    }
+    return q15;
+}
+
+double GetNumber(const cJSON* root, const char* name, double fallback) {
+    auto item = cJSON_GetObjectItem(root, name);
+    return cJSON_IsNumber(item) ? item->valuedouble : fallback;
+}
+
+}  // namespace
+
+void AcousticCalibration::LoadFromAssets() {
+    void* ptr = nullptr;
+    size_t size = 0;
+    auto& assets = Assets::GetInstance();
+    if (!assets.partition_valid() || !assets.GetAssetData("acoustic_calibration.json", ptr, size)) {
+        return;
+    }
+
+    std::string text((const char*)ptr, size);
+    cJSON* root = cJSON_Parse(text.c_str());
+    if (root == nullptr) {
+        ESP_LOGE(TAG, "Invalid calibration profile, ignored");
+        return;
+    }
+
+    mic_gain_q15_ = DbToQ15(GetNumber(root, "mic_gain_db", 0.0));
+    reference_gain_q15_ = DbToQ15(GetNumber(root, "reference_gain_db", 0.0));
+    speaker_gain_q15_ = DbToQ15(GetNumber(root, "speaker_gain_db", 0.0));
+    aec_filter_length_ = (int)GetNumber(root, "aec_filter_length", 0.0);
+
+    auto eq = cJSON_GetObjectItem(root, "eq");
+    if (cJSON_IsArray(eq)) {
+        int sections = cJSON_GetArraySize(eq);
+        for (int i = 0; i < sections && i < kMaxEqSections; i++) {
+            auto coeffs = cJSON_GetArrayItem(eq, i);
+            if (!cJSON_IsArray(coeffs) || cJSON_GetArraySize(coeffs) != 5) {
+                ESP_LOGW(TAG, "EQ section %d malformed, skipped", i);
+                continue;
+            }
+            Biquad section;
+            section.b0 = (int32_t)std::lround(cJSON_GetArrayItem(coeffs, 0)->valuedouble * 16384.0);
+            section.b1 = (int32_t)std::lround(cJSON_GetArrayItem(coeffs, 1)->valuedouble * 16384.0);
+            section.b2 = (int32_t)std::lround(cJSON_GetArrayItem(coeffs, 2)->valuedouble * 16384.0);
+            section.a1 = (int32_t)std::lround(cJSON_GetArrayItem(coeffs, 3)->valuedouble * 16384.0);
+            section.a2 = (int32_t)std::lround(cJSON_GetArrayItem(coeffs, 4)->valuedouble * 16384.0);
+            eq_sections_.push_back(section);
+        }
+    }
+
+    cJSON_Delete(root);
+    loaded_ = true;
+    ESP_LOGI(TAG, "Profile loaded: mic %ld, ref %ld, spk %ld (Q15), eq %u sections, aec_len %d",
+             (long)mic_gain_q15_, (long)reference_gain_q15_, (long)speaker_gain_q15_,
+             (unsigned)eq_sections_.size(), aec_filter_length_);
+}
+
+void AcousticCalibration::ApplyGain(int16_t* pcm, size_t samples, size_t stride, int32_t gain_q15) {
+    if (gain_q15 == kUnityQ15) {
+        return;
+    }
+    for (size_t i = 0; i < samples; i += stride) {
+        int32_t value = ((int32_t)pcm[i] * gain_q15) >> 15;
+        if (value > 32767) value = 32767;
+        if (value < -32768) value = -32768;
+        pcm[i] = (int16_t)value;
+    }
+}
+
+void AcousticCalibration::ProcessOutput(int16_t* pcm, size_t samples) {
+    for (auto& s : eq_sections_) {
+        for (size_t i = 0; i < samples; i++) {
+            // DF2T，Q14 系数，中间量 32 位足够（|系数|<2，|状态|<2^17）
+            int32_t x = pcm[i];
+            int32_t y = (s.b0 * x + s.s1) >> 14;
+            s.s1 = s.b1 * x - s.a1 * y + s.s2;
+            s.s2 = s.b2 * x - s.a2 * y;
+            if (y > 32767) y = 32767;
+            if (y < -32768) y = -32768;
+            pcm[i] = (int16_t)y;
+        }
+    }
+    ApplyGain(pcm, samples, 1, speaker_gain_q15_);
+}
@@ -0,0 +1,72 @@
+#ifndef ACOUSTIC_CALIBRATION_H
+#define ACOUSTIC_CALIBRATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * 每个外壳一份的声学标定档案，由打包器放进资源分区
+ * （acoustic_calibration.json），音频服务初始化时加载。没有档案时
+ * 所有接口退化为直通，行为与没有这个模块时一致。
+ *
+ * 档案内容（增益单位 dB，滤波器系数离线算好，固件不做设计）：
+ * {
+ *   "mic_gain_db": -2.0,          // 麦克风数字微调，喂 AFE 前作用于 M 通道
+ *   "reference_gain_db": -6.0,    // AEC 参考通道微调：大喇叭的箱体回声
+ *                                 // 路径增益高，参考压低后收敛明显变快
+ *   "speaker_gain_db": 0,         // 扬声器数字微调，EQ 之后、写 codec 之前
+ *   "aec_filter_length": 0,       // AEC 滤波器长度提示，0 用默认
+ *   "eq": [[b0,b1,b2,a1,a2], ...] // 扬声器 EQ 双二阶级联，最多 6 段
+ * }
+ *
+ * 增益换算成 Q15 定点在热路径上乘加，EQ 用 Q14 系数的 DF2T 实现，
+ * 无浮点，C3 上同样可用。
+ */
+class AcousticCalibration {
+public:
+    static AcousticCalibration& GetInstance() {
+        static AcousticCalibration instance;
+        return instance;
+    }
+
+    // AudioService::Initialize 里调用一次
+    void LoadFromAssets();
+    bool loaded() const { return loaded_; }
+
+    // Q15 线性增益；32768 = 0dB。未加载或未配置时返回 32768
+    int32_t mic_gain_q15() const { return mic_gain_q15_; }
+    int32_t reference_gain_q15() const { return reference_gain_q15_; }
+    int32_t speaker_gain_q15() const { return speaker_gain_q15_; }
+    int aec_filter_length() const { return aec_filter_length_; }
+    bool has_input_trim() const { return mic_gain_q15_ != kUnityQ15 || reference_gain_q15_ != kUnityQ15; }
+    bool has_output_chain() const { return speaker_gain_q15_ != kUnityQ15 || !eq_sections_.empty(); }
+
+    // 就地做扬声器 EQ + 增益；只在输出任务上调用（滤波器状态不加锁）
+    void ProcessOutput(int16_t* pcm, size_t samples);
+
+    // 就地缩放一个 Q15 增益，增益为 0dB 时直接返回
+    static void ApplyGain(int16_t* pcm, size_t samples, size_t stride, int32_t gain_q15);
+
+private:
+    AcousticCalibration() = default;
+
+    static constexpr int32_t kUnityQ15 = 32768;
+    static constexpr int kMaxEqSections = 6;
+
+    struct Biquad {
+        // Q14 系数：b0 b1 b2 a1 a2（a0 归一）
+        int32_t b0, b1, b2, a1, a2;
+        // DF2T 状态，只在输出任务上读写
+        int32_t s1 = 0, s2 = 0;
+    };
+
+    bool loaded_ = false;
+    int32_t mic_gain_q15_ = kUnityQ15;
+    int32_t reference_gain_q15_ = kUnityQ15;
+    int32_t speaker_gain_q15_ = kUnityQ15;
+    int aec_filter_length_ = 0;
+    std::vector<Biquad> eq_sections_;
+};
+
+#endif // ACOUSTIC_CALIBRATION_H
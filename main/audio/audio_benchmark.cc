@@ -0,0 +1,121 @@
+#include "audio_benchmark.h"
+
+#if CONFIG_USE_AUDIO_BENCHMARK
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <esp_cpu.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+
+#include <opus_encoder.h>
+#include <opus_decoder.h>
+
+#include "assets.h"
+#include "audio_service.h"
+#include "fir_resampler.h"
+
+#define TAG "AudioBenchmark"
+
+/* Number of frames fed through each stage; enough to average out cache
+ * warmup without stretching the boot time */
+static const int kBenchmarkFrames = 50;
+
+/* Prefer canned PCM from the assets partition ("benchmark.pcm", 16 kHz
+ * mono s16le) so runs compare the same material across releases; fall
+ * back to a deterministic chirp when the asset is not flashed. */
+static std::vector<int16_t> LoadBenchmarkPcm(size_t samples) {
+    std::vector<int16_t> pcm(samples);
+    void* ptr = nullptr;
+    size_t size = 0;
+    if (Assets::GetInstance().GetAssetData("benchmark.pcm", ptr, size) && size >= samples * sizeof(int16_t)) {
+        memcpy(pcm.data(), ptr, samples * sizeof(int16_t));
+        return pcm;
+    }
+    for (size_t i = 0; i < samples; i++) {
+        float t = (float)i / 16000.0f;
+        pcm[i] = (int16_t)(8000.0f * sinf(2.0f * M_PI * (200.0f + 600.0f * t) * t));
+    }
+    return pcm;
+}
+
+static void Report(const char* stage, uint32_t cycles, int frames, int32_t heap_delta) {
+    ESP_LOGI(TAG, "%-24s %8lu cycles/frame, heap delta %ld bytes",
+        stage, (unsigned long)(cycles / frames), (long)heap_delta);
+}
+
+static void BenchmarkCodec(int sample_rate, int frame_duration_ms) {
+    const size_t frame_samples = sample_rate * frame_duration_ms / 1000;
+    auto pcm = LoadBenchmarkPcm(frame_samples * kBenchmarkFrames);
+    char stage[48];
+
+    /* Encoder, at the complexity the service starts from */
+    int32_t heap_before = esp_get_free_heap_size();
+    auto encoder = std::make_unique<OpusEncoderWrapper>(sample_rate, 1, frame_duration_ms);
+    encoder->SetComplexity(0);
+    std::vector<std::vector<uint8_t>> packets;
+    uint32_t cycles = 0;
+    for (int i = 0; i < kBenchmarkFrames; i++) {
+        std::vector<int16_t> frame(pcm.begin() + i * frame_samples, pcm.begin() + (i + 1) * frame_samples);
+        std::vector<uint8_t> opus;
+        uint32_t start = esp_cpu_get_cycle_count();
+        encoder->Encode(std::move(frame), opus);
+        cycles += esp_cpu_get_cycle_count() - start;
+        packets.emplace_back(std::move(opus));
+    }
+    snprintf(stage, sizeof(stage), "encode %dk/%dms", sample_rate / 1000, frame_duration_ms);
+    Report(stage, cycles, kBenchmarkFrames, esp_get_free_heap_size() - heap_before);
+    encoder.reset();
+
+    /* Decoder, on the packets just produced */
+    heap_before = esp_get_free_heap_size();
+    auto decoder = std::make_unique<OpusDecoderWrapper>(sample_rate, 1, frame_duration_ms);
+    cycles = 0;
+    for (auto& packet : packets) {
+        std::vector<int16_t> out;
+        uint32_t start = esp_cpu_get_cycle_count();
+        decoder->Decode(std::move(packet), out);
+        cycles += esp_cpu_get_cycle_count() - start;
+    }
+    snprintf(stage, sizeof(stage), "decode %dk/%dms", sample_rate / 1000, frame_duration_ms);
+    Report(stage, cycles, kBenchmarkFrames, esp_get_free_heap_size() - heap_before);
+}
+
+static void BenchmarkResampler(int input_rate, int output_rate, int frame_duration_ms) {
+    const size_t frame_samples = input_rate * frame_duration_ms / 1000;
+    auto pcm = LoadBenchmarkPcm(frame_samples);
+    char stage[48];
+
+    int32_t heap_before = esp_get_free_heap_size();
+    FirResampler resampler;
+    resampler.Configure(input_rate, output_rate);
+    std::vector<int16_t> out(resampler.GetOutputSamples(frame_samples));
+    uint32_t cycles = 0;
+    for (int i = 0; i < kBenchmarkFrames; i++) {
+        uint32_t start = esp_cpu_get_cycle_count();
+        resampler.Process(pcm.data(), frame_samples, out.data());
+        cycles += esp_cpu_get_cycle_count() - start;
+    }
+    snprintf(stage, sizeof(stage), "resample %dk->%dk/%dms", input_rate / 1000, output_rate / 1000, frame_duration_ms);
+    Report(stage, cycles, kBenchmarkFrames, esp_get_free_heap_size() - heap_before);
+}
+
+void AudioBenchmark::Run() {
+    ESP_LOGI(TAG, "Running audio pipeline benchmark, %d frames per stage", kBenchmarkFrames);
+
+    static const int kFrameDurations[] = { 20, 40, 60 };
+    for (int frame_duration : kFrameDurations) {
+        /* Uplink runs at 16 kHz, downlink TTS at 16 or 24 kHz */
+        BenchmarkCodec(16000, frame_duration);
+        BenchmarkCodec(24000, frame_duration);
+    }
+    /* The resampler paths the service actually configures */
+    BenchmarkResampler(24000, 16000, OPUS_FRAME_DURATION_MS);
+    BenchmarkResampler(48000, 16000, OPUS_FRAME_DURATION_MS);
+
+    ESP_LOGI(TAG, "Audio pipeline benchmark finished");
+}
+
+#endif // CONFIG_USE_AUDIO_BENCHMARK
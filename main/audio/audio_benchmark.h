@@ -0,0 +1,16 @@
+#ifndef AUDIO_BENCHMARK_H
+#define AUDIO_BENCHMARK_H
+
+/*
+ * Startup benchmark for the audio stack, enabled with
+ * CONFIG_USE_AUDIO_BENCHMARK. Feeds canned PCM through the encoder,
+ * decoder and resampler stages for each frame duration and sample rate
+ * and logs cycles/frame plus heap deltas, so audio CPU regressions show
+ * up on S3/C3/P4 hardware before a rollout instead of in the field.
+ */
+class AudioBenchmark {
+public:
+    static void Run();
+};
+
+#endif // AUDIO_BENCHMARK_H
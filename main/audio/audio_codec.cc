@@ -1,6 +1,7 @@
 #include "audio_codec.h"
 #include "board.h"
 #include "settings.h"
+#include "status_event.h"
 
 #include <esp_log.h>
 #include <cstring>
@@ -14,18 +15,6 @@ AudioCodec::AudioCodec() {
 AudioCodec::~AudioCodec() {
 }
 
-void AudioCodec::OutputData(std::vector<int16_t>& data) {
-    Write(data.data(), data.size());
-}
-
-bool AudioCodec::InputData(std::vector<int16_t>& data) {
-    int samples = Read(data.data(), data.size());
-    if (samples > 0) {
-        return true;
-    }
-    return false;
-}
-
 void AudioCodec::Start() {
     Settings settings("audio", false);
     output_volume_ = settings.GetInt("output_volume", output_volume_);
@@ -48,11 +37,17 @@ void AudioCodec::Start() {
 }
 
 void AudioCodec::SetOutputVolume(int volume) {
+    bool was_muted = output_volume_ == 0;
     output_volume_ = volume;
     ESP_LOGI(TAG, "Set output volume to %d", output_volume_);
-    
+
     Settings settings("audio", true);
     settings.SetInt("output_volume", output_volume_);
+
+    // 状态栏的静音图标只关心 0/非 0 的跳变
+    if (was_muted != (output_volume_ == 0)) {
+        StatusEventManager::GetInstance().Publish(StatusEvent::kVolume);
+    }
 }
 
 void AudioCodec::SetInputGain(float gain) {
@@ -1,6 +1,7 @@
 #ifndef _AUDIO_CODEC_H
 #define _AUDIO_CODEC_H
 
+#include <esp_attr.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/event_groups.h>
 #include <driver/i2s_std.h>
@@ -11,9 +12,21 @@
 
 #include "board.h"
 
-#define AUDIO_CODEC_DMA_DESC_NUM 6
+// DMA 环大小可在 menuconfig 按板型调整：电池板开启省电保持唤醒词时
+// 加大 RX 环，让输入在轻睡眠的唤醒延迟内不丢帧
+#define AUDIO_CODEC_DMA_DESC_NUM CONFIG_AUDIO_CODEC_DMA_DESC_NUM
 #define AUDIO_CODEC_DMA_FRAME_NUM 240
 
+/* 音频热路径的 IRAM 放置开关：NVS 提交/OTA 写 flash 期间 cache 关闭，
+ * 重新使能后跑在 flash 里的每帧函数先吃一串 cache miss。被标注的
+ * 函数常驻 IRAM 不付这笔延迟；IRAM 吃紧的配置可在 menuconfig 关掉。
+ * 放置结果用 iram-report 构建目标核对 */
+#if CONFIG_AUDIO_HOT_PATH_IN_IRAM
+#define AUDIO_IRAM_ATTR IRAM_ATTR
+#else
+#define AUDIO_IRAM_ATTR
+#endif
+
 class AudioCodec {
 public:
     AudioCodec();
@@ -24,10 +37,16 @@ public:
     virtual void EnableInput(bool enable);
     virtual void EnableOutput(bool enable);
 
-    virtual void OutputData(std::vector<int16_t>& data);
-    virtual bool InputData(std::vector<int16_t>& data);
+    // 每帧热路径。没有子类重写这两个包装，声明为非虚并内联在头文件里，
+    // 整条链路每帧只剩 Read/Write 一次无法避免的间接调用
+    void OutputData(std::vector<int16_t>& data) { Write(data.data(), data.size()); }
+    bool InputData(std::vector<int16_t>& data) { return Read(data.data(), data.size()) > 0; }
     virtual void Start();
 
+    /* 输入链路从使能到出有效数据的时间（PLL 锁定 + ADC 软斜坡），
+     * 期间的帧要丢弃。各 codec 按实测覆盖；基类取保守值 */
+    virtual int input_warmup_ms() const { return 120; }
+
     inline bool duplex() const { return duplex_; }
     inline bool input_reference() const { return input_reference_; }
     inline int input_sample_rate() const { return input_sample_rate_; }
@@ -1,5 +1,18 @@
 #include "audio_service.h"
+#include "audio_benchmark.h"
+#include "task_registry.h"
+#include "dvfs_governor.h"
+#include "power_profiler.h"
+#include "latency_scoreboard.h"
+#include "flash_op_monitor.h"
+#include "hot_log.h"
+#include "tracepoint.h"
+#include "lp_wake_prescreen.h"
+#include "acoustic_calibration.h"
+#include "knob_registry.h"
 #include <esp_log.h>
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 
 #if CONFIG_USE_AUDIO_PROCESSOR
@@ -10,6 +23,7 @@
 
 #if CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32P4
 #include "wake_words/afe_wake_word.h"
+#include "wake_words/combined_wake_word.h"
 #include "wake_words/custom_wake_word.h"
 #else
 #include "wake_words/esp_wake_word.h"
@@ -17,15 +31,88 @@
 
 #define TAG "AudioService"
 
+/* 开播淡入：输出使能或播放间隙后的前 kFadeInMs 毫秒按 Q15 平滑斜坡
+ * （smoothstep，编译期建表）渐入，PCM 从满幅起跳在不少 codec 上会爆音 */
+static constexpr int kFadeInMs = 20;
+static constexpr int kFadeRampSteps = 256;
+struct FadeRamp {
+    int16_t q15[kFadeRampSteps];
+};
+static constexpr FadeRamp BuildFadeRamp() {
+    FadeRamp ramp{};
+    for (int i = 0; i < kFadeRampSteps; i++) {
+        double x = (double)i / (kFadeRampSteps - 1);
+        double s = x * x * (3.0 - 2.0 * x);
+        ramp.q15[i] = (int16_t)(s * 32767.0 + 0.5);
+    }
+    return ramp;
+}
+static constexpr FadeRamp kFadeRamp = BuildFadeRamp();
+
+
+void LatencyHistogram::Record(int64_t us) {
+    if (us < 0) {
+        us = 0;
+    }
+    int bucket = 0;
+    while (us > 1 && bucket < kNumBuckets - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    buckets[bucket]++;
+    count++;
+}
+
+uint32_t LatencyHistogram::PercentileUs(int percent) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint32_t rank = (uint64_t)count * percent / 100;
+    uint32_t seen = 0;
+    for (int i = 0; i < kNumBuckets; i++) {
+        seen += buckets[i];
+        if (seen > rank) {
+            /* Report the upper edge of the bucket */
+            return 1u << (i + 1);
+        }
+    }
+    return 1u << kNumBuckets;
+}
 
 AudioService::AudioService() {
     event_group_ = xEventGroupCreate();
+    encode_queue_space_ = xSemaphoreCreateBinary();
+    decode_queue_space_ = xSemaphoreCreateBinary();
 }
 
 AudioService::~AudioService() {
     if (event_group_ != nullptr) {
         vEventGroupDelete(event_group_);
     }
+    if (encode_queue_space_ != nullptr) {
+        vSemaphoreDelete(encode_queue_space_);
+    }
+    if (decode_queue_space_ != nullptr) {
+        vSemaphoreDelete(decode_queue_space_);
+    }
+}
+
+void AudioService::NotifyEncodeTask() {
+    if (opus_encode_task_handle_ != nullptr) {
+        xTaskNotifyGive(opus_encode_task_handle_);
+    }
+}
+
+void AudioService::NotifyDecodeTask() {
+    if (opus_decode_task_handle_ != nullptr) {
+        xTaskNotifyGive(opus_decode_task_handle_);
+    }
+}
+
+void AudioService::NotifyOutputTask() {
+    if (audio_output_task_handle_ != nullptr) {
+        xTaskNotifyGive(audio_output_task_handle_);
+    }
 }
 
 
@@ -33,16 +120,31 @@ void AudioService::Initialize(AudioCodec* codec) {
     codec_ = codec;
     codec_->Start();
 
+    // 整机声学标定档案（资源分区，按外壳打包）；没有就全部直通
+    AcousticCalibration::GetInstance().LoadFromAssets();
+
     /* Setup the audio codec */
     opus_decoder_ = std::make_unique<OpusDecoderWrapper>(codec->output_sample_rate(), 1, OPUS_FRAME_DURATION_MS);
     opus_encoder_ = std::make_unique<OpusEncoderWrapper>(16000, 1, OPUS_FRAME_DURATION_MS);
     opus_encoder_->SetComplexity(0);
 
+    // 机群可调：编码复杂度上限（弱 CPU 批次或特定网络批次下发），
+    // 热生效，由自适应闭环在上限内继续调节
+    int fleet_cap = KnobRegistry::GetInstance().RegisterInt(
+        "enc_cmplx_cap", -1, -1, OPUS_MAX_COMPLEXITY,
+        [this](int value) { SetFleetComplexityCap(value); });
+    SetFleetComplexityCap(fleet_cap);
+
     if (codec->input_sample_rate() != 16000) {
         input_resampler_.Configure(codec->input_sample_rate(), 16000);
         reference_resampler_.Configure(codec->input_sample_rate(), 16000);
     }
 
+#if CONFIG_USE_AUDIO_DEBUGGER
+    // 输入、输出任务都会投递抽头帧，提前创建避免惰性初始化竞争
+    audio_debugger_ = std::make_unique<AudioDebugger>();
+#endif
+
 #if CONFIG_USE_AUDIO_PROCESSOR
     audio_processor_ = std::make_unique<AfeAudioProcessor>();
 #else
@@ -50,11 +152,28 @@ void AudioService::Initialize(AudioCodec* codec) {
 #endif
 
     audio_processor_->OnOutput([this](std::vector<int16_t>&& data) {
+#if CONFIG_USE_AUDIO_DEBUGGER
+        audio_debugger_->Feed(kAudioDebugTapProcessed, data);
+#endif
+#if CONFIG_USE_VAD_GATED_ENCODE
+        /* During sustained silence, thin the uplink to sparse keepalive
+         * frames instead of encoding and sending every frame */
+        if (vad_state_seen_ && !voice_detected_) {
+            if (++vad_silence_frames_ > VAD_GATE_SILENCE_FRAMES &&
+                ++vad_gated_frames_ % VAD_GATE_KEEPALIVE_INTERVAL_FRAMES != 0) {
+                return;
+            }
+        } else {
+            vad_silence_frames_ = 0;
+            vad_gated_frames_ = 0;
+        }
+#endif
         PushTaskToEncodeQueue(kAudioTaskTypeEncodeToSendQueue, std::move(data));
     });
 
     audio_processor_->OnVadStateChange([this](bool speaking) {
         voice_detected_ = speaking;
+        vad_state_seen_ = true;
         if (callbacks_.on_vad_change) {
             callbacks_.on_vad_change(speaking);
         }
@@ -71,6 +190,22 @@ void AudioService::Initialize(AudioCodec* codec) {
         .skip_unhandled_events = true,
     };
     esp_timer_create(&audio_power_timer_args, &audio_power_timer_);
+
+#if CONFIG_USE_LP_WAKE_PRESCREEN
+    /* 两级唤醒的编排任务；LP 侧初始化失败就不建，常开监听照旧 */
+    if (LpWakePrescreen::GetInstance().Initialize()) {
+        xTaskCreate([](void* arg) {
+            ((AudioService*)arg)->LpPrescreenTask();
+            vTaskDelete(NULL);
+        }, "lp_prescreen", 2048 * 2, this, 3, &lp_prescreen_task_handle_);
+        TaskRegistry::GetInstance().Register(lp_prescreen_task_handle_, "lp_prescreen", 3, -1);
+    }
+#endif
+
+#if CONFIG_USE_AUDIO_BENCHMARK
+    /* Log per-stage cycles/frame before the pipeline starts */
+    AudioBenchmark::Run();
+#endif
 }
 
 void AudioService::Start() {
@@ -80,41 +215,79 @@ void AudioService::Start() {
     esp_timer_start_periodic(audio_power_timer_, 1000000);
 
 #if CONFIG_USE_AUDIO_PROCESSOR
+    auto& task_registry = TaskRegistry::GetInstance();
+
     /* Start the audio input task */
-    xTaskCreatePinnedToCore([](void* arg) {
+    int input_core = task_registry.ResolveCore("audio_input", 0);
+    audio_input_task_handle_ = audio_input_task_buffer_.Create([](void* arg) {
         AudioService* audio_service = (AudioService*)arg;
         audio_service->AudioInputTask();
         vTaskDelete(NULL);
-    }, "audio_input", 2048 * 3, this, 8, &audio_input_task_handle_, 0);
+    }, "audio_input", 2048 * 3, this, 8, input_core);
+    task_registry.Register(audio_input_task_handle_, "audio_input", 8, input_core);
 
     /* Start the audio output task */
-    xTaskCreate([](void* arg) {
+    audio_output_task_handle_ = audio_output_task_buffer_.Create([](void* arg) {
         AudioService* audio_service = (AudioService*)arg;
         audio_service->AudioOutputTask();
         vTaskDelete(NULL);
-    }, "audio_output", 2048 * 2, this, 4, &audio_output_task_handle_);
+    }, "audio_output", 2048 * 2, this, 4);
+    task_registry.Register(audio_output_task_handle_, "audio_output", 4, -1);
 #else
     /* Start the audio input task */
-    xTaskCreate([](void* arg) {
+    audio_input_task_handle_ = audio_input_task_buffer_.Create([](void* arg) {
         AudioService* audio_service = (AudioService*)arg;
         audio_service->AudioInputTask();
         vTaskDelete(NULL);
-    }, "audio_input", 2048 * 2, this, 8, &audio_input_task_handle_);
+    }, "audio_input", 2048 * 2, this, 8);
+    TaskRegistry::GetInstance().Register(audio_input_task_handle_, "audio_input", 8, -1);
 
     /* Start the audio output task */
-    xTaskCreate([](void* arg) {
+    audio_output_task_handle_ = audio_output_task_buffer_.Create([](void* arg) {
         AudioService* audio_service = (AudioService*)arg;
         audio_service->AudioOutputTask();
         vTaskDelete(NULL);
-    }, "audio_output", 2048, this, 4, &audio_output_task_handle_);
+    }, "audio_output", 2048, this, 4);
+    TaskRegistry::GetInstance().Register(audio_output_task_handle_, "audio_output", 4, -1);
 #endif
 
-    /* Start the opus codec task */
-    xTaskCreate([](void* arg) {
+#if (CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32P4 || CONFIG_IDF_TARGET_ESP32) && !CONFIG_FREERTOS_UNICORE
+    /* On dual-core targets, pin the heavy Opus encoder to core 1 so it never
+     * preempts the realtime input path on core 0, and let decode run on core 0
+     * where it interleaves with the lighter playback work. Both defaults can
+     * be overridden per board via CONFIG_TASK_AFFINITY_MAP. */
+    auto& codec_task_registry = TaskRegistry::GetInstance();
+    int encode_core = codec_task_registry.ResolveCore("opus_encode", 1);
+    opus_encode_task_handle_ = opus_encode_task_buffer_.Create([](void* arg) {
+        AudioService* audio_service = (AudioService*)arg;
+        audio_service->OpusEncodeTask();
+        vTaskDelete(NULL);
+    }, "opus_encode", 2048 * 10, this, 2, encode_core);
+    codec_task_registry.Register(opus_encode_task_handle_, "opus_encode", 2, encode_core);
+
+    int decode_core = codec_task_registry.ResolveCore("opus_decode", 0);
+    opus_decode_task_handle_ = opus_decode_task_buffer_.Create([](void* arg) {
+        AudioService* audio_service = (AudioService*)arg;
+        audio_service->OpusDecodeTask();
+        vTaskDelete(NULL);
+    }, "opus_decode", 2048 * 6, this, 2, decode_core);
+    codec_task_registry.Register(opus_decode_task_handle_, "opus_decode", 2, decode_core);
+#else
+    /* Start the opus encode / decode tasks */
+    opus_encode_task_handle_ = opus_encode_task_buffer_.Create([](void* arg) {
+        AudioService* audio_service = (AudioService*)arg;
+        audio_service->OpusEncodeTask();
+        vTaskDelete(NULL);
+    }, "opus_encode", 2048 * 10, this, 2);
+    TaskRegistry::GetInstance().Register(opus_encode_task_handle_, "opus_encode", 2, -1);
+
+    opus_decode_task_handle_ = opus_decode_task_buffer_.Create([](void* arg) {
         AudioService* audio_service = (AudioService*)arg;
-        audio_service->OpusCodecTask();
+        audio_service->OpusDecodeTask();
         vTaskDelete(NULL);
-    }, "opus_codec", 2048 * 13, this, 2, &opus_codec_task_handle_);
+    }, "opus_decode", 2048 * 6, this, 2);
+    TaskRegistry::GetInstance().Register(opus_decode_task_handle_, "opus_decode", 2, -1);
+#endif
 }
 
 void AudioService::Stop() {
@@ -124,12 +297,18 @@ void AudioService::Stop() {
         AS_EVENT_WAKE_WORD_RUNNING |
         AS_EVENT_AUDIO_PROCESSOR_RUNNING);
 
-    std::lock_guard<std::mutex> lock(audio_queue_mutex_);
-    audio_encode_queue_.clear();
-    audio_decode_queue_.clear();
-    audio_playback_queue_.clear();
-    audio_testing_queue_.clear();
-    audio_queue_cv_.notify_all();
+    /* Wake every task so it can observe service_stopped_ and exit. Remaining
+     * ring contents are drained on the consumer side the next time the tasks
+     * start, to keep clears on the single-consumer side of each ring. */
+    decoder_reset_requested_ = true;
+    playback_drain_requested_ = true;
+    timestamp_drain_requested_ = true;
+    NotifyEncodeTask();
+    NotifyDecodeTask();
+    NotifyOutputTask();
+    xSemaphoreGive(encode_queue_space_);
+    xSemaphoreGive(decode_queue_space_);
+    pcm_buffer_pool_.Clear();
 }
 
 bool AudioService::ReadAudioData(std::vector<int16_t>& data, int sample_rate, int samples) {
@@ -145,25 +324,29 @@ bool AudioService::ReadAudioData(std::vector<int16_t>& data, int sample_rate, in
             return false;
         }
         if (codec_->input_channels() == 2) {
-            auto mic_channel = std::vector<int16_t>(data.size() / 2);
-            auto reference_channel = std::vector<int16_t>(data.size() / 2);
-            for (size_t i = 0, j = 0; i < mic_channel.size(); ++i, j += 2) {
-                mic_channel[i] = data[j];
-                reference_channel[i] = data[j + 1];
+            /* Deinterleave and resample through persistent scratch buffers:
+             * their capacity survives between frames, so the mic/reference
+             * path does no per-frame allocations and the two channels stay
+             * sample-aligned for the AEC. */
+            mic_scratch_.resize(data.size() / 2);
+            reference_scratch_.resize(data.size() / 2);
+            for (size_t i = 0, j = 0; i < mic_scratch_.size(); ++i, j += 2) {
+                mic_scratch_[i] = data[j];
+                reference_scratch_[i] = data[j + 1];
             }
-            auto resampled_mic = std::vector<int16_t>(input_resampler_.GetOutputSamples(mic_channel.size()));
-            auto resampled_reference = std::vector<int16_t>(reference_resampler_.GetOutputSamples(reference_channel.size()));
-            input_resampler_.Process(mic_channel.data(), mic_channel.size(), resampled_mic.data());
-            reference_resampler_.Process(reference_channel.data(), reference_channel.size(), resampled_reference.data());
-            data.resize(resampled_mic.size() + resampled_reference.size());
-            for (size_t i = 0, j = 0; i < resampled_mic.size(); ++i, j += 2) {
-                data[j] = resampled_mic[i];
-                data[j + 1] = resampled_reference[i];
+            resampled_mic_scratch_.resize(input_resampler_.GetOutputSamples(mic_scratch_.size()));
+            resampled_reference_scratch_.resize(reference_resampler_.GetOutputSamples(reference_scratch_.size()));
+            input_resampler_.Process(mic_scratch_.data(), mic_scratch_.size(), resampled_mic_scratch_.data());
+            reference_resampler_.Process(reference_scratch_.data(), reference_scratch_.size(), resampled_reference_scratch_.data());
+            data.resize(resampled_mic_scratch_.size() + resampled_reference_scratch_.size());
+            for (size_t i = 0, j = 0; i < resampled_mic_scratch_.size(); ++i, j += 2) {
+                data[j] = resampled_mic_scratch_[i];
+                data[j + 1] = resampled_reference_scratch_[i];
             }
         } else {
-            auto resampled = std::vector<int16_t>(input_resampler_.GetOutputSamples(data.size()));
-            input_resampler_.Process(data.data(), data.size(), resampled.data());
-            data = std::move(resampled);
+            resampled_mic_scratch_.resize(input_resampler_.GetOutputSamples(data.size()));
+            input_resampler_.Process(data.data(), data.size(), resampled_mic_scratch_.data());
+            data.assign(resampled_mic_scratch_.begin(), resampled_mic_scratch_.end());
         }
     } else {
         data.resize(samples * codec_->input_channels());
@@ -178,10 +361,7 @@ bool AudioService::ReadAudioData(std::vector<int16_t>& data, int sample_rate, in
 
 #if CONFIG_USE_AUDIO_DEBUGGER
     // 音频调试：发送原始音频数据
-    if (audio_debugger_ == nullptr) {
-        audio_debugger_ = std::make_unique<AudioDebugger>();
-    }
-    audio_debugger_->Feed(data);
+    audio_debugger_->Feed(kAudioDebugTapRawMic, data);
 #endif
 
     return true;
@@ -198,13 +378,36 @@ void AudioService::AudioInputTask() {
         }
         if (audio_input_need_warmup_) {
             audio_input_need_warmup_ = false;
-            vTaskDelay(pdMS_TO_TICKS(120));
+            vTaskDelay(pdMS_TO_TICKS(codec_->input_warmup_ms()));
             continue;
         }
 
         /* Used for audio testing in NetworkConfiguring mode by clicking the BOOT button */
         if (bits & AS_EVENT_AUDIO_TESTING_RUNNING) {
-            if (audio_testing_queue_.size() >= AUDIO_TESTING_MAX_DURATION_MS / OPUS_FRAME_DURATION_MS) {
+            /* 回环自检：原始 PCM 顺序写进采集区，写满自动停 */
+            if (loopback_capture_active_) {
+                std::vector<int16_t> data;
+                int samples = OPUS_FRAME_DURATION_MS * 16000 / 1000;
+                if (ReadAudioData(data, 16000, samples)) {
+                    if (codec_->input_channels() == 2) {
+                        auto mono_data = std::vector<int16_t>(data.size() / 2);
+                        for (size_t i = 0, j = 0; i < mono_data.size(); ++i, j += 2) {
+                            mono_data[i] = data[j];
+                        }
+                        data = std::move(mono_data);
+                    }
+                    size_t pos = loopback_capture_pos_;
+                    size_t count = std::min(data.size(), loopback_capture_.size() - pos);
+                    std::memcpy(loopback_capture_.data() + pos, data.data(), count * sizeof(int16_t));
+                    loopback_capture_pos_ = pos + count;
+                    if (pos + count >= loopback_capture_.size()) {
+                        loopback_capture_active_ = false;
+                        xEventGroupClearBits(event_group_, AS_EVENT_AUDIO_TESTING_RUNNING);
+                    }
+                }
+                continue;
+            }
+            if (audio_testing_queue_.Size() >= AUDIO_TESTING_MAX_DURATION_MS / OPUS_FRAME_DURATION_MS) {
                 ESP_LOGW(TAG, "Audio testing queue is full, stopping audio testing");
                 EnableAudioTesting(false);
                 continue;
@@ -243,6 +446,7 @@ void AudioService::AudioInputTask() {
             int samples = audio_processor_->GetFeedSize();
             if (samples > 0) {
                 if (ReadAudioData(data, 16000, samples)) {
+                    TRACE_EVENT(TracePoint::kAudioInputFrame, audio_encode_queue_.Size());
                     audio_processor_->Feed(std::move(data));
                     continue;
                 }
@@ -258,33 +462,93 @@ void AudioService::AudioInputTask() {
 
 void AudioService::AudioOutputTask() {
     while (true) {
-        std::unique_lock<std::mutex> lock(audio_queue_mutex_);
-        audio_queue_cv_.wait(lock, [this]() { return !audio_playback_queue_.empty() || service_stopped_; });
+        if (playback_drain_requested_.exchange(false)) {
+            queue_statistics_.playback.dropped_reset += audio_playback_queue_.Size();
+            audio_playback_queue_.Clear();
+            playback_position_ms_ = 0;
+            {
+                std::lock_guard<std::mutex> lock(effect_lane_mutex_);
+                effect_lane_pcm_.clear();
+                effect_lane_pos_ = 0;
+            }
+            NotifyDecodeTask();
+        }
         if (service_stopped_) {
             break;
         }
 
-        auto task = std::move(audio_playback_queue_.front());
-        audio_playback_queue_.pop_front();
-        audio_queue_cv_.notify_all();
-        lock.unlock();
+        std::unique_ptr<AudioTask> task;
+        bool from_playback_queue = audio_playback_queue_.Pop(task);
+        if (from_playback_queue) {
+            /* A playback slot is free again, the decode task may decode more */
+            NotifyDecodeTask();
+        } else if (EffectLanePending()) {
+            /* 没有 TTS 帧在流动：叠加通道独立成帧播出（静音帧 + 混音），
+             * 播放节奏由 codec 的 DMA 写入自然限速 */
+            task = std::make_unique<AudioTask>();
+            task->type = kAudioTaskTypeDecodeToPlaybackQueue;
+            size_t frame_samples = (size_t)codec_->output_sample_rate() * OPUS_FRAME_DURATION_MS / 1000;
+            task->pcm = pcm_buffer_pool_.Acquire(frame_samples);
+        } else {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+            continue;
+        }
 
         if (!codec_->output_enabled()) {
             esp_timer_stop(audio_power_timer_);
             esp_timer_start_periodic(audio_power_timer_, AUDIO_POWER_CHECK_INTERVAL_MS * 1000);
             codec_->EnableOutput(true);
+            StartFadeIn();
+        }
+        if (task->trace_time_us > 0) {
+            latency_statistics_.decode_to_playback.Record(esp_timer_get_time() - task->trace_time_us);
+        }
+        /* A gap in playout means a new utterance, restart the position */
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_output_time_ > std::chrono::seconds(1)) {
+            playback_position_ms_ = 0;
+            StartFadeIn();
         }
+        size_t frame_samples = task->pcm.size();
+
+        MixEffectLane(task->pcm);
+        if (fade_in_remaining_ > 0) {
+            ApplyFadeIn(task->pcm);
+        }
+        // 整机声学标定：扬声器 EQ 级联 + 增益微调（没有档案时空操作）
+        auto& calibration = AcousticCalibration::GetInstance();
+        if (calibration.has_output_chain()) {
+            calibration.ProcessOutput(task->pcm.data(), task->pcm.size());
+        }
+        TRACE_EVENT(TracePoint::kAudioOutputFrame, audio_playback_queue_.Size());
+        LatencyScoreboard::GetInstance().Mark(LatencyScoreboard::kFirstPlayback);
         codec_->OutputData(task->pcm);
+#if CONFIG_USE_AUDIO_DEBUGGER
+        audio_debugger_->Feed(kAudioDebugTapOutput, task->pcm);
+#endif
+        /* Recycle the PCM buffer for the next decoded frame */
+        pcm_buffer_pool_.Release(std::move(task->pcm));
 
         /* Update the last output time */
-        last_output_time_ = std::chrono::steady_clock::now();
+        last_output_time_ = now;
         debug_statistics_.playback_count++;
 
+        /* 纯叠加通道合成的帧不推进语音播放进度 */
+        if (from_playback_queue) {
+            if (codec_->output_sample_rate() > 0) {
+                playback_position_ms_ += frame_samples * 1000 / codec_->output_sample_rate();
+            }
+            if (callbacks_.on_playback_position) {
+                callbacks_.on_playback_position(playback_position_ms_);
+            }
+        }
+
 #if CONFIG_USE_SERVER_AEC
         /* Record the timestamp for server AEC */
         if (task->timestamp > 0) {
-            lock.lock();
-            timestamp_queue_.push_back(task->timestamp);
+            if (!timestamp_queue_.Push(std::move(task->timestamp))) {
+                HOT_LOGW(TAG, "Timestamp queue is full, dropping timestamp");
+            }
         }
 #endif
     }
@@ -292,83 +556,257 @@ void AudioService::AudioOutputTask() {
     ESP_LOGW(TAG, "Audio output task stopped");
 }
 
-void AudioService::OpusCodecTask() {
+void AudioService::OpusDecodeTask() {
     while (true) {
-        std::unique_lock<std::mutex> lock(audio_queue_mutex_);
-        audio_queue_cv_.wait(lock, [this]() {
-            return service_stopped_ ||
-                (!audio_encode_queue_.empty() && audio_send_queue_.size() < MAX_SEND_PACKETS_IN_QUEUE) ||
-                (!audio_decode_queue_.empty() && audio_playback_queue_.size() < MAX_PLAYBACK_TASKS_IN_QUEUE);
-        });
+        if (decoder_reset_requested_.exchange(false)) {
+            opus_decoder_->ResetState();
+            queue_statistics_.decode.dropped_reset +=
+                audio_decode_queue_.Size() + decode_overflow_store_.Size();
+            audio_decode_queue_.Clear();
+            decode_overflow_store_.Clear();
+            xSemaphoreGive(decode_queue_space_);
+        }
         if (service_stopped_) {
             break;
         }
 
-        /* Decode the audio from decode queue */
-        if (!audio_decode_queue_.empty() && audio_playback_queue_.size() < MAX_PLAYBACK_TASKS_IN_QUEUE) {
-            auto packet = std::move(audio_decode_queue_.front());
-            audio_decode_queue_.pop_front();
-            audio_queue_cv_.notify_all();
-            lock.unlock();
+        if (audio_playback_queue_.Full()) {
+            queue_statistics_.playback.blocked_count++;
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+            continue;
+        }
+
+        /* Hold off until the jitter buffer has its target pre-buffer depth */
+        if (!jitter_buffer_.ShouldDecode(audio_decode_queue_.Size() + decode_overflow_store_.Size())) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+            continue;
+        }
 
-            auto task = std::make_unique<AudioTask>();
-            task->type = kAudioTaskTypeDecodeToPlaybackQueue;
-            task->timestamp = packet->timestamp;
-
-            SetDecodeSampleRate(packet->sample_rate, packet->frame_duration);
-            if (opus_decoder_->Decode(std::move(packet->payload), task->pcm)) {
-                // Resample if the sample rate is different
-                if (opus_decoder_->sample_rate() != codec_->output_sample_rate()) {
-                    int target_size = output_resampler_.GetOutputSamples(task->pcm.size());
-                    std::vector<int16_t> resampled(target_size);
-                    output_resampler_.Process(task->pcm.data(), task->pcm.size(), resampled.data());
-                    task->pcm = std::move(resampled);
+        std::unique_ptr<AudioStreamPacket> packet;
+        if (!audio_decode_queue_.Pop(packet)) {
+            /* Staging ring is drained; continue from the PSRAM overflow
+             * store, copying the payload back into internal RAM */
+            if (!decode_overflow_store_.Empty()) {
+                packet = Protocol::AcquireAudioPacket();
+                if (!decode_overflow_store_.Pop(*packet)) {
+                    Protocol::ReleaseAudioPacket(std::move(packet));
                 }
-
-                lock.lock();
-                audio_playback_queue_.push_back(std::move(task));
-                audio_queue_cv_.notify_all();
-            } else {
-                ESP_LOGE(TAG, "Failed to decode audio");
-                lock.lock();
             }
-            debug_statistics_.decode_count++;
-        }
-        
-        /* Encode the audio to send queue */
-        if (!audio_encode_queue_.empty() && audio_send_queue_.size() < MAX_SEND_PACKETS_IN_QUEUE) {
-            auto task = std::move(audio_encode_queue_.front());
-            audio_encode_queue_.pop_front();
-            audio_queue_cv_.notify_all();
-            lock.unlock();
-
-            auto packet = std::make_unique<AudioStreamPacket>();
-            packet->frame_duration = OPUS_FRAME_DURATION_MS;
-            packet->sample_rate = 16000;
-            packet->timestamp = task->timestamp;
-            if (!opus_encoder_->Encode(std::move(task->pcm), packet->payload)) {
-                ESP_LOGE(TAG, "Failed to encode audio");
-                continue;
+        }
+        if (packet == nullptr) {
+            if (jitter_buffer_.OnUnderrun()) {
+                TRACE_EVENT(TracePoint::kAudioUnderrun, jitter_buffer_.target_depth());
+                queue_statistics_.underrun_count++;
+                queue_statistics_.last_underrun_us = esp_timer_get_time();
+                FlashOpMonitor::GetInstance().OnUnderrun();
+                /* Conceal the gap with one frame of Opus PLC: an empty
+                 * payload makes the decoder extrapolate from its state. */
+                auto task = std::make_unique<AudioTask>();
+                task->type = kAudioTaskTypeDecodeToPlaybackQueue;
+                task->pcm = pcm_buffer_pool_.Acquire(0);
+                if (opus_decoder_->Decode(std::vector<uint8_t>(), task->pcm) && !task->pcm.empty()) {
+                    audio_playback_queue_.Push(std::move(task));
+                    NotifyOutputTask();
+                }
             }
+            /* Wait until a packet arrives or the output task frees a slot.
+             * The timeout lets us re-check service_stopped_ periodically. */
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+            continue;
+        }
+        xSemaphoreGive(decode_queue_space_);
+
+        auto task = std::make_unique<AudioTask>();
+        task->type = kAudioTaskTypeDecodeToPlaybackQueue;
+        task->timestamp = packet->timestamp;
+        /* Reuse a pooled buffer so the decoder writes into recycled capacity */
+        task->pcm = pcm_buffer_pool_.Acquire(0);
+
+        /* Cached UI sounds arrive as raw PCM at the codec output rate and
+         * bypass the decoder (and any sample-rate switch) entirely */
+        if (packet->pcm_payload) {
+            size_t samples = packet->payload.size() / sizeof(int16_t);
+            task->pcm.resize(samples);
+            memcpy(task->pcm.data(), packet->payload.data(), samples * sizeof(int16_t));
+            task->trace_time_us = esp_timer_get_time();
+            audio_playback_queue_.Push(std::move(task));
+            queue_statistics_.playback.OnDepth(audio_playback_queue_.Size());
+            NotifyOutputTask();
+            Protocol::ReleaseAudioPacket(std::move(packet));
+            continue;
+        }
+
+        auto decode_start = esp_timer_get_time();
+        latency_statistics_.receive_to_decode.Record(decode_start - packet->trace_time_us);
+        SetDecodeSampleRate(packet->sample_rate, packet->frame_duration);
+        if (opus_decoder_->Decode(std::move(packet->payload), task->pcm)) {
+            // Resample if the sample rate is different
+            if (opus_decoder_->sample_rate() != codec_->output_sample_rate()) {
+                int target_size = output_resampler_.GetOutputSamples(task->pcm.size());
+                auto resampled = pcm_buffer_pool_.Acquire(target_size);
+                output_resampler_.Process(task->pcm.data(), task->pcm.size(), resampled.data());
+                pcm_buffer_pool_.Release(std::move(task->pcm));
+                task->pcm = std::move(resampled);
+            }
+
+            jitter_buffer_.OnPlayout(task->timestamp);
+            task->trace_time_us = esp_timer_get_time();
+            latency_statistics_.decode.Record(task->trace_time_us - decode_start);
+            TRACE_EVENT(TracePoint::kAudioDecode, (task->trace_time_us - decode_start) / 64);
+            audio_playback_queue_.Push(std::move(task));
+            queue_statistics_.playback.OnDepth(audio_playback_queue_.Size());
+            NotifyOutputTask();
+        } else {
+            HOT_LOGE(TAG, "Failed to decode audio");
+        }
+        /* Return the packet shell to the protocol pool */
+        Protocol::ReleaseAudioPacket(std::move(packet));
+        debug_statistics_.decode_count++;
+    }
+
+    ESP_LOGW(TAG, "Opus decode task stopped");
+}
+
+void AudioService::OpusEncodeTask() {
+    while (true) {
+        if (service_stopped_) {
+            break;
+        }
 
+        std::unique_ptr<AudioTask> task;
+        if (audio_send_queue_.Full()) {
+            queue_statistics_.send.blocked_count++;
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+            continue;
+        }
+        if (!audio_encode_queue_.Pop(task)) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+            continue;
+        }
+        xSemaphoreGive(encode_queue_space_);
+
+        auto packet = std::make_unique<AudioStreamPacket>();
+        packet->frame_duration = OPUS_FRAME_DURATION_MS;
+        packet->sample_rate = 16000;
+        packet->timestamp = task->timestamp;
+        auto encode_start = esp_timer_get_time();
+        latency_statistics_.capture_to_encode.Record(encode_start - task->trace_time_us);
+        bool encoded = opus_encoder_->Encode(std::move(task->pcm), packet->payload);
+        auto encode_time_us = esp_timer_get_time() - encode_start;
+        latency_statistics_.encode.Record(encode_time_us);
+        AdjustEncoderComplexity(encode_time_us);
+        if (encoded) {
             if (task->type == kAudioTaskTypeEncodeToSendQueue) {
-                {
-                    std::lock_guard<std::mutex> lock(audio_queue_mutex_);
-                    audio_send_queue_.push_back(std::move(packet));
-                }
+                audio_send_queue_.Push(std::move(packet));
+                queue_statistics_.send.OnDepth(audio_send_queue_.Size());
+                UpdateSendCongestion(audio_send_queue_.Size());
                 if (callbacks_.on_send_queue_available) {
                     callbacks_.on_send_queue_available();
                 }
             } else if (task->type == kAudioTaskTypeEncodeToTestingQueue) {
-                std::lock_guard<std::mutex> lock(audio_queue_mutex_);
-                audio_testing_queue_.push_back(std::move(packet));
+                audio_testing_queue_.Push(std::move(packet));
             }
             debug_statistics_.encode_count++;
-            lock.lock();
+        } else {
+            HOT_LOGE(TAG, "Failed to encode audio");
         }
     }
 
-    ESP_LOGW(TAG, "Opus codec task stopped");
+    ESP_LOGW(TAG, "Opus encode task stopped");
+}
+
+void AudioService::AdjustEncoderComplexity(int64_t encode_time_us) {
+    /* EWMA with 1/8 weight, updated on the encode task only */
+    encode_time_ewma_us_ += (encode_time_us - encode_time_ewma_us_) / 8;
+
+    /* 结温/机群封顶取较小者：上限被压到当前值以下时立即降下去，
+     * 而不是等预算闭环 */
+    int thermal_cap = thermal_complexity_cap_.load(std::memory_order_relaxed);
+    int fleet_cap = fleet_complexity_cap_.load(std::memory_order_relaxed);
+    int max_complexity = OPUS_MAX_COMPLEXITY;
+    if (thermal_cap >= 0 && thermal_cap < max_complexity) {
+        max_complexity = thermal_cap;
+    }
+    if (fleet_cap >= 0 && fleet_cap < max_complexity) {
+        max_complexity = fleet_cap;
+    }
+    if (current_complexity_ > max_complexity) {
+        current_complexity_ = max_complexity;
+        opus_encoder_->SetComplexity(current_complexity_);
+        HOT_LOGI(TAG, "Complexity cap, down to %d", current_complexity_);
+    }
+
+    const int64_t frame_budget_us = OPUS_FRAME_DURATION_MS * 1000;
+    const int64_t lower_bound_us = frame_budget_us * OPUS_COMPLEXITY_RAISE_PERCENT / 100;
+    const int64_t upper_bound_us = frame_budget_us * OPUS_COMPLEXITY_BUDGET_PERCENT / 100;
+
+    /* Over budget: back off immediately to absorb CPU spikes (e.g. a TLS
+     * handshake on single-core targets) before the send queue overflows */
+    if (encode_time_ewma_us_ > upper_bound_us && current_complexity_ > 0) {
+        current_complexity_--;
+        opus_encoder_->SetComplexity(current_complexity_);
+        frames_since_complexity_adjust_ = 0;
+        HOT_LOGI(TAG, "Encode time %ld us over budget, complexity down to %d",
+                 (long)encode_time_ewma_us_, current_complexity_);
+        return;
+    }
+
+    /* Plenty of headroom for a sustained window: step quality back up
+     * （拥塞期间不回升，复杂度由拥塞闭环恢复） */
+    if (++frames_since_complexity_adjust_ >= OPUS_COMPLEXITY_ADJUST_INTERVAL_FRAMES) {
+        frames_since_complexity_adjust_ = 0;
+        if (!send_congested_ && encode_time_ewma_us_ < lower_bound_us && current_complexity_ < max_complexity) {
+            current_complexity_++;
+            opus_encoder_->SetComplexity(current_complexity_);
+            HOT_LOGI(TAG, "Encode headroom available, complexity up to %d", current_complexity_);
+        }
+    }
+}
+
+void AudioService::SetRadioDegraded(bool degraded) {
+    radio_degraded_.store(degraded, std::memory_order_relaxed);
+}
+
+void AudioService::UpdateSendCongestion(size_t depth) {
+    // 链路已报劣化时入门阈值减半：队列还没堆起来就先降载，
+    // 否则等深度真到 2/3 再动作，弱信号下往往已经丢了半秒音频
+    size_t enter_depth = radio_degraded_.load(std::memory_order_relaxed)
+                             ? SEND_CONGESTION_ENTER_DEPTH / 2
+                             : SEND_CONGESTION_ENTER_DEPTH;
+    if (!send_congested_) {
+        if (depth >= enter_depth) {
+            /* 链路跟不上：把编码复杂度压到底，省下的 CPU 让给网络栈，
+             * 并通过回调通知上层与服务器协商降码率 */
+            send_congested_ = true;
+            congestion_clear_frames_ = 0;
+            complexity_before_congestion_ = current_complexity_;
+            if (current_complexity_ > 0) {
+                current_complexity_ = 0;
+                opus_encoder_->SetComplexity(0);
+            }
+            HOT_LOGW(TAG, "Send queue congested, depth %d", (int)depth);
+            if (callbacks_.on_send_congestion) {
+                callbacks_.on_send_congestion(true);
+            }
+        }
+        return;
+    }
+    if (depth <= SEND_CONGESTION_CLEAR_DEPTH) {
+        /* 留出滞回窗口，避免在阈值附近抖动 */
+        if (++congestion_clear_frames_ >= SEND_CONGESTION_CLEAR_FRAMES) {
+            send_congested_ = false;
+            if (complexity_before_congestion_ > current_complexity_) {
+                current_complexity_ = complexity_before_congestion_;
+                opus_encoder_->SetComplexity(current_complexity_);
+            }
+            HOT_LOGI(TAG, "Send queue congestion cleared");
+            if (callbacks_.on_send_congestion) {
+                callbacks_.on_send_congestion(false);
+            }
+        }
+    } else {
+        congestion_clear_frames_ = 0;
+    }
 }
 
 void AudioService::SetDecodeSampleRate(int sample_rate, int frame_duration) {
@@ -376,8 +814,28 @@ void AudioService::SetDecodeSampleRate(int sample_rate, int frame_duration) {
         return;
     }
 
-    opus_decoder_.reset();
-    opus_decoder_ = std::make_unique<OpusDecoderWrapper>(sample_rate, 1, frame_duration);
+    /* Warm-start pool: the backend mixes 16k notification sounds with 24k
+     * TTS, so this switch happens several times per session. Park the
+     * current decoder and reuse a pre-initialized one with the requested
+     * configuration; switching back becomes a pointer swap plus a cheap
+     * state reset instead of a full decoder reinit. */
+    if (opus_decoder_ != nullptr) {
+        decoder_pool_.push_back(std::move(opus_decoder_));
+        while (decoder_pool_.size() > MAX_POOLED_OPUS_DECODERS) {
+            decoder_pool_.pop_front();
+        }
+    }
+    for (auto it = decoder_pool_.begin(); it != decoder_pool_.end(); ++it) {
+        if ((*it)->sample_rate() == sample_rate && (*it)->duration_ms() == frame_duration) {
+            opus_decoder_ = std::move(*it);
+            decoder_pool_.erase(it);
+            opus_decoder_->ResetState();
+            break;
+        }
+    }
+    if (opus_decoder_ == nullptr) {
+        opus_decoder_ = std::make_unique<OpusDecoderWrapper>(sample_rate, 1, frame_duration);
+    }
 
     auto codec = Board::GetInstance().GetAudioCodec();
     if (opus_decoder_->sample_rate() != codec->output_sample_rate()) {
@@ -390,47 +848,136 @@ void AudioService::PushTaskToEncodeQueue(AudioTaskType type, std::vector<int16_t
     auto task = std::make_unique<AudioTask>();
     task->type = type;
     task->pcm = std::move(pcm);
-    
-    /* Push the task to the encode queue */
-    std::unique_lock<std::mutex> lock(audio_queue_mutex_);
+    task->trace_time_us = esp_timer_get_time();
+
+    /* This context is the single consumer of the timestamp ring */
+    if (timestamp_drain_requested_.exchange(false)) {
+        timestamp_queue_.Clear();
+    }
 
     /* If the task is to send queue, we need to set the timestamp */
-    if (type == kAudioTaskTypeEncodeToSendQueue && !timestamp_queue_.empty()) {
-        if (timestamp_queue_.size() <= MAX_TIMESTAMPS_IN_QUEUE) {
-            task->timestamp = timestamp_queue_.front();
-        } else {
-            ESP_LOGW(TAG, "Timestamp queue (%u) is full, dropping timestamp", timestamp_queue_.size());
-        }
-        timestamp_queue_.pop_front();
+    if (type == kAudioTaskTypeEncodeToSendQueue) {
+        timestamp_queue_.Pop(task->timestamp);
     }
 
-    audio_queue_cv_.wait(lock, [this]() { return audio_encode_queue_.size() < MAX_ENCODE_TASKS_IN_QUEUE; });
-    audio_encode_queue_.push_back(std::move(task));
-    audio_queue_cv_.notify_all();
+    if (audio_encode_queue_.Full()) {
+        queue_statistics_.encode.blocked_count++;
+    }
+    while (!audio_encode_queue_.Push(std::move(task))) {
+        if (service_stopped_) {
+            return;
+        }
+        xSemaphoreTake(encode_queue_space_, pdMS_TO_TICKS(100));
+    }
+    queue_statistics_.encode.OnDepth(audio_encode_queue_.Size());
+    NotifyEncodeTask();
 }
 
 bool AudioService::PushPacketToDecodeQueue(std::unique_ptr<AudioStreamPacket> packet, bool wait) {
-    std::unique_lock<std::mutex> lock(audio_queue_mutex_);
-    if (audio_decode_queue_.size() >= MAX_DECODE_PACKETS_IN_QUEUE) {
-        if (wait) {
-            audio_queue_cv_.wait(lock, [this]() { return audio_decode_queue_.size() < MAX_DECODE_PACKETS_IN_QUEUE; });
-        } else {
+    packet->trace_time_us = esp_timer_get_time();
+    jitter_buffer_.OnPacketArrived(packet->frame_duration);
+    if (jitter_buffer_.IsLate(packet->timestamp)) {
+        /* Arrived after its playout position, playing it would glitch */
+        queue_statistics_.decode_dropped_late++;
+        Protocol::ReleaseAudioPacket(std::move(packet));
+        return true;
+    }
+    /* Keep the internal-RAM ring as the decoder's staging window and spill
+     * everything else to PSRAM. Once the overflow store holds packets, new
+     * arrivals must go there too, or they would overtake the stored ones. */
+    if (decode_overflow_store_.Empty() && audio_decode_queue_.Push(std::move(packet))) {
+        queue_statistics_.decode.OnDepth(audio_decode_queue_.Size());
+        NotifyDecodeTask();
+        return true;
+    }
+    bool blocked = false;
+    while (!decode_overflow_store_.Push(*packet)) {
+        if (!blocked) {
+            blocked = true;
+            queue_statistics_.decode.blocked_count++;
+        }
+        if (!wait || service_stopped_) {
+            queue_statistics_.decode_dropped_overflow++;
             return false;
         }
+        xSemaphoreTake(decode_queue_space_, pdMS_TO_TICKS(100));
     }
-    audio_decode_queue_.push_back(std::move(packet));
-    audio_queue_cv_.notify_all();
+    queue_statistics_.decode_spilled++;
+    Protocol::ReleaseAudioPacket(std::move(packet));
+    NotifyDecodeTask();
     return true;
 }
 
+void AudioService::DumpLatencyStatistics() {
+    struct {
+        const char* name;
+        const LatencyHistogram* histogram;
+    } stages[] = {
+        { "capture->encode", &latency_statistics_.capture_to_encode },
+        { "encode", &latency_statistics_.encode },
+        { "receive->decode", &latency_statistics_.receive_to_decode },
+        { "decode", &latency_statistics_.decode },
+        { "decode->playback", &latency_statistics_.decode_to_playback },
+    };
+    for (auto& stage : stages) {
+        ESP_LOGI(TAG, "latency %s: p50=%lu us p90=%lu us p99=%lu us (%lu frames)",
+            stage.name,
+            (unsigned long)stage.histogram->PercentileUs(50),
+            (unsigned long)stage.histogram->PercentileUs(90),
+            (unsigned long)stage.histogram->PercentileUs(99),
+            (unsigned long)stage.histogram->count);
+    }
+}
+
+std::string AudioService::GetQueueStatisticsJson() const {
+    auto& q = queue_statistics_;
+    // 每队列 [高水位, 堵塞, reset 丢弃]
+    char buffer[320];
+    snprintf(buffer, sizeof(buffer),
+             "{\"encode\":[%lu,%lu,%lu],\"decode\":[%lu,%lu,%lu],\"send\":[%lu,%lu,%lu],"
+             "\"playback\":[%lu,%lu,%lu],\"drops\":{\"late\":%lu,\"overflow\":%lu},"
+             "\"spilled\":%lu,\"underruns\":%lu,\"last_underrun_age_s\":%ld}",
+             (unsigned long)q.encode.high_watermark, (unsigned long)q.encode.blocked_count,
+             (unsigned long)q.encode.dropped_reset,
+             (unsigned long)q.decode.high_watermark, (unsigned long)q.decode.blocked_count,
+             (unsigned long)q.decode.dropped_reset,
+             (unsigned long)q.send.high_watermark, (unsigned long)q.send.blocked_count,
+             (unsigned long)q.send.dropped_reset,
+             (unsigned long)q.playback.high_watermark, (unsigned long)q.playback.blocked_count,
+             (unsigned long)q.playback.dropped_reset,
+             (unsigned long)q.decode_dropped_late, (unsigned long)q.decode_dropped_overflow,
+             (unsigned long)q.decode_spilled, (unsigned long)q.underrun_count,
+             q.last_underrun_us > 0
+                 ? (long)((esp_timer_get_time() - q.last_underrun_us) / 1000000)
+                 : -1L);
+    return std::string(buffer);
+}
+
+void AudioService::DumpQueueStatistics() {
+    auto& q = queue_statistics_;
+    ESP_LOGI(TAG, "queues hwm enc=%lu dec=%lu send=%lu play=%lu, blocked %lu/%lu/%lu/%lu",
+        (unsigned long)q.encode.high_watermark, (unsigned long)q.decode.high_watermark,
+        (unsigned long)q.send.high_watermark, (unsigned long)q.playback.high_watermark,
+        (unsigned long)q.encode.blocked_count, (unsigned long)q.decode.blocked_count,
+        (unsigned long)q.send.blocked_count, (unsigned long)q.playback.blocked_count);
+    if (q.decode_dropped_late + q.decode_dropped_overflow + q.decode.dropped_reset +
+        q.playback.dropped_reset + q.underrun_count > 0) {
+        ESP_LOGI(TAG, "drops late=%lu overflow=%lu reset=%lu/%lu, underruns=%lu (last %llds ago)",
+            (unsigned long)q.decode_dropped_late, (unsigned long)q.decode_dropped_overflow,
+            (unsigned long)q.decode.dropped_reset, (unsigned long)q.playback.dropped_reset,
+            (unsigned long)q.underrun_count,
+            q.last_underrun_us > 0
+                ? (long long)((esp_timer_get_time() - q.last_underrun_us) / 1000000)
+                : -1LL);
+    }
+}
+
 std::unique_ptr<AudioStreamPacket> AudioService::PopPacketFromSendQueue() {
-    std::lock_guard<std::mutex> lock(audio_queue_mutex_);
-    if (audio_send_queue_.empty()) {
-        return nullptr;
+    std::unique_ptr<AudioStreamPacket> packet;
+    if (audio_send_queue_.Pop(packet)) {
+        /* A send slot is free again, the encode task may encode more */
+        NotifyEncodeTask();
     }
-    auto packet = std::move(audio_send_queue_.front());
-    audio_send_queue_.pop_front();
-    audio_queue_cv_.notify_all();
     return packet;
 }
 
@@ -474,6 +1021,80 @@ void AudioService::EnableWakeWordDetection(bool enable) {
     }
 }
 
+#if CONFIG_USE_LP_WAKE_PRESCREEN
+
+void AudioService::EnableLpPrescreen(bool allowed) {
+    if (lp_prescreen_task_handle_ == nullptr) {
+        return;
+    }
+    if (lp_prescreen_allowed_.exchange(allowed) == allowed) {
+        return;
+    }
+    if (allowed) {
+        xTaskNotifyGive(lp_prescreen_task_handle_);
+    } else {
+        // 让正在一级监听里阻塞的编排任务立即返回；HP 侧想要的状态
+        // 由调用方随后的 EnableWakeWordDetection 决定
+        LpWakePrescreen::GetInstance().Disarm();
+    }
+}
+
+void AudioService::LpPrescreenTask() {
+    auto& prescreen = LpWakePrescreen::GetInstance();
+    // 刚进空闲的一段时间里继续用 HP 引擎，保持零确认延迟；连续空闲
+    // 满宽限期才把监听降级到 LP 域
+    constexpr int kIdleGraceSeconds = 30;
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        int grace = kIdleGraceSeconds;
+        while (lp_prescreen_allowed_ && grace-- > 0) {
+            vTaskDelay(pdMS_TO_TICKS(1000));
+        }
+        if (!lp_prescreen_allowed_ || !IsWakeWordRunning()) {
+            continue;
+        }
+
+        /* 一级：停 HP 引擎喂入，等在途 Feed 归位，断掉编解码器输入，
+         * 布防 LP VAD。此后 HP 核可以睡满每个空闲窗口 */
+        wake_word_->Stop();
+        xEventGroupClearBits(event_group_, AS_EVENT_WAKE_WORD_RUNNING);
+        vTaskDelay(pdMS_TO_TICKS(OPUS_FRAME_DURATION_MS * 2));
+        codec_->EnableInput(false);
+        prescreen.Arm();
+
+        std::vector<int16_t> preroll;
+        bool voice = prescreen.WaitVoice(preroll);
+        prescreen.Disarm();
+
+        if (!voice) {
+            // 撤防路径：调用方已接管唤醒词开关，这里不抢着恢复
+            continue;
+        }
+
+        /* 二级：恢复 HP 链路，先把 LP 侧缓存的 preroll 灌给唤醒词
+         * 引擎再放行实时流，引擎看到的音频与单级方案一致 */
+        wake_word_->Start();
+        size_t feed = wake_word_->GetFeedSize();
+        if (feed > 0) {
+            std::vector<int16_t> frame(feed);
+            for (size_t pos = 0; pos + feed <= preroll.size(); pos += feed) {
+                frame.assign(preroll.begin() + pos, preroll.begin() + pos + feed);
+                wake_word_->Feed(frame);
+            }
+        }
+        xEventGroupSetBits(event_group_, AS_EVENT_WAKE_WORD_RUNNING);
+
+        // 误触发（确认不出词）时设备还在空闲，重新走宽限期降级
+        if (lp_prescreen_allowed_) {
+            xTaskNotifyGive(lp_prescreen_task_handle_);
+        }
+    }
+}
+
+#endif // CONFIG_USE_LP_WAKE_PRESCREEN
+
 void AudioService::EnableVoiceProcessing(bool enable) {
     ESP_LOGD(TAG, "%s voice processing", enable ? "Enabling" : "Disabling");
     if (enable) {
@@ -484,12 +1105,19 @@ void AudioService::EnableVoiceProcessing(bool enable) {
 
         /* We should make sure no audio is playing */
         ResetDecoder();
-        audio_input_need_warmup_ = true;
+        /* 唤醒词常开时麦克风本来就在跑，链路没有断电就不用付预热；
+         * 只有输入真正重新上电（PLL 重锁）才需要丢弃起始帧 */
+        audio_input_need_warmup_ = !codec_->input_enabled();
         audio_processor_->Start();
         xEventGroupSetBits(event_group_, AS_EVENT_AUDIO_PROCESSOR_RUNNING);
+        // 处理器运行期间锁满频，防止 DVFS 降频造成欠载
+        DvfsGovernor::GetInstance().SetAudioLock(true);
+        PowerProfiler::GetInstance().SetFlag(PowerProfiler::kFlagAudioProcessor, true);
     } else {
         audio_processor_->Stop();
         xEventGroupClearBits(event_group_, AS_EVENT_AUDIO_PROCESSOR_RUNNING);
+        DvfsGovernor::GetInstance().SetAudioLock(false);
+        PowerProfiler::GetInstance().SetFlag(PowerProfiler::kFlagAudioProcessor, false);
     }
 }
 
@@ -499,13 +1127,192 @@ void AudioService::EnableAudioTesting(bool enable) {
         xEventGroupSetBits(event_group_, AS_EVENT_AUDIO_TESTING_RUNNING);
     } else {
         xEventGroupClearBits(event_group_, AS_EVENT_AUDIO_TESTING_RUNNING);
-        /* Copy audio_testing_queue_ to audio_decode_queue_ */
-        std::lock_guard<std::mutex> lock(audio_queue_mutex_);
-        audio_decode_queue_ = std::move(audio_testing_queue_);
-        audio_queue_cv_.notify_all();
+        /* Move audio_testing_queue_ to audio_decode_queue_ for playback.
+         * No protocol is connected in testing mode, so this context is the
+         * only decode-queue producer at this point. */
+        std::unique_ptr<AudioStreamPacket> packet;
+        while (audio_testing_queue_.Pop(packet)) {
+            if (!PushPacketToDecodeQueue(std::move(packet), true)) {
+                break;
+            }
+        }
     }
 }
 
+/* Goertzel 单点功率，用于回环自检纯音段的基波/谐波测量 */
+static float GoertzelPower(const int16_t* x, int n, float freq, int sample_rate) {
+    float coeff = 2.0f * cosf(2.0f * (float)M_PI * freq / sample_rate);
+    float s1 = 0.0f, s2 = 0.0f;
+    for (int i = 0; i < n; i++) {
+        float s0 = (float)x[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    return s1 * s1 + s2 * s2 - coeff * s1 * s2;
+}
+
+AudioService::LoopbackTestResult AudioService::RunLoopbackTest() {
+    LoopbackTestResult result;
+    if (!IsIdle() || loopback_capture_active_) {
+        ESP_LOGW(TAG, "Loopback test refused, audio pipeline is busy");
+        return result;
+    }
+
+    constexpr int kSampleRate = 16000;
+    constexpr int kChirpMs = 200;
+    constexpr int kGapMs = 100;
+    constexpr int kToneMs = 300;
+    constexpr int kCaptureMs = 1000;
+    constexpr int kToneFreq = 1000;
+    constexpr float kAmplitude = 16384.0f;  // -6 dBFS
+
+    // 激励 = Hann 窗线性啁啾(500→3500Hz) + 静音间隔 + 1kHz 纯音。
+    // 同一公式按两个采样率各生成一份：参考序列跟采集端走 16k，播放
+    // 序列直接按 codec 输出采样率合成，两边都不需要再重采样
+    auto build_signal = [&](int sr) {
+        int chirp_n = sr * kChirpMs / 1000;
+        int gap_n = sr * kGapMs / 1000;
+        int tone_n = sr * kToneMs / 1000;
+        std::vector<int16_t> signal(chirp_n + gap_n + tone_n, 0);
+        const float f0 = 500.0f, f1 = 3500.0f;
+        const float duration = (float)kChirpMs / 1000.0f;
+        for (int i = 0; i < chirp_n; i++) {
+            float t = (float)i / sr;
+            float phase = 2.0f * (float)M_PI * (f0 * t + (f1 - f0) * t * t / (2.0f * duration));
+            float window = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / (chirp_n - 1));
+            signal[i] = (int16_t)(kAmplitude * window * sinf(phase));
+        }
+        int edge_n = sr * 5 / 1000;  // 5ms 收边
+        for (int i = 0; i < tone_n; i++) {
+            float window = 1.0f;
+            if (i < edge_n) {
+                window = (float)i / edge_n;
+            } else if (i >= tone_n - edge_n) {
+                window = (float)(tone_n - 1 - i) / edge_n;
+            }
+            signal[chirp_n + gap_n + i] =
+                (int16_t)(kAmplitude * window * sinf(2.0f * (float)M_PI * kToneFreq * i / sr));
+        }
+        return signal;
+    };
+    auto reference = build_signal(kSampleRate);
+    auto playback = build_signal(codec_->output_sample_rate());
+
+    // 先开采集再入队播放：播放链路的固定启动偏差由互相关一并量出来
+    loopback_capture_.assign(kSampleRate * kCaptureMs / 1000, 0);
+    loopback_capture_pos_ = 0;
+    loopback_capture_active_ = true;
+    xEventGroupSetBits(event_group_, AS_EVENT_AUDIO_TESTING_RUNNING);
+
+    if (!codec_->output_enabled()) {
+        esp_timer_stop(audio_power_timer_);
+        esp_timer_start_periodic(audio_power_timer_, AUDIO_POWER_CHECK_INTERVAL_MS * 1000);
+        codec_->EnableOutput(true);
+    }
+    QueueEffectPcm(playback.data(), playback.size());
+    NotifyOutputTask();
+
+    // 采集区写满时输入任务自动清事件位；加 1s 超时兜底
+    for (int i = 0; i < (kCaptureMs + 1000) / 50 && loopback_capture_active_; i++) {
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+    bool completed = !loopback_capture_active_;
+    loopback_capture_active_ = false;
+    xEventGroupClearBits(event_group_, AS_EVENT_AUDIO_TESTING_RUNNING);
+    if (!completed) {
+        ESP_LOGE(TAG, "Loopback capture timed out");
+        loopback_capture_ = std::vector<int16_t>();
+        return result;
+    }
+
+    /* 时延：4:1 抽取后用 64 位累加器做整数互相关找啁啾峰值（抽取后
+     * 每个滞后点 800 次乘加，全程 <10ms，分辨率 0.25ms）。esp-dsp 的
+     * dsps_dotprod_s16 结果饱和在 16 位，真实麦克风电平下峰会被压平，
+     * 不适合这里 */
+    const int chirp_samples = kSampleRate * kChirpMs / 1000;
+    auto decimate = [](const int16_t* in, size_t count) {
+        std::vector<int16_t> out(count / 4);
+        for (size_t i = 0; i < out.size(); i++) {
+            int32_t acc = 0;
+            for (int j = 0; j < 4; j++) {
+                acc += in[i * 4 + j];
+            }
+            out[i] = (int16_t)(acc / 4);
+        }
+        return out;
+    };
+    auto ref_dec = decimate(reference.data(), chirp_samples);
+    auto cap_dec = decimate(loopback_capture_.data(), loopback_capture_.size());
+
+    int best_lag = -1;
+    int64_t best_corr = 0;
+    for (size_t lag = 0; lag + ref_dec.size() <= cap_dec.size(); lag++) {
+        int64_t acc = 0;
+        for (size_t i = 0; i < ref_dec.size(); i++) {
+            acc += (int32_t)ref_dec[i] * cap_dec[lag + i];
+        }
+        // 扬声器/麦克风任一极性反接时相关峰是负的，取绝对值
+        if (acc < 0) {
+            acc = -acc;
+        }
+        if (acc > best_corr) {
+            best_corr = acc;
+            best_lag = (int)lag;
+        }
+    }
+    if (best_lag < 0) {
+        ESP_LOGE(TAG, "Loopback chirp not found in capture");
+        loopback_capture_ = std::vector<int16_t>();
+        return result;
+    }
+    int latency_samples = best_lag * 4;
+
+    // 增益：对齐后啁啾段的 RMS 比
+    auto rms = [](const int16_t* x, int n) {
+        double acc = 0.0;
+        for (int i = 0; i < n; i++) {
+            acc += (double)x[i] * x[i];
+        }
+        return sqrt(acc / n);
+    };
+    int aligned_n = std::min(chirp_samples, (int)loopback_capture_.size() - latency_samples);
+    double ref_rms = rms(reference.data(), chirp_samples);
+    double cap_rms = rms(loopback_capture_.data() + latency_samples, aligned_n);
+    if (cap_rms < 1.0) {
+        ESP_LOGE(TAG, "Loopback capture is silent, mic or speaker dead?");
+        loopback_capture_ = std::vector<int16_t>();
+        return result;
+    }
+
+    // THD：纯音段掐头去尾各 20ms 避开收边，Goertzel 测基波和 2~5 次谐波
+    int tone_offset = latency_samples + kSampleRate * (kChirpMs + kGapMs + 20) / 1000;
+    int tone_samples = kSampleRate * (kToneMs - 40) / 1000;
+    if (tone_offset + tone_samples > (int)loopback_capture_.size()) {
+        tone_samples = (int)loopback_capture_.size() - tone_offset;
+    }
+    float thd = 0.0f;
+    if (tone_samples > 0) {
+        const int16_t* tone = loopback_capture_.data() + tone_offset;
+        float fundamental = GoertzelPower(tone, tone_samples, kToneFreq, kSampleRate);
+        float harmonics = 0.0f;
+        for (int h = 2; h <= 5; h++) {
+            harmonics += GoertzelPower(tone, tone_samples, (float)(kToneFreq * h), kSampleRate);
+        }
+        if (fundamental > 0.0f) {
+            thd = 100.0f * sqrtf(harmonics / fundamental);
+        }
+    }
+
+    result.valid = true;
+    result.latency_ms = latency_samples * 1000 / kSampleRate;
+    result.gain_db = 20.0f * log10f((float)(cap_rms / ref_rms));
+    result.thd_percent = thd;
+    loopback_capture_ = std::vector<int16_t>();
+    ESP_LOGI(TAG, "Loopback test: latency %d ms, gain %.1f dB, THD %.1f%%",
+             result.latency_ms, result.gain_db, result.thd_percent);
+    return result;
+}
+
 void AudioService::EnableDeviceAec(bool enable) {
     ESP_LOGI(TAG, "%s device AEC", enable ? "Enabling" : "Disabling");
     if (!audio_processor_initialized_) {
@@ -527,6 +1334,82 @@ void AudioService::PlaySound(const std::string_view& ogg) {
         codec_->EnableOutput(true);
     }
 
+    /* UI sounds are embedded assets, so the data pointer identifies the
+     * sound. Cached sounds play as raw PCM packets and never touch the
+     * Opus decoder, so an alert is not delayed by a busy TTS stream.
+     * 进叠加通道：输出任务把它与正在播放的 TTS 帧饱和混音，提示音叠在
+     * 语音上播出，不再排在解码队列后面。拷贝在缓存锁内完成，预算管理
+     * 器从别的任务回收缓存也不会抽走正在用的 PCM */
+    auto queue_effect = [this](const int16_t* pcm, size_t samples) {
+        QueueEffectPcm(pcm, samples);
+    };
+    if (!sound_cache_.Get(ogg.data(), queue_effect)) {
+        if (!DecodeSoundToCache(ogg) || !sound_cache_.Get(ogg.data(), queue_effect)) {
+            /* No PSRAM for the cache: play through the decoder as before */
+            PlaySoundThroughDecoder(ogg);
+            return;
+        }
+    }
+    NotifyOutputTask();
+}
+
+void AudioService::WarmSoundCache(const std::string_view& sound) {
+    if (!sound_cache_.Contains(sound.data())) {
+        DecodeSoundToCache(sound);
+    }
+}
+
+void AudioService::StartFadeIn() {
+    fade_in_total_ = (size_t)codec_->output_sample_rate() * kFadeInMs / 1000;
+    fade_in_remaining_ = fade_in_total_;
+}
+
+void AudioService::ApplyFadeIn(std::vector<int16_t>& pcm) {
+    for (size_t i = 0; i < pcm.size() && fade_in_remaining_ > 0; i++, fade_in_remaining_--) {
+        size_t done = fade_in_total_ - fade_in_remaining_;
+        int idx = (int)(done * kFadeRampSteps / fade_in_total_);
+        pcm[i] = (int16_t)(((int32_t)pcm[i] * kFadeRamp.q15[idx]) >> 15);
+    }
+}
+
+void AudioService::QueueEffectPcm(const int16_t* pcm, size_t samples) {
+    std::lock_guard<std::mutex> lock(effect_lane_mutex_);
+    if (effect_lane_pos_ >= effect_lane_pcm_.size()) {
+        effect_lane_pcm_.clear();
+        effect_lane_pos_ = 0;
+    }
+    effect_lane_pcm_.insert(effect_lane_pcm_.end(), pcm, pcm + samples);
+}
+
+bool AudioService::EffectLanePending() {
+    std::lock_guard<std::mutex> lock(effect_lane_mutex_);
+    return effect_lane_pos_ < effect_lane_pcm_.size();
+}
+
+void AudioService::MixEffectLane(std::vector<int16_t>& pcm) {
+    /* 叠加通道增益 0.8（Q15），TTS 保持原电平，相加后饱和截断 */
+    static constexpr int32_t kEffectLaneGainQ15 = 26214;
+    std::lock_guard<std::mutex> lock(effect_lane_mutex_);
+    size_t available = effect_lane_pcm_.size() - effect_lane_pos_;
+    size_t count = std::min(pcm.size(), available);
+    const int16_t* effect = effect_lane_pcm_.data() + effect_lane_pos_;
+    for (size_t i = 0; i < count; i++) {
+        int32_t mixed = (int32_t)pcm[i] + (((int32_t)effect[i] * kEffectLaneGainQ15) >> 15);
+        if (mixed > INT16_MAX) {
+            mixed = INT16_MAX;
+        } else if (mixed < INT16_MIN) {
+            mixed = INT16_MIN;
+        }
+        pcm[i] = (int16_t)mixed;
+    }
+    effect_lane_pos_ += count;
+    if (effect_lane_pos_ >= effect_lane_pcm_.size()) {
+        effect_lane_pcm_.clear();
+        effect_lane_pos_ = 0;
+    }
+}
+
+void AudioService::ParseOggOpus(const std::string_view& ogg, int& sample_rate, std::vector<std::vector<uint8_t>>& packets) {
     const uint8_t* buf = reinterpret_cast<const uint8_t*>(ogg.data());
     size_t size = ogg.size();
     size_t offset = 0;
@@ -540,7 +1423,7 @@ void AudioService::PlaySound(const std::string_view& ogg) {
 
     bool seen_head = false;
     bool seen_tags = false;
-    int sample_rate = 16000; // 默认值
+    sample_rate = 16000; // 默认值
 
     while (true) {
         size_t pos = find_page(offset);
@@ -607,38 +1490,85 @@ void AudioService::PlaySound(const std::string_view& ogg) {
             }
 
             // Audio packet (Opus)
-            auto packet = std::make_unique<AudioStreamPacket>();
-            packet->sample_rate = sample_rate;
-            packet->frame_duration = 60;
-            packet->payload.resize(pkt_len);
-            std::memcpy(packet->payload.data(), pkt_ptr, pkt_len);
-            PushPacketToDecodeQueue(std::move(packet), true);
+            packets.emplace_back(pkt_ptr, pkt_ptr + pkt_len);
         }
 
         offset = body_off + body_size;
     }
 }
 
+bool AudioService::DecodeSoundToCache(const std::string_view& ogg) {
+    int sample_rate = 16000;
+    std::vector<std::vector<uint8_t>> packets;
+    ParseOggOpus(ogg, sample_rate, packets);
+    if (packets.empty()) {
+        return false;
+    }
+
+    /* Decode on the calling task with a throwaway decoder; UI sounds are
+     * short and this runs once per sound, every later play is a copy */
+    auto decoder = std::make_unique<OpusDecoderWrapper>(sample_rate, 1, 60);
+    std::vector<int16_t> pcm;
+    for (auto& packet : packets) {
+        std::vector<int16_t> frame;
+        if (decoder->Decode(std::move(packet), frame)) {
+            pcm.insert(pcm.end(), frame.begin(), frame.end());
+        }
+    }
+    if (pcm.empty()) {
+        return false;
+    }
+
+    /* Cache at the codec output rate so playback is a straight copy */
+    int output_sample_rate = codec_->output_sample_rate();
+    if (sample_rate != output_sample_rate) {
+        FirResampler resampler;
+        resampler.Configure(sample_rate, output_sample_rate);
+        std::vector<int16_t> resampled(resampler.GetOutputSamples(pcm.size()));
+        resampler.Process(pcm.data(), pcm.size(), resampled.data());
+        pcm = std::move(resampled);
+    }
+
+    sound_cache_.Put(ogg.data(), pcm.data(), pcm.size());
+    return true;
+}
+
+void AudioService::PlaySoundThroughDecoder(const std::string_view& ogg) {
+    int sample_rate = 16000;
+    std::vector<std::vector<uint8_t>> packets;
+    ParseOggOpus(ogg, sample_rate, packets);
+
+    for (auto& payload : packets) {
+        auto packet = Protocol::AcquireAudioPacket();
+        packet->sample_rate = sample_rate;
+        packet->frame_duration = 60;
+        packet->payload = std::move(payload);
+        PushPacketToDecodeQueue(std::move(packet), true);
+    }
+}
+
 bool AudioService::IsIdle() {
-    std::lock_guard<std::mutex> lock(audio_queue_mutex_);
-    return audio_encode_queue_.empty() && audio_decode_queue_.empty() && audio_playback_queue_.empty() && audio_testing_queue_.empty();
+    return audio_encode_queue_.Empty() && audio_decode_queue_.Empty() && decode_overflow_store_.Empty() &&
+           audio_playback_queue_.Empty() && audio_testing_queue_.Empty() && !EffectLanePending();
 }
 
 void AudioService::ResetDecoder() {
-    std::lock_guard<std::mutex> lock(audio_queue_mutex_);
-    opus_decoder_->ResetState();
-    timestamp_queue_.clear();
-    audio_decode_queue_.clear();
-    audio_playback_queue_.clear();
-    audio_testing_queue_.clear();
-    audio_queue_cv_.notify_all();
+    /* Clears must run on the consumer side of each ring, so request them
+     * with atomic flags and wake the owning tasks. They run at a higher
+     * priority than the callers, so the flush is effectively immediate. */
+    decoder_reset_requested_ = true;
+    playback_drain_requested_ = true;
+    timestamp_drain_requested_ = true;
+    jitter_buffer_.Reset();
+    NotifyDecodeTask();
+    NotifyOutputTask();
 }
 
 void AudioService::CheckAndUpdateAudioPowerState() {
     auto now = std::chrono::steady_clock::now();
     auto input_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_input_time_).count();
     auto output_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_output_time_).count();
-    if (input_elapsed > AUDIO_POWER_TIMEOUT_MS && codec_->input_enabled()) {
+    if (input_elapsed > AUDIO_INPUT_POWER_TIMEOUT_MS && codec_->input_enabled()) {
         codec_->EnableInput(false);
     }
     if (output_elapsed > AUDIO_POWER_TIMEOUT_MS && codec_->output_enabled()) {
@@ -653,9 +1583,14 @@ void AudioService::SetModelsList(srmodel_list_t* models_list) {
     models_list_ = models_list;
 
 #if CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32P4
-    if (esp_srmodel_filter(models_list_, ESP_MN_PREFIX, NULL) != nullptr) {
+    bool has_multinet = esp_srmodel_filter(models_list_, ESP_MN_PREFIX, NULL) != nullptr;
+    bool has_wakenet = esp_srmodel_filter(models_list_, ESP_WN_PREFIX, NULL) != nullptr;
+    if (has_multinet && has_wakenet) {
+        /* Brand wake word and custom keywords off one shared AFE frontend */
+        wake_word_ = std::make_unique<CombinedWakeWord>();
+    } else if (has_multinet) {
         wake_word_ = std::make_unique<CustomWakeWord>();
-    } else if (esp_srmodel_filter(models_list_, ESP_WN_PREFIX, NULL) != nullptr) {
+    } else if (has_wakenet) {
         wake_word_ = std::make_unique<AfeWakeWord>();
     } else {
         wake_word_ = nullptr;
@@ -677,6 +1612,25 @@ void AudioService::SetModelsList(srmodel_list_t* models_list) {
     }
 }
 
+bool AudioService::SwapModelsList(srmodel_list_t* models_list) {
+    bool was_running = (xEventGroupGetBits(event_group_) & AS_EVENT_WAKE_WORD_RUNNING) != 0;
+    if (was_running) {
+        EnableWakeWordDetection(false);
+    }
+    if (wake_word_initialized_) {
+        /* 输入任务可能正处在一次 Feed 里，等两个帧周期让在途调用归位，
+         * 再销毁旧引擎（析构会阻塞等检测任务退出并释放 AFE） */
+        vTaskDelay(pdMS_TO_TICKS(OPUS_FRAME_DURATION_MS * 2));
+        wake_word_.reset();
+        wake_word_initialized_ = false;
+    }
+    SetModelsList(models_list);
+    if (was_running && wake_word_ != nullptr) {
+        EnableWakeWordDetection(true);
+    }
+    return wake_word_ != nullptr;
+}
+
 bool AudioService::IsAfeWakeWord() {
 #if CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32P4
     return wake_word_ != nullptr && dynamic_cast<AfeWakeWord*>(wake_word_.get()) != nullptr;
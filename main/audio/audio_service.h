@@ -2,14 +2,17 @@
 #define AUDIO_SERVICE_H
 
 #include <memory>
-#include <deque>
-#include <condition_variable>
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <mutex>
 
+#include "delegate.h"
+
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/event_groups.h>
+#include <freertos/semphr.h>
 #include <esp_timer.h>
 #include <model_path.h>
 
@@ -19,6 +22,13 @@
 
 #include "audio_codec.h"
 #include "audio_processor.h"
+#include "static_task.h"
+#include "fir_resampler.h"
+#include "jitter_buffer.h"
+#include "pcm_buffer_pool.h"
+#include "psram_packet_store.h"
+#include "sound_cache.h"
+#include "spsc_ring.h"
 #include "processors/audio_debugger.h"
 #include "wake_word.h"
 #include "protocol.h"
@@ -35,28 +45,71 @@
  * 
  */
 
+/* Uplink frame duration, selected via menuconfig. The downlink duration is
+ * negotiated in the protocol hello and applied at runtime through
+ * SetDecodeSampleRate(). Queue depths below scale with the frame duration. */
+#if CONFIG_OPUS_FRAME_DURATION_20MS
+#define OPUS_FRAME_DURATION_MS 20
+#elif CONFIG_OPUS_FRAME_DURATION_40MS
+#define OPUS_FRAME_DURATION_MS 40
+#else
 #define OPUS_FRAME_DURATION_MS 60
+#endif
 #define MAX_ENCODE_TASKS_IN_QUEUE 2
 #define MAX_PLAYBACK_TASKS_IN_QUEUE 2
 #define MAX_DECODE_PACKETS_IN_QUEUE (2400 / OPUS_FRAME_DURATION_MS)
+/* PSRAM overflow behind the decode queue; the sum gives ~30 s of buffering */
+#define MAX_DECODE_PACKETS_BUFFERED (30000 / OPUS_FRAME_DURATION_MS)
 #define MAX_SEND_PACKETS_IN_QUEUE (2400 / OPUS_FRAME_DURATION_MS)
+/* 发送队列拥塞闭环：深度过 2/3 进入拥塞，回落到 1/4 并稳定一段时间后恢复 */
+#define SEND_CONGESTION_ENTER_DEPTH (MAX_SEND_PACKETS_IN_QUEUE * 2 / 3)
+#define SEND_CONGESTION_CLEAR_DEPTH (MAX_SEND_PACKETS_IN_QUEUE / 4)
+#define SEND_CONGESTION_CLEAR_FRAMES 50
 #define AUDIO_TESTING_MAX_DURATION_MS 10000
 #define MAX_TIMESTAMPS_IN_QUEUE 3
+/* Parked decoder states kept warm for sample-rate switches */
+#define MAX_POOLED_OPUS_DECODERS 2
 
 #define AUDIO_POWER_TIMEOUT_MS 15000
+/* 输入链路断电后重新使能要付 PLL 重锁 + 预热丢帧（见 input_warmup_ms），
+ * 所以短暂的空闲间隙里让 RX 继续跑，超时取输出的 3 倍 */
+#define AUDIO_INPUT_POWER_TIMEOUT_MS (3 * AUDIO_POWER_TIMEOUT_MS)
 #define AUDIO_POWER_CHECK_INTERVAL_MS 1000
 
+/* VAD-gated encode: after this many consecutive non-speech frames the
+ * uplink drops to sparse keepalive frames until speech resumes. The
+ * hangover keeps trailing syllables; the keepalives let the server keep
+ * its comfort-noise and timing state. */
+#define VAD_GATE_SILENCE_FRAMES (600 / OPUS_FRAME_DURATION_MS)
+#define VAD_GATE_KEEPALIVE_INTERVAL_FRAMES (400 / OPUS_FRAME_DURATION_MS)
+
+/* Adaptive Opus complexity: keep the EWMA encode time under this fraction of
+ * the frame budget, stepping complexity down fast and back up slowly */
+#define OPUS_COMPLEXITY_BUDGET_PERCENT 50
+#define OPUS_COMPLEXITY_RAISE_PERCENT 25
+#define OPUS_COMPLEXITY_ADJUST_INTERVAL_FRAMES 50
+#define OPUS_MAX_COMPLEXITY 5
+
 
 #define AS_EVENT_AUDIO_TESTING_RUNNING      (1 << 0)
 #define AS_EVENT_WAKE_WORD_RUNNING          (1 << 1)
 #define AS_EVENT_AUDIO_PROCESSOR_RUNNING    (1 << 2)
 #define AS_EVENT_PLAYBACK_NOT_EMPTY         (1 << 3)
 
+/* 一次性接好、终生不变的回调（见 Application::Start），用 Delegate
+ * 承载：调用只是一次函数指针跳转，不走 std::function 的类型擦除 */
 struct AudioServiceCallbacks {
-    std::function<void(void)> on_send_queue_available;
-    std::function<void(const std::string&)> on_wake_word_detected;
-    std::function<void(bool)> on_vad_change;
-    std::function<void(void)> on_audio_testing_queue_full;
+    Delegate<void()> on_send_queue_available;
+    /* 上行发送队列进入(true)/脱离(false)拥塞时从编码任务回调，
+     * 板级/应用可据此提示用户或与服务器协商降码率 */
+    Delegate<void(bool)> on_send_congestion;
+    Delegate<void(const std::string&)> on_wake_word_detected;
+    Delegate<void(bool)> on_vad_change;
+    Delegate<void()> on_audio_testing_queue_full;
+    /* Invoked from the audio output task after each frame is written to the
+     * codec, with the playout position of the current utterance in ms. Lets
+     * the UI pace animation off actual playback; must stay cheap. */
+    Delegate<void(uint32_t)> on_playback_position;
 };
 
 
@@ -70,6 +123,8 @@ struct AudioTask {
     AudioTaskType type;
     std::vector<int16_t> pcm;
     uint32_t timestamp;
+    // Local pipeline tracing stamp, updated as the task moves between stages
+    int64_t trace_time_us = 0;
 };
 
 struct DebugStatistics {
@@ -79,6 +134,56 @@ struct DebugStatistics {
     uint32_t playback_count = 0;
 };
 
+/* 单条队列的动态指标。每个字段只被该队列的生产/消费一侧写（与
+ * DebugStatistics 同一约定），别的任务读到的是尽力而为的快照，
+ * 不加锁。 */
+struct QueueStats {
+    uint32_t high_watermark = 0;   // 深度高水位
+    uint32_t blocked_count = 0;    // 生产侧遇满被迫等待/让步的次数
+    uint32_t dropped_reset = 0;    // 被 reset/drain 清掉的条数
+
+    void OnDepth(uint32_t depth) {
+        if (depth > high_watermark) {
+            high_watermark = depth;
+        }
+    }
+};
+
+/* 客服拿到"卡了一下"的报障时要看的那块数据：各队列高水位、堵塞、
+ * 分原因的丢包和带时间戳的播放欠载。 */
+struct QueueStatistics {
+    QueueStats encode;
+    QueueStats decode;
+    QueueStats send;
+    QueueStats playback;
+    uint32_t decode_dropped_late = 0;      // 晚于播出位置到达，播了会毛刺
+    uint32_t decode_dropped_overflow = 0;  // 暂存环和 PSRAM 溢出仓都满
+    uint32_t decode_spilled = 0;           // 转入 PSRAM 溢出仓的包数
+    uint32_t underrun_count = 0;
+    int64_t last_underrun_us = 0;
+};
+
+/* Log2-bucketed latency histogram: bucket i covers [2^i, 2^(i+1)) us, so the
+ * whole pipeline fits in 20 buckets (~0.5 s). Each histogram is written from
+ * a single pipeline task; reads from other tasks are best-effort snapshots,
+ * same as DebugStatistics. */
+struct LatencyHistogram {
+    static constexpr int kNumBuckets = 20;
+    uint32_t buckets[kNumBuckets] = {0};
+    uint32_t count = 0;
+
+    void Record(int64_t us);
+    uint32_t PercentileUs(int percent) const;
+};
+
+struct LatencyStatistics {
+    LatencyHistogram capture_to_encode;  // mic read -> encoder pops the frame
+    LatencyHistogram encode;             // Opus encode duration
+    LatencyHistogram receive_to_decode;  // network receive -> decoder pops the packet
+    LatencyHistogram decode;             // Opus decode duration
+    LatencyHistogram decode_to_playback; // decoded -> written to the speaker
+};
+
 class AudioService {
 public:
     AudioService();
@@ -98,6 +203,12 @@ public:
 
     void EnableWakeWordDetection(bool enable);
     void EnableVoiceProcessing(bool enable);
+#if CONFIG_USE_LP_WAKE_PRESCREEN
+    /* 两级唤醒：允许后，设备空闲一段时间就把常开监听降级成 LP VAD
+     * 预筛（HP 麦克风链路断电），预筛触发再回到唤醒词引擎确认。
+     * Application 在进入/离开空闲态时切换 */
+    void EnableLpPrescreen(bool allowed);
+#endif
     void EnableAudioTesting(bool enable);
     void EnableDeviceAec(bool enable);
 
@@ -106,9 +217,40 @@ public:
     bool PushPacketToDecodeQueue(std::unique_ptr<AudioStreamPacket> packet, bool wait = false);
     std::unique_ptr<AudioStreamPacket> PopPacketFromSendQueue();
     void PlaySound(const std::string_view& sound);
+    // 碎片化缓解：清掉已解码提示音缓存，返回释放的字节数。与
+    // PlaySound 同任务（主循环）调用，缓存本身无锁
+    size_t DropSoundCache() { return sound_cache_.Clear(); }
+    // 启动空闲时预解码热提示音，首次告警不再在交互路径上解码。
+    // 与 PlaySound 同任务（主循环）调用
+    void WarmSoundCache(const std::string_view& sound);
     bool ReadAudioData(std::vector<int16_t>& data, int sample_rate, int samples);
     void ResetDecoder();
     void SetModelsList(srmodel_list_t* models_list);
+    // 唤醒词模型热切换：退住检测、释放旧引擎后用新列表重建，音频处理器
+    // 和协议会话不受影响。旧模型列表由调用方在本函数返回后释放
+    bool SwapModelsList(srmodel_list_t* models_list);
+    const LatencyStatistics& GetLatencyStatistics() const { return latency_statistics_; }
+    void DumpLatencyStatistics();
+    const QueueStatistics& GetQueueStatistics() const { return queue_statistics_; }
+    std::string GetQueueStatisticsJson() const;
+    void DumpQueueStatistics();
+    // 板级链路质量采样（主循环）报告射频劣化，拥塞闭环提前收紧入门阈值
+    void SetRadioDegraded(bool degraded);
+    // 结温降载（ThermalMonitor）：限制自适应复杂度的上限，-1 解除
+    void SetThermalComplexityCap(int cap) { thermal_complexity_cap_.store(cap, std::memory_order_relaxed); }
+    // 机群调参（KnobRegistry "enc_cmplx_cap"）：与结温上限取较小者
+    void SetFleetComplexityCap(int cap) { fleet_complexity_cap_.store(cap, std::memory_order_relaxed); }
+
+    /* 回环自检：扬声器放一段啁啾 + 1kHz 纯音，麦克风录回来，互相关求
+     * 端到端时延，纯音段求回环增益和 THD。只在空闲态运行（MCP 工具
+     * self.run_audio_loopback_test），用于远程判断喇叭/麦克风是否劣化 */
+    struct LoopbackTestResult {
+        bool valid = false;
+        int latency_ms = 0;
+        float gain_db = 0.0f;
+        float thd_percent = 0.0f;
+    };
+    LoopbackTestResult RunLoopbackTest();
 
 private:
     AudioCodec* codec_ = nullptr;
@@ -118,10 +260,36 @@ private:
     std::unique_ptr<AudioDebugger> audio_debugger_;
     std::unique_ptr<OpusEncoderWrapper> opus_encoder_;
     std::unique_ptr<OpusDecoderWrapper> opus_decoder_;
-    OpusResampler input_resampler_;
-    OpusResampler reference_resampler_;
-    OpusResampler output_resampler_;
+    /* Warm decoder states parked on sample-rate switches, keyed by their own
+     * (sample_rate, duration_ms); only touched on the decode task */
+    std::deque<std::unique_ptr<OpusDecoderWrapper>> decoder_pool_;
+    FirResampler input_resampler_;
+    FirResampler reference_resampler_;
+    FirResampler output_resampler_;
+    PcmBufferPool pcm_buffer_pool_;
+    JitterBuffer jitter_buffer_;
+    /* Decoded UI sounds in PSRAM; only touched from the PlaySound caller */
+    SoundCache sound_cache_;
+    /* 叠加混音通道：提示音/earcon 的 PCM（已是输出采样率）排在这里，
+     * 输出任务逐帧与 TTS 做饱和混音叠播，而不是排在语音后面；没有
+     * TTS 在流动时叠加通道独立成帧播出 */
+    std::mutex effect_lane_mutex_;
+    std::vector<int16_t> effect_lane_pcm_;
+    size_t effect_lane_pos_ = 0;
+    // Persistent scratch buffers for the mic/reference deinterleave + resample
+    // path; capacity is reused so the AEC input path stays allocation-free
+    std::vector<int16_t> mic_scratch_;
+    std::vector<int16_t> reference_scratch_;
+    std::vector<int16_t> resampled_mic_scratch_;
+    std::vector<int16_t> resampled_reference_scratch_;
+    // 回环自检采集区：AudioInputTask 在测试事件位 + active 标志下把原始
+    // 16kHz 单声道 PCM 顺序写进来，写满自动停
+    std::vector<int16_t> loopback_capture_;
+    std::atomic<size_t> loopback_capture_pos_{0};
+    std::atomic<bool> loopback_capture_active_{false};
     DebugStatistics debug_statistics_;
+    LatencyStatistics latency_statistics_;
+    QueueStatistics queue_statistics_;
     srmodel_list_t* models_list_ = nullptr;
 
     EventGroupHandle_t event_group_;
@@ -129,31 +297,97 @@ private:
     // Audio encode / decode
     TaskHandle_t audio_input_task_handle_ = nullptr;
     TaskHandle_t audio_output_task_handle_ = nullptr;
-    TaskHandle_t opus_codec_task_handle_ = nullptr;
-    std::mutex audio_queue_mutex_;
-    std::condition_variable audio_queue_cv_;
-    std::deque<std::unique_ptr<AudioStreamPacket>> audio_decode_queue_;
-    std::deque<std::unique_ptr<AudioStreamPacket>> audio_send_queue_;
-    std::deque<std::unique_ptr<AudioStreamPacket>> audio_testing_queue_;
-    std::deque<std::unique_ptr<AudioTask>> audio_encode_queue_;
-    std::deque<std::unique_ptr<AudioTask>> audio_playback_queue_;
+    TaskHandle_t opus_encode_task_handle_ = nullptr;
+    TaskHandle_t opus_decode_task_handle_ = nullptr;
+    // 任务栈放 PSRAM（见 static_task.h），内部 RAM 留给 DMA 缓冲
+    StaticTaskBuffer audio_input_task_buffer_;
+    StaticTaskBuffer audio_output_task_buffer_;
+    StaticTaskBuffer opus_encode_task_buffer_;
+    StaticTaskBuffer opus_decode_task_buffer_;
+    /*
+     * Lock-free SPSC rings, one per producer/consumer pair. Wakeups use task
+     * notifications instead of a shared condition variable, so the input,
+     * output and codec tasks no longer contend on one mutex every frame.
+     * Cross-task clears (decoder reset, playback flush) are requested with
+     * atomic flags and performed on the consumer side of each ring.
+     */
+    SpscRing<std::unique_ptr<AudioStreamPacket>, MAX_DECODE_PACKETS_IN_QUEUE> audio_decode_queue_;
+    /* Overflow behind audio_decode_queue_: once it spills, new packets keep
+     * going to the store until it drains, so playout order is preserved */
+    PsramPacketStore<MAX_DECODE_PACKETS_BUFFERED> decode_overflow_store_;
+    SpscRing<std::unique_ptr<AudioStreamPacket>, MAX_SEND_PACKETS_IN_QUEUE> audio_send_queue_;
+    SpscRing<std::unique_ptr<AudioStreamPacket>, AUDIO_TESTING_MAX_DURATION_MS / OPUS_FRAME_DURATION_MS> audio_testing_queue_;
+    SpscRing<std::unique_ptr<AudioTask>, MAX_ENCODE_TASKS_IN_QUEUE> audio_encode_queue_;
+    SpscRing<std::unique_ptr<AudioTask>, MAX_PLAYBACK_TASKS_IN_QUEUE> audio_playback_queue_;
     // For server AEC
-    std::deque<uint32_t> timestamp_queue_;
+    SpscRing<uint32_t, MAX_TIMESTAMPS_IN_QUEUE> timestamp_queue_;
+    SemaphoreHandle_t encode_queue_space_ = nullptr;
+    SemaphoreHandle_t decode_queue_space_ = nullptr;
+    // Encode-time feedback for adaptive Opus complexity
+    int64_t encode_time_ewma_us_ = 0;
+    int current_complexity_ = 0;
+    int frames_since_complexity_adjust_ = 0;
+    // 发送队列拥塞状态，只在编码任务上更新
+    bool send_congested_ = false;
+    int congestion_clear_frames_ = 0;
+    int complexity_before_congestion_ = 0;
+    // 射频劣化提示：主循环写、编码任务读
+    std::atomic<bool> radio_degraded_{false};
+    // 结温复杂度上限：ThermalMonitor 写、编码任务读；-1 表示不限
+    std::atomic<int> thermal_complexity_cap_{-1};
+    // 机群下发的复杂度上限：注册表写、编码任务读；-1 表示不限
+    std::atomic<int> fleet_complexity_cap_{-1};
+
+    std::atomic<bool> decoder_reset_requested_{false};
+    std::atomic<bool> playback_drain_requested_{false};
+    std::atomic<bool> timestamp_drain_requested_{false};
 
     bool wake_word_initialized_ = false;
     bool audio_processor_initialized_ = false;
     bool voice_detected_ = false;
-    bool service_stopped_ = true;
+    /* VAD gate state, only touched on the processor output path. The gate
+     * stays open until the VAD has reported at least once, so builds whose
+     * processor runs without VAD (device AEC) are never gated. */
+    bool vad_state_seen_ = false;
+    int vad_silence_frames_ = 0;
+    int vad_gated_frames_ = 0;
+    std::atomic<bool> service_stopped_{true};
     bool audio_input_need_warmup_ = false;
 
     esp_timer_handle_t audio_power_timer_ = nullptr;
     std::chrono::steady_clock::time_point last_input_time_;
     std::chrono::steady_clock::time_point last_output_time_;
+    /* Playout position of the current utterance, only touched on the output
+     * task; resets after a playback gap or drain */
+    uint32_t playback_position_ms_ = 0;
+    /* 开播淡入进度，只在输出任务上使用；输出使能或播放间隙后重置 */
+    size_t fade_in_total_ = 0;
+    size_t fade_in_remaining_ = 0;
+
+#if CONFIG_USE_LP_WAKE_PRESCREEN
+    TaskHandle_t lp_prescreen_task_handle_ = nullptr;
+    std::atomic<bool> lp_prescreen_allowed_{false};
+    void LpPrescreenTask();
+#endif
 
     void AudioInputTask();
     void AudioOutputTask();
-    void OpusCodecTask();
+    void OpusEncodeTask();
+    void OpusDecodeTask();
+    void AdjustEncoderComplexity(int64_t encode_time_us);
+    void UpdateSendCongestion(size_t depth);
+    void NotifyEncodeTask();
+    void NotifyDecodeTask();
+    void NotifyOutputTask();
     void PushTaskToEncodeQueue(AudioTaskType type, std::vector<int16_t>&& pcm);
+    static void ParseOggOpus(const std::string_view& ogg, int& sample_rate, std::vector<std::vector<uint8_t>>& packets);
+    bool DecodeSoundToCache(const std::string_view& ogg);
+    void PlaySoundThroughDecoder(const std::string_view& ogg);
+    void QueueEffectPcm(const int16_t* pcm, size_t samples);
+    bool EffectLanePending();
+    void MixEffectLane(std::vector<int16_t>& pcm);
+    void StartFadeIn();
+    void ApplyFadeIn(std::vector<int16_t>& pcm);
     void SetDecodeSampleRate(int sample_rate, int frame_duration);
     void CheckAndUpdateAudioPowerState();
 };
@@ -224,7 +224,10 @@ void BoxAudioCodec::EnableOutput(bool enable) {
         };
         ESP_ERROR_CHECK(esp_codec_dev_open(output_dev_, &fs));
         ESP_ERROR_CHECK(esp_codec_dev_set_out_vol(output_dev_, output_volume_));
+        esp_codec_dev_set_out_mute(output_dev_, false);
     } else {
+        // 关断前先软静音，DAC 内部把输出斜坡到零，避免关闭瞬间的爆音
+        esp_codec_dev_set_out_mute(output_dev_, true);
         ESP_ERROR_CHECK(esp_codec_dev_close(output_dev_));
     }
     AudioCodec::EnableOutput(enable);
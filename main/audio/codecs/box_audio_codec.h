@@ -8,7 +8,7 @@
 #include <mutex>
 
 
-class BoxAudioCodec : public AudioCodec {
+class BoxAudioCodec final : public AudioCodec {
 private:
     const audio_codec_data_if_t* data_if_ = nullptr;
     const audio_codec_ctrl_if_t* out_ctrl_if_ = nullptr;
@@ -154,6 +154,11 @@ void Es8311AudioCodec::CreateDuplexChannels(gpio_num_t mclk, gpio_num_t bclk, gp
 }
 
 void Es8311AudioCodec::SetOutputVolume(int volume) {
+    /* The volume register is applied on open with output_volume_, so a
+     * repeated value would be a redundant blocking I2C transaction */
+    if (volume == output_volume_) {
+        return;
+    }
     ESP_ERROR_CHECK(esp_codec_dev_set_out_vol(dev_, volume));
     AudioCodec::SetOutputVolume(volume);
 }
@@ -178,8 +183,15 @@ void Es8311AudioCodec::EnableOutput(bool enable) {
     if (enable == output_enabled_) {
         return;
     }
+    if (!enable && dev_ != nullptr) {
+        // 关断前先软静音，DAC 内部把输出斜坡到零，避免关闭瞬间的爆音
+        esp_codec_dev_set_out_mute(dev_, true);
+    }
     AudioCodec::EnableOutput(enable);
     UpdateDeviceState();
+    if (enable && dev_ != nullptr) {
+        esp_codec_dev_set_out_mute(dev_, false);
+    }
 }
 
 int Es8311AudioCodec::Read(int16_t* dest, int samples) {
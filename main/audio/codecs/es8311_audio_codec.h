@@ -10,7 +10,7 @@
 #include <mutex>
 
 
-class Es8311AudioCodec : public AudioCodec {
+class Es8311AudioCodec final : public AudioCodec {
 private:
     const audio_codec_data_if_t* data_if_ = nullptr;
     const audio_codec_ctrl_if_t* ctrl_if_ = nullptr;
@@ -37,6 +37,8 @@ public:
     virtual void SetOutputVolume(int volume) override;
     virtual void EnableInput(bool enable) override;
     virtual void EnableOutput(bool enable) override;
+    // ES8311 的 PLL 锁定很快，启用延迟由 ADC 软斜坡主导
+    virtual int input_warmup_ms() const override { return 50; }
 };
 
 #endif // _ES8311_AUDIO_CODEC_H
\ No newline at end of file
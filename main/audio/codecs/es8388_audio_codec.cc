@@ -135,6 +135,11 @@ void Es8388AudioCodec::CreateDuplexChannels(gpio_num_t mclk, gpio_num_t bclk, gp
 }
 
 void Es8388AudioCodec::SetOutputVolume(int volume) {
+    /* The volume register is applied on open with output_volume_, so a
+     * repeated value would be a redundant blocking I2C transaction */
+    if (volume == output_volume_) {
+        return;
+    }
     ESP_ERROR_CHECK(esp_codec_dev_set_out_vol(output_dev_, volume));
     AudioCodec::SetOutputVolume(volume);
 }
@@ -9,7 +9,7 @@
 #include <mutex>
 
 
-class Es8388AudioCodec : public AudioCodec {
+class Es8388AudioCodec final : public AudioCodec {
 private:
     const audio_codec_data_if_t* data_if_ = nullptr;
     const audio_codec_ctrl_if_t* ctrl_if_ = nullptr;
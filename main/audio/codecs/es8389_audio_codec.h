@@ -9,7 +9,7 @@
 #include <esp_codec_dev_defaults.h>
 #include <mutex>
 
-class Es8389AudioCodec : public AudioCodec {
+class Es8389AudioCodec final : public AudioCodec {
 private:
     const audio_codec_data_if_t* data_if_ = nullptr;
     const audio_codec_ctrl_if_t* ctrl_if_ = nullptr;
@@ -75,11 +75,30 @@ NoAudioCodecDuplex::NoAudioCodecDuplex(int input_sample_rate, int output_sample_
 }
 
 
-NoAudioCodecSimplex::NoAudioCodecSimplex(int input_sample_rate, int output_sample_rate, gpio_num_t spk_bclk, gpio_num_t spk_ws, gpio_num_t spk_dout, gpio_num_t mic_sck, gpio_num_t mic_ws, gpio_num_t mic_din) {
+// Delegating constructor: calls the main constructor with default slot masks
+NoAudioCodecSimplex::NoAudioCodecSimplex(int input_sample_rate, int output_sample_rate, gpio_num_t spk_bclk, gpio_num_t spk_ws, gpio_num_t spk_dout, gpio_num_t mic_sck, gpio_num_t mic_ws, gpio_num_t mic_din)
+    : NoAudioCodecSimplex(input_sample_rate, output_sample_rate, spk_bclk, spk_ws, spk_dout, I2S_STD_SLOT_LEFT, mic_sck, mic_ws, mic_din, I2S_STD_SLOT_LEFT) {
+    // All initialization is handled by the delegated constructor
+}
+
+NoAudioCodecSimplex::NoAudioCodecSimplex(int input_sample_rate, int output_sample_rate, gpio_num_t spk_bclk, gpio_num_t spk_ws, gpio_num_t spk_dout, i2s_std_slot_mask_t spk_slot_mask, gpio_num_t mic_sck, gpio_num_t mic_ws, gpio_num_t mic_din, i2s_std_slot_mask_t mic_slot_mask){
     duplex_ = false;
     input_sample_rate_ = input_sample_rate;
     output_sample_rate_ = output_sample_rate;
 
+    // 板上 MIC 与功放共用 BCLK/WS 且采样率一致时，走单控制器全双工：
+    // 收发在同一时钟域内样本级对齐（设备端 AEC 需要），并空出一个 I2S
+    // 外设。C3 只有一个 I2S，这也是两条通路唯一能同时工作的方式
+    if (mic_sck == spk_bclk && mic_ws == spk_ws && input_sample_rate_ == output_sample_rate_) {
+        CreateSharedClockDuplexChannels(spk_bclk, spk_ws, spk_dout, spk_slot_mask, mic_din, mic_slot_mask);
+        return;
+    }
+#if SOC_I2S_NUM < 2
+    // 单 I2S 芯片上引脚没接到同一时钟域就没有第二个控制器可用
+    ESP_LOGE(TAG, "Simplex needs 2 I2S controllers, wire mic to the speaker BCLK/WS for duplex");
+    abort();
+#else
+
     // Create a new channel for speaker
     i2s_chan_config_t chan_cfg = {
         .id = (i2s_port_t)0,
@@ -106,7 +125,7 @@ NoAudioCodecSimplex::NoAudioCodecSimplex(int input_sample_rate, int output_sampl
             .data_bit_width = I2S_DATA_BIT_WIDTH_32BIT,
             .slot_bit_width = I2S_SLOT_BIT_WIDTH_AUTO,
             .slot_mode = I2S_SLOT_MODE_MONO,
-            .slot_mask = I2S_STD_SLOT_LEFT,
+            .slot_mask = spk_slot_mask,
             .ws_width = I2S_DATA_BIT_WIDTH_32BIT,
             .ws_pol = false,
             .bit_shift = true,
@@ -136,22 +155,21 @@ NoAudioCodecSimplex::NoAudioCodecSimplex(int input_sample_rate, int output_sampl
     chan_cfg.id = (i2s_port_t)1;
     ESP_ERROR_CHECK(i2s_new_channel(&chan_cfg, nullptr, &rx_handle_));
     std_cfg.clk_cfg.sample_rate_hz = (uint32_t)input_sample_rate_;
+    std_cfg.slot_cfg.slot_mask = mic_slot_mask;
     std_cfg.gpio_cfg.bclk = mic_sck;
     std_cfg.gpio_cfg.ws = mic_ws;
     std_cfg.gpio_cfg.dout = I2S_GPIO_UNUSED;
     std_cfg.gpio_cfg.din = mic_din;
     ESP_ERROR_CHECK(i2s_channel_init_std_mode(rx_handle_, &std_cfg));
     ESP_LOGI(TAG, "Simplex channels created");
+#endif // SOC_I2S_NUM
 }
 
-NoAudioCodecSimplex::NoAudioCodecSimplex(int input_sample_rate, int output_sample_rate, gpio_num_t spk_bclk, gpio_num_t spk_ws, gpio_num_t spk_dout, i2s_std_slot_mask_t spk_slot_mask, gpio_num_t mic_sck, gpio_num_t mic_ws, gpio_num_t mic_din, i2s_std_slot_mask_t mic_slot_mask){
-    duplex_ = false;
-    input_sample_rate_ = input_sample_rate;
-    output_sample_rate_ = output_sample_rate;
+void NoAudioCodecSimplex::CreateSharedClockDuplexChannels(gpio_num_t bclk, gpio_num_t ws, gpio_num_t dout, i2s_std_slot_mask_t spk_slot_mask, gpio_num_t din, i2s_std_slot_mask_t mic_slot_mask) {
+    duplex_ = true;
 
-    // Create a new channel for speaker
     i2s_chan_config_t chan_cfg = {
-        .id = (i2s_port_t)0,
+        .id = I2S_NUM_0,
         .role = I2S_ROLE_MASTER,
         .dma_desc_num = AUDIO_CODEC_DMA_DESC_NUM,
         .dma_frame_num = AUDIO_CODEC_DMA_FRAME_NUM,
@@ -159,7 +177,9 @@ NoAudioCodecSimplex::NoAudioCodecSimplex(int input_sample_rate, int output_sampl
         .auto_clear_before_cb = false,
         .intr_priority = 0,
     };
-    ESP_ERROR_CHECK(i2s_new_channel(&chan_cfg, &tx_handle_, nullptr));
+    // 同一次 i2s_new_channel 申请收发两个通道，驱动保证二者共享
+    // 控制器的 BCLK/WS，DMA 同时启动
+    ESP_ERROR_CHECK(i2s_new_channel(&chan_cfg, &tx_handle_, &rx_handle_));
 
     i2s_std_config_t std_cfg = {
         .clk_cfg = {
@@ -188,10 +208,10 @@ NoAudioCodecSimplex::NoAudioCodecSimplex(int input_sample_rate, int output_sampl
         },
         .gpio_cfg = {
             .mclk = I2S_GPIO_UNUSED,
-            .bclk = spk_bclk,
-            .ws = spk_ws,
-            .dout = spk_dout,
-            .din = I2S_GPIO_UNUSED,
+            .bclk = bclk,
+            .ws = ws,
+            .dout = dout,
+            .din = din,
             .invert_flags = {
                 .mclk_inv = false,
                 .bclk_inv = false,
@@ -200,23 +220,16 @@ NoAudioCodecSimplex::NoAudioCodecSimplex(int input_sample_rate, int output_sampl
         }
     };
     ESP_ERROR_CHECK(i2s_channel_init_std_mode(tx_handle_, &std_cfg));
-
-    // Create a new channel for MIC
-    chan_cfg.id = (i2s_port_t)1;
-    ESP_ERROR_CHECK(i2s_new_channel(&chan_cfg, nullptr, &rx_handle_));
-    std_cfg.clk_cfg.sample_rate_hz = (uint32_t)input_sample_rate_;
     std_cfg.slot_cfg.slot_mask = mic_slot_mask;
-    std_cfg.gpio_cfg.bclk = mic_sck;
-    std_cfg.gpio_cfg.ws = mic_ws;
-    std_cfg.gpio_cfg.dout = I2S_GPIO_UNUSED;
-    std_cfg.gpio_cfg.din = mic_din;
     ESP_ERROR_CHECK(i2s_channel_init_std_mode(rx_handle_, &std_cfg));
-    ESP_LOGI(TAG, "Simplex channels created");
+    ESP_LOGI(TAG, "Shared-clock duplex channels created");
 }
 
-int NoAudioCodec::Write(const int16_t* data, int samples) {
+int AUDIO_IRAM_ATTR NoAudioCodec::Write(const int16_t* data, int samples) {
     std::lock_guard<std::mutex> lock(data_if_mutex_);
-    std::vector<int32_t> buffer(samples);
+    if (write_conv_buffer_.size() < (size_t)samples) {
+        write_conv_buffer_.resize(samples);
+    }
 
     // output_volume_: 0-100
     // volume_factor_: 0-65536
@@ -224,31 +237,33 @@ int NoAudioCodec::Write(const int16_t* data, int samples) {
     for (int i = 0; i < samples; i++) {
         int64_t temp = int64_t(data[i]) * volume_factor; // 使用 int64_t 进行乘法运算
         if (temp > INT32_MAX) {
-            buffer[i] = INT32_MAX;
+            write_conv_buffer_[i] = INT32_MAX;
         } else if (temp < INT32_MIN) {
-            buffer[i] = INT32_MIN;
+            write_conv_buffer_[i] = INT32_MIN;
         } else {
-            buffer[i] = static_cast<int32_t>(temp);
+            write_conv_buffer_[i] = static_cast<int32_t>(temp);
         }
     }
 
     size_t bytes_written;
-    ESP_ERROR_CHECK(i2s_channel_write(tx_handle_, buffer.data(), samples * sizeof(int32_t), &bytes_written, portMAX_DELAY));
+    ESP_ERROR_CHECK(i2s_channel_write(tx_handle_, write_conv_buffer_.data(), samples * sizeof(int32_t), &bytes_written, portMAX_DELAY));
     return bytes_written / sizeof(int32_t);
 }
 
-int NoAudioCodec::Read(int16_t* dest, int samples) {
+int AUDIO_IRAM_ATTR NoAudioCodec::Read(int16_t* dest, int samples) {
     size_t bytes_read;
 
-    std::vector<int32_t> bit32_buffer(samples);
-    if (i2s_channel_read(rx_handle_, bit32_buffer.data(), samples * sizeof(int32_t), &bytes_read, portMAX_DELAY) != ESP_OK) {
+    if (read_conv_buffer_.size() < (size_t)samples) {
+        read_conv_buffer_.resize(samples);
+    }
+    if (i2s_channel_read(rx_handle_, read_conv_buffer_.data(), samples * sizeof(int32_t), &bytes_read, portMAX_DELAY) != ESP_OK) {
         ESP_LOGE(TAG, "Read Failed!");
         return 0;
     }
 
     samples = bytes_read / sizeof(int32_t);
     for (int i = 0; i < samples; i++) {
-        int32_t value = bit32_buffer[i] >> 12;
+        int32_t value = read_conv_buffer_[i] >> 12;
         dest[i] = (value > INT16_MAX) ? INT16_MAX : (value < -INT16_MAX) ? -INT16_MAX : (int16_t)value;
     }
     return samples;
@@ -338,7 +353,7 @@ NoAudioCodecSimplexPdm::NoAudioCodecSimplexPdm(int input_sample_rate, int output
     ESP_LOGI(TAG, "Simplex channels created");
 }
 
-int NoAudioCodecSimplexPdm::Read(int16_t* dest, int samples) {
+int AUDIO_IRAM_ATTR NoAudioCodecSimplexPdm::Read(int16_t* dest, int samples) {
     size_t bytes_read;
 
     // PDM 解调后的数据位宽为 16 位，直接读取到目标缓冲区
@@ -6,10 +6,16 @@
 #include <driver/gpio.h>
 #include <driver/i2s_pdm.h>
 #include <mutex>
+#include <vector>
 
 class NoAudioCodec : public AudioCodec {
 protected:
     std::mutex data_if_mutex_;
+    // Persistent 32-bit conversion buffers, sized to one DMA block on first
+    // use and reused across calls so the per-frame read/write path does not
+    // allocate
+    std::vector<int32_t> read_conv_buffer_;
+    std::vector<int32_t> write_conv_buffer_;
 
     virtual int Write(const int16_t* data, int samples) override;
     virtual int Read(int16_t* dest, int samples) override;
@@ -18,18 +24,23 @@ public:
     virtual ~NoAudioCodec();
 };
 
-class NoAudioCodecDuplex : public NoAudioCodec {
+class NoAudioCodecDuplex final : public NoAudioCodec {
 public:
     NoAudioCodecDuplex(int input_sample_rate, int output_sample_rate, gpio_num_t bclk, gpio_num_t ws, gpio_num_t dout, gpio_num_t din);
 };
 
-class NoAudioCodecSimplex : public NoAudioCodec {
+class NoAudioCodecSimplex final : public NoAudioCodec {
+private:
+    // MIC 与功放共用 BCLK/WS 引脚且采样率一致时，用单控制器全双工替代
+    // 两个 simplex 通道：时钟域共享、收发样本级对齐，并省出一个 I2S 外设
+    void CreateSharedClockDuplexChannels(gpio_num_t bclk, gpio_num_t ws, gpio_num_t dout, i2s_std_slot_mask_t spk_slot_mask, gpio_num_t din, i2s_std_slot_mask_t mic_slot_mask);
+
 public:
     NoAudioCodecSimplex(int input_sample_rate, int output_sample_rate, gpio_num_t spk_bclk, gpio_num_t spk_ws, gpio_num_t spk_dout, gpio_num_t mic_sck, gpio_num_t mic_ws, gpio_num_t mic_din);
     NoAudioCodecSimplex(int input_sample_rate, int output_sample_rate, gpio_num_t spk_bclk, gpio_num_t spk_ws, gpio_num_t spk_dout, i2s_std_slot_mask_t spk_slot_mask, gpio_num_t mic_sck, gpio_num_t mic_ws, gpio_num_t mic_din, i2s_std_slot_mask_t mic_slot_mask);
 };
 
-class NoAudioCodecSimplexPdm : public NoAudioCodec {
+class NoAudioCodecSimplexPdm final : public NoAudioCodec {
 public:
     NoAudioCodecSimplexPdm(int input_sample_rate, int output_sample_rate, gpio_num_t spk_bclk, gpio_num_t spk_ws, gpio_num_t spk_dout, gpio_num_t mic_sck,  gpio_num_t mic_din);
     NoAudioCodecSimplexPdm(int input_sample_rate, int output_sample_rate, gpio_num_t spk_bclk, gpio_num_t spk_ws, gpio_num_t spk_dout, i2s_std_slot_mask_t spk_slot_mask, gpio_num_t mic_sck,  gpio_num_t mic_din);
@@ -0,0 +1,90 @@
+#include "fir_resampler.h"
+
+#if CONFIG_IDF_TARGET_ESP32S3
+#include "fir_taps.h"
+#endif
+
+#include <esp_log.h>
+#include <cmath>
+#include <cstring>
+
+#define TAG "FirResampler"
+
+void FirResampler::Configure(int input_sample_rate, int output_sample_rate) {
+    input_sample_rate_ = input_sample_rate;
+    output_sample_rate_ = output_sample_rate;
+
+#if CONFIG_IDF_TARGET_ESP32S3
+    use_simd_ = input_sample_rate > output_sample_rate &&
+                input_sample_rate % output_sample_rate == 0;
+    if (use_simd_) {
+        decimation_ = input_sample_rate / output_sample_rate;
+        int num_taps = kTapsPerPhase * decimation_;
+        /* Board rate pairs hit the constexpr tables (flash-resident, no
+         * design pass); unusual factors fall back to runtime design. */
+        const int16_t* taps = fir_taps::TapsFor(decimation_, &num_taps);
+        if (taps == nullptr) {
+            /* Cut off slightly below the new Nyquist to leave transition band */
+            DesignLowpass(num_taps, 0.45f / decimation_);
+            taps = coeffs_.data();
+        } else {
+            coeffs_.clear();
+            coeffs_.shrink_to_fit();
+        }
+        delay_.assign(num_taps, 0);
+        /* dsps_fird only reads the coefficients; the table may live in flash */
+        dsps_fird_init_s16(&fird_, const_cast<int16_t*>(taps), delay_.data(),
+                           num_taps, decimation_, 0, 15);
+        ESP_LOGI(TAG, "SIMD FIR decimator %d -> %d (decim %d, %d taps%s)",
+                 input_sample_rate, output_sample_rate, decimation_, num_taps,
+                 taps == coeffs_.data() ? "" : ", constexpr");
+        return;
+    }
+#endif
+    fallback_.Configure(input_sample_rate, output_sample_rate);
+}
+
+int FirResampler::GetOutputSamples(int input_samples) const {
+#if CONFIG_IDF_TARGET_ESP32S3
+    if (use_simd_) {
+        return input_samples / decimation_;
+    }
+#endif
+    return fallback_.GetOutputSamples(input_samples);
+}
+
+void FirResampler::Process(const int16_t* input, int samples, int16_t* output) {
+#if CONFIG_IDF_TARGET_ESP32S3
+    if (use_simd_) {
+        dsps_fird_s16(&fird_, input, output, samples / decimation_);
+        return;
+    }
+#endif
+    fallback_.Process(input, samples, output);
+}
+
+#if CONFIG_IDF_TARGET_ESP32S3
+void FirResampler::DesignLowpass(int num_taps, float cutoff) {
+    /* Hamming-windowed sinc, quantized to Q15 with unity DC gain */
+    std::vector<float> taps(num_taps);
+    float sum = 0.0f;
+    float center = (num_taps - 1) / 2.0f;
+    for (int i = 0; i < num_taps; i++) {
+        float x = i - center;
+        float sinc = (x == 0.0f) ? 2.0f * cutoff
+                                 : sinf(2.0f * (float)M_PI * cutoff * x) / ((float)M_PI * x);
+        float window = 0.54f - 0.46f * cosf(2.0f * (float)M_PI * i / (num_taps - 1));
+        taps[i] = sinc * window;
+        sum += taps[i];
+    }
+
+    coeffs_.resize(num_taps);
+    for (int i = 0; i < num_taps; i++) {
+        float normalized = taps[i] / sum;
+        int q15 = (int)lroundf(normalized * 32767.0f);
+        if (q15 > 32767) q15 = 32767;
+        if (q15 < -32768) q15 = -32768;
+        coeffs_[i] = (int16_t)q15;
+    }
+}
+#endif
@@ -0,0 +1,51 @@
+#ifndef FIR_RESAMPLER_H
+#define FIR_RESAMPLER_H
+
+#include <cstdint>
+#include <vector>
+
+#include <opus_resampler.h>
+
+#if CONFIG_IDF_TARGET_ESP32S3
+#include <dsps_fird.h>
+#endif
+
+/*
+ * Resampler facade with an ESP32-S3 SIMD fast path.
+ *
+ * Integer-factor downsampling (e.g. the 48k -> 16k mic path on boards whose
+ * codec runs at 48kHz) is handled by an esp-dsp fixed-point FIR decimator,
+ * which uses the Xtensa EE.* SIMD instructions on the S3. The FIR taps are a
+ * Hamming-windowed sinc designed at Configure() time and quantized to Q15.
+ * Everything else (fractional ratios, upsampling, other targets) falls back
+ * to the portable OpusResampler, so behaviour is unchanged off the fast path.
+ */
+class FirResampler {
+public:
+    void Configure(int input_sample_rate, int output_sample_rate);
+    int GetOutputSamples(int input_samples) const;
+    void Process(const int16_t* input, int samples, int16_t* output);
+
+    inline int input_sample_rate() const { return input_sample_rate_; }
+    inline int output_sample_rate() const { return output_sample_rate_; }
+
+private:
+    int input_sample_rate_ = 0;
+    int output_sample_rate_ = 0;
+
+#if CONFIG_IDF_TARGET_ESP32S3
+    static const int kTapsPerPhase = 16;
+
+    bool use_simd_ = false;
+    int decimation_ = 1;
+    fir_s16_t fird_;
+    std::vector<int16_t> coeffs_;
+    std::vector<int16_t> delay_;
+
+    void DesignLowpass(int num_taps, float cutoff);
+#endif
+
+    OpusResampler fallback_;
+};
+
+#endif // FIR_RESAMPLER_H
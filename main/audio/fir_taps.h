@@ -0,0 +1,94 @@
+#ifndef FIR_TAPS_H
+#define FIR_TAPS_H
+
+#include <array>
+#include <cstdint>
+
+/*
+ * 编译期生成的 FIR 抽取器抽头表。
+ *
+ * FirResampler 的低通设计只取决于抽取倍数（截止 0.45/decim，抽头数
+ * 16*decim），而板子实际用到的倍数是有限的枚举（48k->16k 为 3，
+ * 32k->16k 为 2）。把 Hamming 窗 sinc 的设计搬到 constexpr 里，Q15
+ * 表直接进 .rodata（flash 映射），Configure() 既不用跑三角函数也不用
+ * 堆分配。运行期 DesignLowpass 保留，覆盖表里没有的倍数。
+ *
+ * 表内容和 FirResampler::DesignLowpass 的设计一致（它用 float 算，
+ * 这里用 double，量化后允许 1 LSB 差异）；scripts/hostsim 的 taps
+ * 场景对比两者并校验直流增益。
+ */
+namespace fir_taps {
+
+inline constexpr int kTapsPerPhase = 16;
+
+// constexpr 可用的 sin：归约到 [-pi/2, pi/2] 后泰勒展开，double 精度
+// 下误差远小于 Q15 的量化步长
+constexpr double ConstexprSin(double x) {
+    constexpr double kPi = 3.14159265358979323846;
+    while (x > kPi) x -= 2.0 * kPi;
+    while (x < -kPi) x += 2.0 * kPi;
+    if (x > kPi / 2.0) x = kPi - x;
+    if (x < -kPi / 2.0) x = -kPi - x;
+    double x2 = x * x;
+    double term = x;
+    double sum = x;
+    for (int n = 1; n <= 7; n++) {
+        term *= -x2 / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double ConstexprCos(double x) {
+    return ConstexprSin(x + 3.14159265358979323846 / 2.0);
+}
+
+template <int Decimation>
+struct DecimatorTaps {
+    static constexpr int kNumTaps = kTapsPerPhase * Decimation;
+
+    static constexpr std::array<int16_t, kNumTaps> Make() {
+        constexpr double kPi = 3.14159265358979323846;
+        constexpr double cutoff = 0.45 / Decimation;
+        std::array<double, kNumTaps> taps{};
+        double sum = 0.0;
+        double center = (kNumTaps - 1) / 2.0;
+        for (int i = 0; i < kNumTaps; i++) {
+            double x = i - center;
+            double sinc = (x == 0.0) ? 2.0 * cutoff
+                                     : ConstexprSin(2.0 * kPi * cutoff * x) / (kPi * x);
+            double window = 0.54 - 0.46 * ConstexprCos(2.0 * kPi * i / (kNumTaps - 1));
+            taps[i] = sinc * window;
+            sum += taps[i];
+        }
+        std::array<int16_t, kNumTaps> q15{};
+        for (int i = 0; i < kNumTaps; i++) {
+            double normalized = taps[i] / sum * 32767.0;
+            int value = (int)(normalized >= 0.0 ? normalized + 0.5 : normalized - 0.5);
+            if (value > 32767) value = 32767;
+            if (value < -32768) value = -32768;
+            q15[i] = (int16_t)value;
+        }
+        return q15;
+    }
+
+    static constexpr std::array<int16_t, kNumTaps> taps = Make();
+};
+
+// 返回该抽取倍数的编译期表，没有则 nullptr（走运行期设计）
+inline const int16_t* TapsFor(int decimation, int* num_taps) {
+    switch (decimation) {
+        case 2:
+            *num_taps = DecimatorTaps<2>::kNumTaps;
+            return DecimatorTaps<2>::taps.data();
+        case 3:
+            *num_taps = DecimatorTaps<3>::kNumTaps;
+            return DecimatorTaps<3>::taps.data();
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace fir_taps
+
+#endif // FIR_TAPS_H
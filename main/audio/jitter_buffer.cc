@@ -0,0 +1,79 @@
+#include "jitter_buffer.h"
+
+#include <esp_log.h>
+
+#define TAG "JitterBuffer"
+
+void JitterBuffer::OnPacketArrived(int frame_duration_ms) {
+    auto now = std::chrono::steady_clock::now();
+    if (has_last_arrival_ && frame_duration_ms > 0) {
+        int interval_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_arrival_time_).count();
+        int deviation = interval_ms - frame_duration_ms;
+        if (deviation < 0) {
+            deviation = -deviation;
+        }
+        /* EWMA with 1/8 weight, the classic RFC 3550 jitter estimator */
+        jitter_ms_ += (deviation - jitter_ms_) / 8;
+
+        size_t target = kMinTargetDepth + jitter_ms_ / frame_duration_ms;
+        if (target > kMaxTargetDepth) {
+            target = kMaxTargetDepth;
+        }
+        /* Grow immediately, shrink one frame at a time */
+        size_t current = target_depth_.load();
+        if (target > current) {
+            target_depth_ = target;
+        } else if (target < current) {
+            target_depth_ = current - 1;
+        }
+    }
+    last_arrival_time_ = now;
+    has_last_arrival_ = true;
+}
+
+bool JitterBuffer::ShouldDecode(size_t queued_frames) {
+    if (playout_active_.load()) {
+        return true;
+    }
+    if (queued_frames >= target_depth_.load()) {
+        playout_active_ = true;
+        return true;
+    }
+    return false;
+}
+
+bool JitterBuffer::OnUnderrun() {
+    if (!playout_active_.exchange(false)) {
+        return false;
+    }
+    /* Ran dry mid-stream: pre-buffer one frame more next time */
+    size_t current = target_depth_.load();
+    if (current < kMaxTargetDepth) {
+        target_depth_ = current + 1;
+    }
+    ESP_LOGW(TAG, "Playout underrun, target depth now %u frames", (unsigned)target_depth_.load());
+    return true;
+}
+
+bool JitterBuffer::IsLate(uint32_t timestamp) const {
+    if (timestamp == 0) {
+        return false;
+    }
+    uint32_t last_played = last_played_timestamp_.load();
+    /* Signed wrap-around comparison */
+    return last_played != 0 && (int32_t)(timestamp - last_played) <= 0;
+}
+
+void JitterBuffer::OnPlayout(uint32_t timestamp) {
+    if (timestamp != 0) {
+        last_played_timestamp_ = timestamp;
+    }
+}
+
+void JitterBuffer::Reset() {
+    has_last_arrival_ = false;
+    jitter_ms_ = 0;
+    target_depth_ = kMinTargetDepth;
+    playout_active_ = false;
+    last_played_timestamp_ = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef JITTER_BUFFER_H
+#define JITTER_BUFFER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Adaptive jitter policy for the decode queue.
+ *
+ * The decode queue itself stays a plain SPSC ring; this class only decides
+ * when the decoder may start draining it. It tracks the inter-arrival jitter
+ * of incoming packets with an EWMA and converts it into a target pre-buffer
+ * depth (in frames). Playout starts once the queue holds the target depth,
+ * and an underrun while playout is active grows the target, so cellular
+ * links with 200-400ms jitter spikes settle at a deeper buffer while WiFi
+ * links keep the latency of a 1-2 frame buffer.
+ */
+class JitterBuffer {
+public:
+    // Called by the network producer for every queued packet.
+    void OnPacketArrived(int frame_duration_ms);
+
+    // Called by the decoder. Returns true when it may drain the queue:
+    // either playout is active, or enough frames are pre-buffered.
+    bool ShouldDecode(size_t queued_frames);
+
+    // Called by the decoder when the queue ran dry. Returns true when this
+    // was an underrun during active playout (the caller may conceal the gap).
+    bool OnUnderrun();
+
+    // Returns true if the packet arrived too late to be played in order.
+    // Timestamps are only populated in server-AEC mode; zero disables this.
+    bool IsLate(uint32_t timestamp) const;
+    void OnPlayout(uint32_t timestamp);
+
+    void Reset();
+
+    size_t target_depth() const { return target_depth_; }
+
+private:
+    static const size_t kMinTargetDepth = 1;
+    static const size_t kMaxTargetDepth = 8;
+
+    std::chrono::steady_clock::time_point last_arrival_time_;
+    bool has_last_arrival_ = false;
+    // EWMA of |inter-arrival - frame_duration| in milliseconds
+    int jitter_ms_ = 0;
+    std::atomic<size_t> target_depth_{kMinTargetDepth};
+    std::atomic<bool> playout_active_{false};
+    std::atomic<uint32_t> last_played_timestamp_{0};
+};
+
+#endif // JITTER_BUFFER_H
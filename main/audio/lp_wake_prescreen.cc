@@ -0,0 +1,124 @@
+#include "lp_wake_prescreen.h"
+
+#if CONFIG_USE_LP_WAKE_PRESCREEN
+
+#include <driver/lp_i2s_pdm.h>
+#include <esp_log.h>
+#include <esp_sleep.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define TAG "LpPrescreen"
+
+namespace {
+// 每次从 LP RX 内存搬运的块；LP I2S 的片上缓存共 4KB，16kHz 单声道
+// 合 ~128ms preroll
+constexpr size_t kChunkSamples = 512;
+// 撤防检查周期
+constexpr int kPollTimeoutMs = 100;
+// 首块到达后继续清空缓存的短超时；读空即认为 preroll 搬完
+constexpr int kDrainTimeoutMs = 20;
+}
+
+bool LpWakePrescreen::Initialize() {
+    lp_i2s_chan_config_t chan_cfg = {
+        .id = 0,
+        .role = I2S_ROLE_MASTER,
+        .threshold = kChunkSamples * sizeof(int16_t),
+    };
+    esp_err_t err = lp_i2s_new_channel(&chan_cfg, nullptr, &rx_chan_);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "lp_i2s_new_channel failed: %s", esp_err_to_name(err));
+        rx_chan_ = nullptr;
+        return false;
+    }
+
+    lp_i2s_pdm_rx_config_t pdm_cfg = {
+        .pdm_cfg = LP_I2S_PDM_RX_CFG_DEFAULT(16000),
+        .pin_cfg = {
+            .clk = (gpio_num_t)CONFIG_LP_WAKE_PRESCREEN_CLK_GPIO,
+            .din = (gpio_num_t)CONFIG_LP_WAKE_PRESCREEN_DIN_GPIO,
+        },
+    };
+    err = lp_i2s_channel_init_pdm_rx_mode(rx_chan_, &pdm_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "PDM RX init failed: %s", esp_err_to_name(err));
+        lp_i2s_del_channel(rx_chan_);
+        rx_chan_ = nullptr;
+        return false;
+    }
+
+    // 能量门限用驱动默认值起步；init_frame_num 决定本底噪声自适应的
+    // 收敛窗口，speak 连击数压低误唤醒
+    lp_vad_init_config_t vad_cfg = {
+        .lp_i2s_chan = rx_chan_,
+        .vad_config = {
+            .init_frame_num = 100,
+            .min_energy_thresh = 100,
+            .speak_activity_thresh = 10,
+            .non_speak_activity_thresh = 30,
+        },
+    };
+    err = lp_i2s_vad_new_unit(LP_VAD_0, &vad_cfg, &vad_unit_);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "VAD unit creation failed: %s", esp_err_to_name(err));
+        lp_i2s_del_channel(rx_chan_);
+        rx_chan_ = nullptr;
+        return false;
+    }
+
+    ESP_LOGI(TAG, "LP I2S wake prescreen ready (clk=%d, din=%d)",
+             CONFIG_LP_WAKE_PRESCREEN_CLK_GPIO, CONFIG_LP_WAKE_PRESCREEN_DIN_GPIO);
+    return true;
+}
+
+void LpWakePrescreen::Arm() {
+    if (!available() || armed_.exchange(true)) {
+        return;
+    }
+    ESP_ERROR_CHECK(lp_i2s_channel_enable(rx_chan_));
+    ESP_ERROR_CHECK(lp_i2s_vad_enable(vad_unit_));
+    // 自动浅睡期间由 VAD 触发唤醒，HP 核睡满空闲窗口
+    esp_sleep_enable_vad_wakeup();
+    ESP_LOGI(TAG, "Armed, HP mic path may power down");
+}
+
+void LpWakePrescreen::Disarm() {
+    if (!available() || !armed_.exchange(false)) {
+        return;
+    }
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_VAD);
+    lp_i2s_vad_disable(vad_unit_);
+    lp_i2s_channel_disable(rx_chan_);
+}
+
+bool LpWakePrescreen::WaitVoice(std::vector<int16_t>& preroll) {
+    int16_t chunk[kChunkSamples];
+    lp_i2s_trans_t trans = {
+        .buffer = chunk,
+        .buflen = sizeof(chunk),
+    };
+
+    // VAD 放行前 RX 不产数据，这里的阻塞读就是"等语音"；带超时轮询
+    // 只为能看见撤防
+    while (armed_.load(std::memory_order_acquire)) {
+        trans.received_size = 0;
+        esp_err_t err = lp_i2s_channel_read(rx_chan_, &trans, kPollTimeoutMs);
+        if (err != ESP_OK || trans.received_size == 0) {
+            continue;
+        }
+        // 首块到了：把 VAD 判决点之前攒在 LP RX 内存里的 preroll 一并
+        // 清空，唤醒词引擎才能看到触发它的那段音频
+        do {
+            const int16_t* samples = (const int16_t*)trans.buffer;
+            preroll.insert(preroll.end(), samples, samples + trans.received_size / sizeof(int16_t));
+            trans.received_size = 0;
+            err = lp_i2s_channel_read(rx_chan_, &trans, kDrainTimeoutMs);
+        } while (err == ESP_OK && trans.received_size > 0 && preroll.size() < 16000);
+        return true;
+    }
+    return false;
+}
+
+#endif // CONFIG_USE_LP_WAKE_PRESCREEN
@@ -0,0 +1,57 @@
+#ifndef LP_WAKE_PRESCREEN_H
+#define LP_WAKE_PRESCREEN_H
+
+#include <sdkconfig.h>
+
+#if CONFIG_USE_LP_WAKE_PRESCREEN
+
+#include <atomic>
+#include <vector>
+
+#include <driver/lp_i2s.h>
+#include <driver/lp_i2s_vad.h>
+
+/*
+ * 两级唤醒的第一级：ESP32-P4 的 LP I2S + 硬件 VAD。布防后 HP 侧的
+ * 麦克风链路整个断电，LP 域以 ~2mA 监听；VAD 判到疑似人声才放行
+ * RX 存储并唤醒 HP 核，HP 侧再用真正的唤醒词引擎在缓存的 preroll
+ * 上确认（见 AudioService::LpPrescreenTask）。
+ *
+ * 这是个薄驱动封装，不做任何策略：Arm/Disarm 控制 VAD 与唤醒源，
+ * WaitVoice 阻塞到第一段语音数据到达并把 LP RX 内存里攒下的
+ * preroll 搬出来。要求板子把麦克风（PDM）接在 LP GPIO 上，引脚
+ * 走 menuconfig（LP_WAKE_PRESCREEN_*_GPIO）。
+ */
+class LpWakePrescreen {
+public:
+    static LpWakePrescreen& GetInstance() {
+        static LpWakePrescreen instance;
+        return instance;
+    }
+
+    // 建 LP I2S RX 通道和 VAD 单元，失败返回 false（之后 available()
+    // 为假，上层直接退回 HP 常开监听）
+    bool Initialize();
+    bool available() const { return rx_chan_ != nullptr; }
+
+    // 布防：使能 VAD 门控的采集并登记浅睡唤醒源。调用后 HP 侧可以
+    // 关掉编解码器输入
+    void Arm();
+    // 撤防；会让正在 WaitVoice 里阻塞的任务返回 false
+    void Disarm();
+
+    // 阻塞等第一段过了 VAD 门的语音，把 LP RX 内存里已缓存的样本
+    // （16kHz 单声道）追加进 preroll。撤防时返回 false
+    bool WaitVoice(std::vector<int16_t>& preroll);
+
+private:
+    LpWakePrescreen() = default;
+
+    lp_i2s_chan_handle_t rx_chan_ = nullptr;
+    vad_unit_handle_t vad_unit_ = nullptr;
+    std::atomic<bool> armed_{false};
+};
+
+#endif // CONFIG_USE_LP_WAKE_PRESCREEN
+
+#endif // LP_WAKE_PRESCREEN_H
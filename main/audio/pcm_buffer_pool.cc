@@ -0,0 +1,32 @@
+#include "pcm_buffer_pool.h"
+
+std::vector<int16_t> PcmBufferPool::Acquire(size_t samples) {
+    std::vector<int16_t> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!buffers_.empty()) {
+            buffer = std::move(buffers_.front());
+            buffers_.pop_front();
+        }
+    }
+    // resize() within the recycled capacity does not touch the heap
+    buffer.resize(samples);
+    return buffer;
+}
+
+void PcmBufferPool::Release(std::vector<int16_t>&& buffer) {
+    if (buffer.capacity() == 0) {
+        return;
+    }
+    buffer.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (buffers_.size() < kMaxPooledBuffers) {
+        buffers_.push_back(std::move(buffer));
+    }
+}
+
+void PcmBufferPool::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.clear();
+}
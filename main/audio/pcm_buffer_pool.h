@@ -0,0 +1,37 @@
+#ifndef PCM_BUFFER_POOL_H
+#define PCM_BUFFER_POOL_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/*
+ * Fixed-size pool of PCM sample buffers for the audio pipeline.
+ *
+ * The decode and playback stages move one PCM buffer per Opus frame (60ms),
+ * and allocating them from the heap every frame fragments the internal RAM
+ * heap. Buffers released here keep their capacity, so once the pool is warm
+ * the steady-state decode -> playback path does no heap allocations.
+ */
+class PcmBufferPool {
+public:
+    // Returns a buffer resized to `samples`. Reuses a pooled buffer when one
+    // is available, so no allocation happens once capacities have grown to
+    // the codec frame size.
+    std::vector<int16_t> Acquire(size_t samples);
+
+    // Returns a buffer to the pool. Capacity is preserved; buffers beyond
+    // the pool limit are freed.
+    void Release(std::vector<int16_t>&& buffer);
+
+    void Clear();
+
+private:
+    static const size_t kMaxPooledBuffers = 8;
+
+    std::mutex mutex_;
+    std::deque<std::vector<int16_t>> buffers_;
+};
+
+#endif // PCM_BUFFER_POOL_H
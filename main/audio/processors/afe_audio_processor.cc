@@ -1,4 +1,6 @@
 #include "afe_audio_processor.h"
+#include "acoustic_calibration.h"
+#include "task_registry.h"
 #include <esp_log.h>
 
 #define PROCESSOR_RUNNING 0x01
@@ -64,14 +66,22 @@ void AfeAudioProcessor::Initialize(AudioCodec* codec, int frame_duration_ms, srm
     afe_config->vad_init = true;
 #endif
 
+    // 声学标定档案里的 AEC 提示：箱体回声路径短的外壳用更短的滤波器，
+    // 收敛更快
+    int aec_filter_length = AcousticCalibration::GetInstance().aec_filter_length();
+    if (afe_config->aec_init && aec_filter_length > 0) {
+        afe_config->aec_filter_length = aec_filter_length;
+    }
+
     afe_iface_ = esp_afe_handle_from_config(afe_config);
     afe_data_ = afe_iface_->create_from_config(afe_config);
     
-    xTaskCreate([](void* arg) {
+    TaskHandle_t processor_task = processor_task_buffer_.Create([](void* arg) {
         auto this_ = (AfeAudioProcessor*)arg;
         this_->AudioProcessorTask();
         vTaskDelete(NULL);
-    }, "audio_communication", 4096, this, 3, NULL);
+    }, "audio_communication", 4096, this, 3);
+    TaskRegistry::GetInstance().Register(processor_task, "audio_communication", 3, -1);
 }
 
 AfeAudioProcessor::~AfeAudioProcessor() {
@@ -85,14 +95,38 @@ size_t AfeAudioProcessor::GetFeedSize() {
     if (afe_data_ == nullptr) {
         return 0;
     }
-    return afe_iface_->get_feed_chunksize(afe_data_);
+    return afe_iface_->get_feed_chunksize(afe_data_) * kFeedBatchChunks;
 }
 
 void AfeAudioProcessor::Feed(std::vector<int16_t>&& data) {
     if (afe_data_ == nullptr) {
         return;
     }
-    afe_iface_->feed(afe_data_, data.data());
+    /* 标定的麦克风/参考通道数字微调：大喇叭外壳把参考压低几 dB，
+     * AEC 在重叠的第一秒内就能收敛（档案缺省时这里是空操作） */
+    auto& calibration = AcousticCalibration::GetInstance();
+    if (calibration.has_input_trim()) {
+        size_t channels = codec_->input_channels();
+        size_t ref_num = codec_->input_reference() ? 1 : 0;
+        size_t mic_num = channels - ref_num;
+        for (size_t ch = 0; ch < mic_num; ch++) {
+            AcousticCalibration::ApplyGain(data.data() + ch, data.size() - ch, channels,
+                                           calibration.mic_gain_q15());
+        }
+        for (size_t ch = mic_num; ch < channels; ch++) {
+            AcousticCalibration::ApplyGain(data.data() + ch, data.size() - ch, channels,
+                                           calibration.reference_gain_q15());
+        }
+    }
+
+    /* The AFE expects exactly one chunk per feed() call, so split the
+     * batched read back into chunks here */
+    size_t chunk_samples = afe_iface_->get_feed_chunksize(afe_data_) * codec_->input_channels();
+    size_t offset = 0;
+    while (offset + chunk_samples <= data.size()) {
+        afe_iface_->feed(afe_data_, data.data() + offset);
+        offset += chunk_samples;
+    }
 }
 
 void AfeAudioProcessor::Start() {
@@ -127,45 +161,49 @@ void AfeAudioProcessor::AudioProcessorTask() {
     while (true) {
         xEventGroupWaitBits(event_group_, PROCESSOR_RUNNING, pdFALSE, pdTRUE, portMAX_DELAY);
 
-        auto res = afe_iface_->fetch_with_delay(afe_data_, portMAX_DELAY);
-        if ((xEventGroupGetBits(event_group_) & PROCESSOR_RUNNING) == 0) {
-            continue;
-        }
-        if (res == nullptr || res->ret_value == ESP_FAIL) {
-            if (res != nullptr) {
+        /* Block for the first result, then drain everything the AFE already
+         * has ready, so one wakeup handles a whole batch of fed chunks */
+        bool first_fetch = true;
+        afe_fetch_result_t* res;
+        while ((res = afe_iface_->fetch_with_delay(afe_data_, first_fetch ? portMAX_DELAY : 0)) != nullptr) {
+            first_fetch = false;
+            if ((xEventGroupGetBits(event_group_) & PROCESSOR_RUNNING) == 0) {
+                break;
+            }
+            if (res->ret_value == ESP_FAIL) {
                 ESP_LOGI(TAG, "Error code: %d", res->ret_value);
+                break;
             }
-            continue;
-        }
 
-        // VAD state change
-        if (vad_state_change_callback_) {
-            if (res->vad_state == VAD_SPEECH && !is_speaking_) {
-                is_speaking_ = true;
-                vad_state_change_callback_(true);
-            } else if (res->vad_state == VAD_SILENCE && is_speaking_) {
-                is_speaking_ = false;
-                vad_state_change_callback_(false);
+            // VAD state change
+            if (vad_state_change_callback_) {
+                if (res->vad_state == VAD_SPEECH && !is_speaking_) {
+                    is_speaking_ = true;
+                    vad_state_change_callback_(true);
+                } else if (res->vad_state == VAD_SILENCE && is_speaking_) {
+                    is_speaking_ = false;
+                    vad_state_change_callback_(false);
+                }
             }
-        }
 
-        if (output_callback_) {
-            size_t samples = res->data_size / sizeof(int16_t);
-            
-            // Add data to buffer
-            output_buffer_.insert(output_buffer_.end(), res->data, res->data + samples);
-            
-            // Output complete frames when buffer has enough data
-            while (output_buffer_.size() >= frame_samples_) {
-                if (output_buffer_.size() == frame_samples_) {
-                    // If buffer size equals frame size, move the entire buffer
-                    output_callback_(std::move(output_buffer_));
-                    output_buffer_.clear();
-                    output_buffer_.reserve(frame_samples_);
-                } else {
-                    // If buffer size exceeds frame size, copy one frame and remove it
-                    output_callback_(std::vector<int16_t>(output_buffer_.begin(), output_buffer_.begin() + frame_samples_));
-                    output_buffer_.erase(output_buffer_.begin(), output_buffer_.begin() + frame_samples_);
+            if (output_callback_) {
+                size_t samples = res->data_size / sizeof(int16_t);
+
+                // Add data to buffer
+                output_buffer_.insert(output_buffer_.end(), res->data, res->data + samples);
+
+                // Output complete frames when buffer has enough data
+                while (output_buffer_.size() >= frame_samples_) {
+                    if (output_buffer_.size() == frame_samples_) {
+                        // If buffer size equals frame size, move the entire buffer
+                        output_callback_(std::move(output_buffer_));
+                        output_buffer_.clear();
+                        output_buffer_.reserve(frame_samples_);
+                    } else {
+                        // If buffer size exceeds frame size, copy one frame and remove it
+                        output_callback_(std::vector<int16_t>(output_buffer_.begin(), output_buffer_.begin() + frame_samples_));
+                        output_buffer_.erase(output_buffer_.begin(), output_buffer_.begin() + frame_samples_);
+                    }
                 }
             }
         }
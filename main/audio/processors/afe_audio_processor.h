@@ -12,8 +12,9 @@
 
 #include "audio_processor.h"
 #include "audio_codec.h"
+#include "static_task.h"
 
-class AfeAudioProcessor : public AudioProcessor {
+class AfeAudioProcessor final : public AudioProcessor {
 public:
     AfeAudioProcessor();
     ~AfeAudioProcessor();
@@ -29,7 +30,14 @@ public:
     void EnableDeviceAec(bool enable) override;
 
 private:
+    /* Number of AFE chunks read and fed per input-task wakeup. Batching
+     * amortizes the I2S read and task switch overhead (~100Hz -> ~50Hz
+     * wakeups with AEC+NS+VAD enabled) at the cost of one chunk of extra
+     * input latency. */
+    static const size_t kFeedBatchChunks = 2;
+
     EventGroupHandle_t event_group_ = nullptr;
+    StaticTaskBuffer processor_task_buffer_;  // 任务栈放 PSRAM
     const esp_afe_sr_iface_t* afe_iface_ = nullptr;
     esp_afe_sr_data_t* afe_data_ = nullptr;
     std::function<void(std::vector<int16_t>&& data)> output_callback_;
@@ -3,11 +3,13 @@
 
 #if CONFIG_USE_AUDIO_DEBUGGER
 #include <esp_log.h>
+#include <esp_heap_caps.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <errno.h>
 #include <cstring>
 #include <string>
+#include <algorithm>
 #endif
 
 #define TAG "AudioDebugger"
@@ -20,16 +22,16 @@ AudioDebugger::AudioDebugger() {
         // 解析配置的服务器地址 "IP:PORT"
         std::string server_addr = CONFIG_AUDIO_DEBUG_UDP_SERVER;
         size_t colon_pos = server_addr.find(':');
-        
+
         if (colon_pos != std::string::npos) {
             std::string ip = server_addr.substr(0, colon_pos);
             int port = std::stoi(server_addr.substr(colon_pos + 1));
-            
+
             memset(&udp_server_addr_, 0, sizeof(udp_server_addr_));
             udp_server_addr_.sin_family = AF_INET;
             udp_server_addr_.sin_port = htons(port);
             inet_pton(AF_INET, ip.c_str(), &udp_server_addr_.sin_addr);
-            
+
             ESP_LOGI(TAG, "Initialized server address: %s", CONFIG_AUDIO_DEBUG_UDP_SERVER);
         } else {
             ESP_LOGW(TAG, "Invalid server address: %s, should be IP:PORT", CONFIG_AUDIO_DEBUG_UDP_SERVER);
@@ -39,11 +41,45 @@ AudioDebugger::AudioDebugger() {
     } else {
         ESP_LOGW(TAG, "Failed to create UDP socket: %d", errno);
     }
+
+    if (udp_sockfd_ >= 0) {
+        // 环形队列放 PSRAM（约 8KB），没有 PSRAM 的板子退回内部 RAM
+        uint32_t caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+        if (heap_caps_get_total_size(MALLOC_CAP_SPIRAM) == 0) {
+            caps = MALLOC_CAP_8BIT;
+        }
+        slots_ = (Slot*)heap_caps_malloc(sizeof(Slot) * kRingFrames, caps);
+        if (slots_ == nullptr) {
+            ESP_LOGW(TAG, "Failed to allocate tap ring");
+            close(udp_sockfd_);
+            udp_sockfd_ = -1;
+            return;
+        }
+        for (uint32_t i = 0; i < kRingFrames; i++) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        running_.store(true);
+        xTaskCreate([](void* arg) {
+            static_cast<AudioDebugger*>(arg)->SenderLoop();
+        }, "audio_tap", 3072, this, 2, &sender_task_);
+    }
 #endif
 }
 
 AudioDebugger::~AudioDebugger() {
 #if CONFIG_USE_AUDIO_DEBUGGER
+    if (sender_task_ != nullptr) {
+        running_.store(false);
+        xTaskNotifyGive(sender_task_);
+        // 发送任务退出前把 handle 清空
+        while (sender_task_ != nullptr) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    if (slots_ != nullptr) {
+        heap_caps_free(slots_);
+    }
     if (udp_sockfd_ >= 0) {
         close(udp_sockfd_);
         ESP_LOGI(TAG, "Closed UDP socket");
@@ -51,18 +87,105 @@ AudioDebugger::~AudioDebugger() {
 #endif
 }
 
-void AudioDebugger::Feed(const std::vector<int16_t>& data) {
 #if CONFIG_USE_AUDIO_DEBUGGER
-    if (udp_sockfd_ >= 0) {
-        ssize_t sent = sendto(udp_sockfd_, data.data(), data.size() * sizeof(int16_t), 0,
-                             (struct sockaddr*)&udp_server_addr_, sizeof(udp_server_addr_));
-        if (sent < 0) {
-            ESP_LOGW(TAG, "Failed to send audio data to %s: %d", CONFIG_AUDIO_DEBUG_UDP_SERVER, errno);
+bool AudioDebugger::PushFrame(AudioDebugTap tap, const int16_t* samples, size_t count, bool downsampled) {
+    uint32_t pos = head_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots_[pos & (kRingFrames - 1)];
+        uint32_t seq = slot->seq.load(std::memory_order_acquire);
+        int32_t dif = (int32_t)(seq - pos);
+        if (dif == 0) {
+            if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            // 队列满：丢帧计数，绝不阻塞音频任务
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
         } else {
-            ESP_LOGD(TAG, "Sent %d bytes audio data to %s", sent, CONFIG_AUDIO_DEBUG_UDP_SERVER);
+            pos = head_.load(std::memory_order_relaxed);
         }
     }
-#endif
+
+    slot->frame.tap = (uint8_t)tap;
+    slot->frame.flags = downsampled ? 0x01 : 0x00;
+    slot->frame.samples = (uint16_t)count;
+    memcpy(slot->frame.pcm, samples, count * sizeof(int16_t));
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
 }
 
- 
\ No newline at end of file
+void AudioDebugger::SenderLoop() {
+    struct __attribute__((packed)) PacketHeader {
+        uint8_t tap;
+        uint8_t flags;
+        uint16_t seq;
+        uint32_t dropped;
+    };
+    static_assert(sizeof(PacketHeader) == 8, "header layout is part of the wire format");
+
+    uint8_t packet[sizeof(PacketHeader) + kMaxFrameSamples * sizeof(int16_t)];
+    while (running_.load()) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+        for (;;) {
+            uint32_t pos = tail_.load(std::memory_order_relaxed);
+            Slot* slot = &slots_[pos & (kRingFrames - 1)];
+            uint32_t seq = slot->seq.load(std::memory_order_acquire);
+            if ((int32_t)(seq - (pos + 1)) < 0) {
+                break;  // 队列空
+            }
+            tail_.store(pos + 1, std::memory_order_relaxed);
+
+            auto* header = (PacketHeader*)packet;
+            header->tap = slot->frame.tap;
+            header->flags = slot->frame.flags;
+            header->seq = send_seq_++;
+            header->dropped = dropped_.load(std::memory_order_relaxed);
+            size_t payload = slot->frame.samples * sizeof(int16_t);
+            memcpy(packet + sizeof(PacketHeader), slot->frame.pcm, payload);
+            // 槽位归还给生产者
+            slot->seq.store(pos + kRingFrames, std::memory_order_release);
+
+            ssize_t sent = sendto(udp_sockfd_, packet, sizeof(PacketHeader) + payload, 0,
+                                  (struct sockaddr*)&udp_server_addr_, sizeof(udp_server_addr_));
+            if (sent < 0) {
+                ESP_LOGD(TAG, "Failed to send audio data to %s: %d", CONFIG_AUDIO_DEBUG_UDP_SERVER, errno);
+            }
+        }
+    }
+    sender_task_ = nullptr;
+    vTaskDelete(NULL);
+}
+#endif
+
+void AudioDebugger::Feed(AudioDebugTap tap, const std::vector<int16_t>& data) {
+#if CONFIG_USE_AUDIO_DEBUGGER
+    if (udp_sockfd_ < 0 || ((CONFIG_AUDIO_DEBUG_TAP_MASK >> (int)tap) & 1) == 0) {
+        return;
+    }
+
+    bool notify = false;
+#if CONFIG_AUDIO_DEBUG_DOWNSAMPLE_4X
+    // 4:1 平均降采样，带宽降到 1/4；多通道交织的原始输入不适合开这个
+    int16_t decimated[kMaxFrameSamples];
+    size_t total = data.size() / 4;
+    for (size_t offset = 0; offset < total; offset += kMaxFrameSamples) {
+        size_t count = std::min(total - offset, kMaxFrameSamples);
+        for (size_t i = 0; i < count; i++) {
+            const int16_t* src = data.data() + (offset + i) * 4;
+            decimated[i] = (int16_t)(((int32_t)src[0] + src[1] + src[2] + src[3]) / 4);
+        }
+        notify |= PushFrame(tap, decimated, count, true);
+    }
+#else
+    for (size_t offset = 0; offset < data.size(); offset += kMaxFrameSamples) {
+        size_t count = std::min(data.size() - offset, kMaxFrameSamples);
+        notify |= PushFrame(tap, data.data() + offset, count, false);
+    }
+#endif
+    if (notify && sender_task_ != nullptr) {
+        xTaskNotifyGive(sender_task_);
+    }
+#endif
+}
@@ -3,20 +3,65 @@
 
 #include <vector>
 #include <cstdint>
+#include <atomic>
 
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
+// 调试抽头点，对应 CONFIG_AUDIO_DEBUG_TAP_MASK 的位。
+// AEC 板的参考通道与麦克风在原始输入里交织，没有单独的抽头
+enum AudioDebugTap {
+    kAudioDebugTapRawMic = 0,     // 编解码器读出的原始输入
+    kAudioDebugTapProcessed = 1,  // AFE 之后、编码之前
+    kAudioDebugTapOutput = 2,     // 解码后的下行 PCM
+};
+
+/*
+ * 音频调试抽头：音频任务把帧写进无锁环形队列后立即返回，由低优先级
+ * 发送任务负责 UDP 发送，抽头永远不会阻塞被调试的音频通路。队列满时
+ * 丢帧并计数，丢帧总数随每个包的头部带给主机，便于判断数据完整性。
+ * 每个 UDP 包带 8 字节头：tap、flags（bit0=4:1 降采样）、递增序号、
+ * 累计丢帧数，其后是 int16 小端 PCM。
+ */
 class AudioDebugger {
 public:
     AudioDebugger();
     ~AudioDebugger();
 
-    void Feed(const std::vector<int16_t>& data);
+    void Feed(const std::vector<int16_t>& data) { Feed(kAudioDebugTapRawMic, data); }
+    void Feed(AudioDebugTap tap, const std::vector<int16_t>& data);
 
 private:
+    // 单个槽位装一个 UDP 包的载荷；更长的帧在 Feed 里分段
+    static constexpr size_t kMaxFrameSamples = 512;
+    static constexpr size_t kRingFrames = 8;  // 2 的幂
+
+    struct TapFrame {
+        uint8_t tap;
+        uint8_t flags;
+        uint16_t samples;
+        int16_t pcm[kMaxFrameSamples];
+    };
+    // Vyukov 风格的有界无锁队列：输入、输出两个任务都会投递
+    struct Slot {
+        std::atomic<uint32_t> seq;
+        TapFrame frame;
+    };
+
+    bool PushFrame(AudioDebugTap tap, const int16_t* samples, size_t count, bool downsampled);
+    void SenderLoop();
+
     int udp_sockfd_ = -1;
     struct sockaddr_in udp_server_addr_;
+    Slot* slots_ = nullptr;
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+    std::atomic<uint32_t> dropped_{0};
+    uint16_t send_seq_ = 0;
+    TaskHandle_t sender_task_ = nullptr;
+    std::atomic<bool> running_{false};
 };
 
-#endif 
\ No newline at end of file
+#endif
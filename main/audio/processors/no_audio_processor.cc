@@ -14,9 +14,34 @@ void NoAudioProcessor::Feed(std::vector<int16_t>&& data) {
     }
 
     if (codec_->input_channels() == 2) {
-        // If input channels is 2, we need to fetch the left channel data
-        auto mono_data = std::vector<int16_t>(data.size() / 2);
-        for (size_t i = 0, j = 0; i < mono_data.size(); ++i, j += 2) {
+        size_t frames = data.size() / 2;
+        if (!codec_->input_reference()) {
+            // 双麦（第二路不是 AEC 参考）：逐帧测两路能量并持续选用更响
+            // 的那路，而不是固定取左声道。没有 AFE 波束成形的板子至少
+            // 能受益于摆位更好的那只麦克风
+            float energy[2] = {0.0f, 0.0f};
+            for (size_t i = 0, j = 0; i < frames; ++i, j += 2) {
+                energy[0] += (float)data[j] * data[j];
+                energy[1] += (float)data[j + 1] * data[j + 1];
+            }
+            for (int ch = 0; ch < 2; ch++) {
+                // 约 1s 时间常数的 IIR 平滑，避免逐帧能量抖动来回切
+                channel_energy_[ch] += (energy[ch] / frames - channel_energy_[ch]) * 0.06f;
+            }
+            int other = 1 - selected_channel_;
+            // 滞回：另一路平滑能量高出 6dB 并保持若干帧才切换
+            if (channel_energy_[other] > channel_energy_[selected_channel_] * 4.0f) {
+                if (++switch_hold_frames_ >= kSwitchHoldFrames) {
+                    selected_channel_ = other;
+                    switch_hold_frames_ = 0;
+                    ESP_LOGI(TAG, "Input switched to mic channel %d", selected_channel_);
+                }
+            } else {
+                switch_hold_frames_ = 0;
+            }
+        }
+        auto mono_data = std::vector<int16_t>(frames);
+        for (size_t i = 0, j = (size_t)selected_channel_; i < frames; ++i, j += 2) {
             mono_data[i] = data[j];
         }
         output_callback_(std::move(mono_data));
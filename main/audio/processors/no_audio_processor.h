@@ -7,7 +7,7 @@
 #include "audio_processor.h"
 #include "audio_codec.h"
 
-class NoAudioProcessor : public AudioProcessor {
+class NoAudioProcessor final : public AudioProcessor {
 public:
     NoAudioProcessor() = default;
     ~NoAudioProcessor() = default;
@@ -28,6 +28,13 @@ private:
     std::function<void(std::vector<int16_t>&& data)> output_callback_;
     std::function<void(bool speaking)> vad_state_change_callback_;
     bool is_running_ = false;
+
+    // 双麦选路状态：两路能量的 IIR 平滑值、当前选用的声道与滞回计数。
+    // 带 AEC 参考的双通道 codec 不参与选路，固定用 0 路（麦克风）
+    static constexpr int kSwitchHoldFrames = 10;
+    float channel_energy_[2] = {0.0f, 0.0f};
+    int selected_channel_ = 0;
+    int switch_hold_frames_ = 0;
 };
 
 #endif 
\ No newline at end of file
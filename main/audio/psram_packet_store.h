@@ -0,0 +1,93 @@
+#ifndef PSRAM_PACKET_STORE_H
+#define PSRAM_PACKET_STORE_H
+
+#include <cstring>
+
+#include <esp_heap_caps.h>
+
+#include "heap_telemetry.h"
+#include "protocol.h"
+#include "spsc_ring.h"
+
+/*
+ * Overflow store for the decode path, layered behind the internal-RAM
+ * decode ring. Payload bytes are copied into MALLOC_CAP_SPIRAM buffers,
+ * so deep buffering of long replies never touches the DMA-capable
+ * internal heap; only the fixed-size descriptor ring lives in internal
+ * RAM. Same SPSC contract as the other audio queues: the network task
+ * pushes, the decode task pops and clears.
+ */
+template <size_t N>
+class PsramPacketStore {
+public:
+    ~PsramPacketStore() {
+        Clear();
+    }
+
+    // Producer side. Copies the payload into PSRAM; returns false when the
+    // store is full or the PSRAM allocation fails (packet left untouched).
+    bool Push(const AudioStreamPacket& packet) {
+        Entry entry;
+        entry.sample_rate = packet.sample_rate;
+        entry.frame_duration = packet.frame_duration;
+        entry.timestamp = packet.timestamp;
+        entry.trace_time_us = packet.trace_time_us;
+        entry.payload_size = packet.payload.size();
+        if (entry.payload_size > 0) {
+            entry.payload = (uint8_t*)heap_caps_malloc(entry.payload_size, MALLOC_CAP_SPIRAM);
+            if (entry.payload == nullptr) {
+                return false;
+            }
+            memcpy(entry.payload, packet.payload.data(), entry.payload_size);
+        }
+        if (!ring_.Push(std::move(entry))) {
+            heap_caps_free(entry.payload);
+            return false;
+        }
+        HeapTelemetry::GetInstance().Add("audio", entry.payload_size);
+        return true;
+    }
+
+    // Consumer side. Copies the payload back into internal RAM and frees
+    // the PSRAM buffer. Returns false when the store is empty.
+    bool Pop(AudioStreamPacket& packet) {
+        Entry entry;
+        if (!ring_.Pop(entry)) {
+            return false;
+        }
+        packet.sample_rate = entry.sample_rate;
+        packet.frame_duration = entry.frame_duration;
+        packet.timestamp = entry.timestamp;
+        packet.trace_time_us = entry.trace_time_us;
+        packet.payload.assign(entry.payload, entry.payload + entry.payload_size);
+        heap_caps_free(entry.payload);
+        HeapTelemetry::GetInstance().Remove("audio", entry.payload_size);
+        return true;
+    }
+
+    bool Empty() const { return ring_.Empty(); }
+    size_t Size() const { return ring_.Size(); }
+
+    // Consumer side only: drop everything currently stored.
+    void Clear() {
+        Entry entry;
+        while (ring_.Pop(entry)) {
+            heap_caps_free(entry.payload);
+            HeapTelemetry::GetInstance().Remove("audio", entry.payload_size);
+        }
+    }
+
+private:
+    struct Entry {
+        int sample_rate = 0;
+        int frame_duration = 0;
+        uint32_t timestamp = 0;
+        int64_t trace_time_us = 0;
+        uint8_t* payload = nullptr;
+        size_t payload_size = 0;
+    };
+
+    SpscRing<Entry, N> ring_;
+};
+
+#endif // PSRAM_PACKET_STORE_H
@@ -0,0 +1,76 @@
+#include "sound_cache.h"
+
+#include <cstring>
+
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+
+#define TAG "SoundCache"
+
+
+SoundCache::~SoundCache() {
+    while (!entries_.empty()) {
+        EvictOldest();
+    }
+}
+
+bool SoundCache::Get(const void* key, const std::function<void(const int16_t* pcm, size_t samples)>& use) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->key == key) {
+            entries_.splice(entries_.begin(), entries_, it);
+            use(it->pcm, it->samples);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SoundCache::Contains(const void* key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_) {
+        if (entry.key == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SoundCache::Put(const void* key, const int16_t* pcm, size_t samples) {
+    size_t bytes = samples * sizeof(int16_t);
+    if (bytes > kMaxCacheBytes) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (total_bytes_ + bytes > kMaxCacheBytes && !entries_.empty()) {
+        EvictOldest();
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.pcm = (int16_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+    if (entry.pcm == nullptr) {
+        ESP_LOGW(TAG, "Failed to allocate %u bytes of PSRAM for sound cache", (unsigned)bytes);
+        return;
+    }
+    memcpy(entry.pcm, pcm, bytes);
+    entry.samples = samples;
+    entries_.push_front(entry);
+    total_bytes_ += bytes;
+}
+
+size_t SoundCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t freed = total_bytes_;
+    while (!entries_.empty()) {
+        EvictOldest();
+    }
+    return freed;
+}
+
+void SoundCache::EvictOldest() {
+    auto& entry = entries_.back();
+    heap_caps_free(entry.pcm);
+    total_bytes_ -= entry.samples * sizeof(int16_t);
+    entries_.pop_back();
+}
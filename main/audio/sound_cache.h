@@ -0,0 +1,57 @@
+#ifndef SOUND_CACHE_H
+#define SOUND_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+
+/*
+ * LRU cache of decoded UI sounds. The PCM is stored in PSRAM
+ * (MALLOC_CAP_SPIRAM), already resampled to the codec output rate, so a
+ * cached sound plays without touching the Opus decoder at all. Sounds
+ * are embedded assets, so their data pointer is stable and serves as
+ * the cache key. The cache is registered as a reclaimable pool with the
+ * memory budget manager, whose reclaim runs on whatever task hit the
+ * failing allocation, so all access is serialized with an internal
+ * lock; Get hands the PCM to a callback under that lock so a concurrent
+ * Clear cannot free it mid-use.
+ */
+class SoundCache {
+public:
+    ~SoundCache();
+
+    // Looks up the sound keyed by its asset data pointer, marks it most
+    // recently used and invokes `use` with the PCM while the entry is
+    // guaranteed alive. Returns false (without calling `use`) on miss
+    bool Get(const void* key, const std::function<void(const int16_t* pcm, size_t samples)>& use);
+    // Presence check without touching the LRU order
+    bool Contains(const void* key);
+    // Copies the PCM into PSRAM, evicting least recently used sounds to
+    // stay under budget. A failed PSRAM allocation leaves the cache
+    // unchanged (the caller falls back to the decoder path).
+    void Put(const void* key, const int16_t* pcm, size_t samples);
+    // Drops every entry and returns the bytes freed. Used as the budget
+    // manager's reclaim; sounds re-decode on next use.
+    size_t Clear();
+
+private:
+    struct Entry {
+        const void* key;
+        int16_t* pcm;
+        size_t samples;
+    };
+
+    // Most recently used first
+    std::list<Entry> entries_;
+    size_t total_bytes_ = 0;
+    std::mutex mutex_;
+
+    static const size_t kMaxCacheBytes = 512 * 1024;
+
+    // Caller holds mutex_
+    void EvictOldest();
+};
+
+#endif // SOUND_CACHE_H
@@ -0,0 +1,76 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/*
+ * Lock-free single-producer / single-consumer ring.
+ *
+ * Each audio queue has exactly one producer task and one consumer task, so a
+ * classic SPSC ring with acquire/release indices is enough: a push and a pop
+ * never touch the same cache line state under a shared mutex the way the old
+ * deque + condition_variable queues did.
+ *
+ * One slot is kept empty to distinguish full from empty, so the ring holds at
+ * most N items with N + 1 slots. Push/Pop never block; the callers handle
+ * waiting with FreeRTOS task notifications.
+ */
+template <typename T, size_t N>
+class SpscRing {
+public:
+    // Producer side. Returns false (and leaves `item` untouched) when full.
+    bool Push(T&& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t next = Advance(tail);
+        if (next == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots_[tail] = std::move(item);
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when empty.
+    bool Pop(T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = std::move(slots_[head]);
+        head_.store(Advance(head), std::memory_order_release);
+        return true;
+    }
+
+    bool Empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    bool Full() const {
+        return Advance(tail_.load(std::memory_order_acquire)) == head_.load(std::memory_order_acquire);
+    }
+
+    size_t Size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : (N + 1) - head + tail;
+    }
+
+    // Consumer side only: drop everything currently queued.
+    void Clear() {
+        T item;
+        while (Pop(item)) {
+        }
+    }
+
+private:
+    static size_t Advance(size_t index) { return (index + 1) % (N + 1); }
+
+    std::array<T, N + 1> slots_;
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+};
+
+#endif // SPSC_RING_H
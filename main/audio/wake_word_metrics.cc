@@ -0,0 +1,78 @@
+#include "wake_word_metrics.h"
+
+#include <cstdio>
+
+#include <esp_timer.h>
+
+void WakeWordMetrics::OnFetchResult(float volume_db, bool vad_speech) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    vad_total_frames_++;
+    if (vad_speech) {
+        vad_speech_frames_++;
+    } else {
+        // 静音期能量的慢 EWMA 当噪声底；首帧直接播种，免得从 -60 爬很久
+        if (!noise_floor_seeded_) {
+            noise_floor_seeded_ = true;
+            noise_floor_db_ = volume_db;
+        } else {
+            noise_floor_db_ += 0.02f * (volume_db - noise_floor_db_);
+        }
+    }
+}
+
+void WakeWordMetrics::OnDetection(const char* model_name, float volume_db) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (model_name != nullptr && model_name_.empty()) {
+        model_name_ = model_name;
+    }
+    detections_++;
+    snr_sum_db_ += volume_db - noise_floor_db_;
+    last_detection_us_ = esp_timer_get_time();
+}
+
+void WakeWordMetrics::OnSessionStart() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sessions_++;
+}
+
+void WakeWordMetrics::OnSessionAborted() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (last_detection_us_ != 0 &&
+        esp_timer_get_time() - last_detection_us_ < kQuickAbortWindowUs) {
+        quick_aborts_++;
+    }
+}
+
+std::string WakeWordMetrics::TakeReport() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t now_us = esp_timer_get_time();
+    if (last_report_us_ == 0) {
+        // 首个窗口从启动算起
+        last_report_us_ = now_us;
+        return "";
+    }
+    if (now_us - last_report_us_ < kReportIntervalUs ||
+        (detections_ == 0 && vad_total_frames_ == 0)) {
+        return "";
+    }
+
+    char buffer[224];
+    snprintf(buffer, sizeof(buffer),
+             "{\"model\":\"%s\",\"window_s\":%ld,\"detections\":%lu,\"sessions\":%lu,"
+             "\"quick_aborts\":%lu,\"vad_ratio\":%.3f,\"noise_floor_db\":%.1f,"
+             "\"mean_snr_db\":%.1f}",
+             model_name_.c_str(), (long)((now_us - last_report_us_) / 1000000),
+             (unsigned long)detections_, (unsigned long)sessions_, (unsigned long)quick_aborts_,
+             vad_total_frames_ > 0 ? (double)vad_speech_frames_ / vad_total_frames_ : 0.0,
+             (double)noise_floor_db_,
+             detections_ > 0 ? (double)(snr_sum_db_ / detections_) : 0.0);
+
+    detections_ = 0;
+    sessions_ = 0;
+    quick_aborts_ = 0;
+    vad_speech_frames_ = 0;
+    vad_total_frames_ = 0;
+    snr_sum_db_ = 0.0f;
+    last_report_us_ = now_us;
+    return std::string(buffer);
+}
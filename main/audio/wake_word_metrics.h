@@ -0,0 +1,61 @@
+#ifndef WAKE_WORD_METRICS_H
+#define WAKE_WORD_METRICS_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+/*
+ * 唤醒词质量指标采集。
+ *
+ * 单台设备上的误唤醒/漏唤醒没法直接测，但全队聚合信号可以：检测次数、
+ * 检测后很快被用户打断的会话（疑似误唤醒）、VAD 活跃占比、检测时的
+ * 能量对噪声底的差值（SNR 估计）。检测任务每次 AFE fetch 喂入能量和
+ * VAD 状态，VAD 静音期间的能量做 EWMA 当噪声底；检测命中时记
+ * volume - noise_floor。聚合结果按周期通过协议的 telemetry 消息上报
+ * （见 Protocol::SendTelemetry），服务端按 wakenet 模型版本分桶即可
+ * A/B 对比，不再依赖实验室样本。
+ */
+class WakeWordMetrics {
+public:
+    static WakeWordMetrics& GetInstance() {
+        static WakeWordMetrics instance;
+        return instance;
+    }
+
+    // 检测任务侧，AFE fetch 频率（~30Hz）调用
+    void OnFetchResult(float volume_db, bool vad_speech);
+    void OnDetection(const char* model_name, float volume_db);
+
+    // 会话信号（主循环侧）
+    void OnSessionStart();
+    // 中止；距上次检测不超过 kQuickAbortWindowUs 的按疑似误唤醒计数
+    void OnSessionAborted();
+
+    // 距上次上报超过间隔且窗口内有数据时返回紧凑 JSON 并清零计数，
+    // 否则返回空串。调用方负责送进协议
+    std::string TakeReport();
+
+private:
+    WakeWordMetrics() = default;
+    WakeWordMetrics(const WakeWordMetrics&) = delete;
+    WakeWordMetrics& operator=(const WakeWordMetrics&) = delete;
+
+    static constexpr int64_t kQuickAbortWindowUs = 3 * 1000000LL;
+    static constexpr int64_t kReportIntervalUs = 1800 * 1000000LL;
+
+    std::mutex mutex_;
+    std::string model_name_;
+    uint32_t detections_ = 0;
+    uint32_t sessions_ = 0;
+    uint32_t quick_aborts_ = 0;
+    uint32_t vad_speech_frames_ = 0;
+    uint32_t vad_total_frames_ = 0;
+    float noise_floor_db_ = -60.0f;
+    bool noise_floor_seeded_ = false;
+    float snr_sum_db_ = 0.0f;
+    int64_t last_detection_us_ = 0;
+    int64_t last_report_us_ = 0;
+};
+
+#endif // WAKE_WORD_METRICS_H
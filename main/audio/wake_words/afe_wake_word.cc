@@ -1,35 +1,38 @@
 #include "afe_wake_word.h"
 #include "audio_service.h"
+#include "task_registry.h"
+#include "wake_word_metrics.h"
 
 #include <esp_log.h>
 #include <sstream>
 
 #define DETECTION_RUNNING_EVENT 1
+#define DETECTION_EXIT_EVENT 2
+#define DETECTION_EXITED_EVENT 4
 
 #define TAG "AfeWakeWord"
 
+/* Keep roughly 2 seconds of encoded preroll */
+static const size_t kMaxPrerollPackets = 2000 / OPUS_FRAME_DURATION_MS + 1;
+
 AfeWakeWord::AfeWakeWord()
     : afe_data_(nullptr),
-      wake_word_pcm_(),
       wake_word_opus_() {
 
     event_group_ = xEventGroupCreate();
 }
 
 AfeWakeWord::~AfeWakeWord() {
+    // 先退住检测任务再释放 AFE，任务可能正阻塞在 fetch 上
+    StopDetectionTask();
+
     if (afe_data_ != nullptr) {
         afe_iface_->destroy(afe_data_);
     }
 
-    if (wake_word_encode_task_stack_ != nullptr) {
-        heap_caps_free(wake_word_encode_task_stack_);
-    }
-
-    if (wake_word_encode_task_buffer_ != nullptr) {
-        heap_caps_free(wake_word_encode_task_buffer_);
-    }
-
-    if (models_ != nullptr) {
+    // 外部传入的模型列表归 Assets 管（热切换时旧列表由调用方释放），
+    // 只有自己 esp_srmodel_init 出来的才在这里释放
+    if (owns_models_ && models_ != nullptr) {
         esp_srmodel_deinit(models_);
     }
 
@@ -42,6 +45,7 @@ bool AfeWakeWord::Initialize(AudioCodec* codec, srmodel_list_t* models_list) {
 
     if (models_list == nullptr) {
         models_ = esp_srmodel_init("model");
+        owns_models_ = true;
     } else {
         models_ = models_list;
     }
@@ -81,20 +85,43 @@ bool AfeWakeWord::Initialize(AudioCodec* codec, srmodel_list_t* models_list) {
     afe_iface_ = esp_afe_handle_from_config(afe_config);
     afe_data_ = afe_iface_->create_from_config(afe_config);
 
-    xTaskCreate([](void* arg) {
+    /* The AFE internal tasks prefer core 1 (afe_perferred_core above), so
+     * pin the detection task to core 0; extra detectors run by subclasses
+     * on this task then execute on the other core. */
+    auto& task_registry = TaskRegistry::GetInstance();
+    int detection_core = task_registry.ResolveCore("audio_detection", 0);
+    TaskHandle_t detection_task = nullptr;
+    xTaskCreatePinnedToCore([](void* arg) {
         auto this_ = (AfeWakeWord*)arg;
         this_->AudioDetectionTask();
         vTaskDelete(NULL);
-    }, "audio_detection", 4096, this, 3, nullptr);
+    }, "audio_detection", 4096, this, 3, &detection_task,
+        detection_core < 0 ? tskNO_AFFINITY : detection_core);
+    task_registry.Register(detection_task, "audio_detection", 3, detection_core);
+    detection_task_started_ = true;
 
     return true;
 }
 
+void AfeWakeWord::StopDetectionTask() {
+    if (!detection_task_started_) {
+        return;
+    }
+    detection_task_started_ = false;
+    xEventGroupSetBits(event_group_, DETECTION_EXIT_EVENT);
+    xEventGroupWaitBits(event_group_, DETECTION_EXITED_EVENT, pdFALSE, pdTRUE, portMAX_DELAY);
+}
+
 void AfeWakeWord::OnWakeWordDetected(std::function<void(const std::string& wake_word)> callback) {
     wake_word_detected_callback_ = callback;
 }
 
 void AfeWakeWord::Start() {
+    /* Drop any preroll the server did not drain from the last utterance */
+    {
+        std::lock_guard<std::mutex> lock(wake_word_mutex_);
+        wake_word_opus_.clear();
+    }
     xEventGroupSetBits(event_group_, DETECTION_RUNNING_EVENT);
 }
 
@@ -126,75 +153,71 @@ void AfeWakeWord::AudioDetectionTask() {
         feed_size, fetch_size);
 
     while (true) {
-        xEventGroupWaitBits(event_group_, DETECTION_RUNNING_EVENT, pdFALSE, pdTRUE, portMAX_DELAY);
+        EventBits_t bits = xEventGroupWaitBits(event_group_,
+            DETECTION_RUNNING_EVENT | DETECTION_EXIT_EVENT, pdFALSE, pdFALSE, portMAX_DELAY);
+        if (bits & DETECTION_EXIT_EVENT) {
+            break;
+        }
 
-        auto res = afe_iface_->fetch_with_delay(afe_data_, portMAX_DELAY);
+        // 有限超时而不是 portMAX_DELAY：喂料停掉后还能回来检查退出请求
+        auto res = afe_iface_->fetch_with_delay(afe_data_, pdMS_TO_TICKS(100));
         if (res == nullptr || res->ret_value == ESP_FAIL) {
-            continue;;
+            continue;
         }
 
+        WakeWordMetrics::GetInstance().OnFetchResult(res->data_volume, res->vad_state == VAD_SPEECH);
+
         // Store the wake word data for voice recognition, like who is speaking
         StoreWakeWordData(res->data, res->data_size / sizeof(int16_t));
 
-        if (res->wakeup_state == WAKENET_DETECTED) {
-            Stop();
-            last_detected_wake_word_ = wake_words_[res->wakenet_model_index - 1];
+        ProcessFetchResult(res);
+    }
 
-            if (wake_word_detected_callback_) {
-                wake_word_detected_callback_(last_detected_wake_word_);
-            }
+    ESP_LOGI(TAG, "Audio detection task exiting");
+    xEventGroupSetBits(event_group_, DETECTION_EXITED_EVENT);
+}
+
+void AfeWakeWord::ProcessFetchResult(const afe_fetch_result_t* res) {
+    if (res->wakeup_state == WAKENET_DETECTED) {
+        Stop();
+        last_detected_wake_word_ = wake_words_[res->wakenet_model_index - 1];
+        WakeWordMetrics::GetInstance().OnDetection(wakenet_model_, res->data_volume);
+
+        if (wake_word_detected_callback_) {
+            wake_word_detected_callback_(last_detected_wake_word_);
         }
     }
 }
 
 void AfeWakeWord::StoreWakeWordData(const int16_t* data, size_t samples) {
-    // store audio data to wake_word_pcm_
-    wake_word_pcm_.emplace_back(std::vector<int16_t>(data, data + samples));
-    // keep about 2 seconds of data, detect duration is 30ms (sample_rate == 16000, chunksize == 512)
-    while (wake_word_pcm_.size() > 2000 / 30) {
-        wake_word_pcm_.pop_front();
-    }
+    /* Encode the preroll incrementally while detection is still running,
+     * instead of keeping 2s of raw PCM and encoding it in one ~300ms burst
+     * after detection. The encoder runs at complexity 0 on the detection
+     * task, so the steady-state cost is a fraction of one AFE chunk. */
+    if (preroll_encoder_ == nullptr) {
+        preroll_encoder_ = std::make_unique<OpusEncoderWrapper>(16000, 1, OPUS_FRAME_DURATION_MS);
+        preroll_encoder_->SetComplexity(0); // 0 is the fastest
+    }
+
+    preroll_encoder_->Encode(std::vector<int16_t>(data, data + samples),
+        [this](std::vector<uint8_t>&& opus) {
+            std::lock_guard<std::mutex> lock(wake_word_mutex_);
+            wake_word_opus_.emplace_back(std::move(opus));
+            // keep about 2 seconds of encoded preroll
+            while (wake_word_opus_.size() > kMaxPrerollPackets) {
+                wake_word_opus_.pop_front();
+            }
+            wake_word_cv_.notify_all();
+        });
 }
 
 void AfeWakeWord::EncodeWakeWordData() {
-    const size_t stack_size = 4096 * 7;
-    wake_word_opus_.clear();
-    if (wake_word_encode_task_stack_ == nullptr) {
-        wake_word_encode_task_stack_ = (StackType_t*)heap_caps_malloc(stack_size, MALLOC_CAP_SPIRAM);
-        assert(wake_word_encode_task_stack_ != nullptr);
-    }
-    if (wake_word_encode_task_buffer_ == nullptr) {
-        wake_word_encode_task_buffer_ = (StaticTask_t*)heap_caps_malloc(sizeof(StaticTask_t), MALLOC_CAP_INTERNAL);
-        assert(wake_word_encode_task_buffer_ != nullptr);
-    }
-
-    wake_word_encode_task_ = xTaskCreateStatic([](void* arg) {
-        auto this_ = (AfeWakeWord*)arg;
-        {
-            auto start_time = esp_timer_get_time();
-            auto encoder = std::make_unique<OpusEncoderWrapper>(16000, 1, OPUS_FRAME_DURATION_MS);
-            encoder->SetComplexity(0); // 0 is the fastest
-
-            int packets = 0;
-            for (auto& pcm: this_->wake_word_pcm_) {
-                encoder->Encode(std::move(pcm), [this_](std::vector<uint8_t>&& opus) {
-                    std::lock_guard<std::mutex> lock(this_->wake_word_mutex_);
-                    this_->wake_word_opus_.emplace_back(std::move(opus));
-                    this_->wake_word_cv_.notify_all();
-                });
-                packets++;
-            }
-            this_->wake_word_pcm_.clear();
-
-            auto end_time = esp_timer_get_time();
-            ESP_LOGI(TAG, "Encode wake word opus %d packets in %ld ms", packets, (long)((end_time - start_time) / 1000));
-
-            std::lock_guard<std::mutex> lock(this_->wake_word_mutex_);
-            this_->wake_word_opus_.push_back(std::vector<uint8_t>());
-            this_->wake_word_cv_.notify_all();
-        }
-        vTaskDelete(NULL);
-    }, "encode_wake_word", stack_size, this, 2, wake_word_encode_task_stack_, wake_word_encode_task_buffer_);
+    /* The preroll is already encoded; just terminate the packet stream so
+     * GetWakeWordOpus() stops after draining it. */
+    std::lock_guard<std::mutex> lock(wake_word_mutex_);
+    ESP_LOGI(TAG, "Wake word preroll ready, %u packets", (unsigned)wake_word_opus_.size());
+    wake_word_opus_.push_back(std::vector<uint8_t>());
+    wake_word_cv_.notify_all();
 }
 
 bool AfeWakeWord::GetWakeWordOpus(std::vector<uint8_t>& opus) {
@@ -10,21 +10,24 @@
 #include <model_path.h>
 
 #include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 #include <functional>
 #include <mutex>
 #include <condition_variable>
 
+#include <opus_encoder.h>
+
 #include "audio_codec.h"
 #include "wake_word.h"
 
 class AfeWakeWord : public WakeWord {
 public:
     AfeWakeWord();
-    ~AfeWakeWord();
+    virtual ~AfeWakeWord();
 
-    bool Initialize(AudioCodec* codec, srmodel_list_t* models_list);
+    virtual bool Initialize(AudioCodec* codec, srmodel_list_t* models_list);
     void Feed(const std::vector<int16_t>& data);
     void OnWakeWordDetected(std::function<void(const std::string& wake_word)> callback);
     void Start();
@@ -34,8 +37,11 @@ public:
     bool GetWakeWordOpus(std::vector<uint8_t>& opus);
     const std::string& GetLastDetectedWakeWord() const { return last_detected_wake_word_; }
 
-private:
+protected:
     srmodel_list_t *models_ = nullptr;
+    // 模型列表是自己初始化的才负责释放；外部传入的归 Assets 管
+    bool owns_models_ = false;
+    bool detection_task_started_ = false;
     const esp_afe_sr_iface_t* afe_iface_ = nullptr;
     esp_afe_sr_data_t* afe_data_ = nullptr;
     char* wakenet_model_ = NULL;
@@ -45,16 +51,19 @@ private:
     AudioCodec* codec_ = nullptr;
     std::string last_detected_wake_word_;
 
-    TaskHandle_t wake_word_encode_task_ = nullptr;
-    StaticTask_t* wake_word_encode_task_buffer_ = nullptr;
-    StackType_t* wake_word_encode_task_stack_ = nullptr;
-    std::deque<std::vector<int16_t>> wake_word_pcm_;
+    std::unique_ptr<OpusEncoderWrapper> preroll_encoder_;
     std::deque<std::vector<uint8_t>> wake_word_opus_;
     std::mutex wake_word_mutex_;
     std::condition_variable wake_word_cv_;
 
     void StoreWakeWordData(const int16_t* data, size_t size);
     void AudioDetectionTask();
+    /* 请求检测任务退出并阻塞等它落地；幂等。派生类析构要先调用，
+     * 避免任务在派生部分已销毁后还经虚函数回来 */
+    void StopDetectionTask();
+    /* Called for every AFE fetch result on the detection task; subclasses
+     * can run additional detectors on the same AFE-cleaned audio */
+    virtual void ProcessFetchResult(const afe_fetch_result_t* res);
 };
 
 #endif
@@ -0,0 +1,150 @@
+#include "combined_wake_word.h"
+#include "assets.h"
+
+#include <esp_log.h>
+#include <esp_mn_speech_commands.h>
+#include <cJSON.h>
+
+#define TAG "CombinedWakeWord"
+
+
+CombinedWakeWord::~CombinedWakeWord() {
+    // 检测任务还在经虚函数调 ProcessFetchResult，先退住它再销毁 multinet
+    StopDetectionTask();
+    if (multinet_model_data_ != nullptr && multinet_ != nullptr) {
+        multinet_->destroy(multinet_model_data_);
+        multinet_model_data_ = nullptr;
+    }
+}
+
+void CombinedWakeWord::ParseMultinetConfig() {
+    // Read index.json
+    auto& assets = Assets::GetInstance();
+    void* ptr = nullptr;
+    size_t size = 0;
+    if (!assets.GetAssetData("index.json", ptr, size)) {
+        ESP_LOGE(TAG, "Failed to read index.json");
+        return;
+    }
+    cJSON* root = cJSON_ParseWithLength(static_cast<char*>(ptr), size);
+    if (root == nullptr) {
+        ESP_LOGE(TAG, "Failed to parse index.json");
+        return;
+    }
+    cJSON* multinet_model = cJSON_GetObjectItem(root, "multinet_model");
+    if (cJSON_IsObject(multinet_model)) {
+        cJSON* language = cJSON_GetObjectItem(multinet_model, "language");
+        cJSON* duration = cJSON_GetObjectItem(multinet_model, "duration");
+        cJSON* threshold = cJSON_GetObjectItem(multinet_model, "threshold");
+        cJSON* commands = cJSON_GetObjectItem(multinet_model, "commands");
+        if (cJSON_IsString(language)) {
+            language_ = language->valuestring;
+        }
+        if (cJSON_IsNumber(duration)) {
+            duration_ = duration->valueint;
+        }
+        if (cJSON_IsNumber(threshold)) {
+            threshold_ = threshold->valuedouble;
+        }
+        if (cJSON_IsArray(commands)) {
+            for (int i = 0; i < cJSON_GetArraySize(commands); i++) {
+                cJSON* command = cJSON_GetArrayItem(commands, i);
+                if (cJSON_IsObject(command)) {
+                    cJSON* command_name = cJSON_GetObjectItem(command, "command");
+                    cJSON* text = cJSON_GetObjectItem(command, "text");
+                    cJSON* action = cJSON_GetObjectItem(command, "action");
+                    if (cJSON_IsString(command_name) && cJSON_IsString(text) && cJSON_IsString(action)) {
+                        commands_.push_back({command_name->valuestring, text->valuestring, action->valuestring});
+                        ESP_LOGI(TAG, "Command: %s, Text: %s, Action: %s", command_name->valuestring, text->valuestring, action->valuestring);
+                    }
+                }
+            }
+        }
+    }
+    cJSON_Delete(root);
+}
+
+bool CombinedWakeWord::Initialize(AudioCodec* codec, srmodel_list_t* models_list) {
+    /* Shared AFE frontend, wakenet and preroll encoding */
+    if (!AfeWakeWord::Initialize(codec, models_list)) {
+        return false;
+    }
+
+    commands_.clear();
+    if (models_list == nullptr) {
+#ifdef CONFIG_CUSTOM_WAKE_WORD
+        threshold_ = CONFIG_CUSTOM_WAKE_WORD_THRESHOLD / 100.0f;
+        commands_.push_back({CONFIG_CUSTOM_WAKE_WORD, CONFIG_CUSTOM_WAKE_WORD_DISPLAY, "wake"});
+#endif
+    } else {
+        ParseMultinetConfig();
+    }
+
+    mn_name_ = esp_srmodel_filter(models_, ESP_MN_PREFIX, language_.c_str());
+    if (mn_name_ == nullptr) {
+        ESP_LOGW(TAG, "Language '%s' multinet not found, falling back to any multinet model", language_.c_str());
+        mn_name_ = esp_srmodel_filter(models_, ESP_MN_PREFIX, NULL);
+    }
+    if (mn_name_ == nullptr) {
+        /* Brand wake word keeps working without the custom keywords */
+        ESP_LOGW(TAG, "No multinet model found, running wakenet only");
+        return true;
+    }
+
+    multinet_ = esp_mn_handle_from_name(mn_name_);
+    multinet_model_data_ = multinet_->create(mn_name_, duration_);
+    multinet_->set_det_threshold(multinet_model_data_, threshold_);
+    esp_mn_commands_clear();
+    for (int i = 0; i < commands_.size(); i++) {
+        esp_mn_commands_add(i + 1, commands_[i].command.c_str());
+    }
+    esp_mn_commands_update();
+
+    multinet_->print_active_speech_commands(multinet_model_data_);
+    return true;
+}
+
+void CombinedWakeWord::ProcessFetchResult(const afe_fetch_result_t* res) {
+    /* Wakenet first: it runs inside the AFE on the other core, so this
+     * only inspects the result */
+    AfeWakeWord::ProcessFetchResult(res);
+
+    if (multinet_model_data_ == nullptr) {
+        return;
+    }
+
+    /* Multinet consumes the AFE output chunk as-is: both run at 16 kHz
+     * mono and the chunk sizes match for the shipped models */
+    size_t samples = res->data_size / sizeof(int16_t);
+    if ((int)samples != multinet_->get_samp_chunksize(multinet_model_data_)) {
+        if (!chunk_size_warned_) {
+            chunk_size_warned_ = true;
+            ESP_LOGW(TAG, "AFE fetch size %u != multinet chunk size %d, custom keywords disabled",
+                (unsigned)samples, multinet_->get_samp_chunksize(multinet_model_data_));
+        }
+        return;
+    }
+
+    esp_mn_state_t mn_state = multinet_->detect(multinet_model_data_, const_cast<int16_t*>(res->data));
+    if (mn_state == ESP_MN_STATE_DETECTED) {
+        esp_mn_results_t* mn_result = multinet_->get_results(multinet_model_data_);
+        for (int i = 0; i < mn_result->num; i++) {
+            ESP_LOGI(TAG, "Custom wake word detected: command_id=%d, string=%s, prob=%f",
+                    mn_result->command_id[i], mn_result->string, mn_result->prob[i]);
+            auto& command = commands_[mn_result->command_id[i] - 1];
+            if (command.action == "wake") {
+                Stop();
+                last_detected_wake_word_ = command.text;
+
+                if (wake_word_detected_callback_) {
+                    wake_word_detected_callback_(last_detected_wake_word_);
+                }
+                break;
+            }
+        }
+        multinet_->clean(multinet_model_data_);
+    } else if (mn_state == ESP_MN_STATE_TIMEOUT) {
+        ESP_LOGD(TAG, "Command word detection timeout, cleaning state");
+        multinet_->clean(multinet_model_data_);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef COMBINED_WAKE_WORD_H
+#define COMBINED_WAKE_WORD_H
+
+#include <esp_mn_iface.h>
+#include <esp_mn_models.h>
+
+#include <deque>
+#include <string>
+
+#include "afe_wake_word.h"
+
+/*
+ * Runs the wakenet brand wake word and multinet custom keywords off one
+ * shared AFE frontend. The AFE feed/fetch pipeline (and its preroll
+ * encoder) comes from AfeWakeWord; the multinet detector consumes the
+ * same AFE-cleaned fetch output on the detection task, which is pinned
+ * to the opposite core from the AFE internal tasks. Whichever model
+ * fires first reports through the common OnWakeWordDetected callback.
+ */
+class CombinedWakeWord final : public AfeWakeWord {
+public:
+    ~CombinedWakeWord();
+
+    bool Initialize(AudioCodec* codec, srmodel_list_t* models_list) override;
+
+protected:
+    void ProcessFetchResult(const afe_fetch_result_t* res) override;
+
+private:
+    struct Command {
+        std::string command;
+        std::string text;
+        std::string action;
+    };
+
+    esp_mn_iface_t* multinet_ = nullptr;
+    model_iface_data_t* multinet_model_data_ = nullptr;
+    char* mn_name_ = nullptr;
+    std::string language_ = "cn";
+    int duration_ = 3000;
+    float threshold_ = 0.2;
+    std::deque<Command> commands_;
+    bool chunk_size_warned_ = false;
+
+    void ParseMultinetConfig();
+};
+
+#endif // COMBINED_WAKE_WORD_H
@@ -15,9 +15,10 @@
 #include <atomic>
 
 #include "audio_codec.h"
+#include "static_task.h"
 #include "wake_word.h"
 
-class CustomWakeWord : public WakeWord {
+class CustomWakeWord final : public WakeWord {
 public:
     CustomWakeWord();
     ~CustomWakeWord();
@@ -43,6 +44,7 @@ private:
     esp_mn_iface_t* multinet_ = nullptr;
     model_iface_data_t* multinet_model_data_ = nullptr;
     srmodel_list_t *models_ = nullptr;
+    bool owns_models_ = false;
     char* mn_name_ = nullptr;
     std::string language_ = "cn";
     int duration_ = 3000;
@@ -55,8 +57,7 @@ private:
     std::atomic<bool> running_ = false;
 
     TaskHandle_t wake_word_encode_task_ = nullptr;
-    StaticTask_t* wake_word_encode_task_buffer_ = nullptr;
-    StackType_t* wake_word_encode_task_stack_ = nullptr;
+    StaticTaskBuffer wake_word_encode_task_buffer_;
     std::deque<std::vector<int16_t>> wake_word_pcm_;
     std::deque<std::vector<uint8_t>> wake_word_opus_;
     std::mutex wake_word_mutex_;
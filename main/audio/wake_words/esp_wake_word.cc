@@ -1,5 +1,8 @@
 #include "esp_wake_word.h"
+#include "boot_profiler.h"
+
 #include <esp_log.h>
+#include <esp_timer.h>
 
 
 #define TAG "EspWakeWord"
@@ -10,15 +13,20 @@ EspWakeWord::EspWakeWord() {
 EspWakeWord::~EspWakeWord() {
     if (wakenet_data_ != nullptr) {
         wakenet_iface_->destroy(wakenet_data_);
+    }
+    // 外部传入的模型列表归 Assets 管，只释放自己初始化的
+    if (owns_models_ && wakenet_model_ != nullptr) {
         esp_srmodel_deinit(wakenet_model_);
     }
 }
 
 bool EspWakeWord::Initialize(AudioCodec* codec, srmodel_list_t* models_list) {
     codec_ = codec;
+    int64_t init_start_us = esp_timer_get_time();
 
     if (models_list == nullptr) {
         wakenet_model_ = esp_srmodel_init("model");
+        owns_models_ = true;
     } else {
         wakenet_model_ = models_list;
     }
@@ -41,6 +49,17 @@ bool EspWakeWord::Initialize(AudioCodec* codec, srmodel_list_t* models_list) {
     int audio_chunksize = wakenet_iface_->get_samp_chunksize(wakenet_data_);
     ESP_LOGI(TAG, "Wake word(%s),freq: %d, chunksize: %d", model_name, frequency, audio_chunksize);
 
+    // 预热：喂一帧静音，沿真实推理路径把整套权重拉过 flash cache。
+    // 权重 mmap 在 assets 分区里，不预热的话首次唤醒要现场缺页加载，
+    // 开机头几秒漏检就是这么来的
+    {
+        BootSpan span("wakenet_warmup");
+        std::vector<int16_t> silence(audio_chunksize, 0);
+        wakenet_iface_->detect(wakenet_data_, silence.data());
+    }
+    ESP_LOGI(TAG, "Wakenet ready in %d ms (warm-up included)",
+             (int)((esp_timer_get_time() - init_start_us) / 1000));
+
     return true;
 }
 
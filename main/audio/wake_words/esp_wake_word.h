@@ -13,7 +13,7 @@
 #include "audio_codec.h"
 #include "wake_word.h"
 
-class EspWakeWord : public WakeWord {
+class EspWakeWord final : public WakeWord {
 public:
     EspWakeWord();
     ~EspWakeWord();
@@ -32,6 +32,7 @@ private:
     esp_wn_iface_t *wakenet_iface_ = nullptr;
     model_iface_data_t *wakenet_data_ = nullptr;
     srmodel_list_t *wakenet_model_ = nullptr;
+    bool owns_models_ = false;
     AudioCodec* codec_ = nullptr;
     std::atomic<bool> running_ = false;
 
@@ -52,6 +52,10 @@ AdcBatteryMonitor::AdcBatteryMonitor(adc_unit_t adc_unit, adc_channel_t adc_chan
     };
     ESP_ERROR_CHECK(esp_timer_create(&timer_cfg, &timer_handle_));
     ESP_ERROR_CHECK(esp_timer_start_periodic(timer_handle_, 1000000));
+
+    // 先采一笔做缓存种子，之后 getter 不再触发任何转换
+    is_charging_ = ReadChargingState();
+    CheckBatteryStatus();
 }
 
 AdcBatteryMonitor::~AdcBatteryMonitor() {
@@ -65,7 +69,7 @@ AdcBatteryMonitor::~AdcBatteryMonitor() {
     }
 }
 
-bool AdcBatteryMonitor::IsCharging() {
+bool AdcBatteryMonitor::ReadChargingState() {
     // 优先使用adc_battery_estimation库的功能
     if (adc_battery_estimation_handle_ != nullptr) {
         bool is_charging = false;
@@ -74,31 +78,29 @@ bool AdcBatteryMonitor::IsCharging() {
             return is_charging;
         }
     }
-    
+
     // 回退到GPIO读取或返回默认值
     if (charging_pin_ != GPIO_NUM_NC) {
         return gpio_get_level(charging_pin_) == 1;
     }
-    
+
     return false;
 }
 
+bool AdcBatteryMonitor::IsCharging() {
+    return is_charging_;
+}
+
 bool AdcBatteryMonitor::IsDischarging() {
-    return !IsCharging();
+    return !is_charging_;
 }
 
 uint8_t AdcBatteryMonitor::GetBatteryLevel() {
-    // 如果句柄无效，返回默认值
-    if (adc_battery_estimation_handle_ == nullptr) {
+    // 纯内存查询；采样与平滑都在 CheckBatteryStatus 的周期节拍里完成
+    if (filtered_capacity_ < 0) {
         return 100;
     }
-    
-    float capacity = 0;
-    esp_err_t err = adc_battery_estimation_get_capacity(adc_battery_estimation_handle_, &capacity);
-    if (err != ESP_OK) {
-        return 100; // 出错时返回默认值
-    }
-    return (uint8_t)capacity;
+    return (uint8_t)(filtered_capacity_ + 0.5f);
 }
 
 void AdcBatteryMonitor::OnChargingStatusChanged(std::function<void(bool)> callback) {
@@ -106,11 +108,23 @@ void AdcBatteryMonitor::OnChargingStatusChanged(std::function<void(bool)> callba
 }
 
 void AdcBatteryMonitor::CheckBatteryStatus() {
-    bool new_charging_status = IsCharging();
+    bool new_charging_status = ReadChargingState();
     if (new_charging_status != is_charging_) {
         is_charging_ = new_charging_status;
         if (on_charging_status_changed_) {
             on_charging_status_changed_(is_charging_);
         }
     }
+
+    // 每秒一笔转换喂给一阶 IIR（1/8 步进），电压毛刺被滤掉，显示不跳变
+    if (adc_battery_estimation_handle_ != nullptr) {
+        float capacity = 0;
+        if (adc_battery_estimation_get_capacity(adc_battery_estimation_handle_, &capacity) == ESP_OK) {
+            if (filtered_capacity_ < 0) {
+                filtered_capacity_ = capacity;
+            } else {
+                filtered_capacity_ += (capacity - filtered_capacity_) / 8.0f;
+            }
+        }
+    }
 }
\ No newline at end of file
@@ -6,6 +6,14 @@
 #include <adc_battery_estimation.h>
 #include <esp_timer.h>
 
+/*
+ * Battery monitoring over an ADC voltage divider. All sampling happens on the
+ * periodic monitor tick: one conversion burst per second feeds an IIR filter,
+ * and the getters are pure RAM lookups. Spreading the conversions out (and
+ * never issuing them from the status-bar path, which used to cluster several
+ * bursts together) also removes the audible ticks on boards where the ADC
+ * shares a sensitive rail with I2S.
+ */
 class AdcBatteryMonitor {
 public:
     AdcBatteryMonitor(adc_unit_t adc_unit, adc_channel_t adc_channel, float upper_resistor, float lower_resistor, gpio_num_t charging_pin = GPIO_NUM_NC);
@@ -22,8 +30,11 @@ private:
     adc_battery_estimation_handle_t adc_battery_estimation_handle_ = nullptr;
     esp_timer_handle_t timer_handle_ = nullptr;
     bool is_charging_ = false;
+    // IIR 平滑后的电量缓存；-1 表示还没有第一笔采样
+    float filtered_capacity_ = -1.0f;
     std::function<void(bool)> on_charging_status_changed_;
 
+    bool ReadChargingState();
     void CheckBatteryStatus();
 };
 
@@ -1,7 +1,9 @@
 #include "afsk_demod.h"
 #include <cstring>
 #include <algorithm>
+#include <limits>
 #include "esp_log.h"
+#include "esp_dsp.h"
 #include "display.h"
 
 #ifndef M_PI
@@ -115,57 +117,33 @@ namespace audio_wifi_config
     // FrequencyDetector implementation
     FrequencyDetector::FrequencyDetector(float frequency, size_t window_size)
         : frequency_(frequency), window_size_(window_size) {
-        frequency_bin_ = std::floor(frequency_ * static_cast<float>(window_size_));
-        angular_frequency_ = 2.0f * M_PI * frequency_;
-        cos_coefficient_ = std::cos(angular_frequency_);
-        sin_coefficient_ = std::sin(angular_frequency_);
-        filter_coefficient_ = 2.0f * cos_coefficient_;
-
-        // Initialize state buffer
-        state_buffer_.push_back(0.0f);
-        state_buffer_.push_back(0.0f);
-    }
-
-    void FrequencyDetector::Reset() {
-        state_buffer_.clear();
-        state_buffer_.push_back(0.0f);
-        state_buffer_.push_back(0.0f);
-    }
-
-    void FrequencyDetector::ProcessSample(float sample) {
-        if (state_buffer_.size() < 2) {
-            return;
+        float angular_frequency = 2.0f * M_PI * frequency_;
+        cos_table_.resize(window_size_);
+        sin_table_.resize(window_size_);
+        for (size_t n = 0; n < window_size_; ++n) {
+            cos_table_[n] = std::cos(angular_frequency * static_cast<float>(n));
+            sin_table_[n] = std::sin(angular_frequency * static_cast<float>(n));
         }
-
-        float s_minus_2 = state_buffer_.front();  // S[-2]
-        state_buffer_.pop_front();
-        float s_minus_1 = state_buffer_.front();  // S[-1]
-        state_buffer_.pop_front();
-
-        float s_current = sample + filter_coefficient_ * s_minus_1 - s_minus_2;
-
-        state_buffer_.push_back(s_minus_1);  // Put S[-1] back
-        state_buffer_.push_back(s_current);  // Add new S[0]
     }
 
-    float FrequencyDetector::GetAmplitude() const {
-        if (state_buffer_.size() < 2) {
-            return 0.0f;
-        }
+    float FrequencyDetector::MeasureBlock(const float *samples, size_t count) const {
+        count = std::min(count, window_size_);
 
-        float s_minus_1 = state_buffer_[1];                      // S[-1]
-        float s_minus_2 = state_buffer_[0];                      // S[-2]
-        float real_part = cos_coefficient_ * s_minus_1 - s_minus_2;  // Real part
-        float imaginary_part = sin_coefficient_ * s_minus_1;         // Imaginary part
+        // Correlate the block against the reference vectors: two dot
+        // products give the real/imaginary parts of the DFT bin directly
+        float real_part = 0.0f;
+        float imaginary_part = 0.0f;
+        dsps_dotprod_f32(samples, cos_table_.data(), &real_part, count);
+        dsps_dotprod_f32(samples, sin_table_.data(), &imaginary_part, count);
 
-        return std::sqrt(real_part * real_part + imaginary_part * imaginary_part) / 
+        return std::sqrt(real_part * real_part + imaginary_part * imaginary_part) /
                (static_cast<float>(window_size_) / 2.0f);
     }
 
     // AudioSignalProcessor implementation
     AudioSignalProcessor::AudioSignalProcessor(size_t sample_rate, size_t mark_frequency, size_t space_frequency,
                                              size_t bit_rate, size_t window_size)
-        : input_buffer_size_(window_size), output_sample_count_(0) {
+        : input_buffer_size_(window_size), next_start_(0) {
         if (sample_rate % bit_rate != 0) {
             // On ESP32 we can continue execution, but log the error
             ESP_LOGW(kLogTag, "Sample rate %zu is not divisible by bit rate %zu", sample_rate, bit_rate);
@@ -182,37 +160,28 @@ namespace audio_wifi_config
 
     std::vector<float> AudioSignalProcessor::ProcessAudioSamples(const std::vector<float> &samples) {
         std::vector<float> result;
+        stream_.insert(stream_.end(), samples.begin(), samples.end());
+
+        // One analysis window per bit period, evaluated over contiguous
+        // memory; mark and space are measured on the same block so it stays
+        // in cache across both dot products
+        while (stream_.size() >= next_start_ + input_buffer_size_) {
+            const float *block = stream_.data() + next_start_;
+            float mark_amplitude = mark_detector_->MeasureBlock(block, input_buffer_size_);
+            float space_amplitude = space_detector_->MeasureBlock(block, input_buffer_size_);
+
+            // Avoid division by zero
+            float mark_probability = mark_amplitude /
+                                   (space_amplitude + mark_amplitude + std::numeric_limits<float>::epsilon());
+            result.push_back(mark_probability);
+            next_start_ += samples_per_bit_;
+        }
 
-        for (float sample : samples) {
-            if (input_buffer_.size() < input_buffer_size_) {
-                input_buffer_.push_back(sample);  // Just add, don't process yet
-            } else {
-                // Input buffer is full, process the data
-                input_buffer_.pop_front();   // Remove oldest sample
-                input_buffer_.push_back(sample);  // Add new sample
-                output_sample_count_++;
-
-                if (output_sample_count_ >= samples_per_bit_) {
-                    // Process all samples in the window using Goertzel algorithm
-                    for (float window_sample : input_buffer_) {
-                        mark_detector_->ProcessSample(window_sample);
-                        space_detector_->ProcessSample(window_sample);
-                    }
-
-                    float mark_amplitude = mark_detector_->GetAmplitude();   // Mark amplitude
-                    float space_amplitude = space_detector_->GetAmplitude(); // Space amplitude
-
-                    // Avoid division by zero
-                    float mark_probability = mark_amplitude / 
-                                           (space_amplitude + mark_amplitude + std::numeric_limits<float>::epsilon());
-                    result.push_back(mark_probability);
-
-                    // Reset detector windows
-                    mark_detector_->Reset();
-                    space_detector_->Reset();
-                    output_sample_count_ = 0;  // Reset output counter
-                }
-            }
+        // Drop samples no later window can reference
+        size_t consumed = std::min(next_start_, stream_.size());
+        if (consumed > 0) {
+            stream_.erase(stream_.begin(), stream_.begin() + consumed);
+            next_start_ -= consumed;
         }
 
         return result;
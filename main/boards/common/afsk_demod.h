@@ -23,20 +23,19 @@ namespace audio_wifi_config
                                          size_t input_channels = 1);
 
     /**
-     * Goertzel algorithm implementation for single frequency detection
-     * Used to detect specific audio frequencies in the AFSK demodulation process
+     * Single frequency detector for the AFSK demodulation process.
+     * Measures one DFT bin over a contiguous sample block as two esp-dsp
+     * dot products against precomputed cos/sin reference vectors, which
+     * vectorizes on targets with SIMD support. Equivalent to the Goertzel
+     * recurrence previously used, without the per-sample state shuffling.
      */
     class FrequencyDetector
     {
     private:
         float frequency_;              // Target frequency (normalized, i.e., f / fs)
         size_t window_size_;           // Window size for analysis
-        float frequency_bin_;          // Frequency bin
-        float angular_frequency_;      // Angular frequency
-        float cos_coefficient_;        // cos(w)
-        float sin_coefficient_;        // sin(w)
-        float filter_coefficient_;     // 2 * cos(w)
-        std::deque<float> state_buffer_;  // Circular buffer for storing S[-1] and S[-2]
+        std::vector<float> cos_table_; // cos(w * n) reference vector
+        std::vector<float> sin_table_; // sin(w * n) reference vector
 
     public:
         /**
@@ -47,21 +46,12 @@ namespace audio_wifi_config
         FrequencyDetector(float frequency, size_t window_size);
 
         /**
-         * Reset the detector state
-         */
-        void Reset();
-
-        /**
-         * Process one audio sample
-         * @param sample Input audio sample
-         */
-        void ProcessSample(float sample);
-
-        /**
-         * Calculate current amplitude
+         * Measure the amplitude of the target frequency over one block
+         * @param samples Contiguous sample block
+         * @param count Number of samples (clamped to the window size)
          * @return Amplitude value
          */
-        float GetAmplitude() const;
+        float MeasureBlock(const float *samples, size_t count) const;
     };
 
     /**
@@ -71,9 +61,9 @@ namespace audio_wifi_config
     class AudioSignalProcessor
     {
     private:
-        std::deque<float> input_buffer_;             // Input sample buffer
-        size_t input_buffer_size_;                   // Input buffer size = window size
-        size_t output_sample_count_;                 // Output sample counter
+        std::vector<float> stream_;                  // Contiguous buffer of pending samples
+        size_t input_buffer_size_;                   // Analysis window size
+        size_t next_start_;                          // Start index of the next analysis window
         size_t samples_per_bit_;                     // Samples per bit threshold
         std::unique_ptr<FrequencyDetector> mark_detector_;   // Mark frequency detector
         std::unique_ptr<FrequencyDetector> space_detector_;  // Space frequency detector
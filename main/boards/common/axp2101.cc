@@ -1,37 +1,120 @@
 #include "axp2101.h"
 #include "board.h"
 #include "display.h"
+#include "status_event.h"
 
 #include <esp_log.h>
+#include <esp_timer.h>
 
 #define TAG "Axp2101"
 
+namespace {
+// 无 IRQ 时的节流间隔：状态栏 10 秒读一轮，5 秒的缓存不会让显示变迟钝
+constexpr int64_t kThrottleUs = 5 * 1000000LL;
+// 有 IRQ 时只留一个粗粒度的兜底刷新
+constexpr int64_t kCoarseRefreshUs = 60 * 1000000LL;
+}
+
 Axp2101::Axp2101(i2c_master_bus_handle_t i2c_bus, uint8_t addr) : I2cDevice(i2c_bus, addr) {
+    // 同步读一次做缓存种子，之后都走总线 worker 的异步批量刷新
+    uint8_t status = ReadReg(0x01);
+    uint8_t soc[2];
+    ReadRegs(0xA4, soc, 2);
+    current_direction_ = (status & 0b01100000) >> 5;
+    charging_done_ = (status & 0b00000111) == 0b00000100;
+    battery_level_ = soc[0];
+    temperature_ = soc[1];
+}
+
+void Axp2101::EnableIrq(gpio_num_t irq_gpio) {
+    // 打开电池/充电相关中断源：VBUS 与电池插拔（INTEN2），充电开始/完成
+    // （INTEN3）；状态寄存器写 1 清零，先清掉历史中断避免上电即触发
+    WriteReg(0x41, 0xF0);
+    WriteReg(0x42, 0x0C);
+    WriteReg(0x48, 0xFF);
+    WriteReg(0x49, 0xFF);
+    WriteReg(0x4A, 0xFF);
+
+    gpio_config_t config = {
+        .pin_bit_mask = 1ULL << irq_gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_NEGEDGE,  // IRQ 引脚开漏低有效
+    };
+    ESP_ERROR_CHECK(gpio_config(&config));
+    // 板子其它外设可能已经装好 ISR 服务
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_ERROR_CHECK(err);
+    }
+    ESP_ERROR_CHECK(gpio_isr_handler_add(irq_gpio, [](void* arg) {
+        static_cast<Axp2101*>(arg)->irq_pending_.store(true);
+    }, this));
+    irq_enabled_ = true;
 }
 
-int Axp2101::GetBatteryCurrentDirection() {
-    return (ReadReg(0x01) & 0b01100000) >> 5;
+void Axp2101::RefreshStateAsync() {
+    // 缓存够新且没有中断挂起时完全不碰总线
+    bool irq = irq_pending_.load();
+    int64_t now_us = esp_timer_get_time();
+    if (!irq && now_us - last_refresh_us_ < (irq_enabled_ ? kCoarseRefreshUs : kThrottleUs)) {
+        return;
+    }
+    if (poll_pending_.exchange(true)) {
+        return;
+    }
+    irq_pending_.store(false);
+    // 状态 + 电量/温度共两笔传输，打包成 worker 上的一个低优先级操作，
+    // 不会插在音量写等高优先级事务中间
+    SubmitAsync(I2cBusWorker::kPriorityLow, [this, irq]() {
+        if (irq) {
+            // 清 PMIC 侧的中断状态，让 IRQ 引脚释放
+            WriteReg(0x48, 0xFF);
+            WriteReg(0x49, 0xFF);
+            WriteReg(0x4A, 0xFF);
+        }
+        uint8_t status = ReadReg(0x01);
+        uint8_t soc[2];
+        ReadRegs(0xA4, soc, 2);
+        int old_direction = current_direction_;
+        int old_level = battery_level_;
+        current_direction_ = (status & 0b01100000) >> 5;
+        charging_done_ = (status & 0b00000111) == 0b00000100;
+        battery_level_ = soc[0];
+        temperature_ = soc[1];
+        last_refresh_us_ = esp_timer_get_time();
+        poll_pending_.store(false);
+        // 充放电方向或电量变了才通知状态栏，回调在 worker 任务上执行
+        if (old_direction != current_direction_ || old_level != battery_level_) {
+            StatusEventManager::GetInstance().Publish(StatusEvent::kBattery);
+        }
+    });
 }
 
 bool Axp2101::IsCharging() {
-    return GetBatteryCurrentDirection() == 1;
+    RefreshStateAsync();
+    return current_direction_ == 1;
 }
 
 bool Axp2101::IsDischarging() {
-    return GetBatteryCurrentDirection() == 2;
+    RefreshStateAsync();
+    return current_direction_ == 2;
 }
 
 bool Axp2101::IsChargingDone() {
-    uint8_t value = ReadReg(0x01);
-    return (value & 0b00000111) == 0b00000100;
+    RefreshStateAsync();
+    return charging_done_;
 }
 
 int Axp2101::GetBatteryLevel() {
-    return ReadReg(0xA4);
+    RefreshStateAsync();
+    return battery_level_;
 }
 
 float Axp2101::GetTemperature() {
-    return ReadReg(0xA5);
+    RefreshStateAsync();
+    return temperature_;
 }
 
 void Axp2101::PowerOff() {
@@ -1,6 +1,10 @@
 #ifndef __AXP2101_H__
 #define __AXP2101_H__
 
+#include <atomic>
+
+#include <driver/gpio.h>
+
 #include "i2c_device.h"
 
 class Axp2101 : public I2cDevice {
@@ -13,8 +17,27 @@ public:
     float GetTemperature();
     void PowerOff();
 
+    /* Boards that have the PMIC IRQ line wired can call this once after
+     * construction. Charge/battery state then updates on interrupt plus a
+     * coarse once-a-minute safety refresh, instead of an I2C poll per
+     * status-bar pass. */
+    void EnableIrq(gpio_num_t irq_gpio);
+
 private:
-    int GetBatteryCurrentDirection();
+    /* Getters serve a RAM cache and kick a low-priority batched refresh on
+     * the bus worker, so the status-bar path never blocks on I2C. The cache
+     * is seeded synchronously in the constructor. Refreshes are throttled:
+     * pending IRQ or stale cache, otherwise the getter is RAM-only. */
+    void RefreshStateAsync();
+
+    std::atomic<bool> poll_pending_{false};
+    std::atomic<bool> irq_pending_{false};
+    bool irq_enabled_ = false;
+    int64_t last_refresh_us_ = 0;
+    int current_direction_ = 0;
+    bool charging_done_ = false;
+    int battery_level_ = 0;
+    int temperature_ = 0;
 };
 
 #endif
@@ -58,6 +58,13 @@ void Backlight::SetBrightness(uint8_t brightness, bool permanent) {
     }
 
     target_brightness_ = brightness;
+
+    // 有硬件渐变引擎（LEDC fade）的子类整个过渡都不占 CPU
+    if (StartHardwareTransition(brightness)) {
+        ESP_LOGI(TAG, "Set brightness to %d", brightness);
+        return;
+    }
+
     step_ = (target_brightness_ > brightness_) ? 1 : -1;
 
     if (transition_timer_ != nullptr) {
@@ -81,6 +88,42 @@ void Backlight::OnTransitionTimer() {
     }
 }
 
+namespace {
+
+/* Compile-time gamma-2.2 lookup: brightness percent -> 10-bit LEDC duty.
+ * Perceived brightness follows a power law, so a linear duty ramp wastes most
+ * of the control range at the bright end; the corrected curve makes every
+ * percent step look roughly equal. x^2.2 = x^2 * x^(1/5), with the fifth
+ * root evaluated by a constexpr Newton iteration. */
+constexpr double FifthRoot(double x) {
+    if (x <= 0.0) {
+        return 0.0;
+    }
+    double r = 1.0;
+    for (int i = 0; i < 40; i++) {
+        r = r - (r * r * r * r * r - x) / (5.0 * r * r * r * r);
+    }
+    return r;
+}
+
+struct GammaTable {
+    uint16_t duty[101];
+};
+
+constexpr GammaTable BuildGammaTable() {
+    GammaTable table{};
+    for (int percent = 0; percent <= 100; percent++) {
+        double x = percent / 100.0;
+        double y = x * x * FifthRoot(x);
+        table.duty[percent] = (uint16_t)(y * 1023.0 + 0.5);
+    }
+    return table;
+}
+
+constexpr GammaTable kGammaTable = BuildGammaTable();
+
+}  // namespace
+
 PwmBacklight::PwmBacklight(gpio_num_t pin, bool output_invert, uint32_t freq_hz) : Backlight() {
     const ledc_timer_config_t backlight_timer = {
         .speed_mode = LEDC_LOW_SPEED_MODE,
@@ -106,16 +149,40 @@ PwmBacklight::PwmBacklight(gpio_num_t pin, bool output_invert, uint32_t freq_hz)
         }
     };
     ESP_ERROR_CHECK(ledc_channel_config(&backlight_channel));
+
+    // 硬件渐变引擎；fade 结束回调只清标志位，整个过渡零 CPU
+    ESP_ERROR_CHECK(ledc_fade_func_install(0));
+    ledc_cbs_t callbacks = {
+        .fade_cb = [](const ledc_cb_param_t* param, void* user_arg) -> bool {
+            if (param->event == LEDC_FADE_END_EVT) {
+                static_cast<PwmBacklight*>(user_arg)->fade_active_ = false;
+            }
+            return false;
+        },
+    };
+    ESP_ERROR_CHECK(ledc_cb_register(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, &callbacks, this));
 }
 
 PwmBacklight::~PwmBacklight() {
     ledc_stop(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, 0);
 }
 
+bool PwmBacklight::StartHardwareTransition(uint8_t target) {
+    // 保持与原软件渐变相同的节奏：每 1% 约 5ms
+    int duration_ms = (target > brightness_ ? target - brightness_ : brightness_ - target) * 5;
+    if (fade_active_) {
+        ledc_fade_stop(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0);
+    }
+    fade_active_ = true;
+    ESP_ERROR_CHECK(ledc_set_fade_time_and_start(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0,
+        kGammaTable.duty[target], duration_ms, LEDC_FADE_NO_WAIT));
+    brightness_ = target;
+    return true;
+}
+
 void PwmBacklight::SetBrightnessImpl(uint8_t brightness) {
     // LEDC resolution set to 10bits, thus: 100% = 1023
-    uint32_t duty_cycle = (1023 * brightness) / 100;
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, duty_cycle);
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, kGammaTable.duty[brightness]);
     ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0);
 }
 
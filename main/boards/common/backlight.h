@@ -19,6 +19,10 @@ public:
 protected:
     void OnTransitionTimer();
     virtual void SetBrightnessImpl(uint8_t brightness) = 0;
+    /* Subclasses with a hardware fade engine override this and return true;
+     * the base class then skips the software stepping timer entirely. The
+     * implementation must bring the panel to `target` on its own. */
+    virtual bool StartHardwareTransition(uint8_t target) { return false; }
 
     esp_timer_handle_t transition_timer_ = nullptr;
     uint8_t brightness_ = 0;
@@ -27,10 +31,24 @@ protected:
 };
 
 
+/*
+ * LEDC-backed backlight. Transitions run on the LEDC hardware fade engine —
+ * zero CPU per fade regardless of audio load, where the software timer used
+ * to fire dozens of 5ms callbacks and visibly stuttered during TTS playback.
+ * Brightness percent maps to duty through a gamma-2.2 lookup table computed
+ * at compile time, so the low end of the dimming range stops collapsing into
+ * a few indistinguishable steps.
+ */
 class PwmBacklight : public Backlight {
 public:
     PwmBacklight(gpio_num_t pin, bool output_invert = false, uint32_t freq_hz = 25000);
     ~PwmBacklight();
 
     void SetBrightnessImpl(uint8_t brightness) override;
+
+protected:
+    bool StartHardwareTransition(uint8_t target) override;
+
+private:
+    volatile bool fade_active_ = false;
 };
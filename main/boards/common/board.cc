@@ -10,8 +10,51 @@
 #include <esp_chip_info.h>
 #include <esp_random.h>
 
+#include <deque>
+#include <mutex>
+
 #define TAG "Board"
 
+namespace {
+
+const size_t kMaxPooledHttpClients = 2;
+
+struct PooledHttpClient {
+    std::string key;
+    std::unique_ptr<Http> http;
+};
+
+std::mutex http_pool_mutex;
+std::deque<PooledHttpClient> http_pool;
+
+} // namespace
+
+std::unique_ptr<Http> Board::AcquireHttp(const char* pool_key, int connect_id) {
+    {
+        std::lock_guard<std::mutex> lock(http_pool_mutex);
+        for (auto it = http_pool.begin(); it != http_pool.end(); ++it) {
+            if (it->key == pool_key) {
+                auto http = std::move(it->http);
+                http_pool.erase(it);
+                return http;
+            }
+        }
+    }
+    return GetNetwork()->CreateHttp(connect_id);
+}
+
+void Board::ReleaseHttp(const char* pool_key, std::unique_ptr<Http> http) {
+    if (http == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(http_pool_mutex);
+    if (http_pool.size() >= kMaxPooledHttpClients) {
+        // Drop the oldest warm connection to make room
+        http_pool.pop_front();
+    }
+    http_pool.push_back({pool_key, std::move(http)});
+}
+
 Board::Board() {
     Settings settings("board", true);
     uuid_ = settings.GetString("uuid");
@@ -107,70 +150,80 @@ std::string Board::GetSystemInfoJson() {
             }
         }
     */
-    std::string json = R"({"version":2,"language":")" + std::string(Lang::CODE) + R"(",)";
-    json += R"("flash_size":)" + std::to_string(SystemInfo::GetFlashSize()) + R"(,)";
-    json += R"("minimum_free_heap_size":")" + std::to_string(SystemInfo::GetMinimumFreeHeapSize()) + R"(",)";
-    json += R"("mac_address":")" + SystemInfo::GetMacAddress() + R"(",)";
-    json += R"("uuid":")" + uuid_ + R"(",)";
-    json += R"("chip_model_name":")" + SystemInfo::GetChipModelName() + R"(",)";
-
-    esp_chip_info_t chip_info;
-    esp_chip_info(&chip_info);
-    json += R"("chip_info":{)";
-    json += R"("model":)" + std::to_string(chip_info.model) + R"(,)";
-    json += R"("cores":)" + std::to_string(chip_info.cores) + R"(,)";
-    json += R"("revision":)" + std::to_string(chip_info.revision) + R"(,)";
-    json += R"("features":)" + std::to_string(chip_info.features) + R"(},)";
-
-    auto app_desc = esp_app_get_description();
-    json += R"("application":{)";
-    json += R"("name":")" + std::string(app_desc->project_name) + R"(",)";
-    json += R"("version":")" + std::string(app_desc->version) + R"(",)";
-    json += R"("compile_time":")" + std::string(app_desc->date) + R"(T)" + std::string(app_desc->time) + R"(Z",)";
-    json += R"("idf_version":")" + std::string(app_desc->idf_ver) + R"(",)";
-    char sha256_str[65];
-    for (int i = 0; i < 32; i++) {
-        snprintf(sha256_str + i * 2, sizeof(sha256_str) - i * 2, "%02x", app_desc->app_elf_sha256[i]);
-    }
-    json += R"("elf_sha256":")" + std::string(sha256_str) + R"(")";
-    json += R"(},)";
-
-    json += R"("partition_table": [)";
-    esp_partition_iterator_t it = esp_partition_find(ESP_PARTITION_TYPE_ANY, ESP_PARTITION_SUBTYPE_ANY, NULL);
-    while (it) {
-        const esp_partition_t *partition = esp_partition_get(it);
-        json += R"({)";
-        json += R"("label":")" + std::string(partition->label) + R"(",)";
-        json += R"("type":)" + std::to_string(partition->type) + R"(,)";
-        json += R"("subtype":)" + std::to_string(partition->subtype) + R"(,)";
-        json += R"("address":)" + std::to_string(partition->address) + R"(,)";
-        json += R"("size":)" + std::to_string(partition->size) + R"(},)";;
-        it = esp_partition_next(it);
-    }
-    json.pop_back(); // Remove the last comma
-    json += R"(],)";
-
-    json += R"("ota":{)";
-    auto ota_partition = esp_ota_get_running_partition();
-    json += R"("label":")" + std::string(ota_partition->label) + R"(")";
-    json += R"(},)";
-
-    // Append display info
-    auto display = GetDisplay();
-    if (display) {
-        json += R"("display":{)";
-        if (dynamic_cast<OledDisplay*>(display)) {
-            json += R"("monochrome":)" + std::string("true") + R"(,)";
-        } else {
-            json += R"("monochrome":)" + std::string("false") + R"(,)";
+    // 不变部分只在首次调用时序列化：flash/分区枚举和 MAC 读取每次要
+    // 几十毫秒，而结果整个运行期不会变
+    if (system_info_tail_.empty()) {
+        system_info_head_ = R"({"version":2,"language":")" + std::string(Lang::CODE) + R"(",)";
+        system_info_head_ += R"("flash_size":)" + std::to_string(SystemInfo::GetFlashSize()) + R"(,)";
+
+        std::string& json = system_info_tail_;
+        json += R"("mac_address":")" + SystemInfo::GetMacAddress() + R"(",)";
+        json += R"("uuid":")" + uuid_ + R"(",)";
+        json += R"("chip_model_name":")" + SystemInfo::GetChipModelName() + R"(",)";
+
+        esp_chip_info_t chip_info;
+        esp_chip_info(&chip_info);
+        json += R"("chip_info":{)";
+        json += R"("model":)" + std::to_string(chip_info.model) + R"(,)";
+        json += R"("cores":)" + std::to_string(chip_info.cores) + R"(,)";
+        json += R"("revision":)" + std::to_string(chip_info.revision) + R"(,)";
+        json += R"("features":)" + std::to_string(chip_info.features) + R"(},)";
+
+        auto app_desc = esp_app_get_description();
+        json += R"("application":{)";
+        json += R"("name":")" + std::string(app_desc->project_name) + R"(",)";
+        json += R"("version":")" + std::string(app_desc->version) + R"(",)";
+        json += R"("compile_time":")" + std::string(app_desc->date) + R"(T)" + std::string(app_desc->time) + R"(Z",)";
+        json += R"("idf_version":")" + std::string(app_desc->idf_ver) + R"(",)";
+        char sha256_str[65];
+        for (int i = 0; i < 32; i++) {
+            snprintf(sha256_str + i * 2, sizeof(sha256_str) - i * 2, "%02x", app_desc->app_elf_sha256[i]);
+        }
+        json += R"("elf_sha256":")" + std::string(sha256_str) + R"(")";
+        json += R"(},)";
+
+        json += R"("partition_table": [)";
+        esp_partition_iterator_t it = esp_partition_find(ESP_PARTITION_TYPE_ANY, ESP_PARTITION_SUBTYPE_ANY, NULL);
+        while (it) {
+            const esp_partition_t *partition = esp_partition_get(it);
+            json += R"({)";
+            json += R"("label":")" + std::string(partition->label) + R"(",)";
+            json += R"("type":)" + std::to_string(partition->type) + R"(,)";
+            json += R"("subtype":)" + std::to_string(partition->subtype) + R"(,)";
+            json += R"("address":)" + std::to_string(partition->address) + R"(,)";
+            json += R"("size":)" + std::to_string(partition->size) + R"(},)";;
+            it = esp_partition_next(it);
         }
-        json += R"("width":)" + std::to_string(display->width()) + R"(,)";
-        json += R"("height":)" + std::to_string(display->height()) + R"(,)";
         json.pop_back(); // Remove the last comma
+        json += R"(],)";
+
+        json += R"("ota":{)";
+        auto ota_partition = esp_ota_get_running_partition();
+        json += R"("label":")" + std::string(ota_partition->label) + R"(")";
+        json += R"(},)";
+
+        // Append display info
+        auto display = GetDisplay();
+        if (display) {
+            json += R"("display":{)";
+            if (dynamic_cast<OledDisplay*>(display)) {
+                json += R"("monochrome":)" + std::string("true") + R"(,)";
+            } else {
+                json += R"("monochrome":)" + std::string("false") + R"(,)";
+            }
+            json += R"("width":)" + std::to_string(display->width()) + R"(,)";
+            json += R"("height":)" + std::to_string(display->height()) + R"(,)";
+            json.pop_back(); // Remove the last comma
+        }
+        json += R"(},)";
+        json += R"("board":)";
     }
-    json += R"(},)";
 
-    json += R"("board":)" + GetBoardJson();
+    // 动态字段每次重新取：最小空闲堆在变，板级 JSON 含 RSSI/IP 等网络状态
+    std::string json = system_info_head_;
+    json += R"("minimum_free_heap_size":")" + std::to_string(SystemInfo::GetMinimumFreeHeapSize()) + R"(",)";
+    json += system_info_tail_;
+    json += GetBoardJson();
 
     // Close the JSON object
     json += R"(})";
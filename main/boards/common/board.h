@@ -5,6 +5,7 @@
 #include <web_socket.h>
 #include <mqtt.h>
 #include <udp.h>
+#include <memory>
 #include <string>
 #include <network_interface.h>
 
@@ -29,6 +30,12 @@ protected:
     // 软件生成的设备唯一标识
     std::string uuid_;
 
+    // GetSystemInfoJson 的不变部分快照：芯片、分区表、应用描述整个运行期
+    // 不会变，首次调用时序列化一次，之后每次只拼接动态字段（最小空闲堆、
+    // 板级网络状态），省掉启动关键路径上的重复枚举
+    std::string system_info_head_;
+    std::string system_info_tail_;
+
 public:
     static Board& GetInstance() {
         static Board* instance = static_cast<Board*>(create_board());
@@ -52,6 +59,24 @@ public:
     virtual void SetPowerSaveMode(bool enabled) = 0;
     virtual std::string GetBoardJson() = 0;
     virtual std::string GetDeviceStatusJson() = 0;
+
+    // 主循环时钟滴答（约 1Hz）调用，板级按需采样无线链路质量；
+    // 无链路质量概念的板子保持空实现即可
+    virtual void SampleRadioQuality() {}
+    // 链路质量遥测 JSON（窗口统计，取走即清零）；无数据返回空串
+    virtual std::string GetRadioTelemetryJson() { return ""; }
+
+    /*
+     * Pooled HTTP clients, keyed by call site ("ota", "assets", ...).
+     * Releasing a client after a completed request keeps the underlying
+     * connection and its TLS session warm, so the next request to the same
+     * endpoint can skip the full TCP + TLS handshake. Clients are only
+     * reused under the same key, so headers set by one subsystem never
+     * leak into another's requests. Callers that fail mid-request should
+     * just let the client destruct instead of releasing it.
+     */
+    std::unique_ptr<Http> AcquireHttp(const char* pool_key, int connect_id = 0);
+    void ReleaseHttp(const char* pool_key, std::unique_ptr<Http> http);
 };
 
 #define DECLARE_BOARD(BOARD_CLASS_NAME) \
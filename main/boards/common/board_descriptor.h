@@ -0,0 +1,63 @@
+#ifndef BOARD_DESCRIPTOR_H
+#define BOARD_DESCRIPTOR_H
+
+#include <driver/gpio.h>
+
+/**
+ * constexpr 板级描述符。config.h 里的裸宏没有类型也没法做交叉校验，
+ * 把它们聚合成一个 constexpr 对象后：构造函数里引用的都是编译期常量
+ * （和宏同样零开销），引脚/几何之间的约束用 static_assert 在编译期
+ * 拦下来（比如共享 I2S 时钟要求采样率一致），拼错的配置不用烧板子
+ * 就能发现。每板一次构建本来就是全特化，这里把特化收益拿回来。
+ *
+ * 迁移是渐进的：新板直接写 kBoard 描述符，老板在动到 config.h 时
+ * 顺手换（见 xingzhi-cube-1.54tft-wifi 的样板用法）。
+ */
+
+struct AudioPinout {
+    gpio_num_t mic_sck = GPIO_NUM_NC;
+    gpio_num_t mic_ws = GPIO_NUM_NC;
+    gpio_num_t mic_din = GPIO_NUM_NC;
+    gpio_num_t spk_bclk = GPIO_NUM_NC;
+    gpio_num_t spk_lrck = GPIO_NUM_NC;
+    gpio_num_t spk_dout = GPIO_NUM_NC;
+};
+
+struct DisplayGeometry {
+    int width = 0;
+    int height = 0;
+    int offset_x = 0;
+    int offset_y = 0;
+    bool swap_xy = false;
+    bool mirror_x = false;
+    bool mirror_y = false;
+};
+
+struct BoardDescriptor {
+    int input_sample_rate = 16000;
+    int output_sample_rate = 24000;
+    AudioPinout audio;
+    DisplayGeometry display;
+
+    // 采集和播放共用一对 BCLK/WS 时（单 I2S 控制器全双工），两个方向
+    // 必然同采样率；NoAudioCodecSimplex 依赖这个判断走共享时钟路径
+    constexpr bool shared_i2s_clock() const {
+        return audio.mic_sck != GPIO_NUM_NC &&
+               audio.mic_sck == audio.spk_bclk && audio.mic_ws == audio.spk_lrck;
+    }
+
+    constexpr bool valid() const {
+        if (input_sample_rate <= 0 || output_sample_rate <= 0) {
+            return false;
+        }
+        if (shared_i2s_clock() && input_sample_rate != output_sample_rate) {
+            return false;
+        }
+        if (display.width < 0 || display.height < 0) {
+            return false;
+        }
+        return true;
+    }
+};
+
+#endif // BOARD_DESCRIPTOR_H
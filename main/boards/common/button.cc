@@ -1,4 +1,5 @@
 #include "button.h"
+#include "button_engine.h"
 
 #include <button_gpio.h>
 #include <esp_log.h>
@@ -22,6 +23,14 @@ Button::Button(gpio_num_t gpio_num, bool active_high, uint16_t long_press_time,
     if (gpio_num == GPIO_NUM_NC) {
         return;
     }
+#if CONFIG_USE_BUTTON_ENGINE
+    engine_slot_ = ButtonEngine::GetInstance().Register(this, gpio_num, active_high,
+                                                        long_press_time, short_press_time, enable_power_save);
+    if (engine_slot_ >= 0) {
+        return;
+    }
+    // 槽位满了退回 iot_button，行为不变
+#endif
     button_config_t button_config = {
         .long_press_time = long_press_time,
         .short_press_time = short_press_time
@@ -36,16 +45,22 @@ Button::Button(gpio_num_t gpio_num, bool active_high, uint16_t long_press_time,
 }
 
 Button::~Button() {
+#if CONFIG_USE_BUTTON_ENGINE
+    if (engine_slot_ >= 0) {
+        ButtonEngine::GetInstance().Unregister(engine_slot_);
+    }
+#endif
     if (button_handle_ != NULL) {
         iot_button_delete(button_handle_);
     }
 }
 
 void Button::OnPressDown(std::function<void()> callback) {
+    // 引擎路径（engine_slot_ >= 0）直接读成员，存下即生效
+    on_press_down_ = callback;
     if (button_handle_ == nullptr) {
         return;
     }
-    on_press_down_ = callback;
     iot_button_register_cb(button_handle_, BUTTON_PRESS_DOWN, nullptr, [](void* handle, void* usr_data) {
         Button* button = static_cast<Button*>(usr_data);
         if (button->on_press_down_) {
@@ -55,10 +70,10 @@ void Button::OnPressDown(std::function<void()> callback) {
 }
 
 void Button::OnPressUp(std::function<void()> callback) {
+    on_press_up_ = callback;
     if (button_handle_ == nullptr) {
         return;
     }
-    on_press_up_ = callback;
     iot_button_register_cb(button_handle_, BUTTON_PRESS_UP, nullptr, [](void* handle, void* usr_data) {
         Button* button = static_cast<Button*>(usr_data);
         if (button->on_press_up_) {
@@ -68,10 +83,10 @@ void Button::OnPressUp(std::function<void()> callback) {
 }
 
 void Button::OnLongPress(std::function<void()> callback) {
+    on_long_press_ = callback;
     if (button_handle_ == nullptr) {
         return;
     }
-    on_long_press_ = callback;
     iot_button_register_cb(button_handle_, BUTTON_LONG_PRESS_START, nullptr, [](void* handle, void* usr_data) {
         Button* button = static_cast<Button*>(usr_data);
         if (button->on_long_press_) {
@@ -81,10 +96,10 @@ void Button::OnLongPress(std::function<void()> callback) {
 }
 
 void Button::OnClick(std::function<void()> callback) {
+    on_click_ = callback;
     if (button_handle_ == nullptr) {
         return;
     }
-    on_click_ = callback;
     iot_button_register_cb(button_handle_, BUTTON_SINGLE_CLICK, nullptr, [](void* handle, void* usr_data) {
         Button* button = static_cast<Button*>(usr_data);
         if (button->on_click_) {
@@ -94,10 +109,10 @@ void Button::OnClick(std::function<void()> callback) {
 }
 
 void Button::OnDoubleClick(std::function<void()> callback) {
+    on_double_click_ = callback;
     if (button_handle_ == nullptr) {
         return;
     }
-    on_double_click_ = callback;
     iot_button_register_cb(button_handle_, BUTTON_DOUBLE_CLICK, nullptr, [](void* handle, void* usr_data) {
         Button* button = static_cast<Button*>(usr_data);
         if (button->on_double_click_) {
@@ -107,10 +122,11 @@ void Button::OnDoubleClick(std::function<void()> callback) {
 }
 
 void Button::OnMultipleClick(std::function<void()> callback, uint8_t click_count) {
+    on_multiple_click_ = callback;
+    multiple_click_count_ = click_count;
     if (button_handle_ == nullptr) {
         return;
     }
-    on_multiple_click_ = callback;
     button_event_args_t event_args = {
         .multiple_clicks = {
             .clicks = click_count
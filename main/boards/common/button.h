@@ -22,8 +22,14 @@ public:
     void OnMultipleClick(std::function<void()> callback, uint8_t click_count = 3);
 
 protected:
+    friend class ButtonEngine;
+
     gpio_num_t gpio_num_;
     button_handle_t button_handle_ = nullptr;
+    // CONFIG_USE_BUTTON_ENGINE 时 GPIO 按键走共享状态机（见
+    // button_engine.h），此处记录槽位；ADC 按键始终走 iot_button
+    int engine_slot_ = -1;
+    uint8_t multiple_click_count_ = 3;
 
     std::function<void()> on_press_down_;
     std::function<void()> on_press_up_;
@@ -0,0 +1,240 @@
+#include "button_engine.h"
+
+#if CONFIG_USE_BUTTON_ENGINE
+
+#include "button.h"
+#include "task_registry.h"
+
+#include <esp_log.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <soc/soc_caps.h>
+
+#define TAG "ButtonEngine"
+
+namespace {
+// iot_button 的默认判定时间，保持行为一致
+constexpr int64_t kDefaultLongPressUs = 1500 * 1000;
+}
+
+int ButtonEngine::Register(Button* owner, gpio_num_t gpio_num, bool active_high,
+                           uint16_t long_press_ms, uint16_t short_press_ms, bool enable_power_save) {
+    (void)short_press_ms;
+    int slot_index = -1;
+    for (int i = 0; i < kMaxButtons; i++) {
+        if (slots_[i].owner == nullptr) {
+            slot_index = i;
+            break;
+        }
+    }
+    if (slot_index < 0) {
+        ESP_LOGW(TAG, "No free slot for GPIO %d", gpio_num);
+        return -1;
+    }
+
+    auto& slot = slots_[slot_index];
+    slot.gpio_num = gpio_num;
+    slot.active_high = active_high;
+    slot.long_press_us = long_press_ms > 0 ? (int64_t)long_press_ms * 1000 : kDefaultLongPressUs;
+    slot.state = State::kIdle;
+    slot.deadline_us = 0;
+    slot.click_count = 0;
+
+    gpio_config_t io_config = {
+        .pin_bit_mask = 1ULL << gpio_num,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = active_high ? GPIO_PULLUP_DISABLE : GPIO_PULLUP_ENABLE,
+        .pull_down_en = active_high ? GPIO_PULLDOWN_ENABLE : GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_ANYEDGE,
+    };
+    ESP_ERROR_CHECK(gpio_config(&io_config));
+
+#if SOC_GPIO_SUPPORT_PIN_GLITCH_FILTER
+    // 两个时钟周期以内的毛刺直接在管脚上挡掉，抖动根本到不了中断
+    gpio_pin_glitch_filter_config_t filter_config = {
+        .clk_src = GLITCH_FILTER_CLK_SRC_DEFAULT,
+        .gpio_num = gpio_num,
+    };
+    if (gpio_new_pin_glitch_filter(&filter_config, &slot.glitch_filter) == ESP_OK) {
+        gpio_glitch_filter_enable(slot.glitch_filter);
+    }
+#endif
+
+    if (enable_power_save) {
+        gpio_wakeup_enable(gpio_num, active_high ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+        esp_sleep_enable_gpio_wakeup();
+    }
+
+    EnsureTask();
+
+    // 共享的 ISR 服务可能已被其它驱动装过
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_ERROR_CHECK(err);
+    }
+    ESP_ERROR_CHECK(gpio_isr_handler_add(gpio_num, GpioIsr, this));
+
+    slot.owner = owner;
+    return slot_index;
+}
+
+void ButtonEngine::Unregister(int slot_index) {
+    if (slot_index < 0 || slot_index >= kMaxButtons) {
+        return;
+    }
+    auto& slot = slots_[slot_index];
+    gpio_isr_handler_remove(slot.gpio_num);
+    if (slot.glitch_filter != nullptr) {
+        gpio_glitch_filter_disable(slot.glitch_filter);
+        gpio_del_glitch_filter(slot.glitch_filter);
+        slot.glitch_filter = nullptr;
+    }
+    slot.owner = nullptr;
+    slot.state = State::kIdle;
+    slot.deadline_us = 0;
+}
+
+void ButtonEngine::EnsureTask() {
+    if (task_handle_ != nullptr) {
+        return;
+    }
+    xTaskCreate([](void* arg) {
+        static_cast<ButtonEngine*>(arg)->EngineTask();
+        vTaskDelete(NULL);
+    }, "button_engine", 3072, this, 3, &task_handle_);
+    TaskRegistry::GetInstance().Register(task_handle_, "button_engine", 3, -1);
+}
+
+void IRAM_ATTR ButtonEngine::GpioIsr(void* arg) {
+    auto engine = static_cast<ButtonEngine*>(arg);
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(engine->task_handle_, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+bool ButtonEngine::IsActive(const Slot& slot) const {
+    return gpio_get_level(slot.gpio_num) == (slot.active_high ? 1 : 0);
+}
+
+void ButtonEngine::EngineTask() {
+    while (true) {
+        // 阻塞到最近的截止点；全部空闲时无限等，不产生任何周期唤醒
+        int64_t next_deadline = 0;
+        for (auto& slot : slots_) {
+            if (slot.owner != nullptr && slot.deadline_us != 0 &&
+                (next_deadline == 0 || slot.deadline_us < next_deadline)) {
+                next_deadline = slot.deadline_us;
+            }
+        }
+        TickType_t wait_ticks = portMAX_DELAY;
+        if (next_deadline != 0) {
+            int64_t delta_us = next_deadline - esp_timer_get_time();
+            wait_ticks = delta_us > 0 ? pdMS_TO_TICKS((delta_us + 999) / 1000) : 0;
+        }
+        ulTaskNotifyTake(pdTRUE, wait_ticks);
+
+        int64_t now_us = esp_timer_get_time();
+        for (auto& slot : slots_) {
+            if (slot.owner != nullptr) {
+                StepSlot(slot, now_us);
+            }
+        }
+    }
+}
+
+int64_t ButtonEngine::StepSlot(Slot& slot, int64_t now_us) {
+    bool active = IsActive(slot);
+    Button* button = slot.owner;
+
+    switch (slot.state) {
+        case State::kIdle:
+            if (active) {
+                slot.state = State::kDebouncing;
+                slot.deadline_us = now_us + kDebounceUs;
+            }
+            break;
+
+        case State::kDebouncing:
+            if (now_us < slot.deadline_us) {
+                break;
+            }
+            if (active) {
+                slot.state = State::kPressed;
+                slot.press_start_us = now_us;
+                slot.deadline_us = now_us + slot.long_press_us;
+                if (button->on_press_down_) {
+                    button->on_press_down_();
+                }
+            } else if (slot.click_count > 0) {
+                // 连击途中的毛刺，回到窗口继续等
+                slot.state = State::kClickWindow;
+                slot.deadline_us = now_us + kMultiClickWindowUs;
+            } else {
+                slot.state = State::kIdle;
+                slot.deadline_us = 0;
+            }
+            break;
+
+        case State::kPressed:
+            if (!active) {
+                if (button->on_press_up_) {
+                    button->on_press_up_();
+                }
+                slot.click_count++;
+                // 只挂了单击回调就立即判定；有双击/N 连击才付连击窗口
+                // 的那一次延迟
+                if (button->on_double_click_ || button->on_multiple_click_) {
+                    slot.state = State::kClickWindow;
+                    slot.deadline_us = now_us + kMultiClickWindowUs;
+                } else {
+                    EmitClicks(slot);
+                    slot.state = State::kIdle;
+                    slot.deadline_us = 0;
+                }
+            } else if (now_us >= slot.deadline_us) {
+                slot.state = State::kLongPressed;
+                slot.deadline_us = 0;
+                slot.click_count = 0;
+                if (button->on_long_press_) {
+                    button->on_long_press_();
+                }
+            }
+            break;
+
+        case State::kLongPressed:
+            if (!active) {
+                slot.state = State::kIdle;
+                if (button->on_press_up_) {
+                    button->on_press_up_();
+                }
+            }
+            break;
+
+        case State::kClickWindow:
+            if (active) {
+                slot.state = State::kDebouncing;
+                slot.deadline_us = now_us + kDebounceUs;
+            } else if (now_us >= slot.deadline_us) {
+                EmitClicks(slot);
+                slot.state = State::kIdle;
+                slot.deadline_us = 0;
+            }
+            break;
+    }
+    return slot.deadline_us;
+}
+
+void ButtonEngine::EmitClicks(Slot& slot) {
+    Button* button = slot.owner;
+    int count = slot.click_count;
+    slot.click_count = 0;
+    if (count == 1 && button->on_click_) {
+        button->on_click_();
+    } else if (count == 2 && button->on_double_click_) {
+        button->on_double_click_();
+    } else if (count >= 2 && count == button->multiple_click_count_ && button->on_multiple_click_) {
+        button->on_multiple_click_();
+    }
+}
+
+#endif // CONFIG_USE_BUTTON_ENGINE
@@ -0,0 +1,91 @@
+#ifndef BUTTON_ENGINE_H_
+#define BUTTON_ENGINE_H_
+
+#include <sdkconfig.h>
+
+#if CONFIG_USE_BUTTON_ENGINE
+
+#include <driver/gpio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <atomic>
+#include <cstdint>
+
+class Button;
+
+/*
+ * GPIO 按键矩阵引擎，替代 iot_button 的 GPIO 后端（ADC 按键仍走
+ * iot_button）。所有按键共用一个低优先级状态机任务：
+ *
+ *  - 毛刺由硬件 glitch filter 挡掉（gpio_new_pin_glitch_filter），
+ *    软件只留一次 10ms 的稳定确认；
+ *  - 任务平时阻塞在任务通知上（portMAX_DELAY），只有边沿中断或
+ *    最近一个待办截止点（消抖确认、长按判定、连击窗口）会唤醒它。
+ *    按住不放时唯一的唤醒是长按截止点本身，没有周期性 hold 定时器，
+ *    tickless idle 不再被按键轮询打断；
+ *  - 长按/单击/双击/N 连击在同一个状态机里判定，判定完成才回调，
+ *    中间状态不产生任何事件。
+ *
+ * 回调在引擎任务上下文执行，与 iot_button 从自身任务回调的语义
+ * 一致，板级代码无需改动。
+ */
+class ButtonEngine {
+public:
+    static ButtonEngine& GetInstance() {
+        static ButtonEngine instance;
+        return instance;
+    }
+
+    // 登记一个 GPIO 按键，返回槽位（满了返回 -1，调用方退回 iot_button）。
+    // 时间参数为 0 时取 iot_button 的默认值
+    int Register(Button* owner, gpio_num_t gpio_num, bool active_high,
+                 uint16_t long_press_ms, uint16_t short_press_ms, bool enable_power_save);
+    void Unregister(int slot);
+
+private:
+    ButtonEngine() = default;
+
+    static constexpr int kMaxButtons = 8;
+    // 连击间隔窗口：释放后这段时间内的再次按下算同一组连击
+    static constexpr int64_t kMultiClickWindowUs = 300 * 1000;
+    // 硬件滤波后的软件稳定确认
+    static constexpr int64_t kDebounceUs = 10 * 1000;
+
+    enum class State : uint8_t {
+        kIdle,
+        kDebouncing,       // 边沿后等稳定确认
+        kPressed,          // 已确认按下，等释放或长按截止点
+        kLongPressed,      // 长按已回调，等释放
+        kClickWindow,      // 已释放，等连击窗口关闭或下一次按下
+    };
+
+    struct Slot {
+        Button* owner = nullptr;
+        gpio_num_t gpio_num = GPIO_NUM_NC;
+        bool active_high = false;
+        int64_t long_press_us = 0;
+        gpio_glitch_filter_handle_t glitch_filter = nullptr;
+
+        State state = State::kIdle;
+        bool level_at_edge = false;
+        int64_t deadline_us = 0;       // 0 表示无截止点
+        int64_t press_start_us = 0;
+        int click_count = 0;
+    };
+
+    void EnsureTask();
+    void EngineTask();
+    // 处理一个槽位，返回它的下一个截止点（0 = 无）
+    int64_t StepSlot(Slot& slot, int64_t now_us);
+    void EmitClicks(Slot& slot);
+    bool IsActive(const Slot& slot) const;
+    static void IRAM_ATTR GpioIsr(void* arg);
+
+    Slot slots_[kMaxButtons];
+    TaskHandle_t task_handle_ = nullptr;
+};
+
+#endif // CONFIG_USE_BUTTON_ENGINE
+
+#endif // BUTTON_ENGINE_H_
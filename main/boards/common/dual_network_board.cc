@@ -42,15 +42,54 @@ void DualNetworkBoard::InitializeCurrentBoard() {
     }
 }
 
+void DualNetworkBoard::StartStandbyWarmup() {
+    // 仅在WiFi为主链路时预热4G热备：调制解调器驻网后保持空闲，
+    // 切换时只需迁移音频通道。反向（4G为主）不预热WiFi——
+    // WifiBoard::StartNetwork 会阻塞并可能进入配网模式，不适合后台静默运行
+    if (network_type_ != NetworkType::WIFI || ml307_tx_pin_ == GPIO_NUM_NC) {
+        return;
+    }
+    standby_board_ = std::make_unique<Ml307Board>(ml307_tx_pin_, ml307_rx_pin_, ml307_dtr_pin_);
+    xTaskCreate([](void* arg) {
+        auto self = static_cast<DualNetworkBoard*>(arg);
+        auto modem_board = static_cast<Ml307Board*>(self->standby_board_.get());
+        if (modem_board->StartStandby()) {
+            self->standby_ready_ = true;
+            ESP_LOGI(TAG, "Standby 4G link is ready for failover");
+        }
+        vTaskDelete(NULL);
+    }, "net_standby", 4096, this, 1, nullptr);
+}
+
+bool DualNetworkBoard::SwitchToStandby() {
+    if (standby_board_ == nullptr || !standby_ready_.load()) {
+        return false;
+    }
+    // 交换活动/热备板卡。旧的主链路保持在线，所以反向切换同样免重启
+    current_board_.swap(standby_board_);
+    network_type_ = (network_type_ == NetworkType::WIFI) ? NetworkType::ML307 : NetworkType::WIFI;
+    ESP_LOGI(TAG, "Switched to standby %s link without reboot", current_board_->GetBoardType().c_str());
+
+    // 在新链路上重建音频通道，对话状态在迁移期间保持不变
+    auto& app = Application::GetInstance();
+    app.Schedule([&app]() {
+        app.ReopenAudioChannel();
+    });
+    return true;
+}
+
 void DualNetworkBoard::SwitchNetworkType() {
     auto display = GetDisplay();
-    if (network_type_ == NetworkType::WIFI) {    
+    if (network_type_ == NetworkType::WIFI) {
         SaveNetworkTypeToSettings(NetworkType::ML307);
         display->ShowNotification(Lang::Strings::SWITCH_TO_4G_NETWORK);
     } else {
         SaveNetworkTypeToSettings(NetworkType::WIFI);
         display->ShowNotification(Lang::Strings::SWITCH_TO_WIFI_NETWORK);
     }
+    if (SwitchToStandby()) {
+        return;
+    }
     vTaskDelay(pdMS_TO_TICKS(1000));
     auto& app = Application::GetInstance();
     app.Reboot();
@@ -70,6 +109,9 @@ void DualNetworkBoard::StartNetwork() {
         display->SetStatus(Lang::Strings::DETECTING_MODULE);
     }
     current_board_->StartNetwork();
+
+    // 主链路就绪后在后台预热热备链路
+    StartStandbyWarmup();
 }
 
 NetworkInterface* DualNetworkBoard::GetNetwork() {
@@ -4,6 +4,7 @@
 #include "board.h"
 #include "wifi_board.h"
 #include "ml307_board.h"
+#include <atomic>
 #include <memory>
 
 //enum NetworkType
@@ -17,6 +18,9 @@ class DualNetworkBoard : public Board {
 private:
     // 使用基类指针存储当前活动的板卡
     std::unique_ptr<Board> current_board_;
+    // 热备板卡（见 StartStandbyWarmup），就绪后 SwitchNetworkType 可免重启切换
+    std::unique_ptr<Board> standby_board_;
+    std::atomic<bool> standby_ready_{false};
     NetworkType network_type_ = NetworkType::ML307;  // Default to ML307
 
     // ML307的引脚配置
@@ -32,7 +36,13 @@ private:
 
     // 初始化当前网络类型对应的板卡
     void InitializeCurrentBoard();
- 
+
+    // 在后台预热热备链路
+    void StartStandbyWarmup();
+
+    // 热备就绪时免重启切换并迁移音频通道，否则返回false
+    bool SwitchToStandby();
+
 public:
     DualNetworkBoard(gpio_num_t ml307_tx_pin, gpio_num_t ml307_rx_pin, gpio_num_t ml307_dtr_pin = GPIO_NUM_NC, int32_t default_net_type = 1);
     virtual ~DualNetworkBoard() = default;
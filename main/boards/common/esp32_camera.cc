@@ -6,6 +6,7 @@
 #include <errno.h>
 #include <esp_heap_caps.h>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
 #include "esp_imgfx_color_convert.h"
@@ -17,9 +18,11 @@
 #include "display.h"
 #include "esp32_camera.h"
 #include "esp_jpeg_common.h"
+#include "heap_telemetry.h"
 #include "jpg/image_to_jpeg.h"
 #include "jpg/jpeg_to_image.h"
 #include "lvgl_display.h"
+#include "memory_budget.h"
 #include "mcp_server.h"
 #include "system_info.h"
 
@@ -54,6 +57,11 @@
 
 #define TAG "Esp32Camera"
 
+// 最后一次拍照这么久之后挂起传感器流省电；恢复时重新收敛曝光
+static constexpr int64_t kStreamIdleSuspendUs = 30 * 1000000LL;
+// 恢复后丢帧等待 AE/AWB 收敛的时长
+static constexpr TickType_t kStreamResumeConvergeTicks = pdMS_TO_TICKS(600);
+
 #if defined(CONFIG_CAMERA_SENSOR_SWAP_PIXEL_BYTE_ORDER) || defined(CONFIG_XIAOZHI_ENABLE_CAMERA_ENDIANNESS_SWAP)
 #warning \
     "CAMERA_SENSOR_SWAP_PIXEL_BYTE_ORDER or CONFIG_XIAOZHI_ENABLE_CAMERA_ENDIANNESS_SWAP is enabled, which may cause image corruption in YUV422 format!"
@@ -94,6 +102,74 @@ static void log_available_video_devices() {
 #define CAM_PRINT_FOURCC(pixelformat) (void)0;
 #endif  // CONFIG_XIAOZHI_ENABLE_CAMERA_DEBUG_MODE
 
+namespace {
+
+// 预览帧图片，像素缓冲来自相机的缓冲池，析构时归还而不是释放
+class PooledPreviewImage : public LvglImage {
+public:
+    PooledPreviewImage(Esp32Camera* camera, uint8_t* data, size_t buffer_size, size_t image_size,
+                       int width, int height, int stride, lv_color_format_t color_format)
+        : camera_(camera), data_(data), buffer_size_(buffer_size) {
+        bzero(&image_dsc_, sizeof(image_dsc_));
+        image_dsc_.data_size = image_size;
+        image_dsc_.data = data;
+        image_dsc_.header.magic = LV_IMAGE_HEADER_MAGIC;
+        image_dsc_.header.cf = color_format;
+        image_dsc_.header.w = width;
+        image_dsc_.header.h = height;
+        image_dsc_.header.stride = stride;
+    }
+
+    virtual ~PooledPreviewImage() {
+        camera_->RecyclePreviewBuffer(data_, buffer_size_);
+    }
+
+    virtual const lv_img_dsc_t* image_dsc() const override { return &image_dsc_; }
+
+private:
+    Esp32Camera* camera_;
+    uint8_t* data_;
+    size_t buffer_size_;
+    lv_img_dsc_t image_dsc_;
+};
+
+}  // namespace
+
+uint8_t* Esp32Camera::AcquirePreviewBuffer(size_t& size) {
+    {
+        std::lock_guard<std::mutex> lock(preview_buffer_mutex_);
+        for (auto it = preview_buffer_pool_.begin(); it != preview_buffer_pool_.end(); ++it) {
+            if (it->second >= size) {
+                uint8_t* data = it->first;
+                size = it->second;
+                preview_buffer_pool_.erase(it);
+                return data;
+            }
+        }
+    }
+    // JPEG 解码器要求输出缓冲 16 字节对齐
+    auto data = (uint8_t*)heap_caps_aligned_alloc(16, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (data == nullptr) {
+        ESP_LOGE(TAG, "Failed to allocate preview buffer (%u bytes)", (unsigned)size);
+    } else {
+        HeapTelemetry::GetInstance().Add("camera", size);
+    }
+    return data;
+}
+
+void Esp32Camera::RecyclePreviewBuffer(uint8_t* data, size_t size) {
+    if (data == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(preview_buffer_mutex_);
+    if (preview_buffer_pool_.size() < 2) {
+        preview_buffer_pool_.emplace_back(data, size);
+    } else {
+        heap_caps_free(data);
+        HeapTelemetry::GetInstance().Remove("camera", size);
+    }
+}
+
 Esp32Camera::Esp32Camera(const esp_video_init_config_t& config) {
     if (esp_video_init(&config) != ESP_OK) {
         ESP_LOGE(TAG, "esp_video_init failed");
@@ -326,6 +402,19 @@ Esp32Camera::Esp32Camera(const esp_video_init_config_t& config) {
         return;
     }
 
+    // 空闲挂起定时器：一段时间没有拍照就关掉传感器流
+    esp_timer_create_args_t idle_timer_args = {
+        .callback = [](void* arg) {
+            static_cast<Esp32Camera*>(arg)->SuspendStream();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "camera_idle",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&idle_timer_args, &idle_timer_));
+    esp_timer_start_once(idle_timer_, kStreamIdleSuspendUs);
+
 #ifdef CONFIG_ESP_VIDEO_ENABLE_ISP_VIDEO_DEVICE
     // 当启用 ISP 时，ISP 需要一些照片来初始化参数，因此开启后后台拍摄5s照片并丢弃
     xTaskCreate(
@@ -361,7 +450,11 @@ Esp32Camera::Esp32Camera(const esp_video_init_config_t& config) {
 }
 
 Esp32Camera::~Esp32Camera() {
-    if (streaming_on_ && video_fd_ >= 0) {
+    if (idle_timer_ != nullptr) {
+        esp_timer_stop(idle_timer_);
+        esp_timer_delete(idle_timer_);
+    }
+    if (streaming_on_ && !stream_suspended_ && video_fd_ >= 0) {
         int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
         ioctl(video_fd_, VIDIOC_STREAMOFF, &type);
     }
@@ -375,6 +468,24 @@ Esp32Camera::~Esp32Camera() {
         video_fd_ = -1;
     }
     sensor_format_ = 0;
+#ifdef CONFIG_XIAOZHI_ENABLE_ROTATE_CAMERA_IMAGE
+#ifdef CONFIG_SOC_PPA_SUPPORTED
+    if (ppa_client_ != nullptr) {
+        (void)ppa_unregister_client(ppa_client_);
+        ppa_client_ = nullptr;
+    }
+#else
+    if (rotate_handle_ != nullptr) {
+        esp_imgfx_rotate_close(rotate_handle_);
+        rotate_handle_ = nullptr;
+    }
+#endif
+#endif  // CONFIG_XIAOZHI_ENABLE_ROTATE_CAMERA_IMAGE
+    for (auto& [data, size] : preview_buffer_pool_) {
+        heap_caps_free(data);
+        HeapTelemetry::GetInstance().Remove("camera", size);
+    }
+    preview_buffer_pool_.clear();
     esp_video_deinit();
 }
 
@@ -383,6 +494,57 @@ void Esp32Camera::SetExplainUrl(const std::string& url, const std::string& token
     explain_token_ = token;
 }
 
+void Esp32Camera::SuspendStream() {
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    if (!streaming_on_ || stream_suspended_ || video_fd_ < 0) {
+        return;
+    }
+    int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (ioctl(video_fd_, VIDIOC_STREAMOFF, &type) != 0) {
+        ESP_LOGE(TAG, "VIDIOC_STREAMOFF failed, errno=%d(%s)", errno, strerror(errno));
+        return;
+    }
+    stream_suspended_ = true;
+    ESP_LOGI(TAG, "Camera stream suspended after idle timeout");
+}
+
+bool Esp32Camera::ResumeStreamLocked() {
+    // STREAMOFF 把缓冲都收回了，重新入队再开流
+    for (uint32_t i = 0; i < mmap_buffers_.size(); i++) {
+        struct v4l2_buffer buf = {};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (ioctl(video_fd_, VIDIOC_QBUF, &buf) != 0) {
+            ESP_LOGE(TAG, "Resume: VIDIOC_QBUF failed, errno=%d(%s)", errno, strerror(errno));
+            return false;
+        }
+    }
+    int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (ioctl(video_fd_, VIDIOC_STREAMON, &type) != 0) {
+        ESP_LOGE(TAG, "Resume: VIDIOC_STREAMON failed, errno=%d(%s)", errno, strerror(errno));
+        return false;
+    }
+
+    // 丢掉曝光还没收敛的帧，别让第一张照片过曝/过暗
+    TickType_t start = xTaskGetTickCount();
+    while (xTaskGetTickCount() - start < kStreamResumeConvergeTicks) {
+        struct v4l2_buffer buf = {};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        if (ioctl(video_fd_, VIDIOC_DQBUF, &buf) != 0) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+        if (ioctl(video_fd_, VIDIOC_QBUF, &buf) != 0) {
+            ESP_LOGE(TAG, "Resume: VIDIOC_QBUF failed");
+        }
+    }
+    stream_suspended_ = false;
+    ESP_LOGI(TAG, "Camera stream resumed");
+    return true;
+}
+
 bool Esp32Camera::Capture() {
     if (encoder_thread_.joinable()) {
         encoder_thread_.join();
@@ -392,6 +554,18 @@ bool Esp32Camera::Capture() {
         return false;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(stream_mutex_);
+        if (stream_suspended_ && !ResumeStreamLocked()) {
+            return false;
+        }
+    }
+    // 重新计时空闲挂起窗口
+    if (idle_timer_ != nullptr) {
+        esp_timer_stop(idle_timer_);
+        esp_timer_start_once(idle_timer_, kStreamIdleSuspendUs);
+    }
+
     for (int i = 0; i < 3; i++) {
         struct v4l2_buffer buf = {};
         buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
@@ -408,7 +582,10 @@ bool Esp32Camera::Capture() {
                 frame_.format = 0;
             }
             frame_.len = buf.bytesused;
-            frame_.data = (uint8_t*)heap_caps_malloc(frame_.len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+            // 预算接口：PSRAM 吃紧时先淘汰缓存等级的池子再抓帧
+            frame_.data = (uint8_t*)MemoryBudget::GetInstance().Alloc(
+                "camera_frame", frame_.len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+                MemoryBudget::kReclaimPreview);
             if (!frame_.data) {
                 ESP_LOGE(TAG, "alloc frame copy failed: need allocate %d bytes", buf.bytesused);
                 if (ioctl(video_fd_, VIDIOC_QBUF, &buf) != 0) {
@@ -502,42 +679,45 @@ bool Esp32Camera::Capture() {
             }
             uint8_t* rotate_src = (uint8_t*)frame_.data;
 
-            esp_imgfx_rotate_cfg_t rotate_cfg = {
-                .in_res =
-                    {
-                        .width = static_cast<int16_t>(sensor_width_),
-                        .height = static_cast<int16_t>(sensor_height_),
-                    },
-                .degree = IMAGE_ROTATION_ANGLE,
-            };
-            switch (frame_.format) {
-                case V4L2_PIX_FMT_RGB565:
-                    rotate_cfg.in_pixel_fmt = ESP_IMGFX_PIXEL_FMT_RGB565_LE;
-                    break;
-                case V4L2_PIX_FMT_YUYV:
-                    rotate_cfg.in_pixel_fmt = ESP_IMGFX_PIXEL_FMT_RGB565_LE;
-                    break;
-                case V4L2_PIX_FMT_GREY:
-                    rotate_cfg.in_pixel_fmt = ESP_IMGFX_PIXEL_FMT_Y;
-                    break;
-                case V4L2_PIX_FMT_RGB24:
-                    rotate_cfg.in_pixel_fmt = ESP_IMGFX_PIXEL_FMT_RGB888;
-                    break;
-                default:
-                    ESP_LOGE(TAG, "unsupported sensor format: 0x%08x", sensor_format_);
+            // 旋转句柄跨拍照复用：传感器格式和分辨率固定，建表只需一次
+            if (rotate_handle_ == nullptr) {
+                esp_imgfx_rotate_cfg_t rotate_cfg = {
+                    .in_res =
+                        {
+                            .width = static_cast<int16_t>(sensor_width_),
+                            .height = static_cast<int16_t>(sensor_height_),
+                        },
+                    .degree = IMAGE_ROTATION_ANGLE,
+                };
+                switch (frame_.format) {
+                    case V4L2_PIX_FMT_RGB565:
+                        rotate_cfg.in_pixel_fmt = ESP_IMGFX_PIXEL_FMT_RGB565_LE;
+                        break;
+                    case V4L2_PIX_FMT_YUYV:
+                        rotate_cfg.in_pixel_fmt = ESP_IMGFX_PIXEL_FMT_RGB565_LE;
+                        break;
+                    case V4L2_PIX_FMT_GREY:
+                        rotate_cfg.in_pixel_fmt = ESP_IMGFX_PIXEL_FMT_Y;
+                        break;
+                    case V4L2_PIX_FMT_RGB24:
+                        rotate_cfg.in_pixel_fmt = ESP_IMGFX_PIXEL_FMT_RGB888;
+                        break;
+                    default:
+                        ESP_LOGE(TAG, "unsupported sensor format: 0x%08x", sensor_format_);
+                        if (ioctl(video_fd_, VIDIOC_QBUF, &buf) != 0) {
+                            ESP_LOGE(TAG, "Cleanup: VIDIOC_QBUF failed");
+                        }
+                        return false;
+                }
+                esp_imgfx_err_t imgfx_err = esp_imgfx_rotate_open(&rotate_cfg, &rotate_handle_);
+                if (imgfx_err != ESP_IMGFX_ERR_OK || rotate_handle_ == nullptr) {
+                    ESP_LOGE(TAG, "esp_imgfx_rotate_create failed");
+                    rotate_handle_ = nullptr;
                     if (ioctl(video_fd_, VIDIOC_QBUF, &buf) != 0) {
                         ESP_LOGE(TAG, "Cleanup: VIDIOC_QBUF failed");
                     }
                     return false;
-            }
-            esp_imgfx_rotate_handle_t rotate_handle = nullptr;
-            esp_imgfx_err_t imgfx_err = esp_imgfx_rotate_open(&rotate_cfg, &rotate_handle);
-            if (imgfx_err != ESP_IMGFX_ERR_OK || rotate_handle == nullptr) {
-                ESP_LOGE(TAG, "esp_imgfx_rotate_create failed");
-                if (ioctl(video_fd_, VIDIOC_QBUF, &buf) != 0) {
-                    ESP_LOGE(TAG, "Cleanup: VIDIOC_QBUF failed");
                 }
-                return false;
             }
 
             esp_imgfx_data_t rotate_input_data = {
@@ -549,7 +729,7 @@ bool Esp32Camera::Capture() {
                 .data_len = frame_.len,
             };
 
-            imgfx_err = esp_imgfx_rotate_process(rotate_handle, &rotate_input_data, &rotate_output_data);
+            esp_imgfx_err_t imgfx_err = esp_imgfx_rotate_process(rotate_handle_, &rotate_input_data, &rotate_output_data);
             if (imgfx_err != ESP_IMGFX_ERR_OK) {
                 ESP_LOGE(TAG, "esp_imgfx_rotate_process failed");
                 heap_caps_free(rotate_dst);
@@ -557,8 +737,9 @@ bool Esp32Camera::Capture() {
                 if (ioctl(video_fd_, VIDIOC_QBUF, &buf) != 0) {
                     ESP_LOGE(TAG, "Cleanup: VIDIOC_QBUF failed");
                 }
-                esp_imgfx_rotate_close(rotate_handle);
-                rotate_handle = nullptr;
+                // 句柄可能已进入坏状态，下次拍照重建
+                esp_imgfx_rotate_close(rotate_handle_);
+                rotate_handle_ = nullptr;
                 return false;
             }
 
@@ -566,9 +747,6 @@ bool Esp32Camera::Capture() {
 
             heap_caps_free(rotate_src);
             rotate_src = nullptr;
-
-            esp_imgfx_rotate_close(rotate_handle);
-            rotate_handle = nullptr;
 #else   // CONFIG_SOC_PPA_SUPPORTED
             uint8_t* rotate_src = nullptr;
 
@@ -656,20 +834,23 @@ bool Esp32Camera::Capture() {
                 return false;
             }
 
-            ppa_client_handle_t ppa_client = nullptr;
-            ppa_client_config_t client_cfg = {
-                .oper_type = PPA_OPERATION_SRM,
-                .max_pending_trans_num = 1,
-            };
-            esp_err_t err = ppa_register_client(&client_cfg, &ppa_client);
-            if (err != ESP_OK || ppa_client == nullptr) {
-                ESP_LOGE(TAG, "ppa_register_client failed: %d", (int)err);
-                heap_caps_free(rotate_dst);
-                rotate_dst = nullptr;
-                if (ioctl(video_fd_, VIDIOC_QBUF, &buf) != 0) {
-                    ESP_LOGE(TAG, "Cleanup: VIDIOC_QBUF failed");
+            // PPA 客户端跨拍照复用，注册开销只付一次
+            if (ppa_client_ == nullptr) {
+                ppa_client_config_t client_cfg = {
+                    .oper_type = PPA_OPERATION_SRM,
+                    .max_pending_trans_num = 1,
+                };
+                esp_err_t reg_err = ppa_register_client(&client_cfg, &ppa_client_);
+                if (reg_err != ESP_OK || ppa_client_ == nullptr) {
+                    ESP_LOGE(TAG, "ppa_register_client failed: %d", (int)reg_err);
+                    ppa_client_ = nullptr;
+                    heap_caps_free(rotate_dst);
+                    rotate_dst = nullptr;
+                    if (ioctl(video_fd_, VIDIOC_QBUF, &buf) != 0) {
+                        ESP_LOGE(TAG, "Cleanup: VIDIOC_QBUF failed");
+                    }
+                    return false;
                 }
-                return false;
             }
 
             ppa_srm_rotation_angle_t ppa_angle = IMAGE_ROTATION_ANGLE;
@@ -699,20 +880,17 @@ bool Esp32Camera::Capture() {
             srm_cfg.mode = PPA_TRANS_MODE_BLOCKING;
             srm_cfg.user_data = nullptr;
 
-            err = ppa_do_scale_rotate_mirror(ppa_client, &srm_cfg);
+            esp_err_t err = ppa_do_scale_rotate_mirror(ppa_client_, &srm_cfg);
             if (err != ESP_OK) {
                 ESP_LOGE(TAG, "ppa_do_scale_rotate_mirror failed: %d", (int)err);
                 heap_caps_free(rotate_dst);
                 rotate_dst = nullptr;
-                (void)ppa_unregister_client(ppa_client);
                 if (ioctl(video_fd_, VIDIOC_QBUF, &buf) != 0) {
                     ESP_LOGE(TAG, "Cleanup: VIDIOC_QBUF failed");
                 }
                 return false;
             }
 
-            (void)ppa_unregister_client(ppa_client);
-
             frame_.data = rotate_dst;
             frame_.len = frame_.width * frame_.height * 2;
             frame_.format = V4L2_PIX_FMT_RGB565;
@@ -740,6 +918,7 @@ bool Esp32Camera::Capture() {
         size_t stride = ((w * 2) + 3) & ~3;  // 4字节对齐
         lv_color_format_t color_format = LV_COLOR_FORMAT_RGB565;
         uint8_t* data = nullptr;
+        size_t buffer_size = 0;
 
         switch (frame_.format) {
             // LVGL 显示 YUV 系的图像似乎都有问题，暂时转换为 RGB565 显示
@@ -747,9 +926,9 @@ bool Esp32Camera::Capture() {
             case V4L2_PIX_FMT_YUV420:
             case V4L2_PIX_FMT_RGB24: {
                 color_format = LV_COLOR_FORMAT_RGB565;
-                data = (uint8_t*)heap_caps_malloc(w * h * 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+                buffer_size = w * h * 2;
+                data = AcquirePreviewBuffer(buffer_size);
                 if (data == nullptr) {
-                    ESP_LOGE(TAG, "Failed to allocate memory for preview image");
                     return false;
                 }
                 esp_imgfx_color_convert_cfg_t convert_cfg = {
@@ -763,7 +942,7 @@ bool Esp32Camera::Capture() {
                 esp_imgfx_err_t err = esp_imgfx_color_convert_open(&convert_cfg, &convert_handle);
                 if (err != ESP_IMGFX_ERR_OK || convert_handle == nullptr) {
                     ESP_LOGE(TAG, "esp_imgfx_color_convert_open failed");
-                    heap_caps_free(data);
+                    RecyclePreviewBuffer(data, buffer_size);
                     data = nullptr;
                     return false;
                 }
@@ -778,7 +957,7 @@ bool Esp32Camera::Capture() {
                 err = esp_imgfx_color_convert_process(convert_handle, &convert_input_data, &convert_output_data);
                 if (err != ESP_IMGFX_ERR_OK) {
                     ESP_LOGE(TAG, "esp_imgfx_color_convert_process failed");
-                    heap_caps_free(data);
+                    RecyclePreviewBuffer(data, buffer_size);
                     data = nullptr;
                     esp_imgfx_color_convert_close(convert_handle);
                     convert_handle = nullptr;
@@ -791,9 +970,9 @@ bool Esp32Camera::Capture() {
             }
 
             case V4L2_PIX_FMT_RGB565:
-                data = (uint8_t*)heap_caps_malloc(w * h * 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+                buffer_size = w * h * 2;
+                data = AcquirePreviewBuffer(buffer_size);
                 if (data == nullptr) {
-                    ESP_LOGE(TAG, "Failed to allocate memory for preview image");
                     return false;
                 }
                 memcpy(data, frame_.data, frame_.len);
@@ -802,24 +981,39 @@ bool Esp32Camera::Capture() {
 
 #ifdef CONFIG_XIAOZHI_CAMERA_ALLOW_JPEG_INPUT
             case V4L2_PIX_FMT_JPEG: {
-                uint8_t* out_data = nullptr;  // out data is allocated by jpeg_to_image
+                // 预览按显示分辨率在 DCT 域降采样解码，不再先解出全尺寸图再交给 LVGL 缩放
+                size_t max_width = display->width() > 0 ? display->width() : w;
+                size_t max_height = display->height() > 0 ? display->height() : h;
                 size_t out_len = 0;
                 size_t out_width = 0;
                 size_t out_height = 0;
                 size_t out_stride = 0;
 
-                esp_err_t ret =
-                    jpeg_to_image(frame_.data, frame_.len, &out_data, &out_len, &out_width, &out_height, &out_stride);
+                buffer_size = max_width * max_height * 2;
+                data = AcquirePreviewBuffer(buffer_size);
+                if (data == nullptr) {
+                    return false;
+                }
+                esp_err_t ret = jpeg_to_image_scaled(frame_.data, frame_.len, max_width, max_height, data, buffer_size,
+                                                     &out_len, &out_width, &out_height, &out_stride);
+                if (ret == ESP_ERR_INVALID_SIZE) {
+                    // 超大图片 1/8 降采样后仍放不下，换更大的缓冲重试一次
+                    RecyclePreviewBuffer(data, buffer_size);
+                    buffer_size = out_len;
+                    data = AcquirePreviewBuffer(buffer_size);
+                    if (data == nullptr) {
+                        return false;
+                    }
+                    ret = jpeg_to_image_scaled(frame_.data, frame_.len, max_width, max_height, data, buffer_size,
+                                               &out_len, &out_width, &out_height, &out_stride);
+                }
                 if (ret != ESP_OK) {
                     ESP_LOGE(TAG, "Failed to decode JPEG image: %d (%s)", (int)ret, esp_err_to_name(ret));
-                    if (out_data) {
-                        heap_caps_free(out_data);
-                        out_data = nullptr;
-                    }
+                    RecyclePreviewBuffer(data, buffer_size);
+                    data = nullptr;
                     return false;
                 }
 
-                data = out_data;
                 w = out_width;
                 h = out_height;
                 lvgl_image_size = out_len;
@@ -832,7 +1026,7 @@ bool Esp32Camera::Capture() {
                 return false;
         }
 
-        auto image = std::make_unique<LvglAllocatedImage>(data, lvgl_image_size, w, h, stride, color_format);
+        auto image = std::make_unique<PooledPreviewImage>(this, data, buffer_size, lvgl_image_size, w, h, stride, color_format);
         display->SetPreviewImage(std::move(image));
     }
     return true;
@@ -895,13 +1089,50 @@ bool Esp32Camera::SetVFlip(bool enabled) {
  * @note 函数会等待之前的编码线程完成后再开始新的处理
  * @warning 如果摄像头缓冲区为空或网络连接失败，将返回错误信息
  */
+std::vector<uint8_t> Esp32Camera::ComputeFrameSignature() const {
+    // 均匀抽 1024 个字节作为帧特征，足以区分"场景变了"和传感器噪声
+    constexpr size_t kSignatureSamples = 1024;
+    std::vector<uint8_t> signature;
+    if (frame_.data == nullptr || frame_.len == 0) {
+        return signature;
+    }
+    signature.reserve(kSignatureSamples);
+    size_t step = frame_.len / kSignatureSamples;
+    if (step == 0) {
+        step = 1;
+    }
+    for (size_t i = 0; i < frame_.len && signature.size() < kSignatureSamples; i += step) {
+        signature.push_back(frame_.data[i]);
+    }
+    return signature;
+}
+
 std::string Esp32Camera::Explain(const std::string& question) {
     if (explain_url_.empty()) {
         throw std::runtime_error("Image explain URL or token is not set");
     }
 
-    // 创建局部的 JPEG 队列, 40 entries is about to store 512 * 40 = 20480 bytes of JPEG data
-    QueueHandle_t jpeg_queue = xQueueCreate(40, sizeof(JpegChunk));
+    // 场景没变、问题相同且上次应答还新鲜时，直接复用服务器的分析结果
+    constexpr int64_t kExplainCacheTtlUs = 30 * 1000000LL;
+    constexpr int kSceneChangeThreshold = 6;  // 每采样字节的平均绝对差
+    auto signature = ComputeFrameSignature();
+    if (!last_explain_result_.empty() && question == last_explain_question_ &&
+        esp_timer_get_time() - last_explain_us_ < kExplainCacheTtlUs &&
+        signature.size() == last_frame_signature_.size() && !signature.empty()) {
+        int64_t diff_sum = 0;
+        for (size_t i = 0; i < signature.size(); i++) {
+            diff_sum += std::abs((int)signature[i] - (int)last_frame_signature_[i]);
+        }
+        if (diff_sum / (int64_t)signature.size() < kSceneChangeThreshold) {
+            ESP_LOGI(TAG, "Scene unchanged, reusing cached explain result");
+            return last_explain_result_;
+        }
+    }
+
+    // 创建局部的 JPEG 队列。队列故意开得浅：编码快于发送时 xQueueSend
+    // 阻塞住编码线程，整个管线在途数据被限制在 8 块（约 4KB），
+    // 而不是把整张 JPEG 都堆在内存里等网络
+    QueueHandle_t jpeg_queue = xQueueCreate(8, sizeof(JpegChunk));
     if (jpeg_queue == nullptr) {
         ESP_LOGE(TAG, "Failed to create JPEG queue");
         throw std::runtime_error("Failed to create JPEG queue");
@@ -917,7 +1148,8 @@ std::string Esp32Camera::Explain(const std::string& question) {
             [](void* arg, size_t index, const void* data, size_t len) -> size_t {
                 auto jpeg_queue = static_cast<QueueHandle_t>(arg);
                 JpegChunk chunk = {.data = nullptr, .len = len};
-                if (index == 0 && data != nullptr && len > 0) {
+                // 软件编码器按 MCU 带分多块输出，data 为 NULL 表示结束
+                if (data != nullptr && len > 0) {
                     chunk.data = (uint8_t*)heap_caps_aligned_alloc(16, len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
                     if (chunk.data == nullptr) {
                         ESP_LOGE(TAG, "Failed to allocate %zu bytes for JPEG chunk", len);
@@ -939,8 +1171,8 @@ std::string Esp32Camera::Explain(const std::string& question) {
         }
     });
 
-    auto network = Board::GetInstance().GetNetwork();
-    auto http = network->CreateHttp(3);
+    // 复用连接池里的客户端：连续的拍照解释请求走同一个热连接
+    auto http = Board::GetInstance().AcquireHttp("camera", 3);
     // 构造multipart/form-data请求体
     std::string boundary = "----ESP32_CAMERA_BOUNDARY";
 
@@ -954,8 +1186,7 @@ std::string Esp32Camera::Explain(const std::string& question) {
     http->SetHeader("Transfer-Encoding", "chunked");
     if (!http->Open("POST", explain_url_)) {
         ESP_LOGE(TAG, "Failed to connect to explain URL");
-        // Clear the queue
-        encoder_thread_.join();
+        // 先把队列排空再 join：编码线程可能正阻塞在已满的队列上
         JpegChunk chunk;
         while (xQueueReceive(jpeg_queue, &chunk, portMAX_DELAY) == pdPASS) {
             if (chunk.data != nullptr) {
@@ -964,6 +1195,7 @@ std::string Esp32Camera::Explain(const std::string& question) {
                 break;
             }
         }
+        encoder_thread_.join();
         vQueueDelete(jpeg_queue);
         throw std::runtime_error("Failed to connect to explain URL");
     }
@@ -1030,6 +1262,12 @@ std::string Esp32Camera::Explain(const std::string& question) {
 
     std::string result = http->ReadAll();
     http->Close();
+    Board::GetInstance().ReleaseHttp("camera", std::move(http));
+
+    last_frame_signature_ = std::move(signature);
+    last_explain_question_ = question;
+    last_explain_result_ = result;
+    last_explain_us_ = esp_timer_get_time();
 
     // Get remain task stack size
     size_t remain_stack_size = uxTaskGetStackHighWaterMark(nullptr);
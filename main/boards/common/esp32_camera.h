@@ -5,15 +5,25 @@
 #include <lvgl.h>
 #include <thread>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <esp_timer.h>
 
 #include "camera.h"
 #include "jpg/image_to_jpeg.h"
 #include "esp_video_init.h"
 
+#ifdef CONFIG_XIAOZHI_ENABLE_ROTATE_CAMERA_IMAGE
+#ifdef CONFIG_SOC_PPA_SUPPORTED
+#include <driver/ppa.h>
+#else
+#include "esp_imgfx_rotate.h"
+#endif
+#endif  // CONFIG_XIAOZHI_ENABLE_ROTATE_CAMERA_IMAGE
+
 struct JpegChunk {
     uint8_t* data;
     size_t len;
@@ -32,14 +42,34 @@ private:
 #ifdef CONFIG_XIAOZHI_ENABLE_ROTATE_CAMERA_IMAGE
     uint16_t sensor_width_ = 0;
     uint16_t sensor_height_ = 0;
+    // 旋转引擎句柄跨拍照复用：注册/建表只做一次，不摊到每张照片上
+#ifdef CONFIG_SOC_PPA_SUPPORTED
+    ppa_client_handle_t ppa_client_ = nullptr;
+#else
+    esp_imgfx_rotate_handle_t rotate_handle_ = nullptr;
+#endif
 #endif  // CONFIG_XIAOZHI_ENABLE_ROTATE_CAMERA_IMAGE
     int video_fd_ = -1;
     bool streaming_on_ = false;
+    // 空闲一段时间后挂起传感器省电，下次 Capture 时恢复并重新收敛曝光
+    bool stream_suspended_ = false;
+    std::mutex stream_mutex_;
+    esp_timer_handle_t idle_timer_ = nullptr;
     struct MmapBuffer { void *start = nullptr; size_t length = 0; };
     std::vector<MmapBuffer> mmap_buffers_;
     std::string explain_url_;
     std::string explain_token_;
     std::thread encoder_thread_;
+    // 重复巡检场景的结果缓存：场景没变、问题相同时直接复用上次的
+    // 服务器应答，省掉整条编码+上传链路
+    std::vector<uint8_t> last_frame_signature_;
+    std::string last_explain_question_;
+    std::string last_explain_result_;
+    int64_t last_explain_us_ = 0;
+    // 预览帧缓冲池：稳态下只在池中保留两块缓冲（屏幕上的一块和正在填充的一块），
+    // 不再每帧分配
+    std::mutex preview_buffer_mutex_;
+    std::vector<std::pair<uint8_t*, size_t>> preview_buffer_pool_;
 
 public:
     Esp32Camera(const esp_video_init_config_t& config);
@@ -51,6 +81,15 @@ public:
     virtual bool SetHMirror(bool enabled) override;
     virtual bool SetVFlip(bool enabled) override;
     virtual std::string Explain(const std::string& question);
+
+    // 预览缓冲池接口，size 会被更新为实际容量；预览图片析构时归还缓冲
+    uint8_t* AcquirePreviewBuffer(size_t& size);
+    void RecyclePreviewBuffer(uint8_t* data, size_t size);
+
+private:
+    void SuspendStream();
+    bool ResumeStreamLocked();
+    std::vector<uint8_t> ComputeFrameSignature() const;
 };
 
 #endif // ndef CONFIG_IDF_TARGET_ESP32
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "i2c_bus_worker.h"
+
+#include <vector>
+
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define TAG "I2cBusWorker"
+
+I2cBusWorker& I2cBusWorker::GetForBus(i2c_master_bus_handle_t bus) {
+    // 每条总线一个 worker；板子最多两三条 I2C，线性查找即可
+    static std::mutex registry_mutex;
+    static std::vector<std::pair<i2c_master_bus_handle_t, I2cBusWorker*>> registry;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto& entry : registry) {
+        if (entry.first == bus) {
+            return *entry.second;
+        }
+    }
+    auto* worker = new I2cBusWorker();
+    registry.emplace_back(bus, worker);
+    return *worker;
+}
+
+I2cBusWorker::I2cBusWorker() {
+    // 优先级 4：高于主循环（3），低于音频输入，控制写不会被界面工作压住
+    xTaskCreate([](void* arg) {
+        static_cast<I2cBusWorker*>(arg)->WorkLoop();
+    }, "i2c_worker", 4096, this, 4, nullptr);
+}
+
+void I2cBusWorker::Submit(Priority priority, std::function<void()> op) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (priority == kPriorityHigh) {
+            high_queue_.push_back(std::move(op));
+        } else {
+            low_queue_.push_back(std::move(op));
+        }
+    }
+    cv_.notify_one();
+}
+
+void I2cBusWorker::WorkLoop() {
+    while (true) {
+        std::function<void()> op;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() {
+                return !high_queue_.empty() || !low_queue_.empty();
+            });
+            // 高优先级队列清空前不碰低优先级的轮询
+            if (!high_queue_.empty()) {
+                op = std::move(high_queue_.front());
+                high_queue_.pop_front();
+            } else {
+                op = std::move(low_queue_.front());
+                low_queue_.pop_front();
+            }
+        }
+        op();
+    }
+}
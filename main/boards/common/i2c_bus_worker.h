@@ -0,0 +1,50 @@
+#ifndef I2C_BUS_WORKER_H
+#define I2C_BUS_WORKER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include <driver/i2c_master.h>
+
+/*
+ * Async engine for shared I2C buses. On boards where codec, PMIC, touch and
+ * IO expander hang off one bus, a synchronous battery poll issued from the
+ * status-bar path holds the bus mutex and delays latency-sensitive writes
+ * (codec volume, amp enable). Each bus gets one worker task with a two-level
+ * queue: high-priority ops (user-visible control writes) always run before
+ * low-priority housekeeping (battery/PMIC polls), and an op may issue several
+ * blocking transactions back to back, so multi-register polls batch into one
+ * bus acquisition instead of interleaving with other traffic.
+ *
+ * Ops and their completion callbacks run on the worker task; anything touched
+ * from a callback needs its own synchronization (the PMIC drivers just write
+ * ints, which the status-bar reader tolerates).
+ */
+class I2cBusWorker {
+public:
+    enum Priority {
+        kPriorityHigh = 0,  // control writes the user notices immediately
+        kPriorityLow,       // periodic polls, no deadline
+    };
+
+    // Per-bus worker, created (with its task) on first use
+    static I2cBusWorker& GetForBus(i2c_master_bus_handle_t bus);
+
+    void Submit(Priority priority, std::function<void()> op);
+
+private:
+    I2cBusWorker();
+    I2cBusWorker(const I2cBusWorker&) = delete;
+    I2cBusWorker& operator=(const I2cBusWorker&) = delete;
+
+    void WorkLoop();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> high_queue_;
+    std::deque<std::function<void()>> low_queue_;
+};
+
+#endif // I2C_BUS_WORKER_H
@@ -1,11 +1,13 @@
 #include "i2c_device.h"
 
+#include <cstring>
+
 #include <esp_log.h>
 
 #define TAG "I2cDevice"
 
 
-I2cDevice::I2cDevice(i2c_master_bus_handle_t i2c_bus, uint8_t addr) {
+I2cDevice::I2cDevice(i2c_master_bus_handle_t i2c_bus, uint8_t addr) : i2c_bus_(i2c_bus) {
     i2c_device_config_t i2c_device_cfg = {
         .dev_addr_length = I2C_ADDR_BIT_LEN_7,
         .device_address = addr,
@@ -22,6 +24,34 @@ I2cDevice::I2cDevice(i2c_master_bus_handle_t i2c_bus, uint8_t addr) {
 void I2cDevice::WriteReg(uint8_t reg, uint8_t value) {
     uint8_t buffer[2] = {reg, value};
     ESP_ERROR_CHECK(i2c_master_transmit(i2c_device_, buffer, 2, 100));
+    reg_shadow_[reg] = value;
+    reg_shadow_valid_[reg] = true;
+}
+
+bool I2cDevice::WriteRegIfChanged(uint8_t reg, uint8_t value) {
+    if (reg_shadow_valid_[reg] && reg_shadow_[reg] == value) {
+        return false;
+    }
+    WriteReg(reg, value);
+    return true;
+}
+
+uint8_t I2cDevice::UpdateReg(uint8_t reg, uint8_t mask, uint8_t bits) {
+    uint8_t value = reg_shadow_valid_[reg] ? reg_shadow_[reg] : ReadReg(reg);
+    uint8_t new_value = (value & ~mask) | (bits & mask);
+    WriteRegIfChanged(reg, new_value);
+    return new_value;
+}
+
+void I2cDevice::WriteRegs(uint8_t reg, const uint8_t* buffer, size_t length) {
+    uint8_t write_buffer[length + 1];
+    write_buffer[0] = reg;
+    memcpy(write_buffer + 1, buffer, length);
+    ESP_ERROR_CHECK(i2c_master_transmit(i2c_device_, write_buffer, length + 1, 100));
+    for (size_t i = 0; i < length; i++) {
+        reg_shadow_[(uint8_t)(reg + i)] = buffer[i];
+        reg_shadow_valid_[(uint8_t)(reg + i)] = true;
+    }
 }
 
 uint8_t I2cDevice::ReadReg(uint8_t reg) {
@@ -32,4 +62,25 @@ uint8_t I2cDevice::ReadReg(uint8_t reg) {
 
 void I2cDevice::ReadRegs(uint8_t reg, uint8_t* buffer, size_t length) {
     ESP_ERROR_CHECK(i2c_master_transmit_receive(i2c_device_, &reg, 1, buffer, length, 100));
+}
+
+void I2cDevice::WriteRegAsync(uint8_t reg, uint8_t value, std::function<void()> done,
+                              I2cBusWorker::Priority priority) {
+    SubmitAsync(priority, [this, reg, value, done = std::move(done)]() {
+        WriteReg(reg, value);
+        if (done) {
+            done();
+        }
+    });
+}
+
+void I2cDevice::ReadRegAsync(uint8_t reg, std::function<void(uint8_t)> done,
+                             I2cBusWorker::Priority priority) {
+    SubmitAsync(priority, [this, reg, done = std::move(done)]() {
+        done(ReadReg(reg));
+    });
+}
+
+void I2cDevice::SubmitAsync(I2cBusWorker::Priority priority, std::function<void()> op) {
+    I2cBusWorker::GetForBus(i2c_bus_).Submit(priority, std::move(op));
 }
\ No newline at end of file
@@ -1,8 +1,12 @@
 #ifndef I2C_DEVICE_H
 #define I2C_DEVICE_H
 
+#include <functional>
+
 #include <driver/i2c_master.h>
 
+#include "i2c_bus_worker.h"
+
 class I2cDevice {
 public:
     I2cDevice(i2c_master_bus_handle_t i2c_bus, uint8_t addr);
@@ -13,6 +17,35 @@ protected:
     void WriteReg(uint8_t reg, uint8_t value);
     uint8_t ReadReg(uint8_t reg);
     void ReadRegs(uint8_t reg, uint8_t* buffer, size_t length);
+
+    /* Shadow-cache helpers. WriteReg keeps its always-write semantics (some
+     * registers are write-to-trigger), but it records the last written value,
+     * so the helpers below can skip redundant transactions on the audio path:
+     * - WriteRegIfChanged: skip the ~1ms I2C write when the register already
+     *   holds the value, returns true when a write was issued
+     * - UpdateReg: read-modify-write that uses the shadow instead of an I2C
+     *   read when the register has been written before
+     * - WriteRegs: burst-write consecutive registers in one transaction
+     */
+    bool WriteRegIfChanged(uint8_t reg, uint8_t value);
+    uint8_t UpdateReg(uint8_t reg, uint8_t mask, uint8_t bits);
+    void WriteRegs(uint8_t reg, const uint8_t* buffer, size_t length);
+
+    /* Async variants, executed on the shared bus worker (see i2c_bus_worker.h).
+     * Writes default to high priority so e.g. a volume change never queues
+     * behind a battery poll; reads default to low priority since their typical
+     * use is periodic polling. SubmitAsync runs an arbitrary op on the worker,
+     * which is how the PMIC drivers batch a multi-register poll into one slot. */
+    void WriteRegAsync(uint8_t reg, uint8_t value, std::function<void()> done = nullptr,
+                       I2cBusWorker::Priority priority = I2cBusWorker::kPriorityHigh);
+    void ReadRegAsync(uint8_t reg, std::function<void(uint8_t)> done,
+                      I2cBusWorker::Priority priority = I2cBusWorker::kPriorityLow);
+    void SubmitAsync(I2cBusWorker::Priority priority, std::function<void()> op);
+
+private:
+    i2c_master_bus_handle_t i2c_bus_;
+    uint8_t reg_shadow_[256];
+    bool reg_shadow_valid_[256] = {false};
 };
 
 #endif // I2C_DEVICE_H
@@ -1,8 +1,96 @@
 #include "knob.h"
 
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
+
 static const char* TAG = "Knob";
 
-Knob::Knob(gpio_num_t pin_a, gpio_num_t pin_b) {
+#if SOC_PCNT_SUPPORTED
+
+// 全象限解码：一个检位（detent）= 4 个计数
+#define KNOB_COUNTS_PER_DETENT 4
+
+Knob::Knob(gpio_num_t pin_a, gpio_num_t pin_b) : pin_a_(pin_a), pin_b_(pin_b) {
+    pcnt_unit_config_t unit_config = {
+        .low_limit = -KNOB_COUNTS_PER_DETENT,
+        .high_limit = KNOB_COUNTS_PER_DETENT,
+    };
+    ESP_ERROR_CHECK(pcnt_new_unit(&unit_config, &pcnt_unit_));
+
+    // 硬件毛刺滤波：1us 以下的抖动直接丢掉，不再依赖软件去抖
+    pcnt_glitch_filter_config_t filter_config = {
+        .max_glitch_ns = 1000,
+    };
+    ESP_ERROR_CHECK(pcnt_unit_set_glitch_filter(pcnt_unit_, &filter_config));
+
+    pcnt_chan_config_t chan_a_config = {
+        .edge_gpio_num = pin_a,
+        .level_gpio_num = pin_b,
+    };
+    ESP_ERROR_CHECK(pcnt_new_channel(pcnt_unit_, &chan_a_config, &pcnt_chan_a_));
+    pcnt_chan_config_t chan_b_config = {
+        .edge_gpio_num = pin_b,
+        .level_gpio_num = pin_a,
+    };
+    ESP_ERROR_CHECK(pcnt_new_channel(pcnt_unit_, &chan_b_config, &pcnt_chan_b_));
+
+    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(pcnt_chan_a_,
+        PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_INCREASE));
+    ESP_ERROR_CHECK(pcnt_channel_set_level_action(pcnt_chan_a_,
+        PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE));
+    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(pcnt_chan_b_,
+        PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_DECREASE));
+    ESP_ERROR_CHECK(pcnt_channel_set_level_action(pcnt_chan_b_,
+        PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE));
+
+    // 计数到 ±4（一个检位）触发一次中断并自动清零；中断里只累加原子量，
+    // 分发挂到定时器服务任务。分发晚到也不会丢步——计数还在硬件里走
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_unit_, KNOB_COUNTS_PER_DETENT));
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_unit_, -KNOB_COUNTS_PER_DETENT));
+
+    pcnt_event_callbacks_t callbacks = {
+        .on_reach = [](pcnt_unit_handle_t unit, const pcnt_watch_event_data_t* event_data,
+                       void* user_ctx) -> bool {
+            auto* knob = static_cast<Knob*>(user_ctx);
+            knob->pending_detents_.fetch_add(event_data->watch_point_value > 0 ? 1 : -1,
+                                             std::memory_order_relaxed);
+            BaseType_t higher_priority_task_woken = pdFALSE;
+            xTimerPendFunctionCallFromISR(&Knob::DispatchPending, knob, 0,
+                                          &higher_priority_task_woken);
+            return higher_priority_task_woken == pdTRUE;
+        },
+    };
+    ESP_ERROR_CHECK(pcnt_unit_register_event_callbacks(pcnt_unit_, &callbacks, this));
+
+    ESP_ERROR_CHECK(pcnt_unit_enable(pcnt_unit_));
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(pcnt_unit_));
+    ESP_ERROR_CHECK(pcnt_unit_start(pcnt_unit_));
+
+    ESP_LOGI(TAG, "Knob initialized on PCNT with pins A:%d B:%d", pin_a, pin_b);
+}
+
+Knob::~Knob() {
+    if (pcnt_unit_ != nullptr) {
+        pcnt_unit_stop(pcnt_unit_);
+        pcnt_unit_disable(pcnt_unit_);
+        pcnt_del_channel(pcnt_chan_a_);
+        pcnt_del_channel(pcnt_chan_b_);
+        pcnt_del_unit(pcnt_unit_);
+    }
+}
+
+void Knob::DispatchPending(void* arg, uint32_t unused) {
+    auto* knob = static_cast<Knob*>(arg);
+    int detents = knob->pending_detents_.exchange(0, std::memory_order_relaxed);
+    if (detents != 0) {
+        knob->Dispatch(detents);
+    }
+}
+
+#else  // !SOC_PCNT_SUPPORTED
+
+Knob::Knob(gpio_num_t pin_a, gpio_num_t pin_b) : pin_a_(pin_a), pin_b_(pin_b) {
     knob_config_t config = {
         .default_direction = 0,
         .gpio_encoder_a = static_cast<uint8_t>(pin_a),
@@ -38,15 +126,44 @@ Knob::~Knob() {
     }
 }
 
+void Knob::knob_callback(void* arg, void* data) {
+    Knob* knob = static_cast<Knob*>(data);
+    knob_event_t event = iot_knob_get_event(arg);
+    knob->Dispatch(event == KNOB_RIGHT ? 1 : -1);
+}
+
+#endif  // SOC_PCNT_SUPPORTED
+
 void Knob::OnRotate(std::function<void(bool)> callback) {
     on_rotate_ = callback;
 }
 
-void Knob::knob_callback(void* arg, void* data) {
-    Knob* knob = static_cast<Knob*>(data);
-    knob_event_t event = iot_knob_get_event(arg);
-    
-    if (knob->on_rotate_) {
-        knob->on_rotate_(event == KNOB_RIGHT);
+void Knob::OnRotateSteps(std::function<void(bool, int)> callback) {
+    on_rotate_steps_ = callback;
+}
+
+void Knob::Dispatch(int detents) {
+    bool clockwise = detents > 0;
+    int steps = detents > 0 ? detents : -detents;
+
+#if SOC_PCNT_SUPPORTED
+    // 速度加速曲线：相邻分发间隔越短，每个检位放大的步数越多
+    int64_t now_us = esp_timer_get_time();
+    int64_t interval_us = now_us - last_dispatch_us_;
+    last_dispatch_us_ = now_us;
+    if (interval_us < 30 * 1000) {
+        steps *= 4;
+    } else if (interval_us < 100 * 1000) {
+        steps *= 2;
     }
-}
\ No newline at end of file
+#endif
+
+    if (on_rotate_steps_) {
+        on_rotate_steps_(clockwise, steps);
+    } else if (on_rotate_) {
+        // 兼容旧回调：按步数重复触发，加速效果对老调用方同样生效
+        for (int i = 0; i < steps; i++) {
+            on_rotate_(clockwise);
+        }
+    }
+}
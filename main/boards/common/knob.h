@@ -1,25 +1,57 @@
 #ifndef KNOB_H_
 #define KNOB_H_
 
-#include <driver/gpio.h>
+#include <atomic>
 #include <functional>
+
+#include <driver/gpio.h>
 #include <esp_log.h>
+#include <soc/soc_caps.h>
+#if SOC_PCNT_SUPPORTED
+#include <driver/pulse_cnt.h>
+#else
 #include <iot_knob.h>
+#endif
 
+/*
+ * Rotary encoder input. On chips with the PCNT peripheral the quadrature
+ * decode runs entirely in hardware with a glitch filter, so detents are never
+ * lost while the CPU is busy with audio: the counter keeps accumulating and a
+ * single watch-point interrupt per detent hands the aggregate to the
+ * dispatcher. Detents arriving in quick succession get a velocity-based step
+ * multiplier, so a fast spin covers the whole volume range in one motion.
+ * Chips without PCNT fall back to the GPIO-interrupt iot_knob component.
+ */
 class Knob {
 public:
     Knob(gpio_num_t pin_a, gpio_num_t pin_b);
     ~Knob();
 
     void OnRotate(std::function<void(bool)> callback);
+    // 带加速的变体：steps 已按旋转速度放大，慢转每格 1 步
+    void OnRotateSteps(std::function<void(bool, int)> callback);
 
 private:
-    static void knob_callback(void* arg, void* data);
+    void Dispatch(int detents);
 
-    knob_handle_t knob_handle_;
     gpio_num_t pin_a_;
     gpio_num_t pin_b_;
     std::function<void(bool)> on_rotate_;
+    std::function<void(bool, int)> on_rotate_steps_;
+
+#if SOC_PCNT_SUPPORTED
+    static void DispatchPending(void* arg, uint32_t unused);
+
+    pcnt_unit_handle_t pcnt_unit_ = nullptr;
+    pcnt_channel_handle_t pcnt_chan_a_ = nullptr;
+    pcnt_channel_handle_t pcnt_chan_b_ = nullptr;
+    std::atomic<int> pending_detents_{0};
+    int64_t last_dispatch_us_ = 0;
+#else
+    static void knob_callback(void* arg, void* data);
+
+    knob_handle_t knob_handle_ = nullptr;
+#endif
 };
 
-#endif // KNOB_H_
\ No newline at end of file
+#endif // KNOB_H_
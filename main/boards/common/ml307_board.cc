@@ -24,7 +24,7 @@ void Ml307Board::StartNetwork() {
     display->SetStatus(Lang::Strings::DETECTING_MODULE);
 
     while (true) {
-        modem_ = AtModem::Detect(tx_pin_, rx_pin_, dtr_pin_, 921600);
+        modem_ = AtModem::Detect(tx_pin_, rx_pin_, dtr_pin_, CONFIG_ML307_BAUD_RATE);
         if (modem_ != nullptr) {
             break;
         }
@@ -68,6 +68,42 @@ void Ml307Board::StartNetwork() {
     ESP_LOGI(TAG, "ML307 ICCID: %s", iccid.c_str());
 }
 
+bool Ml307Board::StartStandby() {
+    auto& application = Application::GetInstance();
+
+    for (int i = 0; i < 10 && modem_ == nullptr; i++) {
+        modem_ = AtModem::Detect(tx_pin_, rx_pin_, dtr_pin_, CONFIG_ML307_BAUD_RATE);
+        if (modem_ == nullptr) {
+            vTaskDelay(pdMS_TO_TICKS(1000));
+        }
+    }
+    if (modem_ == nullptr) {
+        ESP_LOGW(TAG, "Standby modem not detected");
+        return false;
+    }
+
+    modem_->OnNetworkStateChanged([this, &application](bool network_ready) {
+        if (network_ready) {
+            ESP_LOGI(TAG, "Network is ready");
+        } else {
+            ESP_LOGE(TAG, "Network is down");
+            auto device_state = application.GetDeviceState();
+            if (device_state == kDeviceStateListening || device_state == kDeviceStateSpeaking) {
+                application.Schedule([this, &application]() {
+                    application.SetDeviceState(kDeviceStateIdle);
+                });
+            }
+        }
+    });
+
+    auto result = modem_->WaitForNetworkReady();
+    if (result == NetworkStatus::ErrorInsertPin || result == NetworkStatus::ErrorRegistrationDenied) {
+        ESP_LOGW(TAG, "Standby modem failed to register");
+        return false;
+    }
+    return true;
+}
+
 NetworkInterface* Ml307Board::GetNetwork() {
     return modem_.get();
 }
@@ -107,7 +143,19 @@ std::string Ml307Board::GetBoardJson() {
 }
 
 void Ml307Board::SetPowerSaveMode(bool enabled) {
-    // TODO: Implement power save mode for ML307
+    if (modem_ == nullptr || dtr_pin_ == GPIO_NUM_NC) {
+        return;
+    }
+    if (enabled) {
+        // 模组自主休眠：DTR 拉高 1 秒后入睡。MQTT 会话由模组侧协议栈
+        // 持有（esp-ml307 的 Mqtt 走的就是模组内置栈），保活在模组的
+        // DRX 醒来窗口里自行应答，不唤主控；下行数据或 DTR 拉低会把
+        // 模组叫醒，UART 收发不受影响
+        modem_->SetSleepMode(true, 1);
+        modem_->GetAtUart()->SetDtrPin(true);
+    } else {
+        modem_->GetAtUart()->SetDtrPin(false);
+    }
 }
 
 std::string Ml307Board::GetDeviceStatusJson() {
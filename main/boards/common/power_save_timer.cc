@@ -76,6 +76,7 @@ void PowerSaveTimer::PowerSaveCheck() {
             }
 
             if (cpu_max_freq_ != -1) {
+#if !CONFIG_AUDIO_POWER_SAVE_KEEP_WAKE_WORD
                 // Disable wake word detection
                 auto& audio_service = app.GetAudioService();
                 is_wake_word_running_ = audio_service.IsWakeWordRunning();
@@ -88,6 +89,12 @@ void PowerSaveTimer::PowerSaveCheck() {
                 if (codec) {
                     codec->EnableInput(false);
                 }
+#else
+                // Keep the audio input path alive so the device can wake by
+                // voice: the I2S PM lock holds the chip in tickless-idle DFS
+                // while DMA runs, and light sleep engages in the idle gaps
+                is_wake_word_running_ = false;
+#endif
 
                 esp_pm_config_t pm_config = {
                     .max_freq_mhz = cpu_max_freq_,
@@ -107,9 +114,11 @@ void PowerSaveTimer::WakeUp() {
     ticks_ = 0;
     if (in_sleep_mode_) {
         ESP_LOGI(TAG, "Exiting power save mode");
+        int64_t resume_start_us = esp_timer_get_time();
         in_sleep_mode_ = false;
 
         if (cpu_max_freq_ != -1) {
+            // Restore full frequency first so everything after runs fast
             esp_pm_config_t pm_config = {
                 .max_freq_mhz = cpu_max_freq_,
                 .min_freq_mhz = cpu_max_freq_,
@@ -128,5 +137,8 @@ void PowerSaveTimer::WakeUp() {
         if (on_exit_sleep_mode_) {
             on_exit_sleep_mode_();
         }
+
+        // 复盘唤醒链路耗时，用来盯住 <50ms 的恢复目标
+        ESP_LOGI(TAG, "Resume took %lld ms", (esp_timer_get_time() - resume_start_us) / 1000);
     }
 }
@@ -1,33 +1,93 @@
 #include "sy6970.h"
 #include "board.h"
 #include "display.h"
+#include "status_event.h"
 
 #include <esp_log.h>
+#include <esp_timer.h>
 
 #define TAG "Sy6970"
 
+namespace {
+// 节流间隔与 axp2101.cc 保持一致
+constexpr int64_t kThrottleUs = 5 * 1000000LL;
+constexpr int64_t kCoarseRefreshUs = 60 * 1000000LL;
+}
+
 Sy6970::Sy6970(i2c_master_bus_handle_t i2c_bus, uint8_t addr) : I2cDevice(i2c_bus, addr) {
+    // 同步读一次做缓存种子，之后都走总线 worker 的异步批量刷新
+    status_reg_ = ReadReg(0x0B);
+    vbat_reg_ = ReadReg(0x0E);
+    charge_volt_reg_ = ReadReg(0x06);
+}
+
+void Sy6970::EnableIrq(gpio_num_t irq_gpio) {
+    gpio_config_t config = {
+        .pin_bit_mask = 1ULL << irq_gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_NEGEDGE,  // INT 为低有效脉冲
+    };
+    ESP_ERROR_CHECK(gpio_config(&config));
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_ERROR_CHECK(err);
+    }
+    ESP_ERROR_CHECK(gpio_isr_handler_add(irq_gpio, [](void* arg) {
+        static_cast<Sy6970*>(arg)->irq_pending_.store(true);
+    }, this));
+    irq_enabled_ = true;
+}
+
+void Sy6970::RefreshStateAsync() {
+    // 缓存够新且没有中断挂起时完全不碰总线
+    bool irq = irq_pending_.load();
+    int64_t now_us = esp_timer_get_time();
+    if (!irq && now_us - last_refresh_us_ < (irq_enabled_ ? kCoarseRefreshUs : kThrottleUs)) {
+        return;
+    }
+    if (poll_pending_.exchange(true)) {
+        return;
+    }
+    irq_pending_.store(false);
+    // 三个寄存器打包成 worker 上的一个低优先级操作
+    SubmitAsync(I2cBusWorker::kPriorityLow, [this]() {
+        uint8_t old_status = status_reg_;
+        uint8_t old_vbat = vbat_reg_;
+        status_reg_ = ReadReg(0x0B);
+        vbat_reg_ = ReadReg(0x0E);
+        charge_volt_reg_ = ReadReg(0x06);
+        last_refresh_us_ = esp_timer_get_time();
+        poll_pending_.store(false);
+        // 充电状态或电池电压变了才通知状态栏
+        if (old_status != status_reg_ || old_vbat != vbat_reg_) {
+            StatusEventManager::GetInstance().Publish(StatusEvent::kBattery);
+        }
+    });
 }
 
 int Sy6970::GetChangingStatus() {
-    return (ReadReg(0x0B) >> 3) & 0x03;
+    return (status_reg_ >> 3) & 0x03;
 }
 
 bool Sy6970::IsCharging() {
+    RefreshStateAsync();
     return GetChangingStatus() != 0;
 }
 
 bool Sy6970::IsPowerGood() {
-    return (ReadReg(0x0B) & 0x04) != 0;
+    RefreshStateAsync();
+    return (status_reg_ & 0x04) != 0;
 }
 
 bool Sy6970::IsChargingDone() {
+    RefreshStateAsync();
     return GetChangingStatus() == 3;
 }
 
 int Sy6970::GetBatteryVoltage() {
-    uint8_t value = ReadReg(0x0E);
-    value &= 0x7F;
+    uint8_t value = vbat_reg_ & 0x7F;
     if (value == 0) {
         return 0;
     }
@@ -35,8 +95,7 @@ int Sy6970::GetBatteryVoltage() {
 }
 
 int Sy6970::GetChargeTargetVoltage() {
-    uint8_t value = ReadReg(0x06);
-    value = (value & 0xFC) >> 2;
+    uint8_t value = (charge_volt_reg_ & 0xFC) >> 2;
     if (value > 0x30) {
         return 4608;
     }
@@ -44,6 +103,7 @@ int Sy6970::GetChargeTargetVoltage() {
 }
 
 int Sy6970::GetBatteryLevel() {
+    RefreshStateAsync();
     int level = 0;
     // 电池所能掉电的最低电压
     int battery_minimum_voltage = 3200;
@@ -1,6 +1,10 @@
 #ifndef __SY6970_H__
 #define __SY6970_H__
 
+#include <atomic>
+
+#include <driver/gpio.h>
+
 #include "i2c_device.h"
 
 class Sy6970 : public I2cDevice {
@@ -12,10 +16,30 @@ public:
     int GetBatteryLevel();
     void PowerOff();
 
+    /* Boards with the charger INT line wired can call this once after
+     * construction; state then refreshes on interrupt plus a coarse
+     * once-a-minute fallback instead of per status-bar pass. The SY6970
+     * pulses INT on charge/VBUS state changes with IRQs enabled by default,
+     * so only the GPIO side needs configuring. */
+    void EnableIrq(gpio_num_t irq_gpio);
+
 private:
     int GetChangingStatus();
     int GetBatteryVoltage();
     int GetChargeTargetVoltage();
+
+    /* Getters compute from a RAM cache of the three status registers and
+     * kick a low-priority batched refresh on the bus worker (same pattern
+     * as axp2101.cc). Seeded synchronously in the constructor. */
+    void RefreshStateAsync();
+
+    std::atomic<bool> poll_pending_{false};
+    std::atomic<bool> irq_pending_{false};
+    bool irq_enabled_ = false;
+    int64_t last_refresh_us_ = 0;
+    uint8_t status_reg_ = 0;       // 0x0B
+    uint8_t vbat_reg_ = 0;         // 0x0E
+    uint8_t charge_volt_reg_ = 0;  // 0x06
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,128 @@
+#include "touch_input.h"
+#include "application.h"
+#include "board.h"
+#include "task_registry.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/task.h>
+
+#include <cstdlib>
+
+static const char* TAG = "TouchInput";
+
+namespace {
+// 按住时的采样周期；松手后完全静默等中断
+constexpr TickType_t kPollPeriodTicks = pdMS_TO_TICKS(20);
+// 轻点判定：按压时长与位移的上限
+constexpr int64_t kTapMaxDurationUs = 500 * 1000;
+constexpr int kTapMaxTravelPx = 30;
+}
+
+TouchInputPipeline::TouchInputPipeline(std::function<bool(int& x, int& y)> reader)
+    : reader_(std::move(reader)) {
+    wake_sem_ = xSemaphoreCreateBinary();
+    int core = TaskRegistry::GetInstance().ResolveCore("touch_input", 1);
+    xTaskCreatePinnedToCore([](void* arg) {
+        static_cast<TouchInputPipeline*>(arg)->DrainTask();
+        vTaskDelete(NULL);
+    }, "touch_input", 2048 * 2, this, 5, nullptr, core);
+}
+
+void TouchInputPipeline::NotifyFromIsr() {
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    xSemaphoreGiveFromISR(wake_sem_, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+void TouchInputPipeline::OnTap(std::function<void(int x, int y)> callback) {
+    on_tap_ = std::move(callback);
+}
+
+void TouchInputPipeline::DrainTask() {
+    while (true) {
+        // 手指按住时以固定周期跟踪移动；松开后回到纯中断驱动
+        xSemaphoreTake(wake_sem_, was_pressed_ ? kPollPeriodTicks : portMAX_DELAY);
+        int x = 0, y = 0;
+        bool pressed = reader_(x, y);
+        HandleSample(pressed, x, y);
+    }
+}
+
+void TouchInputPipeline::HandleSample(bool pressed, int x, int y) {
+    if (pressed) {
+        // 移动合并：快速滑动只更新快照，不产生事件积压
+        cur_x_.store(x, std::memory_order_relaxed);
+        cur_y_.store(y, std::memory_order_relaxed);
+    }
+    cur_pressed_.store(pressed, std::memory_order_release);
+
+    if (pressed == was_pressed_) {
+        if (pressed && (std::abs(x - press_x_) > kTapMaxTravelPx ||
+                        std::abs(y - press_y_) > kTapMaxTravelPx)) {
+            moved_ = true;
+        }
+        return;
+    }
+
+    // 按下/抬起沿走无损环，两次 indev 轮询之间的快速轻点不会被吞掉
+    PushEdge(pressed, pressed ? x : cur_x_.load(std::memory_order_relaxed),
+             pressed ? y : cur_y_.load(std::memory_order_relaxed));
+
+    int64_t now_us = esp_timer_get_time();
+    if (pressed) {
+        press_x_ = x;
+        press_y_ = y;
+        press_time_us_ = now_us;
+        moved_ = false;
+    } else if (!moved_ && now_us - press_time_us_ < kTapMaxDurationUs && on_tap_) {
+        // 离散手势才上主循环，一次手势一条 Schedule
+        int tap_x = press_x_, tap_y = press_y_;
+        Application::GetInstance().Schedule([this, tap_x, tap_y]() {
+            on_tap_(tap_x, tap_y);
+        });
+    }
+    was_pressed_ = pressed;
+}
+
+void TouchInputPipeline::PushEdge(bool pressed, int x, int y) {
+    uint8_t head = ring_head_.load(std::memory_order_relaxed);
+    uint8_t tail = ring_tail_.load(std::memory_order_acquire);
+    if ((uint8_t)(head - tail) >= kRingSize) {
+        // 环满丢最旧的沿；快照仍然正确，最坏只丢一次历史轻点
+        ring_tail_.store(tail + 1, std::memory_order_release);
+    }
+    ring_[head % kRingSize] = Edge{(int16_t)x, (int16_t)y, pressed};
+    ring_head_.store(head + 1, std::memory_order_release);
+}
+
+#ifdef HAVE_LVGL
+
+void TouchInputPipeline::AttachIndev() {
+    auto display = Board::GetInstance().GetDisplay();
+    DisplayLockGuard lock(display);
+    lv_indev_t* indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_user_data(indev, this);
+    lv_indev_set_read_cb(indev, [](lv_indev_t* indev, lv_indev_data_t* data) {
+        auto pipeline = static_cast<TouchInputPipeline*>(lv_indev_get_user_data(indev));
+        uint8_t tail = pipeline->ring_tail_.load(std::memory_order_relaxed);
+        uint8_t head = pipeline->ring_head_.load(std::memory_order_acquire);
+        if (tail != head) {
+            const Edge& edge = pipeline->ring_[tail % kRingSize];
+            data->point.x = edge.x;
+            data->point.y = edge.y;
+            data->state = edge.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+            pipeline->ring_tail_.store(tail + 1, std::memory_order_release);
+            data->continue_reading = (uint8_t)(tail + 1) != head;
+        } else {
+            data->point.x = pipeline->cur_x_.load(std::memory_order_relaxed);
+            data->point.y = pipeline->cur_y_.load(std::memory_order_relaxed);
+            data->state = pipeline->cur_pressed_.load(std::memory_order_acquire)
+                              ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+        }
+    });
+    ESP_LOGI(TAG, "Touch indev attached");
+}
+
+#endif  // HAVE_LVGL
@@ -0,0 +1,75 @@
+#ifndef TOUCH_INPUT_H_
+#define TOUCH_INPUT_H_
+
+#include "display.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <atomic>
+#include <functional>
+
+/*
+ * Touch input pipeline. The controller is drained on a small dedicated task
+ * (woken by the touch INT line, polling at 50Hz only while a finger is down)
+ * and fed to LVGL through a pointer indev, so fast drag gestures never enter
+ * the main task queue and cannot delay audio callbacks queued behind them.
+ *
+ * Coalescing follows the kernel input model: motion just overwrites the
+ * latest-position snapshot (LVGL only wants the current point anyway), while
+ * press/release edges go through a small lossless ring so a quick tap between
+ * two indev polls is not swallowed. Only discrete gestures (taps) are handed
+ * to the main loop, one Schedule call per gesture.
+ */
+class TouchInputPipeline {
+public:
+    // reader polls the controller (usually over I2C), returns whether a
+    // finger is down and fills x/y when it is. Runs on the drain task only.
+    explicit TouchInputPipeline(std::function<bool(int& x, int& y)> reader);
+
+    // Hook for the touch INT line; wakes the drain task
+    void NotifyFromIsr();
+
+    // Tap gesture (short press without significant motion), delivered on the
+    // main loop via Application::Schedule
+    void OnTap(std::function<void(int x, int y)> callback);
+
+#ifdef HAVE_LVGL
+    // Call once the LVGL display is up: registers a pointer indev reading
+    // straight from the pipeline's snapshot/ring, bypassing the main loop
+    void AttachIndev();
+#endif
+
+private:
+    struct Edge {
+        int16_t x;
+        int16_t y;
+        bool pressed;
+    };
+    static constexpr int kRingSize = 8;  // 2 的幂，单写单读无锁环
+
+    void DrainTask();
+    void HandleSample(bool pressed, int x, int y);
+    void PushEdge(bool pressed, int x, int y);
+
+    std::function<bool(int&, int&)> reader_;
+    std::function<void(int, int)> on_tap_;
+    SemaphoreHandle_t wake_sem_ = nullptr;
+
+    // 写端只有 drain 任务，读端只有 LVGL 任务
+    Edge ring_[kRingSize];
+    std::atomic<uint8_t> ring_head_{0};
+    std::atomic<uint8_t> ring_tail_{0};
+    std::atomic<int> cur_x_{0};
+    std::atomic<int> cur_y_{0};
+    std::atomic<bool> cur_pressed_{false};
+
+    // 手势状态，只在 drain 任务上读写
+    bool was_pressed_ = false;
+    int press_x_ = 0;
+    int press_y_ = 0;
+    int64_t press_time_us_ = 0;
+    bool moved_ = false;
+};
+
+#endif  // TOUCH_INPUT_H_
@@ -4,12 +4,14 @@
 #include "application.h"
 #include "system_info.h"
 #include "settings.h"
+#include "status_event.h"
 #include "assets/lang_config.h"
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_network.h>
 #include <esp_log.h>
+#include <esp_wifi.h>
 
 #include <font_awesome.h>
 #include <wifi_station.h>
@@ -103,6 +105,8 @@ void WifiBoard::StartNetwork() {
         std::string notification = Lang::Strings::CONNECTED_TO;
         notification += ssid;
         display->ShowNotification(notification.c_str(), 30000);
+        // 连上就推一次网络图标更新，不等状态栏的 10 秒轮询
+        StatusEventManager::GetInstance().Publish(StatusEvent::kNetwork);
     });
     wifi_station.Start();
 
@@ -140,24 +144,87 @@ const char* WifiBoard::GetNetworkStateIcon() {
 
 std::string WifiBoard::GetBoardJson() {
     // Set the board type for OTA
+    // type/name/mac 运行期不变，只有网络状态段每次重取
+    static const std::string head = R"({"type":")" BOARD_TYPE R"(","name":")" BOARD_NAME R"(",)";
+    static const std::string tail = R"("mac":")" + SystemInfo::GetMacAddress() + R"("})";
     auto& wifi_station = WifiStation::GetInstance();
-    std::string board_json = R"({)";
-    board_json += R"("type":")" + std::string(BOARD_TYPE) + R"(",)";
-    board_json += R"("name":")" + std::string(BOARD_NAME) + R"(",)";
+    std::string board_json = head;
     if (!wifi_config_mode_) {
         board_json += R"("ssid":")" + wifi_station.GetSsid() + R"(",)";
         board_json += R"("rssi":)" + std::to_string(wifi_station.GetRssi()) + R"(,)";
         board_json += R"("channel":)" + std::to_string(wifi_station.GetChannel()) + R"(,)";
         board_json += R"("ip":")" + wifi_station.GetIpAddress() + R"(",)";
     }
-    board_json += R"("mac":")" + SystemInfo::GetMacAddress() + R"(")";
-    board_json += R"(})";
+    board_json += tail;
     return board_json;
 }
 
 void WifiBoard::SetPowerSaveMode(bool enabled) {
     auto& wifi_station = WifiStation::GetInstance();
     wifi_station.SetPowerSaveMode(enabled);
+    // 省电态把 modem-sleep 提到 MAX：站点只在 listen interval 的 beacon
+    // 窗口醒来，broker 的 MQTT/TCP 保活段在窗口内收发，射频其余时间
+    // 下电。退出省电态回 MIN，保住服务器下推的时延
+    esp_wifi_set_ps(enabled ? WIFI_PS_MAX_MODEM : WIFI_PS_MIN_MODEM);
+}
+
+void WifiBoard::SampleRadioQuality() {
+    if (wifi_config_mode_) {
+        return;
+    }
+    auto& wifi_station = WifiStation::GetInstance();
+    if (!wifi_station.IsConnected()) {
+        // 断开后历史均值作废，重连从首个采样重建
+        rssi_ewma_valid_ = false;
+        return;
+    }
+
+    int8_t rssi = wifi_station.GetRssi();
+    rssi_last_ = rssi;
+    if (!rssi_ewma_valid_) {
+        rssi_ewma_x4_ = rssi * 4;
+        rssi_ewma_valid_ = true;
+        rssi_min_ = rssi;
+    } else {
+        rssi_ewma_x4_ += (rssi * 4 - rssi_ewma_x4_) / 4;
+        if (rssi < rssi_min_) {
+            rssi_min_ = rssi;
+        }
+    }
+    radio_samples_++;
+
+    // 均值跌破 -78 dBm 判劣化（回升到 -74 以上才解除，留滞回窗口）；
+    // 单次采样比均值低 12 dB 以上视作快衰落，同样提前报警
+    int ewma = rssi_ewma_x4_ / 4;
+    bool degraded = radio_degraded_ ? (ewma <= -74) : (ewma <= -78 || rssi <= ewma - 12);
+    if (degraded != radio_degraded_) {
+        radio_degraded_ = degraded;
+        if (degraded) {
+            degraded_events_++;
+            ESP_LOGW(TAG, "Radio degraded, rssi %d dBm (ewma %d)", rssi, ewma);
+        } else {
+            ESP_LOGI(TAG, "Radio recovered, rssi %d dBm (ewma %d)", rssi, ewma);
+        }
+        Application::GetInstance().GetAudioService().SetRadioDegraded(degraded);
+    }
+}
+
+std::string WifiBoard::GetRadioTelemetryJson() {
+    if (radio_samples_ == 0) {
+        return "";
+    }
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer),
+             "{\"rssi\":%d,\"rssi_ewma\":%d,\"rssi_min\":%d,\"degraded\":%s,"
+             "\"degraded_events\":%lu,\"samples\":%lu}",
+             (int)rssi_last_, rssi_ewma_x4_ / 4, (int)rssi_min_,
+             radio_degraded_ ? "true" : "false",
+             (unsigned long)degraded_events_, (unsigned long)radio_samples_);
+    // 窗口统计取走即清零，下个上报周期重新累计
+    rssi_min_ = rssi_last_;
+    radio_samples_ = 0;
+    degraded_events_ = 0;
+    return std::string(buffer);
 }
 
 void WifiBoard::ResetWifiConfiguration() {
@@ -165,6 +232,7 @@ void WifiBoard::ResetWifiConfiguration() {
     {
         Settings settings("wifi", true);
         settings.SetInt("force_ap", 1);
+        Settings::FlushAll();
     }
     GetDisplay()->ShowNotification(Lang::Strings::ENTERING_WIFI_CONFIG_MODE);
     vTaskDelay(pdMS_TO_TICKS(1000));
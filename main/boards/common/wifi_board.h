@@ -19,6 +19,18 @@ public:
     virtual void ResetWifiConfiguration();
     virtual AudioCodec* GetAudioCodec() override { return nullptr; }
     virtual std::string GetDeviceStatusJson() override;
+    virtual void SampleRadioQuality() override;
+    virtual std::string GetRadioTelemetryJson() override;
+
+private:
+    // RSSI EWMA，定点放大 4 倍；只在主循环任务上读写
+    int rssi_ewma_x4_ = 0;
+    bool rssi_ewma_valid_ = false;
+    bool radio_degraded_ = false;
+    int8_t rssi_last_ = 0;
+    int8_t rssi_min_ = 0;
+    uint32_t radio_samples_ = 0;
+    uint32_t degraded_events_ = 0;
 };
 
 #endif // WIFI_BOARD_H
@@ -18,6 +18,7 @@
 #include <esp_lcd_st77916.h>
 #include "esp_lcd_touch_cst816s.h"
 #include "touch.h"
+#include "touch_input.h"
 
 #include "driver/temperature_sensor.h"
 #include <freertos/FreeRTOS.h>
@@ -384,6 +385,7 @@ class EspS3Cat : public WifiBoard {
 private:
     i2c_master_bus_handle_t i2c_bus_;
     Cst816s* cst816s_;
+    TouchInputPipeline* touch_pipeline_ = nullptr;
     Charge* charge_;
     Button boot_button_;
     Display* display_ = nullptr;
@@ -450,39 +452,9 @@ private:
 
     static void touch_isr_callback(void* arg)
     {
-        Cst816s* touchpad = static_cast<Cst816s*>(arg);
-        if (touchpad != nullptr) {
-            touchpad->NotifyTouchEvent();
-        }
-    }
-
-    static void touch_event_task(void* arg)
-    {
-        Cst816s* touchpad = static_cast<Cst816s*>(arg);
-        if (touchpad == nullptr) {
-            ESP_LOGE(TAG, "Invalid touchpad pointer in touch_event_task");
-            vTaskDelete(NULL);
-            return;
-        }
-
-        while (true) {
-            if (touchpad->WaitForTouchEvent()) {
-                auto &app = Application::GetInstance();
-                auto &board = (EspS3Cat &)Board::GetInstance();
-
-                ESP_LOGI(TAG, "Touch event, TP_PIN_NUM_INT: %d", gpio_get_level(TP_PIN_NUM_INT));
-                touchpad->UpdateTouchPoint();
-                auto touch_event = touchpad->CheckTouchEvent();
-
-                if (touch_event == Cst816s::TOUCH_RELEASE) {
-                    if (app.GetDeviceState() == kDeviceStateStarting &&
-                            !WifiStation::GetInstance().IsConnected()) {
-                        board.ResetWifiConfiguration();
-                    } else {
-                        app.ToggleChatState();
-                    }
-                }
-            }
+        auto pipeline = static_cast<TouchInputPipeline*>(arg);
+        if (pipeline != nullptr) {
+            pipeline->NotifyFromIsr();
         }
     }
 
@@ -496,7 +468,24 @@ private:
     {
         cst816s_ = new Cst816s(i2c_bus_, 0x15);
 
-        xTaskCreatePinnedToCore(touch_event_task, "touch_task", 4 * 1024, cst816s_, 5, NULL, 1);
+        // 触摸走输入管线：INT 唤醒 drain 任务、移动合并进快照、按抬沿直
+        // 接喂 LVGL indev，不再经过主循环的任务队列
+        touch_pipeline_ = new TouchInputPipeline([this](int& x, int& y) {
+            cst816s_->UpdateTouchPoint();
+            auto& tp = cst816s_->GetTouchPoint();
+            x = tp.x;
+            y = tp.y;
+            return tp.num > 0;
+        });
+        touch_pipeline_->OnTap([this](int x, int y) {
+            auto& app = Application::GetInstance();
+            if (app.GetDeviceState() == kDeviceStateStarting &&
+                    !WifiStation::GetInstance().IsConnected()) {
+                ResetWifiConfiguration();
+            } else {
+                app.ToggleChatState();
+            }
+        });
 
         const gpio_config_t int_gpio_config = {
             .pin_bit_mask = (1ULL << TP_PIN_NUM_INT),
@@ -507,7 +496,7 @@ private:
         gpio_config(&int_gpio_config);
         gpio_install_isr_service(0);
         gpio_intr_enable(TP_PIN_NUM_INT);
-        gpio_isr_handler_add(TP_PIN_NUM_INT, EspS3Cat::touch_isr_callback, cst816s_);
+        gpio_isr_handler_add(TP_PIN_NUM_INT, EspS3Cat::touch_isr_callback, touch_pipeline_);
     }
 
     void InitializeSpi()
@@ -593,6 +582,10 @@ public:
 
         InitializeSpi();
         Initializest77916Display(pcb_verison);
+#ifndef CONFIG_USE_EMOTE_MESSAGE_STYLE
+        // LVGL 起来之后再挂 indev，触摸滚动/拖动全程不过主循环
+        touch_pipeline_->AttachIndev();
+#endif
         InitializeButtons();
     }
 
@@ -188,10 +188,11 @@ private:
         assert(ret == ESP_OK);
     }
 
-    void OnKnobRotate(bool clockwise) {
+    void OnKnobRotate(bool clockwise, int steps) {
         auto codec = GetAudioCodec();
         int current_volume = codec->output_volume();
-        int new_volume = current_volume + (clockwise ? -5 : 5); 
+        // steps 已按旋转速度加速，快速旋转一把就能拉满整个音量区间
+        int new_volume = current_volume + steps * (clockwise ? -5 : 5);
 
         // 确保音量在有效范围内
         if (new_volume > 100) {
@@ -216,9 +217,9 @@ private:
 
     void InitializeKnob() {
         knob_ = std::make_unique<Knob>(BSP_KNOB_A_PIN, BSP_KNOB_B_PIN);
-        knob_->OnRotate([this](bool clockwise) {
-            ESP_LOGD(TAG, "Knob rotation detected. Clockwise:%s", clockwise ? "true" : "false");
-            OnKnobRotate(clockwise);
+        knob_->OnRotateSteps([this](bool clockwise, int steps) {
+            ESP_LOGD(TAG, "Knob rotation detected. Clockwise:%s steps:%d", clockwise ? "true" : "false", steps);
+            OnKnobRotate(clockwise, steps);
         });
         ESP_LOGI(TAG, "Knob initialized with pins A:%d B:%d", BSP_KNOB_A_PIN, BSP_KNOB_B_PIN);
     }
@@ -16,6 +16,7 @@
 #include <esp_log.h>
 #include <esp_err.h>
 #include <esp_lvgl_port.h>
+#include <esp_cache.h>
 
 #define TAG "CustomLcdDisplay"
 
@@ -49,9 +50,10 @@ void CustomLcdDisplay::lvgl_port_flush_callback(lv_display_t *drv, const lv_area
     const int x_end = area->x2;
     const int y_start = area->y1;
     const int y_end = area->y2;
+#if CONFIG_LCD_PSRAM_FLUSH_BOUNCE
     const int width = x_end - x_start + 1;
     const int height = y_end - y_start + 1;
-    
+
     int32_t hor_res = lv_display_get_horizontal_resolution(drv);
     int32_t ver_res = lv_display_get_vertical_resolution(drv);
 
@@ -185,8 +187,20 @@ void CustomLcdDisplay::lvgl_port_flush_callback(lv_display_t *drv, const lv_area
                 y_end_tmp -= max_height;
             }
         }
-    } else {
+    } else
+#endif
+    {
+        // DMA 直接从 PSRAM 帧缓冲读数据：LVGL 的渲染写都停在 cache 里，
+        // 必须先把本次失效区域回写，否则 DMA 读到的是旧行。FULL 渲染
+        // 模式下 flush 区域在缓冲里是连续的，只回写这一段（UNALIGNED
+        // 标志让驱动自己按 cache 行对齐两端），不做整缓冲回写
+        size_t bytes = (size_t)len * sizeof(uint16_t);
+        esp_cache_msync(color_map, bytes, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
         esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end + 1, y_end + 1, color_map);
+        // 单缓冲直出必须等 DMA 读完才能让 LVGL 重用这块缓冲
+        if (trans_done_sem) {
+            xSemaphoreTake(trans_done_sem, portMAX_DELAY);
+        }
     }
     lv_disp_flush_ready(drv);
 }
@@ -216,8 +230,10 @@ CustomLcdDisplay::CustomLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_p
     port_cfg.timer_period_ms = 50;
     lvgl_port_init(&port_cfg);
     trans_done_sem = xSemaphoreCreateCounting(1, 0);
+#if CONFIG_LCD_PSRAM_FLUSH_BOUNCE
     trans_buf_1 = (uint16_t *)heap_caps_malloc(DISPLAY_TRANS_SIZE * sizeof(uint16_t), MALLOC_CAP_DMA);
     trans_buf_2 = (uint16_t *)heap_caps_malloc(DISPLAY_TRANS_SIZE * sizeof(uint16_t), MALLOC_CAP_DMA);
+#endif
 #if 0
     ESP_LOGI(TAG, "Adding LCD screen");
     const lvgl_port_display_cfg_t display_cfg = {
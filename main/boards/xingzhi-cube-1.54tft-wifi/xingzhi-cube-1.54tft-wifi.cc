@@ -17,8 +17,38 @@
 #include <driver/rtc_io.h>
 #include <esp_sleep.h>
 
+#include "board_descriptor.h"
+
 #define TAG "XINGZHI_CUBE_1_54TFT_WIFI"
 
+namespace {
+
+// 样板用法：把 config.h 的宏聚成 constexpr 描述符，约束在编译期校验
+constexpr BoardDescriptor kBoard = {
+    .input_sample_rate = AUDIO_INPUT_SAMPLE_RATE,
+    .output_sample_rate = AUDIO_OUTPUT_SAMPLE_RATE,
+    .audio = {
+        .mic_sck = AUDIO_I2S_MIC_GPIO_SCK,
+        .mic_ws = AUDIO_I2S_MIC_GPIO_WS,
+        .mic_din = AUDIO_I2S_MIC_GPIO_DIN,
+        .spk_bclk = AUDIO_I2S_SPK_GPIO_BCLK,
+        .spk_lrck = AUDIO_I2S_SPK_GPIO_LRCK,
+        .spk_dout = AUDIO_I2S_SPK_GPIO_DOUT,
+    },
+    .display = {
+        .width = DISPLAY_WIDTH,
+        .height = DISPLAY_HEIGHT,
+        .offset_x = DISPLAY_OFFSET_X,
+        .offset_y = DISPLAY_OFFSET_Y,
+        .swap_xy = DISPLAY_SWAP_XY,
+        .mirror_x = DISPLAY_MIRROR_X,
+        .mirror_y = DISPLAY_MIRROR_Y,
+    },
+};
+static_assert(kBoard.valid(), "inconsistent board configuration");
+
+} // namespace
+
 class XINGZHI_CUBE_1_54TFT_WIFI : public WifiBoard {
 private:
     Button boot_button_;
@@ -73,7 +103,7 @@ private:
         buscfg.sclk_io_num = DISPLAY_SCL;
         buscfg.quadwp_io_num = GPIO_NUM_NC;
         buscfg.quadhd_io_num = GPIO_NUM_NC;
-        buscfg.max_transfer_sz = DISPLAY_WIDTH * DISPLAY_HEIGHT * sizeof(uint16_t);
+        buscfg.max_transfer_sz = kBoard.display.width * kBoard.display.height * sizeof(uint16_t);
         ESP_ERROR_CHECK(spi_bus_initialize(SPI3_HOST, &buscfg, SPI_DMA_CH_AUTO));
     }
 
@@ -142,12 +172,13 @@ private:
         ESP_ERROR_CHECK(esp_lcd_new_panel_st7789(panel_io_, &panel_config, &panel_));
         ESP_ERROR_CHECK(esp_lcd_panel_reset(panel_));
         ESP_ERROR_CHECK(esp_lcd_panel_init(panel_));
-        ESP_ERROR_CHECK(esp_lcd_panel_swap_xy(panel_, DISPLAY_SWAP_XY));
-        ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel_, DISPLAY_MIRROR_X, DISPLAY_MIRROR_Y));
+        ESP_ERROR_CHECK(esp_lcd_panel_swap_xy(panel_, kBoard.display.swap_xy));
+        ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel_, kBoard.display.mirror_x, kBoard.display.mirror_y));
         ESP_ERROR_CHECK(esp_lcd_panel_invert_color(panel_, true));
 
-        display_ = new SpiLcdDisplay(panel_io_, panel_, DISPLAY_WIDTH, DISPLAY_HEIGHT, DISPLAY_OFFSET_X, DISPLAY_OFFSET_Y, 
-            DISPLAY_MIRROR_X, DISPLAY_MIRROR_Y, DISPLAY_SWAP_XY);
+        display_ = new SpiLcdDisplay(panel_io_, panel_, kBoard.display.width, kBoard.display.height,
+            kBoard.display.offset_x, kBoard.display.offset_y,
+            kBoard.display.mirror_x, kBoard.display.mirror_y, kBoard.display.swap_xy);
     }
 
 public:
@@ -164,8 +195,9 @@ public:
     }
 
     virtual AudioCodec* GetAudioCodec() override {
-        static NoAudioCodecSimplex audio_codec(AUDIO_INPUT_SAMPLE_RATE, AUDIO_OUTPUT_SAMPLE_RATE,
-            AUDIO_I2S_SPK_GPIO_BCLK, AUDIO_I2S_SPK_GPIO_LRCK, AUDIO_I2S_SPK_GPIO_DOUT, AUDIO_I2S_MIC_GPIO_SCK, AUDIO_I2S_MIC_GPIO_WS, AUDIO_I2S_MIC_GPIO_DIN);
+        static NoAudioCodecSimplex audio_codec(kBoard.input_sample_rate, kBoard.output_sample_rate,
+            kBoard.audio.spk_bclk, kBoard.audio.spk_lrck, kBoard.audio.spk_dout,
+            kBoard.audio.mic_sck, kBoard.audio.mic_ws, kBoard.audio.mic_din);
         return &audio_codec;
     }
 
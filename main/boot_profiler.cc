@@ -0,0 +1,48 @@
+#include "boot_profiler.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#include <cstring>
+
+#define TAG "BootProfiler"
+
+void BootProfiler::BeginSpan(const char* name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    spans_.push_back(Span{name, esp_timer_get_time(), 0});
+}
+
+void BootProfiler::EndSpan(const char* name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = spans_.rbegin(); it != spans_.rend(); ++it) {
+        if (it->end_us == 0 && strcmp(it->name, name) == 0) {
+            it->end_us = esp_timer_get_time();
+            return;
+        }
+    }
+    ESP_LOGW(TAG, "EndSpan without BeginSpan: %s", name);
+}
+
+std::string BootProfiler::GetJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string json = "[";
+    for (const auto& span : spans_) {
+        int64_t end_us = span.end_us != 0 ? span.end_us : esp_timer_get_time();
+        char buffer[96];
+        snprintf(buffer, sizeof(buffer), "%s{\"name\":\"%s\",\"start_ms\":%lld,\"duration_ms\":%lld}",
+                 json.size() > 1 ? "," : "", span.name, span.start_us / 1000, (end_us - span.start_us) / 1000);
+        json += buffer;
+    }
+    json += "]";
+    return json;
+}
+
+void BootProfiler::LogSummary() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ESP_LOGI(TAG, "Boot stage breakdown:");
+    for (const auto& span : spans_) {
+        int64_t end_us = span.end_us != 0 ? span.end_us : esp_timer_get_time();
+        ESP_LOGI(TAG, "  %-16s %6lld ms (at %lld ms)", span.name,
+                 (end_us - span.start_us) / 1000, span.start_us / 1000);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * 启动阶段计时器。Application::Start 里用 BootSpan 给每个启动阶段记录
+ * esp_timer 起止时间，启动完成后打一份汇总日志，之后随时可以通过
+ * self.get_boot_profile 工具在线上查询各阶段耗时。
+ */
+class BootProfiler {
+public:
+    static BootProfiler& GetInstance() {
+        static BootProfiler instance;
+        return instance;
+    }
+
+    void BeginSpan(const char* name);
+    void EndSpan(const char* name);
+    // 汇总为 JSON：[{"name":...,"start_ms":...,"duration_ms":...}, ...]
+    std::string GetJson() const;
+    void LogSummary() const;
+
+private:
+    BootProfiler() = default;
+    BootProfiler(const BootProfiler&) = delete;
+    BootProfiler& operator=(const BootProfiler&) = delete;
+
+    struct Span {
+        const char* name;   // 必须是字符串字面量
+        int64_t start_us;
+        int64_t end_us;     // 0 表示还没结束
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Span> spans_;
+};
+
+// 作用域结束时自动结束对应阶段
+class BootSpan {
+public:
+    explicit BootSpan(const char* name) : name_(name) {
+        BootProfiler::GetInstance().BeginSpan(name_);
+    }
+    ~BootSpan() {
+        BootProfiler::GetInstance().EndSpan(name_);
+    }
+
+private:
+    const char* name_;
+};
+
+#endif // BOOT_PROFILER_H
@@ -0,0 +1,107 @@
+#ifndef CALLABLE_RING_H
+#define CALLABLE_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Lock-free multi-producer / single-consumer ring of in-place callables.
+ *
+ * Application::Schedule is called from the audio and protocol tasks many
+ * times per second, and the old deque + mutex queue occasionally stalled a
+ * high-priority producer while the main loop drained a burst of tasks. This
+ * ring stores each callable inline in a fixed slot (no heap allocation for
+ * captures that fit StorageSize) and producers only touch the slot they
+ * claimed, so a push never blocks and never contends a lock.
+ *
+ * Slot claiming follows the bounded MPMC queue design with per-slot sequence
+ * numbers; the consumer side is single-threaded (the main event loop), so
+ * head_ needs no atomics. Push returns false when the ring is full or the
+ * callable does not fit inline — the caller keeps a mutex-protected overflow
+ * queue for those rare cases, same layering as the audio decode ring and its
+ * PSRAM overflow store.
+ */
+template <size_t N, size_t StorageSize>
+class CallableRing {
+    static_assert((N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+    CallableRing() {
+        for (size_t i = 0; i < N; i++) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~CallableRing() {
+        while (PopAndInvoke()) {
+        }
+    }
+
+    // Producer side. Returns false when the ring is full or the callable is
+    // too big / too aligned to be stored inline.
+    template <typename F>
+    bool Push(F&& callable) {
+        using Fn = std::decay_t<F>;
+        if constexpr (sizeof(Fn) > StorageSize || alignof(Fn) > alignof(std::max_align_t)) {
+            return false;
+        } else {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = slots_[pos & (N - 1)];
+                size_t seq = slot.sequence.load(std::memory_order_acquire);
+                intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+                if (dif == 0) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        new (slot.storage) Fn(std::forward<F>(callable));
+                        slot.invoke = [](void* p) {
+                            Fn* fn = static_cast<Fn*>(p);
+                            (*fn)();
+                            fn->~Fn();
+                        };
+                        slot.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (dif < 0) {
+                    return false;
+                } else {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    // Consumer side only. Runs and destroys the oldest callable; returns
+    // false when the ring is empty.
+    bool PopAndInvoke() {
+        Slot& slot = slots_[head_ & (N - 1)];
+        size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(head_ + 1) < 0) {
+            return false;
+        }
+        size_t pos = head_++;
+        slot.invoke(slot.storage);
+        slot.sequence.store(pos + N, std::memory_order_release);
+        return true;
+    }
+
+    bool Empty() const {
+        const Slot& slot = slots_[head_ & (N - 1)];
+        return (intptr_t)slot.sequence.load(std::memory_order_acquire) - (intptr_t)(head_ + 1) < 0;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        void (*invoke)(void*) = nullptr;
+        alignas(std::max_align_t) unsigned char storage[StorageSize];
+    };
+
+    Slot slots_[N];
+    std::atomic<size_t> tail_{0};
+    size_t head_ = 0;
+};
+
+#endif // CALLABLE_RING_H
@@ -0,0 +1,110 @@
+#include "crash_reporter.h"
+#include "board.h"
+#include "system_info.h"
+
+#include <esp_core_dump.h>
+#include <esp_log.h>
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define TAG "CrashReporter"
+
+void CrashReporter::CheckAndUpload() {
+    if (esp_core_dump_image_check() != ESP_OK) {
+        return;
+    }
+
+    size_t addr = 0, size = 0;
+    if (esp_core_dump_image_get(&addr, &size) != ESP_OK || size == 0) {
+        return;
+    }
+    ESP_LOGW(TAG, "Core dump from previous crash found, %u bytes", (unsigned)size);
+
+    if (strlen(CONFIG_CRASH_REPORT_URL) == 0) {
+        ESP_LOGW(TAG, "CONFIG_CRASH_REPORT_URL is empty, keeping core dump on flash");
+        return;
+    }
+
+    // 优先级 1 的后台任务，永远排在音频和主循环之后
+    xTaskCreate([](void* arg) {
+        static_cast<CrashReporter*>(arg)->UploadTask();
+        vTaskDelete(NULL);
+    }, "crash_report", 4096 * 2, this, 1, nullptr);
+}
+
+void CrashReporter::UploadTask() {
+    auto partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                              ESP_PARTITION_SUBTYPE_DATA_COREDUMP, nullptr);
+    if (partition == nullptr) {
+        ESP_LOGE(TAG, "No coredump partition found");
+        return;
+    }
+
+    size_t addr = 0, size = 0;
+    if (esp_core_dump_image_get(&addr, &size) != ESP_OK || size == 0 || size > partition->size) {
+        ESP_LOGE(TAG, "Core dump vanished or has invalid size");
+        return;
+    }
+
+    auto& board = Board::GetInstance();
+    auto http = board.AcquireHttp("crash");
+    http->SetHeader("Device-Id", SystemInfo::GetMacAddress().c_str());
+    http->SetHeader("Client-Id", board.GetUuid());
+    http->SetHeader("User-Agent", SystemInfo::GetUserAgent());
+    http->SetHeader("Content-Type", "application/octet-stream");
+    http->SetHeader("Transfer-Encoding", "chunked");
+#if CONFIG_ESP_COREDUMP_DATA_FORMAT_ELF
+    // ELF 格式才有摘要；带上崩溃任务与 PC，服务端不用解析整个 dump 就能聚类
+    esp_core_dump_summary_t summary;
+    if (esp_core_dump_get_summary(&summary) == ESP_OK) {
+        char pc_str[16];
+        snprintf(pc_str, sizeof(pc_str), "0x%08lx", (unsigned long)summary.exc_pc);
+        http->SetHeader("X-Crash-Task", summary.exc_task);
+        http->SetHeader("X-Crash-Pc", pc_str);
+    }
+#endif
+
+    if (!http->Open("POST", CONFIG_CRASH_REPORT_URL)) {
+        ESP_LOGE(TAG, "Failed to connect to %s, will retry next boot", CONFIG_CRASH_REPORT_URL);
+        board.ReleaseHttp("crash", std::move(http));
+        return;
+    }
+
+    std::vector<char> chunk(kChunkSize);
+    size_t offset = 0;
+    bool failed = false;
+    while (offset < size) {
+        size_t len = std::min(kChunkSize, size - offset);
+        if (esp_partition_read(partition, offset, chunk.data(), len) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to read coredump partition at offset %u", (unsigned)offset);
+            failed = true;
+            break;
+        }
+        if (http->Write(chunk.data(), len) < 0) {
+            ESP_LOGE(TAG, "Upload aborted at offset %u, will retry next boot", (unsigned)offset);
+            failed = true;
+            break;
+        }
+        offset += len;
+        // 限速：歇一拍再发下一块，避免与音频流量竞争上行带宽
+        vTaskDelay(pdMS_TO_TICKS(kChunkIntervalMs));
+    }
+
+    if (!failed) {
+        http->Write("", 0);
+        int status_code = http->GetStatusCode();
+        if (status_code >= 200 && status_code < 300) {
+            ESP_LOGI(TAG, "Core dump uploaded (%u bytes), erasing partition", (unsigned)size);
+            esp_core_dump_image_erase();
+        } else {
+            ESP_LOGE(TAG, "Upload rejected with status %d, will retry next boot", status_code);
+        }
+    }
+    http->Close();
+    board.ReleaseHttp("crash", std::move(http));
+}
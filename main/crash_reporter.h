@@ -0,0 +1,35 @@
+#ifndef CRASH_REPORTER_H
+#define CRASH_REPORTER_H
+
+#include <cstddef>
+
+/**
+ * 崩溃遥测。崩溃时 core dump 由 IDF 写入专用的 coredump 分区
+ * （sdkconfig 的 ESP_COREDUMP_ENABLE_TO_FLASH），下次启动联网后
+ * 由低优先级后台任务分块 POST 到 CONFIG_CRASH_REPORT_URL：每块
+ * 之间强制歇息做限速，确保不与音频流量抢带宽；上传成功（2xx）
+ * 才擦除分区，失败则留到下次启动重试。URL 留空时只打印摘要。
+ */
+class CrashReporter {
+public:
+    static CrashReporter& GetInstance() {
+        static CrashReporter instance;
+        return instance;
+    }
+
+    // 网络就绪后调用一次；没有 core dump 时立即返回
+    void CheckAndUpload();
+
+private:
+    CrashReporter() = default;
+    CrashReporter(const CrashReporter&) = delete;
+    CrashReporter& operator=(const CrashReporter&) = delete;
+
+    void UploadTask();
+
+    static const size_t kChunkSize = 4096;
+    // 4KB 一块、每块歇 150ms，上行压在 ~27KB/s 以内
+    static const int kChunkIntervalMs = 150;
+};
+
+#endif // CRASH_REPORTER_H
@@ -0,0 +1,58 @@
+#ifndef DELEGATE_H
+#define DELEGATE_H
+
+#include <cstddef>
+#include <utility>
+
+/*
+ * 固定接线回调的轻量代理：一个上下文指针加一个普通函数指针。
+ *
+ * Application::Start 里接好的音频/协议回调一经建立终生不变，却一直用
+ * std::function 承载——类型擦除的间接调用落在每包/每帧路径上，闭包
+ * 超出 SBO 还会上堆。Delegate 调用就是一次函数指针跳转，绑定无捕获
+ * lambda（首参收上下文指针）零分配：
+ *
+ *     callbacks.on_vad_change = Delegate<void(bool)>::Bind(
+ *         this, [](Application* self, bool speaking) { ... });
+ *
+ * 真正需要运行期多态注册的地方（板级差异、多订阅者）继续用
+ * std::function，这里只服务一次性接好的热路径。
+ */
+template <typename Signature>
+class Delegate;
+
+template <typename R, typename... Args>
+class Delegate<R(Args...)> {
+    // 让 fn 的形参类型成为非推导上下文：T 只从 ctx 推导，无捕获
+    // lambda 才能按标准转换匹配到函数指针形参
+    template <typename U>
+    struct Identity { using type = U; };
+
+public:
+    Delegate() = default;
+
+    // fn 通常是无捕获 lambda，首参是绑定的对象指针。T* 与 void* 在
+    // 本平台 ABI 下同表示，函数指针转换后直接调用（gcc/Xtensa/RISC-V
+    // 均成立），省掉逐 T 生成 trampoline 的代码体积
+    template <typename T>
+    static Delegate Bind(T* ctx, R (*fn)(typename Identity<T>::type*, Args...)) {
+        Delegate d;
+        d.ctx_ = ctx;
+        d.thunk_ = reinterpret_cast<Thunk>(fn);
+        return d;
+    }
+
+    R operator()(Args... args) const {
+        return thunk_(ctx_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return thunk_ != nullptr; }
+
+private:
+    using Thunk = R (*)(void*, Args...);
+
+    void* ctx_ = nullptr;
+    Thunk thunk_ = nullptr;
+};
+
+#endif // DELEGATE_H
@@ -7,12 +7,28 @@ DeviceStateEventManager& DeviceStateEventManager::GetInstance() {
     return instance;
 }
 
-void DeviceStateEventManager::RegisterStateChangeCallback(std::function<void(DeviceState, DeviceState)> callback) {
+void DeviceStateEventManager::RegisterStateChangeCallback(std::function<void(DeviceState, DeviceState)> callback,
+                                                          StateCallbackTier tier) {
     std::lock_guard<std::mutex> lock(mutex_);
-    callbacks_.push_back(callback);
+    if (tier == StateCallbackTier::kSync) {
+        sync_callbacks_.push_back(callback);
+    } else {
+        callbacks_.push_back(callback);
+    }
 }
 
 void DeviceStateEventManager::PostStateChangeEvent(DeviceState previous_state, DeviceState current_state) {
+    // 同步档在切换路径上就地执行，切换完成即保证它们已经跑完
+    std::vector<std::function<void(DeviceState, DeviceState)>> sync_callbacks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sync_callbacks = sync_callbacks_;
+    }
+    for (const auto& callback : sync_callbacks) {
+        callback(previous_state, current_state);
+    }
+
+    // 异步档经默认事件循环执行，切换路径不等待
     device_state_event_data_t event_data = {
         .previous_state = previous_state,
         .current_state = current_state
@@ -18,13 +18,23 @@ struct device_state_event_data_t {
     DeviceState current_state;
 };
 
+// 监听器分两档：kSync 在状态切换路径里同步执行（如必须先完成的音频
+// 使能），kAsync 投递到默认事件循环执行（LED、LVGL 主题等 UI 工作），
+// 切换路径不等待它们。进入 kDeviceStateListening 在唤醒词的关键路径上，
+// 慢监听器放 kAsync 档
+enum class StateCallbackTier {
+    kSync,
+    kAsync,
+};
+
 class DeviceStateEventManager {
 public:
     static DeviceStateEventManager& GetInstance();
     DeviceStateEventManager(const DeviceStateEventManager&) = delete;
     DeviceStateEventManager& operator=(const DeviceStateEventManager&) = delete;
 
-    void RegisterStateChangeCallback(std::function<void(DeviceState, DeviceState)> callback);
+    void RegisterStateChangeCallback(std::function<void(DeviceState, DeviceState)> callback,
+                                     StateCallbackTier tier = StateCallbackTier::kAsync);
     void PostStateChangeEvent(DeviceState previous_state, DeviceState current_state);
     std::vector<std::function<void(DeviceState, DeviceState)>> GetCallbacks();
 
@@ -32,7 +42,8 @@ private:
     DeviceStateEventManager();
     ~DeviceStateEventManager();
 
-    std::vector<std::function<void(DeviceState, DeviceState)>> callbacks_;
+    std::vector<std::function<void(DeviceState, DeviceState)>> sync_callbacks_;
+    std::vector<std::function<void(DeviceState, DeviceState)>> callbacks_;  // kAsync 档
     std::mutex mutex_;
 };
 
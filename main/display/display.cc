@@ -10,6 +10,7 @@
 #include "application.h"
 #include "audio_codec.h"
 #include "settings.h"
+#include "power_profiler.h"
 #include "assets/lang_config.h"
 
 #define TAG "Display"
@@ -52,5 +53,7 @@ void Display::SetTheme(Theme* theme) {
 }
 
 void Display::SetPowerSaveMode(bool on) {
+    power_save_mode_ = on;
+    PowerProfiler::GetInstance().SetFlag(PowerProfiler::kFlagDisplayOn, !on);
     ESP_LOGW(TAG, "SetPowerSaveMode: %d", on);
 }
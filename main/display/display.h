@@ -39,6 +39,10 @@ public:
     virtual Theme* GetTheme() { return current_theme_; }
     virtual void UpdateStatusBar(bool update_all = false);
     virtual void SetPowerSaveMode(bool on);
+    // 结温降载：刷新率调速器降一档（见 ThermalMonitor），无界面的
+    // 显示类型忽略
+    virtual void SetThermalThrottle(bool on) {}
+    inline bool power_save_mode() const { return power_save_mode_; }
 
     inline int width() const { return width_; }
     inline int height() const { return height_; }
@@ -46,6 +50,7 @@ public:
 protected:
     int width_ = 0;
     int height_ = 0;
+    bool power_save_mode_ = false;
 
     Theme* current_theme_ = nullptr;
 
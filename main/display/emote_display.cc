@@ -20,9 +20,11 @@
 #include <freertos/task.h>
 
 // Project headers
+#include "application.h"
 #include "assets.h"
 #include "assets/lang_config.h"
 #include "board.h"
+#include "device_state_event.h"
 #include "gfx.h"
 
 LV_FONT_DECLARE(BUILTIN_TEXT_FONT);
@@ -379,13 +381,73 @@ void EmoteEngine::OnFlush(const gfx_handle_t handle, const int x_start, const in
 // EmoteDisplay Class Implementation
 // ============================================================================
 
+// While paused between utterances the render loop goes idle; this is how long
+// playout may stall before the eye animation is paused
+#define PLAYOUT_GATE_IDLE_MS    300
+#define PLAYOUT_GATE_PERIOD_MS  100
+
 EmoteDisplay::EmoteDisplay(const esp_lcd_panel_handle_t panel, const esp_lcd_panel_io_handle_t panel_io,
                            const int width, const int height)
 {
     InitializeEngine(panel, panel_io, width, height);
+
+    // Gate the eye animation on actual audio playout while speaking: the
+    // engine otherwise free-runs on its own timer and lips drift from speech
+    DeviceStateEventManager::GetInstance().RegisterStateChangeCallback(
+        [this](DeviceState previous_state, DeviceState current_state) {
+            playout_gating_ = (current_state == kDeviceStateSpeaking);
+        });
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = [](void* arg) {
+            static_cast<EmoteDisplay*>(arg)->CheckPlayoutGate();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "playout_gate",
+        .skip_unhandled_events = true,
+    };
+    esp_timer_create(&timer_args, &playout_timer_);
+    esp_timer_start_periodic(playout_timer_, PLAYOUT_GATE_PERIOD_MS * 1000);
+}
+
+EmoteDisplay::~EmoteDisplay()
+{
+    if (playout_timer_) {
+        esp_timer_stop(playout_timer_);
+        esp_timer_delete(playout_timer_);
+        playout_timer_ = nullptr;
+    }
 }
 
-EmoteDisplay::~EmoteDisplay() = default;
+void EmoteDisplay::NotifyPlaybackPosition(uint32_t position_ms)
+{
+    last_playout_us_ = esp_timer_get_time();
+}
+
+void EmoteDisplay::CheckPlayoutGate()
+{
+    if (!engine_) {
+        return;
+    }
+
+    bool should_pause = false;
+    if (playout_gating_) {
+        const int64_t idle_us = esp_timer_get_time() - last_playout_us_.load();
+        should_pause = idle_us > PLAYOUT_GATE_IDLE_MS * 1000;
+    }
+    if (should_pause == eyes_paused_by_playout_) {
+        return;
+    }
+
+    DisplayLockGuard lock(this);
+    if (should_pause) {
+        gfx_anim_stop(g_obj_anim_eye);
+    } else {
+        gfx_anim_start(g_obj_anim_eye);
+    }
+    eyes_paused_by_playout_ = should_pause;
+}
 
 void EmoteDisplay::SetEmotion(const char* const emotion)
 {
@@ -497,6 +559,8 @@ void EmoteDisplay::UpdateStatusBar(bool update_all)
 
 void EmoteDisplay::SetPowerSaveMode(bool on)
 {
+    power_save_mode_ = on;
+    Application::GetInstance().RearmClockTick();
     if (!engine_) {
         return;
     }
@@ -2,12 +2,14 @@
 
 #include "display.h"
 #include "lvgl_font.h"
+#include <atomic>
 #include <memory>
 #include <functional>
 #include <map>
 #include <string>
 #include <esp_lcd_panel_io.h>
 #include <esp_lcd_panel_ops.h>
+#include <esp_timer.h>
 
 namespace emote {
 
@@ -78,6 +80,11 @@ public:
     EmoteEngine* GetEngine() const;
     void* GetEngineHandle() const;
 
+    // Called from the audio output task with the playout position of the
+    // frame just written to the codec; paces the eye animation off actual
+    // playback instead of a free-running timer. Must stay cheap.
+    void NotifyPlaybackPosition(uint32_t position_ms);
+
     inline std::shared_ptr<LvglFont> text_font() const
     {
         return text_font_;
@@ -87,9 +94,18 @@ private:
     void InitializeEngine(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t panel_io, int width, int height);
     virtual bool Lock(int timeout_ms = 0) override;
     virtual void Unlock() override;
+    void CheckPlayoutGate();
 
     std::unique_ptr<EmoteEngine> engine_;
 
+    // Playout-gated animation: while speaking, the eye animation only runs
+    // when audio frames are actually being played, so the render loop idles
+    // between utterances and the CPU goes to the AFE
+    std::atomic<int64_t> last_playout_us_{0};
+    std::atomic<bool> playout_gating_{false};
+    bool eyes_paused_by_playout_ = false;
+    esp_timer_handle_t playout_timer_ = nullptr;
+
     // Font management
     std::shared_ptr<LvglFont> text_font_ = nullptr;
 
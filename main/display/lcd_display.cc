@@ -1,5 +1,7 @@
 #include "lcd_display.h"
 #include "gif/lvgl_gif.h"
+#include "heap_telemetry.h"
+#include "memory_budget.h"
 #include "settings.h"
 #include "lvgl_theme.h"
 #include "assets/lang_config.h"
@@ -11,6 +13,7 @@
 #include <esp_err.h>
 #include <esp_lvgl_port.h>
 #include <esp_psram.h>
+#include <esp_heap_caps.h>
 #include <cstring>
 
 #include "board.h"
@@ -133,12 +136,45 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
     lvgl_port_init(&port_cfg);
 
     ESP_LOGI(TAG, "Adding LCD display");
+    // 分块渲染：LVGL 每次只渲染 CONFIG_LCD_TILE_LINES 行的小块，配合双
+    // 缓冲，第 k 块在 DMA 刷屏的同时第 k+1 块并行渲染。大圆屏全屏失效
+    // 时 LVGL 任务最长的不可抢占段就是渲染一块的时间，块高决定了它会
+    // 把音频任务饿多久。块必须留在内部 RAM（DMA 够不着 PSRAM 还要多拷
+    // 一次），按当前最大的内部连续块收紧行数
+    uint32_t tile_lines = CONFIG_LCD_TILE_LINES;
+    {
+#if CONFIG_LCD_DOUBLE_BUFFER_FLUSH
+        const uint32_t buffer_count = 2;
+#else
+        const uint32_t buffer_count = 1;
+#endif
+        size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+        // 留一半给其它 DMA 使用者（SPI 事务队列、音频 I2S）
+        size_t budget = largest / 2;
+        while (tile_lines > 4 && (size_t)width_ * tile_lines * sizeof(uint16_t) * buffer_count > budget) {
+            tile_lines /= 2;
+        }
+        if (tile_lines != CONFIG_LCD_TILE_LINES) {
+            ESP_LOGW(TAG, "Tile height clamped from %d to %lu lines to fit internal DMA RAM",
+                     CONFIG_LCD_TILE_LINES, (unsigned long)tile_lines);
+        }
+    }
     const lvgl_port_display_cfg_t display_cfg = {
         .io_handle = panel_io_,
         .panel_handle = panel_,
         .control_handle = nullptr,
-        .buffer_size = static_cast<uint32_t>(width_ * 20),
+        // port 只分配 4 行的保底条带，上面再弹性补到目标行数（见下），
+        // 内存告警时可以缩回保底而不用动 port 的内部状态
+        .buffer_size = static_cast<uint32_t>(width_ * kMinTileLines),
+        /* With two stripe buffers LVGL renders into one while the SPI DMA
+         * transfer of the other is still in flight, instead of blocking the
+         * LVGL task for the whole flush. Costs one extra stripe of DMA RAM,
+         * so it is opt-in per board. */
+#if CONFIG_LCD_DOUBLE_BUFFER_FLUSH
+        .double_buffer = true,
+#else
         .double_buffer = false,
+#endif
         .trans_size = 0,
         .hres = static_cast<uint32_t>(width_),
         .vres = static_cast<uint32_t>(height_),
@@ -169,9 +205,91 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
         lv_display_set_offset(display_, offset_x, offset_y);
     }
 
+    // 弹性描画缓冲：先乐观放大到目标行数；碎片化告警把它缩回 4 行保底
+    // （帧间切换，渲染只是变慢不中断），压力过去后定时器再恢复
+#if CONFIG_LCD_DOUBLE_BUFFER_FLUSH
+    draw_buffer_count_ = 2;
+#endif
+    optimal_tile_lines_ = tile_lines;
+    if (optimal_tile_lines_ > kMinTileLines) {
+        ElasticSetTileLines(optimal_tile_lines_);
+    }
+    // 预算管理器回收链里排在预览等级：高等级分配失败或碎片化告警时
+    // 缩回保底行数。ElasticSetTileLines 内部有显示锁，任意任务可调
+    MemoryBudget::GetInstance().RegisterPool("lvgl_draw_buffer", MemoryBudget::kReclaimPreview,
+                                             [this](size_t wanted) -> size_t {
+        if (current_tile_lines_ <= kMinTileLines) {
+            return 0;
+        }
+        size_t freed = ElasticSetTileLines(kMinTileLines);
+        if (freed > 0) {
+            ArmRegrowTimer();
+        }
+        return freed;
+    });
+
     SetupUI();
 }
 
+size_t SpiLcdDisplay::ElasticSetTileLines(uint32_t tile_lines) {
+    size_t new_size = (size_t)width_ * tile_lines * sizeof(uint16_t);
+    uint8_t* bufs[2] = {nullptr, nullptr};
+    for (uint32_t i = 0; i < draw_buffer_count_; i++) {
+        bufs[i] = (uint8_t*)heap_caps_malloc(new_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+        if (bufs[i] == nullptr) {
+            // 缩容时 4 行的小块几乎不可能失败；失败就原样退出
+            for (uint32_t j = 0; j < i; j++) {
+                heap_caps_free(bufs[j]);
+            }
+            ESP_LOGW(TAG, "Failed to allocate %u-line draw buffers", (unsigned)tile_lines);
+            return 0;
+        }
+    }
+
+    {
+        DisplayLockGuard lock(this);
+        lv_display_set_buffers(display_, bufs[0], bufs[1], new_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    }
+
+    size_t old_total = 0;
+    size_t new_total = new_size * draw_buffer_count_;
+    if (draw_buffers_[0] != nullptr) {
+        old_total = (size_t)width_ * current_tile_lines_ * sizeof(uint16_t) * draw_buffer_count_;
+        for (uint32_t i = 0; i < draw_buffer_count_; i++) {
+            heap_caps_free(draw_buffers_[i]);
+        }
+        HeapTelemetry::GetInstance().Remove("display", old_total);
+    }
+    HeapTelemetry::GetInstance().Add("display", new_total);
+    draw_buffers_[0] = bufs[0];
+    draw_buffers_[1] = bufs[1];
+    current_tile_lines_ = tile_lines;
+    ESP_LOGI(TAG, "Draw buffers resized to %u lines x%u", (unsigned)tile_lines, (unsigned)draw_buffer_count_);
+    return old_total > new_total ? old_total - new_total : 0;
+}
+
+void SpiLcdDisplay::ArmRegrowTimer() {
+    DisplayLockGuard lock(this);
+    if (regrow_timer_ != nullptr) {
+        return;
+    }
+    regrow_timer_ = lv_timer_create([](lv_timer_t* timer) {
+        auto display = static_cast<SpiLcdDisplay*>(lv_timer_get_user_data(timer));
+        size_t wanted = (size_t)display->width_ * display->optimal_tile_lines_ *
+                        sizeof(uint16_t) * display->draw_buffer_count_;
+        // 沿用初始化时的预算：恢复后仍给其它 DMA 使用者留一半余量
+        size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+        if (wanted > largest / 2) {
+            return;
+        }
+        display->ElasticSetTileLines(display->optimal_tile_lines_);
+        if (display->current_tile_lines_ == display->optimal_tile_lines_) {
+            lv_timer_delete(timer);
+            display->regrow_timer_ = nullptr;
+        }
+    }, 5000, this);
+}
+
 
 // RGB LCD implementation
 RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
@@ -253,7 +371,11 @@ MipiLcdDisplay::MipiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel
         .panel_handle = panel,
         .control_handle = nullptr,
         .buffer_size = static_cast<uint32_t>(width_ * 50),
+#if CONFIG_LCD_DOUBLE_BUFFER_FLUSH
+        .double_buffer = true,
+#else
         .double_buffer = false,
+#endif
         .hres = static_cast<uint32_t>(width_),
         .vres = static_cast<uint32_t>(height_),
         .monochrome = false,
@@ -308,6 +430,7 @@ LcdDisplay::~LcdDisplay() {
     if (chat_message_label_ != nullptr) {
         lv_obj_del(chat_message_label_);
     }
+    chat_text_view_.reset();
     if (emoji_label_ != nullptr) {
         lv_obj_del(emoji_label_);
     }
@@ -499,12 +622,12 @@ void LcdDisplay::SetupUI() {
 #else
 #define  MAX_MESSAGES 20
 #endif
-void LcdDisplay::SetChatMessage(const char* role, const char* content) {
+void LcdDisplay::ApplyChatMessage(const char* role, const char* content) {
     DisplayLockGuard lock(this);
     if (content_ == nullptr) {
         return;
     }
-    
+
     // Check if message count exceeds limit
     uint32_t child_count = lv_obj_get_child_cnt(content_);
     if (child_count >= MAX_MESSAGES) {
@@ -902,14 +1025,11 @@ void LcdDisplay::SetupUI() {
     lv_obj_set_style_border_width(bottom_bar_, 0, 0);
     lv_obj_align(bottom_bar_, LV_ALIGN_BOTTOM_MID, 0, 0);
 
-    /* chat_message_label_ placed in bottom_bar_ and vertically centered */
-    chat_message_label_ = lv_label_create(bottom_bar_);
-    lv_label_set_text(chat_message_label_, "");
-    lv_obj_set_width(chat_message_label_, LV_HOR_RES - lvgl_theme->spacing(8)); // Subtract left and right padding
-    lv_label_set_long_mode(chat_message_label_, LV_LABEL_LONG_WRAP); // Auto wrap mode
-    lv_obj_set_style_text_align(chat_message_label_, LV_TEXT_ALIGN_CENTER, 0); // Center text alignment
-    lv_obj_set_style_text_color(chat_message_label_, lvgl_theme->text_color(), 0);
-    lv_obj_align(chat_message_label_, LV_ALIGN_CENTER, 0, 0); // Vertically and horizontally centered in bottom_bar_
+    /* chat_text_view_ placed in bottom_bar_ and vertically centered; lays out
+       streaming text incrementally instead of re-wrapping the whole label */
+    chat_text_view_ = std::make_unique<ChatTextView>(bottom_bar_, LV_HOR_RES - lvgl_theme->spacing(8)); // Subtract left and right padding
+    lv_obj_set_style_text_color(chat_text_view_->object(), lvgl_theme->text_color(), 0);
+    lv_obj_align(chat_text_view_->object(), LV_ALIGN_CENTER, 0, 0); // Vertically and horizontally centered in bottom_bar_
 
     low_battery_popup_ = lv_obj_create(screen);
     lv_obj_set_scrollbar_mode(low_battery_popup_, LV_SCROLLBAR_MODE_OFF);
@@ -961,23 +1081,42 @@ void LcdDisplay::SetPreviewImage(std::unique_ptr<LvglImage> image) {
     ESP_ERROR_CHECK(esp_timer_start_once(preview_timer_, PREVIEW_IMAGE_DURATION_MS * 1000));
 }
 
-void LcdDisplay::SetChatMessage(const char* role, const char* content) {
+void LcdDisplay::ApplyChatMessage(const char* role, const char* content) {
     DisplayLockGuard lock(this);
-    if (chat_message_label_ == nullptr) {
+    if (chat_text_view_ == nullptr) {
         return;
     }
-    lv_label_set_text(chat_message_label_, content);
+    chat_text_view_->SetText(content);
 }
 #endif
 
+void LcdDisplay::SetChatMessage(const char* role, const char* content) {
+    // Coalesce per LVGL tick: streaming STT text arrives much faster than
+    // the screen refreshes, only the latest value needs a relayout
+    QueueDisplayUpdate("chat_message", [this, role = std::string(role), content = std::string(content)]() {
+        ApplyChatMessage(role.c_str(), content.c_str());
+    });
+}
+
 void LcdDisplay::SetEmotion(const char* emotion) {
+    QueueDisplayUpdate("emotion", [this, emotion = std::string(emotion)]() {
+        ApplyEmotion(emotion.c_str());
+    });
+}
+
+void LcdDisplay::ApplyEmotion(const char* emotion) {
     // Stop any running GIF animation
     if (gif_controller_) {
         DisplayLockGuard lock(this);
         gif_controller_->Stop();
         gif_controller_.reset();
     }
-    
+    // 过渡进行中又来了新表情：立刻终止，下面按新表情重新决策
+    if (emoji_transition_ && emoji_transition_->IsRunning()) {
+        DisplayLockGuard lock(this);
+        emoji_transition_->Cancel();
+    }
+
     if (emoji_image_ == nullptr) {
         return;
     }
@@ -991,6 +1130,7 @@ void LcdDisplay::SetEmotion(const char* emotion) {
             lv_label_set_text(emoji_label_, utf8);
             lv_obj_add_flag(emoji_image_, LV_OBJ_FLAG_HIDDEN);
             lv_obj_remove_flag(emoji_label_, LV_OBJ_FLAG_HIDDEN);
+            last_emoji_dsc_ = nullptr;
         }
         return;
     }
@@ -1017,8 +1157,26 @@ void LcdDisplay::SetEmotion(const char* emotion) {
             ESP_LOGE(TAG, "Failed to load GIF for emotion: %s", emotion);
             gif_controller_.reset();
         }
+        last_emoji_dsc_ = nullptr;
     } else {
-        lv_image_set_src(emoji_image_, image->image_dsc());
+        auto target = image->image_dsc();
+        bool fading = false;
+        // 上一张也是同尺寸同格式的静态表情时做交叉淡化：中间帧由另一个
+        // 核预混，这里挂上的回调只在 LVGL 定时器里换指针
+        if (last_emoji_dsc_ != nullptr && last_emoji_dsc_ != target) {
+            if (emoji_transition_ == nullptr) {
+                emoji_transition_ = std::make_unique<EmojiTransition>();
+            }
+            fading = emoji_transition_->Start(last_emoji_dsc_, target,
+                [this](const lv_img_dsc_t* frame) {
+                    lv_image_set_src(emoji_image_, frame);
+                },
+                nullptr);
+        }
+        if (!fading) {
+            lv_image_set_src(emoji_image_, target);
+        }
+        last_emoji_dsc_ = target;
         lv_obj_add_flag(emoji_label_, LV_OBJ_FLAG_HIDDEN);
         lv_obj_remove_flag(emoji_image_, LV_OBJ_FLAG_HIDDEN);
     }
@@ -1041,7 +1199,13 @@ void LcdDisplay::SetEmotion(const char* emotion) {
 
 void LcdDisplay::SetTheme(Theme* theme) {
     DisplayLockGuard lock(this);
-    
+
+    // 过渡引用的表情图随旧主题销毁，先终止再换肤
+    if (emoji_transition_ && emoji_transition_->IsRunning()) {
+        emoji_transition_->Cancel();
+    }
+    last_emoji_dsc_ = nullptr;
+
     auto lvgl_theme = static_cast<LvglTheme*>(theme);
     
     // Get the active screen
@@ -1159,8 +1323,8 @@ void LcdDisplay::SetTheme(Theme* theme) {
     }
 #else
     // Simple UI mode - just update the main chat message
-    if (chat_message_label_ != nullptr) {
-        lv_obj_set_style_text_color(chat_message_label_, lvgl_theme->text_color(), 0);
+    if (chat_text_view_ != nullptr) {
+        lv_obj_set_style_text_color(chat_text_view_->object(), lvgl_theme->text_color(), 0);
     }
     
     if (emoji_label_ != nullptr) {
@@ -3,6 +3,8 @@
 
 #include "lvgl_display.h"
 #include "gif/lvgl_gif.h"
+#include "chat_text_view.h"
+#include "emoji_transition.h"
 
 #include <esp_lcd_panel_io.h>
 #include <esp_lcd_panel_ops.h>
@@ -30,8 +32,13 @@ protected:
     lv_obj_t* emoji_label_ = nullptr;
     lv_obj_t* emoji_image_ = nullptr;
     std::unique_ptr<LvglGif> gif_controller_ = nullptr;
+    // 静态表情之间的交叉淡化；last_emoji_dsc_ 记录当前屏上静态表情的
+    // 描述符，作为下一次过渡的起点（GIF 或图标字体时为空）
+    std::unique_ptr<EmojiTransition> emoji_transition_ = nullptr;
+    const lv_img_dsc_t* last_emoji_dsc_ = nullptr;
     lv_obj_t* emoji_box_ = nullptr;
     lv_obj_t* chat_message_label_ = nullptr;
+    std::unique_ptr<ChatTextView> chat_text_view_ = nullptr;  // subtitle in simple UI mode
     esp_timer_handle_t preview_timer_ = nullptr;
     std::unique_ptr<LvglImage> preview_image_cached_ = nullptr;
     bool hide_subtitle_ = false;  // Control whether to hide chat messages/subtitles
@@ -41,6 +48,10 @@ protected:
     virtual bool Lock(int timeout_ms = 0) override;
     virtual void Unlock() override;
 
+    // Actual UI updates, run in the LVGL task via the coalescing queue
+    void ApplyEmotion(const char* emotion);
+    void ApplyChatMessage(const char* role, const char* content);
+
 protected:
     // Add protected constructor
     LcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel, int width, int height);
@@ -64,6 +75,23 @@ public:
     SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                   int width, int height, int offset_x, int offset_y,
                   bool mirror_x, bool mirror_y, bool swap_xy);
+
+private:
+    /* Elastic draw buffers: the port is configured with the 4-line floor and
+     * the optimal stripe size is allocated here, so a fragmentation alarm can
+     * shrink back to the floor between frames (freeing internal DMA RAM for
+     * e.g. camera capture bursts) and a timer regrows once pressure clears.
+     * Returns the bytes freed when shrinking, 0 otherwise. */
+    size_t ElasticSetTileLines(uint32_t tile_lines);
+    void ArmRegrowTimer();
+
+    static constexpr uint32_t kMinTileLines = 4;
+
+    uint32_t optimal_tile_lines_ = kMinTileLines;
+    uint32_t current_tile_lines_ = kMinTileLines;
+    uint32_t draw_buffer_count_ = 1;
+    uint8_t* draw_buffers_[2] = {nullptr, nullptr};  // 自有缓冲；空表示还在用 port 的保底缓冲
+    lv_timer_t* regrow_timer_ = nullptr;
 };
 
 // RGB LCD display
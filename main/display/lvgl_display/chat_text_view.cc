@@ -0,0 +1,132 @@
+#include "chat_text_view.h"
+
+#include <esp_log.h>
+#include <cstring>
+
+#define TAG "ChatTextView"
+
+// Cleared transcripts park their line labels here for reuse
+#define MAX_RECYCLED_LABELS 8
+
+ChatTextView::ChatTextView(lv_obj_t* parent, int32_t width) : width_(width) {
+    container_ = lv_obj_create(parent);
+    lv_obj_set_size(container_, width_, LV_SIZE_CONTENT);
+    lv_obj_set_style_bg_opa(container_, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(container_, 0, 0);
+    lv_obj_set_style_pad_all(container_, 0, 0);
+    lv_obj_set_scrollbar_mode(container_, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_flex_flow(container_, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(container_, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_row(container_, 0, 0);
+}
+
+ChatTextView::~ChatTextView() {
+    if (container_ != nullptr) {
+        lv_obj_del(container_);  // deletes line labels with it
+        container_ = nullptr;
+    }
+}
+
+void ChatTextView::SetText(const char* text) {
+    if (text == nullptr) {
+        text = "";
+    }
+    if (text_ == text) {
+        return;
+    }
+
+    // Streaming updates extend the previous text; lay out only the delta
+    if (!text_.empty() && strncmp(text, text_.c_str(), text_.size()) == 0) {
+        AppendDelta(text + text_.size());
+    } else {
+        Clear();
+        AppendDelta(text);
+    }
+    text_ = text;
+}
+
+void ChatTextView::AppendDelta(const char* delta) {
+    auto font = lv_obj_get_style_text_font(container_, LV_PART_MAIN);
+
+    for (const char* p = delta; *p != '\0';) {
+        // Take one UTF-8 sequence
+        size_t char_len = 1;
+        while ((p[char_len] & 0xC0) == 0x80) {
+            char_len++;
+        }
+
+        if (*p == '\n') {
+            // Forced break: freeze the open line and start a new one
+            open_label_ = nullptr;
+            open_line_.clear();
+            p += char_len;
+            continue;
+        }
+
+        open_line_.append(p, char_len);
+        p += char_len;
+
+        if (lv_txt_get_width(open_line_.c_str(), open_line_.size(), font, 0) > width_ &&
+            open_line_.size() > char_len) {
+            // Overflow: close the line, preferring the last space as the
+            // break position so latin words are not split
+            std::string carry;
+            size_t space = open_line_.find_last_of(' ');
+            if (space != std::string::npos && space + 1 < open_line_.size() - char_len) {
+                carry = open_line_.substr(space + 1);
+                open_line_.resize(space);
+            } else {
+                carry = open_line_.substr(open_line_.size() - char_len);
+                open_line_.resize(open_line_.size() - char_len);
+            }
+            if (open_label_ == nullptr) {
+                open_label_ = AcquireLineLabel();
+            }
+            lv_label_set_text(open_label_, open_line_.c_str());
+            open_label_ = AcquireLineLabel();
+            open_line_ = std::move(carry);
+        }
+    }
+
+    if (!open_line_.empty() || open_label_ != nullptr) {
+        if (open_label_ == nullptr) {
+            open_label_ = AcquireLineLabel();
+        }
+        // Only this label is re-measured; the lines above are untouched
+        lv_label_set_text(open_label_, open_line_.c_str());
+    }
+}
+
+void ChatTextView::Clear() {
+    open_label_ = nullptr;
+    open_line_.clear();
+
+    // Hidden children are already in the recycle ring, skip them
+    for (int32_t i = (int32_t)lv_obj_get_child_cnt(container_) - 1; i >= 0; i--) {
+        lv_obj_t* label = lv_obj_get_child(container_, i);
+        if (lv_obj_has_flag(label, LV_OBJ_FLAG_HIDDEN)) {
+            continue;
+        }
+        if (recycled_labels_.size() < MAX_RECYCLED_LABELS) {
+            lv_obj_add_flag(label, LV_OBJ_FLAG_HIDDEN);
+            recycled_labels_.push_back(label);
+        } else {
+            lv_obj_del(label);
+        }
+    }
+}
+
+lv_obj_t* ChatTextView::AcquireLineLabel() {
+    lv_obj_t* label;
+    if (!recycled_labels_.empty()) {
+        label = recycled_labels_.back();
+        recycled_labels_.pop_back();
+        lv_obj_remove_flag(label, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_move_to_index(label, lv_obj_get_child_cnt(container_) - 1);
+    } else {
+        label = lv_label_create(container_);
+        lv_obj_set_width(label, LV_SIZE_CONTENT);
+    }
+    lv_label_set_text(label, "");
+    return label;
+}
@@ -0,0 +1,44 @@
+#ifndef CHAT_TEXT_VIEW_H
+#define CHAT_TEXT_VIEW_H
+
+#include <lvgl.h>
+
+#include <string>
+#include <vector>
+
+// Append-aware chat text widget for streaming transcripts.
+//
+// A plain LVGL label re-measures and re-wraps its whole text whenever it is
+// changed, so streaming STT updates over a few hundred characters cost more
+// every time a sentence grows. This widget lays text out line by line into
+// one label per line: completed lines are frozen and never measured again,
+// and when new text extends the old only the delta after the cached break
+// position is laid out. Labels of a cleared transcript are kept in a small
+// recycle ring instead of being deleted.
+class ChatTextView {
+public:
+    // width is the fixed content width used for line breaking
+    ChatTextView(lv_obj_t* parent, int32_t width);
+    ~ChatTextView();
+
+    // The outer container, for alignment and styling (text styles inherit)
+    lv_obj_t* object() const { return container_; }
+
+    // Replace the displayed text. If text extends the current text only the
+    // appended part is laid out. Must be called with the display locked.
+    void SetText(const char* text);
+
+private:
+    void AppendDelta(const char* delta);
+    void Clear();
+    lv_obj_t* AcquireLineLabel();
+
+    lv_obj_t* container_ = nullptr;
+    std::string text_;       // full text currently displayed
+    std::string open_line_;  // last line, still accepting appended text
+    lv_obj_t* open_label_ = nullptr;
+    std::vector<lv_obj_t*> recycled_labels_;
+    int32_t width_;
+};
+
+#endif // CHAT_TEXT_VIEW_H
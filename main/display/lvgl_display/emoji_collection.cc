@@ -3,9 +3,84 @@
 #include <esp_log.h>
 #include <unordered_map>
 #include <string>
+#include <cstring>
 
 #define TAG "EmojiCollection"
 
+namespace {
+
+// Binary layout of an atlas file, kept in sync with scripts/pack_emoji_atlas.py:
+//   AtlasHeader, then sprite_count NUL-padded names, then the pixel data of
+//   all sprites back to back in entry order.
+struct __attribute__((packed)) AtlasHeader {
+    uint32_t magic;         // "EMA1"
+    uint16_t sprite_count;
+    uint16_t sprite_width;
+    uint16_t sprite_height;
+    uint16_t color_format;  // lv_color_format_t value
+    uint32_t reserved;
+};
+
+constexpr uint32_t kAtlasMagic = 0x31414D45;  // "EMA1" little-endian
+constexpr size_t kAtlasNameLength = 16;
+
+// A sprite inside the atlas: owns only its descriptor, the pixels live in
+// the memory-mapped assets partition
+class AtlasSpriteImage : public LvglImage {
+public:
+    AtlasSpriteImage(const uint8_t* pixels, const AtlasHeader* header, size_t data_size) {
+        bzero(&image_dsc_, sizeof(image_dsc_));
+        image_dsc_.header.magic = LV_IMAGE_HEADER_MAGIC;
+        image_dsc_.header.cf = header->color_format;
+        image_dsc_.header.w = header->sprite_width;
+        image_dsc_.header.h = header->sprite_height;
+        image_dsc_.header.stride = header->sprite_width * lv_color_format_get_size((lv_color_format_t)header->color_format);
+        image_dsc_.data = pixels;
+        image_dsc_.data_size = data_size;
+    }
+    virtual const lv_img_dsc_t* image_dsc() const override { return &image_dsc_; }
+
+private:
+    lv_img_dsc_t image_dsc_;
+};
+
+}  // namespace
+
+bool AtlasEmojiCollection::Load(const void* data, size_t size) {
+    if (data == nullptr || size < sizeof(AtlasHeader)) {
+        ESP_LOGE(TAG, "Atlas too small: %u bytes", (unsigned)size);
+        return false;
+    }
+
+    auto header = (const AtlasHeader*)data;
+    if (header->magic != kAtlasMagic) {
+        ESP_LOGE(TAG, "Invalid atlas magic: 0x%08lx", (unsigned long)header->magic);
+        return false;
+    }
+
+    size_t bpp = lv_color_format_get_size((lv_color_format_t)header->color_format);
+    size_t sprite_size = (size_t)header->sprite_width * header->sprite_height * bpp;
+    size_t names_offset = sizeof(AtlasHeader);
+    size_t pixels_offset = names_offset + (size_t)header->sprite_count * kAtlasNameLength;
+    if (pixels_offset + (size_t)header->sprite_count * sprite_size > size) {
+        ESP_LOGE(TAG, "Atlas truncated: %u sprites of %u bytes in %u bytes",
+                 header->sprite_count, (unsigned)sprite_size, (unsigned)size);
+        return false;
+    }
+
+    auto base = (const uint8_t*)data;
+    for (int i = 0; i < header->sprite_count; i++) {
+        auto name = (const char*)(base + names_offset + i * kAtlasNameLength);
+        auto pixels = base + pixels_offset + i * sprite_size;
+        AddEmoji(std::string(name, strnlen(name, kAtlasNameLength)),
+                 new AtlasSpriteImage(pixels, header, sprite_size));
+    }
+
+    ESP_LOGI(TAG, "Loaded emoji atlas: %u sprites of %ux%u, cf=%u",
+             header->sprite_count, header->sprite_width, header->sprite_height, header->color_format);
+    return true;
+}
+
 void EmojiCollection::AddEmoji(const std::string& name, LvglImage* image) {
     emoji_collection_[name] = image;
 }
@@ -21,6 +21,18 @@ private:
     std::map<std::string, LvglImage*> emoji_collection_;
 };
 
+// Emoji collection backed by a pre-rasterized sprite sheet in the assets
+// partition. Every sprite is already in a native LVGL color format, so
+// rendering is a plain blit straight out of the memory-mapped flash with
+// no PNG decode on the emotion-switch path. Atlas files are produced by
+// scripts/pack_emoji_atlas.py.
+class AtlasEmojiCollection : public EmojiCollection {
+public:
+    // data must point into the memory-mapped assets partition and stay
+    // valid for the lifetime of the collection
+    bool Load(const void* data, size_t size);
+};
+
 class Twemoji32 : public EmojiCollection {
 public:
     Twemoji32();
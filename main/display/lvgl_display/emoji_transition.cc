@@ -0,0 +1,181 @@
+#include "emoji_transition.h"
+#include "task_registry.h"
+
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <cstring>
+
+#define TAG "EmojiTransition"
+
+EmojiTransition::~EmojiTransition() {
+    Cancel();
+}
+
+bool EmojiTransition::CanBlend(const lv_img_dsc_t* from, const lv_img_dsc_t* to) {
+    if (from == nullptr || to == nullptr || from->data == nullptr || to->data == nullptr) {
+        return false;
+    }
+    if (from->header.w != to->header.w || from->header.h != to->header.h ||
+        from->header.cf != to->header.cf || from->data_size != to->data_size) {
+        return false;
+    }
+    switch (to->header.cf) {
+        case LV_COLOR_FORMAT_RGB565:
+        case LV_COLOR_FORMAT_RGB565A8:
+        case LV_COLOR_FORMAT_ARGB8888:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool EmojiTransition::Start(const lv_img_dsc_t* from, const lv_img_dsc_t* to,
+                            std::function<void(const lv_img_dsc_t*)> on_frame,
+                            std::function<void()> on_done) {
+    if (running_ || !CanBlend(from, to)) {
+        return false;
+    }
+
+    for (int i = 0; i < kRingSlots; i++) {
+        ring_[i] = (uint8_t*)heap_caps_malloc(to->data_size, MALLOC_CAP_SPIRAM);
+        if (ring_[i] == nullptr) {
+            ring_[i] = (uint8_t*)malloc(to->data_size);
+        }
+        if (ring_[i] == nullptr) {
+            ReleaseBuffers();
+            return false;
+        }
+        slot_dsc_[i] = *to;
+        slot_dsc_[i].data = ring_[i];
+    }
+
+    from_ = from;
+    to_ = to;
+    on_frame_ = std::move(on_frame);
+    on_done_ = std::move(on_done);
+    produced_ = 0;
+    consumed_ = 0;
+    cancel_ = false;
+    worker_exited_ = false;
+    running_ = true;
+
+    // 混合跑在 LVGL 所在核之外的核上（双核默认 0，LVGL port 固定在 1），
+    // 优先级压到最低一档，绝不和音频抢时间片
+    int core = TaskRegistry::GetInstance().ResolveCore("emoji_blend", 0);
+    auto ret = xTaskCreatePinnedToCore([](void* arg) {
+        static_cast<EmojiTransition*>(arg)->WorkerTask();
+        vTaskDelete(NULL);
+    }, "emoji_blend", 2048, this, 1, nullptr, core);
+    if (ret != pdPASS) {
+        worker_exited_ = true;
+        running_ = false;
+        ReleaseBuffers();
+        return false;
+    }
+
+    timer_ = lv_timer_create([](lv_timer_t* timer) {
+        static_cast<EmojiTransition*>(lv_timer_get_user_data(timer))->OnTimer();
+    }, kStepPeriodMs, this);
+    return true;
+}
+
+void EmojiTransition::Cancel() {
+    if (!running_ && worker_exited_) {
+        return;
+    }
+    cancel_ = true;
+    while (!worker_exited_) {
+        vTaskDelay(1);
+    }
+    if (timer_ != nullptr) {
+        lv_timer_delete(timer_);
+        timer_ = nullptr;
+    }
+    running_ = false;
+    ReleaseBuffers();
+}
+
+void EmojiTransition::ReleaseBuffers() {
+    for (int i = 0; i < kRingSlots; i++) {
+        if (ring_[i] != nullptr) {
+            free(ring_[i]);
+            ring_[i] = nullptr;
+        }
+    }
+}
+
+// 每步把 from/to 按 mix（0..255）线性插值进 dst。只处理 CanBlend 放行的
+// 三种格式；RGB565A8 的 alpha 平面跟在 565 数据之后，一并插值
+void EmojiTransition::BlendStep(uint8_t* dst, uint8_t mix) const {
+    const uint8_t* a = from_->data;
+    const uint8_t* b = to_->data;
+    size_t pixels = (size_t)to_->header.w * to_->header.h;
+
+    if (to_->header.cf == LV_COLOR_FORMAT_ARGB8888) {
+        for (size_t i = 0; i < pixels * 4; i++) {
+            dst[i] = a[i] + (((b[i] - a[i]) * mix) >> 8);
+        }
+        return;
+    }
+
+    auto src_a = (const uint16_t*)a;
+    auto src_b = (const uint16_t*)b;
+    auto out = (uint16_t*)dst;
+    for (size_t i = 0; i < pixels; i++) {
+        uint16_t pa = src_a[i], pb = src_b[i];
+        int ra = pa >> 11, rb = pb >> 11;
+        int ga = (pa >> 5) & 0x3F, gb = (pb >> 5) & 0x3F;
+        int ba = pa & 0x1F, bb = pb & 0x1F;
+        int r = ra + (((rb - ra) * mix) >> 8);
+        int g = ga + (((gb - ga) * mix) >> 8);
+        int bl = ba + (((bb - ba) * mix) >> 8);
+        out[i] = (r << 11) | (g << 5) | bl;
+    }
+    if (to_->header.cf == LV_COLOR_FORMAT_RGB565A8) {
+        const uint8_t* aa = a + pixels * 2;
+        const uint8_t* ab = b + pixels * 2;
+        uint8_t* ad = dst + pixels * 2;
+        for (size_t i = 0; i < pixels; i++) {
+            ad[i] = aa[i] + (((ab[i] - aa[i]) * mix) >> 8);
+        }
+    }
+}
+
+void EmojiTransition::WorkerTask() {
+    for (int step = 1; step <= kSteps; step++) {
+        // 等乒乓缓冲里有空位（屏幕消费掉落后两步以内的帧）
+        while (!cancel_ && produced_.load() - consumed_.load() >= kRingSlots) {
+            vTaskDelay(1);
+        }
+        if (cancel_) {
+            break;
+        }
+        BlendStep(ring_[step % kRingSlots], (uint8_t)(step * 255 / (kSteps + 1)));
+        produced_ = step;
+    }
+    worker_exited_ = true;
+}
+
+void EmojiTransition::OnTimer() {
+    int produced = produced_.load();
+    int consumed = consumed_.load();
+    if (consumed < produced) {
+        int step = consumed + 1;
+        on_frame_(&slot_dsc_[step % kRingSlots]);
+        consumed_ = step;
+        consumed = step;
+    }
+    if (consumed >= kSteps && worker_exited_) {
+        // 最后一拍直接落到目标图本身，然后收尾
+        on_frame_(to_);
+        lv_timer_delete(timer_);
+        timer_ = nullptr;
+        running_ = false;
+        ReleaseBuffers();
+        if (on_done_) {
+            on_done_();
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <lvgl.h>
+#include <atomic>
+#include <functional>
+
+// 表情切换的交叉淡化。朴素做法是让 LVGL 任务每帧把两张表情图按 alpha
+// 混一遍，这会加剧 UI 线程本来就有的 CPU 竞争；这里把混合搬到另一个核
+// 上的低优先级任务：worker 按步预混出中间帧放进乒乓缓冲，LVGL 定时器
+// 每拍只做一次指针交换。只支持同尺寸同格式的原始位图（表情图集的
+// RGB565 / RGB565A8 / ARGB8888），其余组合由调用方照旧直接换图。
+class EmojiTransition {
+public:
+    ~EmojiTransition();
+
+    // 这对描述符能否交叉淡化（非空、同宽高同格式、支持的原始格式）
+    static bool CanBlend(const lv_img_dsc_t* from, const lv_img_dsc_t* to);
+
+    // 开始过渡。on_frame 由 LVGL 定时器在 LVGL 任务里调用，参数是要
+    // 显示的帧（中间帧或最终的 to）；过渡结束后调用 on_done。失败
+    // （内存不足、正在过渡中）返回 false，调用方直接换图即可
+    bool Start(const lv_img_dsc_t* from, const lv_img_dsc_t* to,
+               std::function<void(const lv_img_dsc_t*)> on_frame,
+               std::function<void()> on_done);
+
+    bool IsRunning() const { return running_; }
+
+    // 立刻终止过渡（新表情在过渡中途到达时调用），等 worker 退出并释放
+    // 缓冲；不触发 on_frame/on_done
+    void Cancel();
+
+private:
+    static constexpr int kSteps = 8;         // 中间帧数
+    static constexpr int kRingSlots = 2;     // 乒乓：屏幕显示第 k 帧时 worker 混第 k+1 帧
+    static constexpr int kStepPeriodMs = 30;
+
+    void WorkerTask();
+    void OnTimer();
+    void BlendStep(uint8_t* dst, uint8_t mix) const;
+    void ReleaseBuffers();
+
+    const lv_img_dsc_t* from_ = nullptr;
+    const lv_img_dsc_t* to_ = nullptr;
+    uint8_t* ring_[kRingSlots] = {};
+    lv_img_dsc_t slot_dsc_[kRingSlots];
+    lv_timer_t* timer_ = nullptr;
+    std::function<void(const lv_img_dsc_t*)> on_frame_;
+    std::function<void()> on_done_;
+    std::atomic<int> produced_{0};       // worker 已混完的步数
+    std::atomic<int> consumed_{0};       // LVGL 已显示的步数
+    std::atomic<bool> worker_exited_{true};
+    std::atomic<bool> cancel_{false};
+    bool running_ = false;
+};
@@ -650,6 +650,8 @@ read_image(gd_GIF * gif)
         gif->lct.size = 1 << ((fisrz & 0x07) + 1);
         f_gif_read(gif, gif->lct.colors, 3 * gif->lct.size);
         gif->palette = &gif->lct;
+        /* LCT is reloaded in place, the cached LUT no longer matches */
+        gif->lut_dirty = 1;
     }
     else
         gif->palette = &gif->gct;
@@ -666,18 +668,71 @@ render_frame_rect(gd_GIF * gif, uint8_t * buffer)
                         &gif->frame[i], gif->palette->colors,
                         gif->gce.transparency ? gif->gce.tindex : 0x100);
 #else
-    int j, k;
-    uint8_t index, * color;
+    /* Portable fast path: instead of three palette byte loads and four byte
+     * stores per pixel, pixels go through a prebuilt 256-entry ARGB8888 LUT
+     * with one aligned 32-bit store each, unrolled 8 pixels per iteration.
+     * With transparency enabled, transparent runs are skipped and opaque runs
+     * are bounded with memchr so the inner loop stays branch-free. */
+    int j;
+
+    if(gif->lut_dirty || gif->lut_palette != (void *)gif->palette) {
+        const uint8_t * c = gif->palette->colors;
+        for(j = 0; j < 0x100; j++, c += 3) {
+            /* canvas byte order is B,G,R,A */
+            gif->argb_lut[j] = 0xFF000000u | ((uint32_t)c[0] << 16) | ((uint32_t)c[1] << 8) | c[2];
+        }
+        gif->lut_palette = (void *)gif->palette;
+        gif->lut_dirty = 0;
+    }
 
+    const uint32_t * lut = gif->argb_lut;
     for(j = 0; j < gif->fh; j++) {
-        for(k = 0; k < gif->fw; k++) {
-            index = gif->frame[(gif->fy + j) * gif->width + gif->fx + k];
-            color = &gif->palette->colors[index * 3];
-            if(!gif->gce.transparency || index != gif->gce.tindex) {
-                buffer[(i + k) * 4 + 0] = *(color + 2);
-                buffer[(i + k) * 4 + 1] = *(color + 1);
-                buffer[(i + k) * 4 + 2] = *(color + 0);
-                buffer[(i + k) * 4 + 3] = 0xFF;
+        const uint8_t * src = &gif->frame[(gif->fy + j) * gif->width + gif->fx];
+        uint32_t * dst = (uint32_t *)&buffer[i * 4];
+        if(!gif->gce.transparency) {
+            int n = gif->fw;
+            while(n >= 8) {
+                dst[0] = lut[src[0]];
+                dst[1] = lut[src[1]];
+                dst[2] = lut[src[2]];
+                dst[3] = lut[src[3]];
+                dst[4] = lut[src[4]];
+                dst[5] = lut[src[5]];
+                dst[6] = lut[src[6]];
+                dst[7] = lut[src[7]];
+                dst += 8;
+                src += 8;
+                n -= 8;
+            }
+            while(n--) *dst++ = lut[*src++];
+        }
+        else {
+            int k = 0, fw = gif->fw;
+            uint8_t tindex = gif->gce.tindex;
+            while(k < fw) {
+                if(src[k] == tindex) {
+                    do k++; while(k < fw && src[k] == tindex);
+                    continue;
+                }
+                const uint8_t * end = memchr(&src[k], tindex, fw - k);
+                int run = end ? (int)(end - &src[k]) : fw - k;
+                const uint8_t * in = &src[k];
+                uint32_t * out = &dst[k];
+                k += run;
+                while(run >= 8) {
+                    out[0] = lut[in[0]];
+                    out[1] = lut[in[1]];
+                    out[2] = lut[in[2]];
+                    out[3] = lut[in[3]];
+                    out[4] = lut[in[4]];
+                    out[5] = lut[in[5]];
+                    out[6] = lut[in[6]];
+                    out[7] = lut[in[7]];
+                    out += 8;
+                    in += 8;
+                    run -= 8;
+                }
+                while(run--) *out++ = lut[*in++];
             }
         }
         i += gif->width;
@@ -732,6 +787,7 @@ gd_get_frame(gd_GIF * gif)
     while(sep != ',') {
         if(sep == ';') {
             f_gif_seek(gif, gif->anim_start, LV_FS_SEEK_SET);
+            gif->wrapped = 1;
             if(gif->loop_count == 1 || gif->loop_count < 0) {
                 return 0;
             }
@@ -759,6 +815,7 @@ void
 gd_rewind(gd_GIF * gif)
 {
     gif->loop_count = -1;
+    gif->wrapped = 0;
     f_gif_seek(gif, gif->anim_start, LV_FS_SEEK_SET);
 }
 
@@ -30,6 +30,7 @@ typedef struct _gd_GIF {
     uint8_t is_file;
     uint32_t f_rw_p;
     int32_t anim_start;
+    uint8_t wrapped; /* set when the decoder looped back to the first frame */
     uint16_t width, height;
     uint16_t depth;
     int32_t loop_count;
@@ -46,6 +47,11 @@ typedef struct _gd_GIF {
     uint16_t fx, fy, fw, fh;
     uint8_t bgindex;
     uint8_t * canvas, * frame;
+    /* 256-entry ARGB8888 mirror of the active palette so the blit does one
+     * 32-bit store per pixel; rebuilt only when a color table is (re)loaded */
+    uint32_t argb_lut[0x100];
+    void * lut_palette;
+    uint8_t lut_dirty;
 #if LV_GIF_CACHE_DECODE_DATA
     uint8_t *lzw_cache;
 #endif
@@ -1,9 +1,17 @@
 #include "lvgl_gif.h"
+#include "heap_telemetry.h"
+#include "assets.h"
 #include <esp_log.h>
+#include <esp_heap_caps.h>
 #include <cstring>
 
 #define TAG "LvglGif"
 
+// Upper bound for one looping animation's worth of cached ARGB8888 frames.
+// Emoji GIFs are small (typically well under 1MB per loop); anything bigger
+// keeps decoding every frame instead of monopolizing PSRAM.
+static constexpr size_t kMaxFrameCacheBytes = 2 * 1024 * 1024;
+
 LvglGif::LvglGif(const lv_img_dsc_t* img_dsc)
     : gif_(nullptr), timer_(nullptr), last_call_(0), playing_(false), loaded_(false) {
     if (!img_dsc || !img_dsc->data) {
@@ -16,6 +24,8 @@ LvglGif::LvglGif(const lv_img_dsc_t* img_dsc)
         ESP_LOGE(TAG, "Failed to open GIF from image descriptor");
         return;
     }
+    src_data_ = img_dsc->data;
+    src_size_ = img_dsc->data_size;
 
     // Setup LVGL image descriptor
     memset(&img_dsc_, 0, sizeof(img_dsc_));
@@ -104,6 +114,14 @@ void LvglGif::Stop() {
         lv_timer_pause(timer_);
     }
 
+    if (cache_complete_) {
+        // Restart playback from the cached first frame
+        cache_frame_index_ = 0;
+    } else {
+        // A partial recording would go out of sync with the rewound decoder
+        ClearFrameCache();
+    }
+
     if (gif_) {
         gd_rewind(gif_);
         NextFrame();
@@ -157,6 +175,26 @@ void LvglGif::NextFrame() {
         return;
     }
 
+    // Steady state for looping GIFs: every frame of one loop is cached, so
+    // serve a plain memcpy and skip the LZW decoder entirely
+    if (cache_complete_ && !frame_cache_.empty()) {
+        size_t count = frame_cache_.size();
+        // Gate on the delay of the frame currently on screen
+        size_t shown = (cache_frame_index_ + count - 1) % count;
+        uint32_t elapsed = lv_tick_elaps(last_call_);
+        if (elapsed < frame_cache_[shown].delay * 10) {
+            return;
+        }
+        last_call_ = lv_tick_get();
+
+        memcpy(gif_->canvas, frame_cache_[cache_frame_index_].data, img_dsc_.data_size);
+        cache_frame_index_ = (cache_frame_index_ + 1) % count;
+        if (frame_callback_) {
+            frame_callback_();
+        }
+        return;
+    }
+
     // Check if enough time has passed for the next frame
     uint32_t elapsed = lv_tick_elaps(last_call_);
     if (elapsed < gif_->gce.delay * 10) {
@@ -165,6 +203,14 @@ void LvglGif::NextFrame() {
 
     last_call_ = lv_tick_get();
 
+    // The decoder is about to read sequentially from the source stream;
+    // ask the assets partition to warm the next flash page in the
+    // background so the LZW loop below doesn't stall on cache misses.
+    // No-op for GIFs that don't live in the mmap'd partition.
+    if (src_data_ && (size_t)gif_->f_rw_p < src_size_) {
+        Assets::GetInstance().Prefetch(src_data_ + gif_->f_rw_p, src_size_ - gif_->f_rw_p);
+    }
+
     // Get next frame
     int has_next = gd_get_frame(gif_);
     if (has_next == 0) {
@@ -173,13 +219,37 @@ void LvglGif::NextFrame() {
         if (timer_) {
             lv_timer_pause(timer_);
         }
+        // Finite animation won't replay the frames we recorded
+        ClearFrameCache();
         ESP_LOGD(TAG, "GIF animation completed");
     }
 
+    bool wrapped = gif_->wrapped != 0;
+    gif_->wrapped = 0;
+
     // Render current frame
     if (gif_->canvas) {
         gd_render_frame(gif_, gif_->canvas);
-        
+
+        if (cache_enabled_ && has_next > 0) {
+            if (wrapped && gif_->loop_count == 0 && !frame_cache_.empty()) {
+                // One full loop of an endless animation recorded; the
+                // decoder just re-rendered frame 0, so the next frame to
+                // serve is index 1
+                cache_complete_ = true;
+                cache_frame_index_ = frame_cache_.size() > 1 ? 1 : 0;
+                ESP_LOGD(TAG, "Cached %u frames (%u bytes), decoding done",
+                         (unsigned)frame_cache_.size(), (unsigned)cache_bytes_);
+            } else if (wrapped) {
+                // Finite loop count - replaying from the cache would lose
+                // track of the remaining iterations
+                cache_enabled_ = false;
+                ClearFrameCache();
+            } else {
+                CacheCurrentFrame();
+            }
+        }
+
         // Call frame callback if set
         if (frame_callback_) {
             frame_callback_();
@@ -187,6 +257,40 @@ void LvglGif::NextFrame() {
     }
 }
 
+void LvglGif::CacheCurrentFrame() {
+    size_t frame_size = img_dsc_.data_size;
+    if (cache_bytes_ + frame_size > kMaxFrameCacheBytes) {
+        ESP_LOGD(TAG, "Frame cache budget exceeded, falling back to decoding");
+        cache_enabled_ = false;
+        ClearFrameCache();
+        return;
+    }
+
+    uint8_t* copy = (uint8_t*)heap_caps_malloc(frame_size, MALLOC_CAP_SPIRAM);
+    if (!copy) {
+        ESP_LOGW(TAG, "No PSRAM for frame cache, falling back to decoding");
+        cache_enabled_ = false;
+        ClearFrameCache();
+        return;
+    }
+
+    memcpy(copy, gif_->canvas, frame_size);
+    frame_cache_.push_back({copy, gif_->gce.delay});
+    cache_bytes_ += frame_size;
+    HeapTelemetry::GetInstance().Add("display", frame_size);
+}
+
+void LvglGif::ClearFrameCache() {
+    for (auto& frame : frame_cache_) {
+        heap_caps_free(frame.data);
+    }
+    frame_cache_.clear();
+    HeapTelemetry::GetInstance().Remove("display", cache_bytes_);
+    cache_bytes_ = 0;
+    cache_complete_ = false;
+    cache_frame_index_ = 0;
+}
+
 void LvglGif::Cleanup() {
     // Stop and delete timer
     if (timer_) {
@@ -194,6 +298,8 @@ void LvglGif::Cleanup() {
         timer_ = nullptr;
     }
 
+    ClearFrameCache();
+
     // Close GIF decoder
     if (gif_) {
         gd_close_gif(gif_);
@@ -5,6 +5,7 @@
 #include <lvgl.h>
 #include <memory>
 #include <functional>
+#include <vector>
 
 /**
  * C++ implementation of LVGL GIF widget
@@ -72,6 +73,11 @@ public:
 private:
     // GIF decoder instance
     gd_GIF* gif_;
+
+    // Source GIF byte stream; kept around so the decode path can issue
+    // read-ahead for the flash-mapped data it is about to consume
+    const uint8_t* src_data_ = nullptr;
+    size_t src_size_ = 0;
     
     // LVGL image descriptor
     lv_img_dsc_t img_dsc_;
@@ -88,12 +94,39 @@ private:
     
     // Frame update callback
     std::function<void()> frame_callback_;
-    
+
+    /**
+     * Fully decoded frames of one loop, copied to PSRAM during the first
+     * pass. Once the decoder wraps, playback serves memcpy blits from here
+     * and does no LZW work at all - looping emoji GIFs hit this in steady
+     * state. Caching gives up silently when the loop exceeds the byte
+     * budget or PSRAM runs out.
+     */
+    struct CachedFrame {
+        uint8_t* data;
+        uint16_t delay;  // in GIF 10ms units
+    };
+    std::vector<CachedFrame> frame_cache_;
+    bool cache_enabled_ = true;
+    bool cache_complete_ = false;
+    size_t cache_frame_index_ = 0;
+    size_t cache_bytes_ = 0;
+
     /**
      * Update to next frame
      */
     void NextFrame();
-    
+
+    /**
+     * Record the just-rendered canvas into the frame cache
+     */
+    void CacheCurrentFrame();
+
+    /**
+     * Drop all cached frames
+     */
+    void ClearFrameCache();
+
     /**
      * Cleanup resources
      */
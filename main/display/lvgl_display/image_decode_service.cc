@@ -0,0 +1,197 @@
+#include "image_decode_service.h"
+#include "jpg/jpeg_to_image.h"
+#include "memory_budget.h"
+#include "task_registry.h"
+
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <freertos/task.h>
+
+#include <cstring>
+
+#define TAG "ImageDecode"
+
+ImageDecodeService& ImageDecodeService::GetInstance() {
+    static ImageDecodeService instance;
+    return instance;
+}
+
+void ImageDecodeService::Decode(Lane lane, std::string data, int max_width, int max_height,
+                                std::function<void(std::unique_ptr<LvglImage>)> callback) {
+    EnsureWorker();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& queue = (lane == Lane::kUiBlocking) ? ui_lane_ : prefetch_lane_;
+        queue.push_back(Job{std::move(data), max_width, max_height, std::move(callback)});
+    }
+    xSemaphoreGive(work_sem_);
+}
+
+void ImageDecodeService::EnsureWorker() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (worker_started_) {
+        return;
+    }
+    work_sem_ = xSemaphoreCreateCounting(16, 0);
+    // 优先级 2：高于预热类后台任务，低于主循环（3）和音频，解码吃满也
+    // 抢不走交互路径的时间片
+    int core = TaskRegistry::GetInstance().ResolveCore("img_decode", 0);
+    xTaskCreatePinnedToCore([](void* arg) {
+        static_cast<ImageDecodeService*>(arg)->WorkerTask();
+        vTaskDelete(NULL);
+    }, "img_decode", 2048 * 2, this, 2, nullptr, core);
+    worker_started_ = true;
+
+    // 空闲槽里留用的大缓冲注册成可回收池；只动没在用的槽，回收后
+    // 下次解码重新分配即可
+    MemoryBudget::GetInstance().RegisterPool("img_decode_pool", MemoryBudget::kReclaimDecode,
+                                             [this](size_t wanted) -> size_t {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t freed = 0;
+        for (auto& slot : pool_) {
+            if (!slot.in_use && slot.buffer != nullptr) {
+                heap_caps_free(slot.buffer);
+                freed += slot.size;
+                slot.buffer = nullptr;
+                slot.size = 0;
+            }
+        }
+        return freed;
+    });
+}
+
+void ImageDecodeService::WorkerTask() {
+    while (true) {
+        xSemaphoreTake(work_sem_, portMAX_DELAY);
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            // UI 车道清空之前不碰预取车道
+            if (!ui_lane_.empty()) {
+                job = std::move(ui_lane_.front());
+                ui_lane_.pop_front();
+            } else if (!prefetch_lane_.empty()) {
+                job = std::move(prefetch_lane_.front());
+                prefetch_lane_.pop_front();
+            } else {
+                continue;
+            }
+        }
+        auto image = DecodeJob(job);
+        if (job.callback) {
+            job.callback(std::move(image));
+        }
+    }
+}
+
+std::unique_ptr<LvglImage> ImageDecodeService::DecodeJob(Job& job) {
+    auto src = (const uint8_t*)job.data.data();
+    size_t src_len = job.data.size();
+    if (src_len < 4) {
+        return nullptr;
+    }
+
+    if (src[0] == 0xFF && src[1] == 0xD8) {
+        // JPEG：直接解成 RGB565，渲染时零解码开销。缩放只能按 JPEG 的
+        // 1/2^n 档位走，超大图按两倍预算兜底
+        size_t buffer_size = (size_t)job.max_width * job.max_height * 2 * 2 + 4096;
+        uint8_t* buffer = AcquireBuffer(buffer_size);
+        if (buffer != nullptr) {
+            size_t out_len, width, height, stride;
+            esp_err_t ret = jpeg_to_image_scaled(src, src_len, job.max_width, job.max_height,
+                                                 buffer, buffer_size, &out_len, &width, &height, &stride);
+            if (ret == ESP_OK) {
+                return std::make_unique<PooledDecodedImage>(buffer, out_len, width, height, stride,
+                                                            LV_COLOR_FORMAT_RGB565);
+            }
+            ESP_LOGW(TAG, "JPEG decode failed: %s, falling back to LVGL decoder", esp_err_to_name(ret));
+            ReleaseBuffer(buffer);
+        }
+    }
+
+    // PNG 等其它格式：LVGL 渲染时再解（原有路径），这里只搬进堆缓冲。
+    // 走预算接口：不够时先淘汰缓存/预览等级的池子
+    uint8_t* copy = (uint8_t*)MemoryBudget::GetInstance().Alloc(
+        "img_decode", src_len, MALLOC_CAP_8BIT, MemoryBudget::kReclaimDecode);
+    if (copy == nullptr) {
+        ESP_LOGE(TAG, "Failed to allocate %u bytes for image", (unsigned)src_len);
+        return nullptr;
+    }
+    memcpy(copy, src, src_len);
+    try {
+        return std::make_unique<LvglAllocatedImage>(copy, src_len);
+    } catch (const std::exception& e) {
+        // LvglAllocatedImage 的析构不会跑，手动释放
+        heap_caps_free(copy);
+        ESP_LOGE(TAG, "Unsupported image: %s", e.what());
+        return nullptr;
+    }
+}
+
+uint8_t* ImageDecodeService::AcquireBuffer(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 先找够大的空闲槽复用；不够大就重分配该槽
+    for (auto& slot : pool_) {
+        if (!slot.in_use && slot.size >= size) {
+            slot.in_use = true;
+            return slot.buffer;
+        }
+    }
+    for (auto& slot : pool_) {
+        if (!slot.in_use) {
+            if (slot.buffer != nullptr) {
+                heap_caps_free(slot.buffer);
+                slot.buffer = nullptr;
+                slot.size = 0;
+            }
+            // 硬件 JPEG 要求输出缓冲 16 字节对齐
+            slot.buffer = (uint8_t*)heap_caps_aligned_alloc(16, size, MALLOC_CAP_SPIRAM);
+            if (slot.buffer == nullptr) {
+                slot.buffer = (uint8_t*)heap_caps_aligned_alloc(16, size, MALLOC_CAP_8BIT);
+            }
+            if (slot.buffer == nullptr) {
+                // 对齐分配走不了预算接口，失败后手动回收低等级池子
+                // （不含本池，不会递归拿 mutex_）再试一次
+                if (MemoryBudget::GetInstance().Reclaim(size, MemoryBudget::kReclaimDecode) > 0) {
+                    slot.buffer = (uint8_t*)heap_caps_aligned_alloc(16, size, MALLOC_CAP_SPIRAM);
+                }
+            }
+            if (slot.buffer == nullptr) {
+                return nullptr;
+            }
+            slot.size = size;
+            slot.in_use = true;
+            return slot.buffer;
+        }
+    }
+    ESP_LOGW(TAG, "Decode buffer pool exhausted");
+    return nullptr;
+}
+
+void ImageDecodeService::ReleaseBuffer(uint8_t* buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& slot : pool_) {
+        if (slot.buffer == buffer) {
+            slot.in_use = false;
+            return;
+        }
+    }
+}
+
+PooledDecodedImage::PooledDecodedImage(uint8_t* buffer, size_t data_size, int width, int height,
+                                       int stride, int color_format)
+    : buffer_(buffer) {
+    bzero(&image_dsc_, sizeof(image_dsc_));
+    image_dsc_.data_size = data_size;
+    image_dsc_.data = buffer;
+    image_dsc_.header.magic = LV_IMAGE_HEADER_MAGIC;
+    image_dsc_.header.cf = color_format;
+    image_dsc_.header.w = width;
+    image_dsc_.header.h = height;
+    image_dsc_.header.stride = stride;
+}
+
+PooledDecodedImage::~PooledDecodedImage() {
+    ImageDecodeService::GetInstance().ReleaseBuffer(buffer_);
+}
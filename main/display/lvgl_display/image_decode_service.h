@@ -0,0 +1,86 @@
+#ifndef IMAGE_DECODE_SERVICE_H
+#define IMAGE_DECODE_SERVICE_H
+
+#include "lvgl_image.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// 异步图片解码服务：PNG/JPEG 的解码从调用方任务（经常是主循环的
+// SetPreviewImage 路径，80~200ms 的解码会直接变成调度延迟）挪到独立的
+// worker 任务上。两条优先级车道：kUiBlocking 是用户正在等着上屏的图，
+// 永远排在 kPrefetch（预热、后台换肤）前面。
+//
+// JPEG 走 jpeg_to_image_scaled 解成立即可 blit 的 RGB565，输出缓冲来自
+// 内部的小缓冲池（复用避免反复向 PSRAM 要大块）；其它格式退回
+// LvglAllocatedImage，由 LVGL 在渲染时解码，行为与原来一致。回调在
+// worker 任务上执行，SetPreviewImage 内部有显示锁，可直接调用。
+class ImageDecodeService {
+public:
+    enum class Lane {
+        kUiBlocking,
+        kPrefetch,
+    };
+
+    static ImageDecodeService& GetInstance();
+    ImageDecodeService(const ImageDecodeService&) = delete;
+    ImageDecodeService& operator=(const ImageDecodeService&) = delete;
+
+    // data 为压缩图整包（服务接管所有权）；解码结果缩放到 max_width x
+    // max_height 以内。失败时回调收到 nullptr
+    void Decode(Lane lane, std::string data, int max_width, int max_height,
+                std::function<void(std::unique_ptr<LvglImage> image)> callback);
+
+    // 供 PooledDecodedImage 析构时归还缓冲
+    void ReleaseBuffer(uint8_t* buffer);
+
+private:
+    ImageDecodeService() = default;
+
+    struct Job {
+        std::string data;
+        int max_width;
+        int max_height;
+        std::function<void(std::unique_ptr<LvglImage>)> callback;
+    };
+
+    struct PoolSlot {
+        uint8_t* buffer = nullptr;
+        size_t size = 0;
+        bool in_use = false;
+    };
+
+    void EnsureWorker();
+    void WorkerTask();
+    std::unique_ptr<LvglImage> DecodeJob(Job& job);
+    uint8_t* AcquireBuffer(size_t size);
+
+    static constexpr int kPoolSlots = 2;
+
+    std::mutex mutex_;
+    std::deque<Job> ui_lane_;
+    std::deque<Job> prefetch_lane_;
+    SemaphoreHandle_t work_sem_ = nullptr;
+    bool worker_started_ = false;
+    PoolSlot pool_[kPoolSlots];
+};
+
+// 解码输出包在池化缓冲里的图；析构把缓冲还回服务的池子复用
+class PooledDecodedImage : public LvglImage {
+public:
+    PooledDecodedImage(uint8_t* buffer, size_t data_size, int width, int height, int stride, int color_format);
+    virtual ~PooledDecodedImage();
+    virtual const lv_img_dsc_t* image_dsc() const override { return &image_dsc_; }
+
+private:
+    lv_img_dsc_t image_dsc_;
+    uint8_t* buffer_;
+};
+
+#endif // IMAGE_DECODE_SERVICE_H
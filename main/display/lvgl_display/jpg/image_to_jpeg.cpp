@@ -392,6 +392,50 @@ static bool encode_with_esp_new_jpeg(const uint8_t* src, size_t src_len, uint16_
         return false;
     }
 
+    if (cb) {
+        // 流式输出：按块编码，每编码完一条 MCU 带就把新产生的字节交给回调，
+        // 让 HTTP 上传与后续块的编码重叠，而不是等整帧编码完
+        int block_size = 0;
+        ret = jpeg_enc_get_block_size(h, &block_size);
+        if (ret != JPEG_ERR_OK || block_size <= 0) {
+            jpeg_enc_close(h);
+            jpeg_free_align(enc_in);
+            free(outbuf);
+            ESP_LOGE(TAG, "jpeg_enc_get_block_size failed: %d", (int)ret);
+            return false;
+        }
+
+        int out_len = 0;       // 累计写入 outbuf 的字节数
+        size_t emitted = 0;    // 已经交给回调的字节数
+        size_t index = 0;
+        for (int offset = 0; offset < enc_in_size; offset += block_size) {
+            int chunk = enc_in_size - offset;
+            if (chunk > block_size)
+                chunk = block_size;
+            ret = jpeg_enc_process_with_block(h, enc_in + offset, chunk, outbuf, (int)out_cap, &out_len);
+            if (ret != JPEG_ERR_OK) {
+                jpeg_enc_close(h);
+                jpeg_free_align(enc_in);
+                free(outbuf);
+                ESP_LOGE(TAG, "jpeg_enc_process_with_block failed: %d", (int)ret);
+                return false;
+            }
+            if ((size_t)out_len > emitted) {
+                cb(cb_arg, index++, outbuf + emitted, (size_t)out_len - emitted);
+                emitted = (size_t)out_len;
+            }
+        }
+        jpeg_enc_close(h);
+        jpeg_free_align(enc_in);
+        cb(cb_arg, index, NULL, 0);  // 结束信号
+        free(outbuf);
+        if (jpg_out)
+            *jpg_out = NULL;
+        if (jpg_out_len)
+            *jpg_out_len = 0;
+        return true;
+    }
+
     int out_len = 0;
     ret = jpeg_enc_process(h, enc_in, enc_in_size, outbuf, (int)out_cap, &out_len);
     jpeg_enc_close(h);
@@ -403,17 +447,6 @@ static bool encode_with_esp_new_jpeg(const uint8_t* src, size_t src_len, uint16_
         return false;
     }
 
-    if (cb) {
-        cb(cb_arg, 0, outbuf, (size_t)out_len);
-        cb(cb_arg, 1, NULL, 0);  // 结束信号
-        free(outbuf);
-        if (jpg_out)
-            *jpg_out = NULL;
-        if (jpg_out_len)
-            *jpg_out_len = 0;
-        return true;
-    }
-
     if (jpg_out && jpg_out_len) {
         *jpg_out = outbuf;
         *jpg_out_len = (size_t)out_len;
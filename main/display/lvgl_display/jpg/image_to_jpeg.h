@@ -17,6 +17,8 @@ extern "C" {
 // JPEG输出回调函数类型
 // arg: 用户自定义参数, index: 当前数据索引, data: JPEG数据块, len: 数据块长度
 // 返回: 实际处理的字节数
+// 数据可能分多块到达（软件编码器按 MCU 带流式输出），data 为 NULL 且 len 为 0
+// 的调用表示输出结束
 typedef size_t (*jpg_out_cb)(void *arg, size_t index, const void *data, size_t len);
 
 /**
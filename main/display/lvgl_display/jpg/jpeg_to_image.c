@@ -99,6 +99,116 @@ jpeg_dec_failed:
     return ret;
 }
 
+esp_err_t jpeg_to_image_scaled(const uint8_t* src, size_t src_len, size_t max_width, size_t max_height,
+                               uint8_t* out_buf, size_t out_buf_len, size_t* out_len, size_t* width,
+                               size_t* height, size_t* stride) {
+#ifdef CONFIG_XIAOZHI_ENABLE_CAMERA_DEBUG_MODE
+    esp_log_level_set(TAG, ESP_LOG_DEBUG);
+#endif  // CONFIG_XIAOZHI_ENABLE_CAMERA_DEBUG_MODE
+    if (src == NULL || src_len == 0 || max_width == 0 || max_height == 0 || out_buf == NULL || out_len == NULL ||
+        width == NULL || height == NULL || stride == NULL || ((uintptr_t)out_buf % 16) != 0) {
+        ESP_LOGE(TAG, "Invalid parameters");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    jpeg_error_t jpeg_ret = JPEG_ERR_OK;
+    jpeg_dec_io_t jpeg_io = {0};
+    jpeg_dec_header_info_t out_info = {0};
+
+    jpeg_dec_config_t config = DEFAULT_JPEG_DEC_CONFIG();
+    config.output_type = JPEG_PIXEL_FORMAT_RGB565_LE;
+    config.rotate = JPEG_ROTATE_0D;
+
+    jpeg_dec_handle_t jpeg_dec = NULL;
+    jpeg_ret = jpeg_dec_open(&config, &jpeg_dec);
+    if (jpeg_ret != JPEG_ERR_OK) {
+        ESP_LOGE(TAG, "Failed to open JPEG decoder");
+        ret = ESP_FAIL;
+        goto jpeg_scaled_dec_failed;
+    }
+
+    jpeg_io.inbuf = (uint8_t*)src;
+    jpeg_io.inbuf_len = (int)src_len;
+
+    jpeg_ret = jpeg_dec_parse_header(jpeg_dec, &jpeg_io, &out_info);
+    if (jpeg_ret != JPEG_ERR_OK) {
+        ESP_LOGE(TAG, "Failed to parse JPEG header");
+        ret = ESP_ERR_INVALID_ARG;
+        goto jpeg_scaled_dec_failed;
+    }
+
+    // Pick the smallest DCT-domain scale (1, 1/2, 1/4, 1/8) whose output
+    // still fits within the requested resolution
+    int shift = 0;
+    while (shift < 3 && ((out_info.width >> shift) > max_width || (out_info.height >> shift) > max_height)) {
+        shift++;
+    }
+
+    size_t scaled_width = out_info.width >> shift;
+    size_t scaled_height = out_info.height >> shift;
+    ESP_LOGD(TAG, "JPEG header info: width=%d, height=%d, scaled to %ux%u", out_info.width, out_info.height,
+             (unsigned)scaled_width, (unsigned)scaled_height);
+
+    if (out_buf_len < scaled_width * scaled_height * 2) {
+        *out_len = scaled_width * scaled_height * 2;
+        ret = ESP_ERR_INVALID_SIZE;
+        goto jpeg_scaled_dec_failed;
+    }
+
+    if (shift > 0) {
+        // The scale factor is part of the decoder config, reopen with it
+        jpeg_dec_close(jpeg_dec);
+        jpeg_dec = NULL;
+        config.scale.width = scaled_width;
+        config.scale.height = scaled_height;
+        jpeg_ret = jpeg_dec_open(&config, &jpeg_dec);
+        if (jpeg_ret != JPEG_ERR_OK) {
+            ESP_LOGE(TAG, "Failed to open JPEG decoder with scale");
+            ret = ESP_FAIL;
+            goto jpeg_scaled_dec_failed;
+        }
+        jpeg_ret = jpeg_dec_parse_header(jpeg_dec, &jpeg_io, &out_info);
+        if (jpeg_ret != JPEG_ERR_OK) {
+            ESP_LOGE(TAG, "Failed to parse JPEG header");
+            ret = ESP_ERR_INVALID_ARG;
+            goto jpeg_scaled_dec_failed;
+        }
+    }
+
+    jpeg_io.outbuf = out_buf;
+    jpeg_ret = jpeg_dec_process(jpeg_dec, &jpeg_io);
+    if (jpeg_ret != JPEG_ERR_OK) {
+        ESP_LOGE(TAG, "Failed to decode JPEG");
+        ret = ESP_FAIL;
+        goto jpeg_scaled_dec_failed;
+    }
+
+    ESP_LOG_BUFFER_HEXDUMP(TAG, out_buf, MIN(scaled_width * scaled_height * 2, 256), ESP_LOG_DEBUG);
+
+    *out_len = scaled_width * scaled_height * 2;
+    *width = scaled_width;
+    *height = scaled_height;
+    *stride = scaled_width * 2;
+    jpeg_dec_close(jpeg_dec);
+    jpeg_dec = NULL;
+
+    return ret;
+
+jpeg_scaled_dec_failed:
+    if (jpeg_dec) {
+        jpeg_dec_close(jpeg_dec);
+        jpeg_dec = NULL;
+    }
+    if (ret != ESP_ERR_INVALID_SIZE) {
+        *out_len = 0;
+    }
+    *width = 0;
+    *height = 0;
+    *stride = 0;
+    return ret;
+}
+
 #ifdef CONFIG_XIAOZHI_ENABLE_HARDWARE_JPEG_DECODER
 static esp_err_t decode_with_hardware_jpeg(const uint8_t* src, size_t src_len, uint8_t** out, size_t* out_len,
                                            size_t* width, size_t* height, size_t* stride) {
@@ -55,6 +55,38 @@ extern "C" {
 esp_err_t jpeg_to_image(const uint8_t* src, size_t src_len, uint8_t** out, size_t* out_len, size_t* width,
                         size_t* height, size_t* stride);
 
+/**
+ * @brief Decodes a JPEG image directly at (or below) a target resolution into a caller-provided buffer
+ *
+ * The decoder downscales in the DCT domain (1/2, 1/4 or 1/8) while decoding, so a preview never
+ * materializes a full-size intermediate copy. The smallest scale factor whose output still fits
+ * within max_width x max_height is chosen; images already small enough are decoded 1:1. Always uses
+ * the software decoder, as the hardware JPEG engine has no scaler.
+ *
+ * @param[in] src Pointer to the JPEG bitstream in memory
+ * @param[in] src_len Length of the JPEG bitstream in bytes
+ * @param[in] max_width Target width the decoded image should fit into
+ * @param[in] max_height Target height the decoded image should fit into
+ * @param[out] out_buf Caller-provided output buffer, MUST be 16-byte aligned
+ * @param[in] out_buf_len Size of out_buf in bytes
+ * @param[out] out_len Receives the size of the decoded image data in bytes. On ESP_ERR_INVALID_SIZE
+ *             it receives the required buffer size instead, so the caller can retry with a larger buffer
+ * @param[out] width Receives the decoded image width in pixels
+ * @param[out] height Receives the decoded image height in pixels
+ * @param[out] stride Receives the decoded image stride in bytes
+ *
+ * @return ESP_OK on successful decoding
+ * @return ESP_ERR_INVALID_ARG on invalid parameters
+ * @return ESP_ERR_INVALID_SIZE if out_buf is too small, *out_len is set to the required size
+ * @return ESP_FAIL on failure
+ *
+ * @note A 1/8-scaled image of a very large JPEG can still exceed max_width x max_height; size the
+ *       buffer from *out_len in that case. The decoded image format is always RGB565 (2 bytes per pixel).
+ */
+esp_err_t jpeg_to_image_scaled(const uint8_t* src, size_t src_len, size_t max_width, size_t max_height,
+                               uint8_t* out_buf, size_t out_buf_len, size_t* out_len, size_t* width,
+                               size_t* height, size_t* stride);
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,14 +7,22 @@
 
 #include "lvgl_display.h"
 #include "board.h"
+#include "tracepoint.h"
 #include "application.h"
 #include "audio_codec.h"
 #include "settings.h"
 #include "assets/lang_config.h"
 #include "jpg/image_to_jpeg.h"
+#include "device_state_event.h"
+#include "status_event.h"
 
 #define TAG "Display"
 
+// Refresh periods for the state-aware frame governor
+#define REFRESH_PERIOD_ACTIVE_MS     33   // ~30fps while speaking/listening
+#define REFRESH_PERIOD_IDLE_MS       100  // 10fps when idle
+#define REFRESH_PERIOD_POWER_SAVE_MS 1000 // 1Hz in power save mode
+
 LvglDisplay::LvglDisplay() {
     // Notification timer
     esp_timer_create_args_t notification_timer_args = {
@@ -38,6 +46,24 @@ LvglDisplay::LvglDisplay() {
     } else {
         ESP_ERROR_CHECK(ret);
     }
+
+    // Tie the frame rate to the device state: the LVGL task competes with
+    // the audio stack for CPU on single-core boards, so only run at full
+    // rate while a conversation is on screen
+    DeviceStateEventManager::GetInstance().RegisterStateChangeCallback(
+        [this](DeviceState previous_state, DeviceState current_state) {
+            last_device_state_ = current_state;
+            UpdateRefreshRate();
+        });
+
+    // 状态栏走订阅式更新：电量/网络/音量变化时发布方推一次，这里跑一遍
+    // 差量检查（没变化的项不碰 LVGL）。时钟滴答对 UpdateStatusBar 的调用
+    // 退化成兜底轮询，平时只剩几次 RAM 比较
+    StatusEventManager::GetInstance().Subscribe([this](StatusEvent event) {
+        if (!power_save_mode_) {
+            UpdateStatusBar();
+        }
+    });
 }
 
 LvglDisplay::~LvglDisplay() {
@@ -46,6 +72,12 @@ LvglDisplay::~LvglDisplay() {
         esp_timer_delete(notification_timer_);
     }
 
+    if (update_timer_ != nullptr) {
+        DisplayLockGuard lock(this);
+        lv_timer_delete(update_timer_);
+        update_timer_ = nullptr;
+    }
+
     if (network_label_ != nullptr) {
         lv_obj_del(network_label_);
     }
@@ -78,6 +110,8 @@ void LvglDisplay::SetStatus(const char* status) {
     lv_obj_remove_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
     lv_obj_add_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
 
+    // 任何状态文本都会盖掉时钟，作废时钟的去重缓存
+    clock_text_.clear();
     last_status_update_time_ = std::chrono::system_clock::now();
 }
 
@@ -98,26 +132,30 @@ void LvglDisplay::ShowNotification(const char* notification, int duration_ms) {
     ESP_ERROR_CHECK(esp_timer_start_once(notification_timer_, duration_ms * 1000));
 }
 
+// 差量优先：每一项先在 RAM 里比对缓存值，只有真正变化时才取显示锁、
+// 碰 LVGL。发布方的变更事件和时钟滴答的兜底轮询都走这一个入口，没有
+// 变化的调用除了几次比较什么都不花
 void LvglDisplay::UpdateStatusBar(bool update_all) {
     auto& app = Application::GetInstance();
     auto& board = Board::GetInstance();
     auto codec = board.GetAudioCodec();
 
-    // Update mute icon
-    {
-        DisplayLockGuard lock(this);
-        if (mute_label_ == nullptr) {
-            return;
-        }
+    if (mute_label_ == nullptr) {
+        return;
+    }
+    if (update_all) {
+        // 休眠唤醒/网络就绪后的强制刷新：清掉缓存让各项都重新落一次
+        battery_icon_ = nullptr;
+        network_icon_ = nullptr;
+        clock_text_.clear();
+    }
 
-        // Update icon if mute state changes
-        if (codec->output_volume() == 0 && !muted_) {
-            muted_ = true;
-            lv_label_set_text(mute_label_, FONT_AWESOME_VOLUME_XMARK);
-        } else if (codec->output_volume() > 0 && muted_) {
-            muted_ = false;
-            lv_label_set_text(mute_label_, "");
-        }
+    // Update mute icon only when the mute state flips
+    bool muted = codec->output_volume() == 0;
+    if (muted != muted_) {
+        DisplayLockGuard lock(this);
+        muted_ = muted;
+        lv_label_set_text(mute_label_, muted ? FONT_AWESOME_VOLUME_XMARK : "");
     }
 
     // Update time
@@ -130,15 +168,18 @@ void LvglDisplay::UpdateStatusBar(bool update_all) {
             if (tm->tm_year >= 2025 - 1900) {
                 char time_str[16];
                 strftime(time_str, sizeof(time_str), "%H:%M", tm);
-                SetStatus(time_str);
+                // 只在分钟跳变时真正写标签（SetStatus 会清缓存，后赋值）
+                if (clock_text_ != time_str) {
+                    SetStatus(time_str);
+                    clock_text_ = time_str;
+                }
             } else {
                 ESP_LOGW(TAG, "System time is not set, tm_year: %d", tm->tm_year);
             }
         }
     }
 
-    esp_pm_lock_acquire(pm_lock_);
-    // Update battery icon
+    // Update battery icon; GetBatteryLevel answers from the PMIC RAM cache
     int battery_level;
     bool charging, discharging;
     const char* icon = nullptr;
@@ -156,28 +197,29 @@ void LvglDisplay::UpdateStatusBar(bool update_all) {
             };
             icon = levels[battery_level / 20];
         }
-        DisplayLockGuard lock(this);
-        if (battery_label_ != nullptr && battery_icon_ != icon) {
-            battery_icon_ = icon;
-            lv_label_set_text(battery_label_, battery_icon_);
-        }
-
-        if (low_battery_popup_ != nullptr) {
-            if (strcmp(icon, FONT_AWESOME_BATTERY_EMPTY) == 0 && discharging) {
-                if (lv_obj_has_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN)) { // Show if low battery popup is hidden
+        bool low_battery = strcmp(icon, FONT_AWESOME_BATTERY_EMPTY) == 0 && discharging;
+        if (battery_icon_ != icon || low_battery != low_battery_shown_) {
+            esp_pm_lock_acquire(pm_lock_);
+            DisplayLockGuard lock(this);
+            if (battery_label_ != nullptr && battery_icon_ != icon) {
+                battery_icon_ = icon;
+                lv_label_set_text(battery_label_, battery_icon_);
+            }
+            if (low_battery_popup_ != nullptr && low_battery != low_battery_shown_) {
+                low_battery_shown_ = low_battery;
+                if (low_battery) {
                     lv_obj_remove_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN);
                     app.PlaySound(Lang::Sounds::OGG_LOW_BATTERY);
-                }
-            } else {
-                // Hide the low battery popup when the battery is not empty
-                if (!lv_obj_has_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN)) { // Hide if low battery popup is shown
+                } else {
                     lv_obj_add_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN);
                 }
             }
+            esp_pm_lock_release(pm_lock_);
         }
     }
 
-    // Update network icon every 10 seconds
+    // Update network icon every 10 seconds (RSSI tier changes have no
+    // publisher, so this stays polled at a coarse interval)
     static int seconds_counter = 0;
     if (update_all || seconds_counter++ % 10 == 0) {
         // Don't read 4G network status during firmware upgrade to avoid occupying UART resources
@@ -192,20 +234,83 @@ void LvglDisplay::UpdateStatusBar(bool update_all) {
         if (std::find(allowed_states.begin(), allowed_states.end(), device_state) != allowed_states.end()) {
             icon = board.GetNetworkStateIcon();
             if (network_label_ != nullptr && icon != nullptr && network_icon_ != icon) {
+                esp_pm_lock_acquire(pm_lock_);
                 DisplayLockGuard lock(this);
                 network_icon_ = icon;
                 lv_label_set_text(network_label_, network_icon_);
+                esp_pm_lock_release(pm_lock_);
             }
         }
     }
-
-    esp_pm_lock_release(pm_lock_);
 }
 
 void LvglDisplay::SetPreviewImage(std::unique_ptr<LvglImage> image) {
 }
 
+void LvglDisplay::QueueDisplayUpdate(const char* key, std::function<void()> update) {
+    if (update_timer_ == nullptr) {
+        // Created lazily on the first queued update; runs in the LVGL task
+        DisplayLockGuard lock(this);
+        if (update_timer_ == nullptr) {
+            update_timer_ = lv_timer_create([](lv_timer_t* timer) {
+                auto display = static_cast<LvglDisplay*>(lv_timer_get_user_data(timer));
+                std::map<std::string, std::function<void()>> updates;
+                {
+                    std::lock_guard<std::mutex> lock(display->update_queue_mutex_);
+                    updates.swap(display->pending_updates_);
+                }
+                TRACE_EVENT(TracePoint::kDisplayUpdate, updates.size());
+                for (auto& update : updates) {
+                    update.second();
+                }
+            }, REFRESH_PERIOD_ACTIVE_MS, this);
+            UpdateRefreshRate();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(update_queue_mutex_);
+    pending_updates_[key] = std::move(update);
+}
+
+void LvglDisplay::UpdateRefreshRate() {
+    if (display_ == nullptr) {
+        return;
+    }
+
+    uint32_t period_ms;
+    if (power_save_mode_) {
+        period_ms = REFRESH_PERIOD_POWER_SAVE_MS;
+    } else if (last_device_state_ == kDeviceStateIdle) {
+        period_ms = thermal_throttle_ ? REFRESH_PERIOD_POWER_SAVE_MS : REFRESH_PERIOD_IDLE_MS;
+    } else {
+        // 结温过高时交互态也退到空闲帧率，渲染是这颗芯片上最大的
+        // 可伸缩负载之一
+        period_ms = thermal_throttle_ ? REFRESH_PERIOD_IDLE_MS : REFRESH_PERIOD_ACTIVE_MS;
+    }
+
+    DisplayLockGuard lock(this);
+    auto refr_timer = lv_display_get_refr_timer(display_);
+    if (refr_timer != nullptr) {
+        lv_timer_set_period(refr_timer, period_ms);
+    }
+    // Slow down the update queue together with the refresh rate, otherwise
+    // its timer would keep waking the LVGL task at full rate
+    if (update_timer_ != nullptr) {
+        lv_timer_set_period(update_timer_, period_ms);
+    }
+}
+
+void LvglDisplay::SetThermalThrottle(bool on) {
+    if (thermal_throttle_ == on) {
+        return;
+    }
+    thermal_throttle_ = on;
+    UpdateRefreshRate();
+}
+
 void LvglDisplay::SetPowerSaveMode(bool on) {
+    power_save_mode_ = on;
+    UpdateRefreshRate();
     if (on) {
         SetChatMessage("system", "");
         SetEmotion("sleepy");
@@ -213,8 +318,134 @@ void LvglDisplay::SetPowerSaveMode(bool on) {
         SetChatMessage("system", "");
         SetEmotion("neutral");
     }
+    // 息屏状态变化后让主循环重算下一个时钟截止时间（见 ScheduleClockTick）
+    Application::GetInstance().RearmClockTick();
+}
+
+#if CONFIG_SCREEN_MIRROR
+
+// flush 回调没有 user_data 可挂（esp_lvgl_port 占用了 display 的
+// user_data），整机只有一个显示实例，用静态指针转发即可
+static LvglDisplay* s_mirror_instance = nullptr;
+
+// u8 游程长度 + u16 像素；纯色大块（状态栏、背景）能压到 1% 以下
+static void MirrorRleEncode(const uint16_t* src, size_t count, std::string& out) {
+    size_t i = 0;
+    while (i < count) {
+        uint16_t px = src[i];
+        size_t run = 1;
+        while (run < 255 && i + run < count && src[i + run] == px) {
+            run++;
+        }
+        out.push_back((char)run);
+        out.append((const char*)&px, 2);
+        i += run;
+    }
+}
+
+bool LvglDisplay::StartScreenMirror(size_t max_bytes_per_sec, std::function<bool(std::string frame)> sink) {
+    if (display_ == nullptr || sink == nullptr) {
+        return false;
+    }
+    DisplayLockGuard lock(this);
+    mirror_sink_ = std::move(sink);
+    mirror_budget_per_sec_ = max_bytes_per_sec;
+    mirror_window_bytes_ = 0;
+    mirror_window_start_us_ = esp_timer_get_time();
+    mirror_skipped_frames_ = 0;
+    if (mirror_orig_flush_ == nullptr) {
+        mirror_orig_flush_ = lv_display_get_flush_cb(display_);
+        s_mirror_instance = this;
+        lv_display_set_flush_cb(display_, MirrorFlushCb);
+        // 让静止的画面也立刻出一帧，镜像端不用等下一次 UI 变化
+        lv_obj_invalidate(lv_screen_active());
+    }
+    ESP_LOGI(TAG, "Screen mirror started, budget %u B/s", (unsigned)max_bytes_per_sec);
+    return true;
+}
+
+void LvglDisplay::StopScreenMirror() {
+    DisplayLockGuard lock(this);
+    if (mirror_orig_flush_ != nullptr) {
+        lv_display_set_flush_cb(display_, mirror_orig_flush_);
+        mirror_orig_flush_ = nullptr;
+        s_mirror_instance = nullptr;
+    }
+    mirror_sink_ = nullptr;
+    ESP_LOGI(TAG, "Screen mirror stopped, %u frames skipped by budget", (unsigned)mirror_skipped_frames_);
 }
 
+void LvglDisplay::MirrorFlushCb(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    auto display = s_mirror_instance;
+    if (display != nullptr) {
+        display->OnMirrorFlush(area, px_map);
+        if (display->mirror_orig_flush_ != nullptr) {
+            display->mirror_orig_flush_(disp, area, px_map);
+            return;
+        }
+    }
+    // 镜像刚被停掉但回调还没换回去时兜底
+    lv_display_flush_ready(disp);
+}
+
+void LvglDisplay::OnMirrorFlush(const lv_area_t* area, const uint8_t* px_map) {
+    if (!mirror_sink_) {
+        return;
+    }
+
+    // 按秒滚动的字节预算；超了就整块丢掉，脏矩形下一次重绘会再来
+    int64_t now = esp_timer_get_time();
+    if (now - mirror_window_start_us_ >= 1000000) {
+        mirror_window_start_us_ = now;
+        mirror_window_bytes_ = 0;
+    }
+    if (mirror_window_bytes_ >= mirror_budget_per_sec_) {
+        mirror_skipped_frames_++;
+        return;
+    }
+
+    uint16_t x = (uint16_t)area->x1;
+    uint16_t y = (uint16_t)area->y1;
+    uint16_t w = (uint16_t)lv_area_get_width(area);
+    uint16_t h = (uint16_t)lv_area_get_height(area);
+    size_t pixels = (size_t)w * h;
+    uint32_t raw_len = (uint32_t)(pixels * sizeof(uint16_t));
+
+    // px_map 在 esp_lvgl_port 做字节交换之前，是原生 RGB565 小端
+    std::string frame;
+    frame.reserve(18 + raw_len / 8);
+    frame.append("XMR1", 4);
+    frame.append((const char*)&x, 2);
+    frame.append((const char*)&y, 2);
+    frame.append((const char*)&w, 2);
+    frame.append((const char*)&h, 2);
+    uint8_t format = 0;
+    uint8_t reserved = 0;
+    frame.push_back((char)format);
+    frame.push_back((char)reserved);
+    frame.append((const char*)&raw_len, 4);
+
+    MirrorRleEncode((const uint16_t*)px_map, pixels, frame);
+    if (frame.size() - 18 >= raw_len) {
+        // 高熵内容（照片、GIF）RLE 压不动，退回裸数据
+        frame.resize(18);
+        frame[12] = 1;
+        frame.append((const char*)px_map, raw_len);
+    }
+
+    mirror_window_bytes_ += frame.size();
+    if (!mirror_sink_(std::move(frame))) {
+        // 对端通道没了（断连或不支持二进制附件），就地收摊
+        lv_display_set_flush_cb(display_, mirror_orig_flush_);
+        mirror_orig_flush_ = nullptr;
+        s_mirror_instance = nullptr;
+        mirror_sink_ = nullptr;
+        ESP_LOGW(TAG, "Screen mirror sink rejected frame, stopping");
+    }
+}
+
+#endif // CONFIG_SCREEN_MIRROR
+
 bool LvglDisplay::SnapshotToJpeg(std::string& jpeg_data, int quality) {
 #if CONFIG_LV_USE_SNAPSHOT
     DisplayLockGuard lock(this);
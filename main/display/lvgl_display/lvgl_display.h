@@ -3,6 +3,7 @@
 
 #include "display.h"
 #include "lvgl_image.h"
+#include "device_state.h"
 
 #include <lvgl.h>
 #include <esp_timer.h>
@@ -11,6 +12,9 @@
 
 #include <string>
 #include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
 
 class LvglDisplay : public Display {
 public:
@@ -23,8 +27,24 @@ public:
     virtual void SetPreviewImage(std::unique_ptr<LvglImage> image);
     virtual void UpdateStatusBar(bool update_all = false);
     virtual void SetPowerSaveMode(bool on);
+    virtual void SetThermalThrottle(bool on) override;
     virtual bool SnapshotToJpeg(std::string& jpeg_data, int quality = 80);
 
+#if CONFIG_SCREEN_MIRROR
+    /*
+     * 远程调试的屏幕镜像：包住 LVGL 的 flush 回调，把每个脏矩形 RLE
+     * 压缩后交给 sink（协议层的二进制附件通道）。带宽超出预算时整帧
+     * 跳过（脏矩形下一次重绘还会来）。sink 返回 false 时自动停止。
+     * 未开启会话时不挂钩子，flush 路径零开销。
+     *
+     * 帧格式（小端）：'XMR1' magic(4) + x,y,w,h(u16*4) + format(u8,
+     * 0=RGB565 RLE / 1=RGB565 raw) + reserved(u8) + raw_len(u32)，后跟
+     * 数据。RLE 为 u8 游程长度 + u16 像素的重复对。
+     */
+    bool StartScreenMirror(size_t max_bytes_per_sec, std::function<bool(std::string frame)> sink);
+    void StopScreenMirror();
+#endif
+
 protected:
     esp_pm_lock_handle_t pm_lock_ = nullptr;
     lv_display_t *display_ = nullptr;
@@ -40,10 +60,40 @@ protected:
     const char* battery_icon_ = nullptr;
     const char* network_icon_ = nullptr;
     bool muted_ = false;
+    // UpdateStatusBar 的差量缓存：低电弹窗当前是否可见、时钟标签上一次
+    // 写入的 "HH:MM"（被其它状态文本覆盖时清空）
+    bool low_battery_shown_ = false;
+    std::string clock_text_;
 
     std::chrono::system_clock::time_point last_status_update_time_;
     esp_timer_handle_t notification_timer_ = nullptr;
 
+    // Coalescing update queue: Set* calls store the latest value per key and
+    // an LVGL timer applies them once per tick, so streaming STT text causes
+    // at most one relayout per frame instead of one per call
+    void QueueDisplayUpdate(const char* key, std::function<void()> update);
+    // Adjust the LVGL refresh rate to the device state: full rate while
+    // speaking or listening, reduced when idle, 1Hz in power save mode
+    void UpdateRefreshRate();
+
+    std::mutex update_queue_mutex_;
+    std::map<std::string, std::function<void()>> pending_updates_;
+    lv_timer_t* update_timer_ = nullptr;
+    DeviceState last_device_state_ = kDeviceStateUnknown;
+    // 结温降载：true 时刷新率在当前状态的基础上再降一档
+    bool thermal_throttle_ = false;
+
+#if CONFIG_SCREEN_MIRROR
+    static void MirrorFlushCb(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map);
+    void OnMirrorFlush(const lv_area_t* area, const uint8_t* px_map);
+    lv_display_flush_cb_t mirror_orig_flush_ = nullptr;
+    std::function<bool(std::string frame)> mirror_sink_;
+    size_t mirror_budget_per_sec_ = 0;
+    size_t mirror_window_bytes_ = 0;
+    int64_t mirror_window_start_us_ = 0;
+    uint32_t mirror_skipped_frames_ = 0;
+#endif
+
     friend class DisplayLockGuard;
     virtual bool Lock(int timeout_ms = 0) = 0;
     virtual void Unlock() = 0;
@@ -1,13 +1,135 @@
 #include "lvgl_font.h"
+#include "assets.h"
 #include <cbin_font.h>
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <cstring>
 
+#define TAG "LvglFont"
 
-LvglCBinFont::LvglCBinFont(void* data) {
-    font_ = cbin_font_create(static_cast<uint8_t*>(data));
+// 字形查找缓存。cbin 字体的 get_glyph_dsc 每次都要在 mmap 的 cmap 表里
+// 二分查找，中文聊天文本每次重排版都按字符重查一遍，流式字幕下这是
+// O(消息长度) 的开销。这里给每个 cbin 字体挂一张直接映射的缓存表，
+// 键是（当前字符，后继字符）对（后继参与度量是因为字距调整），命中时
+// 直接拷出量好的字形描述。聊天气泡和状态栏共用同一批字体对象，天然
+// 共享缓存；字体随主题销毁时缓存一并释放
+namespace {
+
+struct GlyphCacheEntry {
+    uint32_t letter;
+    uint32_t letter_next;
+    uint8_t valid;
+    uint8_t found;
+    lv_font_glyph_dsc_t dsc;
+};
+
+constexpr int kGlyphCacheSize = 256;   // 直接映射；每字体约 9KB，优先放 PSRAM
+constexpr int kMaxCachedFonts = 4;
+
+struct FontGlyphCache {
+    const lv_font_t* font = nullptr;
+    bool (*orig_cb)(const lv_font_t*, lv_font_glyph_dsc_t*, uint32_t, uint32_t) = nullptr;
+    GlyphCacheEntry* entries = nullptr;
+};
+
+FontGlyphCache g_font_caches[kMaxCachedFonts];
+
+FontGlyphCache* FindCache(const lv_font_t* font) {
+    for (auto& cache : g_font_caches) {
+        if (cache.font == font) {
+            return &cache;
+        }
+    }
+    return nullptr;
+}
+
+bool CachedGetGlyphDsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t letter_next) {
+    auto cache = FindCache(font);
+    if (cache == nullptr) {
+        return false;
+    }
+    auto& entry = cache->entries[(letter * 31 + letter_next) & (kGlyphCacheSize - 1)];
+    if (entry.valid && entry.letter == letter && entry.letter_next == letter_next) {
+        *dsc = entry.dsc;
+        return entry.found != 0;
+    }
+    bool found = cache->orig_cb(font, dsc, letter, letter_next);
+    entry.letter = letter;
+    entry.letter_next = letter_next;
+    entry.dsc = *dsc;
+    entry.found = found ? 1 : 0;
+    entry.valid = 1;
+    return found;
+}
+
+void RegisterGlyphCache(lv_font_t* font) {
+    if (font->get_glyph_dsc == nullptr || FindCache(font) != nullptr) {
+        return;
+    }
+    FontGlyphCache* slot = nullptr;
+    for (auto& cache : g_font_caches) {
+        if (cache.font == nullptr) {
+            slot = &cache;
+            break;
+        }
+    }
+    if (slot == nullptr) {
+        return;
+    }
+    auto entries = (GlyphCacheEntry*)heap_caps_calloc(kGlyphCacheSize, sizeof(GlyphCacheEntry), MALLOC_CAP_SPIRAM);
+    if (entries == nullptr) {
+        entries = (GlyphCacheEntry*)calloc(kGlyphCacheSize, sizeof(GlyphCacheEntry));
+    }
+    if (entries == nullptr) {
+        return;  // 没内存就不缓存，字体照常可用
+    }
+    slot->entries = entries;
+    slot->orig_cb = font->get_glyph_dsc;
+    slot->font = font;
+    font->get_glyph_dsc = CachedGetGlyphDsc;
+}
+
+void UnregisterGlyphCache(lv_font_t* font) {
+    auto cache = FindCache(font);
+    if (cache == nullptr) {
+        return;
+    }
+    font->get_glyph_dsc = cache->orig_cb;
+    free(cache->entries);
+    cache->entries = nullptr;
+    cache->orig_cb = nullptr;
+    cache->font = nullptr;
+}
+
+}  // namespace
+
+LvglCBinFont::LvglCBinFont(void* data, size_t size) : data_(data), size_(size) {
 }
 
 LvglCBinFont::~LvglCBinFont() {
     if (font_ != nullptr) {
+        UnregisterGlyphCache(font_);
         cbin_font_delete(font_);
     }
-}
\ No newline at end of file
+}
+
+const lv_font_t* LvglCBinFont::font() const {
+    // 首次使用时才创建字体对象，未被当前主题引用的字体不占内存
+    if (font_ == nullptr && !load_failed_) {
+        if (size_ > 0) {
+            // 字体头和字形表的首次解析是顺序读，提前预热下一页 flash cache
+            Assets::GetInstance().Prefetch(data_, size_);
+        }
+        font_ = cbin_font_create(static_cast<uint8_t*>(data_));
+        if (font_ == nullptr) {
+            ESP_LOGE(TAG, "Failed to create cbin font, falling back to default font");
+            load_failed_ = true;
+        } else {
+            RegisterGlyphCache(font_);
+        }
+    }
+    if (font_ == nullptr) {
+        return lv_font_get_default();
+    }
+    return font_;
+}
@@ -20,12 +20,22 @@ private:
 };
 
 
+// Font loaded from a cbin blob in the mmap'd assets partition. Glyph data is
+// read from flash on demand by the cbin_font component; the lv_font_t object
+// itself is created lazily on first use, so a font that is only referenced by
+// an inactive theme costs no RAM. Both themes share one instance, which makes
+// theme switching a pure style swap without re-creating font objects.
 class LvglCBinFont : public LvglFont {
 public:
-    LvglCBinFont(void* data);
+    // size is optional; when known it lets the first load issue read-ahead
+    // for the sequential header/table parse over the flash-mapped blob
+    LvglCBinFont(void* data, size_t size = 0);
     virtual ~LvglCBinFont();
-    virtual const lv_font_t* font() const override { return font_; }
+    virtual const lv_font_t* font() const override;
 
 private:
-    lv_font_t* font_;
+    void* data_;
+    size_t size_;
+    mutable lv_font_t* font_ = nullptr;
+    mutable bool load_failed_ = false;
 };
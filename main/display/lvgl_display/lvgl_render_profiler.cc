@@ -0,0 +1,224 @@
+#include "lvgl_render_profiler.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#define TAG "LvglProfiler"
+
+namespace {
+
+/* 类指针到可读名字的映射。被 Kconfig 裁掉的控件类没有符号，逐项用
+ * LV_USE_* 保护；不在表里的类回退成指针打印。 */
+const char* ClassName(const lv_obj_class_t* cls) {
+    if (cls == &lv_obj_class) return "obj";
+#if LV_USE_LABEL
+    if (cls == &lv_label_class) return "label";
+#endif
+#if LV_USE_IMAGE
+    if (cls == &lv_image_class) return "image";
+#endif
+#if LV_USE_BUTTON
+    if (cls == &lv_button_class) return "button";
+#endif
+#if LV_USE_BAR
+    if (cls == &lv_bar_class) return "bar";
+#endif
+#if LV_USE_SPINNER
+    if (cls == &lv_spinner_class) return "spinner";
+#endif
+#if LV_USE_TEXTAREA
+    if (cls == &lv_textarea_class) return "textarea";
+#endif
+#if LV_USE_SPANGROUP
+    if (cls == &lv_spangroup_class) return "spangroup";
+#endif
+    return nullptr;
+}
+
+}  // namespace
+
+void LvglRenderProfiler::DisplayEventCb(lv_event_t* e) {
+    auto* self = static_cast<LvglRenderProfiler*>(lv_event_get_user_data(e));
+    if (!self->enabled_) {
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_RENDER_START:
+            self->render_start_us_ = now_us;
+            break;
+        case LV_EVENT_RENDER_READY:
+            if (self->render_start_us_ != 0) {
+                self->render_.Record((uint32_t)(now_us - self->render_start_us_));
+                self->render_start_us_ = 0;
+            }
+            break;
+        case LV_EVENT_FLUSH_START:
+            self->flush_start_us_ = now_us;
+            break;
+        case LV_EVENT_FLUSH_FINISH:
+            if (self->flush_start_us_ != 0) {
+                self->flush_.Record((uint32_t)(now_us - self->flush_start_us_));
+                self->flush_start_us_ = 0;
+            }
+            break;
+        case LV_EVENT_INVALIDATE_AREA: {
+            auto* area = (const lv_area_t*)lv_event_get_param(e);
+            self->invalidations_++;
+            if (area != nullptr) {
+                self->invalidated_px_ +=
+                    (uint64_t)lv_area_get_width(area) * lv_area_get_height(area);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void LvglRenderProfiler::DrawEventCb(lv_event_t* e) {
+    auto* self = static_cast<LvglRenderProfiler*>(lv_event_get_user_data(e));
+    if (!self->enabled_) {
+        return;
+    }
+    auto* obj = (lv_obj_t*)lv_event_get_target(e);
+    if (lv_event_get_code(e) == LV_EVENT_DRAW_MAIN_BEGIN) {
+        self->draw_obj_ = obj;
+        self->draw_start_us_ = esp_timer_get_time();
+    } else if (lv_event_get_code(e) == LV_EVENT_DRAW_MAIN_END && self->draw_obj_ == obj) {
+        auto* slot = self->FindClassSlot(lv_obj_get_class(obj));
+        if (slot != nullptr) {
+            slot->draw.Record((uint32_t)(esp_timer_get_time() - self->draw_start_us_));
+        }
+        self->draw_obj_ = nullptr;
+    }
+}
+
+LvglRenderProfiler::ClassStats* LvglRenderProfiler::FindClassSlot(const lv_obj_class_t* cls) {
+    for (auto& slot : classes_) {
+        if (slot.cls == cls) {
+            return &slot;
+        }
+        if (slot.cls == nullptr) {
+            slot.cls = cls;
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void LvglRenderProfiler::AddObjHooks(lv_obj_t* obj) {
+    lv_obj_add_event_cb(obj, DrawEventCb, LV_EVENT_DRAW_MAIN_BEGIN, this);
+    lv_obj_add_event_cb(obj, DrawEventCb, LV_EVENT_DRAW_MAIN_END, this);
+    for (uint32_t i = 0; i < lv_obj_get_child_count(obj); i++) {
+        AddObjHooks(lv_obj_get_child(obj, i));
+    }
+}
+
+void LvglRenderProfiler::RemoveObjHooks(lv_obj_t* obj) {
+    // BEGIN/END 各注册了一次，摘两次
+    lv_obj_remove_event_cb_with_user_data(obj, DrawEventCb, this);
+    lv_obj_remove_event_cb_with_user_data(obj, DrawEventCb, this);
+    for (uint32_t i = 0; i < lv_obj_get_child_count(obj); i++) {
+        RemoveObjHooks(lv_obj_get_child(obj, i));
+    }
+}
+
+bool LvglRenderProfiler::Enable() {
+    if (enabled_) {
+        return false;
+    }
+    display_ = lv_display_get_default();
+    if (display_ == nullptr) {
+        return false;
+    }
+    if (!display_hooked_) {
+        // display 级回调常驻，未开窗时在回调入口直接返回
+        lv_display_add_event_cb(display_, DisplayEventCb, LV_EVENT_ALL, this);
+        display_hooked_ = true;
+    }
+
+    render_ = OpStats{};
+    flush_ = OpStats{};
+    invalidations_ = 0;
+    invalidated_px_ = 0;
+    memset(classes_, 0, sizeof(classes_));
+    render_start_us_ = flush_start_us_ = 0;
+    draw_obj_ = nullptr;
+
+    auto* screen = lv_display_get_screen_active(display_);
+    if (screen != nullptr) {
+        AddObjHooks(screen);
+    }
+    enabled_ = true;
+    return true;
+}
+
+void LvglRenderProfiler::Disable() {
+    if (!enabled_) {
+        return;
+    }
+    enabled_ = false;
+    auto* screen = lv_display_get_screen_active(display_);
+    if (screen != nullptr) {
+        RemoveObjHooks(screen);
+    }
+}
+
+std::string LvglRenderProfiler::Report() {
+    char buffer[128];
+    std::string json = "{";
+    snprintf(buffer, sizeof(buffer),
+             "\"frames\":%lu,\"render_avg_us\":%lu,\"render_max_us\":%lu,",
+             (unsigned long)render_.count,
+             (unsigned long)(render_.count > 0 ? render_.total_us / render_.count : 0),
+             (unsigned long)render_.max_us);
+    json += buffer;
+    snprintf(buffer, sizeof(buffer),
+             "\"flushes\":%lu,\"flush_avg_us\":%lu,\"flush_max_us\":%lu,",
+             (unsigned long)flush_.count,
+             (unsigned long)(flush_.count > 0 ? flush_.total_us / flush_.count : 0),
+             (unsigned long)flush_.max_us);
+    json += buffer;
+    snprintf(buffer, sizeof(buffer), "\"invalidations\":%lu,\"invalidated_px\":%llu,",
+             (unsigned long)invalidations_, (unsigned long long)invalidated_px_);
+    json += buffer;
+
+    // 控件类按总耗时冒泡排序后输出（槽位最多 16 个，开销可忽略）
+    ClassStats* order[kMaxClasses];
+    int used = 0;
+    for (auto& slot : classes_) {
+        if (slot.cls != nullptr) {
+            order[used++] = &slot;
+        }
+    }
+    for (int i = 0; i < used; i++) {
+        for (int j = i + 1; j < used; j++) {
+            if (order[j]->draw.total_us > order[i]->draw.total_us) {
+                auto* tmp = order[i];
+                order[i] = order[j];
+                order[j] = tmp;
+            }
+        }
+    }
+    json += "\"widgets\":[";
+    for (int i = 0; i < used; i++) {
+        const char* name = ClassName(order[i]->cls);
+        char label[24];
+        if (name == nullptr) {
+            snprintf(label, sizeof(label), "%p", (const void*)order[i]->cls);
+            name = label;
+        }
+        snprintf(buffer, sizeof(buffer),
+                 "%s{\"class\":\"%s\",\"draws\":%lu,\"total_us\":%llu,\"max_us\":%lu}",
+                 i > 0 ? "," : "", name, (unsigned long)order[i]->draw.count,
+                 (unsigned long long)order[i]->draw.total_us,
+                 (unsigned long)order[i]->draw.max_us);
+        json += buffer;
+    }
+    json += "]}";
+    return json;
+}
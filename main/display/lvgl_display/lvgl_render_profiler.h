@@ -0,0 +1,81 @@
+#ifndef LVGL_RENDER_PROFILER_H
+#define LVGL_RENDER_PROFILER_H
+
+#include <cstdint>
+#include <string>
+
+#include <lvgl.h>
+
+/*
+ * LVGL 渲染耗时画像，按需开窗（MCP 工具 self.screen.profile_render）。
+ *
+ * 聊天界面忙起来音频会跟着抖，但看不出贵在哪个控件。开窗后挂三层钩子：
+ * display 级的 RENDER_START/READY 计整帧渲染耗时、FLUSH_START/FINISH 计
+ * 每次刷屏传输耗时、INVALIDATE_AREA 统计失效次数与像素量；控件级给当前
+ * 对象树每个对象挂 DRAW_MAIN_BEGIN/END，按控件类聚合绘制耗时，报告里
+ * 按总耗时排出"最贵控件"。display 级回调注册一次后常驻（未开窗只付
+ * 一次布尔判断），对象钩子在关窗时摘除；窗口期间新建的控件不在统计内。
+ * 帧率上限/逐状态刷新预算这类调参以这里的数据为准，不再拍脑袋。
+ */
+class LvglRenderProfiler {
+public:
+    static LvglRenderProfiler& GetInstance() {
+        static LvglRenderProfiler instance;
+        return instance;
+    }
+
+    // 调用方持有显示锁；已在采集中返回 false
+    bool Enable();
+    // 调用方持有显示锁
+    void Disable();
+    // 关窗后取报告 JSON
+    std::string Report();
+
+private:
+    LvglRenderProfiler() = default;
+    LvglRenderProfiler(const LvglRenderProfiler&) = delete;
+    LvglRenderProfiler& operator=(const LvglRenderProfiler&) = delete;
+
+    static constexpr int kMaxClasses = 16;
+
+    struct OpStats {
+        uint32_t count = 0;
+        uint64_t total_us = 0;
+        uint32_t max_us = 0;
+
+        void Record(uint32_t us) {
+            count++;
+            total_us += us;
+            if (us > max_us) {
+                max_us = us;
+            }
+        }
+    };
+
+    struct ClassStats {
+        const lv_obj_class_t* cls = nullptr;
+        OpStats draw;
+    };
+
+    static void DisplayEventCb(lv_event_t* e);
+    static void DrawEventCb(lv_event_t* e);
+
+    void AddObjHooks(lv_obj_t* obj);
+    void RemoveObjHooks(lv_obj_t* obj);
+    ClassStats* FindClassSlot(const lv_obj_class_t* cls);
+
+    bool enabled_ = false;
+    bool display_hooked_ = false;
+    lv_display_t* display_ = nullptr;
+    int64_t render_start_us_ = 0;
+    int64_t flush_start_us_ = 0;
+    int64_t draw_start_us_ = 0;
+    lv_obj_t* draw_obj_ = nullptr;
+    OpStats render_;
+    OpStats flush_;
+    uint32_t invalidations_ = 0;
+    uint64_t invalidated_px_ = 0;
+    ClassStats classes_[kMaxClasses];
+};
+
+#endif // LVGL_RENDER_PROFILER_H
@@ -0,0 +1,187 @@
+#include "oled_diff_panel.h"
+
+#include <cstring>
+
+#include <esp_log.h>
+#include <esp_check.h>
+#include <esp_heap_caps.h>
+#include <esp_lcd_panel_interface.h>
+
+#define TAG "OledDiffPanel"
+
+namespace {
+
+struct oled_diff_panel_t {
+    esp_lcd_panel_t base;
+    esp_lcd_panel_handle_t real;
+    int width;
+    int pages;            // height / 8
+    uint8_t* shadow;      // page-major copy of the panel RAM, width bytes per page
+    bool shadow_valid;    // set after the first flush covering the whole screen
+};
+
+inline oled_diff_panel_t* from_base(esp_lcd_panel_t* panel) {
+    return __containerof(panel, oled_diff_panel_t, base);
+}
+
+esp_err_t diff_panel_reset(esp_lcd_panel_t* panel) {
+    auto dp = from_base(panel);
+    dp->shadow_valid = false;
+    return dp->real->reset(dp->real);
+}
+
+esp_err_t diff_panel_init(esp_lcd_panel_t* panel) {
+    auto dp = from_base(panel);
+    dp->shadow_valid = false;
+    return dp->real->init(dp->real);
+}
+
+esp_err_t diff_panel_del(esp_lcd_panel_t* panel) {
+    auto dp = from_base(panel);
+    heap_caps_free(dp->shadow);
+    heap_caps_free(dp);
+    return ESP_OK;
+}
+
+esp_err_t diff_panel_draw_bitmap(esp_lcd_panel_t* panel, int x_start, int y_start,
+                                 int x_end, int y_end, const void* color_data) {
+    auto dp = from_base(panel);
+    int w = x_end - x_start;
+    if (color_data == nullptr || w <= 0 || (y_start % 8) != 0 || (y_end % 8) != 0) {
+        // Not page aligned, cannot diff against the shadow buffer
+        return esp_lcd_panel_draw_bitmap(dp->real, x_start, y_start, x_end, y_end, color_data);
+    }
+
+    auto src = static_cast<const uint8_t*>(color_data);
+    int first_page = y_start / 8;
+    int last_page = y_end / 8;  // exclusive
+
+    if (!dp->shadow_valid) {
+        // Panel RAM content is unknown until a full-screen flush has landed
+        esp_err_t err = esp_lcd_panel_draw_bitmap(dp->real, x_start, y_start, x_end, y_end, color_data);
+        if (err != ESP_OK) {
+            return err;
+        }
+        for (int page = first_page; page < last_page; page++) {
+            memcpy(dp->shadow + page * dp->width + x_start, src + (page - first_page) * w, w);
+        }
+        if (x_start == 0 && w == dp->width && first_page == 0 && last_page == dp->pages) {
+            dp->shadow_valid = true;
+        }
+        return ESP_OK;
+    }
+
+    bool transmitted = false;
+    int page = first_page;
+    while (page < last_page) {
+        const uint8_t* row_new = src + (page - first_page) * w;
+        uint8_t* row_old = dp->shadow + page * dp->width + x_start;
+        if (memcmp(row_new, row_old, w) == 0) {
+            page++;
+            continue;
+        }
+
+        // Merge the run of adjacent dirty pages: one transaction with a few
+        // retransmitted bytes beats one address setup per page on I2C
+        int run_end = page + 1;
+        while (run_end < last_page &&
+               memcmp(src + (run_end - first_page) * w, dp->shadow + run_end * dp->width + x_start, w) != 0) {
+            run_end++;
+        }
+
+        esp_err_t err;
+        if (run_end - page > 1) {
+            // Source rows are contiguous, send the run full-width in one go
+            err = esp_lcd_panel_draw_bitmap(dp->real, x_start, page * 8, x_end, run_end * 8, row_new);
+            for (int p = page; p < run_end; p++) {
+                memcpy(dp->shadow + p * dp->width + x_start, src + (p - first_page) * w, w);
+            }
+        } else {
+            // Single dirty page: clip to the changed column span
+            int c0 = 0;
+            while (row_new[c0] == row_old[c0]) {
+                c0++;
+            }
+            int c1 = w - 1;
+            while (row_new[c1] == row_old[c1]) {
+                c1--;
+            }
+            err = esp_lcd_panel_draw_bitmap(dp->real, x_start + c0, page * 8,
+                                            x_start + c1 + 1, page * 8 + 8, row_new + c0);
+            memcpy(row_old + c0, row_new + c0, c1 - c0 + 1);
+        }
+        if (err != ESP_OK) {
+            dp->shadow_valid = false;
+            return err;
+        }
+        transmitted = true;
+        page = run_end;
+    }
+
+    if (!transmitted) {
+        // esp_lvgl_port completes the flush from the trans_done callback, so a
+        // no-change frame still has to generate one (minimal) transaction
+        return esp_lcd_panel_draw_bitmap(dp->real, x_start, y_start, x_start + 1, y_start + 8, src);
+    }
+    return ESP_OK;
+}
+
+esp_err_t diff_panel_mirror(esp_lcd_panel_t* panel, bool x_axis, bool y_axis) {
+    auto dp = from_base(panel);
+    dp->shadow_valid = false;
+    return dp->real->mirror(dp->real, x_axis, y_axis);
+}
+
+esp_err_t diff_panel_swap_xy(esp_lcd_panel_t* panel, bool swap_axes) {
+    auto dp = from_base(panel);
+    dp->shadow_valid = false;
+    return dp->real->swap_xy(dp->real, swap_axes);
+}
+
+esp_err_t diff_panel_set_gap(esp_lcd_panel_t* panel, int x_gap, int y_gap) {
+    auto dp = from_base(panel);
+    return dp->real->set_gap(dp->real, x_gap, y_gap);
+}
+
+esp_err_t diff_panel_invert_color(esp_lcd_panel_t* panel, bool invert_color_data) {
+    auto dp = from_base(panel);
+    return dp->real->invert_color(dp->real, invert_color_data);
+}
+
+esp_err_t diff_panel_disp_on_off(esp_lcd_panel_t* panel, bool on_off) {
+    auto dp = from_base(panel);
+    return dp->real->disp_on_off(dp->real, on_off);
+}
+
+}  // namespace
+
+esp_err_t oled_diff_panel_create(esp_lcd_panel_handle_t real_panel, int width, int height,
+                                 esp_lcd_panel_handle_t* ret_panel) {
+    ESP_RETURN_ON_FALSE(real_panel != nullptr && ret_panel != nullptr, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(width > 0 && height > 0 && (height % 8) == 0, ESP_ERR_INVALID_ARG, TAG, "invalid resolution");
+
+    auto dp = static_cast<oled_diff_panel_t*>(heap_caps_calloc(1, sizeof(oled_diff_panel_t), MALLOC_CAP_INTERNAL));
+    ESP_RETURN_ON_FALSE(dp != nullptr, ESP_ERR_NO_MEM, TAG, "no mem for diff panel");
+
+    dp->real = real_panel;
+    dp->width = width;
+    dp->pages = height / 8;
+    dp->shadow = static_cast<uint8_t*>(heap_caps_malloc(width * dp->pages, MALLOC_CAP_INTERNAL));
+    if (dp->shadow == nullptr) {
+        heap_caps_free(dp);
+        return ESP_ERR_NO_MEM;
+    }
+
+    dp->base.reset = diff_panel_reset;
+    dp->base.init = diff_panel_init;
+    dp->base.del = diff_panel_del;
+    dp->base.draw_bitmap = diff_panel_draw_bitmap;
+    dp->base.mirror = diff_panel_mirror;
+    dp->base.swap_xy = diff_panel_swap_xy;
+    dp->base.set_gap = diff_panel_set_gap;
+    dp->base.invert_color = diff_panel_invert_color;
+    dp->base.disp_on_off = diff_panel_disp_on_off;
+
+    *ret_panel = &dp->base;
+    return ESP_OK;
+}
@@ -0,0 +1,19 @@
+#ifndef OLED_DIFF_PANEL_H
+#define OLED_DIFF_PANEL_H
+
+#include <esp_lcd_panel_ops.h>
+
+// Wraps an SSD1306-class monochrome panel with a dirty-page tracker: each
+// draw_bitmap is compared against a shadow copy of the panel RAM and only the
+// changed 8-pixel pages are forwarded to the real panel. Runs of adjacent
+// dirty pages are merged into a single transaction, a single dirty page is
+// clipped to its changed column span. Status-bar-only refreshes then cost a
+// few dozen bytes of I2C time instead of a full framebuffer, which matters on
+// boards that share the bus with the audio codec.
+//
+// The wrapper does not own the real panel: deleting it frees only the shadow
+// buffer, the caller keeps deleting the real panel as before.
+esp_err_t oled_diff_panel_create(esp_lcd_panel_handle_t real_panel, int width, int height,
+                                 esp_lcd_panel_handle_t* ret_panel);
+
+#endif // OLED_DIFF_PANEL_H
@@ -1,4 +1,5 @@
 #include "oled_display.h"
+#include "oled_diff_panel.h"
 #include "assets/lang_config.h"
 #include "lvgl_theme.h"
 #include "lvgl_font.h"
@@ -46,9 +47,15 @@ OledDisplay::OledDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handl
     lvgl_port_init(&port_cfg);
 
     ESP_LOGI(TAG, "Adding OLED display");
+    // Only transmit changed 8-pixel pages; the I2C bus is shared with the
+    // audio codec on several boards
+    if (oled_diff_panel_create(panel_, width_, height_, &diff_panel_) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to create diff panel, flushing full frames");
+        diff_panel_ = nullptr;
+    }
     const lvgl_port_display_cfg_t display_cfg = {
         .io_handle = panel_io_,
-        .panel_handle = panel_,
+        .panel_handle = diff_panel_ != nullptr ? diff_panel_ : panel_,
         .control_handle = nullptr,
         .buffer_size = static_cast<uint32_t>(width_ * height_),
         .double_buffer = false,
@@ -114,6 +121,9 @@ OledDisplay::~OledDisplay() {
         lv_obj_del(container_);
     }
 
+    if (diff_panel_ != nullptr) {
+        esp_lcd_panel_del(diff_panel_);  // frees only the wrapper, not panel_
+    }
     if (panel_ != nullptr) {
         esp_lcd_panel_del(panel_);
     }
@@ -132,6 +142,13 @@ void OledDisplay::Unlock() {
 }
 
 void OledDisplay::SetChatMessage(const char* role, const char* content) {
+    // Coalesce per LVGL tick, see LvglDisplay::QueueDisplayUpdate
+    QueueDisplayUpdate("chat_message", [this, role = std::string(role), content = std::string(content)]() {
+        ApplyChatMessage(role.c_str(), content.c_str());
+    });
+}
+
+void OledDisplay::ApplyChatMessage(const char* role, const char* content) {
     DisplayLockGuard lock(this);
     if (chat_message_label_ == nullptr) {
         return;
@@ -373,6 +390,12 @@ void OledDisplay::SetupUI_128x32() {
 }
 
 void OledDisplay::SetEmotion(const char* emotion) {
+    QueueDisplayUpdate("emotion", [this, emotion = std::string(emotion)]() {
+        ApplyEmotion(emotion.c_str());
+    });
+}
+
+void OledDisplay::ApplyEmotion(const char* emotion) {
     const char* utf8 = font_awesome_get_utf8(emotion);
     DisplayLockGuard lock(this);
     if (emotion_label_ == nullptr) {
@@ -11,6 +11,7 @@ class OledDisplay : public LvglDisplay {
 private:
     esp_lcd_panel_io_handle_t panel_io_ = nullptr;
     esp_lcd_panel_handle_t panel_ = nullptr;
+    esp_lcd_panel_handle_t diff_panel_ = nullptr;  // dirty-page wrapper around panel_
 
     lv_obj_t* top_bar_ = nullptr;
     lv_obj_t* status_bar_ = nullptr;
@@ -28,6 +29,10 @@ private:
     void SetupUI_128x64();
     void SetupUI_128x32();
 
+    // Actual UI updates, run in the LVGL task via the coalescing queue
+    void ApplyChatMessage(const char* role, const char* content);
+    void ApplyEmotion(const char* emotion);
+
 public:
     OledDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel, int width, int height, bool mirror_x, bool mirror_y);
     ~OledDisplay();
@@ -0,0 +1,84 @@
+#include "dns_prefetch.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <lwip/netdb.h>
+#include <lwip/ip_addr.h>
+
+#include <algorithm>
+
+#define TAG "DnsPrefetch"
+
+void DnsPrefetch::AddUrl(const std::string& url) {
+    // 摘出 scheme:// 和端口/路径之间的主机名
+    size_t start = url.find("://");
+    start = (start == std::string::npos) ? 0 : start + 3;
+    size_t end = url.find_first_of(":/", start);
+    std::string host = url.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    if (host.empty()) {
+        return;
+    }
+    // IP 直连不需要解析
+    ip_addr_t addr;
+    if (ipaddr_aton(host.c_str(), &addr)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (std::find(hosts_.begin(), hosts_.end(), host) != hosts_.end()) {
+        return;
+    }
+    if (hosts_.size() >= kMaxHosts) {
+        ESP_LOGW(TAG, "Host list full, not prefetching %s", host.c_str());
+        return;
+    }
+    hosts_.push_back(std::move(host));
+}
+
+void DnsPrefetch::Start() {
+    if (task_handle_ != nullptr) {
+        return;
+    }
+    xTaskCreate([](void* arg) {
+        ((DnsPrefetch*)arg)->PrefetchTask();
+        vTaskDelete(NULL);
+    }, "dns_prefetch", 3072, this, 1, &task_handle_);
+}
+
+void DnsPrefetch::RefreshNow() {
+    if (task_handle_ != nullptr) {
+        xTaskNotifyGive(task_handle_);
+    }
+}
+
+void DnsPrefetch::PrefetchTask() {
+    while (true) {
+        ResolveAll();
+        // 到点或被 RefreshNow 提前唤醒都重解析一轮
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kRefreshIntervalMs));
+    }
+}
+
+void DnsPrefetch::ResolveAll() {
+    std::vector<std::string> hosts;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hosts = hosts_;
+    }
+    for (const auto& host : hosts) {
+        // AF_UNSPEC 让 lwIP 按编译配置同时查 A/AAAA；结果进 DNS 表，
+        // 这里只要触发解析，地址本身用不上
+        struct addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo* result = nullptr;
+        int64_t start_us = esp_timer_get_time();
+        int err = getaddrinfo(host.c_str(), nullptr, &hints, &result);
+        if (err == 0) {
+            ESP_LOGD(TAG, "Resolved %s in %d ms", host.c_str(),
+                     (int)((esp_timer_get_time() - start_us) / 1000));
+            freeaddrinfo(result);
+        } else {
+            ESP_LOGW(TAG, "Failed to resolve %s: %d", host.c_str(), err);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef DNS_PREFETCH_H
+#define DNS_PREFETCH_H
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * DNS 预热。OTA 检查、资源下载和协议连接都经由封装好的 HTTP/WebSocket
+ * 客户端走阻塞 getaddrinfo，冷链路（蜂窝网）上单次解析要 300-800ms。
+ * 这里把已知端点的主机名提前解析一遍，把 lwIP 自带的 DNS 表焐热——
+ * 表项带 TTL，后续 getaddrinfo 直接命中；后台任务周期性重解析，
+ * 保证过期表项在下一次连接前已经补好。
+ */
+class DnsPrefetch {
+public:
+    static DnsPrefetch& GetInstance() {
+        static DnsPrefetch instance;
+        return instance;
+    }
+
+    // 从完整 URL 里摘出主机名登记；IP 直连和重复登记会被忽略
+    void AddUrl(const std::string& url);
+    // 网络就绪后调用：立刻解析一轮并启动后台刷新任务
+    void Start();
+    // 链路切换/重连后把下一轮刷新提前到现在
+    void RefreshNow();
+
+private:
+    DnsPrefetch() = default;
+    DnsPrefetch(const DnsPrefetch&) = delete;
+    DnsPrefetch& operator=(const DnsPrefetch&) = delete;
+
+    void PrefetchTask();
+    void ResolveAll();
+
+    // lwIP DNS 表默认只有 4 个槽位，登记多了反而互相挤占
+    static const size_t kMaxHosts = 4;
+    static const int kRefreshIntervalMs = 5 * 60 * 1000;
+
+    std::mutex mutex_;
+    std::vector<std::string> hosts_;
+    TaskHandle_t task_handle_ = nullptr;
+};
+
+#endif // DNS_PREFETCH_H
@@ -0,0 +1,63 @@
+#include "dvfs_governor.h"
+#include "device_state_event.h"
+
+#include <esp_log.h>
+#include <esp_pm.h>
+
+#define TAG "DvfsGovernor"
+
+#if CONFIG_DVFS_GOVERNOR
+
+namespace {
+constexpr int kMaxFreqMhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+constexpr int kIdleMaxFreqMhz = 80;
+constexpr int kFloorFreqMhz = 40;
+}
+
+void DvfsGovernor::Init() {
+    // 同步档：升频必须在状态切换继续之前完成，比如进入 Speaking 开 AEC
+    DeviceStateEventManager::GetInstance().RegisterStateChangeCallback(
+        [this](DeviceState previous_state, DeviceState current_state) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            state_ = current_state;
+            Apply();
+        }, StateCallbackTier::kSync);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Apply();
+}
+
+void DvfsGovernor::SetAudioLock(bool locked) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (audio_locked_ == locked) {
+        return;
+    }
+    audio_locked_ = locked;
+    Apply();
+}
+
+void DvfsGovernor::Apply() {
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = kMaxFreqMhz,
+        .min_freq_mhz = kFloorFreqMhz,
+        .light_sleep_enable = false,
+    };
+    if (audio_locked_) {
+        // 音频处理器运行期间锁死满频，降频换挡会把 AEC 跑出欠载
+        pm_config.min_freq_mhz = kMaxFreqMhz;
+    } else if (state_ == kDeviceStateIdle || state_ == kDeviceStateUnknown) {
+        pm_config.max_freq_mhz = kIdleMaxFreqMhz;
+    }
+    esp_err_t err = esp_pm_configure(&pm_config);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "esp_pm_configure failed: %s", esp_err_to_name(err));
+    }
+}
+
+#else
+
+void DvfsGovernor::Init() {}
+void DvfsGovernor::SetAudioLock(bool locked) {}
+void DvfsGovernor::Apply() {}
+
+#endif
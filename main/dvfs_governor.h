@@ -0,0 +1,39 @@
+#ifndef DVFS_GOVERNOR_H
+#define DVFS_GOVERNOR_H
+
+#include <mutex>
+
+#include "device_state.h"
+
+/**
+ * 按设备状态调 CPU 频率的 DVFS 调速器（CONFIG_DVFS_GOVERNOR 开启时生效）。
+ * 空闲态只跑唤醒词检测，降到 80MHz 足够；进入交互态恢复满频。音频处理器
+ * （AEC/VAD）运行期间通过 SetAudioLock 锁死满频，保证不会因为降频把音频
+ * 流水线跑出欠载。与 PowerSaveTimer 的深度省电互斥，见 Kconfig 说明。
+ */
+class DvfsGovernor {
+public:
+    static DvfsGovernor& GetInstance() {
+        static DvfsGovernor instance;
+        return instance;
+    }
+
+    // 注册状态监听并应用初始档位，Application::Start 里调用一次
+    void Init();
+
+    // 音频处理器启停时由 AudioService 调用；true 期间锁定满频
+    void SetAudioLock(bool locked);
+
+private:
+    DvfsGovernor() = default;
+    DvfsGovernor(const DvfsGovernor&) = delete;
+    DvfsGovernor& operator=(const DvfsGovernor&) = delete;
+
+    void Apply();
+
+    std::mutex mutex_;
+    DeviceState state_ = kDeviceStateUnknown;
+    bool audio_locked_ = false;
+};
+
+#endif // DVFS_GOVERNOR_H
@@ -0,0 +1,57 @@
+#include "flash_op_monitor.h"
+
+#include <esp_log.h>
+
+#define TAG "FlashOpMon"
+
+namespace {
+const char* const kKindNames[] = { "nvs_commit", "write", "erase" };
+const TracePoint kKindPoints[] = {
+    TracePoint::kNvsCommit, TracePoint::kFlashWrite, TracePoint::kFlashErase,
+};
+}
+
+void FlashOpMonitor::Record(OpKind kind, int64_t duration_us) {
+    TRACE_EVENT(kKindPoints[kind], duration_us / 64);
+    auto& stats = kinds_[kind];
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    stats.total_us.fetch_add((uint32_t)duration_us, std::memory_order_relaxed);
+    uint32_t max = stats.max_us.load(std::memory_order_relaxed);
+    while ((uint32_t)duration_us > max &&
+           !stats.max_us.compare_exchange_weak(max, (uint32_t)duration_us,
+                                               std::memory_order_relaxed)) {
+    }
+    last_op_end_us_.store(esp_timer_get_time(), std::memory_order_relaxed);
+}
+
+void FlashOpMonitor::OnUnderrun() {
+    int64_t last_end = last_op_end_us_.load(std::memory_order_relaxed);
+    if (last_end != 0 && esp_timer_get_time() - last_end < kCorrelationWindowUs) {
+        underruns_near_flash_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void FlashOpMonitor::Dump() {
+    uint32_t total_ops = 0;
+    for (auto& stats : kinds_) {
+        total_ops += stats.count.load(std::memory_order_relaxed);
+    }
+    if (total_ops == 0) {
+        return;
+    }
+    for (int i = 0; i < kKindCount; i++) {
+        uint32_t count = kinds_[i].count.load(std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+        uint32_t total_us = kinds_[i].total_us.load(std::memory_order_relaxed);
+        ESP_LOGI(TAG, "%-10s %6lu ops, avg %5lu us, max %6lu us", kKindNames[i],
+                 (unsigned long)count, (unsigned long)(total_us / count),
+                 (unsigned long)kinds_[i].max_us.load(std::memory_order_relaxed));
+    }
+    uint32_t near = underruns_near_flash_.load(std::memory_order_relaxed);
+    if (near > 0) {
+        ESP_LOGW(TAG, "underruns within %lldms of a flash op: %lu",
+                 (long long)(kCorrelationWindowUs / 1000), (unsigned long)near);
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef FLASH_OP_MONITOR_H
+#define FLASH_OP_MONITOR_H
+
+#include <atomic>
+#include <cstdint>
+
+#include <esp_timer.h>
+
+#include "tracepoint.h"
+
+/*
+ * Flash 操作时延监视：回答"音频爆音是不是 flash 写引起的"。
+ *
+ * NVS 提交、资源分区写、OTA 擦写都会让 cache 停摆，嫌疑很大但一直
+ * 没有证据。各写入口用 FlashOpScope 包住后，每次操作的耗时打进
+ * tracepoint 环（采集窗口内可与 audio_underrun 事件对齐看时间线），
+ * 同时这里常驻记录每类操作的次数/累计/最大耗时和最近一次结束时间；
+ * 播放欠载发生时音频侧回查：距 flash 操作 100ms 以内的欠载单独计数。
+ * 这个计数决定后续是做 IRAM 固定还是音频感知的 flash 调度——拿数据
+ * 说话，不靠猜。
+ */
+class FlashOpMonitor {
+public:
+    enum OpKind {
+        kNvsCommit,
+        kPartitionWrite,
+        kPartitionErase,
+        kKindCount,
+    };
+
+    static FlashOpMonitor& GetInstance() {
+        static FlashOpMonitor instance;
+        return instance;
+    }
+
+    void Record(OpKind kind, int64_t duration_us);
+
+    // 播放欠载时由音频服务调用，做时间邻近归因
+    void OnUnderrun();
+
+    // 有操作记录时打印汇总（周期调试节拍里调用）
+    void Dump();
+
+private:
+    FlashOpMonitor() = default;
+    FlashOpMonitor(const FlashOpMonitor&) = delete;
+    FlashOpMonitor& operator=(const FlashOpMonitor&) = delete;
+
+    // 欠载归因窗口：flash 操作结束后多久内的欠载算"疑似相关"
+    static constexpr int64_t kCorrelationWindowUs = 100 * 1000;
+
+    struct KindStats {
+        std::atomic<uint32_t> count{0};
+        std::atomic<uint32_t> total_us{0};
+        std::atomic<uint32_t> max_us{0};
+    };
+
+    KindStats kinds_[kKindCount];
+    std::atomic<int64_t> last_op_end_us_{0};
+    std::atomic<uint32_t> underruns_near_flash_{0};
+};
+
+// RAII：包住一次 flash 操作，析构时记录耗时
+class FlashOpScope {
+public:
+    explicit FlashOpScope(FlashOpMonitor::OpKind kind)
+        : kind_(kind), start_us_(esp_timer_get_time()) {}
+    ~FlashOpScope() {
+        FlashOpMonitor::GetInstance().Record(kind_, esp_timer_get_time() - start_us_);
+    }
+
+private:
+    FlashOpMonitor::OpKind kind_;
+    int64_t start_us_;
+};
+
+#endif // FLASH_OP_MONITOR_H
@@ -0,0 +1,187 @@
+#include "heap_telemetry.h"
+
+#include <cstring>
+
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#define TAG "HeapTelemetry"
+
+namespace {
+// 碎片化告警阈值：内部 RAM 最大空闲块跌破 16KB（一个任务栈都放不下）
+// 或 PSRAM 跌破 64KB（一帧解码缓冲级别）时触发缓解
+constexpr size_t kInternalLargestMin = 16 * 1024;
+constexpr size_t kPsramLargestMin = 64 * 1024;
+// 缓解动作冷却：避免阈值附近来回抖动时反复清缓存
+constexpr int64_t kAlarmCooldownUs = 3600LL * 1000000;
+
+size_t SizeBucket(size_t bytes) {
+    size_t bucket = 0;
+    while ((bytes >> 1) != 0 && bucket < HeapTelemetry::kNumSizeBuckets - 1) {
+        bytes >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+}
+
+HeapTelemetry::TagStats* HeapTelemetry::FindSlot(const char* tag) {
+    for (size_t i = 0; i < kMaxTags; i++) {
+        if (tags_[i].tag == nullptr) {
+            tags_[i].tag = tag;
+            return &tags_[i];
+        }
+        if (tags_[i].tag == tag || strcmp(tags_[i].tag, tag) == 0) {
+            return &tags_[i];
+        }
+    }
+    return nullptr;
+}
+
+void HeapTelemetry::Add(const char* tag, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto* slot = FindSlot(tag);
+    if (slot == nullptr) {
+        return;
+    }
+    slot->current += bytes;
+    slot->allocs++;
+    slot->size_hist[SizeBucket(bytes)]++;
+    if (slot->current > slot->peak) {
+        slot->peak = slot->current;
+    }
+}
+
+void HeapTelemetry::RegisterMitigation(const char* name, std::function<size_t()> handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& slot : mitigations_) {
+        if (slot.name == nullptr) {
+            slot.name = name;
+            slot.handler = std::move(handler);
+            return;
+        }
+    }
+    ESP_LOGW(TAG, "Mitigation slots exhausted, %s not registered", name);
+}
+
+void HeapTelemetry::CheckFragmentation() {
+    size_t internal_largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+    size_t psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    size_t psram_largest = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+
+    bool internal_low = internal_largest < kInternalLargestMin;
+    // 无 PSRAM 的板子 free 恒为 0，不误报
+    bool psram_low = psram_free > kPsramLargestMin && psram_largest < kPsramLargestMin;
+    if (!internal_low && !psram_low) {
+        return;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (last_alarm_us_ != 0 && now_us - last_alarm_us_ < kAlarmCooldownUs) {
+            return;
+        }
+        last_alarm_us_ = now_us;
+        fragmentation_alarms_++;
+    }
+
+    ESP_LOGW(TAG, "Fragmentation alarm: internal largest %u, psram largest %u/%u",
+             (unsigned)internal_largest, (unsigned)psram_largest, (unsigned)psram_free);
+    for (auto& mitigation : mitigations_) {
+        if (mitigation.name == nullptr) {
+            break;
+        }
+        size_t freed = mitigation.handler();
+        ESP_LOGW(TAG, "  mitigation %s freed %u bytes", mitigation.name, (unsigned)freed);
+    }
+}
+
+void HeapTelemetry::Remove(const char* tag, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto* slot = FindSlot(tag);
+    if (slot == nullptr) {
+        return;
+    }
+    // 记账不配对说明某处漏了 Add/Remove，钳住而不是下溢
+    if (bytes > slot->current) {
+        ESP_LOGW(TAG, "Unbalanced remove for tag %s: %u > %u", tag, (unsigned)bytes, (unsigned)slot->current);
+        slot->current = 0;
+    } else {
+        slot->current -= bytes;
+    }
+}
+
+std::string HeapTelemetry::GetJson() const {
+    char buffer[128];
+    std::string json = "{";
+    snprintf(buffer, sizeof(buffer), "\"internal\":{\"free\":%u,\"min_free\":%u,\"largest\":%u},",
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+    json += buffer;
+    snprintf(buffer, sizeof(buffer), "\"psram\":{\"free\":%u,\"min_free\":%u,\"largest\":%u},",
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM));
+    json += buffer;
+    json += "\"tags\":[";
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool first = true;
+        for (size_t i = 0; i < kMaxTags; i++) {
+            if (tags_[i].tag == nullptr) {
+                break;
+            }
+            snprintf(buffer, sizeof(buffer), "%s{\"tag\":\"%s\",\"current\":%u,\"peak\":%u,\"allocs\":%lu,\"hist\":[",
+                     first ? "" : ",", tags_[i].tag, (unsigned)tags_[i].current,
+                     (unsigned)tags_[i].peak, (unsigned long)tags_[i].allocs);
+            json += buffer;
+            // 尺寸直方图截断到最后一个非零桶
+            size_t last = 0;
+            for (size_t b = 0; b < kNumSizeBuckets; b++) {
+                if (tags_[i].size_hist[b] != 0) {
+                    last = b + 1;
+                }
+            }
+            for (size_t b = 0; b < last; b++) {
+                snprintf(buffer, sizeof(buffer), "%s%lu", b > 0 ? "," : "",
+                         (unsigned long)tags_[i].size_hist[b]);
+                json += buffer;
+            }
+            json += "]}";
+            first = false;
+        }
+        snprintf(buffer, sizeof(buffer), "],\"frag_alarms\":%lu}",
+                 (unsigned long)fragmentation_alarms_);
+        json += buffer;
+    }
+    return json;
+}
+
+void HeapTelemetry::LogCompact() const {
+    char tags_line[128] = "";
+    size_t used = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < kMaxTags; i++) {
+            if (tags_[i].tag == nullptr) {
+                break;
+            }
+            int n = snprintf(tags_line + used, sizeof(tags_line) - used, " %s:%u/%u",
+                             tags_[i].tag, (unsigned)tags_[i].current, (unsigned)tags_[i].peak);
+            if (n < 0 || used + n >= sizeof(tags_line)) {
+                break;
+            }
+            used += n;
+        }
+    }
+    ESP_LOGI(TAG, "sram %u min %u lg %u | psram %u min %u |%s",
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL),
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM),
+             tags_line);
+}
@@ -0,0 +1,81 @@
+#ifndef HEAP_TELEMETRY_H
+#define HEAP_TELEMETRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+/**
+ * 堆用量遥测。各子系统在自己管理的 heap_caps_malloc/free 配对处调用
+ * Add/Remove 按标签记账（audio/display/camera/ota），排查 OOM 时能看出
+ * 内存被谁占走；内部 RAM 与 PSRAM 的水位直接从 heap_caps 接口读取。
+ * 汇总 JSON 可通过 self.get_heap_stats 工具在线上查询，主循环每 10 秒
+ * 打一行紧凑日志（见 Application::MainEventLoop）。
+ *
+ * 碎片化监控：长时间运行的设备总空闲充足却 OOM，是最大空闲块被切碎。
+ * CheckFragmentation 周期比较 largest-free-block 与 total-free，内部
+ * RAM 或 PSRAM 跌破阈值时先打告警，再依次执行注册的缓解动作（比如丢弃
+ * 已解码提示音缓存），在分配失败变成死机之前腾出整块内存。按标签的
+ * log2 分配尺寸直方图随 JSON 一起导出，离线能看出是谁在制造碎片。
+ */
+class HeapTelemetry {
+public:
+    static HeapTelemetry& GetInstance() {
+        static HeapTelemetry instance;
+        return instance;
+    }
+
+    // log2 尺寸桶：桶 i 覆盖 [2^i, 2^(i+1))，最后一桶收尾
+    static const size_t kNumSizeBuckets = 20;
+
+    // tag 必须是字符串字面量，按指针/内容匹配到固定槽位，热路径上不分配
+    void Add(const char* tag, size_t bytes);
+    void Remove(const char* tag, size_t bytes);
+
+    // 碎片化缓解动作，返回释放的字节数；告警时按注册顺序执行。
+    // 回调在 CheckFragmentation 的调用任务（主循环）上运行
+    void RegisterMitigation(const char* name, std::function<size_t()> handler);
+
+    // 周期调用（主循环 10 秒节拍）：检查两块堆的最大空闲块，跌破阈值
+    // 时告警并触发缓解动作，同一小时内不重复触发
+    void CheckFragmentation();
+
+    // {"internal":{...},"psram":{...},"tags":[{"tag":...,"current":...,"peak":...,"allocs":...,"hist":[...]}]}
+    std::string GetJson() const;
+    // 单行紧凑日志，替代原来只打内部 RAM 的 SystemInfo::PrintHeapStats
+    void LogCompact() const;
+
+private:
+    HeapTelemetry() = default;
+    HeapTelemetry(const HeapTelemetry&) = delete;
+    HeapTelemetry& operator=(const HeapTelemetry&) = delete;
+
+    static const size_t kMaxTags = 8;
+    static const size_t kMaxMitigations = 4;
+
+    struct TagStats {
+        const char* tag = nullptr;
+        size_t current = 0;
+        size_t peak = 0;
+        uint32_t allocs = 0;
+        uint32_t size_hist[kNumSizeBuckets] = {};
+    };
+
+    struct Mitigation {
+        const char* name = nullptr;
+        std::function<size_t()> handler;
+    };
+
+    // 调用方持有 mutex_；找不到且槽位用尽时返回 nullptr
+    TagStats* FindSlot(const char* tag);
+
+    mutable std::mutex mutex_;
+    TagStats tags_[kMaxTags];
+    Mitigation mitigations_[kMaxMitigations];
+    uint32_t fragmentation_alarms_ = 0;
+    int64_t last_alarm_us_ = 0;
+};
+
+#endif // HEAP_TELEMETRY_H
@@ -0,0 +1,31 @@
+#include "hot_log.h"
+
+#define TAG "HotLog"
+
+void HotLog::NotifyDrainTask() {
+    TaskHandle_t task = drain_task_.load(std::memory_order_acquire);
+    if (task == nullptr) {
+        bool expected = false;
+        if (!task_starting_.compare_exchange_strong(expected, true)) {
+            // 另一个生产者正在建任务，它起来后自然会排空
+            return;
+        }
+        xTaskCreate([](void* arg) {
+            static_cast<HotLog*>(arg)->DrainLoop();
+        }, "hot_log", 3072, this, 1, &task);
+        drain_task_.store(task, std::memory_order_release);
+    }
+    xTaskNotifyGive(task);
+}
+
+void HotLog::DrainLoop() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (ring_.PopAndInvoke()) {
+        }
+        uint32_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            ESP_LOGW(TAG, "Dropped %lu hot-path log records", (unsigned long)dropped);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef HOT_LOG_H
+#define HOT_LOG_H
+
+#include <atomic>
+#include <type_traits>
+
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "callable_ring.h"
+
+/*
+ * Deferred-formatting log channel for hot paths.
+ *
+ * ESP_LOGx formats and writes to the console inline, and UART output can
+ * block the calling task — enabling verbose logging in the audio or
+ * protocol tasks shifts the very timing being debugged. HOT_LOGx instead
+ * records the format-string pointer and the raw 32-bit arguments into the
+ * lock-free callable ring (~1us) and a priority-1 task does the formatting
+ * and console write. When the ring is full the record is dropped and
+ * counted; the drop count is reported when the drain catches up.
+ *
+ * Constraints, enforced at compile time: at most four arguments, each a
+ * 32-bit integer, enum or pointer. Strings must be pointers to literals or
+ * otherwise-stable storage since formatting happens later. Timestamps are
+ * emission time, normally within a few ms of the call.
+ */
+class HotLog {
+public:
+    static HotLog& GetInstance() {
+        static HotLog instance;
+        return instance;
+    }
+
+    template <typename... Args>
+    void Push(esp_log_level_t level, const char* tag, const char* fmt, Args... args) {
+        static_assert(sizeof...(Args) <= 4, "HOT_LOG takes at most 4 arguments");
+        static_assert((ArgOk<Args>::value && ...), "HOT_LOG arguments must be 32-bit integers, enums or pointers");
+        uint32_t a[4] = {};
+        size_t i = 0;
+        ((a[i++] = (uint32_t)(uintptr_t)args), ...);
+        if (!ring_.Push([level, tag, fmt, a0 = a[0], a1 = a[1], a2 = a[2], a3 = a[3]]() {
+                // 多余的实参会被 printf 忽略，只按 fmt 消费
+                ESP_LOG_LEVEL(level, tag, fmt, a0, a1, a2, a3);
+            })) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        NotifyDrainTask();
+    }
+
+private:
+    HotLog() = default;
+    HotLog(const HotLog&) = delete;
+    HotLog& operator=(const HotLog&) = delete;
+
+    template <typename T>
+    struct ArgOk {
+        static constexpr bool value =
+            (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>) && sizeof(T) <= 4;
+    };
+
+    void NotifyDrainTask();
+    void DrainLoop();
+
+    CallableRing<64, 32> ring_;
+    std::atomic<uint32_t> dropped_{0};
+    std::atomic<TaskHandle_t> drain_task_{nullptr};
+    std::atomic<bool> task_starting_{false};
+};
+
+#define HOT_LOGE(tag, fmt, ...) HotLog::GetInstance().Push(ESP_LOG_ERROR, tag, fmt, ##__VA_ARGS__)
+#define HOT_LOGW(tag, fmt, ...) HotLog::GetInstance().Push(ESP_LOG_WARN, tag, fmt, ##__VA_ARGS__)
+#define HOT_LOGI(tag, fmt, ...) HotLog::GetInstance().Push(ESP_LOG_INFO, tag, fmt, ##__VA_ARGS__)
+#define HOT_LOGD(tag, fmt, ...) HotLog::GetInstance().Push(ESP_LOG_DEBUG, tag, fmt, ##__VA_ARGS__)
+
+#endif // HOT_LOG_H
@@ -0,0 +1,112 @@
+#include "json_arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+
+#include <cJSON.h>
+#include <esp_heap_caps.h>
+
+namespace {
+
+constexpr size_t kBlockSize = 4096;
+
+// 当前任务生效的 arena（嵌套时指向最内层）
+thread_local JsonArena* t_current_arena = nullptr;
+
+// 所有活跃 arena 块的地址范围，free 钩子据此判断指针归属。
+// 条目随 4KB 块增删，稳态下只有 0~2 条，线性扫描足够
+std::mutex s_ranges_mutex;
+std::vector<std::pair<uintptr_t, uintptr_t>> s_ranges;
+
+void RegisterRange(void* start, size_t size) {
+    std::lock_guard<std::mutex> lock(s_ranges_mutex);
+    s_ranges.emplace_back(reinterpret_cast<uintptr_t>(start),
+                          reinterpret_cast<uintptr_t>(start) + size);
+}
+
+void UnregisterRange(void* start) {
+    std::lock_guard<std::mutex> lock(s_ranges_mutex);
+    auto it = std::find_if(s_ranges.begin(), s_ranges.end(), [start](const auto& range) {
+        return range.first == reinterpret_cast<uintptr_t>(start);
+    });
+    if (it != s_ranges.end()) {
+        s_ranges.erase(it);
+    }
+}
+
+bool InArenaRange(void* ptr) {
+    std::lock_guard<std::mutex> lock(s_ranges_mutex);
+    auto p = reinterpret_cast<uintptr_t>(ptr);
+    for (const auto& range : s_ranges) {
+        if (p >= range.first && p < range.second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+JsonArena::JsonArena() : prev_(t_current_arena) {
+    t_current_arena = this;
+}
+
+JsonArena::~JsonArena() {
+    t_current_arena = prev_;
+    for (auto& block : blocks_) {
+        UnregisterRange(block.data);
+        heap_caps_free(block.data);
+    }
+}
+
+void* JsonArena::Allocate(size_t size) {
+    size = (size + 7) & ~static_cast<size_t>(7);
+    if (!blocks_.empty()) {
+        Block& block = blocks_.back();
+        if (block.used + size <= block.size) {
+            void* ptr = block.data + block.used;
+            block.used += size;
+            return ptr;
+        }
+    }
+    size_t block_size = std::max(kBlockSize, size);
+    auto data = static_cast<uint8_t*>(
+        heap_caps_malloc(block_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (data == nullptr) {
+        data = static_cast<uint8_t*>(
+            heap_caps_malloc(block_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    }
+    if (data == nullptr) {
+        return nullptr;
+    }
+    RegisterRange(data, block_size);
+    blocks_.push_back({data, block_size, size});
+    return data;
+}
+
+void* JsonArena::HookMalloc(size_t size) {
+    if (t_current_arena != nullptr) {
+        return t_current_arena->Allocate(size);
+    }
+    return malloc(size);
+}
+
+void JsonArena::HookFree(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    // arena 内的指针随块在作用域结束时整体归还
+    if (InArenaRange(ptr)) {
+        return;
+    }
+    free(ptr);
+}
+
+void JsonArena::InstallHooks() {
+    cJSON_Hooks hooks = {
+        .malloc_fn = HookMalloc,
+        .free_fn = HookFree,
+    };
+    cJSON_InitHooks(&hooks);
+}
@@ -0,0 +1,50 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * cJSON 的逐消息 bump 分配器。
+ *
+ * 解析一条 MCP/协议消息会产生几十个十几字节的小节点，逐个 malloc、
+ * 再由 cJSON_Delete 逐个 free，是长时间运行设备上堆碎片的主要来源
+ * 之一。在栈上构造一个 JsonArena 后，当前任务里 cJSON 的所有分配都
+ * 从 4KB 块里顺序切出，free 变成空操作，作用域结束时整块归还——
+ * 解析和释放的分配器开销都是 O(1)。
+ *
+ * cJSON_InitHooks 没有上下文参数，钩子是全局的：没激活 arena 的任务
+ * 走原来的 malloc/free；free 钩子通过全局块表判断指针归属，所以在
+ * 别的任务上释放 arena 作用域外构建的树不受影响。注意不要让 arena
+ * 作用域内 cJSON 分配的指针（节点或 cJSON_Print 的缓冲）逃逸出作用
+ * 域，需要保留的内容先拷贝成 std::string。
+ */
+class JsonArena {
+public:
+    JsonArena();
+    ~JsonArena();
+
+    JsonArena(const JsonArena&) = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+
+    // 启动时调用一次，安装全局 cJSON 分配钩子
+    static void InstallHooks();
+
+private:
+    struct Block {
+        uint8_t* data;
+        size_t size;
+        size_t used;
+    };
+
+    void* Allocate(size_t size);
+
+    static void* HookMalloc(size_t size);
+    static void HookFree(void* ptr);
+
+    std::vector<Block> blocks_;
+    JsonArena* prev_ = nullptr;  // 支持嵌套作用域
+};
+
+#endif // JSON_ARENA_H
@@ -0,0 +1,101 @@
+#include "knob_registry.h"
+#include "settings.h"
+
+#include <esp_log.h>
+
+#include <cstring>
+
+#define TAG "KnobRegistry"
+
+int KnobRegistry::RegisterInt(const char* name, int default_value, int min_value, int max_value,
+                              std::function<void(int value)> apply) {
+    Settings settings("knobs", false);
+    int value = settings.GetInt(name, default_value);
+    if (value < min_value) value = min_value;
+    if (value > max_value) value = max_value;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (knob_count_ >= kMaxKnobs) {
+        ESP_LOGE(TAG, "Knob slots exhausted, '%s' not registered", name);
+        return value;
+    }
+    auto& knob = knobs_[knob_count_++];
+    knob.name = name;
+    knob.value = value;
+    knob.min_value = min_value;
+    knob.max_value = max_value;
+    knob.apply = std::move(apply);
+    if (value != default_value) {
+        ESP_LOGI(TAG, "'%s' overridden to %d (default %d)", name, value, default_value);
+    }
+    return value;
+}
+
+bool KnobRegistry::Set(const std::string& name, int value, std::string& error) {
+    std::function<void(int value)> apply;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Knob* knob = nullptr;
+        for (size_t i = 0; i < knob_count_; i++) {
+            if (name == knobs_[i].name) {
+                knob = &knobs_[i];
+                break;
+            }
+        }
+        if (knob == nullptr) {
+            error = "Unknown knob: " + name;
+            return false;
+        }
+        if (value < knob->min_value || value > knob->max_value) {
+            error = "Value out of range [" + std::to_string(knob->min_value) + ", " +
+                    std::to_string(knob->max_value) + "]";
+            return false;
+        }
+        if (knob->value == value) {
+            return true;
+        }
+        knob->value = value;
+        apply = knob->apply;
+    }
+
+    {
+        Settings settings("knobs", true);
+        settings.SetInt(name, value);
+    }
+    // 不持锁调用，回调可能反过来读注册表
+    if (apply) {
+        apply(value);
+    }
+    ESP_LOGI(TAG, "'%s' set to %d%s", name.c_str(), value, apply ? "" : " (takes effect on next use)");
+    return true;
+}
+
+int KnobRegistry::GetInt(const char* name, int fallback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < knob_count_; i++) {
+        if (strcmp(knobs_[i].name, name) == 0) {
+            return knobs_[i].value;
+        }
+    }
+    return fallback;
+}
+
+std::string KnobRegistry::GetJson() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string json = "{\"knobs\":[";
+    for (size_t i = 0; i < knob_count_; i++) {
+        if (i > 0) {
+            json += ",";
+        }
+        json += "{\"name\":\"";
+        json += knobs_[i].name;
+        json += "\",\"value\":" + std::to_string(knobs_[i].value);
+        json += ",\"min\":" + std::to_string(knobs_[i].min_value);
+        json += ",\"max\":" + std::to_string(knobs_[i].max_value);
+        json += ",\"live\":";
+        json += knobs_[i].apply ? "true" : "false";
+        json += "}";
+    }
+    json += "]}";
+    return json;
+}
@@ -0,0 +1,64 @@
+#ifndef KNOB_REGISTRY_H
+#define KNOB_REGISTRY_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+/**
+ * 机群可调参数注册表。前面各项优化留下了一堆编译期常数（队列深度、
+ * 调速器节奏、码率下限、缓存预算），不同网络/声学环境下最优值不同，
+ * 但为了调一个数发一版固件不现实。子系统把可调参数注册进来，运维侧
+ * 通过 MCP 工具（self.knobs.*）或服务器下推（type:"knobs"）按批次
+ * 改值，改动经 Settings 持久化（NVS 命名空间 "knobs"），带 apply
+ * 回调的参数立即生效，其余下次使用/重启时生效。
+ *
+ * 参数名兼作 NVS 键，必须是 ≤15 字符的字符串字面量。RegisterInt 返回
+ * 生效初值（持久化值优先于默认值），子系统用返回值完成初始化；之后
+ * 的改动经 apply 回调送达，回调在发起修改的任务上执行（MCP 工具任务
+ * 或主循环），需要自带线程安全——原子变量赋值即可满足。
+ */
+class KnobRegistry {
+public:
+    static KnobRegistry& GetInstance() {
+        static KnobRegistry instance;
+        return instance;
+    }
+
+    // 注册整型参数并返回生效初值。apply 为空表示没有热生效路径，
+    // 改动落盘后由消费方下次读取时拿到（见 GetInt）
+    int RegisterInt(const char* name, int default_value, int min_value, int max_value,
+                    std::function<void(int value)> apply = nullptr);
+
+    // 校验范围、持久化并调用 apply；未注册或越界时返回 false 并填充
+    // error（原样送回 MCP 调用方/日志）
+    bool Set(const std::string& name, int value, std::string& error);
+
+    // 拉取式消费方（没有 apply 回调的参数）读当前值
+    int GetInt(const char* name, int fallback);
+
+    // {"knobs":[{"name":...,"value":...,"min":...,"max":...,"live":...}]}
+    std::string GetJson();
+
+private:
+    KnobRegistry() = default;
+    KnobRegistry(const KnobRegistry&) = delete;
+    KnobRegistry& operator=(const KnobRegistry&) = delete;
+
+    static const size_t kMaxKnobs = 16;
+
+    struct Knob {
+        const char* name = nullptr;
+        int value = 0;
+        int min_value = 0;
+        int max_value = 0;
+        std::function<void(int value)> apply;
+    };
+
+    std::mutex mutex_;
+    Knob knobs_[kMaxKnobs];
+    size_t knob_count_ = 0;
+};
+
+#endif // KNOB_REGISTRY_H
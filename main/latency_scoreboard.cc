@@ -0,0 +1,78 @@
+#include "latency_scoreboard.h"
+
+#include <cstdio>
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#define TAG "LatencyBoard"
+
+namespace {
+const char* const kMilestoneNames[] = {
+    "start_listening", "first_uplink_audio", "first_server_json",
+    "first_downlink_audio", "first_playback",
+};
+static_assert(sizeof(kMilestoneNames) / sizeof(kMilestoneNames[0]) ==
+              LatencyScoreboard::kMilestoneCount, "milestone name table out of sync");
+}
+
+void LatencyScoreboard::BeginRound() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    round_start_us_ = esp_timer_get_time();
+    for (auto& marked : marked_) {
+        marked = false;
+    }
+    round_active_.store(true, std::memory_order_relaxed);
+}
+
+void LatencyScoreboard::MarkSlow(Milestone milestone) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!round_active_.load(std::memory_order_relaxed)) {
+        return;  // 拿锁期间被别的里程碑收轮了
+    }
+    int64_t now_us = esp_timer_get_time();
+    if (now_us - round_start_us_ > kRoundTimeoutUs) {
+        // 超时作废：连接失败之类的轮不进统计
+        round_active_.store(false, std::memory_order_relaxed);
+        return;
+    }
+    if (marked_[milestone]) {
+        return;
+    }
+    marked_[milestone] = true;
+    histograms_[milestone].Record(now_us - round_start_us_);
+    if (milestone == kFirstPlayback) {
+        round_active_.store(false, std::memory_order_relaxed);
+        rounds_++;
+    }
+}
+
+std::string LatencyScoreboard::Json() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string json = "{\"rounds\":" + std::to_string(rounds_) + ",\"milestones\":{";
+    for (int i = 0; i < kMilestoneCount; i++) {
+        char entry[96];
+        snprintf(entry, sizeof(entry), "%s\"%s\":{\"count\":%lu,\"p50_ms\":%lu,\"p95_ms\":%lu}",
+                 i > 0 ? "," : "", kMilestoneNames[i],
+                 (unsigned long)histograms_[i].count,
+                 (unsigned long)(histograms_[i].PercentileUs(50) / 1000),
+                 (unsigned long)(histograms_[i].PercentileUs(95) / 1000));
+        json += entry;
+    }
+    json += "}}";
+    return json;
+}
+
+void LatencyScoreboard::DumpIfFresh() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (rounds_ == dumped_rounds_) {
+        return;
+    }
+    dumped_rounds_ = rounds_;
+    ESP_LOGI(TAG, "Rounds: %lu (ms since wake word, p50/p95)", (unsigned long)rounds_);
+    for (int i = 0; i < kMilestoneCount; i++) {
+        ESP_LOGI(TAG, "  %-20s %5lu / %5lu", kMilestoneNames[i],
+                 (unsigned long)(histograms_[i].PercentileUs(50) / 1000),
+                 (unsigned long)(histograms_[i].PercentileUs(95) / 1000));
+    }
+}
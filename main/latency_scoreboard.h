@@ -0,0 +1,74 @@
+#ifndef LATENCY_SCOREBOARD_H
+#define LATENCY_SCOREBOARD_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "audio_service.h"  // LatencyHistogram
+
+/*
+ * 端到端会话时延记分牌："助手反应快不快"的那一个数。
+ *
+ * 以唤醒词命中为零点开一轮，之后五个里程碑各记一次到零点的间隔：
+ * 发出 start listening、第一包上行音频、第一条服务端 JSON、第一包
+ * 下行音频、第一帧真正写进喇叭。首帧播放即收轮。间隔进各自的
+ * LatencyHistogram（与音频流水线共用的 log2 直方图），随时可取 p50/p95。
+ * 超过 30 秒没收轮视为该轮作废（比如连接失败），不污染统计。
+ * 各优化项的验收都看这块牌子：MCP self.get_latency_stats 取 JSON，
+ * 周期调试输出里也会打印新完成轮次后的汇总。
+ */
+class LatencyScoreboard {
+public:
+    enum Milestone {
+        kStartListening,
+        kFirstUplinkAudio,
+        kFirstServerJson,
+        kFirstDownlinkAudio,
+        kFirstPlayback,
+        kMilestoneCount,
+    };
+
+    static LatencyScoreboard& GetInstance() {
+        static LatencyScoreboard instance;
+        return instance;
+    }
+
+    // 唤醒词命中时开一轮（主循环侧）
+    void BeginRound();
+
+    // 各里程碑首次到达时调用；同一轮内重复调用只记第一次。热路径
+    // （每帧播放）也会打进来，轮外只付一次 relaxed load
+    void Mark(Milestone milestone) {
+        if (!round_active_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        MarkSlow(milestone);
+    }
+
+    // 全量统计的紧凑 JSON（MCP 工具用）
+    std::string Json();
+
+    // 有新完成的轮次才打印汇总，否则无输出（周期调试节拍里调用）
+    void DumpIfFresh();
+
+private:
+    LatencyScoreboard() = default;
+    LatencyScoreboard(const LatencyScoreboard&) = delete;
+    LatencyScoreboard& operator=(const LatencyScoreboard&) = delete;
+
+    static constexpr int64_t kRoundTimeoutUs = 30 * 1000000LL;
+
+    void MarkSlow(Milestone milestone);
+
+    std::atomic<bool> round_active_{false};
+    std::mutex mutex_;
+    int64_t round_start_us_ = 0;
+    bool marked_[kMilestoneCount] = {};
+    LatencyHistogram histograms_[kMilestoneCount];
+    uint32_t rounds_ = 0;
+    uint32_t dumped_rounds_ = 0;
+};
+
+#endif // LATENCY_SCOREBOARD_H
@@ -1,11 +1,48 @@
 #include "circular_strip.h"
 #include "application.h"
 #include <esp_log.h>
+#include <soc/soc_caps.h>
 
 #define TAG "CircularStrip"
 
 #define BLINK_INFINITE -1
 
+namespace {
+
+/* 呼吸动画用的感知亮度斜坡：线性相位经 x^2.2 映射后低亮度端不再有
+ * 台阶感，端点 0/255 保持不变，所以稳态颜色与旧实现一致。
+ * x^2.2 = x^2 * x^(1/5)，五次方根用常量表达式牛顿迭代求解 */
+constexpr double Root5(double x) {
+    if (x <= 0.0) {
+        return 0.0;
+    }
+    double r = 1.0;
+    for (int i = 0; i < 40; i++) {
+        r = r - (r * r * r * r * r - x) / (5.0 * r * r * r * r);
+    }
+    return r;
+}
+
+struct GammaRamp {
+    uint8_t value[256];
+};
+
+constexpr GammaRamp BuildGammaRamp() {
+    GammaRamp ramp{};
+    for (int i = 0; i < 256; i++) {
+        double x = i / 255.0;
+        ramp.value[i] = (uint8_t)(x * x * Root5(x) * 255.0 + 0.5);
+    }
+    return ramp;
+}
+
+constexpr GammaRamp kGammaRamp = BuildGammaRamp();
+
+// 呼吸动画半周期的帧数
+constexpr int kBreatheHalfSteps = 32;
+
+}  // namespace
+
 CircularStrip::CircularStrip(gpio_num_t gpio, uint8_t max_leds) : max_leds_(max_leds) {
     // If the gpio is not connected, you should use NoLed class
     assert(gpio != GPIO_NUM_NC);
@@ -20,6 +57,11 @@ CircularStrip::CircularStrip(gpio_num_t gpio, uint8_t max_leds) : max_leds_(max_
 
     led_strip_rmt_config_t rmt_config = {};
     rmt_config.resolution_hz = 10 * 1000 * 1000; // 10MHz
+#if SOC_RMT_SUPPORT_DMA
+    // DMA 通道把符号流的搬运交给硬件，刷新期间 CPU 不再按符号块响应 RMT 中断
+    rmt_config.mem_block_symbols = 1024;
+    rmt_config.flags.with_dma = true;
+#endif
 
     ESP_ERROR_CHECK(led_strip_new_rmt_device(&strip_config, &rmt_config, &led_strip_));
     led_strip_clear(led_strip_);
@@ -28,9 +70,7 @@ CircularStrip::CircularStrip(gpio_num_t gpio, uint8_t max_leds) : max_leds_(max_
         .callback = [](void *arg) {
             auto strip = static_cast<CircularStrip*>(arg);
             std::lock_guard<std::mutex> lock(strip->mutex_);
-            if (strip->strip_callback_ != nullptr) {
-                strip->strip_callback_();
-            }
+            strip->AnimationTick();
         },
         .arg = this,
         .dispatch_method = ESP_TIMER_TASK,
@@ -51,6 +91,7 @@ CircularStrip::~CircularStrip() {
 void CircularStrip::SetAllColor(StripColor color) {
     std::lock_guard<std::mutex> lock(mutex_);
     esp_timer_stop(strip_timer_);
+    animation_.type = AnimationType::kNone;
     for (int i = 0; i < max_leds_; i++) {
         colors_[i] = color;
         led_strip_set_pixel(led_strip_, i, color.red, color.green, color.blue);
@@ -61,118 +102,130 @@ void CircularStrip::SetAllColor(StripColor color) {
 void CircularStrip::SetSingleColor(uint8_t index, StripColor color) {
     std::lock_guard<std::mutex> lock(mutex_);
     esp_timer_stop(strip_timer_);
+    animation_.type = AnimationType::kNone;
     colors_[index] = color;
     led_strip_set_pixel(led_strip_, index, color.red, color.green, color.blue);
     led_strip_refresh(led_strip_);
 }
 
 void CircularStrip::Blink(StripColor color, int interval_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    animation_ = Animation{};
+    animation_.type = AnimationType::kBlink;
+    animation_.high = color;
+    StartAnimation(interval_ms);
+}
+
+void CircularStrip::FadeOut(int interval_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    animation_ = Animation{};
+    animation_.type = AnimationType::kFadeOut;
+    StartAnimation(interval_ms);
+}
+
+void CircularStrip::Breathe(StripColor low, StripColor high, int interval_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    animation_ = Animation{};
+    animation_.type = AnimationType::kBreathe;
+    animation_.low = low;
+    animation_.high = high;
+    StartAnimation(interval_ms);
+}
+
+void CircularStrip::Scroll(StripColor low, StripColor high, int length, int interval_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    animation_ = Animation{};
+    animation_.type = AnimationType::kScroll;
+    animation_.low = low;
+    animation_.high = high;
+    animation_.length = length;
+    StartAnimation(interval_ms);
+}
+
+void CircularStrip::ApplyUniformFrame(StripColor color) {
     for (int i = 0; i < max_leds_; i++) {
         colors_[i] = color;
+        led_strip_set_pixel(led_strip_, i, color.red, color.green, color.blue);
     }
-    StartStripTask(interval_ms, [this]() {
-        static bool on = true;
-        if (on) {
-            for (int i = 0; i < max_leds_; i++) {
-                led_strip_set_pixel(led_strip_, i, colors_[i].red, colors_[i].green, colors_[i].blue);
-            }
-            led_strip_refresh(led_strip_);
-        } else {
-            led_strip_clear(led_strip_);
-        }
-        on = !on;
-    });
+    led_strip_refresh(led_strip_);
 }
 
-void CircularStrip::FadeOut(int interval_ms) {
-    StartStripTask(interval_ms, [this]() {
-        bool all_off = true;
-        for (int i = 0; i < max_leds_; i++) {
-            colors_[i].red /= 2;
-            colors_[i].green /= 2;
-            colors_[i].blue /= 2;
-            if (colors_[i].red != 0 || colors_[i].green != 0 || colors_[i].blue != 0) {
-                all_off = false;
+void CircularStrip::AnimationTick() {
+    switch (animation_.type) {
+        case AnimationType::kBlink:
+            if (animation_.on) {
+                ApplyUniformFrame(animation_.high);
+            } else {
+                led_strip_clear(led_strip_);
             }
-            led_strip_set_pixel(led_strip_, i, colors_[i].red, colors_[i].green, colors_[i].blue);
-        }
-        if (all_off) {
-            led_strip_clear(led_strip_);
-            esp_timer_stop(strip_timer_);
-        } else {
-            led_strip_refresh(led_strip_);
+            animation_.on = !animation_.on;
+            break;
+
+        case AnimationType::kBreathe: {
+            // 三角波相位经 gamma 斜坡映射到插值系数
+            int tri = animation_.phase < kBreatheHalfSteps
+                ? animation_.phase
+                : 2 * kBreatheHalfSteps - animation_.phase;
+            int t = kGammaRamp.value[tri * 255 / kBreatheHalfSteps];
+            StripColor color;
+            color.red = animation_.low.red + (animation_.high.red - animation_.low.red) * t / 255;
+            color.green = animation_.low.green + (animation_.high.green - animation_.low.green) * t / 255;
+            color.blue = animation_.low.blue + (animation_.high.blue - animation_.low.blue) * t / 255;
+            ApplyUniformFrame(color);
+            animation_.phase = (animation_.phase + 1) % (2 * kBreatheHalfSteps);
+            break;
         }
-    });
-}
 
-void CircularStrip::Breathe(StripColor low, StripColor high, int interval_ms) {
-    StartStripTask(interval_ms, [this, low, high]() {
-        static bool increase = true;
-        static StripColor color = low;
-        if (increase) {
-            if (color.red < high.red) {
-                color.red++;
-            }
-            if (color.green < high.green) {
-                color.green++;
-            }
-            if (color.blue < high.blue) {
-                color.blue++;
-            }
-            if (color.red == high.red && color.green == high.green && color.blue == high.blue) {
-                increase = false;
+        case AnimationType::kScroll: {
+            int offset = animation_.phase;
+            for (int i = 0; i < max_leds_; i++) {
+                colors_[i] = animation_.low;
             }
-        } else {
-            if (color.red > low.red) {
-                color.red--;
+            for (int j = 0; j < animation_.length; j++) {
+                int i = (offset + j) % max_leds_;
+                colors_[i] = animation_.high;
             }
-            if (color.green > low.green) {
-                color.green--;
+            for (int i = 0; i < max_leds_; i++) {
+                led_strip_set_pixel(led_strip_, i, colors_[i].red, colors_[i].green, colors_[i].blue);
             }
-            if (color.blue > low.blue) {
-                color.blue--;
+            led_strip_refresh(led_strip_);
+            animation_.phase = (offset + 1) % max_leds_;
+            break;
+        }
+
+        case AnimationType::kFadeOut: {
+            bool all_off = true;
+            for (int i = 0; i < max_leds_; i++) {
+                colors_[i].red /= 2;
+                colors_[i].green /= 2;
+                colors_[i].blue /= 2;
+                if (colors_[i].red != 0 || colors_[i].green != 0 || colors_[i].blue != 0) {
+                    all_off = false;
+                }
+                led_strip_set_pixel(led_strip_, i, colors_[i].red, colors_[i].green, colors_[i].blue);
             }
-            if (color.red == low.red && color.green == low.green && color.blue == low.blue) {
-                increase = true;
+            if (all_off) {
+                led_strip_clear(led_strip_);
+                esp_timer_stop(strip_timer_);
+                animation_.type = AnimationType::kNone;
+            } else {
+                led_strip_refresh(led_strip_);
             }
+            break;
         }
-        for (int i = 0; i < max_leds_; i++) {
-            led_strip_set_pixel(led_strip_, i, color.red, color.green, color.blue);
-        }
-        led_strip_refresh(led_strip_);
-    });
-}
 
-void CircularStrip::Scroll(StripColor low, StripColor high, int length, int interval_ms) {
-    for (int i = 0; i < max_leds_; i++) {
-        colors_[i] = low;
+        case AnimationType::kNone:
+        default:
+            esp_timer_stop(strip_timer_);
+            break;
     }
-    StartStripTask(interval_ms, [this, low, high, length]() {
-        static int offset = 0;
-        for (int i = 0; i < max_leds_; i++) {
-            colors_[i] = low;
-        }
-        for (int j = 0; j < length; j++) {
-            int i = (offset + j) % max_leds_;
-            colors_[i] = high;
-        }
-        for (int i = 0; i < max_leds_; i++) {
-            led_strip_set_pixel(led_strip_, i, colors_[i].red, colors_[i].green, colors_[i].blue);
-        }
-        led_strip_refresh(led_strip_);
-        offset = (offset + 1) % max_leds_;
-    });
 }
 
-void CircularStrip::StartStripTask(int interval_ms, std::function<void()> cb) {
+void CircularStrip::StartAnimation(int interval_ms) {
     if (led_strip_ == nullptr) {
         return;
     }
-
-    std::lock_guard<std::mutex> lock(mutex_);
     esp_timer_stop(strip_timer_);
-    
-    strip_callback_ = cb;
     esp_timer_start_periodic(strip_timer_, interval_ms * 1000);
 }
 
@@ -30,21 +30,38 @@ public:
     void Scroll(StripColor low, StripColor high, int length, int interval_ms);
 
 private:
+    enum class AnimationType {
+        kNone,
+        kBlink,
+        kBreathe,
+        kScroll,
+        kFadeOut,
+    };
+
+    // 声明式动画程序：定时器回调只根据 phase 插值出当前帧，
+    // 不再持有带静态局部变量的闭包（那些状态会在动画之间串台）
+    struct Animation {
+        AnimationType type = AnimationType::kNone;
+        StripColor low;
+        StripColor high;
+        int length = 0;     // Scroll 亮段长度
+        int phase = 0;
+        bool on = true;     // Blink 当前亮/灭
+    };
+
     std::mutex mutex_;
-    TaskHandle_t blink_task_ = nullptr;
     led_strip_handle_t led_strip_ = nullptr;
     int max_leds_ = 0;
     std::vector<StripColor> colors_;
-    int blink_counter_ = 0;
-    int blink_interval_ms_ = 0;
     esp_timer_handle_t strip_timer_ = nullptr;
-    std::function<void()> strip_callback_ = nullptr;
+    Animation animation_;
 
     uint8_t default_brightness_ = DEFAULT_BRIGHTNESS;
     uint8_t low_brightness_ = LOW_BRIGHTNESS;
 
-    void StartStripTask(int interval_ms, std::function<void()> cb);
-    void Rainbow(StripColor low, StripColor high, int interval_ms);
+    void StartAnimation(int interval_ms);
+    void AnimationTick();
+    void ApplyUniformFrame(StripColor color);
     void FadeOut(int interval_ms);
 };
 
@@ -15,11 +15,24 @@
 #include "oled_display.h"
 #include "board.h"
 #include "settings.h"
+#include "boot_profiler.h"
+#include "heap_telemetry.h"
+#include "knob_registry.h"
+#include "task_registry.h"
+#include "tracepoint.h"
+#include "latency_scoreboard.h"
+#include "micro_benchmark.h"
+#include "json_arena.h"
 #include "lvgl_theme.h"
 #include "lvgl_display.h"
+#include "lvgl_render_profiler.h"
+#include "image_decode_service.h"
 
 #define TAG "MCP"
 
+// 工具调用队列上限：场景类会连发 5-10 个调用，超出说明上游失控
+static constexpr size_t kMaxPendingToolCalls = 16;
+
 McpServer::McpServer() {
 }
 
@@ -135,6 +148,113 @@ void McpServer::AddUserOnlyTools() {
             return board.GetSystemInfoJson();
         });
 
+    AddUserOnlyTool("self.get_boot_profile",
+        "Get the boot stage timing breakdown",
+        PropertyList(),
+        [this](const PropertyList& properties) -> ReturnValue {
+            return BootProfiler::GetInstance().GetJson();
+        });
+
+    AddUserOnlyTool("self.get_heap_stats",
+        "Get heap watermarks and per-subsystem allocation accounting",
+        PropertyList(),
+        [this](const PropertyList& properties) -> ReturnValue {
+            return HeapTelemetry::GetInstance().GetJson();
+        });
+
+    AddUserOnlyTool("self.knobs.list",
+        "List the fleet-tunable performance knobs with current values, ranges and "
+        "whether a change applies live or on next use",
+        PropertyList(),
+        [this](const PropertyList& properties) -> ReturnValue {
+            return KnobRegistry::GetInstance().GetJson();
+        });
+
+    AddUserOnlyTool("self.knobs.set",
+        "Set a fleet-tunable performance knob. The value is validated against the "
+        "knob's range, persisted across reboots and applied live when the owning "
+        "subsystem supports it",
+        PropertyList({
+            Property("name", kPropertyTypeString),
+            Property("value", kPropertyTypeInteger)
+        }),
+        [this](const PropertyList& properties) -> ReturnValue {
+            std::string error;
+            if (!KnobRegistry::GetInstance().Set(properties["name"].value<std::string>(),
+                                                 properties["value"].value<int>(), error)) {
+                throw std::runtime_error(error);
+            }
+            return true;
+        });
+
+    AddUserOnlyTool("self.get_latency_stats",
+        "Get end-to-end conversation latency percentiles, measured from wake word "
+        "to each pipeline milestone (start listening, first uplink audio, first "
+        "server response, first downlink audio, first playback)",
+        PropertyList(),
+        [this](const PropertyList& properties) -> ReturnValue {
+            return LatencyScoreboard::GetInstance().Json();
+        });
+
+    AddUserOnlyTool("self.run_benchmark",
+        "Run an on-device micro-benchmark and return timings as JSON. Covers Opus "
+        "encode/decode per complexity, the resampler paths, AES-CTR, base64, JSON "
+        "parsing and internal/PSRAM memcpy. Only runs when the device is idle.",
+        PropertyList({
+            Property("name", kPropertyTypeString, std::string("all"))
+        }),
+        [this](const PropertyList& properties) -> ReturnValue {
+            if (Application::GetInstance().GetDeviceState() != kDeviceStateIdle) {
+                throw std::runtime_error("Device is busy, try again when idle");
+            }
+            return MicroBenchmark::Run(properties["name"].value<std::string>());
+        });
+
+    AddUserOnlyTool("self.run_audio_loopback_test",
+        "Play a chirp through the speaker and measure it back through the microphone; "
+        "reports round-trip latency, loopback gain and THD. Only runs when the device is idle.",
+        PropertyList(),
+        [this](const PropertyList& properties) -> ReturnValue {
+            auto& app = Application::GetInstance();
+            if (app.GetDeviceState() != kDeviceStateIdle) {
+                throw std::runtime_error("Device is busy, try again when idle");
+            }
+            auto result = app.GetAudioService().RunLoopbackTest();
+            if (!result.valid) {
+                throw std::runtime_error("Loopback test failed, see device log");
+            }
+            char buffer[96];
+            snprintf(buffer, sizeof(buffer),
+                "{\"latency_ms\":%d,\"gain_db\":%.1f,\"thd_percent\":%.1f}",
+                result.latency_ms, result.gain_db, result.thd_percent);
+            return std::string(buffer);
+        });
+
+    AddUserOnlyTool("self.capture_trace",
+        "Arm the tracepoint capture window for the given duration and return the "
+        "recorded timeline as base64 (decode with scripts/decode_trace.py)",
+        PropertyList({
+            Property("duration_ms", kPropertyTypeInteger, 1000, 100, 10000)
+        }),
+        [this](const PropertyList& properties) -> ReturnValue {
+            auto& trace = TraceCapture::GetInstance();
+            if (trace.armed()) {
+                throw std::runtime_error("A capture window is already armed");
+            }
+            if (!trace.Arm()) {
+                throw std::runtime_error("No memory for trace buffers");
+            }
+            vTaskDelay(pdMS_TO_TICKS(properties["duration_ms"].value<int>()));
+            return "{\"encoding\":\"base64\",\"data\":\"" + trace.DumpBase64() + "\"}";
+        });
+
+    AddUserOnlyTool("self.get_task_stats",
+        "Get per-task priority, core, stack watermark and CPU usage",
+        PropertyList(),
+        [this](const PropertyList& properties) -> ReturnValue {
+            return TaskRegistry::GetInstance().GetJson();
+        });
+
     AddUserOnlyTool("self.reboot", "Reboot the system",
         PropertyList(),
         [this](const PropertyList& properties) -> ReturnValue {
@@ -188,6 +308,55 @@ void McpServer::AddUserOnlyTools() {
                 return json;
             });
 
+        AddUserOnlyTool("self.screen.profile_render",
+            "Profile LVGL rendering for a while and report per-frame render times, "
+            "flush transfer times, invalidation counts and the most expensive widget "
+            "classes as JSON",
+            PropertyList({
+                Property("duration_ms", kPropertyTypeInteger, 5000, 1000, 30000)
+            }),
+            [display](const PropertyList& properties) -> ReturnValue {
+                auto& profiler = LvglRenderProfiler::GetInstance();
+                {
+                    DisplayLockGuard lock(display);
+                    if (!profiler.Enable()) {
+                        throw std::runtime_error("Render profiler already running");
+                    }
+                }
+                vTaskDelay(pdMS_TO_TICKS(properties["duration_ms"].value<int>()));
+                {
+                    DisplayLockGuard lock(display);
+                    profiler.Disable();
+                }
+                return profiler.Report();
+            });
+
+#if CONFIG_SCREEN_MIRROR
+        AddUserOnlyTool("self.screen.set_mirror",
+            "Start or stop mirroring the screen: dirty rectangles are streamed as "
+            "RLE-compressed binary attachments over the current protocol connection, "
+            "capped at max_kbps with adaptive frame skipping",
+            PropertyList({
+                Property("enabled", kPropertyTypeBoolean),
+                Property("max_kbps", kPropertyTypeInteger, 200, 50, 2000)
+            }),
+            [display](const PropertyList& properties) -> ReturnValue {
+                if (!properties["enabled"].value<bool>()) {
+                    display->StopScreenMirror();
+                    return true;
+                }
+                size_t budget = (size_t)properties["max_kbps"].value<int>() * 1000 / 8;
+                bool ok = display->StartScreenMirror(budget, [](std::string frame) {
+                    // 附件通道不在（断连或对端协议太旧）时返回 false，镜像自动停
+                    return Application::GetInstance().SendMcpAttachment(frame) != 0;
+                });
+                if (!ok) {
+                    throw std::runtime_error("Failed to start screen mirror");
+                }
+                return true;
+            });
+#endif
+
 #if CONFIG_LV_USE_SNAPSHOT
         AddUserOnlyTool("self.screen.snapshot", "Snapshot the screen and upload it to a specific URL",
             PropertyList({
@@ -260,15 +429,12 @@ void McpServer::AddUserOnlyTools() {
                 }
 
                 size_t content_length = http->GetBodyLength();
-                char* data = (char*)heap_caps_malloc(content_length, MALLOC_CAP_8BIT);
-                if (data == nullptr) {
-                    throw std::runtime_error("Failed to allocate memory for image: " + url);
-                }
+                std::string data;
+                data.resize(content_length);
                 size_t total_read = 0;
                 while (total_read < content_length) {
-                    int ret = http->Read(data + total_read, content_length - total_read);
+                    int ret = http->Read(data.data() + total_read, content_length - total_read);
                     if (ret < 0) {
-                        heap_caps_free(data);
                         throw std::runtime_error("Failed to download image: " + url);
                     }
                     if (ret == 0) {
@@ -278,8 +444,15 @@ void McpServer::AddUserOnlyTools() {
                 }
                 http->Close();
 
-                auto image = std::make_unique<LvglAllocatedImage>(data, content_length);
-                display->SetPreviewImage(std::move(image));
+                // 解码丢给解码服务的 UI 车道，别在 MCP 调用的任务上扛
+                // 80~200ms 的 PNG/JPEG 解码
+                ImageDecodeService::GetInstance().Decode(ImageDecodeService::Lane::kUiBlocking,
+                    std::move(data), display->width(), display->height(),
+                    [display](std::unique_ptr<LvglImage> image) {
+                        if (image != nullptr) {
+                            display->SetPreviewImage(std::move(image));
+                        }
+                    });
                 return true;
             });
 #endif // CONFIG_LV_USE_SNAPSHOT
@@ -324,6 +497,10 @@ void McpServer::AddUserOnlyTool(const std::string& name, const std::string& desc
 }
 
 void McpServer::ParseMessage(const std::string& message) {
+    // 整棵解析树和应答构建期间的 cJSON 节点都从 arena 切出，作用域结束整体归还。
+    // 工具调用的参数在 DoToolCall 里已拷贝成 PropertyList，应答也先拷成
+    // std::string 再发送，没有 cJSON 指针逃逸出本作用域
+    JsonArena arena;
     cJSON* json = cJSON_Parse(message.c_str());
     if (json == nullptr) {
         ESP_LOGE(TAG, "Failed to parse MCP message: %s", message.c_str());
@@ -353,6 +530,19 @@ void McpServer::ParseCapabilities(const cJSON* capabilities) {
 }
 
 void McpServer::ParseMessage(const cJSON* json) {
+    // JSON-RPC 2.0 批量请求：场景类客户端把一组 tools/call 打包成一个
+    // 数组，一条消息内按序派发（工具在 mcp_tool 队列里背靠背执行），
+    // 省掉逐条消息的协议往返；应答仍按单条回复
+    if (cJSON_IsArray(json)) {
+        const cJSON* item = nullptr;
+        cJSON_ArrayForEach(item, json) {
+            if (cJSON_IsObject(item)) {
+                ParseMessage(item);
+            }
+        }
+        return;
+    }
+
     // Check JSONRPC version
     auto version = cJSON_GetObjectItem(json, "jsonrpc");
     if (version == nullptr || !cJSON_IsString(version) || strcmp(version->valuestring, "2.0") != 0) {
@@ -437,8 +627,27 @@ void McpServer::ParseMessage(const cJSON* json) {
     }
 }
 
+std::string SerializeImageContent(const ImageContent& image) {
+    uint32_t attachment_id = Application::GetInstance().SendMcpAttachment(image.data());
+    if (attachment_id == 0) {
+        // 没有二进制通道（如 MQTT），退回内联 base64
+        return image.to_json();
+    }
+    cJSON* json = cJSON_CreateObject();
+    cJSON_AddStringToObject(json, "type", "image");
+    cJSON_AddStringToObject(json, "mimeType", image.mime_type().c_str());
+    cJSON_AddNumberToObject(json, "attachment", attachment_id);
+    char* json_str = cJSON_PrintUnformatted(json);
+    std::string result(json_str);
+    cJSON_free(json_str);
+    cJSON_Delete(json);
+    return result;
+}
+
 void McpServer::ReplyResult(int id, const std::string& result) {
-    std::string payload = "{\"jsonrpc\":\"2.0\",\"id\":";
+    std::string payload;
+    payload.reserve(result.size() + 48);
+    payload += "{\"jsonrpc\":\"2.0\",\"id\":";
     payload += std::to_string(id) + ",\"result\":";
     payload += result;
     payload += "}";
@@ -456,8 +665,10 @@ void McpServer::ReplyError(int id, const std::string& message) {
 
 void McpServer::GetToolsList(int id, const std::string& cursor, bool list_user_only_tools) {
     const int max_payload_size = 8000;
-    std::string json = "{\"tools\":[";
-    
+    std::string json;
+    json.reserve(max_payload_size);
+    json += "{\"tools\":[";
+
     bool found_cursor = cursor.empty();
     auto it = tools_.begin();
     std::string next_cursor = "";
@@ -478,8 +689,10 @@ void McpServer::GetToolsList(int id, const std::string& cursor, bool list_user_o
             continue;
         }
         
-        // 添加tool前检查大小
-        std::string tool_json = (*it)->to_json() + ",";
+        // 添加tool前检查大小（序列化结果按工具缓存在 PSRAM，重建列表不再走 cJSON）
+        const char* cached = (*it)->cached_json();
+        std::string tool_json = cached != nullptr ? std::string(cached) : (*it)->to_json();
+        tool_json += ",";
         if (json.length() + tool_json.length() + 30 > max_payload_size) {
             // 如果添加这个tool会超出大小限制，设置next_cursor并退出循环
             next_cursor = (*it)->name();
@@ -552,14 +765,63 @@ void McpServer::DoToolCall(int id, const std::string& tool_name, const cJSON* to
         return;
     }
 
-    // Use main thread to call the tool
-    auto& app = Application::GetInstance();
-    app.Schedule([this, id, tool_iter, arguments = std::move(arguments)]() {
+    auto job = [this, id, tool_iter, arguments = std::move(arguments)]() {
         try {
             ReplyResult(id, (*tool_iter)->Call(arguments));
         } catch (const std::exception& e) {
             ESP_LOGE(TAG, "tools/call: %s", e.what());
             ReplyError(id, e.what());
         }
-    });
+    };
+
+    // 工具在常驻 worker 上执行：拍照、HTTP 这类慢工具不再卡住主循环。
+    // worker 创建失败（栈分配不到）时退回主循环执行
+    EnsureToolWorker();
+    if (tool_task_ == nullptr) {
+        Application::GetInstance().Schedule(std::move(job));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(tool_queue_mutex_);
+        if (tool_queue_.size() >= kMaxPendingToolCalls) {
+            ESP_LOGE(TAG, "tools/call: Too many pending tool calls");
+            ReplyError(id, "Too many pending tool calls");
+            return;
+        }
+        tool_queue_.emplace_back(std::move(job));
+    }
+    xTaskNotifyGive(tool_task_);
+}
+
+void McpServer::EnsureToolWorker() {
+    if (tool_task_ != nullptr) {
+        return;
+    }
+    auto& task_registry = TaskRegistry::GetInstance();
+    int core = task_registry.ResolveCore("mcp_tool", -1);
+    tool_task_ = tool_task_buffer_.Create([](void* arg) {
+        static_cast<McpServer*>(arg)->ToolWorkerLoop();
+    }, "mcp_tool", 8192, this, 3, core);
+    if (tool_task_ != nullptr) {
+        task_registry.Register(tool_task_, "mcp_tool", 3, core);
+    }
+}
+
+void McpServer::ToolWorkerLoop() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (true) {
+            std::function<void()> job;
+            {
+                std::lock_guard<std::mutex> lock(tool_queue_mutex_);
+                if (tool_queue_.empty()) {
+                    break;
+                }
+                job = std::move(tool_queue_.front());
+                tool_queue_.pop_front();
+            }
+            job();
+        }
+    }
 }
@@ -9,43 +9,113 @@
 #include <optional>
 #include <stdexcept>
 #include <thread>
-#include <mbedtls/base64.h>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <cstdint>
+#include <cstdio>
 
 #include <cJSON.h>
+#include <esp_heap_caps.h>
+
+#include "static_task.h"
+
+// 把 value 按 JSON 字符串语义转义后追加到 out，单遍、无中间副本。
+// 大负载（内嵌图片 JSON）靠它绕开 cJSON 的整包转义打印
+inline void AppendJsonEscaped(std::string& out, const std::string& value) {
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += (char)c;
+                }
+                break;
+        }
+    }
+}
 
 class ImageContent {
 private:
-    std::string encoded_data_;
+    // Raw bytes are kept as-is; base64 happens lazily and only on the
+    // fallback path, so transports with a binary channel never pay the
+    // 33% expansion or the extra copies
+    std::string data_;
     std::string mime_type_;
 
-    static std::string Base64Encode(const std::string& data) {
-        size_t dlen = 0, olen = 0;
-        mbedtls_base64_encode((unsigned char*)nullptr, 0, &dlen, (const unsigned char*)data.data(), data.size());
-        std::string result(dlen, 0);
-        mbedtls_base64_encode((unsigned char*)result.data(), result.size(), &olen, (const unsigned char*)data.data(), data.size());
-        return result;
+    // Streaming table-driven encoder: 3-byte groups go straight into the
+    // outbound string, which is reserved to its exact final size up front,
+    // so the only full-size buffer is the message itself
+    static void AppendBase64(std::string& out, const std::string& data) {
+        static const char kTable[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        const unsigned char* p = (const unsigned char*)data.data();
+        size_t n = data.size();
+        size_t i = 0;
+        char quad[4];
+        for (; i + 3 <= n; i += 3) {
+            uint32_t v = (uint32_t)p[i] << 16 | (uint32_t)p[i + 1] << 8 | p[i + 2];
+            quad[0] = kTable[(v >> 18) & 63];
+            quad[1] = kTable[(v >> 12) & 63];
+            quad[2] = kTable[(v >> 6) & 63];
+            quad[3] = kTable[v & 63];
+            out.append(quad, 4);
+        }
+        if (i < n) {
+            uint32_t v = (uint32_t)p[i] << 16;
+            if (i + 1 < n) {
+                v |= (uint32_t)p[i + 1] << 8;
+            }
+            quad[0] = kTable[(v >> 18) & 63];
+            quad[1] = kTable[(v >> 12) & 63];
+            quad[2] = (i + 1 < n) ? kTable[(v >> 6) & 63] : '=';
+            quad[3] = '=';
+            out.append(quad, 4);
+        }
     }
 
 public:
     ImageContent(const std::string& mime_type, const std::string& data) {
         mime_type_ = mime_type;
-        // base64 encode data
-        encoded_data_ = Base64Encode(data);
+        data_ = data;
     }
 
+    const std::string& mime_type() const { return mime_type_; }
+    const std::string& data() const { return data_; }
+
     std::string to_json() const {
-        cJSON *json = cJSON_CreateObject();
-        cJSON_AddStringToObject(json, "type", "image");
-        cJSON_AddStringToObject(json, "mimeType", mime_type_.c_str());
-        cJSON_AddStringToObject(json, "data", encoded_data_.c_str());
-        char* json_str = cJSON_PrintUnformatted(json);
-        std::string result(json_str);
-        cJSON_free(json_str);
-        cJSON_Delete(json);
-        return result;
+        // 手写 JSON：base64 输出不含需要转义的字符，mime type 是受控常量，
+        // 不必为它们经过 cJSON 树（strdup 一份）加打印缓冲（再一份）
+        std::string json;
+        json.reserve(mime_type_.size() + (data_.size() + 2) / 3 * 4 + 48);
+        json += R"({"type":"image","mimeType":")";
+        json += mime_type_;
+        json += R"(","data":")";
+        AppendBase64(json, data_);
+        json += R"("})";
+        return json;
     }
 };
 
+/*
+ * Serializes an image tool result. When the active protocol has a binary
+ * attachment channel, the raw bytes go out-of-band and the JSON only carries
+ * the attachment id; otherwise this falls back to to_json() with inline
+ * base64 (e.g. on MQTT). Defined in mcp_server.cc to keep application.h out
+ * of this header.
+ */
+std::string SerializeImageContent(const ImageContent& image);
+
 // 添加类型别名
 using ReturnValue = std::variant<bool, int, std::string, cJSON*, ImageContent*>;
 
@@ -212,6 +282,7 @@ private:
     PropertyList properties_;
     std::function<ReturnValue(const PropertyList&)> callback_;
     bool user_only_ = false;
+    mutable char* cached_json_ = nullptr;
 
 public:
     McpTool(const std::string& name, 
@@ -220,9 +291,15 @@ public:
             std::function<ReturnValue(const PropertyList&)> callback)
         : name_(name), 
         description_(description), 
-        properties_(properties), 
+        properties_(properties),
         callback_(callback) {}
 
+    ~McpTool() {
+        if (cached_json_ != nullptr) {
+            heap_caps_free(cached_json_);
+        }
+    }
+
     void set_user_only(bool user_only) { user_only_ = user_only; }
     inline const std::string& name() const { return name_; }
     inline const std::string& description() const { return description_; }
@@ -269,37 +346,61 @@ public:
         return result;
     }
 
+    // tools/list 的每一页都要用到序列化结果，首次生成后缓存到 PSRAM
+    //（无 PSRAM 的板子退回内部 RAM）。工具定义注册之后不会再变，缓存
+    // 无需失效；分配失败时返回 nullptr，调用方退回临时 to_json()。
+    const char* cached_json() const {
+        if (cached_json_ == nullptr) {
+            std::string json = to_json();
+            uint32_t caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+            if (heap_caps_get_total_size(MALLOC_CAP_SPIRAM) == 0) {
+                caps = MALLOC_CAP_8BIT;
+            }
+            cached_json_ = (char*)heap_caps_malloc(json.size() + 1, caps);
+            if (cached_json_ == nullptr) {
+                return nullptr;
+            }
+            memcpy(cached_json_, json.c_str(), json.size() + 1);
+        }
+        return cached_json_;
+    }
+
     std::string Call(const PropertyList& properties) {
         ReturnValue return_value = callback_(properties);
         // 返回结果
-        cJSON* result = cJSON_CreateObject();
-        cJSON* content = cJSON_CreateArray();
-
         if (std::holds_alternative<ImageContent*>(return_value)) {
+            // 图片分支手工拼接信封：几百 KB 的序列化结果不进 cJSON 树，
+            // 也不再被 PrintUnformatted 整包转义一遍
             auto image_content = std::get<ImageContent*>(return_value);
-            cJSON* image = cJSON_CreateObject();
-            cJSON_AddStringToObject(image, "type", "image");
-            cJSON_AddStringToObject(image, "image", image_content->to_json().c_str());
-            cJSON_AddItemToArray(content, image);
+            std::string serialized = SerializeImageContent(*image_content);
             delete image_content;
-        } else {
-            cJSON* text = cJSON_CreateObject();
-            cJSON_AddStringToObject(text, "type", "text");
-            if (std::holds_alternative<std::string>(return_value)) {
-                cJSON_AddStringToObject(text, "text", std::get<std::string>(return_value).c_str());
-            } else if (std::holds_alternative<bool>(return_value)) {
-                cJSON_AddStringToObject(text, "text", std::get<bool>(return_value) ? "true" : "false");
-            } else if (std::holds_alternative<int>(return_value)) {
-                cJSON_AddStringToObject(text, "text", std::to_string(std::get<int>(return_value)).c_str());
-            } else if (std::holds_alternative<cJSON*>(return_value)) {
-                cJSON* json = std::get<cJSON*>(return_value);
-                char* json_str = cJSON_PrintUnformatted(json);
-                cJSON_AddStringToObject(text, "text", json_str);
-                cJSON_free(json_str);
-                cJSON_Delete(json);
-            }
-            cJSON_AddItemToArray(content, text);
+            std::string result_str;
+            result_str.reserve(serialized.size() + serialized.size() / 16 + 64);
+            result_str += R"({"content":[{"type":"image","image":")";
+            AppendJsonEscaped(result_str, serialized);
+            result_str += R"("}],"isError":false})";
+            return result_str;
         }
+
+        cJSON* result = cJSON_CreateObject();
+        cJSON* content = cJSON_CreateArray();
+
+        cJSON* text = cJSON_CreateObject();
+        cJSON_AddStringToObject(text, "type", "text");
+        if (std::holds_alternative<std::string>(return_value)) {
+            cJSON_AddStringToObject(text, "text", std::get<std::string>(return_value).c_str());
+        } else if (std::holds_alternative<bool>(return_value)) {
+            cJSON_AddStringToObject(text, "text", std::get<bool>(return_value) ? "true" : "false");
+        } else if (std::holds_alternative<int>(return_value)) {
+            cJSON_AddStringToObject(text, "text", std::to_string(std::get<int>(return_value)).c_str());
+        } else if (std::holds_alternative<cJSON*>(return_value)) {
+            cJSON* json = std::get<cJSON*>(return_value);
+            char* json_str = cJSON_PrintUnformatted(json);
+            cJSON_AddStringToObject(text, "text", json_str);
+            cJSON_free(json_str);
+            cJSON_Delete(json);
+        }
+        cJSON_AddItemToArray(content, text);
         cJSON_AddItemToObject(result, "content", content);
         cJSON_AddBoolToObject(result, "isError", false);
 
@@ -338,7 +439,16 @@ private:
     void GetToolsList(int id, const std::string& cursor, bool list_user_only_tools);
     void DoToolCall(int id, const std::string& tool_name, const cJSON* tool_arguments);
 
+    // 工具调用在常驻 worker 任务上执行（栈在 PSRAM），慢工具不再拖住
+    // 主循环；队列有界，场景类连发的调用排队而不是丢弃
+    void EnsureToolWorker();
+    void ToolWorkerLoop();
+
     std::vector<McpTool*> tools_;
+    StaticTaskBuffer tool_task_buffer_;
+    TaskHandle_t tool_task_ = nullptr;
+    std::mutex tool_queue_mutex_;
+    std::deque<std::function<void()>> tool_queue_;
 };
 
 #endif // MCP_SERVER_H
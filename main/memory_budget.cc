@@ -0,0 +1,122 @@
+#include "memory_budget.h"
+#include "heap_telemetry.h"
+
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+
+#include <algorithm>
+
+#define TAG "MemoryBudget"
+
+void MemoryBudget::RegisterPool(const char* name, Priority priority,
+                                std::function<size_t(size_t wanted)> handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pool_count_ >= kMaxPools) {
+        ESP_LOGE(TAG, "Pool slots exhausted, '%s' not registered", name);
+        return;
+    }
+    pools_[pool_count_].name = name;
+    pools_[pool_count_].priority = priority;
+    pools_[pool_count_].handler = std::move(handler);
+    pool_count_++;
+
+    // 等级内按注册顺序稳定，回收从最低等级开始
+    std::stable_sort(pools_, pools_ + pool_count_, [](const Pool& a, const Pool& b) {
+        return a.priority < b.priority;
+    });
+
+    if (!telemetry_bridge_registered_) {
+        telemetry_bridge_registered_ = true;
+        HeapTelemetry::GetInstance().RegisterMitigation("budget_pools", []() {
+            return MemoryBudget::GetInstance().ReclaimAll();
+        });
+    }
+}
+
+void* MemoryBudget::Alloc(const char* tag, size_t bytes, uint32_t caps, Priority priority) {
+    void* ptr = heap_caps_malloc(bytes, caps);
+    if (ptr != nullptr) {
+        return ptr;
+    }
+
+    size_t freed = Reclaim(bytes, priority);
+    if (freed > 0) {
+        ptr = heap_caps_malloc(bytes, caps);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ptr != nullptr) {
+        rescued_allocs_++;
+        ESP_LOGW(TAG, "'%s' alloc of %u bytes rescued by reclaiming %u bytes",
+                 tag, (unsigned)bytes, (unsigned)freed);
+    } else {
+        denied_allocs_++;
+        ESP_LOGE(TAG, "'%s' alloc of %u bytes denied (reclaimed %u bytes, caps 0x%lx)",
+                 tag, (unsigned)bytes, (unsigned)freed, (unsigned long)caps);
+    }
+    return ptr;
+}
+
+size_t MemoryBudget::Reclaim(size_t wanted, Priority requester) {
+    size_t freed = 0;
+    // 处理器可能自己再进分配器，不持锁调用；池子只增不删，按索引
+    // 访问是安全的
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        count = pool_count_;
+    }
+    for (size_t i = 0; i < count && freed < wanted; i++) {
+        if (pools_[i].priority >= requester) {
+            break;
+        }
+        size_t pool_freed = pools_[i].handler(wanted - freed);
+        if (pool_freed > 0) {
+            freed += pool_freed;
+            std::lock_guard<std::mutex> lock(mutex_);
+            pools_[i].reclaims++;
+            pools_[i].reclaimed_bytes += pool_freed;
+            ESP_LOGW(TAG, "Reclaimed %u bytes from '%s'", (unsigned)pool_freed, pools_[i].name);
+        }
+    }
+    return freed;
+}
+
+size_t MemoryBudget::ReclaimAll() {
+    size_t freed = 0;
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        count = pool_count_;
+    }
+    for (size_t i = 0; i < count; i++) {
+        size_t pool_freed = pools_[i].handler(SIZE_MAX);
+        if (pool_freed > 0) {
+            freed += pool_freed;
+            std::lock_guard<std::mutex> lock(mutex_);
+            pools_[i].reclaims++;
+            pools_[i].reclaimed_bytes += pool_freed;
+        }
+    }
+    return freed;
+}
+
+void MemoryBudget::Dump() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t events = rescued_allocs_ + denied_allocs_;
+    for (size_t i = 0; i < pool_count_; i++) {
+        events += pools_[i].reclaims;
+    }
+    if (events == dumped_events_) {
+        return;
+    }
+    dumped_events_ = events;
+    ESP_LOGI(TAG, "Rescued %lu allocs, denied %lu:", (unsigned long)rescued_allocs_,
+             (unsigned long)denied_allocs_);
+    for (size_t i = 0; i < pool_count_; i++) {
+        if (pools_[i].reclaims > 0) {
+            ESP_LOGI(TAG, "  %s: %lu reclaims, %u bytes", pools_[i].name,
+                     (unsigned long)pools_[i].reclaims, (unsigned)pools_[i].reclaimed_bytes);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+/**
+ * 会话级内存预算管理。相机抓帧、图片深解码、各类缓存、TLS 各自独立
+ * 向堆要内存，失败模式是"谁最后分配谁倒霉"，倒霉的经常是音频路径。
+ * 这里把可回收的内存池按保护等级注册进来（缓存 < 预览图 < 解码队列 <
+ * 活跃音频），高等级的分配失败时同步回收所有更低等级的池子再重试一次，
+ * 随机 OOM 变成有迹可查的缓存淘汰。
+ *
+ * 回收处理器在发起分配的任务上同步执行，注册方必须保证跨任务安全
+ * （提示音缓存、描画缓冲、解码缓冲池都有自己的锁）。碎片化告警路径
+ * 复用同一批池子：首次注册时向 HeapTelemetry 挂一个聚合缓解动作，
+ * 告警时按等级从低到高全量回收。
+ *
+ * 活跃音频等级目前只作为请求方等级存在（音频的大块内存都在初始化时
+ * 分好），它的意义是音频路径将来任何运行期分配都能挤掉下面三层。
+ */
+class MemoryBudget {
+public:
+    static MemoryBudget& GetInstance() {
+        static MemoryBudget instance;
+        return instance;
+    }
+
+    // 保护等级，数值越大越后被回收；回收只动严格低于请求方的池子
+    enum Priority {
+        kReclaimCaches = 0,   // 提示音缓存、主题资源缓存
+        kReclaimPreview,      // 预览图、相机帧副本、弹性描画缓冲
+        kReclaimDecode,       // 图片解码缓冲池
+        kReclaimAudio,        // 活跃音频（只作请求方等级）
+    };
+
+    // name 必须是字符串字面量。handler 收到期望释放的字节数（尽力
+    // 而为，可以少给也可以全清），返回实际释放的字节数；在任意任务
+    // 上同步调用，必须自带线程安全
+    void RegisterPool(const char* name, Priority priority, std::function<size_t(size_t wanted)> handler);
+
+    // heap_caps_malloc 的预算版：失败时回收低于 priority 的池子后重试
+    // 一次。返回的指针仍用 heap_caps_free 释放
+    void* Alloc(const char* tag, size_t bytes, uint32_t caps, Priority priority);
+
+    // 同步回收严格低于 requester 的池子，按等级从低到高，凑够 wanted
+    // 字节即停；返回实际释放的字节数。分配接口之外也可直接调用
+    // （比如对齐分配失败后自救）
+    size_t Reclaim(size_t wanted, Priority requester);
+
+    // 全量回收所有池子（碎片化告警路径）
+    size_t ReclaimAll();
+
+    // 10 秒调试节拍里调用；没有新的回收/拒绝记录时保持安静
+    void Dump();
+
+private:
+    MemoryBudget() = default;
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    static const size_t kMaxPools = 8;
+
+    struct Pool {
+        const char* name = nullptr;
+        Priority priority = kReclaimCaches;
+        std::function<size_t(size_t wanted)> handler;
+        uint32_t reclaims = 0;
+        size_t reclaimed_bytes = 0;
+    };
+
+    std::mutex mutex_;
+    Pool pools_[kMaxPools];
+    size_t pool_count_ = 0;
+    bool telemetry_bridge_registered_ = false;
+    // 回收后重试成功/仍然失败的分配计数（遥测轨迹）
+    uint32_t rescued_allocs_ = 0;
+    uint32_t denied_allocs_ = 0;
+    uint32_t dumped_events_ = 0;
+};
+
+#endif // MEMORY_BUDGET_H
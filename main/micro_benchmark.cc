@@ -0,0 +1,220 @@
+#include "micro_benchmark.h"
+#include "system_info.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <cJSON.h>
+#include <esp_chip_info.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <mbedtls/aes.h>
+#include <mbedtls/base64.h>
+
+#include <opus_encoder.h>
+#include <opus_decoder.h>
+
+#include "audio_service.h"  // OPUS_FRAME_DURATION_MS
+#include "fir_resampler.h"
+
+#define TAG "MicroBench"
+
+namespace {
+
+// 吞吐类基准的工作集：比 L1/L2 大、比 PSRAM 带宽测试该有的样子小，
+// 单项控制在百毫秒级，整套 all 跑完不过几秒
+constexpr size_t kBufferSize = 32 * 1024;
+constexpr int kThroughputReps = 32;
+
+std::vector<int16_t> MakeChirp(size_t samples) {
+    std::vector<int16_t> pcm(samples);
+    for (size_t i = 0; i < samples; i++) {
+        float t = (float)i / 16000.0f;
+        pcm[i] = (int16_t)(8000.0f * sinf(2.0f * M_PI * (200.0f + 600.0f * t) * t));
+    }
+    return pcm;
+}
+
+void AppendEntry(std::string& json, const char* name, const char* metric, double value) {
+    char entry[96];
+    snprintf(entry, sizeof(entry), "%s{\"name\":\"%s\",\"%s\":%.1f}",
+             json.empty() ? "" : ",", name, metric, value);
+    json += entry;
+}
+
+double ThroughputMbps(size_t bytes_per_rep, int reps, int64_t elapsed_us) {
+    if (elapsed_us <= 0) {
+        return 0.0;
+    }
+    return (double)bytes_per_rep * reps / elapsed_us;  // bytes/us == MB/s
+}
+
+void BenchOpus(std::string& json) {
+    const int kFrames = 20;
+    const size_t frame_samples = 16000 * OPUS_FRAME_DURATION_MS / 1000;
+    auto pcm = MakeChirp(frame_samples * kFrames);
+
+    // 编码按复杂度分档：机群数据能看出换档的真实成本
+    static const int kComplexities[] = { 0, 3, 5 };
+    std::vector<std::vector<uint8_t>> packets;
+    for (int complexity : kComplexities) {
+        auto encoder = std::make_unique<OpusEncoderWrapper>(16000, 1, OPUS_FRAME_DURATION_MS);
+        encoder->SetComplexity(complexity);
+        packets.clear();
+        int64_t start_us = esp_timer_get_time();
+        for (int i = 0; i < kFrames; i++) {
+            std::vector<int16_t> frame(pcm.begin() + i * frame_samples,
+                                       pcm.begin() + (i + 1) * frame_samples);
+            std::vector<uint8_t> opus;
+            encoder->Encode(std::move(frame), opus);
+            packets.emplace_back(std::move(opus));
+        }
+        int64_t elapsed_us = esp_timer_get_time() - start_us;
+        char name[32];
+        snprintf(name, sizeof(name), "opus_encode_c%d", complexity);
+        AppendEntry(json, name, "us_per_frame", (double)elapsed_us / kFrames);
+    }
+
+    auto decoder = std::make_unique<OpusDecoderWrapper>(16000, 1, OPUS_FRAME_DURATION_MS);
+    int64_t start_us = esp_timer_get_time();
+    for (auto& packet : packets) {
+        std::vector<int16_t> out;
+        decoder->Decode(std::move(packet), out);
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    AppendEntry(json, "opus_decode", "us_per_frame", (double)elapsed_us / kFrames);
+}
+
+void BenchResampler(std::string& json) {
+    // 服务实际配置的两条下行路径
+    static const int kInputRates[] = { 24000, 48000 };
+    for (int input_rate : kInputRates) {
+        const int kFrames = 50;
+        const size_t frame_samples = input_rate * OPUS_FRAME_DURATION_MS / 1000;
+        auto pcm = MakeChirp(frame_samples);
+        FirResampler resampler;
+        resampler.Configure(input_rate, 16000);
+        std::vector<int16_t> out(resampler.GetOutputSamples(frame_samples));
+        int64_t start_us = esp_timer_get_time();
+        for (int i = 0; i < kFrames; i++) {
+            resampler.Process(pcm.data(), frame_samples, out.data());
+        }
+        int64_t elapsed_us = esp_timer_get_time() - start_us;
+        char name[32];
+        snprintf(name, sizeof(name), "resample_%dk_16k", input_rate / 1000);
+        AppendEntry(json, name, "us_per_frame", (double)elapsed_us / kFrames);
+    }
+}
+
+void BenchAes(std::string& json) {
+    std::vector<uint8_t> buffer(kBufferSize, 0xA5);
+    std::vector<uint8_t> out(kBufferSize);
+    mbedtls_aes_context ctx;
+    mbedtls_aes_init(&ctx);
+    const uint8_t key[16] = { 0x13, 0x57, 0x9b, 0xdf };
+    mbedtls_aes_setkey_enc(&ctx, key, 128);
+    uint8_t nonce[16] = {};
+    uint8_t stream_block[16] = {};
+    size_t nc_off = 0;
+    int64_t start_us = esp_timer_get_time();
+    for (int i = 0; i < kThroughputReps; i++) {
+        mbedtls_aes_crypt_ctr(&ctx, kBufferSize, &nc_off, nonce, stream_block,
+                              buffer.data(), out.data());
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    mbedtls_aes_free(&ctx);
+    AppendEntry(json, "aes_ctr", "mbps", ThroughputMbps(kBufferSize, kThroughputReps, elapsed_us));
+}
+
+void BenchBase64(std::string& json) {
+    std::vector<uint8_t> buffer(kBufferSize, 0xA5);
+    std::vector<uint8_t> out((kBufferSize / 3 + 1) * 4 + 4);
+    size_t out_len = 0;
+    int64_t start_us = esp_timer_get_time();
+    for (int i = 0; i < kThroughputReps; i++) {
+        mbedtls_base64_encode(out.data(), out.size(), &out_len, buffer.data(), kBufferSize);
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    AppendEntry(json, "base64_encode", "mbps", ThroughputMbps(kBufferSize, kThroughputReps, elapsed_us));
+}
+
+void BenchJson(std::string& json) {
+    // 服务端下行消息的典型形态
+    static const char kCannedMessage[] =
+        "{\"session_id\":\"a1b2c3d4\",\"type\":\"tts\",\"state\":\"sentence_start\","
+        "\"text\":\"今天天气不错，适合出去走走。\",\"audio_params\":{\"format\":\"opus\","
+        "\"sample_rate\":24000,\"channels\":1,\"frame_duration\":60}}";
+    const int kReps = 500;
+    int64_t start_us = esp_timer_get_time();
+    for (int i = 0; i < kReps; i++) {
+        cJSON* root = cJSON_Parse(kCannedMessage);
+        cJSON_Delete(root);
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    AppendEntry(json, "json_parse", "us_per_msg", (double)elapsed_us / kReps);
+}
+
+void BenchMemcpyPair(std::string& json, const char* name, void* dst, const void* src) {
+    int64_t start_us = esp_timer_get_time();
+    for (int i = 0; i < kThroughputReps; i++) {
+        memcpy(dst, src, kBufferSize);
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    AppendEntry(json, name, "mbps", ThroughputMbps(kBufferSize, kThroughputReps, elapsed_us));
+}
+
+void BenchMemcpy(std::string& json) {
+    void* internal_a = heap_caps_malloc(kBufferSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    void* internal_b = heap_caps_malloc(kBufferSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (internal_a == nullptr || internal_b == nullptr) {
+        heap_caps_free(internal_a);
+        heap_caps_free(internal_b);
+        throw std::runtime_error("Not enough internal heap for memcpy benchmark");
+    }
+    memset(internal_a, 0xA5, kBufferSize);
+    BenchMemcpyPair(json, "memcpy_int_int", internal_b, internal_a);
+
+    // PSRAM 时序慢的批次在这三项上现原形；无 PSRAM 的板子只报内部项
+    void* spiram_a = heap_caps_malloc(kBufferSize, MALLOC_CAP_SPIRAM);
+    void* spiram_b = heap_caps_malloc(kBufferSize, MALLOC_CAP_SPIRAM);
+    if (spiram_a != nullptr && spiram_b != nullptr) {
+        memset(spiram_a, 0x5A, kBufferSize);
+        BenchMemcpyPair(json, "memcpy_int_psram", spiram_a, internal_a);
+        BenchMemcpyPair(json, "memcpy_psram_int", internal_b, spiram_a);
+        BenchMemcpyPair(json, "memcpy_psram_psram", spiram_b, spiram_a);
+    }
+    heap_caps_free(spiram_a);
+    heap_caps_free(spiram_b);
+    heap_caps_free(internal_a);
+    heap_caps_free(internal_b);
+}
+
+}  // namespace
+
+std::string MicroBenchmark::Run(const std::string& name) {
+    std::string results;
+    bool all = (name == "all");
+    bool matched = false;
+
+    if (all || name == "opus") { BenchOpus(results); matched = true; }
+    if (all || name == "resampler") { BenchResampler(results); matched = true; }
+    if (all || name == "aes") { BenchAes(results); matched = true; }
+    if (all || name == "base64") { BenchBase64(results); matched = true; }
+    if (all || name == "json") { BenchJson(results); matched = true; }
+    if (all || name == "memcpy") { BenchMemcpy(results); matched = true; }
+    if (!matched) {
+        throw std::runtime_error("Unknown benchmark: " + name);
+    }
+
+    esp_chip_info_t chip_info;
+    esp_chip_info(&chip_info);
+    std::string json = "{\"chip\":\"" + SystemInfo::GetChipModelName() + "\",\"revision\":" +
+                       std::to_string(chip_info.revision) + ",\"results\":[" + results + "]}";
+    ESP_LOGI(TAG, "Benchmark '%s' finished", name.c_str());
+    return json;
+}
@@ -0,0 +1,22 @@
+#ifndef MICRO_BENCHMARK_H
+#define MICRO_BENCHMARK_H
+
+#include <string>
+
+/*
+ * 按需触发的微基准套件，通过 MCP 工具 self.run_benchmark 调用。
+ *
+ * 与开机的 AudioBenchmark（盯音频回归、只进日志）不同，这套面向机群：
+ * 结果带芯片型号/版本返回 JSON，让设备自己量自己，硅片批次、PSRAM
+ * 供应商之间的性能差异在现场数据里直接可见——之前一批 PSRAM 时序慢的
+ * 板子靠人工排查花了一个月。覆盖 Opus 编解码（分复杂度档）、重采样、
+ * AES-CTR、base64、canned JSON 解析、内部 RAM 与 PSRAM 各方向 memcpy。
+ */
+class MicroBenchmark {
+public:
+    // name 取 opus / resampler / aes / base64 / json / memcpy / all，
+    // 返回结果 JSON；未知名字抛 std::runtime_error
+    static std::string Run(const std::string& name);
+};
+
+#endif // MICRO_BENCHMARK_H
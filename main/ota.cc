@@ -1,6 +1,9 @@
 #include "ota.h"
+#include "heap_telemetry.h"
+#include "flash_op_monitor.h"
 #include "system_info.h"
 #include "settings.h"
+#include "json_arena.h"
 #include "assets/lang_config.h"
 
 #include <cJSON.h>
@@ -10,17 +13,72 @@
 #include <esp_app_format.h>
 #include <esp_efuse.h>
 #include <esp_efuse_table.h>
+#include <esp_rom_crc.h>
+#include <miniz.h>  // ROM 常驻的 DEFLATE 解压器（tinfl），压缩整包升级用
 #ifdef SOC_HMAC_SUPPORTED
 #include <esp_hmac.h>
 #endif
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <esp_heap_caps.h>
+
+#include <atomic>
 #include <cstring>
+#include <ctime>
 #include <vector>
 #include <sstream>
 #include <algorithm>
 
 #define TAG "Ota"
 
+#define OTA_CHUNK_COUNT 4
+#define OTA_DOWNLOAD_MAX_RETRIES 3
+
+namespace {
+
+struct OtaWriteChunk {
+    uint8_t* data;
+    size_t len;
+};
+
+/* Flash writer stage of the download pipeline: drains filled chunks while the
+ * network stage keeps the radio busy filling the next one, so HTTP reads and
+ * esp_ota_write no longer serialize. */
+struct OtaWriterContext {
+    esp_ota_handle_t handle;
+    QueueHandle_t filled_queue;
+    QueueHandle_t free_queue;
+    SemaphoreHandle_t done;
+    std::atomic<esp_err_t> write_result{ESP_OK};
+};
+
+void OtaWriterTask(void* arg) {
+    auto ctx = static_cast<OtaWriterContext*>(arg);
+    OtaWriteChunk chunk;
+    while (true) {
+        xQueueReceive(ctx->filled_queue, &chunk, portMAX_DELAY);
+        if (chunk.data == nullptr) {  // EOF sentinel
+            break;
+        }
+        if (ctx->write_result.load() == ESP_OK) {
+            // 顺序写模式下 esp_ota_write 内部按需擦除，耗时一并计入
+            FlashOpScope scope(FlashOpMonitor::kPartitionWrite);
+            esp_err_t err = esp_ota_write(ctx->handle, chunk.data, chunk.len);
+            if (err != ESP_OK) {
+                ctx->write_result.store(err);
+            }
+        }
+        xQueueSend(ctx->free_queue, &chunk, portMAX_DELAY);
+    }
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+}  // namespace
+
 
 Ota::Ota() {
 #ifdef ESP_EFUSE_BLOCK_USR_DATA
@@ -51,8 +109,9 @@ std::string Ota::GetCheckVersionUrl() {
 
 std::unique_ptr<Http> Ota::SetupHttp() {
     auto& board = Board::GetInstance();
-    auto network = board.GetNetwork();
-    auto http = network->CreateHttp(0);
+    // Pooled client: repeated version checks and activation polls hit the
+    // same server, so a released client resumes the TLS session
+    auto http = board.AcquireHttp("ota");
     auto user_agent = SystemInfo::GetUserAgent();
     http->SetHeader("Activation-Version", has_serial_number_ ? "2" : "1");
     http->SetHeader("Device-Id", SystemInfo::GetMacAddress().c_str());
@@ -100,16 +159,24 @@ esp_err_t Ota::CheckVersion() {
     auto status_code = http->GetStatusCode();
     if (status_code != 200) {
         ESP_LOGE(TAG, "Failed to check version, status code: %d", status_code);
+        // HTTP 层失败不代表连接坏了，连接放回池子，紧随其后的激活/
+        // 重试不用再付一次 TLS 握手
+        http->Close();
+        board.ReleaseHttp("ota", std::move(http));
         return status_code;
     }
 
     data = http->ReadAll();
     http->Close();
+    board.ReleaseHttp("ota", std::move(http));
 
     // Response: { "firmware": { "version": "1.0.0", "url": "http://" } }
     // Parse the JSON response and check if the version is newer
     // If it is, set has_new_version_ to true and store the new version and URL
     
+    // 应答树节点全部来自 arena，函数返回时整体归还；下面的字段都拷进
+    // std::string 成员，没有指针逃逸
+    JsonArena arena;
     cJSON *root = cJSON_Parse(data.c_str());
     if (root == NULL) {
         ESP_LOGE(TAG, "Failed to parse JSON response");
@@ -218,6 +285,21 @@ esp_err_t Ota::CheckVersion() {
         if (cJSON_IsString(url)) {
             firmware_url_ = url->valuestring;
         }
+        // Optional binary diff against the version we reported; generated by
+        // scripts/make_ota_delta.py. The full image URL stays as fallback.
+        firmware_delta_url_.clear();
+        cJSON *delta_url = cJSON_GetObjectItem(firmware, "delta_url");
+        if (cJSON_IsString(delta_url)) {
+            firmware_delta_url_ = delta_url->valuestring;
+        }
+
+        // Optional zlib-compressed full image (scripts/make_ota_compressed.py),
+        // tried after the delta and before the uncompressed fallback
+        firmware_compressed_url_.clear();
+        cJSON *compressed_url = cJSON_GetObjectItem(firmware, "compressed_url");
+        if (cJSON_IsString(compressed_url)) {
+            firmware_compressed_url_ = compressed_url->valuestring;
+        }
 
         if (cJSON_IsString(version) && cJSON_IsString(url)) {
             // Check if the version is newer, for example, 0.1.0 is newer than 0.0.1
@@ -238,9 +320,26 @@ esp_err_t Ota::CheckVersion() {
     }
 
     cJSON_Delete(root);
+
+    // 记录本次检查的时间和结果；缓存新鲜且上次无待办事项时，
+    // 下次启动可以先就绪、后台再校验（见 Application::CheckNewVersion）
+    {
+        Settings settings("ota", true);
+        settings.SetInt("last_check", static_cast<int32_t>(time(NULL)));
+        settings.SetBool("last_ok", !has_new_version_ && !has_activation_code_ && !has_activation_challenge_);
+    }
     return ESP_OK;
 }
 
+// 从 NVS 恢复上一次版本检查保存的协议配置，用于缓存命中时跳过阻塞检查
+bool Ota::LoadCachedConfig() {
+    Settings mqtt("mqtt", false);
+    has_mqtt_config_ = !mqtt.GetString("endpoint").empty();
+    Settings websocket("websocket", false);
+    has_websocket_config_ = !websocket.GetString("url").empty();
+    return has_mqtt_config_ || has_websocket_config_;
+}
+
 void Ota::MarkCurrentVersionValid() {
     auto partition = esp_ota_get_running_partition();
     if (strcmp(partition->label, "factory") == 0) {
@@ -261,9 +360,31 @@ void Ota::MarkCurrentVersionValid() {
     }
 }
 
+// 后台限速：每收满 4KB 让出一次 CPU 和带宽。音频通道打开时重度让速，
+// 避免下载流量挤占语音链路；空闲时只做最小让步防止饿死低优先级任务。
+// 未设置 background_pacing_（前台升级）时完全不生效。
+void Ota::PaceDownload(size_t bytes) {
+    if (!background_pacing_) {
+        return;
+    }
+    pace_accumulated_ += bytes;
+    if (pace_accumulated_ < 4096) {
+        return;
+    }
+    pace_accumulated_ = 0;
+    vTaskDelay(pdMS_TO_TICKS(background_pacing_() ? 300 : 10));
+}
+
+/*
+ * The download runs as a two-stage pipeline: this task fills a small ring of
+ * chunk buffers from the HTTP stream while a writer task flushes completed
+ * chunks with esp_ota_write, so the radio and the flash stay busy at the same
+ * time instead of serializing on every 512-byte read. If the connection drops
+ * mid-transfer, the download resumes from the last received byte with an HTTP
+ * range request instead of restarting from zero.
+ */
 bool Ota::Upgrade(const std::string& firmware_url) {
     ESP_LOGI(TAG, "Upgrading firmware from %s", firmware_url.c_str());
-    esp_ota_handle_t update_handle = 0;
     auto update_partition = esp_ota_get_next_update_partition(NULL);
     if (update_partition == NULL) {
         ESP_LOGE(TAG, "Failed to get update partition");
@@ -271,8 +392,6 @@ bool Ota::Upgrade(const std::string& firmware_url) {
     }
 
     ESP_LOGI(TAG, "Writing to partition %s at offset 0x%lx", update_partition->label, update_partition->address);
-    bool image_header_checked = false;
-    std::string image_header;
 
     auto network = Board::GetInstance().GetNetwork();
     auto http = network->CreateHttp(0);
@@ -292,20 +411,127 @@ bool Ota::Upgrade(const std::string& firmware_url) {
         return false;
     }
 
-    char buffer[512];
+    // Chunk ring lives in PSRAM; boards without PSRAM fall back to small
+    // internal buffers
+    size_t chunk_size = 16 * 1024;
+    uint32_t caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+    if (heap_caps_get_total_size(MALLOC_CAP_SPIRAM) == 0) {
+        chunk_size = 4096;
+        caps = MALLOC_CAP_8BIT;
+    }
+    OtaWriteChunk pool[OTA_CHUNK_COUNT] = {};
+    for (int i = 0; i < OTA_CHUNK_COUNT; i++) {
+        pool[i].data = static_cast<uint8_t*>(heap_caps_malloc(chunk_size, caps));
+        if (pool[i].data == nullptr) {
+            ESP_LOGE(TAG, "Failed to allocate download buffers");
+            for (int j = 0; j < i; j++) {
+                heap_caps_free(pool[j].data);
+            }
+            return false;
+        }
+    }
+    HeapTelemetry::GetInstance().Add("ota", OTA_CHUNK_COUNT * chunk_size);
+
+    OtaWriterContext writer_ctx;
+    writer_ctx.handle = 0;
+    writer_ctx.filled_queue = xQueueCreate(OTA_CHUNK_COUNT + 1, sizeof(OtaWriteChunk));
+    writer_ctx.free_queue = xQueueCreate(OTA_CHUNK_COUNT, sizeof(OtaWriteChunk));
+    writer_ctx.done = xSemaphoreCreateBinary();
+    for (int i = 0; i < OTA_CHUNK_COUNT; i++) {
+        xQueueSend(writer_ctx.free_queue, &pool[i], portMAX_DELAY);
+    }
+
+    const size_t header_size = sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t) + sizeof(esp_app_desc_t);
+    bool writer_started = false;
+    bool failed = false;
     size_t total_read = 0, recent_read = 0;
+    int retries = 0;
     auto last_calc_time = esp_timer_get_time();
-    while (true) {
-        int ret = http->Read(buffer, sizeof(buffer));
-        if (ret < 0) {
-            ESP_LOGE(TAG, "Failed to read HTTP data: %s", esp_err_to_name(ret));
-            return false;
+
+    while (!failed && total_read < content_length) {
+        OtaWriteChunk chunk;
+        xQueueReceive(writer_ctx.free_queue, &chunk, portMAX_DELAY);
+
+        // Fill the whole chunk so flash writes stay large
+        size_t filled = 0;
+        while (filled < chunk_size && total_read + filled < content_length) {
+            size_t want = std::min(chunk_size - filled, content_length - total_read - filled);
+            int ret = http->Read(reinterpret_cast<char*>(chunk.data) + filled, want);
+            if (ret <= 0) {
+                // Connection dropped mid-transfer, resume from the last
+                // received byte instead of restarting from zero
+                if (++retries > OTA_DOWNLOAD_MAX_RETRIES) {
+                    ESP_LOGE(TAG, "Download failed after %d retries", OTA_DOWNLOAD_MAX_RETRIES);
+                    failed = true;
+                    break;
+                }
+                size_t offset = total_read + filled;
+                ESP_LOGW(TAG, "HTTP read failed at %u/%u, resuming with range request (retry %d)",
+                         offset, content_length, retries);
+                http->Close();
+                http = network->CreateHttp(0);
+                char range[32];
+                snprintf(range, sizeof(range), "bytes=%u-", offset);
+                http->SetHeader("Range", range);
+                if (!http->Open("GET", firmware_url)) {
+                    ESP_LOGE(TAG, "Failed to reopen HTTP connection");
+                    failed = true;
+                    break;
+                }
+                if (http->GetStatusCode() != 206) {
+                    ESP_LOGE(TAG, "Server does not support range requests, status code: %d", http->GetStatusCode());
+                    failed = true;
+                    break;
+                }
+                continue;
+            }
+            filled += ret;
+            PaceDownload(ret);
+        }
+        if (failed || filled == 0) {
+            xQueueSend(writer_ctx.free_queue, &chunk, portMAX_DELAY);
+            failed = true;
+            break;
+        }
+
+        if (!writer_started) {
+            // The first chunk always covers the image header, check the
+            // embedded version and start the flash writer stage
+            if (filled < header_size) {
+                ESP_LOGE(TAG, "Firmware image is too small");
+                xQueueSend(writer_ctx.free_queue, &chunk, portMAX_DELAY);
+                failed = true;
+                break;
+            }
+            esp_app_desc_t new_app_info;
+            memcpy(&new_app_info, chunk.data + sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t), sizeof(esp_app_desc_t));
+
+            auto current_version = esp_app_get_description()->version;
+            ESP_LOGI(TAG, "Current version: %s, New version: %s", current_version, new_app_info.version);
+
+            if (esp_ota_begin(update_partition, OTA_WITH_SEQUENTIAL_WRITES, &writer_ctx.handle)) {
+                ESP_LOGE(TAG, "Failed to begin OTA");
+                xQueueSend(writer_ctx.free_queue, &chunk, portMAX_DELAY);
+                failed = true;
+                break;
+            }
+            xTaskCreate(OtaWriterTask, "ota_write", 4096, &writer_ctx, 5, NULL);
+            writer_started = true;
+        }
+
+        chunk.len = filled;
+        xQueueSend(writer_ctx.filled_queue, &chunk, portMAX_DELAY);
+        total_read += filled;
+        recent_read += filled;
+
+        if (writer_ctx.write_result.load() != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to write OTA data: %s", esp_err_to_name(writer_ctx.write_result.load()));
+            failed = true;
+            break;
         }
 
         // Calculate speed and progress every second
-        recent_read += ret;
-        total_read += ret;
-        if (esp_timer_get_time() - last_calc_time >= 1000000 || ret == 0) {
+        if (esp_timer_get_time() - last_calc_time >= 1000000 || total_read == content_length) {
             size_t progress = total_read * 100 / content_length;
             ESP_LOGI(TAG, "Progress: %u%% (%u/%u), Speed: %uB/s", progress, total_read, content_length, recent_read);
             if (upgrade_callback_) {
@@ -314,39 +540,476 @@ bool Ota::Upgrade(const std::string& firmware_url) {
             last_calc_time = esp_timer_get_time();
             recent_read = 0;
         }
+    }
 
-        if (ret == 0) {
-            break;
+    if (writer_started) {
+        OtaWriteChunk sentinel = {nullptr, 0};
+        xQueueSend(writer_ctx.filled_queue, &sentinel, portMAX_DELAY);
+        xSemaphoreTake(writer_ctx.done, portMAX_DELAY);
+    }
+    http->Close();
+
+    bool success = false;
+    if (!failed && writer_started && writer_ctx.write_result.load() == ESP_OK && total_read == content_length) {
+        esp_err_t err = esp_ota_end(writer_ctx.handle);
+        if (err != ESP_OK) {
+            if (err == ESP_ERR_OTA_VALIDATE_FAILED) {
+                ESP_LOGE(TAG, "Image validation failed, image is corrupted");
+            } else {
+                ESP_LOGE(TAG, "Failed to end OTA: %s", esp_err_to_name(err));
+            }
+        } else {
+            err = esp_ota_set_boot_partition(update_partition);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to set boot partition: %s", esp_err_to_name(err));
+            } else {
+                success = true;
+            }
         }
+    } else if (writer_started) {
+        if (writer_ctx.write_result.load() != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to write OTA data: %s", esp_err_to_name(writer_ctx.write_result.load()));
+        }
+        esp_ota_abort(writer_ctx.handle);
+    }
 
-        if (!image_header_checked) {
-            image_header.append(buffer, ret);
-            if (image_header.size() >= sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t) + sizeof(esp_app_desc_t)) {
-                esp_app_desc_t new_app_info;
-                memcpy(&new_app_info, image_header.data() + sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t), sizeof(esp_app_desc_t));
-                
-                auto current_version = esp_app_get_description()->version;
-                ESP_LOGI(TAG, "Current version: %s, New version: %s", current_version, new_app_info.version);
+    for (int i = 0; i < OTA_CHUNK_COUNT; i++) {
+        heap_caps_free(pool[i].data);
+    }
+    HeapTelemetry::GetInstance().Remove("ota", OTA_CHUNK_COUNT * chunk_size);
+    vQueueDelete(writer_ctx.filled_queue);
+    vQueueDelete(writer_ctx.free_queue);
+    vSemaphoreDelete(writer_ctx.done);
 
-                if (esp_ota_begin(update_partition, OTA_WITH_SEQUENTIAL_WRITES, &update_handle)) {
-                    esp_ota_abort(update_handle);
-                    ESP_LOGE(TAG, "Failed to begin OTA");
-                    return false;
+    if (success) {
+        ESP_LOGI(TAG, "Firmware upgrade successful");
+    }
+    return success;
+}
+
+/*
+ * 压缩整包升级：服务器在 firmware 里下发 compressed_url（zlib 封装的
+ * DEFLATE 流，scripts/make_ota_compressed.py 生成），下载时经 ROM 常驻的
+ * miniz 解压器流式还原进写入管线，应用镜像通常压到 55% 左右，蜂窝链路
+ * 上的流量和升级窗口随之减半。解压器状态全在内存里，断线重连仍按压缩
+ * 流的断点发 range 请求续传；还原出的镜像完整性照旧由 esp_ota_end 校验。
+ */
+bool Ota::UpgradeCompressed(const std::string& url) {
+    ESP_LOGI(TAG, "Upgrading firmware from compressed image %s", url.c_str());
+    auto update_partition = esp_ota_get_next_update_partition(NULL);
+    if (update_partition == NULL) {
+        ESP_LOGE(TAG, "Failed to get update partition");
+        return false;
+    }
+
+    ESP_LOGI(TAG, "Writing to partition %s at offset 0x%lx", update_partition->label, update_partition->address);
+
+    auto network = Board::GetInstance().GetNetwork();
+    auto http = network->CreateHttp(0);
+    if (!http->Open("GET", url)) {
+        ESP_LOGE(TAG, "Failed to open HTTP connection");
+        return false;
+    }
+    if (http->GetStatusCode() != 200) {
+        ESP_LOGE(TAG, "Failed to get firmware, status code: %d", http->GetStatusCode());
+        return false;
+    }
+    size_t content_length = http->GetBodyLength();
+    if (content_length == 0) {
+        ESP_LOGE(TAG, "Failed to get content length");
+        return false;
+    }
+
+    size_t chunk_size = 16 * 1024;
+    uint32_t caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+    if (heap_caps_get_total_size(MALLOC_CAP_SPIRAM) == 0) {
+        chunk_size = 4096;
+        caps = MALLOC_CAP_8BIT;
+    }
+
+    // 解压器状态 + 32KB 滑动字典 + 输入缓冲，合计约 48KB，优先放 PSRAM
+    const size_t in_buf_size = 4096;
+    auto inflator = static_cast<tinfl_decompressor*>(heap_caps_malloc(sizeof(tinfl_decompressor), caps));
+    auto dict = static_cast<uint8_t*>(heap_caps_malloc(TINFL_LZ_DICT_SIZE, caps));
+    auto in_buf = static_cast<uint8_t*>(heap_caps_malloc(in_buf_size, caps));
+    OtaWriteChunk pool[OTA_CHUNK_COUNT] = {};
+    bool alloc_failed = inflator == nullptr || dict == nullptr || in_buf == nullptr;
+    for (int i = 0; i < OTA_CHUNK_COUNT && !alloc_failed; i++) {
+        pool[i].data = static_cast<uint8_t*>(heap_caps_malloc(chunk_size, caps));
+        alloc_failed = pool[i].data == nullptr;
+    }
+    if (alloc_failed) {
+        ESP_LOGE(TAG, "Failed to allocate decompression buffers");
+        for (int i = 0; i < OTA_CHUNK_COUNT; i++) {
+            heap_caps_free(pool[i].data);
+        }
+        heap_caps_free(in_buf);
+        heap_caps_free(dict);
+        heap_caps_free(inflator);
+        return false;
+    }
+    const size_t telemetry_bytes = OTA_CHUNK_COUNT * chunk_size + sizeof(tinfl_decompressor) +
+                                   TINFL_LZ_DICT_SIZE + in_buf_size;
+    HeapTelemetry::GetInstance().Add("ota", telemetry_bytes);
+    tinfl_init(inflator);
+
+    OtaWriterContext writer_ctx;
+    writer_ctx.handle = 0;
+    writer_ctx.filled_queue = xQueueCreate(OTA_CHUNK_COUNT + 1, sizeof(OtaWriteChunk));
+    writer_ctx.free_queue = xQueueCreate(OTA_CHUNK_COUNT, sizeof(OtaWriteChunk));
+    writer_ctx.done = xSemaphoreCreateBinary();
+    for (int i = 0; i < OTA_CHUNK_COUNT; i++) {
+        xQueueSend(writer_ctx.free_queue, &pool[i], portMAX_DELAY);
+    }
+
+    const size_t header_size = sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t) + sizeof(esp_app_desc_t);
+    bool writer_started = false;
+    bool failed = false;
+    bool done = false;
+    size_t comp_read = 0, recent_read = 0, total_written = 0;
+    size_t in_avail = 0, in_ofs = 0, dict_ofs = 0;
+    int retries = 0;
+    auto last_calc_time = esp_timer_get_time();
+
+    OtaWriteChunk chunk = {nullptr, 0};
+    size_t chunk_filled = 0;
+
+    // 当前块攒满（或流结束）后移交写入任务；第一块先做镜像头检查并起管线
+    auto flush_chunk = [&]() -> bool {
+        if (!writer_started) {
+            if (chunk_filled < header_size) {
+                ESP_LOGE(TAG, "Firmware image is too small");
+                return false;
+            }
+            esp_app_desc_t new_app_info;
+            memcpy(&new_app_info, chunk.data + sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t), sizeof(esp_app_desc_t));
+            auto current_version = esp_app_get_description()->version;
+            ESP_LOGI(TAG, "Current version: %s, New version: %s", current_version, new_app_info.version);
+
+            if (esp_ota_begin(update_partition, OTA_WITH_SEQUENTIAL_WRITES, &writer_ctx.handle)) {
+                ESP_LOGE(TAG, "Failed to begin OTA");
+                return false;
+            }
+            xTaskCreate(OtaWriterTask, "ota_write", 4096, &writer_ctx, 5, NULL);
+            writer_started = true;
+        }
+        chunk.len = chunk_filled;
+        xQueueSend(writer_ctx.filled_queue, &chunk, portMAX_DELAY);
+        chunk.data = nullptr;
+        chunk_filled = 0;
+        return true;
+    };
+
+    while (!failed && !done) {
+        // 进料：输入缓冲空了就从 HTTP 流补一段
+        if (in_avail == 0 && comp_read < content_length) {
+            in_ofs = 0;
+            int ret = http->Read(reinterpret_cast<char*>(in_buf), std::min(in_buf_size, content_length - comp_read));
+            if (ret <= 0) {
+                if (++retries > OTA_DOWNLOAD_MAX_RETRIES) {
+                    ESP_LOGE(TAG, "Download failed after %d retries", OTA_DOWNLOAD_MAX_RETRIES);
+                    failed = true;
+                    break;
+                }
+                ESP_LOGW(TAG, "HTTP read failed at %u/%u, resuming with range request (retry %d)",
+                         comp_read, content_length, retries);
+                http->Close();
+                http = network->CreateHttp(0);
+                char range[32];
+                snprintf(range, sizeof(range), "bytes=%u-", comp_read);
+                http->SetHeader("Range", range);
+                if (!http->Open("GET", url)) {
+                    ESP_LOGE(TAG, "Failed to reopen HTTP connection");
+                    failed = true;
+                    break;
+                }
+                if (http->GetStatusCode() != 206) {
+                    ESP_LOGE(TAG, "Server does not support range requests, status code: %d", http->GetStatusCode());
+                    failed = true;
+                    break;
+                }
+                continue;
+            }
+            in_avail = ret;
+            comp_read += ret;
+            recent_read += ret;
+            PaceDownload(ret);
+        }
+
+        // 解压到滑动字典（它就是 LZ 回溯窗口），产出再拷进当前写入块
+        size_t in_bytes = in_avail;
+        size_t out_bytes = TINFL_LZ_DICT_SIZE - dict_ofs;
+        tinfl_status status = tinfl_decompress(inflator, in_buf + in_ofs, &in_bytes,
+            dict, dict + dict_ofs, &out_bytes,
+            TINFL_FLAG_PARSE_ZLIB_HEADER | (comp_read < content_length ? TINFL_FLAG_HAS_MORE_INPUT : 0));
+        in_ofs += in_bytes;
+        in_avail -= in_bytes;
+
+        const uint8_t* produced = dict + dict_ofs;
+        size_t remaining = out_bytes;
+        dict_ofs = (dict_ofs + out_bytes) & (TINFL_LZ_DICT_SIZE - 1);
+        total_written += out_bytes;
+        while (remaining > 0 && !failed) {
+            if (chunk.data == nullptr) {
+                xQueueReceive(writer_ctx.free_queue, &chunk, portMAX_DELAY);
+                if (writer_ctx.write_result.load() != ESP_OK) {
+                    ESP_LOGE(TAG, "Failed to write OTA data: %s", esp_err_to_name(writer_ctx.write_result.load()));
+                    failed = true;
+                    break;
                 }
+            }
+            size_t n = std::min(remaining, chunk_size - chunk_filled);
+            memcpy(chunk.data + chunk_filled, produced, n);
+            chunk_filled += n;
+            produced += n;
+            remaining -= n;
+            if (chunk_filled == chunk_size && !flush_chunk()) {
+                failed = true;
+            }
+        }
+        if (failed) {
+            break;
+        }
 
-                image_header_checked = true;
-                std::string().swap(image_header);
+        if (status == TINFL_STATUS_DONE) {
+            if (chunk_filled > 0) {
+                failed = !flush_chunk();
+            } else if (!writer_started) {
+                ESP_LOGE(TAG, "Firmware image is too small");
+                failed = true;
             }
+            done = true;
+        } else if (status < TINFL_STATUS_DONE) {
+            ESP_LOGE(TAG, "Decompression failed with status %d", (int)status);
+            failed = true;
+        } else if (status == TINFL_STATUS_NEEDS_MORE_INPUT && in_avail == 0 && comp_read >= content_length) {
+            ESP_LOGE(TAG, "Compressed stream is truncated");
+            failed = true;
+        }
+
+        // 进度按压缩流的传输量算，那才是用户等待的瓶颈
+        if (esp_timer_get_time() - last_calc_time >= 1000000) {
+            size_t progress = comp_read * 100 / content_length;
+            ESP_LOGI(TAG, "Progress: %u%% (%u/%u), Speed: %uB/s", progress, comp_read, content_length, recent_read);
+            if (upgrade_callback_) {
+                upgrade_callback_(progress, recent_read);
+            }
+            last_calc_time = esp_timer_get_time();
+            recent_read = 0;
         }
-        auto err = esp_ota_write(update_handle, buffer, ret);
+    }
+
+    if (writer_started) {
+        OtaWriteChunk sentinel = {nullptr, 0};
+        xQueueSend(writer_ctx.filled_queue, &sentinel, portMAX_DELAY);
+        xSemaphoreTake(writer_ctx.done, portMAX_DELAY);
+    }
+    http->Close();
+
+    bool success = false;
+    if (!failed && done && writer_started && writer_ctx.write_result.load() == ESP_OK) {
+        ESP_LOGI(TAG, "Decompressed %u bytes from %u transferred", total_written, comp_read);
+        esp_err_t err = esp_ota_end(writer_ctx.handle);
         if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to write OTA data: %s", esp_err_to_name(err));
+            if (err == ESP_ERR_OTA_VALIDATE_FAILED) {
+                ESP_LOGE(TAG, "Image validation failed, image is corrupted");
+            } else {
+                ESP_LOGE(TAG, "Failed to end OTA: %s", esp_err_to_name(err));
+            }
+        } else {
+            err = esp_ota_set_boot_partition(update_partition);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to set boot partition: %s", esp_err_to_name(err));
+            } else {
+                success = true;
+            }
+        }
+    } else if (writer_started) {
+        if (writer_ctx.write_result.load() != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to write OTA data: %s", esp_err_to_name(writer_ctx.write_result.load()));
+        }
+        esp_ota_abort(writer_ctx.handle);
+    }
+
+    for (int i = 0; i < OTA_CHUNK_COUNT; i++) {
+        heap_caps_free(pool[i].data);
+    }
+    heap_caps_free(in_buf);
+    heap_caps_free(dict);
+    heap_caps_free(inflator);
+    HeapTelemetry::GetInstance().Remove("ota", telemetry_bytes);
+    vQueueDelete(writer_ctx.filled_queue);
+    vQueueDelete(writer_ctx.free_queue);
+    vSemaphoreDelete(writer_ctx.done);
+
+    if (success) {
+        ESP_LOGI(TAG, "Firmware upgrade successful");
+    }
+    return success;
+}
+
+/*
+ * Delta patch format (generated by scripts/make_ota_delta.py):
+ *   magic "XZD1" (4 bytes)
+ *   uint32 LE: new image size
+ *   uint32 LE: CRC32 of the new image (zlib polynomial)
+ *   ops until EOF:
+ *     'C' uint32 src_offset, uint32 length  -- copy from the running partition
+ *     'A' uint32 length, length raw bytes   -- literal data
+ * The new image is reconstructed by streaming reads from the running
+ * partition plus the patch, so no staging buffer is needed. A point release
+ * is mostly 'C' ops and transfers a few hundred KB instead of the full image.
+ */
+bool Ota::UpgradeDelta(const std::string& delta_url) {
+    ESP_LOGI(TAG, "Upgrading firmware with delta patch from %s", delta_url.c_str());
+    auto running_partition = esp_ota_get_running_partition();
+    auto update_partition = esp_ota_get_next_update_partition(NULL);
+    if (running_partition == NULL || update_partition == NULL) {
+        ESP_LOGE(TAG, "Failed to get OTA partitions");
+        return false;
+    }
+
+    auto network = Board::GetInstance().GetNetwork();
+    auto http = network->CreateHttp(0);
+    if (!http->Open("GET", delta_url)) {
+        ESP_LOGE(TAG, "Failed to open HTTP connection");
+        return false;
+    }
+    if (http->GetStatusCode() != 200) {
+        ESP_LOGE(TAG, "Failed to get delta patch, status code: %d", http->GetStatusCode());
+        return false;
+    }
+
+    // Read exactly n bytes from the HTTP stream
+    auto read_exact = [&http, this](void* dest, size_t n) -> bool {
+        auto p = static_cast<char*>(dest);
+        while (n > 0) {
+            int ret = http->Read(p, n);
+            if (ret <= 0) {
+                return false;
+            }
+            p += ret;
+            n -= ret;
+            PaceDownload(ret);
+        }
+        return true;
+    };
+
+    struct __attribute__((packed)) {
+        char magic[4];
+        uint32_t new_size;
+        uint32_t new_crc32;
+    } header;
+    if (!read_exact(&header, sizeof(header)) || memcmp(header.magic, "XZD1", 4) != 0) {
+        ESP_LOGE(TAG, "Invalid delta patch header");
+        return false;
+    }
+    if (header.new_size == 0 || header.new_size > update_partition->size) {
+        ESP_LOGE(TAG, "Delta patch target size %lu does not fit partition", header.new_size);
+        return false;
+    }
+
+    esp_ota_handle_t update_handle = 0;
+    if (esp_ota_begin(update_partition, header.new_size, &update_handle) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to begin OTA");
+        return false;
+    }
+
+    char buffer[512];
+    uint32_t crc = 0;
+    size_t total_written = 0, recent_written = 0;
+    auto last_calc_time = esp_timer_get_time();
+    bool done = false;
+    while (!done) {
+        char op;
+        int ret = http->Read(&op, 1);
+        if (ret == 0) {  // clean EOF after the last op
+            done = true;
+            break;
+        }
+        if (ret < 0) {
+            ESP_LOGE(TAG, "Failed to read HTTP data: %s", esp_err_to_name(ret));
+            esp_ota_abort(update_handle);
+            return false;
+        }
+
+        uint32_t fields[2];
+        size_t length, src_offset = 0;
+        if (op == 'C') {
+            if (!read_exact(fields, sizeof(fields))) {
+                esp_ota_abort(update_handle);
+                return false;
+            }
+            src_offset = fields[0];
+            length = fields[1];
+            if (src_offset + length > running_partition->size) {
+                ESP_LOGE(TAG, "Delta copy out of range: %u+%u", src_offset, length);
+                esp_ota_abort(update_handle);
+                return false;
+            }
+        } else if (op == 'A') {
+            if (!read_exact(fields, sizeof(fields[0]))) {
+                esp_ota_abort(update_handle);
+                return false;
+            }
+            length = fields[0];
+        } else {
+            ESP_LOGE(TAG, "Invalid delta op: 0x%02x", (unsigned)op);
             esp_ota_abort(update_handle);
             return false;
         }
+
+        size_t processed = 0;
+        while (processed < length) {
+            size_t chunk = std::min(length - processed, sizeof(buffer));
+            if (op == 'C') {
+                if (esp_partition_read(running_partition, src_offset + processed, buffer, chunk) != ESP_OK) {
+                    ESP_LOGE(TAG, "Failed to read running partition");
+                    esp_ota_abort(update_handle);
+                    return false;
+                }
+            } else {
+                if (!read_exact(buffer, chunk)) {
+                    ESP_LOGE(TAG, "Failed to read delta literal data");
+                    esp_ota_abort(update_handle);
+                    return false;
+                }
+            }
+            crc = esp_rom_crc32_le(crc, reinterpret_cast<const uint8_t*>(buffer), chunk);
+            esp_err_t err;
+            {
+                FlashOpScope scope(FlashOpMonitor::kPartitionWrite);
+                err = esp_ota_write(update_handle, buffer, chunk);
+            }
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to write OTA data: %s", esp_err_to_name(err));
+                esp_ota_abort(update_handle);
+                return false;
+            }
+            processed += chunk;
+            total_written += chunk;
+            recent_written += chunk;
+
+            if (esp_timer_get_time() - last_calc_time >= 1000000) {
+                size_t progress = total_written * 100 / header.new_size;
+                ESP_LOGI(TAG, "Progress: %u%% (%u/%lu)", progress, total_written, header.new_size);
+                if (upgrade_callback_) {
+                    upgrade_callback_(progress, recent_written);
+                }
+                last_calc_time = esp_timer_get_time();
+                recent_written = 0;
+            }
+        }
     }
     http->Close();
 
+    if (total_written != header.new_size || crc != header.new_crc32) {
+        ESP_LOGE(TAG, "Reconstructed image mismatch: size %u/%lu, crc %08lx/%08lx",
+                 total_written, header.new_size, crc, header.new_crc32);
+        esp_ota_abort(update_handle);
+        return false;
+    }
+
     esp_err_t err = esp_ota_end(update_handle);
     if (err != ESP_OK) {
         if (err == ESP_ERR_OTA_VALIDATE_FAILED) {
@@ -363,12 +1026,24 @@ bool Ota::Upgrade(const std::string& firmware_url) {
         return false;
     }
 
-    ESP_LOGI(TAG, "Firmware upgrade successful");
+    ESP_LOGI(TAG, "Firmware delta upgrade successful, transferred against version %s", current_version_.c_str());
     return true;
 }
 
 bool Ota::StartUpgrade(std::function<void(int progress, size_t speed)> callback) {
     upgrade_callback_ = callback;
+    if (!firmware_delta_url_.empty()) {
+        if (UpgradeDelta(firmware_delta_url_)) {
+            return true;
+        }
+        ESP_LOGW(TAG, "Delta upgrade failed, falling back to compressed/full image");
+    }
+    if (!firmware_compressed_url_.empty()) {
+        if (UpgradeCompressed(firmware_compressed_url_)) {
+            return true;
+        }
+        ESP_LOGW(TAG, "Compressed upgrade failed, falling back to full image");
+    }
     return Upgrade(firmware_url_);
 }
 
@@ -466,13 +1141,21 @@ esp_err_t Ota::Activate() {
     
     auto status_code = http->GetStatusCode();
     if (status_code == 202) {
+        // 挂起重试：把热连接放回池子，3 秒后的下一轮轮询直接复用，
+        // 不再每轮付一次证书链解析 + TLS 握手（C3 上约 400ms）
+        http->Close();
+        Board::GetInstance().ReleaseHttp("ota", std::move(http));
         return ESP_ERR_TIMEOUT;
     }
     if (status_code != 200) {
         ESP_LOGE(TAG, "Failed to activate, code: %d, body: %s", status_code, http->ReadAll().c_str());
+        http->Close();
+        Board::GetInstance().ReleaseHttp("ota", std::move(http));
         return ESP_FAIL;
     }
 
     ESP_LOGI(TAG, "Activation successful");
+    http->Close();
+    Board::GetInstance().ReleaseHttp("ota", std::move(http));
     return ESP_OK;
 }
@@ -13,6 +13,7 @@ public:
     ~Ota();
 
     esp_err_t CheckVersion();
+    bool LoadCachedConfig();
     esp_err_t Activate();
     bool HasActivationChallenge() { return has_activation_challenge_; }
     bool HasNewVersion() { return has_new_version_; }
@@ -22,14 +23,19 @@ public:
     bool HasServerTime() { return has_server_time_; }
     bool StartUpgrade(std::function<void(int progress, size_t speed)> callback);
     bool StartUpgradeFromUrl(const std::string& url, std::function<void(int progress, size_t speed)> callback);
+    // 后台升级的限速钩子：设置后每个下载块之间让出带宽，回调返回
+    // true（音频通道打开）时重度让速
+    void SetBackgroundPacing(std::function<bool()> audio_busy) { background_pacing_ = std::move(audio_busy); }
     void MarkCurrentVersionValid();
 
     const std::string& GetFirmwareVersion() const { return firmware_version_; }
     const std::string& GetCurrentVersion() const { return current_version_; }
     const std::string& GetFirmwareUrl() const { return firmware_url_; }
+    const std::string& GetFirmwareDeltaUrl() const { return firmware_delta_url_; }
+    const std::string& GetFirmwareCompressedUrl() const { return firmware_compressed_url_; }
     const std::string& GetActivationMessage() const { return activation_message_; }
     const std::string& GetActivationCode() const { return activation_code_; }
-    std::string GetCheckVersionUrl();
+    static std::string GetCheckVersionUrl();
 
 private:
     std::string activation_message_;
@@ -44,11 +50,18 @@ private:
     std::string current_version_;
     std::string firmware_version_;
     std::string firmware_url_;
+    std::string firmware_delta_url_;
+    std::string firmware_compressed_url_;
     std::string activation_challenge_;
     std::string serial_number_;
     int activation_timeout_ms_ = 30000;
 
     bool Upgrade(const std::string& firmware_url);
+    bool UpgradeDelta(const std::string& delta_url);
+    bool UpgradeCompressed(const std::string& url);
+    void PaceDownload(size_t bytes);
+    std::function<bool()> background_pacing_;
+    size_t pace_accumulated_ = 0;
     std::function<void(int progress, size_t speed)> upgrade_callback_;
     std::vector<int> ParseVersion(const std::string& version);
     bool IsNewVersionAvailable(const std::string& currentVersion, const std::string& newVersion);
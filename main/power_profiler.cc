@@ -0,0 +1,128 @@
+#include "power_profiler.h"
+#include "device_state_event.h"
+#include "board.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#define TAG "PowerProfiler"
+
+#if CONFIG_POWER_PROFILER
+
+namespace {
+// 标称 3.7V 锂电，容量来自 Kconfig；换算只求量级可比，不追求绝对精度
+constexpr float kCapacityMwh = CONFIG_POWER_PROFILER_BATTERY_MAH * 3.7f;
+
+const char* const kStateNames[] = {
+    "unknown", "starting", "wifi_config", "idle", "connecting",
+    "listening", "speaking", "upgrading", "activating", "audio_testing",
+    "fatal_error",
+};
+static_assert(sizeof(kStateNames) / sizeof(kStateNames[0]) ==
+              kDeviceStateFatalError + 1, "state name table out of sync");
+
+const char* const kFlagNames[] = { "session", "audio_proc", "display" };
+}
+
+void PowerProfiler::Init() {
+    // 时间分桶只要先后顺序，异步档回调足够，不拖累状态切换路径
+    DeviceStateEventManager::GetInstance().RegisterStateChangeCallback(
+        [this](DeviceState previous_state, DeviceState current_state) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            FlushElapsed(esp_timer_get_time());
+            state_ = current_state;
+        }, StateCallbackTier::kAsync);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_since_us_ = esp_timer_get_time();
+}
+
+void PowerProfiler::SetFlag(Flag flag, bool active) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (flag_active_[flag] == active) {
+        return;
+    }
+    FlushElapsed(esp_timer_get_time());
+    flag_active_[flag] = active;
+}
+
+void PowerProfiler::Sample() {
+    int level = 0;
+    bool charging = false, discharging = false;
+    if (!Board::GetInstance().GetBatteryLevel(level, charging, discharging)) {
+        return;  // 无电池的板子：只有时间桶，没有能量桶
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    FlushElapsed(esp_timer_get_time());
+
+    if (last_level_ < 0 || charging || level > last_level_) {
+        // 起点、充电或回充：本窗口的放电量不可信，作废重新锚定
+        for (auto& us : window_state_us_) {
+            us = 0;
+        }
+        last_level_ = level;
+        return;
+    }
+    if (level == last_level_) {
+        return;
+    }
+
+    // 掉格：按窗口内各状态停留时间把放电能量摊进对应桶
+    float energy_mwh = (last_level_ - level) * kCapacityMwh / 100.0f;
+    int64_t window_total_us = 0;
+    for (auto us : window_state_us_) {
+        window_total_us += us;
+    }
+    if (window_total_us > 0) {
+        for (int i = 0; i < kStateCount; i++) {
+            state_mwh_[i] += energy_mwh * window_state_us_[i] / window_total_us;
+            window_state_us_[i] = 0;
+        }
+        total_mwh_ += energy_mwh;
+    }
+    last_level_ = level;
+}
+
+void PowerProfiler::Dump() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FlushElapsed(esp_timer_get_time());
+
+    ESP_LOGI(TAG, "Cumulative discharge: %.1f mWh", (double)total_mwh_);
+    for (int i = 0; i < kStateCount; i++) {
+        if (state_total_us_[i] == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-12s %6llds  %7.1f mWh", kStateNames[i],
+                 (long long)(state_total_us_[i] / 1000000), (double)state_mwh_[i]);
+    }
+    for (int i = 0; i < kFlagCount; i++) {
+        ESP_LOGI(TAG, "  [%s] active %llds", kFlagNames[i],
+                 (long long)(flag_total_us_[i] / 1000000));
+    }
+}
+
+void PowerProfiler::FlushElapsed(int64_t now_us) {
+    if (state_since_us_ != 0) {
+        int64_t elapsed = now_us - state_since_us_;
+        state_total_us_[state_] += elapsed;
+        window_state_us_[state_] += elapsed;
+    }
+    state_since_us_ = now_us;
+    for (int i = 0; i < kFlagCount; i++) {
+        if (flag_active_[i] && flag_since_us_[i] != 0) {
+            flag_total_us_[i] += now_us - flag_since_us_[i];
+        }
+        flag_since_us_[i] = now_us;
+    }
+}
+
+#else
+
+void PowerProfiler::Init() {}
+void PowerProfiler::SetFlag(Flag flag, bool active) {}
+void PowerProfiler::Sample() {}
+void PowerProfiler::Dump() {}
+void PowerProfiler::FlushElapsed(int64_t now_us) {}
+
+#endif
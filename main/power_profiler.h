@@ -0,0 +1,66 @@
+#ifndef POWER_PROFILER_H
+#define POWER_PROFILER_H
+
+#include <cstdint>
+#include <mutex>
+
+#include "device_state.h"
+
+/**
+ * 按设备状态分桶的耗电画像（CONFIG_POWER_PROFILER 开启时生效）。
+ * 板上没有逐毫安的电流计，但电量计的百分比掉格是真实放电量：每次掉格把
+ * (掉格数 × 标称容量/100) 的能量按该区间内各 DeviceState 的停留时间摊到
+ * 对应桶里，长期累计即得 mWh-per-state。充电区间作废不计。另外记录三个
+ * 子系统活跃时长（会话链路、音频处理器、屏幕亮屏），供现场数据交叉分析
+ * DVFS / 息屏这类省电特性的真实收益。
+ */
+class PowerProfiler {
+public:
+    enum Flag {
+        kFlagNetworkSession,   // 音频通道打开期间
+        kFlagAudioProcessor,   // AEC/VAD 运行期间
+        kFlagDisplayOn,        // 非息屏期间
+        kFlagCount,
+    };
+
+    static PowerProfiler& GetInstance() {
+        static PowerProfiler instance;
+        return instance;
+    }
+
+    // 注册状态监听并锚定电量起点，Application::Start 里调用一次
+    void Init();
+
+    // 子系统活跃开关，各归属模块在启停点调用
+    void SetFlag(Flag flag, bool active);
+
+    // 周期采样电量计（主循环 10 秒调试节拍里调用），掉格时做能量摊销
+    void Sample();
+
+    // 打印累计画像，SystemInfo::PrintPowerProfile 转发到这里
+    void Dump();
+
+private:
+    PowerProfiler() = default;
+    PowerProfiler(const PowerProfiler&) = delete;
+    PowerProfiler& operator=(const PowerProfiler&) = delete;
+
+    static constexpr int kStateCount = kDeviceStateFatalError + 1;
+
+    // 把当前状态/活跃标志截至 now 的时间冲入累计桶
+    void FlushElapsed(int64_t now_us);
+
+    std::mutex mutex_;
+    DeviceState state_ = kDeviceStateUnknown;
+    int64_t state_since_us_ = 0;
+    int64_t state_total_us_[kStateCount] = {};
+    int64_t window_state_us_[kStateCount] = {};   // 自上次电量锚点起
+    float state_mwh_[kStateCount] = {};
+    bool flag_active_[kFlagCount] = {};
+    int64_t flag_since_us_[kFlagCount] = {};
+    int64_t flag_total_us_[kFlagCount] = {};
+    int last_level_ = -1;
+    float total_mwh_ = 0.0f;
+};
+
+#endif // POWER_PROFILER_H
@@ -2,6 +2,8 @@
 #include "board.h"
 #include "application.h"
 #include "settings.h"
+#include "hot_log.h"
+#include "json_arena.h"
 
 #include <esp_log.h>
 #include <cstring>
@@ -28,14 +30,30 @@ MqttProtocol::MqttProtocol() {
         .arg = this,
     };
     esp_timer_create(&reconnect_timer_args, &reconnect_timer_);
+
+#if CONFIG_MQTT_UDP_KEEPALIVE_SECONDS > 0
+    esp_timer_create_args_t keepalive_timer_args = {
+        .callback = [](void* arg) {
+            ((MqttProtocol*)arg)->SendUdpKeepalive();
+        },
+        .arg = this,
+    };
+    esp_timer_create(&keepalive_timer_args, &udp_keepalive_timer_);
+#endif
 }
 
 MqttProtocol::~MqttProtocol() {
     ESP_LOGI(TAG, "MqttProtocol deinit");
+    // Stop the sender task while the transports it writes through still exist
+    StopOutboundTask();
     if (reconnect_timer_ != nullptr) {
         esp_timer_stop(reconnect_timer_);
         esp_timer_delete(reconnect_timer_);
     }
+    if (udp_keepalive_timer_ != nullptr) {
+        esp_timer_stop(udp_keepalive_timer_);
+        esp_timer_delete(udp_keepalive_timer_);
+    }
 
     udp_.reset();
     mqtt_.reset();
@@ -91,6 +109,14 @@ bool MqttProtocol::StartMqttClient(bool report_error) {
     });
 
     mqtt_->OnMessage([this](const std::string& topic, const std::string& payload) {
+        CountIncoming(payload.size());
+        /* State messages (tts/stt/llm) bypass the DOM parser */
+        if (DispatchStateMessage(payload.data(), payload.size())) {
+            last_incoming_time_ = std::chrono::steady_clock::now();
+            return;
+        }
+        // 整棵解析树从逐消息 arena 切出，回调返回后整体归还
+        JsonArena arena;
         cJSON* root = cJSON_Parse(payload.c_str());
         if (root == nullptr) {
             ESP_LOGE(TAG, "Failed to parse json message %s", payload.c_str());
@@ -137,6 +163,10 @@ bool MqttProtocol::StartMqttClient(bool report_error) {
     }
 
     ESP_LOGI(TAG, "Connected to endpoint");
+    if (has_connected_) {
+        network_statistics_.reconnect_count++;
+    }
+    has_connected_ = true;
     return true;
 }
 
@@ -152,35 +182,97 @@ bool MqttProtocol::SendText(const std::string& text) {
     return true;
 }
 
-bool MqttProtocol::SendAudio(std::unique_ptr<AudioStreamPacket> packet) {
+bool MqttProtocol::SendAudioNow(std::unique_ptr<AudioStreamPacket> packet) {
     std::lock_guard<std::mutex> lock(channel_mutex_);
     if (udp_ == nullptr) {
         return false;
     }
 
-    std::string nonce(aes_nonce_);
+    /* Build the per-packet nonce on the stack and append the encrypted
+     * record to the reused datagram buffer instead of allocating fresh
+     * strings for every 60ms frame */
+    uint8_t nonce[16];
+    memcpy(nonce, aes_nonce_.data(), sizeof(nonce));
     *(uint16_t*)&nonce[2] = htons(packet->payload.size());
     *(uint32_t*)&nonce[8] = htonl(packet->timestamp);
     *(uint32_t*)&nonce[12] = htonl(++local_sequence_);
 
-    std::string encrypted;
-    encrypted.resize(aes_nonce_.size() + packet->payload.size());
-    memcpy(encrypted.data(), nonce.data(), nonce.size());
+    size_t record_offset = udp_send_buffer_.size();
+    udp_send_buffer_.resize(record_offset + sizeof(nonce) + packet->payload.size());
+    memcpy(&udp_send_buffer_[record_offset], nonce, sizeof(nonce));
 
     size_t nc_off = 0;
     uint8_t stream_block[16] = {0};
-    if (mbedtls_aes_crypt_ctr(&aes_ctx_, packet->payload.size(), &nc_off, (uint8_t*)nonce.c_str(), stream_block,
-        (uint8_t*)packet->payload.data(), (uint8_t*)&encrypted[nonce.size()]) != 0) {
-        ESP_LOGE(TAG, "Failed to encrypt audio data");
+    if (mbedtls_aes_crypt_ctr(&aes_ctx_, packet->payload.size(), &nc_off, nonce, stream_block,
+        (uint8_t*)packet->payload.data(), (uint8_t*)&udp_send_buffer_[record_offset + sizeof(nonce)]) != 0) {
+        HOT_LOGE(TAG, "Failed to encrypt audio data");
+        udp_send_buffer_.resize(record_offset);
         return false;
     }
+    udp_batched_frames_++;
+
+#if CONFIG_MQTT_UDP_AUDIO_BATCH
+    /* When frames arrive faster than real time the send queue is backing
+     * up; coalesce a few records into one datagram, since each UDP send
+     * carries high fixed AT-command overhead on cellular modems. Each
+     * record embeds its own nonce and payload size, so the server parses
+     * the batch by walking the records. */
+    int64_t now = esp_timer_get_time();
+    bool backlog = (now - udp_last_send_time_us_) < (int64_t)packet->frame_duration * 1000 / 2;
+    if (backlog && udp_batched_frames_ < 3) {
+        return true;
+    }
+    udp_last_send_time_us_ = now;
+#endif
+
+#if CONFIG_MQTT_UDP_AUDIO_REDUNDANCY
+    /* Resend the previous record ahead of the current one. The server
+     * drops the duplicate by its old sequence number, but when the
+     * previous datagram was lost this copy fills the gap, converting most
+     * single-packet losses into nothing at all. */
+    std::string datagram = udp_previous_record_ + udp_send_buffer_;
+    udp_previous_record_ = udp_send_buffer_;
+    udp_send_buffer_.clear();
+    udp_batched_frames_ = 0;
+    udp_last_send_time_us_ = esp_timer_get_time();
+    return udp_->Send(datagram) > 0;
+#else
+    bool ok = udp_->Send(udp_send_buffer_) > 0;
+    udp_send_buffer_.clear();
+    udp_batched_frames_ = 0;
+    udp_last_send_time_us_ = esp_timer_get_time();
+    return ok;
+#endif
+}
 
-    return udp_->Send(encrypted) > 0;
+void MqttProtocol::SendUdpKeepalive() {
+    std::lock_guard<std::mutex> lock(channel_mutex_);
+    if (udp_ == nullptr) {
+        return;
+    }
+    // 最近发过音频就不用刷新映射
+    int64_t now = esp_timer_get_time();
+    if (now - udp_last_send_time_us_ < (int64_t)CONFIG_MQTT_UDP_KEEPALIVE_SECONDS * 1000000 / 2) {
+        return;
+    }
+    // 单字节数据报不满足记录格式，服务端按无效包丢弃，只为刷新 NAT 映射
+    udp_->Send(std::string(1, '\0'));
+    udp_last_send_time_us_ = now;
 }
 
 void MqttProtocol::CloseAudioChannel() {
+    if (udp_keepalive_timer_ != nullptr) {
+        esp_timer_stop(udp_keepalive_timer_);
+    }
     {
         std::lock_guard<std::mutex> lock(channel_mutex_);
+        /* Flush any frames still held back by the batch mode */
+        if (udp_ != nullptr && !udp_send_buffer_.empty()) {
+            udp_->Send(udp_send_buffer_);
+        }
+        udp_send_buffer_.clear();
+        udp_batched_frames_ = 0;
+        udp_previous_record_.clear();
         udp_.reset();
     }
 
@@ -208,6 +300,7 @@ bool MqttProtocol::OpenAudioChannel() {
     xEventGroupClearBits(event_group_handle_, MQTT_PROTOCOL_SERVER_HELLO_EVENT);
 
     auto message = GetHelloMessage();
+    int64_t hello_sent_time = esp_timer_get_time();
     if (!SendText(message)) {
         return false;
     }
@@ -219,32 +312,48 @@ bool MqttProtocol::OpenAudioChannel() {
         SetError(Lang::Strings::SERVER_TIMEOUT);
         return false;
     }
+    network_statistics_.last_handshake_rtt_us = esp_timer_get_time() - hello_sent_time;
 
     std::lock_guard<std::mutex> lock(channel_mutex_);
     auto network = Board::GetInstance().GetNetwork();
     udp_ = network->CreateUdp(2);
     udp_->OnMessage([this](const std::string& data) {
+        CountIncoming(data.size());
         /*
          * UDP Encrypted OPUS Packet Format:
          * |type 1u|flags 1u|payload_len 2u|ssrc 4u|timestamp 4u|sequence 4u|
          * |payload payload_len|
          */
         if (data.size() < sizeof(aes_nonce_)) {
-            ESP_LOGE(TAG, "Invalid audio packet size: %u", data.size());
+            HOT_LOGE(TAG, "Invalid audio packet size: %u", data.size());
             return;
         }
         if (data[0] != 0x01) {
-            ESP_LOGE(TAG, "Invalid audio packet type: %x", data[0]);
+            HOT_LOGE(TAG, "Invalid audio packet type: %x", data[0]);
             return;
         }
         uint32_t timestamp = ntohl(*(uint32_t*)&data[8]);
         uint32_t sequence = ntohl(*(uint32_t*)&data[12]);
         if (sequence < remote_sequence_) {
-            ESP_LOGW(TAG, "Received audio packet with old sequence: %lu, expected: %lu", sequence, remote_sequence_);
+            HOT_LOGW(TAG, "Received audio packet with old sequence: %lu, expected: %lu", sequence, remote_sequence_);
             return;
         }
         if (sequence != remote_sequence_ + 1) {
-            ESP_LOGW(TAG, "Received audio packet with wrong sequence: %lu, expected: %lu", sequence, remote_sequence_ + 1);
+            HOT_LOGW(TAG, "Received audio packet with wrong sequence: %lu, expected: %lu", sequence, remote_sequence_ + 1);
+            /* Cover each missing frame with an empty packet: the decode
+             * task runs Opus PLC for empty payloads, so a single lost
+             * frame becomes inaudible concealment instead of a hard gap */
+            if (remote_sequence_ != 0 && on_incoming_audio_) {
+                uint32_t missing = sequence - remote_sequence_ - 1;
+                const uint32_t kMaxConcealedFrames = 3;
+                for (uint32_t i = missing > kMaxConcealedFrames ? kMaxConcealedFrames : missing; i > 0; i--) {
+                    auto plc = AcquireAudioPacket();
+                    plc->sample_rate = server_sample_rate_;
+                    plc->frame_duration = server_frame_duration_;
+                    plc->timestamp = timestamp - i * (uint32_t)server_frame_duration_;
+                    on_incoming_audio_(std::move(plc));
+                }
+            }
         }
 
         size_t decrypted_size = data.size() - aes_nonce_.size();
@@ -259,10 +368,10 @@ bool MqttProtocol::OpenAudioChannel() {
         packet->payload.resize(decrypted_size);
         int ret = mbedtls_aes_crypt_ctr(&aes_ctx_, decrypted_size, &nc_off, nonce, stream_block, encrypted, (uint8_t*)packet->payload.data());
         if (ret != 0) {
-            ESP_LOGE(TAG, "Failed to decrypt audio data, ret: %d", ret);
+            HOT_LOGE(TAG, "Failed to decrypt audio data, ret: %d", ret);
             return;
         }
-        if (on_incoming_audio_ != nullptr) {
+        if (on_incoming_audio_) {
             on_incoming_audio_(std::move(packet));
         }
         remote_sequence_ = sequence;
@@ -271,6 +380,11 @@ bool MqttProtocol::OpenAudioChannel() {
 
     udp_->Connect(udp_server_, udp_port_);
 
+#if CONFIG_MQTT_UDP_KEEPALIVE_SECONDS > 0
+    esp_timer_stop(udp_keepalive_timer_);
+    esp_timer_start_periodic(udp_keepalive_timer_, (int64_t)CONFIG_MQTT_UDP_KEEPALIVE_SECONDS * 1000000);
+#endif
+
     if (on_audio_channel_opened_ != nullptr) {
         on_audio_channel_opened_();
     }
@@ -278,28 +392,19 @@ bool MqttProtocol::OpenAudioChannel() {
 }
 
 std::string MqttProtocol::GetHelloMessage() {
-    // 发送 hello 消息申请 UDP 通道
-    cJSON* root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "type", "hello");
-    cJSON_AddNumberToObject(root, "version", 3);
-    cJSON_AddStringToObject(root, "transport", "udp");
-    cJSON* features = cJSON_CreateObject();
+    // 发送 hello 消息申请 UDP 通道。消息形状固定，所有字段在编译期就已知，
+    // 整个骨架由预处理器拼好，省去每次开通道时的 cJSON 分配
+    static constexpr const char kHelloMessage[] =
+        "{\"type\":\"hello\",\"version\":3,\"transport\":\"udp\","
+        "\"features\":{"
 #if CONFIG_USE_SERVER_AEC
-    cJSON_AddBoolToObject(features, "aec", true);
+        "\"aec\":true,"
 #endif
-    cJSON_AddBoolToObject(features, "mcp", true);
-    cJSON_AddItemToObject(root, "features", features);
-    cJSON* audio_params = cJSON_CreateObject();
-    cJSON_AddStringToObject(audio_params, "format", "opus");
-    cJSON_AddNumberToObject(audio_params, "sample_rate", 16000);
-    cJSON_AddNumberToObject(audio_params, "channels", 1);
-    cJSON_AddNumberToObject(audio_params, "frame_duration", OPUS_FRAME_DURATION_MS);
-    cJSON_AddItemToObject(root, "audio_params", audio_params);
-    auto json_str = cJSON_PrintUnformatted(root);
-    std::string message(json_str);
-    cJSON_free(json_str);
-    cJSON_Delete(root);
-    return message;
+        "\"text_delta\":true,"
+        "\"mcp\":true},"
+        "\"audio_params\":{\"format\":\"opus\",\"sample_rate\":16000,"
+        "\"channels\":1,\"frame_duration\":" PROTOCOL_STR(OPUS_FRAME_DURATION_MS) "}}";
+    return kHelloMessage;
 }
 
 void MqttProtocol::ParseServerHello(const cJSON* root) {
@@ -345,6 +450,7 @@ void MqttProtocol::ParseServerHello(const cJSON* root) {
     mbedtls_aes_setkey_enc(&aes_ctx_, (const unsigned char*)DecodeHexString(key).c_str(), 128);
     local_sequence_ = 0;
     remote_sequence_ = 0;
+    udp_previous_record_.clear();
     xEventGroupSetBits(event_group_handle_, MQTT_PROTOCOL_SERVER_HELLO_EVENT);
 }
 
@@ -27,7 +27,6 @@ public:
     ~MqttProtocol();
 
     bool Start() override;
-    bool SendAudio(std::unique_ptr<AudioStreamPacket> packet) override;
     bool OpenAudioChannel() override;
     void CloseAudioChannel() override;
     bool IsAudioChannelOpened() const override;
@@ -47,12 +46,26 @@ private:
     uint32_t local_sequence_;
     uint32_t remote_sequence_;
     esp_timer_handle_t reconnect_timer_;
+    /* Datagram assembly buffer, reused across packets under channel_mutex_.
+     * With CONFIG_MQTT_UDP_AUDIO_BATCH it may hold a few encrypted frames
+     * before one sendto; otherwise it is flushed per frame. */
+    std::string udp_send_buffer_;
+    int udp_batched_frames_ = 0;
+    /* Copy of the last sent record(s) for the redundancy mode */
+    std::string udp_previous_record_;
+    bool has_connected_ = false;
+    int64_t udp_last_send_time_us_ = 0;
+    /* 空闲时定期发单字节数据报刷新运营商 NAT 的 UDP 映射；有音频在
+     * 流动时每个帧本身就是保活，回调里按 udp_last_send_time_us_ 跳过 */
+    esp_timer_handle_t udp_keepalive_timer_ = nullptr;
 
     bool StartMqttClient(bool report_error=false);
     void ParseServerHello(const cJSON* root);
+    void SendUdpKeepalive();
     std::string DecodeHexString(const std::string& hex_string);
 
     bool SendText(const std::string& text) override;
+    bool SendAudioNow(std::unique_ptr<AudioStreamPacket> packet) override;
     std::string GetHelloMessage();
 };
 
@@ -1,14 +1,341 @@
 #include "protocol.h"
+#include "task_registry.h"
+#include "tracepoint.h"
 
 #include <esp_log.h>
+#include <esp_timer.h>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string_view>
 
 #define TAG "Protocol"
 
+namespace {
+
+const size_t kMaxPooledAudioPackets = 8;
+
+std::mutex audio_packet_pool_mutex;
+std::deque<std::unique_ptr<AudioStreamPacket>> audio_packet_pool;
+
+// 控制消息缓冲池：listen/abort/mcp 这类消息都在状态切换点成簇发出，
+// 正好撞上音频编解码最忙的时刻，回收容量让稳态下的控制发送零分配。
+// 大帧（附件、工具列表）发送后不回池，避免池里扣着几 KB 不放
+const size_t kMaxPooledControlBuffers = 4;
+const size_t kMaxPooledControlCapacity = 512;
+
+std::mutex control_buffer_pool_mutex;
+std::deque<std::string> control_buffer_pool;
+
+} // namespace
+
+void NetworkStatistics::RecordSendLatency(int64_t us) {
+    if (us < 0) {
+        us = 0;
+    }
+    int bucket = 0;
+    while (us > 1 && bucket < kNumBuckets - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    send_latency_buckets[bucket]++;
+    send_count++;
+}
+
+uint32_t NetworkStatistics::SendLatencyPercentileUs(int percent) const {
+    if (send_count == 0) {
+        return 0;
+    }
+    uint32_t rank = (uint64_t)send_count * percent / 100;
+    uint32_t seen = 0;
+    for (int i = 0; i < kNumBuckets; i++) {
+        seen += send_latency_buckets[i];
+        if (seen > rank) {
+            return 1u << (i + 1);
+        }
+    }
+    return 1u << kNumBuckets;
+}
+
+Protocol::~Protocol() {
+    // Backstop only: transports stop the task themselves before their
+    // transport members are destroyed
+    StopOutboundTask();
+}
+
+bool Protocol::SendAudio(std::unique_ptr<AudioStreamPacket> packet) {
+    if (!IsAudioChannelOpened()) {
+        return false;
+    }
+    EnsureOutboundTask();
+    {
+        std::lock_guard<std::mutex> lock(outbound_mutex_);
+        if (outbound_audio_queue_.size() >= MAX_QUEUED_OUTBOUND_AUDIO_PACKETS) {
+            ReleaseAudioPacket(std::move(outbound_audio_queue_.front()));
+            outbound_audio_queue_.pop_front();
+        }
+        outbound_audio_queue_.push_back(std::move(packet));
+    }
+    xTaskNotifyGive(outbound_task_);
+    return true;
+}
+
+void Protocol::EnqueueControl(std::string message, bool urgent) {
+    EnsureOutboundTask();
+    {
+        std::lock_guard<std::mutex> lock(outbound_mutex_);
+        if (urgent) {
+            outbound_control_queue_.push_front({std::move(message), false, false});
+        } else {
+            bool bulk = message.size() >= kBulkControlThreshold;
+            outbound_control_queue_.push_back({std::move(message), false, bulk});
+        }
+    }
+    xTaskNotifyGive(outbound_task_);
+}
+
+void Protocol::EnqueueBinary(std::string frame) {
+    EnsureOutboundTask();
+    {
+        std::lock_guard<std::mutex> lock(outbound_mutex_);
+        // 附件天然是大帧
+        outbound_control_queue_.push_back({std::move(frame), true, true});
+    }
+    xTaskNotifyGive(outbound_task_);
+}
+
+void Protocol::EnsureOutboundTask() {
+    if (outbound_task_ != nullptr) {
+        return;
+    }
+    outbound_task_exit_ = false;
+    outbound_task_exited_ = xSemaphoreCreateBinary();
+#if CONFIG_FREERTOS_UNICORE
+    xTaskCreate([](void* arg) {
+        ((Protocol*)arg)->OutboundTask();
+        vTaskDelete(NULL);
+    }, "proto_send", 4096, this, 3, &outbound_task_);
+    TaskRegistry::GetInstance().Register(outbound_task_, "proto_send", 3, -1);
+#else
+    /* 双核目标上把发送任务绑到核 1：MQTT 的逐包 AES-CTR 加密在这个
+     * 任务里跑，绑走之后主循环所在的核 0 不再被每包约 1ms 的加密
+     * 抢占，实时对话期间 UI 调度不抖。默认绑核可按板型用
+     * CONFIG_TASK_AFFINITY_MAP 覆盖 */
+    int core = TaskRegistry::GetInstance().ResolveCore("proto_send", 1);
+    xTaskCreatePinnedToCore([](void* arg) {
+        ((Protocol*)arg)->OutboundTask();
+        vTaskDelete(NULL);
+    }, "proto_send", 4096, this, 3, &outbound_task_, core);
+    TaskRegistry::GetInstance().Register(outbound_task_, "proto_send", 3, core);
+#endif
+}
+
+void Protocol::OutboundTask() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (outbound_task_exit_) {
+            break;
+        }
+        while (!outbound_task_exit_) {
+            OutboundMessage message;
+            bool have_message = false;
+            std::unique_ptr<AudioStreamPacket> packet;
+            {
+                std::lock_guard<std::mutex> lock(outbound_mutex_);
+                // Control lane first: state changes preempt queued audio.
+                // Exception: when the next control message is a bulk frame
+                // (tool list, image attachment), queued audio drains ahead
+                // of it so a multi-KB frame does not add a frame-time of
+                // jitter to the stream. Control stays FIFO either way, so
+                // an attachment is never reordered after the tool reply
+                // that references it
+                if (!outbound_control_queue_.empty() &&
+                        !(outbound_control_queue_.front().bulk && !outbound_audio_queue_.empty())) {
+                    message = std::move(outbound_control_queue_.front());
+                    outbound_control_queue_.pop_front();
+                    have_message = true;
+                } else if (!outbound_audio_queue_.empty()) {
+                    packet = std::move(outbound_audio_queue_.front());
+                    outbound_audio_queue_.pop_front();
+                } else {
+                    break;
+                }
+            }
+            int64_t send_start = esp_timer_get_time();
+            size_t bytes = 0;
+            if (have_message) {
+                bytes = message.data.size();
+                if (message.binary) {
+                    SendBinaryNow(message.data);
+                } else {
+                    SendText(message.data);
+                }
+                ReleaseControlBuffer(std::move(message.data));
+            } else if (packet != nullptr) {
+                bytes = packet->payload.size();
+                SendAudioNow(std::move(packet));
+            }
+            network_statistics_.RecordSendLatency(esp_timer_get_time() - send_start);
+            network_statistics_.packets_sent++;
+            network_statistics_.bytes_sent += bytes;
+            TRACE_EVENT(TracePoint::kProtoSend, bytes);
+        }
+    }
+    xSemaphoreGive(outbound_task_exited_);
+}
+
+void Protocol::StopOutboundTask() {
+    if (outbound_task_ == nullptr) {
+        return;
+    }
+    outbound_task_exit_ = true;
+    xTaskNotifyGive(outbound_task_);
+    xSemaphoreTake(outbound_task_exited_, pdMS_TO_TICKS(1000));
+    vSemaphoreDelete(outbound_task_exited_);
+    outbound_task_ = nullptr;
+    outbound_task_exited_ = nullptr;
+
+    std::lock_guard<std::mutex> lock(outbound_mutex_);
+    outbound_control_queue_.clear();
+    while (!outbound_audio_queue_.empty()) {
+        ReleaseAudioPacket(std::move(outbound_audio_queue_.front()));
+        outbound_audio_queue_.pop_front();
+    }
+}
+
+std::unique_ptr<AudioStreamPacket> Protocol::AcquireAudioPacket() {
+    std::lock_guard<std::mutex> lock(audio_packet_pool_mutex);
+    if (audio_packet_pool.empty()) {
+        return std::make_unique<AudioStreamPacket>();
+    }
+    auto packet = std::move(audio_packet_pool.front());
+    audio_packet_pool.pop_front();
+    return packet;
+}
+
+void Protocol::ReleaseAudioPacket(std::unique_ptr<AudioStreamPacket> packet) {
+    if (packet == nullptr) {
+        return;
+    }
+    packet->sample_rate = 0;
+    packet->frame_duration = 0;
+    packet->timestamp = 0;
+    packet->trace_time_us = 0;
+    packet->pcm_payload = false;
+    packet->payload.clear();
+
+    std::lock_guard<std::mutex> lock(audio_packet_pool_mutex);
+    if (audio_packet_pool.size() < kMaxPooledAudioPackets) {
+        audio_packet_pool.push_back(std::move(packet));
+    }
+}
+
+std::string Protocol::AcquireControlBuffer(size_t reserve) {
+    std::string buffer;
+    {
+        std::lock_guard<std::mutex> lock(control_buffer_pool_mutex);
+        if (!control_buffer_pool.empty()) {
+            buffer = std::move(control_buffer_pool.front());
+            control_buffer_pool.pop_front();
+        }
+    }
+    buffer.clear();
+    buffer.reserve(reserve);
+    return buffer;
+}
+
+void Protocol::ReleaseControlBuffer(std::string buffer) {
+    if (buffer.capacity() > kMaxPooledControlCapacity) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(control_buffer_pool_mutex);
+    if (control_buffer_pool.size() < kMaxPooledControlBuffers) {
+        control_buffer_pool.push_back(std::move(buffer));
+    }
+}
+
+void Protocol::CountIncoming(size_t bytes) {
+    network_statistics_.packets_received++;
+    network_statistics_.bytes_received += bytes;
+}
+
+void Protocol::DumpNetworkStatistics() {
+    ESP_LOGI(TAG, "net: sent %lu pkts / %llu bytes, received %lu pkts / %llu bytes, reconnects %lu",
+        (unsigned long)network_statistics_.packets_sent,
+        (unsigned long long)network_statistics_.bytes_sent,
+        (unsigned long)network_statistics_.packets_received,
+        (unsigned long long)network_statistics_.bytes_received,
+        (unsigned long)network_statistics_.reconnect_count);
+    ESP_LOGI(TAG, "net: send p50=%lu us p90=%lu us p99=%lu us (%lu calls), handshake rtt=%lld us",
+        (unsigned long)network_statistics_.SendLatencyPercentileUs(50),
+        (unsigned long)network_statistics_.SendLatencyPercentileUs(90),
+        (unsigned long)network_statistics_.SendLatencyPercentileUs(99),
+        (unsigned long)network_statistics_.send_count,
+        (long long)network_statistics_.last_handshake_rtt_us);
+}
+
 void Protocol::OnIncomingJson(std::function<void(const cJSON* root)> callback) {
     on_incoming_json_ = callback;
 }
 
-void Protocol::OnIncomingAudio(std::function<void(std::unique_ptr<AudioStreamPacket> packet)> callback) {
+void Protocol::OnIncomingState(std::function<void(const StateMessage& message)> callback) {
+    on_incoming_state_ = callback;
+}
+
+bool Protocol::DispatchStateMessage(const char* data, size_t len) {
+    if (on_incoming_state_ == nullptr) {
+        return false;
+    }
+    std::string_view json(data, len);
+    /* The scanner only understands flat objects without escape sequences;
+     * everything else goes through the full cJSON parser */
+    if (!IsFlatJsonObject(json)) {
+        return false;
+    }
+
+    StateMessage message;
+    if (!FindStringField(json, "type", message.type)) {
+        return false;
+    }
+    if (message.type != "tts" && message.type != "stt" && message.type != "llm") {
+        return false;
+    }
+    FindStringField(json, "state", message.state);
+    FindStringField(json, "text", message.text);
+    FindStringField(json, "emotion", message.emotion);
+    if (message.type == "stt") {
+        std::string delta;
+        if (FindStringField(json, "delta", delta)) {
+            std::string keep;
+            FindStringField(json, "delta_keep", keep);
+            message.text = ApplySttDelta(delta, keep.empty() ? -1 : atoi(keep.c_str()), message.text);
+        } else if (!message.text.empty()) {
+            // 全量文本：服务端没开增量模式，或一句话的最终确认
+            stt_text_ = message.text;
+        }
+    }
+    on_incoming_state_(message);
+    return true;
+}
+
+const std::string& Protocol::ApplySttDelta(const std::string& op, int keep_chars, const std::string& text) {
+    if (op == "append") {
+        stt_text_ += text;
+    } else if (op == "replace") {
+        if (keep_chars >= 0 && (size_t)keep_chars < stt_text_.size()) {
+            stt_text_.resize(keep_chars);
+        }
+        stt_text_ += text;
+    } else {
+        // 未知操作按全量处理，服务端升级后老固件仍能显示完整文本
+        stt_text_ = text;
+    }
+    return stt_text_;
+}
+
+void Protocol::OnIncomingAudio(Delegate<void(std::unique_ptr<AudioStreamPacket>)> callback) {
     on_incoming_audio_ = callback;
 }
 
@@ -40,22 +367,33 @@ void Protocol::SetError(const std::string& message) {
 }
 
 void Protocol::SendAbortSpeaking(AbortReason reason) {
-    std::string message = "{\"session_id\":\"" + session_id_ + "\",\"type\":\"abort\"";
+    std::string message = AcquireControlBuffer(64 + session_id_.size());
+    message += "{\"session_id\":\"";
+    message += session_id_;
+    message += "\",\"type\":\"abort\"";
     if (reason == kAbortReasonWakeWordDetected) {
         message += ",\"reason\":\"wake_word_detected\"";
     }
     message += "}";
-    SendText(message);
+    // Barge-in: jump ahead of everything already queued
+    EnqueueControl(std::move(message), true);
 }
 
 void Protocol::SendWakeWordDetected(const std::string& wake_word) {
-    std::string json = "{\"session_id\":\"" + session_id_ + 
-                      "\",\"type\":\"listen\",\"state\":\"detect\",\"text\":\"" + wake_word + "\"}";
-    SendText(json);
+    std::string json = AcquireControlBuffer(64 + session_id_.size() + wake_word.size());
+    json += "{\"session_id\":\"";
+    json += session_id_;
+    json += "\",\"type\":\"listen\",\"state\":\"detect\",\"text\":\"";
+    json += wake_word;
+    json += "\"}";
+    EnqueueControl(std::move(json));
 }
 
 void Protocol::SendStartListening(ListeningMode mode) {
-    std::string message = "{\"session_id\":\"" + session_id_ + "\"";
+    std::string message = AcquireControlBuffer(80 + session_id_.size());
+    message += "{\"session_id\":\"";
+    message += session_id_;
+    message += "\"";
     message += ",\"type\":\"listen\",\"state\":\"start\"";
     if (mode == kListeningModeRealtime) {
         message += ",\"mode\":\"realtime\"";
@@ -65,17 +403,37 @@ void Protocol::SendStartListening(ListeningMode mode) {
         message += ",\"mode\":\"manual\"";
     }
     message += "}";
-    SendText(message);
+    EnqueueControl(std::move(message));
 }
 
 void Protocol::SendStopListening() {
-    std::string message = "{\"session_id\":\"" + session_id_ + "\",\"type\":\"listen\",\"state\":\"stop\"}";
-    SendText(message);
+    std::string message = AcquireControlBuffer(64 + session_id_.size());
+    message += "{\"session_id\":\"";
+    message += session_id_;
+    message += "\",\"type\":\"listen\",\"state\":\"stop\"}";
+    EnqueueControl(std::move(message));
 }
 
 void Protocol::SendMcpMessage(const std::string& payload) {
-    std::string message = "{\"session_id\":\"" + session_id_ + "\",\"type\":\"mcp\",\"payload\":" + payload + "}";
-    SendText(message);
+    std::string message = AcquireControlBuffer(48 + session_id_.size() + payload.size());
+    message += "{\"session_id\":\"";
+    message += session_id_;
+    message += "\",\"type\":\"mcp\",\"payload\":";
+    message += payload;
+    message += "}";
+    EnqueueControl(std::move(message));
+}
+
+void Protocol::SendTelemetry(const std::string& subsystem, const std::string& payload) {
+    std::string message = AcquireControlBuffer(64 + session_id_.size() + subsystem.size() + payload.size());
+    message += "{\"session_id\":\"";
+    message += session_id_;
+    message += "\",\"type\":\"telemetry\",\"subsystem\":\"";
+    message += subsystem;
+    message += "\",\"data\":";
+    message += payload;
+    message += "}";
+    EnqueueControl(std::move(message));
 }
 
 bool Protocol::IsTimeout() const {
@@ -1,34 +1,75 @@
 #ifndef PROTOCOL_H
 #define PROTOCOL_H
 
+#include "wire_format.h"
+#include "delegate.h"
+
 #include <cJSON.h>
 #include <string>
 #include <functional>
 #include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <vector>
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+// Upper bound for the outbound audio lane; beyond this the link is behind
+// real time and dropping the oldest frame hurts less than growing the backlog
+#define MAX_QUEUED_OUTBOUND_AUDIO_PACKETS 30
+
+// Compile-time stringification for splicing numeric macros into the
+// fixed-shape message skeletons (hello, listen state)
+#define PROTOCOL_STR_IMPL(x) #x
+#define PROTOCOL_STR(x) PROTOCOL_STR_IMPL(x)
+
 struct AudioStreamPacket {
     int sample_rate = 0;
     int frame_duration = 0;
     uint32_t timestamp = 0;
+    // Local pipeline tracing stamp (esp_timer time), never sent on the wire
+    int64_t trace_time_us = 0;
+    // Local-only: payload is raw s16 PCM at sample_rate, skip the decoder
+    bool pcm_payload = false;
     std::vector<uint8_t> payload;
 };
 
-struct BinaryProtocol2 {
-    uint16_t version;
-    uint16_t type;          // Message type (0: OPUS, 1: JSON)
-    uint32_t reserved;      // Reserved for future use
-    uint32_t timestamp;     // Timestamp in milliseconds (used for server-side AEC)
-    uint32_t payload_size;  // Payload size in bytes
-    uint8_t payload[];      // Payload data
-} __attribute__((packed));
-
-struct BinaryProtocol3 {
-    uint8_t type;
-    uint8_t reserved;
-    uint16_t payload_size;
-    uint8_t payload[];
-} __attribute__((packed));
+/* High-frequency server state message (tts/stt/llm), extracted without
+ * building a cJSON DOM. Absent fields are empty. */
+struct StateMessage {
+    std::string type;
+    std::string state;
+    std::string text;
+    std::string emotion;
+};
+
+/*
+ * Transport health counters, kept by the protocol layer so "server slow"
+ * can be told apart from "radio slow" from the device side. The sender
+ * task counts the outbound direction and times how long each transport
+ * send call blocks; transports count their receive callbacks and record
+ * the hello round trip of each channel open.
+ */
+struct NetworkStatistics {
+    static constexpr int kNumBuckets = 20;
+
+    uint32_t packets_sent = 0;
+    uint32_t packets_received = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_received = 0;
+    uint32_t reconnect_count = 0;
+    int64_t last_handshake_rtt_us = -1;
+
+    // log2 buckets of transport send-call blocking time
+    uint32_t send_latency_buckets[kNumBuckets] = {0};
+    uint32_t send_count = 0;
+
+    void RecordSendLatency(int64_t us);
+    uint32_t SendLatencyPercentileUs(int percent) const;
+};
 
 enum AbortReason {
     kAbortReasonNone,
@@ -43,7 +84,7 @@ enum ListeningMode {
 
 class Protocol {
 public:
-    virtual ~Protocol() = default;
+    virtual ~Protocol();
 
     inline int server_sample_rate() const {
         return server_sample_rate_;
@@ -55,8 +96,19 @@ public:
         return session_id_;
     }
 
-    void OnIncomingAudio(std::function<void(std::unique_ptr<AudioStreamPacket> packet)> callback);
+    // 每包热路径回调，接线固定（见 Application::SetupProtocol），用
+    // Delegate 省掉逐包的类型擦除调用
+    void OnIncomingAudio(Delegate<void(std::unique_ptr<AudioStreamPacket>)> callback);
     void OnIncomingJson(std::function<void(const cJSON* root)> callback);
+    void OnIncomingState(std::function<void(const StateMessage& message)> callback);
+    /*
+     * STT 增量模式（hello 里的 text_delta 特性）：长听写时服务端不再
+     * 每次重发整句，而是发 "delta":"append"（追加 text）或
+     * "delta":"replace"（保留前 delta_keep 个字节后追加 text）。这里在
+     * 稳定缓冲里重建整句并返回；不带 delta 的全量消息直接覆盖缓冲。
+     * keep_chars 传 -1 表示消息里没带 delta_keep
+     */
+    const std::string& ApplySttDelta(const std::string& op, int keep_chars, const std::string& text);
     void OnAudioChannelOpened(std::function<void()> callback);
     void OnAudioChannelClosed(std::function<void()> callback);
     void OnNetworkError(std::function<void(const std::string& message)> callback);
@@ -67,31 +119,125 @@ public:
     virtual bool OpenAudioChannel() = 0;
     virtual void CloseAudioChannel() = 0;
     virtual bool IsAudioChannelOpened() const = 0;
-    virtual bool SendAudio(std::unique_ptr<AudioStreamPacket> packet) = 0;
+    /*
+     * Queues the packet on the outbound audio lane and returns immediately.
+     * Control messages (abort, listen state, MCP replies) travel on a
+     * separate lane that the sender task always drains first, so a large
+     * MCP reply in flight no longer delays barge-in behind queued frames.
+     */
+    bool SendAudio(std::unique_ptr<AudioStreamPacket> packet);
+    /*
+     * Sends a binary blob out-of-band on the control lane and returns its
+     * attachment id, so MCP tool results can reference raw bytes (camera
+     * JPEGs) instead of inflating them 33% with inline base64. Returns 0
+     * when the transport has no binary channel and the caller must fall
+     * back to base64.
+     */
+    virtual uint32_t SendBinaryAttachment(const std::string& data) { return 0; }
     virtual void SendWakeWordDetected(const std::string& wake_word);
     virtual void SendStartListening(ListeningMode mode);
     virtual void SendStopListening();
     virtual void SendAbortSpeaking(AbortReason reason);
     virtual void SendMcpMessage(const std::string& message);
+    /*
+     * 周期性指标上报（如唤醒词质量统计）。payload 必须是完整 JSON，
+     * 服务端按 subsystem 分流，走普通控制队列，不抢占实时消息。
+     */
+    virtual void SendTelemetry(const std::string& subsystem, const std::string& payload);
+
+    /*
+     * Pooled AudioStreamPacket shells for the receive path.
+     *
+     * The transport owns its receive buffer only for the duration of the data
+     * callback, so the one memcpy into the packet payload cannot be avoided.
+     * What can be avoided is the per-packet heap allocation: transports should
+     * build incoming packets with AcquireAudioPacket() and the consumer returns
+     * them with ReleaseAudioPacket() once decoded, so the packet shell (and the
+     * payload capacity, when the decoder has not taken it) is recycled.
+     */
+    static std::unique_ptr<AudioStreamPacket> AcquireAudioPacket();
+    static void ReleaseAudioPacket(std::unique_ptr<AudioStreamPacket> packet);
+
+    const NetworkStatistics& GetNetworkStatistics() const { return network_statistics_; }
+    void DumpNetworkStatistics();
 
 protected:
+    /*
+     * Fast path for the high-frequency tts/stt/llm state messages: scans the
+     * few needed string fields out of a flat JSON object without building a
+     * cJSON DOM, so the network task is not stalled by node-per-key
+     * allocation. Returns false (and leaves dispatch to the full parser)
+     * for every other message type, for nested or escaped payloads, or when
+     * no OnIncomingState handler is registered.
+     */
+    bool DispatchStateMessage(const char* data, size_t len);
+
     std::function<void(const cJSON* root)> on_incoming_json_;
-    std::function<void(std::unique_ptr<AudioStreamPacket> packet)> on_incoming_audio_;
+    std::function<void(const StateMessage& message)> on_incoming_state_;
+    Delegate<void(std::unique_ptr<AudioStreamPacket>)> on_incoming_audio_;
     std::function<void()> on_audio_channel_opened_;
     std::function<void()> on_audio_channel_closed_;
     std::function<void(const std::string& message)> on_network_error_;
     std::function<void()> on_connected_;
     std::function<void()> on_disconnected_;
 
+    NetworkStatistics network_statistics_;
+    // Transports call this from their receive callbacks
+    void CountIncoming(size_t bytes);
+
     int server_sample_rate_ = 24000;
     int server_frame_duration_ = 60;
     bool error_occurred_ = false;
     std::string session_id_;
+    // 当前听写句的重建缓冲（见 ApplySttDelta）
+    std::string stt_text_;
     std::chrono::time_point<std::chrono::steady_clock> last_incoming_time_;
 
     virtual bool SendText(const std::string& text) = 0;
+    virtual bool SendAudioNow(std::unique_ptr<AudioStreamPacket> packet) = 0;
     virtual void SetError(const std::string& message);
     virtual bool IsTimeout() const;
+
+    /*
+     * Outbound priority lanes. EnqueueControl(message, true) jumps the
+     * line (used by SendAbortSpeaking). Transports must call
+     * StopOutboundTask() at the top of their destructor, before the
+     * transport members the sender task writes through are torn down.
+     */
+    void EnqueueControl(std::string message, bool urgent = false);
+    void EnqueueBinary(std::string frame);
+    /*
+     * 控制消息缓冲池：Acquire 拿到一个保留了 reserve 容量的空串，往里
+     * 拼好 JSON 后 move 给 EnqueueControl；发送任务发完把容量还回池，
+     * 稳态下控制发送不再碰堆（AudioStreamPacket 池的同款做法）
+     */
+    static std::string AcquireControlBuffer(size_t reserve);
+    static void ReleaseControlBuffer(std::string buffer);
+    void StopOutboundTask();
+    // Raw binary writer for pre-framed attachment blobs; only transports
+    // that report a binary channel need to implement it
+    virtual bool SendBinaryNow(const std::string& frame) { return false; }
+
+private:
+    struct OutboundMessage {
+        std::string data;
+        bool binary = false;
+        // 大帧（工具列表、图片附件）：发送前先放行排队的音频，控制
+        // 消息之间仍保持 FIFO
+        bool bulk = false;
+    };
+    // 超过这个大小的非紧急控制消息按大帧处理
+    static constexpr size_t kBulkControlThreshold = 1024;
+
+    void EnsureOutboundTask();
+    void OutboundTask();
+
+    std::mutex outbound_mutex_;
+    std::deque<OutboundMessage> outbound_control_queue_;
+    std::deque<std::unique_ptr<AudioStreamPacket>> outbound_audio_queue_;
+    TaskHandle_t outbound_task_ = nullptr;
+    SemaphoreHandle_t outbound_task_exited_ = nullptr;
+    bool outbound_task_exit_ = false;
 };
 
 #endif // PROTOCOL_H
@@ -3,6 +3,7 @@
 #include "system_info.h"
 #include "application.h"
 #include "settings.h"
+#include "json_arena.h"
 
 #include <cstring>
 #include <cJSON.h>
@@ -12,11 +13,33 @@
 
 #define TAG "WS"
 
+// Keep-warm pings are spaced well below common NAT/TLS idle timeouts
+#define KEEP_WARM_TICK_SECONDS 10
+
 WebsocketProtocol::WebsocketProtocol() {
     event_group_handle_ = xEventGroupCreate();
+
+#if CONFIG_WEBSOCKET_KEEP_WARM_SECONDS > 0
+    esp_timer_create_args_t keep_warm_timer_args = {
+        .callback = [](void* arg) {
+            ((WebsocketProtocol*)arg)->OnKeepWarmTick();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "ws_keep_warm",
+        .skip_unhandled_events = true
+    };
+    esp_timer_create(&keep_warm_timer_args, &keep_warm_timer_);
+#endif
 }
 
 WebsocketProtocol::~WebsocketProtocol() {
+    // Stop the sender task while the transport it writes through still exists
+    StopOutboundTask();
+    if (keep_warm_timer_ != nullptr) {
+        esp_timer_stop(keep_warm_timer_);
+        esp_timer_delete(keep_warm_timer_);
+    }
     vEventGroupDelete(event_group_handle_);
 }
 
@@ -25,15 +48,17 @@ bool WebsocketProtocol::Start() {
     return true;
 }
 
-bool WebsocketProtocol::SendAudio(std::unique_ptr<AudioStreamPacket> packet) {
+bool WebsocketProtocol::SendAudioNow(std::unique_ptr<AudioStreamPacket> packet) {
     if (websocket_ == nullptr || !websocket_->IsConnected()) {
         return false;
     }
 
+    /* The WebSocket wrapper sends one contiguous buffer, so the header and
+     * payload are assembled in a frame buffer whose capacity is reused
+     * across packets instead of allocating a fresh string per frame */
     if (version_ == 2) {
-        std::string serialized;
-        serialized.resize(sizeof(BinaryProtocol2) + packet->payload.size());
-        auto bp2 = (BinaryProtocol2*)serialized.data();
+        send_buffer_.resize(sizeof(BinaryProtocol2) + packet->payload.size());
+        auto bp2 = (BinaryProtocol2*)send_buffer_.data();
         bp2->version = htons(version_);
         bp2->type = 0;
         bp2->reserved = 0;
@@ -41,22 +66,55 @@ bool WebsocketProtocol::SendAudio(std::unique_ptr<AudioStreamPacket> packet) {
         bp2->payload_size = htonl(packet->payload.size());
         memcpy(bp2->payload, packet->payload.data(), packet->payload.size());
 
-        return websocket_->Send(serialized.data(), serialized.size(), true);
+        return websocket_->Send(send_buffer_.data(), send_buffer_.size(), true);
     } else if (version_ == 3) {
-        std::string serialized;
-        serialized.resize(sizeof(BinaryProtocol3) + packet->payload.size());
-        auto bp3 = (BinaryProtocol3*)serialized.data();
+        send_buffer_.resize(sizeof(BinaryProtocol3) + packet->payload.size());
+        auto bp3 = (BinaryProtocol3*)send_buffer_.data();
         bp3->type = 0;
         bp3->reserved = 0;
         bp3->payload_size = htons(packet->payload.size());
         memcpy(bp3->payload, packet->payload.data(), packet->payload.size());
 
-        return websocket_->Send(serialized.data(), serialized.size(), true);
+        return websocket_->Send(send_buffer_.data(), send_buffer_.size(), true);
     } else {
         return websocket_->Send(packet->payload.data(), packet->payload.size(), true);
     }
 }
 
+uint32_t WebsocketProtocol::SendBinaryAttachment(const std::string& data) {
+    // Attachments need the version 2 framing: the type field distinguishes
+    // them from OPUS frames and the timestamp field carries the id
+    if (version_ != 2 || websocket_ == nullptr || !websocket_->IsConnected()) {
+        return 0;
+    }
+    uint32_t attachment_id = next_attachment_id_++;
+    if (next_attachment_id_ == 0) {
+        next_attachment_id_ = 1;
+    }
+
+    std::string frame;
+    frame.resize(sizeof(BinaryProtocol2) + data.size());
+    auto bp2 = (BinaryProtocol2*)frame.data();
+    bp2->version = htons(version_);
+    bp2->type = htons(2);
+    bp2->reserved = 0;
+    bp2->timestamp = htonl(attachment_id);
+    bp2->payload_size = htonl(data.size());
+    memcpy(bp2->payload, data.data(), data.size());
+
+    // Control lane keeps the attachment ordered before the tool reply
+    // that references it
+    EnqueueBinary(std::move(frame));
+    return attachment_id;
+}
+
+bool WebsocketProtocol::SendBinaryNow(const std::string& frame) {
+    if (websocket_ == nullptr || !websocket_->IsConnected()) {
+        return false;
+    }
+    return websocket_->Send(frame.data(), frame.size(), true);
+}
+
 bool WebsocketProtocol::SendText(const std::string& text) {
     if (websocket_ == nullptr || !websocket_->IsConnected()) {
         return false;
@@ -72,24 +130,106 @@ bool WebsocketProtocol::SendText(const std::string& text) {
 }
 
 bool WebsocketProtocol::IsAudioChannelOpened() const {
-    return websocket_ != nullptr && websocket_->IsConnected() && !error_occurred_ && !IsTimeout();
+    return audio_channel_opened_ && websocket_ != nullptr && websocket_->IsConnected() && !error_occurred_ && !IsTimeout();
 }
 
 void WebsocketProtocol::CloseAudioChannel() {
+#if CONFIG_WEBSOCKET_KEEP_WARM_SECONDS > 0
+    if (websocket_ != nullptr && websocket_->IsConnected() && !error_occurred_) {
+        // Park the connected socket instead of tearing it down, so the next
+        // OpenAudioChannel only redoes the hello exchange instead of
+        // DNS + TCP + TLS + upgrade. The idle budget bounds how long it stays.
+        audio_channel_opened_ = false;
+        keep_warm_seconds_left_ = CONFIG_WEBSOCKET_KEEP_WARM_SECONDS;
+        esp_timer_stop(keep_warm_timer_);
+        esp_timer_start_periodic(keep_warm_timer_, (uint64_t)KEEP_WARM_TICK_SECONDS * 1000000);
+        if (on_audio_channel_closed_ != nullptr) {
+            on_audio_channel_closed_();
+        }
+        return;
+    }
+#endif
+    audio_channel_opened_ = false;
     websocket_.reset();
+    if (on_audio_channel_closed_ != nullptr) {
+        on_audio_channel_closed_();
+    }
+}
+
+void WebsocketProtocol::OnKeepWarmTick() {
+    // Runs in the esp_timer task; all socket work is pushed to the main loop
+    if (audio_channel_opened_) {
+        esp_timer_stop(keep_warm_timer_);
+        return;
+    }
+    if (websocket_ == nullptr || !websocket_->IsConnected()) {
+        esp_timer_stop(keep_warm_timer_);
+        return;
+    }
+    keep_warm_seconds_left_ -= KEEP_WARM_TICK_SECONDS;
+    if (keep_warm_seconds_left_ <= 0) {
+        ESP_LOGI(TAG, "Keep-warm idle budget expired, closing websocket");
+        esp_timer_stop(keep_warm_timer_);
+        Application::GetInstance().Schedule([this]() {
+            if (!audio_channel_opened_ && websocket_ != nullptr) {
+                websocket_.reset();
+            }
+        });
+        return;
+    }
+    // Lightweight application-level ping to keep NAT mappings and the TLS
+    // session alive while parked; the wrapper does not expose WS PING frames
+    Application::GetInstance().Schedule([this]() {
+        if (!audio_channel_opened_ && websocket_ != nullptr && websocket_->IsConnected()) {
+            websocket_->Send("{\"session_id\":\"" + session_id_ + "\",\"type\":\"ping\"}");
+        }
+    });
 }
 
 bool WebsocketProtocol::OpenAudioChannel() {
     Settings settings("websocket", false);
     std::string url = settings.GetString("url");
     std::string token = settings.GetString("token");
+    // 换了服务器就作废上一个会话的恢复令牌
+    if (url != resume_url_) {
+        resume_token_.clear();
+        resume_url_ = url;
+    }
+
     int version = settings.GetInt("version");
     if (version != 0) {
+        // 配置显式固定了版本，不参与协商
         version_ = version;
+        version_negotiable_ = false;
+    } else {
+        // 未固定版本时主动提议紧凑的 v3 头（4 字节）；需要服务端 AEC
+        // 时间戳时提议 v2。最终以服务端 hello 回的 version 为准，老
+        // 服务端不回这个字段则退回裸 Opus 帧（v1），见 ParseServerHello
+#if CONFIG_USE_SERVER_AEC
+        version_ = 2;
+#else
+        version_ = 3;
+#endif
+        version_negotiable_ = true;
     }
 
     error_occurred_ = false;
 
+#if CONFIG_WEBSOCKET_KEEP_WARM_SECONDS > 0
+    if (websocket_ != nullptr && websocket_->IsConnected()) {
+        esp_timer_stop(keep_warm_timer_);
+        ESP_LOGI(TAG, "Reusing warm websocket connection");
+        if (ExchangeHello(3000)) {
+            return true;
+        }
+        // The parked socket went stale (half-open NAT drop, server restart);
+        // fall back to the full reconnect below
+        ESP_LOGW(TAG, "Warm websocket is stale, reconnecting");
+        websocket_.reset();
+        error_occurred_ = false;
+    }
+#endif
+
     auto network = Board::GetInstance().GetNetwork();
     websocket_ = network->CreateWebSocket(1);
     if (websocket_ == nullptr) {
@@ -109,8 +249,15 @@ bool WebsocketProtocol::OpenAudioChannel() {
     websocket_->SetHeader("Client-Id", Board::GetInstance().GetUuid().c_str());
 
     websocket_->OnData([this](const char* data, size_t len, bool binary) {
+        CountIncoming(len);
         if (binary) {
-            if (on_incoming_audio_ != nullptr) {
+            if (on_incoming_audio_) {
+                // Build the packet from the pool: assign() reuses the recycled
+                // payload capacity, so the only cost left is the single memcpy
+                // out of the transport's callback-scoped receive buffer.
+                auto packet = AcquireAudioPacket();
+                packet->sample_rate = server_sample_rate_;
+                packet->frame_duration = server_frame_duration_;
                 if (version_ == 2) {
                     BinaryProtocol2* bp2 = (BinaryProtocol2*)data;
                     bp2->version = ntohs(bp2->version);
@@ -118,34 +265,27 @@ bool WebsocketProtocol::OpenAudioChannel() {
                     bp2->timestamp = ntohl(bp2->timestamp);
                     bp2->payload_size = ntohl(bp2->payload_size);
                     auto payload = (uint8_t*)bp2->payload;
-                    on_incoming_audio_(std::make_unique<AudioStreamPacket>(AudioStreamPacket{
-                        .sample_rate = server_sample_rate_,
-                        .frame_duration = server_frame_duration_,
-                        .timestamp = bp2->timestamp,
-                        .payload = std::vector<uint8_t>(payload, payload + bp2->payload_size)
-                    }));
+                    packet->timestamp = bp2->timestamp;
+                    packet->payload.assign(payload, payload + bp2->payload_size);
                 } else if (version_ == 3) {
                     BinaryProtocol3* bp3 = (BinaryProtocol3*)data;
-                    bp3->type = bp3->type;
                     bp3->payload_size = ntohs(bp3->payload_size);
                     auto payload = (uint8_t*)bp3->payload;
-                    on_incoming_audio_(std::make_unique<AudioStreamPacket>(AudioStreamPacket{
-                        .sample_rate = server_sample_rate_,
-                        .frame_duration = server_frame_duration_,
-                        .timestamp = 0,
-                        .payload = std::vector<uint8_t>(payload, payload + bp3->payload_size)
-                    }));
+                    packet->payload.assign(payload, payload + bp3->payload_size);
                 } else {
-                    on_incoming_audio_(std::make_unique<AudioStreamPacket>(AudioStreamPacket{
-                        .sample_rate = server_sample_rate_,
-                        .frame_duration = server_frame_duration_,
-                        .timestamp = 0,
-                        .payload = std::vector<uint8_t>((uint8_t*)data, (uint8_t*)data + len)
-                    }));
+                    packet->payload.assign((uint8_t*)data, (uint8_t*)data + len);
                 }
+                on_incoming_audio_(std::move(packet));
             }
         } else {
-            // Parse JSON data
+            /* State messages (tts/stt/llm) bypass the DOM parser */
+            if (DispatchStateMessage(data, len)) {
+                last_incoming_time_ = std::chrono::steady_clock::now();
+                return;
+            }
+            // Parse JSON data; the whole parse tree comes from a per-message
+            // arena and is returned in one piece when the callback finishes
+            JsonArena arena;
             auto root = cJSON_Parse(data);
             auto type = cJSON_GetObjectItem(root, "type");
             if (cJSON_IsString(type)) {
@@ -166,8 +306,13 @@ bool WebsocketProtocol::OpenAudioChannel() {
 
     websocket_->OnDisconnected([this]() {
         ESP_LOGI(TAG, "Websocket disconnected");
-        if (on_audio_channel_closed_ != nullptr) {
-            on_audio_channel_closed_();
+        // Only forward once: an explicit CloseAudioChannel (or a parked
+        // keep-warm socket dropping) has already notified the application
+        if (audio_channel_opened_) {
+            audio_channel_opened_ = false;
+            if (on_audio_channel_closed_ != nullptr) {
+                on_audio_channel_closed_();
+            }
         }
     });
 
@@ -177,21 +322,57 @@ bool WebsocketProtocol::OpenAudioChannel() {
         SetError(Lang::Strings::SERVER_NOT_CONNECTED);
         return false;
     }
+    if (has_connected_) {
+        network_statistics_.reconnect_count++;
+    }
+    has_connected_ = true;
+
+    if (!ExchangeHello(10000)) {
+        SetError(Lang::Strings::SERVER_TIMEOUT);
+        return false;
+    }
+    return true;
+}
+
+// Sends the client hello and waits for the server hello. Kept free of
+// SetError so the warm-reuse path can fail over to a full reconnect without
+// raising a user-visible network error.
+bool WebsocketProtocol::ExchangeHello(int timeout_ms) {
+    xEventGroupClearBits(event_group_handle_, WEBSOCKET_PROTOCOL_SERVER_HELLO_EVENT);
+
+    // 恢复令牌在手时用上次协商好的帧格式版本发 hello，不重新提议
+    if (!resume_token_.empty() && version_negotiable_ && resume_version_ != 0) {
+        version_ = resume_version_;
+    }
 
-    // Send hello message to describe the client
     auto message = GetHelloMessage();
-    if (!SendText(message)) {
+    int64_t hello_sent_time = esp_timer_get_time();
+    if (!websocket_->Send(message)) {
+        ESP_LOGE(TAG, "Failed to send hello message");
         return false;
     }
 
+    // 会话恢复快速通路：令牌、session_id、音频参数、帧格式版本都还是
+    // 上次会话的缓存，不等服务端 hello 即放行音频。服务端拒绝恢复时
+    // 会照常回全量 hello，ParseServerHello 在线纠正这些参数
+    if (!resume_token_.empty() && !session_id_.empty()) {
+        ESP_LOGI(TAG, "Resuming session %s without waiting for server hello", session_id_.c_str());
+        audio_channel_opened_ = true;
+        if (on_audio_channel_opened_ != nullptr) {
+            on_audio_channel_opened_();
+        }
+        return true;
+    }
+
     // Wait for server hello
-    EventBits_t bits = xEventGroupWaitBits(event_group_handle_, WEBSOCKET_PROTOCOL_SERVER_HELLO_EVENT, pdTRUE, pdFALSE, pdMS_TO_TICKS(10000));
+    EventBits_t bits = xEventGroupWaitBits(event_group_handle_, WEBSOCKET_PROTOCOL_SERVER_HELLO_EVENT, pdTRUE, pdFALSE, pdMS_TO_TICKS(timeout_ms));
     if (!(bits & WEBSOCKET_PROTOCOL_SERVER_HELLO_EVENT)) {
         ESP_LOGE(TAG, "Failed to receive server hello");
-        SetError(Lang::Strings::SERVER_TIMEOUT);
         return false;
     }
+    network_statistics_.last_handshake_rtt_us = esp_timer_get_time() - hello_sent_time;
 
+    audio_channel_opened_ = true;
     if (on_audio_channel_opened_ != nullptr) {
         on_audio_channel_opened_();
     }
@@ -200,27 +381,25 @@ bool WebsocketProtocol::OpenAudioChannel() {
 }
 
 std::string WebsocketProtocol::GetHelloMessage() {
-    // keys: message type, version, audio_params (format, sample_rate, channels)
-    cJSON* root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "type", "hello");
-    cJSON_AddNumberToObject(root, "version", version_);
-    cJSON* features = cJSON_CreateObject();
+    /* Fixed-shape message: everything except the negotiated protocol
+     * version is known at compile time, so the skeleton is assembled by
+     * the preprocessor and only the version is spliced in at runtime,
+     * instead of building and printing a cJSON tree on every channel open */
+    std::string message = "{\"type\":\"hello\",\"version\":";
+    message += std::to_string(version_);
+    if (!resume_token_.empty()) {
+        message += ",\"resume_token\":\"" + resume_token_ + "\"";
+    }
+    message +=
+        ",\"features\":{"
 #if CONFIG_USE_SERVER_AEC
-    cJSON_AddBoolToObject(features, "aec", true);
+        "\"aec\":true,"
 #endif
-    cJSON_AddBoolToObject(features, "mcp", true);
-    cJSON_AddItemToObject(root, "features", features);
-    cJSON_AddStringToObject(root, "transport", "websocket");
-    cJSON* audio_params = cJSON_CreateObject();
-    cJSON_AddStringToObject(audio_params, "format", "opus");
-    cJSON_AddNumberToObject(audio_params, "sample_rate", 16000);
-    cJSON_AddNumberToObject(audio_params, "channels", 1);
-    cJSON_AddNumberToObject(audio_params, "frame_duration", OPUS_FRAME_DURATION_MS);
-    cJSON_AddItemToObject(root, "audio_params", audio_params);
-    auto json_str = cJSON_PrintUnformatted(root);
-    std::string message(json_str);
-    cJSON_free(json_str);
-    cJSON_Delete(root);
+        "\"text_delta\":true,"
+        "\"mcp\":true},"
+        "\"transport\":\"websocket\","
+        "\"audio_params\":{\"format\":\"opus\",\"sample_rate\":16000,"
+        "\"channels\":1,\"frame_duration\":" PROTOCOL_STR(OPUS_FRAME_DURATION_MS) "}}";
     return message;
 }
 
@@ -231,6 +410,18 @@ void WebsocketProtocol::ParseServerHello(const cJSON* root) {
         return;
     }
 
+    if (version_negotiable_) {
+        // 版本协商收尾：采用服务端 hello 回的 version；老服务端不带
+        // 这个字段，退回裸 Opus 帧保证互通
+        auto version = cJSON_GetObjectItem(root, "version");
+        if (cJSON_IsNumber(version) && version->valueint >= 1 && version->valueint <= 3) {
+            version_ = version->valueint;
+        } else {
+            version_ = 1;
+        }
+        ESP_LOGI(TAG, "Negotiated binary protocol version: %d", version_);
+    }
+
     auto session_id = cJSON_GetObjectItem(root, "session_id");
     if (cJSON_IsString(session_id)) {
         session_id_ = session_id->valuestring;
@@ -249,5 +440,13 @@ void WebsocketProtocol::ParseServerHello(const cJSON* root) {
         }
     }
 
+    // 支持会话恢复的服务端在 hello 里下发 resume_token，缓存到下次
+    // 重连；随令牌一起记住协商结果，恢复时沿用
+    auto resume_token = cJSON_GetObjectItem(root, "resume_token");
+    if (cJSON_IsString(resume_token)) {
+        resume_token_ = resume_token->valuestring;
+        resume_version_ = version_;
+    }
+
     xEventGroupSetBits(event_group_handle_, WEBSOCKET_PROTOCOL_SERVER_HELLO_EVENT);
 }
@@ -5,6 +5,7 @@
 #include "protocol.h"
 
 #include <web_socket.h>
+#include <esp_timer.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/event_groups.h>
 
@@ -16,8 +17,8 @@ public:
     ~WebsocketProtocol();
 
     bool Start() override;
-    bool SendAudio(std::unique_ptr<AudioStreamPacket> packet) override;
     bool OpenAudioChannel() override;
+    uint32_t SendBinaryAttachment(const std::string& data) override;
     void CloseAudioChannel() override;
     bool IsAudioChannelOpened() const override;
 
@@ -25,10 +26,35 @@ private:
     EventGroupHandle_t event_group_handle_;
     std::unique_ptr<WebSocket> websocket_;
     int version_ = 1;
+    // 配置未固定版本时 version_ 只是发给服务端的提议，最终以服务端
+    // hello 回的 version 为准（见 ParseServerHello）
+    bool version_negotiable_ = false;
+    /* 会话恢复：服务端 hello 里下发的 resume_token 缓存在内存里，对同
+     * 一 URL 重连时随 hello 带回去。持有令牌时不等服务端 hello 就放行
+     * 音频，参数沿用上次会话缓存；服务端拒绝恢复会回全量 hello，
+     * ParseServerHello 就地纠正 */
+    std::string resume_token_;
+    std::string resume_url_;
+    int resume_version_ = 0;
+    /* Reused frame buffer for the versioned binary framing; SendAudio has a
+     * single caller, so the capacity persists across packets */
+    std::string send_buffer_;
+    /* Logical channel state: with keep-warm the socket can stay connected
+     * after CloseAudioChannel, so IsAudioChannelOpened cannot rely on the
+     * transport state alone */
+    bool audio_channel_opened_ = false;
+    esp_timer_handle_t keep_warm_timer_ = nullptr;
+    int keep_warm_seconds_left_ = 0;
+    uint32_t next_attachment_id_ = 1;
+    bool has_connected_ = false;
 
     void ParseServerHello(const cJSON* root);
     bool SendText(const std::string& text) override;
+    bool SendAudioNow(std::unique_ptr<AudioStreamPacket> packet) override;
+    bool SendBinaryNow(const std::string& frame) override;
     std::string GetHelloMessage();
+    bool ExchangeHello(int timeout_ms);
+    void OnKeepWarmTick();
 };
 
 #endif
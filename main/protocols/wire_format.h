@@ -0,0 +1,76 @@
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <string_view>
+
+/*
+ * 线上格式与无依赖的扁平 JSON 扫描器。只依赖标准库，设备侧的协议层和
+ * 主机侧的回放基准（scripts/protocol_replay）共用同一份定义，改格式时
+ * 两边不会漂移。
+ */
+
+struct BinaryProtocol2 {
+    uint16_t version;
+    uint16_t type;          // Message type (0: OPUS, 1: JSON, 2: binary attachment)
+    uint32_t reserved;      // Reserved for future use
+    uint32_t timestamp;     // Timestamp in milliseconds (used for server-side AEC)
+    uint32_t payload_size;  // Payload size in bytes
+    uint8_t payload[];      // Payload data
+} __attribute__((packed));
+
+struct BinaryProtocol3 {
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t payload_size;
+    uint8_t payload[];
+} __attribute__((packed));
+
+// 扫描器的适用前提：没有转义序列的单层对象。不满足时调用方必须退回
+// 完整的 cJSON 解析
+inline bool IsFlatJsonObject(const std::string_view& json) {
+    if (json.find('\\') != std::string_view::npos) {
+        return false;
+    }
+    size_t brace = json.find('{');
+    if (brace == std::string_view::npos ||
+        json.find('{', brace + 1) != std::string_view::npos ||
+        json.find('[') != std::string_view::npos) {
+        return false;
+    }
+    return true;
+}
+
+// Extracts a top-level string field from a flat JSON object. Only valid
+// when the caller has ruled out escape sequences and nested containers.
+inline bool FindStringField(const std::string_view& json, const char* key, std::string& value) {
+    char pattern[24];
+    snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+    size_t pos = json.find(pattern);
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+    pos += strlen(pattern);
+    while (pos < json.size() && isspace((unsigned char)json[pos])) pos++;
+    if (pos >= json.size() || json[pos] != ':') {
+        return false;
+    }
+    pos++;
+    while (pos < json.size() && isspace((unsigned char)json[pos])) pos++;
+    if (pos >= json.size() || json[pos] != '"') {
+        return false;
+    }
+    pos++;
+    size_t end = json.find('"', pos);
+    if (end == std::string_view::npos) {
+        return false;
+    }
+    value.assign(json.data() + pos, end - pos);
+    return true;
+}
+
+#endif // WIRE_FORMAT_H
@@ -1,24 +1,431 @@
 #include "settings.h"
+#include "flash_op_monitor.h"
 
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <nvs_flash.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <vector>
 
 #define TAG "Settings"
 
+namespace {
+
+/*
+ * 写操作先进内存里的待写队列，由低优先级任务批量落盘，NVS 写入和提交的
+ * 毫秒级停顿不再落在调用方（LVGL、音频）任务上；读操作先查待写队列，保证
+ * 写后立即读能看到新值。重启前必须调用 Settings::FlushAll() 清空队列。
+ *
+ * 读路径：某命名空间第一次被打开时，整个命名空间的条目一次性迭代进 RAM
+ * 快照，之后所有读都是内存查表，开机阶段几十次逐 key 的 NVS 查找收敛成
+ * 每个命名空间一趟；写入在进待写队列的同时同步更新快照，快照始终是
+ * 最新值，落盘什么时候发生对读不可见。
+ */
+class SettingsStore {
+public:
+    struct PendingOp {
+        enum Type { kSetString, kSetInt, kSetBool, kEraseKey, kEraseAll };
+        Type type;
+        std::string key;
+        std::string string_value;
+        int32_t int_value = 0;
+    };
+
+    struct CachedEntry {
+        nvs_type_t type;
+        int32_t int_value = 0;
+        std::string string_value;
+    };
+
+    enum class SnapshotResult { kNoSnapshot, kMissing, kFound };
+
+    static SettingsStore& GetInstance() {
+        static SettingsStore instance;
+        return instance;
+    }
+
+    // 命名空间快照就绪返回 true；NVS 异常时返回 false，调用方退回逐 key 直读
+    bool EnsureSnapshot(const std::string& ns) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (snapshots_.count(ns)) {
+                return true;
+            }
+        }
+        Snapshot snapshot;
+        nvs_handle_t handle = 0;
+        esp_err_t err = nvs_open(ns.c_str(), NVS_READONLY, &handle);
+        if (err == ESP_OK) {
+            nvs_iterator_t it = nullptr;
+            esp_err_t res = nvs_entry_find(NVS_DEFAULT_PART_NAME, ns.c_str(), NVS_TYPE_ANY, &it);
+            while (res == ESP_OK) {
+                nvs_entry_info_t info;
+                nvs_entry_info(it, &info);
+                CachedEntry entry = {info.type};
+                bool ok = false;
+                switch (info.type) {
+                    case NVS_TYPE_I32:
+                        ok = nvs_get_i32(handle, info.key, &entry.int_value) == ESP_OK;
+                        break;
+                    case NVS_TYPE_U8: {
+                        uint8_t value;
+                        ok = nvs_get_u8(handle, info.key, &value) == ESP_OK;
+                        entry.int_value = value;
+                        break;
+                    }
+                    case NVS_TYPE_STR: {
+                        size_t length = 0;
+                        if (nvs_get_str(handle, info.key, nullptr, &length) == ESP_OK) {
+                            entry.string_value.resize(length);
+                            ok = nvs_get_str(handle, info.key, entry.string_value.data(), &length) == ESP_OK;
+                            while (!entry.string_value.empty() && entry.string_value.back() == '\0') {
+                                entry.string_value.pop_back();
+                            }
+                        }
+                        break;
+                    }
+                    default:
+                        // blob 等类型没有对应的 getter，不进快照
+                        break;
+                }
+                if (ok) {
+                    snapshot.emplace(info.key, std::move(entry));
+                }
+                res = nvs_entry_next(&it);
+            }
+            nvs_release_iterator(it);
+            nvs_close(handle);
+        } else if (err != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGW(TAG, "Failed to snapshot namespace %s: %s", ns.c_str(), esp_err_to_name(err));
+            return false;
+        }
+        // 不存在的命名空间记成空快照，读全部走默认值，不再碰 NVS
+        std::lock_guard<std::mutex> lock(mutex_);
+        snapshots_.emplace(ns, std::move(snapshot));
+        return true;
+    }
+
+    SnapshotResult Query(const std::string& ns, const std::string& key, CachedEntry& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto snapshot = snapshots_.find(ns);
+        if (snapshot == snapshots_.end()) {
+            return SnapshotResult::kNoSnapshot;
+        }
+        auto entry = snapshot->second.find(key);
+        if (entry == snapshot->second.end()) {
+            return SnapshotResult::kMissing;
+        }
+        out = entry->second;
+        return SnapshotResult::kFound;
+    }
+
+    void Push(const std::string& ns, PendingOp op) {
+        TaskHandle_t worker;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto snapshot = snapshots_.find(ns);
+            if (snapshot != snapshots_.end()) {
+                ApplyToSnapshot(snapshot->second, op);
+            }
+            auto& ops = pending_[ns];
+            if (op.type == PendingOp::kEraseAll) {
+                ops.clear();
+            } else {
+                // 同一个 key 连续写入只保留最后一次（比如音量滑条拖动）
+                ops.erase(std::remove_if(ops.begin(), ops.end(), [&op](const PendingOp& o) {
+                    return o.type != PendingOp::kEraseAll && o.key == op.key;
+                }), ops.end());
+            }
+            ops.push_back(std::move(op));
+            if (worker_ == nullptr) {
+                xTaskCreate([](void* arg) {
+                    static_cast<SettingsStore*>(arg)->WorkerLoop();
+                }, "settings", 4096, this, 1, &worker_);
+            }
+            worker = worker_;
+        }
+        xTaskNotifyGive(worker);
+    }
+
+    // 查询 key 在待写队列中的最新状态，命中返回 true
+    bool Lookup(const std::string& ns, const std::string& key, PendingOp& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pending_.find(ns);
+        if (it == pending_.end()) {
+            return false;
+        }
+        for (auto op = it->second.rbegin(); op != it->second.rend(); ++op) {
+            if (op->type == PendingOp::kEraseAll || op->key == key) {
+                out = *op;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Flush() {
+        std::map<std::string, std::vector<PendingOp>> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending.swap(pending_);
+        }
+        for (auto& [ns, ops] : pending) {
+            nvs_handle_t handle = 0;
+            if (nvs_open(ns.c_str(), NVS_READWRITE, &handle) != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to open namespace %s for writing", ns.c_str());
+                continue;
+            }
+            for (auto& op : ops) {
+                switch (op.type) {
+                    case PendingOp::kSetString:
+                        ESP_ERROR_CHECK(nvs_set_str(handle, op.key.c_str(), op.string_value.c_str()));
+                        break;
+                    case PendingOp::kSetInt:
+                        ESP_ERROR_CHECK(nvs_set_i32(handle, op.key.c_str(), op.int_value));
+                        break;
+                    case PendingOp::kSetBool:
+                        ESP_ERROR_CHECK(nvs_set_u8(handle, op.key.c_str(), op.int_value ? 1 : 0));
+                        break;
+                    case PendingOp::kEraseKey: {
+                        auto ret = nvs_erase_key(handle, op.key.c_str());
+                        if (ret != ESP_ERR_NVS_NOT_FOUND) {
+                            ESP_ERROR_CHECK(ret);
+                        }
+                        break;
+                    }
+                    case PendingOp::kEraseAll:
+                        ESP_ERROR_CHECK(nvs_erase_all(handle));
+                        break;
+                }
+            }
+            {
+                // 提交耗时进 flash 监视：排查写盘与音频爆音的时间耦合
+                FlashOpScope scope(FlashOpMonitor::kNvsCommit);
+                int64_t start_us = esp_timer_get_time();
+                ESP_ERROR_CHECK(nvs_commit(handle));
+                RecordCommit(esp_timer_get_time() - start_us);
+            }
+            nvs_close(handle);
+        }
+    }
+
+    /*
+     * NVS 健康度。页回收（compaction）的停顿随磨损变长，老设备上量到过
+     * 80ms 的提交，而之前没有任何东西在看它：这里常驻记录提交时延的
+     * EWMA/最大值，配合 nvs_get_stats 的条目占用，周期调试节拍里打印、
+     * 随遥测上报。劣化时在空闲态主动消耗一批条目逼 NVS 现在做页回收，
+     * 别等到用户拖音量条的那次提交
+     */
+    void RecordCommit(int64_t duration_us) {
+        commit_count_.fetch_add(1, std::memory_order_relaxed);
+        uint32_t ewma = commit_ewma_us_.load(std::memory_order_relaxed);
+        commit_ewma_us_.store(ewma + ((uint32_t)duration_us - ewma) / 8, std::memory_order_relaxed);
+        uint32_t max = commit_max_us_.load(std::memory_order_relaxed);
+        while ((uint32_t)duration_us > max &&
+               !commit_max_us_.compare_exchange_weak(max, (uint32_t)duration_us,
+                                                     std::memory_order_relaxed)) {
+        }
+    }
+
+    void DumpHealth() {
+        uint32_t count = commit_count_.load(std::memory_order_relaxed);
+        bool degraded = IsDegraded();
+        // 没有新提交且不劣化时保持安静
+        if (count == last_dump_commit_count_ && !degraded) {
+            return;
+        }
+        last_dump_commit_count_ = count;
+        nvs_stats_t stats;
+        if (nvs_get_stats(NULL, &stats) != ESP_OK) {
+            return;
+        }
+        ESP_LOGI(TAG, "nvs: %u/%u entries used, %u ns, %lu commits, ewma %lu us, max %lu us",
+                 stats.used_entries, stats.total_entries, stats.namespace_count,
+                 (unsigned long)count,
+                 (unsigned long)commit_ewma_us_.load(std::memory_order_relaxed),
+                 (unsigned long)commit_max_us_.load(std::memory_order_relaxed));
+        if (degraded) {
+            ESP_LOGW(TAG, "nvs health degraded (slow commits or low free entries)");
+        }
+    }
+
+    std::string GetHealthJson() {
+        uint32_t count = commit_count_.load(std::memory_order_relaxed);
+        if (count == 0) {
+            return "";
+        }
+        nvs_stats_t stats;
+        if (nvs_get_stats(NULL, &stats) != ESP_OK) {
+            return "";
+        }
+        char buffer[192];
+        snprintf(buffer, sizeof(buffer),
+                 "{\"used\":%u,\"free\":%u,\"total\":%u,\"namespaces\":%u,"
+                 "\"commits\":%lu,\"commit_ewma_us\":%lu,\"commit_max_us\":%lu}",
+                 stats.used_entries, stats.free_entries, stats.total_entries,
+                 stats.namespace_count, (unsigned long)count,
+                 (unsigned long)commit_ewma_us_.load(std::memory_order_relaxed),
+                 (unsigned long)commit_max_us_.load(std::memory_order_relaxed));
+        return buffer;
+    }
+
+    void CompactIfDegraded() {
+        // 最多每 24 小时做一次，维护本身也是写放大
+        int64_t now_us = esp_timer_get_time();
+        if (last_gc_us_ != 0 && now_us - last_gc_us_ < 24LL * 3600 * 1000000) {
+            return;
+        }
+        if (!IsDegraded()) {
+            return;
+        }
+        last_gc_us_ = now_us;
+
+        nvs_stats_t before;
+        if (nvs_get_stats(NULL, &before) != ESP_OK) {
+            return;
+        }
+        // 向临时命名空间写入再删除一批条目：消耗空闲槽位，逼 NVS 在
+        // 这次（空闲态的）提交里做页搬移和擦除
+        nvs_handle_t handle;
+        if (nvs_open("nvs_gc", NVS_READWRITE, &handle) != ESP_OK) {
+            return;
+        }
+        for (int i = 0; i < 16; i++) {
+            char key[8];
+            snprintf(key, sizeof(key), "k%d", i);
+            nvs_set_u32(handle, key, i);
+        }
+        {
+            FlashOpScope scope(FlashOpMonitor::kNvsCommit);
+            nvs_commit(handle);
+        }
+        nvs_erase_all(handle);
+        {
+            FlashOpScope scope(FlashOpMonitor::kNvsCommit);
+            nvs_commit(handle);
+        }
+        nvs_close(handle);
+
+        nvs_stats_t after;
+        if (nvs_get_stats(NULL, &after) == ESP_OK) {
+            ESP_LOGI(TAG, "Idle NVS maintenance: free entries %u -> %u",
+                     before.free_entries, after.free_entries);
+        }
+    }
+
+private:
+    using Snapshot = std::map<std::string, CachedEntry>;
+
+    // 提交 EWMA 超过 20ms 或空闲条目低于 1/5 视为劣化
+    bool IsDegraded() {
+        if (commit_count_.load(std::memory_order_relaxed) > 0 &&
+            commit_ewma_us_.load(std::memory_order_relaxed) > 20000) {
+            return true;
+        }
+        nvs_stats_t stats;
+        return nvs_get_stats(NULL, &stats) == ESP_OK &&
+               stats.free_entries * 5 < stats.total_entries;
+    }
+
+    // 调用方持有 mutex_
+    void ApplyToSnapshot(Snapshot& snapshot, const PendingOp& op) {
+        switch (op.type) {
+            case PendingOp::kSetString:
+                snapshot[op.key] = {NVS_TYPE_STR, 0, op.string_value};
+                break;
+            case PendingOp::kSetInt:
+                snapshot[op.key] = {NVS_TYPE_I32, op.int_value};
+                break;
+            case PendingOp::kSetBool:
+                snapshot[op.key] = {NVS_TYPE_U8, op.int_value};
+                break;
+            case PendingOp::kEraseKey:
+                snapshot.erase(op.key);
+                break;
+            case PendingOp::kEraseAll:
+                snapshot.clear();
+                break;
+        }
+    }
+
+    void WorkerLoop() {
+        while (true) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            // 稍等一会儿，把同一阵写入合并成一次落盘
+            vTaskDelay(pdMS_TO_TICKS(200));
+            ulTaskNotifyTake(pdTRUE, 0);
+            Flush();
+        }
+    }
+
+    std::mutex mutex_;
+    std::map<std::string, std::vector<PendingOp>> pending_;
+    std::map<std::string, Snapshot> snapshots_;
+    TaskHandle_t worker_ = nullptr;
+
+    std::atomic<uint32_t> commit_count_{0};
+    std::atomic<uint32_t> commit_ewma_us_{0};
+    std::atomic<uint32_t> commit_max_us_{0};
+    uint32_t last_dump_commit_count_ = 0;   // 只在调试节拍（主循环）上读写
+    int64_t last_gc_us_ = 0;                // 同上
+};
+
+}  // namespace
+
 Settings::Settings(const std::string& ns, bool read_write) : ns_(ns), read_write_(read_write) {
-    nvs_open(ns.c_str(), read_write_ ? NVS_READWRITE : NVS_READONLY, &nvs_handle_);
+    // 快照就绪时整个实例不需要 NVS 句柄：读走快照，写走待写队列。
+    // 句柄只在快照加载失败的退化路径上才打开
+    if (!SettingsStore::GetInstance().EnsureSnapshot(ns)) {
+        nvs_open(ns.c_str(), read_write_ ? NVS_READWRITE : NVS_READONLY, &nvs_handle_);
+    }
 }
 
 Settings::~Settings() {
     if (nvs_handle_ != 0) {
-        if (read_write_ && dirty_) {
-            ESP_ERROR_CHECK(nvs_commit(nvs_handle_));
-        }
         nvs_close(nvs_handle_);
     }
 }
 
+void Settings::FlushAll() {
+    SettingsStore::GetInstance().Flush();
+}
+
+void Settings::DumpHealth() {
+    SettingsStore::GetInstance().DumpHealth();
+}
+
+std::string Settings::GetHealthJson() {
+    return SettingsStore::GetInstance().GetHealthJson();
+}
+
+void Settings::CompactIfDegraded() {
+    SettingsStore::GetInstance().CompactIfDegraded();
+}
+
 std::string Settings::GetString(const std::string& key, const std::string& default_value) {
+    SettingsStore::CachedEntry entry;
+    switch (SettingsStore::GetInstance().Query(ns_, key, entry)) {
+        case SettingsStore::SnapshotResult::kFound:
+            return entry.type == NVS_TYPE_STR ? entry.string_value : default_value;
+        case SettingsStore::SnapshotResult::kMissing:
+            return default_value;
+        case SettingsStore::SnapshotResult::kNoSnapshot:
+            break;
+    }
+
+    // 无快照的退化路径：先查待写队列再直读 NVS
+    SettingsStore::PendingOp op;
+    if (SettingsStore::GetInstance().Lookup(ns_, key, op)) {
+        return op.type == SettingsStore::PendingOp::kSetString ? op.string_value : default_value;
+    }
+
     if (nvs_handle_ == 0) {
         return default_value;
     }
@@ -39,14 +446,28 @@ std::string Settings::GetString(const std::string& key, const std::string& defau
 
 void Settings::SetString(const std::string& key, const std::string& value) {
     if (read_write_) {
-        ESP_ERROR_CHECK(nvs_set_str(nvs_handle_, key.c_str(), value.c_str()));
-        dirty_ = true;
+        SettingsStore::GetInstance().Push(ns_, {SettingsStore::PendingOp::kSetString, key, value});
     } else {
         ESP_LOGW(TAG, "Namespace %s is not open for writing", ns_.c_str());
     }
 }
 
 int32_t Settings::GetInt(const std::string& key, int32_t default_value) {
+    SettingsStore::CachedEntry entry;
+    switch (SettingsStore::GetInstance().Query(ns_, key, entry)) {
+        case SettingsStore::SnapshotResult::kFound:
+            return entry.type == NVS_TYPE_I32 ? entry.int_value : default_value;
+        case SettingsStore::SnapshotResult::kMissing:
+            return default_value;
+        case SettingsStore::SnapshotResult::kNoSnapshot:
+            break;
+    }
+
+    SettingsStore::PendingOp op;
+    if (SettingsStore::GetInstance().Lookup(ns_, key, op)) {
+        return op.type == SettingsStore::PendingOp::kSetInt ? op.int_value : default_value;
+    }
+
     if (nvs_handle_ == 0) {
         return default_value;
     }
@@ -60,14 +481,28 @@ int32_t Settings::GetInt(const std::string& key, int32_t default_value) {
 
 void Settings::SetInt(const std::string& key, int32_t value) {
     if (read_write_) {
-        ESP_ERROR_CHECK(nvs_set_i32(nvs_handle_, key.c_str(), value));
-        dirty_ = true;
+        SettingsStore::GetInstance().Push(ns_, {SettingsStore::PendingOp::kSetInt, key, "", value});
     } else {
         ESP_LOGW(TAG, "Namespace %s is not open for writing", ns_.c_str());
     }
 }
 
 bool Settings::GetBool(const std::string& key, bool default_value) {
+    SettingsStore::CachedEntry entry;
+    switch (SettingsStore::GetInstance().Query(ns_, key, entry)) {
+        case SettingsStore::SnapshotResult::kFound:
+            return entry.type == NVS_TYPE_U8 ? entry.int_value != 0 : default_value;
+        case SettingsStore::SnapshotResult::kMissing:
+            return default_value;
+        case SettingsStore::SnapshotResult::kNoSnapshot:
+            break;
+    }
+
+    SettingsStore::PendingOp op;
+    if (SettingsStore::GetInstance().Lookup(ns_, key, op)) {
+        return op.type == SettingsStore::PendingOp::kSetBool ? op.int_value != 0 : default_value;
+    }
+
     if (nvs_handle_ == 0) {
         return default_value;
     }
@@ -81,8 +516,7 @@ bool Settings::GetBool(const std::string& key, bool default_value) {
 
 void Settings::SetBool(const std::string& key, bool value) {
     if (read_write_) {
-        ESP_ERROR_CHECK(nvs_set_u8(nvs_handle_, key.c_str(), value ? 1 : 0));
-        dirty_ = true;
+        SettingsStore::GetInstance().Push(ns_, {SettingsStore::PendingOp::kSetBool, key, "", value ? 1 : 0});
     } else {
         ESP_LOGW(TAG, "Namespace %s is not open for writing", ns_.c_str());
     }
@@ -90,10 +524,7 @@ void Settings::SetBool(const std::string& key, bool value) {
 
 void Settings::EraseKey(const std::string& key) {
     if (read_write_) {
-        auto ret = nvs_erase_key(nvs_handle_, key.c_str());
-        if (ret != ESP_ERR_NVS_NOT_FOUND) {
-            ESP_ERROR_CHECK(ret);
-        }
+        SettingsStore::GetInstance().Push(ns_, {SettingsStore::PendingOp::kEraseKey, key});
     } else {
         ESP_LOGW(TAG, "Namespace %s is not open for writing", ns_.c_str());
     }
@@ -101,7 +532,7 @@ void Settings::EraseKey(const std::string& key) {
 
 void Settings::EraseAll() {
     if (read_write_) {
-        ESP_ERROR_CHECK(nvs_erase_all(nvs_handle_));
+        SettingsStore::GetInstance().Push(ns_, {SettingsStore::PendingOp::kEraseAll});
     } else {
         ESP_LOGW(TAG, "Namespace %s is not open for writing", ns_.c_str());
     }
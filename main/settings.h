@@ -18,11 +18,21 @@ public:
     void EraseKey(const std::string& key);
     void EraseAll();
 
+    // 把待写队列里的所有设置同步落盘，重启前必须调用
+    static void FlushAll();
+
+    // NVS 健康度：提交时延（EWMA/最大）和条目占用。周期调试节拍里打印
+    static void DumpHealth();
+    // 遥测用的健康度 JSON，还没有过提交时返回空串
+    static std::string GetHealthJson();
+    // 空闲态调用：提交变慢或空闲条目吃紧时主动触发一轮页回收，
+    // 内部限频，最多每天一次
+    static void CompactIfDegraded();
+
 private:
     std::string ns_;
     nvs_handle_t nvs_handle_ = 0;
     bool read_write_ = false;
-    bool dirty_ = false;
 };
 
 #endif
@@ -0,0 +1,66 @@
+#ifndef STATIC_TASK_H
+#define STATIC_TASK_H
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_heap_caps.h>
+
+/*
+ * Owns the stack and TCB for a statically created task, with the stack in
+ * PSRAM when the sdkconfig allows external-memory stacks. Generalizes the
+ * pattern CustomWakeWord uses for its encode task: the big audio task
+ * stacks don't need DMA-capable internal RAM, and moving them out frees it
+ * for deeper DMA buffers on RAM-tight boards.
+ *
+ * The buffers are reused when the same task is stopped and recreated (the
+ * audio service restarts its tasks across Stop/Start), so a long-lived task
+ * costs one allocation for its whole life. The owner must not call Create
+ * again while the previous task is still running.
+ */
+class StaticTaskBuffer {
+public:
+    ~StaticTaskBuffer() {
+        if (stack_ != nullptr) {
+            heap_caps_free(stack_);
+        }
+        if (tcb_ != nullptr) {
+            heap_caps_free(tcb_);
+        }
+    }
+
+    // core < 0 means no affinity. Returns nullptr when allocation fails.
+    TaskHandle_t Create(TaskFunction_t fn, const char* name, uint32_t stack_size,
+                        void* arg, UBaseType_t priority, int core = -1) {
+        if (stack_ != nullptr && stack_size_ != stack_size) {
+            heap_caps_free(stack_);
+            stack_ = nullptr;
+        }
+        if (stack_ == nullptr) {
+#if CONFIG_SPIRAM && CONFIG_SPIRAM_ALLOW_STACK_EXTERNAL_MEMORY
+            stack_ = (StackType_t*)heap_caps_malloc(stack_size, MALLOC_CAP_SPIRAM);
+#endif
+            if (stack_ == nullptr) {
+                stack_ = (StackType_t*)heap_caps_malloc(stack_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            }
+            stack_size_ = stack_size;
+        }
+        if (tcb_ == nullptr) {
+            // TCB 必须在内部 RAM
+            tcb_ = (StaticTask_t*)heap_caps_malloc(sizeof(StaticTask_t), MALLOC_CAP_INTERNAL);
+        }
+        if (stack_ == nullptr || tcb_ == nullptr) {
+            return nullptr;
+        }
+        if (core >= 0) {
+            return xTaskCreateStaticPinnedToCore(fn, name, stack_size, arg, priority, stack_, tcb_, core);
+        }
+        return xTaskCreateStatic(fn, name, stack_size, arg, priority, stack_, tcb_);
+    }
+
+private:
+    StaticTask_t* tcb_ = nullptr;
+    StackType_t* stack_ = nullptr;
+    uint32_t stack_size_ = 0;
+};
+
+#endif // STATIC_TASK_H
@@ -0,0 +1,23 @@
+#include "status_event.h"
+
+StatusEventManager& StatusEventManager::GetInstance() {
+    static StatusEventManager instance;
+    return instance;
+}
+
+void StatusEventManager::Subscribe(std::function<void(StatusEvent)> callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    callbacks_.push_back(std::move(callback));
+}
+
+void StatusEventManager::Publish(StatusEvent event) {
+    // 拷一份再调用，回调里允许再订阅（虽然目前没人这么干）
+    std::vector<std::function<void(StatusEvent)>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        callbacks = callbacks_;
+    }
+    for (auto& callback : callbacks) {
+        callback(event);
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef _STATUS_EVENT_H_
+#define _STATUS_EVENT_H_
+
+#include <functional>
+#include <vector>
+#include <mutex>
+
+// 状态栏数据源的变更通知。电量（PMIC 中断/缓存刷新）、网络（连接状态）、
+// 音量（静音图标）在真正变化时发一个事件，显示侧只在收到事件或粗粒度的
+// 兜底轮询时做差量检查，没有变化的秒不产生任何 LVGL 工作。
+//
+// 回调在发布方的任务上同步执行，可能来自总线 worker 或音频任务，订阅方
+// 必须只做轻量、线程安全的事情（显示侧经由 QueueDisplayUpdate 合并到
+// LVGL 任务）。订阅不支持注销：订阅方都是与固件同生命周期的单例。
+enum class StatusEvent {
+    kBattery,
+    kNetwork,
+    kVolume,
+};
+
+class StatusEventManager {
+public:
+    static StatusEventManager& GetInstance();
+    StatusEventManager(const StatusEventManager&) = delete;
+    StatusEventManager& operator=(const StatusEventManager&) = delete;
+
+    void Subscribe(std::function<void(StatusEvent)> callback);
+    void Publish(StatusEvent event);
+
+private:
+    StatusEventManager() = default;
+
+    std::vector<std::function<void(StatusEvent)>> callbacks_;
+    std::mutex mutex_;
+};
+
+#endif // _STATUS_EVENT_H_
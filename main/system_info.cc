@@ -12,15 +12,21 @@
 #include "esp_wifi_remote.h"
 #endif
 
+#include "power_profiler.h"
+
 #define TAG "SystemInfo"
 
 size_t SystemInfo::GetFlashSize() {
-    uint32_t flash_size;
-    if (esp_flash_get_size(NULL, &flash_size) != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to get flash size");
-        return 0;
-    }
-    return (size_t)flash_size;
+    // 只读硬件属性，首次查询（SPI 命令 + flash 互斥）后缓存
+    static size_t cached_size = [] {
+        uint32_t flash_size;
+        if (esp_flash_get_size(NULL, &flash_size) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to get flash size");
+            return (size_t)0;
+        }
+        return (size_t)flash_size;
+    }();
+    return cached_size;
 }
 
 size_t SystemInfo::GetMinimumFreeHeapSize() {
@@ -32,15 +38,19 @@ size_t SystemInfo::GetFreeHeapSize() {
 }
 
 std::string SystemInfo::GetMacAddress() {
-    uint8_t mac[6];
+    // 出厂固化的地址，缓存后省掉 efuse/远端读取
+    static std::string cached_mac = [] {
+        uint8_t mac[6];
 #if CONFIG_IDF_TARGET_ESP32P4
-    esp_wifi_get_mac(WIFI_IF_STA, mac);
+        esp_wifi_get_mac(WIFI_IF_STA, mac);
 #else
-    esp_read_mac(mac, ESP_MAC_WIFI_STA);
+        esp_read_mac(mac, ESP_MAC_WIFI_STA);
 #endif
-    char mac_str[18];
-    snprintf(mac_str, sizeof(mac_str), "%02x:%02x:%02x:%02x:%02x:%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-    return std::string(mac_str);
+        char mac_str[18];
+        snprintf(mac_str, sizeof(mac_str), "%02x:%02x:%02x:%02x:%02x:%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+        return std::string(mac_str);
+    }();
+    return cached_mac;
 }
 
 std::string SystemInfo::GetChipModelName() {
@@ -149,3 +159,7 @@ void SystemInfo::PrintHeapStats() {
     int min_free_sram = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
     ESP_LOGI(TAG, "free sram: %u minimal sram: %u", free_sram, min_free_sram);
 }
+
+void SystemInfo::PrintPowerProfile() {
+    PowerProfiler::GetInstance().Dump();
+}
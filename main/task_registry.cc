@@ -0,0 +1,97 @@
+#include "task_registry.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include <esp_log.h>
+
+#define TAG "TaskRegistry"
+
+int TaskRegistry::ResolveCore(const char* task_name, int default_core) {
+#if CONFIG_FREERTOS_UNICORE
+    return default_core;
+#else
+    const char* map = CONFIG_TASK_AFFINITY_MAP;
+    size_t name_len = strlen(task_name);
+    const char* p = map;
+    while (*p != '\0') {
+        const char* eq = strchr(p, '=');
+        if (eq == nullptr) {
+            break;
+        }
+        const char* end = strchr(eq, ',');
+        if (end == nullptr) {
+            end = eq + strlen(eq);
+        }
+        if ((size_t)(eq - p) == name_len && strncmp(p, task_name, name_len) == 0) {
+            int core = atoi(eq + 1);
+            if (core < -1 || core >= CONFIG_FREERTOS_NUMBER_OF_CORES) {
+                ESP_LOGW(TAG, "Invalid core %d for task %s, using default %d", core, task_name, default_core);
+                return default_core;
+            }
+            ESP_LOGI(TAG, "Affinity override: %s -> core %d", task_name, core);
+            return core;
+        }
+        p = *end == ',' ? end + 1 : end;
+    }
+    return default_core;
+#endif
+}
+
+void TaskRegistry::Register(TaskHandle_t handle, const char* name, int priority, int core) {
+    if (handle == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_) {
+        // 同名任务重建（如协议切换重建 proto_send）时接管旧槽位，
+        // 否则表里留着已删除任务的句柄
+        if (entry.handle == handle || strcmp(entry.name, name) == 0) {
+            entry.handle = handle;
+            entry.name = name;
+            entry.priority = priority;
+            entry.core = core;
+            return;
+        }
+    }
+    entries_.push_back({handle, name, priority, core});
+}
+
+std::string TaskRegistry::GetJson() {
+    UBaseType_t array_size = uxTaskGetNumberOfTasks() + 4;
+    auto* status = (TaskStatus_t*)malloc(sizeof(TaskStatus_t) * array_size);
+    if (status == nullptr) {
+        return "[]";
+    }
+    configRUN_TIME_COUNTER_TYPE total_run_time = 0;
+    array_size = uxTaskGetSystemState(status, array_size, &total_run_time);
+    if (array_size == 0 || total_run_time == 0) {
+        free(status);
+        return "[]";
+    }
+
+    std::string json = "[";
+    char buffer[128];
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (UBaseType_t i = 0; i < array_size; i++) {
+        // 注册过的任务带上规划的核，未注册的报 -1（系统/组件任务）
+        int core = -1;
+        for (const auto& entry : entries_) {
+            if (entry.handle == status[i].xHandle) {
+                core = entry.core;
+                break;
+            }
+        }
+        uint32_t cpu_pct = (uint32_t)((status[i].ulRunTimeCounter * 100ULL) /
+                                      (total_run_time * CONFIG_FREERTOS_NUMBER_OF_CORES));
+        snprintf(buffer, sizeof(buffer),
+                 "%s{\"name\":\"%s\",\"prio\":%u,\"core\":%d,\"stack_min\":%u,\"cpu_pct\":%lu}",
+                 i == 0 ? "" : ",", status[i].pcTaskName,
+                 (unsigned)status[i].uxCurrentPriority, core,
+                 (unsigned)status[i].usStackHighWaterMark, (unsigned long)cpu_pct);
+        json += buffer;
+    }
+    free(status);
+    json += "]";
+    return json;
+}
@@ -0,0 +1,53 @@
+#ifndef TASK_REGISTRY_H
+#define TASK_REGISTRY_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * 长生命周期任务注册表。各处 xTaskCreate 之后调用 Register 记录任务的
+ * 规划优先级与核，ResolveCore 用 CONFIG_TASK_AFFINITY_MAP 里的配置覆盖
+ * 代码里的默认绑核，按板型调音频/UI 的核分配不用再改代码重编。
+ * GetJson 汇总每个任务的优先级、核、栈水位和开机以来的 CPU 占比
+ * （FreeRTOS 运行时统计），可通过 self.get_task_stats 工具在线上查询。
+ */
+class TaskRegistry {
+public:
+    static TaskRegistry& GetInstance() {
+        static TaskRegistry instance;
+        return instance;
+    }
+
+    // 解析 CONFIG_TASK_AFFINITY_MAP（"name=core,name=core"，core 取
+    // 0/1/-1，-1 表示不绑核）；没配置该任务名时返回 default_core
+    int ResolveCore(const char* task_name, int default_core);
+
+    // name 必须是字符串字面量；core 传 -1 表示未绑核
+    void Register(TaskHandle_t handle, const char* name, int priority, int core);
+
+    // [{"name":...,"prio":...,"core":...,"stack_min":...,"cpu_pct":...}]
+    // CPU 占比基于开机以来的运行时计数，不阻塞采样；需要区间占比时
+    // 隔一段时间查两次在外面做差即可
+    std::string GetJson();
+
+private:
+    TaskRegistry() = default;
+    TaskRegistry(const TaskRegistry&) = delete;
+    TaskRegistry& operator=(const TaskRegistry&) = delete;
+
+    struct Entry {
+        TaskHandle_t handle;
+        const char* name;
+        int priority;
+        int core;
+    };
+
+    std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+#endif // TASK_REGISTRY_H
@@ -0,0 +1,135 @@
+#include "thermal_monitor.h"
+
+#if CONFIG_THERMAL_MONITOR
+
+#include "application.h"
+#include "board.h"
+#include "display.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <soc/soc_caps.h>
+
+#define TAG "Thermal"
+
+namespace {
+
+constexpr int kSampleIntervalSeconds = 10;
+// 回落迟滞，避免在阈值附近来回切档
+constexpr float kHysteresisCelsius = 5.0f;
+
+constexpr float kWarmCelsius = CONFIG_THERMAL_WARM_CELSIUS;
+constexpr float kHotCelsius = CONFIG_THERMAL_HOT_CELSIUS;
+constexpr float kCriticalCelsius = CONFIG_THERMAL_CRITICAL_CELSIUS;
+
+}  // namespace
+
+void ThermalMonitor::Init() {
+    float celsius = 0.0f;
+    if (Board::GetInstance().GetTemperature(celsius)) {
+        use_board_sensor_ = true;
+    } else {
+#if SOC_TEMP_SENSOR_SUPPORTED
+        temperature_sensor_config_t config = TEMPERATURE_SENSOR_CONFIG_DEFAULT(10, 80);
+        if (temperature_sensor_install(&config, &own_sensor_) != ESP_OK ||
+            temperature_sensor_enable(own_sensor_) != ESP_OK) {
+            ESP_LOGW(TAG, "Temperature sensor unavailable, thermal monitor disabled");
+            own_sensor_ = nullptr;
+            return;
+        }
+#else
+        return;
+#endif
+    }
+
+    esp_timer_handle_t timer;
+    esp_timer_create_args_t timer_args = {
+        .callback = [](void* arg) {
+            ((ThermalMonitor*)arg)->Sample();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "thermal_monitor",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(timer, kSampleIntervalSeconds * 1000000LL));
+}
+
+void ThermalMonitor::Sample() {
+    float celsius = 0.0f;
+    if (use_board_sensor_) {
+        if (!Board::GetInstance().GetTemperature(celsius)) {
+            return;
+        }
+    } else {
+        if (temperature_sensor_get_celsius(own_sensor_, &celsius) != ESP_OK) {
+            return;
+        }
+    }
+
+    // EWMA 1/4 权重：压掉单次读数抖动，10 秒采样下仍能在一分钟内
+    // 跟上真实趋势
+    if (!ewma_valid_) {
+        ewma_ = celsius;
+        ewma_valid_ = true;
+    } else {
+        ewma_ += (celsius - ewma_) / 4;
+    }
+    temperature_x10_.store((int)(ewma_ * 10), std::memory_order_relaxed);
+
+    // 升档看阈值本身，降档要求回落过迟滞带
+    auto current = (Level)level_.load(std::memory_order_relaxed);
+    Level wanted;
+    if (ewma_ >= kCriticalCelsius) {
+        wanted = kCritical;
+    } else if (ewma_ >= kHotCelsius) {
+        wanted = kHot;
+    } else if (ewma_ >= kWarmCelsius) {
+        wanted = kWarm;
+    } else {
+        wanted = kNominal;
+    }
+    if (wanted < current) {
+        float back_thresh = (current == kCritical) ? kCriticalCelsius
+                          : (current == kHot)      ? kHotCelsius
+                                                   : kWarmCelsius;
+        if (ewma_ > back_thresh - kHysteresisCelsius) {
+            wanted = current;
+        }
+    }
+
+    if (wanted != current) {
+        ApplyLevel(wanted);
+    }
+    if (wanted >= kCritical) {
+        ESP_LOGE(TAG, "Chip at %.1f C, shedding load before thermal shutdown", ewma_);
+    }
+}
+
+void ThermalMonitor::ApplyLevel(Level level) {
+    auto previous = (Level)level_.exchange(level, std::memory_order_relaxed);
+    ESP_LOGW(TAG, "Thermal level %d -> %d at %.1f C", previous, level, ewma_);
+    ever_throttled_ = true;
+
+    // 降载顺序是我们选的：先牺牲帧率，再牺牲编码质量，最后才让
+    // 后台下载让路（kCritical 由 ShouldDeferBackgroundWork 生效）
+    Board::GetInstance().GetDisplay()->SetThermalThrottle(level >= kWarm);
+    Application::GetInstance().GetAudioService().SetThermalComplexityCap(
+        level >= kHot ? CONFIG_THERMAL_OPUS_COMPLEXITY_CAP : -1);
+}
+
+void ThermalMonitor::Dump() {
+    auto current = level();
+    if (current == kNominal && !ever_throttled_) {
+        return;
+    }
+    ESP_LOGI(TAG, "Chip temperature %.1f C, throttle level %d", temperature(), current);
+}
+
+#else
+
+void ThermalMonitor::Init() {}
+void ThermalMonitor::Dump() {}
+
+#endif // CONFIG_THERMAL_MONITOR
@@ -0,0 +1,68 @@
+#ifndef THERMAL_MONITOR_H
+#define THERMAL_MONITOR_H
+
+#include <sdkconfig.h>
+
+#include <atomic>
+
+#if CONFIG_THERMAL_MONITOR
+#include <driver/temperature_sensor.h>
+#endif
+
+/**
+ * 结温监控与主动降载（CONFIG_THERMAL_MONITOR 开启时生效）。周期读内部
+ * 温度传感器（板子实现了 Board::GetTemperature 就用板子的），按 EWMA
+ * 平滑后分级，按我们自己选的顺序让性能退让，而不是等硅片热关断：
+ *
+ *   kWarm     刷新率调速器降一档（active 30fps -> 10fps）
+ *   kHot      + Opus 编码复杂度封顶
+ *   kCritical + 后台下载（OTA 预装窗口）让路，并开始告警日志
+ *
+ * 各级回落带 5°C 迟滞。每 10 秒的调试汇总里带一行温度与当前档位。
+ */
+class ThermalMonitor {
+public:
+    enum Level {
+        kNominal = 0,
+        kWarm,
+        kHot,
+        kCritical,
+    };
+
+    static ThermalMonitor& GetInstance() {
+        static ThermalMonitor instance;
+        return instance;
+    }
+
+    // Application::Start 里调用一次；传感器不可用时自动退化为空操作
+    void Init();
+
+    float temperature() const { return temperature_x10_.load(std::memory_order_relaxed) / 10.0f; }
+    Level level() const { return (Level)level_.load(std::memory_order_relaxed); }
+    // OTA 预装等重 CPU 后台工作是否应让路
+    bool ShouldDeferBackgroundWork() const { return level() >= kCritical; }
+
+    // 10 秒调试汇总里的一行；kNominal 且从未降载过时保持安静
+    void Dump();
+
+private:
+    ThermalMonitor() = default;
+    ThermalMonitor(const ThermalMonitor&) = delete;
+    ThermalMonitor& operator=(const ThermalMonitor&) = delete;
+
+#if CONFIG_THERMAL_MONITOR
+    void Sample();
+    void ApplyLevel(Level level);
+
+    temperature_sensor_handle_t own_sensor_ = nullptr;
+    bool use_board_sensor_ = false;
+    bool ewma_valid_ = false;
+    float ewma_ = 0.0f;
+    bool ever_throttled_ = false;
+#endif
+
+    std::atomic<int> temperature_x10_{0};
+    std::atomic<int> level_{kNominal};
+};
+
+#endif // THERMAL_MONITOR_H
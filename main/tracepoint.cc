@@ -0,0 +1,130 @@
+#include "tracepoint.h"
+
+#include <cstring>
+
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <mbedtls/base64.h>
+
+#define TAG "TraceCapture"
+
+namespace {
+
+// 与 TracePoint 枚举同序，嵌进 dump 头供 decode_trace.py 使用
+const char* const kPointNames[] = {
+    "audio_input_frame",
+    "audio_output_frame",
+    "audio_underrun",
+    "audio_decode",
+    "proto_send",
+    "proto_recv",
+    "state_change",
+    "display_update",
+    "nvs_commit",
+    "flash_write",
+    "flash_erase",
+};
+static_assert(sizeof(kPointNames) / sizeof(kPointNames[0]) ==
+              (size_t)TracePoint::kPointCount, "name table out of sync");
+
+#if CONFIG_FREERTOS_UNICORE
+constexpr int kActiveCores = 1;
+#else
+constexpr int kActiveCores = 2;
+#endif
+
+} // namespace
+
+std::atomic<bool> TraceCapture::armed_{false};
+
+void TraceCapture::RecordSlow(TracePoint point, uint16_t arg) {
+    int core = xPortGetCoreID();
+    Event* buffer = buffers_[core];
+    if (buffer == nullptr) {
+        return;
+    }
+    // fetch_add 先占坑再填充：同核任务间抢占安全；覆盖环，旧事件被冲掉
+    uint32_t index = write_count_[core].fetch_add(1, std::memory_order_relaxed) % kEventsPerCore;
+    buffer[index].time_us = (uint32_t)esp_timer_get_time();
+    buffer[index].point = (uint16_t)point;
+    buffer[index].arg = arg;
+}
+
+bool TraceCapture::Arm() {
+    for (int core = 0; core < kActiveCores; core++) {
+        if (buffers_[core] == nullptr) {
+            size_t bytes = sizeof(Event) * kEventsPerCore;
+            buffers_[core] = (Event*)heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            if (buffers_[core] == nullptr) {
+                buffers_[core] = (Event*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+            }
+            if (buffers_[core] == nullptr) {
+                ESP_LOGE(TAG, "No memory for trace buffer (core %d)", core);
+                Disarm();
+                for (int c = 0; c < kActiveCores; c++) {
+                    heap_caps_free(buffers_[c]);
+                    buffers_[c] = nullptr;
+                }
+                return false;
+            }
+        }
+        write_count_[core].store(0, std::memory_order_relaxed);
+    }
+    armed_.store(true, std::memory_order_release);
+    ESP_LOGI(TAG, "Trace capture armed (%d x %lu events)", kActiveCores, (unsigned long)kEventsPerCore);
+    return true;
+}
+
+void TraceCapture::Disarm() {
+    armed_.store(false, std::memory_order_release);
+}
+
+std::string TraceCapture::DumpBase64() {
+    Disarm();
+    // 写入方最多还有一个已占坑未填完的事件，等一个 tick 让它落盘
+    vTaskDelay(1);
+
+    std::string raw;
+    raw.reserve(256 + kActiveCores * kEventsPerCore * sizeof(Event));
+    raw += "TRC1";
+    raw += (char)kActiveCores;
+    raw += (char)(uint8_t)TracePoint::kPointCount;
+    raw += '\0';
+    raw += '\0';
+    for (size_t i = 0; i < (size_t)TracePoint::kPointCount; i++) {
+        raw += kPointNames[i];
+        raw += '\0';
+    }
+
+    for (int core = 0; core < kActiveCores; core++) {
+        uint32_t total = write_count_[core].load(std::memory_order_relaxed);
+        uint32_t count = total < kEventsPerCore ? total : kEventsPerCore;
+        uint32_t first = total < kEventsPerCore ? 0 : total % kEventsPerCore;
+        char header[8];
+        memcpy(header, &count, 4);
+        memcpy(header + 4, &total, 4);
+        raw.append(header, 8);
+        if (buffers_[core] != nullptr) {
+            // 覆盖环按时间序展开（最旧在前）
+            for (uint32_t i = 0; i < count; i++) {
+                const Event& event = buffers_[core][(first + i) % kEventsPerCore];
+                raw.append((const char*)&event, sizeof(Event));
+            }
+        }
+        heap_caps_free(buffers_[core]);
+        buffers_[core] = nullptr;
+    }
+
+    size_t encoded_len = 0;
+    mbedtls_base64_encode(nullptr, 0, &encoded_len, (const uint8_t*)raw.data(), raw.size());
+    std::string encoded(encoded_len, '\0');
+    if (mbedtls_base64_encode((unsigned char*)encoded.data(), encoded.size(), &encoded_len,
+                              (const uint8_t*)raw.data(), raw.size()) != 0) {
+        return "";
+    }
+    encoded.resize(encoded_len);
+    return encoded;
+}
@@ -0,0 +1,85 @@
+#ifndef TRACEPOINT_H
+#define TRACEPOINT_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/*
+ * 轻量 tracepoint：按需开窗的 8 字节事件采集。
+ *
+ * 队列/欠载类的 heisenbug 靠采样日志抓不住，SystemView 的常驻开销又
+ * 不能上生产。这里的探针平时只有一次 relaxed 原子读（未布防直接返回）；
+ * 布防窗口内每个事件写 8 字节进本核的覆盖环（时间戳截断到 32 位 us、
+ * 16 位探针号、16 位参数），无锁无阻塞。窗口由 MCP 工具
+ * self.capture_trace 打开，结束后把各核缓冲以 base64 紧凑二进制吐回，
+ * 离线用 scripts/decode_trace.py 重建时间线。
+ *
+ * 缓冲在布防时按核分配（内部 RAM 不够会落到 PSRAM），拆除后释放，
+ * 未布防时不占内存。探针号在 TracePoint 枚举里编译期注册，名字表
+ * 供解码脚本使用（嵌在 dump 头里，固件和脚本不必同版本）。
+ * 只支持任务上下文，不要在 ISR 里打点。
+ */
+enum class TracePoint : uint16_t {
+    kAudioInputFrame = 0,   // arg: 采集队列深度
+    kAudioOutputFrame,      // arg: 播放队列深度
+    kAudioUnderrun,         // arg: jitter buffer 目标深度
+    kAudioDecode,           // arg: 解码耗时 (us/64)
+    kProtoSend,             // arg: 载荷字节数
+    kProtoRecv,             // arg: 载荷字节数
+    kStateChange,           // arg: (旧状态 << 8) | 新状态
+    kDisplayUpdate,         // arg: 本次批量刷新的更新条数
+    kNvsCommit,             // arg: 提交耗时 (us/64)
+    kFlashWrite,            // arg: 写入耗时 (us/64)
+    kFlashErase,            // arg: 擦除耗时 (us/64)
+    kPointCount
+};
+
+class TraceCapture {
+public:
+    static TraceCapture& GetInstance() {
+        static TraceCapture instance;
+        return instance;
+    }
+
+    // 热路径：未布防时只有一次 relaxed load
+    static inline void Record(TracePoint point, uint16_t arg) {
+        if (!armed_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        GetInstance().RecordSlow(point, arg);
+    }
+
+    // 布防采集窗口；缓冲已存在（上一窗未 Dump）时会被复用清零
+    bool Arm();
+    void Disarm();
+    // 拆除并取走采集结果（头 + 各核事件的 base64），释放缓冲
+    std::string DumpBase64();
+
+    bool armed() const { return armed_.load(std::memory_order_relaxed); }
+
+private:
+    TraceCapture() = default;
+    TraceCapture(const TraceCapture&) = delete;
+    TraceCapture& operator=(const TraceCapture&) = delete;
+
+    struct Event {
+        uint32_t time_us;  // esp_timer 时间截断到 32 位，解码侧处理回绕
+        uint16_t point;
+        uint16_t arg;
+    };
+    static_assert(sizeof(Event) == 8, "trace event must stay 8 bytes");
+
+    static constexpr int kMaxCores = 2;
+    static constexpr uint32_t kEventsPerCore = 1024;  // 8KB/核
+
+    void RecordSlow(TracePoint point, uint16_t arg);
+
+    static std::atomic<bool> armed_;
+    Event* buffers_[kMaxCores] = {};
+    std::atomic<uint32_t> write_count_[kMaxCores] = {};
+};
+
+#define TRACE_EVENT(point, arg) TraceCapture::Record(point, (uint16_t)(arg))
+
+#endif // TRACEPOINT_H
@@ -0,0 +1,90 @@
+#include "wake_snapshot.h"
+#include "application.h"
+#include "assets.h"
+
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_rom_crc.h>
+#include <esp_sleep.h>
+#include <esp_system.h>
+
+#include <ctime>
+
+#define TAG "WakeSnapshot"
+
+namespace {
+
+constexpr uint32_t kMagic = 0x574B534E;  // 'WKSN'
+// 睡太久的快照不可信：固件或资源可能已被服务器侧标记更新
+constexpr int64_t kMaxAgeSeconds = 24 * 3600;
+
+struct SnapshotBlob {
+    uint32_t magic;
+    int64_t saved_at;
+    uint8_t device_state;
+    uint8_t assets_verified;
+    uint8_t reserved[2];
+    uint32_t crc;
+};
+
+RTC_NOINIT_ATTR SnapshotBlob s_blob;
+
+// Restore() 之后的解码结果，运行期只读
+bool s_assets_verified = false;
+int s_device_state = 0;
+
+uint32_t BlobCrc(const SnapshotBlob& blob) {
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&blob),
+                            offsetof(SnapshotBlob, crc));
+}
+
+void SaveOnDeepSleepEntry() {
+    s_blob.magic = kMagic;
+    s_blob.saved_at = time(NULL);
+    s_blob.device_state = (uint8_t)Application::GetInstance().GetDeviceState();
+    s_blob.assets_verified = Assets::GetInstance().checksum_valid() ? 1 : 0;
+    s_blob.reserved[0] = 0;
+    s_blob.reserved[1] = 0;
+    s_blob.crc = BlobCrc(s_blob);
+}
+
+}  // namespace
+
+void WakeSnapshot::RegisterSaveHook() {
+    ESP_ERROR_CHECK(esp_deep_sleep_register_hook(&SaveOnDeepSleepEntry));
+}
+
+bool WakeSnapshot::Restore() {
+    if (esp_reset_reason() != ESP_RST_DEEPSLEEP) {
+        return false;
+    }
+    if (s_blob.magic != kMagic || s_blob.crc != BlobCrc(s_blob)) {
+        ESP_LOGW(TAG, "Deep sleep wake without valid snapshot");
+        return false;
+    }
+    // 作废掉，崩溃重启不会再命中
+    s_blob.magic = 0;
+
+    // RTC 时钟跨深睡继续走；时钟没同步过（saved_at 无效）时只信复位
+    // 原因，不做时长判断
+    int64_t now = time(NULL);
+    if (s_blob.saved_at > 1600000000 && now - s_blob.saved_at > kMaxAgeSeconds) {
+        ESP_LOGI(TAG, "Snapshot is %lld seconds old, taking the cold path",
+                 (long long)(now - s_blob.saved_at));
+        return false;
+    }
+
+    s_assets_verified = s_blob.assets_verified != 0;
+    s_device_state = s_blob.device_state;
+    ESP_LOGI(TAG, "Fast wake from deep sleep (slept in state %d, assets %s)",
+             s_device_state, s_assets_verified ? "verified" : "unverified");
+    return true;
+}
+
+bool WakeSnapshot::assets_verified() {
+    return s_assets_verified;
+}
+
+int WakeSnapshot::saved_device_state() {
+    return s_device_state;
+}
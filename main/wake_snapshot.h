@@ -0,0 +1,32 @@
+#ifndef WAKE_SNAPSHOT_H
+#define WAKE_SNAPSHOT_H
+
+#include <cstdint>
+
+/**
+ * 深睡唤醒快照。进入深睡前（esp_deep_sleep_register_hook，覆盖所有调用
+ * esp_deep_sleep_start 的板子）把一小块状态写进 RTC RAM：睡眠时刻、当时
+ * 的设备状态、资源分区校验结论。唤醒后 Restore() 校验复位原因与 CRC，
+ * 命中时启动路径跳过可以证明没变的发现类工作——资源分区校验和、资源
+ * 版本检查，并让 OTA 检查直接走缓存配置 + 后台复验（设备睡着时固件和
+ * 资源都不会变）。电池小板从按键唤醒到可交互由此省掉数秒的串行网络
+ * 往返和 flash 扫描。
+ *
+ * WiFi 的快连配置（信道、BSSID）由 esp_wifi 自己持久化在 NVS，音量与
+ * 主题也已在 NVS，快照不重复保存。
+ */
+class WakeSnapshot {
+public:
+    // 挂深睡前回调，Application::Start 里调用一次
+    static void RegisterSaveHook();
+
+    // 唤醒路径调用一次：深睡复位 + 快照完好 + 睡眠时长在上限内时返回
+    // true，同时作废快照（防止异常重启后反复走快路径）
+    static bool Restore();
+
+    // Restore() 返回 true 后有效
+    static bool assets_verified();
+    static int saved_device_state();
+};
+
+#endif // WAKE_SNAPSHOT_H
@@ -11,6 +11,7 @@ Usage:
 """
 
 import argparse
+import hashlib
 import io
 import os
 import shutil
@@ -95,28 +96,27 @@ def pack_models(model_path, out_file="srmodels.bin"):
                     models[model_name][file_name] = read_data(file_path)
     
     model_num = len(models)
-    header_len = 4 + model_num*(32+4) + file_num*(32+4+4) 
+    header_len = 4 + model_num*(32+4) + file_num*(32+4+4)
     out_bin = struct.pack('I', model_num)  # model number
-    data_bin = None
+    data_bin = b""
     for key in models:
         model_bin = struct_pack_string(key, 32) # + model name
         model_bin += struct.pack('I', len(models[key])) # + file number in this model
-        
+
         for file_name in models[key]:
+            # Pad each payload to a 32-byte boundary: the loader reads the
+            # recorded offsets, so padding is transparent, and weights are
+            # then cache-line aligned when the container itself is (the
+            # assets image places srmodels.bin on a 32-byte boundary)
+            data_bin += b"\x00" * (-(header_len + len(data_bin)) % 32)
             model_bin += struct_pack_string(file_name, 32) # + file name
-            if data_bin == None:
-                model_bin += struct.pack('I', header_len) 
-                data_bin = models[key][file_name]
-                model_bin += struct.pack('I', len(models[key][file_name]))
-            else:
-                model_bin += struct.pack('I', header_len+len(data_bin))
-                data_bin += models[key][file_name]
-                model_bin += struct.pack('I', len(models[key][file_name]))
-        
+            model_bin += struct.pack('I', header_len + len(data_bin))
+            data_bin += models[key][file_name]
+            model_bin += struct.pack('I', len(models[key][file_name]))
+
         out_bin += model_bin
     assert len(out_bin) == header_len
-    if data_bin != None:
-        out_bin += data_bin
+    out_bin += data_bin
 
     out_file = os.path.join(model_path, out_file)
     with open(out_file, "wb") as f:
@@ -292,7 +292,21 @@ def generate_index_json(assets_dir, srmodels, text_font, emoji_collection, extra
     
     if multinet_model_info:
         index_data["multinet_model"] = multinet_model_info
-    
+
+    # Preload hints: the firmware background-warms the flash cache pages of
+    # these assets right after boot, highest priority first (see
+    # Assets::PreloadHotAssets). The font and the neutral emoji are what the
+    # first interaction touches, so they go ahead of the other emojis.
+    preload = []
+    if text_font:
+        preload.append(text_font)
+    if emoji_collection:
+        emoji_files = [e["file"] for e in emoji_collection]
+        neutral = [f for f in emoji_files if os.path.splitext(f)[0] == "neutral"]
+        preload.extend(neutral + [f for f in emoji_files if f not in neutral])
+    if preload:
+        index_data["preload"] = preload
+
     # Write index.json
     index_path = os.path.join(assets_dir, "index.json")
     with open(index_path, 'w', encoding='utf-8') as f:
@@ -356,6 +370,13 @@ def pack_assets_simple(target_path, include_path, out_file, assets_path, max_nam
     os.makedirs(os.path.dirname(out_file), exist_ok=True)
     os.makedirs(include_path, exist_ok=True)
 
+    # Identical payloads are stored once; later table entries alias the
+    # first copy's offset. The device resolves names through the table, so
+    # aliased offsets need no firmware support.
+    dedup_offsets = {}
+    dedup_saved = 0
+    dedup_files = 0
+
     file_list = sorted(os.listdir(target_path), key=sort_key)
     for filename in file_list:
         if filename in skip_files:
@@ -364,20 +385,30 @@ def pack_assets_simple(target_path, include_path, out_file, assets_path, max_nam
         file_path = os.path.join(target_path, filename)
         if not os.path.isfile(file_path):
             continue
-            
+
         file_name = os.path.basename(file_path)
         file_size = os.path.getsize(file_path)
 
+        with open(file_path, 'rb') as bin_file:
+            bin_data = bin_file.read()
+
+        content_key = hashlib.sha256(bin_data).digest()
+        if content_key in dedup_offsets:
+            file_info_list.append((file_name, dedup_offsets[content_key], file_size, 0, 0))
+            dedup_saved += file_size + 2
+            dedup_files += 1
+            continue
+
+        dedup_offsets[content_key] = len(merged_data)
         file_info_list.append((file_name, len(merged_data), file_size, 0, 0))
         # Add 0x5A5A prefix to merged_data
         merged_data.extend(b'\x5A' * 2)
 
-        with open(file_path, 'rb') as bin_file:
-            bin_data = bin_file.read()
-
         merged_data.extend(bin_data)
 
     total_files = len(file_info_list)
+    if dedup_files:
+        print(f'Deduplicated {dedup_files} identical files, saved {dedup_saved} bytes')
 
     mmap_table = bytearray()
     for file_name, offset, file_size, width, height in file_info_list:
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Tracepoint dump 解码。
+
+把 self.capture_trace MCP 工具返回的 base64 数据重建成时间线（探针名
+表嵌在 dump 头里，脚本不依赖固件版本）:
+
+    python scripts/decode_trace.py trace.b64          # 按时间序打印
+    python scripts/decode_trace.py trace.b64 --csv    # CSV，便于画图
+
+格式（小端）: "TRC1"、核数 u8、探针数 u8、保留 u16、探针名表（NUL
+结尾字符串 × 探针数），每核 u32 保留条数 + u32 总写入数（差值即被
+覆盖环冲掉的条数），随后每条 8 字节: u32 时间戳(us, 截断)、u16 探针
+号、u16 参数。时间戳回绕按 32 位无符号差处理。
+"""
+
+import base64
+import struct
+import sys
+
+
+def decode(blob):
+    if blob[:4] != b"TRC1":
+        sys.exit("error: bad magic (not a TRC1 dump)")
+    cores, point_count = blob[4], blob[5]
+    offset = 8
+    names = []
+    for _ in range(point_count):
+        end = blob.index(b"\0", offset)
+        names.append(blob[offset:end].decode())
+        offset = end + 1
+
+    events = []
+    for core in range(cores):
+        count, total = struct.unpack_from("<II", blob, offset)
+        offset += 8
+        if total > count:
+            print("# core %d: %d events overwritten (window longer than buffer)"
+                  % (core, total - count), file=sys.stderr)
+        for _ in range(count):
+            time_us, point, arg = struct.unpack_from("<IHH", blob, offset)
+            offset += 8
+            name = names[point] if point < len(names) else "point_%d" % point
+            events.append((time_us, core, name, arg))
+
+    if not events:
+        return []
+    # 32 位时间戳回绕: 以第一条事件为锚，带符号解释无符号差——采集窗
+    # 远短于 35 分钟，锚点前后的事件都落在有效范围内
+    base = events[0][0]
+
+    def rel(t):
+        d = (t - base) & 0xFFFFFFFF
+        return d - (1 << 32) if d >= (1 << 31) else d
+
+    events.sort(key=lambda e: rel(e[0]))
+    start = rel(events[0][0])
+    return [(rel(e[0]) - start, e[1], e[2], e[3]) for e in events]
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 1
+    csv = "--csv" in sys.argv
+    with open(sys.argv[1]) as f:
+        blob = base64.b64decode(f.read().strip())
+    events = decode(blob)
+    if csv:
+        print("t_us,core,point,arg")
+        for t, core, name, arg in events:
+            print("%d,%d,%s,%d" % (t, core, name, arg))
+    else:
+        for t, core, name, arg in events:
+            print("%10.3f ms  core%d  %-20s %d" % (t / 1000.0, core, name, arg))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
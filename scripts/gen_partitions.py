@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""
+Generate and validate partition table CSVs from measured sizes.
+
+The CSVs in partitions/v2 are hand-maintained per flash size; when an app
+image grows past its slot or assets shrink, rebalancing them by hand means a
+day of CSV edits and reflash tests per board. This script derives the layout
+from what a finished build actually measures:
+
+    # generate a 16MB layout sized around a built image and assets bundle
+    python scripts/gen_partitions.py gen --flash 16m \
+        --app-image build/xiaozhi.bin \
+        --assets-image build/assets.bin > partitions/v2/16m.csv
+
+    # validate an existing CSV against a build (used as a build-time report)
+    python scripts/gen_partitions.py check partitions/v2/16m.csv \
+        --flash 16m --app-image build/xiaozhi.bin
+
+Layout rules (matching the hand-written tables):
+  - nvs/otadata/phy_init keep their conventional offsets after the
+    partition table at 0x8000
+  - two equal OTA app slots, each the measured image plus headroom
+    (default 25% for OTA deltas and future growth), rounded up to 64KB;
+    flash of 4MB or --factory gets a single factory slot instead
+  - assets (spiffs) absorbs all remaining space minus the coredump slot
+  - coredump (64KB, see main/crash_reporter.cc) sits at the end of flash;
+    --no-coredump drops it for boards that disable crash telemetry
+
+check exits non-zero when a slot overlaps, is misaligned, or leaves less
+headroom than --min-headroom, and prints per-slot slack so oversized slots
+are visible in CI logs.
+"""
+
+import argparse
+import os
+import sys
+
+FLASH_SIZES = {"4m": 4, "8m": 8, "16m": 16, "32m": 32}
+APP_ALIGN = 0x10000
+DATA_ALIGN = 0x1000
+COREDUMP_SIZE = 0x10000
+# nvs starts after the 0x8000 partition table + its 0x1000 md5 sector
+FIXED_HEAD = [
+    ("nvs", "data", "nvs", 0x9000, 0x4000),
+    ("otadata", "data", "ota", 0xD000, 0x2000),
+    ("phy_init", "data", "phy", 0xF000, 0x1000),
+]
+
+
+def align_up(value, align):
+    return (value + align - 1) & ~(align - 1)
+
+
+def parse_size(text):
+    text = text.strip()
+    if not text:
+        return None
+    if text.lower().endswith("k"):
+        return int(text[:-1]) * 1024
+    if text.lower().endswith("m"):
+        return int(text[:-1]) * 1024 * 1024
+    return int(text, 0)
+
+
+def measured_size(path, what):
+    if path is None:
+        return None
+    if not os.path.exists(path):
+        sys.exit("error: %s image not found: %s" % (what, path))
+    return os.path.getsize(path)
+
+
+def build_layout(flash_bytes, app_image, assets_image, headroom, factory, coredump):
+    parts = list(FIXED_HEAD)
+    end = flash_bytes - (COREDUMP_SIZE if coredump else 0)
+
+    app_slot = align_up(int(app_image * (1 + headroom)), APP_ALIGN)
+    offset = align_up(parts[-1][3] + parts[-1][4], APP_ALIGN)
+    if factory:
+        parts.append(("factory", "app", "factory", offset, app_slot))
+        offset += app_slot
+    else:
+        parts.append(("ota_0", "app", "ota_0", offset, app_slot))
+        offset += app_slot
+        parts.append(("ota_1", "app", "ota_1", offset, app_slot))
+        offset += app_slot
+
+    offset = align_up(offset, DATA_ALIGN)
+    assets_slot = end - offset
+    if assets_slot <= 0:
+        sys.exit(
+            "error: app slots (%d x 0x%x) leave no room for assets in %dMB flash"
+            % (1 if factory else 2, app_slot, flash_bytes // (1024 * 1024))
+        )
+    if assets_image is not None and assets_slot < assets_image:
+        sys.exit(
+            "error: assets image 0x%x does not fit remaining 0x%x; "
+            "reduce --headroom or trim assets" % (assets_image, assets_slot)
+        )
+    parts.append(("assets", "data", "spiffs", offset, assets_slot))
+    if coredump:
+        parts.append(("coredump", "data", "coredump", end, COREDUMP_SIZE))
+    return parts
+
+
+def emit_csv(parts, out):
+    out.write("# ESP-IDF Partition Table\n")
+    out.write("# Name,   Type, SubType, Offset,  Size, Flags\n")
+    for name, ptype, subtype, offset, size in parts:
+        out.write(
+            "%-9s %-5s %-8s %-10s 0x%x,\n"
+            % (name + ",", ptype + ",", subtype + ",", "0x%x," % offset, size)
+        )
+
+
+def load_csv(path):
+    parts = []
+    offset = 0
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            fields = [c.strip() for c in line.split(",")]
+            name, ptype, subtype = fields[0], fields[1], fields[2]
+            explicit = parse_size(fields[3]) if len(fields) > 3 else None
+            size = parse_size(fields[4])
+            align = APP_ALIGN if ptype == "app" else DATA_ALIGN
+            offset = explicit if explicit is not None else align_up(offset, align)
+            parts.append((name, ptype, subtype, offset, size))
+            offset += size
+    return parts
+
+
+def check_layout(parts, flash_bytes, app_image, assets_image, min_headroom):
+    errors = []
+    prev_end = 0
+    prev_name = "partition table"
+    for name, ptype, subtype, offset, size in parts:
+        align = APP_ALIGN if ptype == "app" else DATA_ALIGN
+        if offset % align:
+            errors.append("%s: offset 0x%x not aligned to 0x%x" % (name, offset, align))
+        if offset < prev_end:
+            errors.append(
+                "%s: offset 0x%x overlaps %s (ends 0x%x)" % (name, offset, prev_name, prev_end)
+            )
+        if offset + size > flash_bytes:
+            errors.append("%s: ends 0x%x past flash end 0x%x" % (name, offset + size, flash_bytes))
+        prev_end, prev_name = offset + size, name
+
+    print("%-10s %-10s %-10s %-10s %s" % ("name", "offset", "size", "used", "slack"))
+    for name, ptype, subtype, offset, size in parts:
+        used = None
+        if ptype == "app":
+            used = app_image
+        elif name == "assets":
+            used = assets_image
+        if used is None:
+            print("%-10s 0x%-8x 0x%-8x %-10s" % (name, offset, size, "-"))
+            continue
+        slack = size - used
+        print("%-10s 0x%-8x 0x%-8x 0x%-8x 0x%x (%.0f%%)" % (name, offset, size, used, slack, 100.0 * slack / size))
+        if used > size:
+            errors.append("%s: image 0x%x exceeds slot 0x%x" % (name, used, size))
+        elif ptype == "app" and slack < size * min_headroom:
+            errors.append(
+                "%s: only %.0f%% headroom left (minimum %.0f%%); regrow the slot "
+                "with gen before the next release" % (name, 100.0 * slack / size, 100.0 * min_headroom)
+            )
+    tail = flash_bytes - prev_end
+    if tail:
+        print("unallocated tail: 0x%x" % tail)
+
+    for e in errors:
+        print("error: " + e, file=sys.stderr)
+    return 1 if errors else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("command", choices=["gen", "check"])
+    parser.add_argument("csv", nargs="?", help="CSV to validate (check only)")
+    parser.add_argument("--flash", required=True, choices=sorted(FLASH_SIZES))
+    parser.add_argument("--app-image", help="built app .bin, used to size/verify app slots")
+    parser.add_argument("--assets-image", help="built assets .bin, used to verify the assets slot")
+    parser.add_argument("--headroom", type=float, default=0.25,
+                        help="app slot growth margin over the measured image (gen)")
+    parser.add_argument("--min-headroom", type=float, default=0.10,
+                        help="headroom below which check fails")
+    parser.add_argument("--factory", action="store_true",
+                        help="single factory slot instead of two OTA slots")
+    parser.add_argument("--no-coredump", dest="coredump", action="store_false",
+                        help="omit the coredump slot")
+    args = parser.parse_args()
+
+    flash_bytes = FLASH_SIZES[args.flash] * 1024 * 1024
+    app_image = measured_size(args.app_image, "app")
+    assets_image = measured_size(args.assets_image, "assets")
+    # 4MB parts can't fit two useful OTA slots; the hand-written 4m.csv agrees
+    factory = args.factory or args.flash == "4m"
+
+    if args.command == "gen":
+        if app_image is None:
+            sys.exit("error: gen requires --app-image to size the app slots")
+        parts = build_layout(flash_bytes, app_image, assets_image,
+                             args.headroom, factory, args.coredump)
+        emit_csv(parts, sys.stdout)
+        return 0
+
+    if not args.csv:
+        sys.exit("error: check requires a CSV path")
+    parts = load_csv(args.csv)
+    return check_layout(parts, flash_bytes, app_image, assets_image, args.min_headroom)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,14 @@
+#ifndef HOSTSIM_ESP_LOG_H
+#define HOSTSIM_ESP_LOG_H
+
+/* 主机侧最小 esp_log 桩：固件源码里的日志宏原样落到 stderr */
+
+#include <cstdio>
+
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E (%s) " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W (%s) " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) fprintf(stderr, "I (%s) " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ((void)0)
+#define ESP_LOGV(tag, fmt, ...) ((void)0)
+
+#endif // HOSTSIM_ESP_LOG_H
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""IRAM 放置报告。
+
+解析链接器 map 文件，按归档列出落在 IRAM (.iram0.text) 里的符号和大小，
+用来核对 AUDIO_IRAM_ATTR 标注的热路径函数确实进了 IRAM，以及各组件
+占了多少预算。配合构建目标使用:
+
+    idf.py build && idf.py iram-report
+    # 或直接: python scripts/iram_report.py build/xiaozhi.map
+"""
+
+import re
+import sys
+from collections import defaultdict
+
+
+def parse_map(path):
+    """返回 [(size, archive, symbol)]，只含 .iram0.text 输入段。"""
+    entries = []
+    in_iram = False
+    pending = None  # 超长符号名换行时，地址/大小在下一行
+    section_re = re.compile(
+        r"^ (\.iram0\.text\S*|\.iram\.text\S*)\s*$|"
+        r"^ (\.iram0\.text\S*|\.iram\.text\S*)\s+0x"
+    )
+    with open(path) as f:
+        for line in f:
+            if line.startswith("Linker script and memory map"):
+                in_iram = False
+            stripped = line.rstrip("\n")
+            # 输入段行形如:
+            #  .iram0.text.symbol
+            #                 0xaddr  0xsize  esp-idf/main/libmain.a(foo.cc.obj)
+            # 或单行放得下时地址大小同行
+            m = re.match(r"^ \.iram0?\.text\.?(\S*)\s*(.*)$", stripped)
+            if m:
+                rest = m.group(2).strip()
+                sym = m.group(1)
+                if rest:
+                    entries.extend(_parse_tail(sym, rest))
+                    pending = None
+                else:
+                    pending = sym
+                continue
+            if pending is not None:
+                rest = stripped.strip()
+                if rest.startswith("0x"):
+                    entries.extend(_parse_tail(pending, rest))
+                pending = None
+    return entries
+
+
+def _parse_tail(sym, rest):
+    parts = rest.split()
+    if len(parts) < 3 or not parts[1].startswith("0x"):
+        return []
+    try:
+        size = int(parts[1], 16)
+    except ValueError:
+        return []
+    if size == 0:
+        return []
+    archive = parts[2]
+    m = re.search(r"([^/\\]+\.a)\(([^)]+)\)", archive)
+    if m:
+        archive = "%s(%s)" % (m.group(1), m.group(2))
+    return [(size, archive, sym or "(anonymous)")]
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("usage: iram_report.py <project.map>", file=sys.stderr)
+        return 1
+    entries = parse_map(sys.argv[1])
+    if not entries:
+        print("no .iram0.text entries found (wrong map file?)", file=sys.stderr)
+        return 1
+
+    by_archive = defaultdict(int)
+    for size, archive, _ in entries:
+        lib = archive.split("(")[0]
+        by_archive[lib] += size
+
+    total = sum(s for s, _, _ in entries)
+    print("IRAM usage by archive:")
+    for lib, size in sorted(by_archive.items(), key=lambda kv: -kv[1]):
+        print("  %8d  %s" % (size, lib))
+    print("  %8d  total" % total)
+
+    print("\nlibmain.a symbols in IRAM:")
+    main_syms = [(s, sym) for s, a, sym in entries if "libmain.a" in a]
+    for size, sym in sorted(main_syms, key=lambda kv: -kv[0]):
+        print("  %8d  %s" % (size, sym))
+    if not main_syms:
+        print("  (none — AUDIO_HOT_PATH_IN_IRAM disabled?)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
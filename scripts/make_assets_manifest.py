@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""
+Generate a per-file manifest for an assets partition image.
+
+The device compares the manifest against its current assets partition and
+downloads only the byte ranges that changed, copying unchanged files in place
+(see Assets::TryIncrementalSync in main/assets.cc). Serve the manifest next to
+the image as "<image name>.manifest.json"; devices without a valid partition
+or talking to a server without the manifest fall back to the full download.
+
+Image layout (mmap_assets_table in main/assets.cc):
+    uint32 LE: file count
+    uint32 LE: checksum of everything after the 12-byte header
+    uint32 LE: length of everything after the 12-byte header
+    file table: 44 bytes per entry (name[32], size, offset, width, height)
+    file data: each blob is a 2-byte "ZZ" magic followed by the payload
+
+Per-file checksums use the same 16-bit byte sum as Assets::CalculateChecksum.
+
+Usage:
+    python make_assets_manifest.py assets.bin > assets.bin.manifest.json
+"""
+
+import json
+import struct
+import sys
+
+TABLE_ENTRY_SIZE = 44
+
+
+def checksum(data):
+    return sum(data) & 0xFFFF
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__)
+        sys.exit(1)
+
+    with open(sys.argv[1], "rb") as f:
+        image = f.read()
+
+    file_count, stored_chksum, stored_len = struct.unpack_from("<III", image, 0)
+    if 12 + stored_len > len(image):
+        sys.exit("stored length exceeds image size")
+    if checksum(image[12:12 + stored_len]) != stored_chksum:
+        sys.exit("image checksum mismatch")
+
+    data_start = 12 + TABLE_ENTRY_SIZE * file_count
+    files = []
+    for i in range(file_count):
+        name, size, offset, _width, _height = struct.unpack_from(
+            "<32sIIHH", image, 12 + i * TABLE_ENTRY_SIZE)
+        name = name.split(b"\0", 1)[0].decode()
+        abs_offset = data_start + offset
+        payload = image[abs_offset + 2:abs_offset + 2 + size]
+        if image[abs_offset:abs_offset + 2] != b"ZZ" or len(payload) != size:
+            sys.exit(f"asset {name} is not valid")
+        files.append({
+            "name": name,
+            "offset": abs_offset,
+            "size": size,
+            "checksum": checksum(payload),
+        })
+
+    print(json.dumps({
+        "version": 1,
+        "size": 12 + stored_len,
+        "checksum": stored_chksum,
+        "files": files,
+    }, indent=2, ensure_ascii=False))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+"""
+Compress a full app image for OTA transfer.
+
+The device inflates the stream on the fly with the ROM-resident miniz
+decompressor while writing to flash (see Ota::UpgradeCompressed in
+main/ota.cc), so no staging buffer for the full image is needed and the
+transfer typically shrinks to ~55% of the image. Serve the output next to
+the full image and return it as "compressed_url" in the firmware section
+of the check-version response; unlike the delta it does not depend on the
+version the device reported, so one file covers all upgrade paths. The
+full image URL stays as fallback.
+
+Format: plain zlib (RFC 1950). The window must not exceed 32KB — that is
+the dictionary size the on-device inflater allocates — which zlib level 9
+already guarantees. No extra framing: the device validates the restored
+image through esp_ota_end as usual.
+
+Usage:
+    python make_ota_compressed.py app.bin app.bin.zz
+"""
+
+import sys
+import zlib
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        sys.exit(1)
+
+    with open(sys.argv[1], "rb") as f:
+        image = f.read()
+
+    compressed = zlib.compress(image, 9)
+
+    with open(sys.argv[2], "wb") as f:
+        f.write(compressed)
+
+    print(f"image: {len(image)} bytes, compressed: {len(compressed)} bytes "
+          f"({len(compressed) * 100 // max(len(image), 1)}% of full image)")
+
+
+if __name__ == "__main__":
+    main()
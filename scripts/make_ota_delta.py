@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+Generate a delta OTA patch between two app images.
+
+The device reconstructs the new image by streaming reads from its running
+partition plus this patch (see Ota::UpgradeDelta in main/ota.cc), so a point
+release transfers a few hundred KB instead of the full 2-4MB image. Serve the
+patch next to the full image and return it as "delta_url" in the firmware
+section of the check-version response, keyed by the version the device
+reported; the full image URL stays as fallback.
+
+Patch format:
+    magic "XZD1" (4 bytes)
+    uint32 LE: new image size
+    uint32 LE: CRC32 of the new image (zlib polynomial)
+    ops until EOF:
+        'C' uint32 src_offset, uint32 length  -- copy from the old image
+        'A' uint32 length, length raw bytes   -- literal data
+
+Usage:
+    python make_ota_delta.py old.bin new.bin patch.xzd
+"""
+
+import struct
+import sys
+import zlib
+
+# Anchor granularity for the match index; matches are extended byte-wise in
+# both directions, so this only bounds the smallest detectable match.
+BLOCK_SIZE = 64
+# Copies shorter than this cost more in op overhead than they save
+MIN_COPY = 32
+
+
+def build_index(old):
+    index = {}
+    for offset in range(0, len(old) - BLOCK_SIZE + 1, BLOCK_SIZE):
+        index.setdefault(old[offset:offset + BLOCK_SIZE], offset)
+    return index
+
+
+def find_match(old, index, new, pos):
+    """Return (src_offset, length) of the best match covering new[pos:], or None."""
+    block = new[pos:pos + BLOCK_SIZE]
+    if len(block) < BLOCK_SIZE:
+        return None
+    src = index.get(block)
+    if src is None:
+        return None
+    # Extend forward
+    length = BLOCK_SIZE
+    while (pos + length < len(new) and src + length < len(old)
+           and new[pos + length] == old[src + length]):
+        length += 1
+    return src, length
+
+
+def make_delta(old, new):
+    index = build_index(old)
+    ops = []
+    literal_start = 0
+    pos = 0
+
+    def flush_literal(end):
+        if end > literal_start:
+            data = new[literal_start:end]
+            ops.append(b"A" + struct.pack("<I", len(data)) + data)
+
+    while pos < len(new):
+        match = find_match(old, index, new, pos)
+        if match is None or match[1] < MIN_COPY:
+            pos += 1
+            continue
+        src, length = match
+        # Extend backward into the pending literal
+        while (pos > literal_start and src > 0 and new[pos - 1] == old[src - 1]):
+            pos -= 1
+            src -= 1
+            length += 1
+        flush_literal(pos)
+        ops.append(b"C" + struct.pack("<II", src, length))
+        pos += length
+        literal_start = pos
+    flush_literal(len(new))
+
+    header = b"XZD1" + struct.pack("<II", len(new), zlib.crc32(new) & 0xFFFFFFFF)
+    return header + b"".join(ops)
+
+
+def main():
+    if len(sys.argv) != 4:
+        print(__doc__)
+        sys.exit(1)
+
+    with open(sys.argv[1], "rb") as f:
+        old = f.read()
+    with open(sys.argv[2], "rb") as f:
+        new = f.read()
+
+    patch = make_delta(old, new)
+
+    with open(sys.argv[3], "wb") as f:
+        f.write(patch)
+
+    print(f"old: {len(old)} bytes, new: {len(new)} bytes, patch: {len(patch)} bytes "
+          f"({len(patch) * 100 // max(len(new), 1)}% of full image)")
+
+
+if __name__ == "__main__":
+    main()
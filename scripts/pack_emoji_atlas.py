@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+Pack emoji images into a pre-rasterized atlas for the assets partition
+
+Rasterizes a directory of emoji images (PNG/GIF first frame) into one
+contiguous sprite sheet in a native LVGL color format. The firmware
+memory-maps the file and blits sprites straight out of flash, so emotion
+switching does not decode PNG at runtime (see AtlasEmojiCollection in
+main/display/lvgl_display/emoji_collection.cc).
+
+Sprite names are taken from the file names without extension and must fit
+in 16 bytes (e.g. neutral.png, laughing.png).
+
+File layout (little-endian, kept in sync with emoji_collection.cc):
+    header:  uint32 magic "EMA1", uint16 sprite_count, uint16 sprite_width,
+             uint16 sprite_height, uint16 color_format (lv_color_format_t),
+             uint32 reserved
+    names:   sprite_count * char[16], NUL-padded
+    pixels:  sprite_count * sprite_width * sprite_height * bpp, entry order
+
+Usage:
+    ./pack_emoji_atlas.py --size 64 --output emoji_64.atlas <input_dir>
+
+Reference the output in the assets index.json as:
+    "emoji_atlas": "emoji_64.atlas"
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+try:
+    from PIL import Image
+except ImportError:
+    print("Error: Pillow is required. Install with: pip install Pillow")
+    sys.exit(1)
+
+ATLAS_MAGIC = 0x31414D45  # "EMA1"
+NAME_LENGTH = 16
+
+# lv_color_format_t values from lvgl 9
+COLOR_FORMATS = {
+    "ARGB8888": (0x10, 4),
+    "RGB565": (0x12, 2),
+}
+
+
+def rasterize(path, size, color_format):
+    """Load an image, resize to size x size, return raw pixel bytes"""
+    img = Image.open(path)
+    img.seek(0)  # first frame for animated inputs
+    img = img.convert("RGBA").resize((size, size), Image.LANCZOS)
+
+    out = bytearray()
+    if color_format == "ARGB8888":
+        # lvgl stores ARGB8888 as B, G, R, A in memory
+        for r, g, b, a in img.getdata():
+            out += struct.pack("<BBBB", b, g, r, a)
+    else:  # RGB565, alpha composited against black
+        for r, g, b, a in img.getdata():
+            r = r * a // 255
+            g = g * a // 255
+            b = b * a // 255
+            out += struct.pack("<H", ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack emoji images into a pre-rasterized atlas")
+    parser.add_argument("input_dir", help="Directory of emoji images named <emoji-name>.<ext>")
+    parser.add_argument("--size", type=int, default=64, help="Sprite width/height in pixels (default: 64)")
+    parser.add_argument("--format", choices=sorted(COLOR_FORMATS), default="ARGB8888",
+                        help="Native LVGL color format (default: ARGB8888)")
+    parser.add_argument("--output", required=True, help="Output atlas file path")
+    args = parser.parse_args()
+
+    files = sorted(
+        f for f in os.listdir(args.input_dir)
+        if f.lower().endswith((".png", ".gif", ".bmp", ".jpg", ".jpeg"))
+    )
+    if not files:
+        print(f"Error: no images found in {args.input_dir}")
+        sys.exit(1)
+
+    names = []
+    pixels = []
+    for filename in files:
+        name = os.path.splitext(filename)[0]
+        if len(name.encode()) >= NAME_LENGTH:
+            print(f"Error: name '{name}' does not fit in {NAME_LENGTH - 1} bytes")
+            sys.exit(1)
+        names.append(name)
+        pixels.append(rasterize(os.path.join(args.input_dir, filename), args.size, args.format))
+
+    cf_value, bpp = COLOR_FORMATS[args.format]
+    with open(args.output, "wb") as f:
+        f.write(struct.pack("<IHHHHI", ATLAS_MAGIC, len(names), args.size, args.size, cf_value, 0))
+        for name in names:
+            f.write(name.encode().ljust(NAME_LENGTH, b"\x00"))
+        for data in pixels:
+            f.write(data)
+
+    total = 16 + len(names) * NAME_LENGTH + len(names) * args.size * args.size * bpp
+    print(f"Packed {len(names)} sprites ({args.size}x{args.size} {args.format}) "
+          f"into {args.output} ({total} bytes)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,277 @@
+/*
+ * 协议解析回放基准（主机侧）。
+ *
+ * 把录制的会话转录（JSON 文本帧 + 二进制音频帧）按固件的接收路径重放：
+ * 二进制帧走 wire_format.h 的 BinaryProtocol2/3 解帧，文本帧先过
+ * IsFlatJsonObject/FindStringField 快路径，判定不可扫描的计作全量解析
+ * 回退。汇报 包/秒、每包分配次数、峰值 RSS，给协议层改动提供可回归的
+ * 数字，不用等现场设备掉音频才发现解析变慢。
+ *
+ * 构建:  cmake -S . -B build && cmake --build build
+ * 回放:  ./build/protocol_replay --version 3 corpus.txt
+ * 生成:  ./build/protocol_replay --gen 100000 corpus.txt
+ *
+ * 转录格式（每行一条）:
+ *   J <原样 JSON 文本>
+ *   B <十六进制 OPUS 负载>（按 --version 指定的版本封帧后再解）
+ */
+
+#include "wire_format.h"
+
+#include <arpa/inet.h>
+#include <sys/resource.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+// 统计重放期间的堆分配次数（allocations/packet 的分子）
+static std::atomic<uint64_t> g_alloc_count{0};
+
+void* operator new(size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+namespace {
+
+// 模拟 AudioService 的下游：只收下负载统计字节数，容量跨包复用，
+// 和设备侧的包池行为一致
+struct MockAudioService {
+    std::vector<uint8_t> payload;
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+
+    void Push(const uint8_t* data, size_t size) {
+        payload.assign(data, data + size);
+        frames++;
+        bytes += size;
+    }
+};
+
+struct ReplayStats {
+    uint64_t packets = 0;
+    uint64_t json_fast = 0;
+    uint64_t json_fallback = 0;
+    uint64_t binary = 0;
+    uint64_t bad_lines = 0;
+};
+
+int HexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool DecodeHex(const std::string& hex, std::vector<uint8_t>& out) {
+    if (hex.size() % 2 != 0) return false;
+    out.resize(hex.size() / 2);
+    for (size_t i = 0; i < out.size(); i++) {
+        int hi = HexNibble(hex[i * 2]);
+        int lo = HexNibble(hex[i * 2 + 1]);
+        if (hi < 0 || lo < 0) return false;
+        out[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return true;
+}
+
+// 按版本封帧，模拟服务端发出的二进制帧
+void BuildFrame(int version, const std::vector<uint8_t>& payload, uint32_t timestamp,
+                std::vector<uint8_t>& frame) {
+    if (version == 2) {
+        frame.resize(sizeof(BinaryProtocol2) + payload.size());
+        auto bp2 = (BinaryProtocol2*)frame.data();
+        bp2->version = htons(2);
+        bp2->type = 0;
+        bp2->reserved = 0;
+        bp2->timestamp = htonl(timestamp);
+        bp2->payload_size = htonl(payload.size());
+        memcpy(bp2->payload, payload.data(), payload.size());
+    } else if (version == 3) {
+        frame.resize(sizeof(BinaryProtocol3) + payload.size());
+        auto bp3 = (BinaryProtocol3*)frame.data();
+        bp3->type = 0;
+        bp3->reserved = 0;
+        bp3->payload_size = htons(payload.size());
+        memcpy(bp3->payload, payload.data(), payload.size());
+    } else {
+        frame = payload;
+    }
+}
+
+// 设备侧 WebsocketProtocol::OnData 二进制分支的解帧逻辑
+void ParseFrame(int version, const uint8_t* data, size_t len, MockAudioService& sink) {
+    if (version == 2) {
+        auto bp2 = (const BinaryProtocol2*)data;
+        uint32_t payload_size = ntohl(bp2->payload_size);
+        sink.Push(bp2->payload, payload_size);
+    } else if (version == 3) {
+        auto bp3 = (const BinaryProtocol3*)data;
+        uint16_t payload_size = ntohs(bp3->payload_size);
+        sink.Push(bp3->payload, payload_size);
+    } else {
+        sink.Push(data, len);
+    }
+}
+
+// 设备侧 Protocol::DispatchStateMessage 的扫描部分
+bool ScanStateMessage(const std::string& json) {
+    std::string_view view(json);
+    if (!IsFlatJsonObject(view)) {
+        return false;
+    }
+    std::string type, state, text, emotion;
+    if (!FindStringField(view, "type", type)) {
+        return false;
+    }
+    if (type != "tts" && type != "stt" && type != "llm") {
+        return false;
+    }
+    FindStringField(view, "state", state);
+    FindStringField(view, "text", text);
+    FindStringField(view, "emotion", emotion);
+    return true;
+}
+
+int GenerateCorpus(const char* path, long count) {
+    std::ofstream out(path);
+    if (!out) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    // 比例取自真实会话：音频帧占绝对大头，状态消息零星穿插
+    srand(42);
+    for (long i = 0; i < count; i++) {
+        int kind = i % 50;
+        if (kind == 0) {
+            out << "J {\"session_id\":\"abc123\",\"type\":\"stt\",\"text\":\"hello world this is a test\"}\n";
+        } else if (kind == 1) {
+            out << "J {\"session_id\":\"abc123\",\"type\":\"tts\",\"state\":\"sentence_start\",\"text\":\"回复文本\"}\n";
+        } else if (kind == 2) {
+            // 带转义，落全量解析回退
+            out << "J {\"session_id\":\"abc123\",\"type\":\"stt\",\"text\":\"he said \\\"hi\\\"\"}\n";
+        } else {
+            // 60ms OPUS 帧的典型大小
+            int size = 80 + rand() % 80;
+            out << "B ";
+            for (int j = 0; j < size; j++) {
+                char buf[3];
+                snprintf(buf, sizeof(buf), "%02x", rand() & 0xff);
+                out << buf;
+            }
+            out << "\n";
+        }
+    }
+    printf("wrote %ld lines to %s\n", count, path);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int version = 3;
+    const char* corpus = nullptr;
+    long gen_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--version") == 0 && i + 1 < argc) {
+            version = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--gen") == 0 && i + 1 < argc) {
+            gen_count = atol(argv[++i]);
+        } else {
+            corpus = argv[i];
+        }
+    }
+    if (corpus == nullptr) {
+        fprintf(stderr, "usage: %s [--version 1|2|3] [--gen N] corpus.txt\n", argv[0]);
+        return 1;
+    }
+    if (gen_count > 0) {
+        return GenerateCorpus(corpus, gen_count);
+    }
+
+    // 先整个读进内存，回放循环里只量解析本身
+    std::ifstream in(corpus);
+    if (!in) {
+        fprintf(stderr, "cannot read %s\n", corpus);
+        return 1;
+    }
+    std::vector<std::string> json_lines;
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<int> order;  // 0 = json_lines 下一条, 1 = frames 下一条
+    std::string line;
+    ReplayStats stats;
+    uint32_t timestamp = 0;
+    while (std::getline(in, line)) {
+        if (line.size() < 2) continue;
+        if (line[0] == 'J' && line[1] == ' ') {
+            json_lines.push_back(line.substr(2));
+            order.push_back(0);
+        } else if (line[0] == 'B' && line[1] == ' ') {
+            std::vector<uint8_t> payload;
+            if (!DecodeHex(line.substr(2), payload)) {
+                stats.bad_lines++;
+                continue;
+            }
+            std::vector<uint8_t> frame;
+            BuildFrame(version, payload, timestamp, frame);
+            timestamp += 60;
+            frames.push_back(std::move(frame));
+            order.push_back(1);
+        } else {
+            stats.bad_lines++;
+        }
+    }
+
+    MockAudioService sink;
+    uint64_t alloc_before = g_alloc_count.load();
+    auto start = std::chrono::steady_clock::now();
+
+    size_t ji = 0, bi = 0;
+    for (int kind : order) {
+        if (kind == 0) {
+            if (ScanStateMessage(json_lines[ji])) {
+                stats.json_fast++;
+            } else {
+                stats.json_fallback++;
+            }
+            ji++;
+        } else {
+            const auto& frame = frames[bi++];
+            ParseFrame(version, frame.data(), frame.size(), sink);
+            stats.binary++;
+        }
+        stats.packets++;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - start).count();
+    uint64_t allocs = g_alloc_count.load() - alloc_before;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("version:          %d\n", version);
+    printf("packets:          %llu (%llu binary, %llu json fast, %llu json fallback, %llu bad)\n",
+           (unsigned long long)stats.packets, (unsigned long long)stats.binary,
+           (unsigned long long)stats.json_fast, (unsigned long long)stats.json_fallback,
+           (unsigned long long)stats.bad_lines);
+    printf("audio payload:    %llu frames, %llu bytes\n",
+           (unsigned long long)sink.frames, (unsigned long long)sink.bytes);
+    printf("elapsed:          %.3f ms\n", elapsed / 1000.0);
+    printf("packets/sec:      %.0f\n", stats.packets * 1e6 / (elapsed > 0 ? elapsed : 1));
+    printf("allocations/pkt:  %.3f\n", stats.packets ? (double)allocs / stats.packets : 0.0);
+    printf("peak RSS:         %ld KB\n", usage.ru_maxrss);
+    return 0;
+}
@@ -168,6 +168,19 @@ def release(board_type: str, config_filename: str = "config.json", *, filter_nam
         sdkconfig_append = [f"{board_type_config}=y"]
         sdkconfig_append.extend(build.get("sdkconfig_append", []))
 
+        # 按显示类裁剪 LVGL：lvgl_profile 指向根目录的 sdkconfig.lvgl.<名字>
+        # 片段，把用不到的部件/解码器编出去（OLED 板省 ~200KB flash）
+        lvgl_profile = build.get("lvgl_profile", cfg.get("lvgl_profile"))
+        if lvgl_profile:
+            profile_path = Path(f"sdkconfig.lvgl.{lvgl_profile}")
+            if not profile_path.exists():
+                print(f"[ERROR] lvgl_profile {lvgl_profile} 不存在: {profile_path}", file=sys.stderr)
+                sys.exit(1)
+            for line in profile_path.read_text(encoding="utf-8").splitlines():
+                line = line.strip()
+                if line and not line.startswith("#"):
+                    sdkconfig_append.append(line)
+
         print("-" * 80)
         print(f"name: {name}")
         print(f"target: {target}")
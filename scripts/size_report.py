@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""二进制体积 / 静态内存回归跟踪。
+
+解析链接器 map 文件，按内存区（flash 代码、flash 只读数据、IRAM、
+DRAM .data、.bss）汇总各归档的占用和最大的符号，输出机器可读的 JSON
+报告；--baseline 模式对比一份已入库的基线并在超出阈值时非零退出——
+.bss 悄悄长大会让 C3 这类内存紧的板子直接在运行期翻车，要在 CI 里拦住。
+
+    idf.py build && idf.py size-report          # 生成 build/size_report.json
+    idf.py size-check                           # 对比 scripts/size_baselines/
+
+    # 或直接:
+    python scripts/size_report.py build/xiaozhi.map -o report.json
+    python scripts/size_report.py build/xiaozhi.map \
+        --baseline scripts/size_baselines/xiaozhi.json --max-bss-delta 1024
+
+基线按板子命名（从 sdkconfig 的 CONFIG_BOARD_TYPE_* 推导）。换基线:
+构建后把 build/size_report.json 拷进 scripts/size_baselines/<board>.json
+提交即可。
+"""
+
+import argparse
+import json
+import re
+import sys
+from collections import defaultdict
+
+# 输入段名前缀 -> 预算区；剩下的后缀是符号名。顺序从具体到泛化
+PREFIXES = [
+    (".iram0.vectors", "iram"),
+    (".iram0.text", "iram"),
+    (".iram.text", "iram"),
+    (".dram0.data", "dram_data"),
+    (".dram0.bss", "bss"),
+    (".flash.appdesc", "flash_rodata"),
+    (".flash.rodata", "flash_rodata"),
+    (".flash.text", "flash_code"),
+    (".text", "flash_code"),
+    (".rodata", "flash_rodata"),
+    (".data", "dram_data"),
+    (".bss", "bss"),
+    (".noinit", "bss"),
+]
+
+
+def classify(section):
+    """返回 (region, symbol)；不属于任何预算区时 (None, None)。"""
+    for prefix, region in PREFIXES:
+        if section == prefix:
+            return region, ""
+        if section.startswith(prefix + "."):
+            return region, section[len(prefix) + 1:]
+    return None, None
+
+
+def parse_map(path):
+    """返回 [(region, size, archive, symbol)]，覆盖所有预算区的输入段。"""
+    entries = []
+    pending = None  # (region, symbol)：超长符号名换行时地址/大小在下一行
+    with open(path) as f:
+        for line in f:
+            stripped = line.rstrip("\n")
+            m = re.match(r"^ (\.\S+)(\s+\S.*)?$", stripped)
+            if m:
+                region, sym = classify(m.group(1))
+                if region is None:
+                    pending = None
+                    continue
+                rest = (m.group(2) or "").strip()
+                if rest:
+                    entries.extend(_parse_tail(region, sym, rest))
+                    pending = None
+                else:
+                    pending = (region, sym)
+                continue
+            if pending is not None:
+                rest = stripped.strip()
+                if rest.startswith("0x"):
+                    entries.extend(_parse_tail(pending[0], pending[1], rest))
+                pending = None
+    return entries
+
+
+def _parse_tail(region, sym, rest):
+    parts = rest.split()
+    if len(parts) < 3 or not parts[0].startswith("0x") or not parts[1].startswith("0x"):
+        return []
+    try:
+        size = int(parts[1], 16)
+    except ValueError:
+        return []
+    if size == 0:
+        return []
+    m = re.search(r"([^/\\]+\.a)\(([^)]+)\)", parts[2])
+    archive = m.group(1) if m else parts[2].rsplit("/", 1)[-1]
+    return [(region, size, archive, sym or "(anonymous)")]
+
+
+def build_report(entries, top_symbols):
+    totals = defaultdict(int)
+    by_archive = defaultdict(lambda: defaultdict(int))
+    symbols = defaultdict(list)
+    for region, size, archive, sym in entries:
+        totals[region] += size
+        by_archive[archive][region] += size
+        symbols[region].append((size, "%s %s" % (archive, sym)))
+    report = {
+        "totals": dict(sorted(totals.items())),
+        "archives": {
+            a: dict(sorted(r.items()))
+            for a, r in sorted(by_archive.items(), key=lambda kv: -sum(kv[1].values()))
+        },
+        "top_symbols": {
+            region: ["%d %s" % (s, n) for s, n in sorted(syms, reverse=True)[:top_symbols]]
+            for region, syms in sorted(symbols.items())
+        },
+    }
+    return report
+
+
+def compare(report, baseline, max_deltas):
+    failures = []
+    print("%-12s %10s %10s %10s" % ("region", "baseline", "current", "delta"))
+    for region in sorted(set(report["totals"]) | set(baseline.get("totals", {}))):
+        old = baseline.get("totals", {}).get(region, 0)
+        new = report["totals"].get(region, 0)
+        delta = new - old
+        print("%-12s %10d %10d %+10d" % (region, old, new, delta))
+        limit = max_deltas.get(region)
+        if limit is not None and delta > limit:
+            failures.append("%s grew %+d bytes (limit %+d)" % (region, delta, limit))
+
+    # 按归档列出增量，直接指向引入回归的组件
+    old_arch = baseline.get("archives", {})
+    deltas = []
+    for archive, regions in report["archives"].items():
+        d = sum(regions.values()) - sum(old_arch.get(archive, {}).values())
+        if d:
+            deltas.append((d, archive))
+    for archive in old_arch:
+        if archive not in report["archives"]:
+            deltas.append((-sum(old_arch[archive].values()), archive))
+    if deltas:
+        print("\nper-archive delta:")
+        for d, archive in sorted(deltas, reverse=True):
+            print("  %+8d  %s" % (d, archive))
+
+    for failure in failures:
+        print("error: " + failure, file=sys.stderr)
+    return 1 if failures else 0
+
+
+def board_from_sdkconfig(path):
+    """CONFIG_BOARD_TYPE_BREAD_COMPACT_WIFI=y -> bread-compact-wifi"""
+    with open(path) as f:
+        for line in f:
+            m = re.match(r"CONFIG_BOARD_TYPE_([A-Z0-9_]+)=y", line)
+            if m:
+                return m.group(1).lower().replace("_", "-")
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("map", help="linker map file from the build")
+    parser.add_argument("-o", "--output", help="write the JSON report here")
+    parser.add_argument("--baseline", help="stored report to compare against")
+    parser.add_argument("--sdkconfig",
+                        help="derive the baseline name from CONFIG_BOARD_TYPE_* in this sdkconfig")
+    parser.add_argument("--baseline-dir",
+                        help="directory of per-board baselines, used with --sdkconfig")
+    parser.add_argument("--max-bss-delta", type=int, default=0,
+                        help="bytes of .bss growth tolerated vs baseline")
+    parser.add_argument("--max-iram-delta", type=int, default=0,
+                        help="bytes of IRAM growth tolerated vs baseline")
+    parser.add_argument("--top-symbols", type=int, default=20)
+    args = parser.parse_args()
+
+    entries = parse_map(args.map)
+    if not entries:
+        print("no input sections found (wrong map file?)", file=sys.stderr)
+        return 1
+    report = build_report(entries, args.top_symbols)
+
+    if args.sdkconfig and args.baseline_dir and not args.baseline:
+        board = board_from_sdkconfig(args.sdkconfig)
+        if board is None:
+            print("no CONFIG_BOARD_TYPE_* in %s" % args.sdkconfig, file=sys.stderr)
+            return 1
+        args.baseline = "%s/%s.json" % (args.baseline_dir, board)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(report, f, indent=2)
+            f.write("\n")
+    if args.baseline:
+        try:
+            with open(args.baseline) as f:
+                baseline = json.load(f)
+        except FileNotFoundError:
+            # 新板子还没有基线：报告当前值并提示怎么入库，不算失败
+            print("no baseline at %s; commit the current report to create one" % args.baseline)
+            for region, total in sorted(report["totals"].items()):
+                print("%-12s %10d" % (region, total))
+            return 0
+        return compare(report, baseline, {
+            "bss": args.max_bss_delta,
+            "iram": args.max_iram_delta,
+        })
+
+    for region, total in sorted(report["totals"].items()):
+        print("%-12s %10d" % (region, total))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
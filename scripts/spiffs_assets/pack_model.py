@@ -82,30 +82,28 @@ def pack_models(model_path, out_file="srmodels.bin"):
                     models[model_name][file_name] = read_data(file_path)
     
     model_num = len(models)
-    header_len = 4 + model_num*(32+4) + file_num*(32+4+4) 
+    header_len = 4 + model_num*(32+4) + file_num*(32+4+4)
     out_bin = struct.pack('I', model_num)  # model number
-    data_bin = None
+    data_bin = b""
     for key in models:
         model_bin = struct_pack_string(key, 32) # + model name
         model_bin += struct.pack('I', len(models[key])) # + file number in this model
-        
+
         for file_name in models[key]:
+            # Pad each payload to a 32-byte boundary: the loader reads the
+            # recorded offsets, so padding is transparent, and weights are
+            # then cache-line aligned when the container itself is (the
+            # assets image places srmodels.bin on a 32-byte boundary)
+            data_bin += b"\x00" * (-(header_len + len(data_bin)) % 32)
             model_bin += struct_pack_string(file_name, 32) # + file name
-            if data_bin == None:
-                model_bin += struct.pack('I', header_len) 
-                data_bin = models[key][file_name]
-                model_bin += struct.pack('I', len(models[key][file_name]))
+            model_bin += struct.pack('I', header_len + len(data_bin))
+            data_bin += models[key][file_name]
+            model_bin += struct.pack('I', len(models[key][file_name]))
                 # print(file_name, header_len, len(models[key][file_name]), len(data_bin))
-            else:
-                model_bin += struct.pack('I', header_len+len(data_bin))
-                # print(file_name, header_len+len(data_bin), len(models[key][file_name]))
-                data_bin += models[key][file_name]
-                model_bin += struct.pack('I', len(models[key][file_name]))
-        
+
         out_bin += model_bin
     assert len(out_bin) == header_len
-    if data_bin != None:
-        out_bin += data_bin
+    out_bin += data_bin
 
     out_file = os.path.join(model_path, out_file)
     with open(out_file, "wb") as f:
@@ -3,6 +3,7 @@
 import io
 import os
 import argparse
+import hashlib
 import json
 import shutil
 import math
@@ -56,10 +57,6 @@ def compute_checksum(data):
     checksum = sum(data) & 0xFFFF
     return checksum
 
-def sort_key(filename):
-    basename, extension = os.path.splitext(filename)
-    return extension, basename
-
 def download_v8_script(convert_path):
     """
     Ensure that the lvgl_image_converter repository is present at the specified path.
@@ -403,11 +400,22 @@ def pack_assets(config: PackModelsConfig):
     file_info_list = []
     skip_files = ['config.json', 'lvgl_image_converter']
 
-    file_list = sorted(os.listdir(target_path), key=sort_key)
+    # Sorted by raw name bytes so the device can binary search the mmap table
+    # directly (see Assets::FindAssetEntry in main/assets.cc)
+    file_list = [f for f in sorted(os.listdir(target_path)) if f not in skip_files]
+    # 12-byte image header + fixed-size mmap table; knowing where the data
+    # region starts lets each payload be placed on a 32-byte boundary in
+    # absolute partition coordinates (flash mmap cache line), so mmap'd
+    # consumers like the srmodels weights read aligned rows in place
+    data_start = 12 + len(file_list) * (int(max_name_len) + 12)
+    # Identical payloads (themed builds ship near-identical emoji sets per
+    # theme) are stored once; later table entries alias the first copy's
+    # offset. The device resolves names through the table, so aliased
+    # offsets need no firmware support.
+    dedup_offsets = {}
+    dedup_saved = 0
+    dedup_files = 0
     for filename in file_list:
-        if filename in skip_files:
-            continue
-
         file_path = os.path.join(target_path, filename)
         file_name = os.path.basename(file_path)
         file_size = os.path.getsize(file_path)
@@ -429,16 +437,30 @@ def pack_assets(config: PackModelsConfig):
             else:
                 width, height = 0, 0
 
+        with open(file_path, 'rb') as bin_file:
+            bin_data = bin_file.read()
+
+        content_key = hashlib.sha256(bin_data).digest()
+        if content_key in dedup_offsets:
+            file_info_list.append((file_name, dedup_offsets[content_key], file_size, width, height))
+            dedup_saved += file_size + 2
+            dedup_files += 1
+            continue
+
+        # Pad so the payload (after the 2-byte magic) is 32-byte aligned;
+        # offsets recorded below point at the magic, so readers are unaffected
+        merged_data.extend(b'\x00' * (-(data_start + len(merged_data) + 2) % 32))
+
+        dedup_offsets[content_key] = len(merged_data)
         file_info_list.append((file_name, len(merged_data), file_size, width, height))
         # Add 0x5A5A prefix to merged_data
         merged_data.extend(b'\x5A' * 2)
 
-        with open(file_path, 'rb') as bin_file:
-            bin_data = bin_file.read()
-
         merged_data.extend(bin_data)
 
     total_files = len(file_info_list)
+    if dedup_files:
+        print(f'Deduplicated {dedup_files} identical files, saved {dedup_saved} bytes')
 
     mmap_table = bytearray()
     for file_name, offset, file_size, width, height in file_info_list: